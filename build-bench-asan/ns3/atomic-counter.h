@@ -0,0 +1,72 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ATOMIC_COUNTER_H
+#define ATOMIC_COUNTER_H
+
+#include "ns3/core-config.h"
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup core
+ * Reference counter helpers shared by SimpleRefCount and the
+ * copy-on-write packet data structures.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ * Increment a reference counter.
+ *
+ * When ns-3 is configured with \c --enable-mtp the increment is
+ * atomic, so that objects can be shared between the partitions of
+ * the MultithreadedSimulatorImpl.  Otherwise this is a plain increment.
+ *
+ * \param [in,out] count The counter.
+ * \returns The value of the counter after the increment.
+ */
+inline uint32_t
+AtomicIncrement (uint32_t &count)
+{
+#ifdef NS3_MTP
+  return __sync_add_and_fetch (&count, 1);
+#else
+  return ++count;
+#endif
+}
+
+/**
+ * \ingroup core
+ * Decrement a reference counter.
+ *
+ * \param [in,out] count The counter.
+ * \returns The value of the counter after the decrement.
+ */
+inline uint32_t
+AtomicDecrement (uint32_t &count)
+{
+#ifdef NS3_MTP
+  return __sync_sub_and_fetch (&count, 1);
+#else
+  return --count;
+#endif
+}
+
+} // namespace ns3
+
+#endif /* ATOMIC_COUNTER_H */
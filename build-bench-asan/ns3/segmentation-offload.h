@@ -0,0 +1,211 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef SEGMENTATION_OFFLOAD_H
+#define SEGMENTATION_OFFLOAD_H
+
+#include "ns3/tag.h"
+#include "ns3/packet.h"
+#include "ns3/callback.h"
+#include "ns3/address.h"
+#include "ns3/event-id.h"
+
+#include <list>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief Mark a super-segment, to be split in segments of a given size
+ *
+ * A transport protocol may hand down a super-segment, i.e., a packet
+ * carrying the payload of several segments behind a single set of
+ * headers. The super-segment crosses the layer 3 protocol, the traffic
+ * control layer and the device as one packet, and it is split as late as
+ * possible: by the device when it supports it (see
+ * NetDevice::SupportsSegmentationOffload), by the layer 3 protocol
+ * otherwise.
+ */
+class GsoTag : public Tag
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer buf) const;
+  virtual void Deserialize (TagBuffer buf);
+  virtual void Print (std::ostream &os) const;
+  GsoTag ();
+
+  /**
+   * Constructs a GsoTag with the given segment size
+   *
+   * \param segmentSize the payload of each segment, in bytes
+   */
+  GsoTag (uint16_t segmentSize);
+  /**
+   * Sets the segment size
+   * \param segmentSize the payload of each segment, in bytes
+   */
+  void SetSegmentSize (uint16_t segmentSize);
+  /**
+   * Gets the segment size
+   * \returns the payload of each segment, in bytes
+   */
+  uint16_t GetSegmentSize (void) const;
+private:
+  uint16_t m_segmentSize; //!< Payload of each segment
+};
+
+/**
+ * \ingroup network
+ *
+ * \brief Registry of the functions splitting the super-segments, and
+ * of the functions merging the received segments
+ *
+ * The devices do not know the headers of the upper layers: a protocol
+ * which emits super-segments registers, for its protocol number, the
+ * function which splits them. The function gets a super-segment starting
+ * with the protocol header, and returns the segments, each one with its
+ * own copy of the headers.
+ *
+ * Conversely, a protocol may register the function which merges two
+ * received segments of the same flow, which ReceiveCoalescer uses.
+ */
+class SegmentationOffload
+{
+public:
+  /**
+   * Callback splitting a super-segment
+   */
+  typedef Callback<std::list<Ptr<Packet> >, Ptr<const Packet> > SegmentCallback;
+  /**
+   * Callback merging a received segment into the preceding one
+   */
+  typedef Callback<Ptr<Packet>, Ptr<const Packet>, Ptr<const Packet> > CoalesceCallback;
+
+  /**
+   * \brief Register the function splitting the super-segments of a protocol
+   * \param protocol the protocol number, as given to NetDevice::Send
+   * \param cb the function splitting the super-segments
+   */
+  static void Register (uint16_t protocol, SegmentCallback cb);
+
+  /**
+   * \brief Split a super-segment
+   *
+   * A packet without GsoTag, or of a protocol without registered function,
+   * is returned as it is.
+   *
+   * \param packet the super-segment, starting with the protocol header
+   * \param protocol the protocol number
+   * \returns the segments, without GsoTag
+   */
+  static std::list<Ptr<Packet> > Segment (Ptr<const Packet> packet, uint16_t protocol);
+
+  /**
+   * \brief Register the function merging the received segments of a protocol
+   * \param protocol the protocol number, as given to the receive callback
+   * \param cb the function merging the segments
+   */
+  static void RegisterCoalesce (uint16_t protocol, CoalesceCallback cb);
+
+  /**
+   * \brief Merge a received segment into the preceding one
+   *
+   * The merged packet is marked with a GsoTag carrying the size of its
+   * segments, so that the receiver can count them.
+   *
+   * \param held the preceding segment, possibly already merged
+   * \param packet the segment received after it
+   * \param protocol the protocol number of both
+   * \returns the merged packet, starting with the protocol header, or 0 if
+   *          the segments cannot be merged (not of the same flow, not
+   *          contiguous, different headers or no registered function)
+   */
+  static Ptr<Packet> Coalesce (Ptr<const Packet> held, Ptr<const Packet> packet, uint16_t protocol);
+};
+
+/**
+ * \ingroup network
+ *
+ * \brief Merge the segments received by a device in the same event
+ *
+ * A device receiving a burst of packets at once (e.g., the MSDUs of an
+ * A-MPDU) hands them to the coalescer instead of the upper layer. Each
+ * packet is merged, when possible, into the packet received just before;
+ * the resulting packets are delivered in order at the end of the current
+ * event, through a zero-delay event, so that the delivery time is
+ * unchanged. The upper layer thus processes one large segment, and
+ * acknowledges it once, instead of each segment of the burst.
+ */
+class ReceiveCoalescer
+{
+public:
+  /**
+   * Callback delivering a packet: packet, protocol number and sender
+   */
+  typedef Callback<void, Ptr<Packet>, uint16_t, const Address &> DeliverCallback;
+
+  ReceiveCoalescer ();
+  ~ReceiveCoalescer ();
+
+  /**
+   * \param cb the callback delivering the packets to the upper layer
+   */
+  void SetDeliverCallback (DeliverCallback cb);
+
+  /**
+   * \brief Add a received packet to the current burst
+   * \param packet the packet, starting with the protocol header
+   * \param protocol the protocol number
+   * \param from the sender
+   */
+  void Receive (Ptr<Packet> packet, uint16_t protocol, const Address &from);
+
+  /**
+   * \brief Deliver the packets of the current burst
+   */
+  void Flush (void);
+
+  /**
+   * \brief Drop the packets of the current burst, and the callback
+   */
+  void Dispose (void);
+
+private:
+  /// A packet waiting for delivery
+  struct Item
+  {
+    Ptr<Packet> packet; //!< The packet
+    uint16_t protocol;  //!< The protocol number
+    Address from;       //!< The sender
+  };
+
+  DeliverCallback m_deliver;  //!< Delivers a packet to the upper layer
+  std::vector<Item> m_items;  //!< Packets waiting for delivery, in order
+  EventId m_flushEvent;       //!< Delivers the packets at the end of the event
+};
+
+} // namespace ns3
+
+#endif /* SEGMENTATION_OFFLOAD_H */
@@ -0,0 +1,212 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2006,2007 INRIA
+ * Copyright (c) 2015, 2016 IMDEA Networks Institute
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Authors: Mathieu Lacage, <mathieu.lacage@sophia.inria.fr>
+ *          Hany Assasa <hany.assasa@gmail.com>
+ */
+
+#ifndef YANS_WIFI_CHANNEL_H
+#define YANS_WIFI_CHANNEL_H
+
+#include <vector>
+#include <stdint.h>
+#include "ns3/packet.h"
+#include "wifi-channel.h"
+#include "wifi-mode.h"
+#include "wifi-preamble.h"
+#include "wifi-tx-vector.h"
+#include "yans-wifi-phy.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+class NetDevice;
+class PropagationLossModel;
+class PropagationDelayModel;
+
+struct Parameters
+{
+  double rxPowerDbm;
+  enum mpduType type;
+  Time duration;
+  WifiTxVector txVector;
+  WifiPreamble preamble;
+};
+
+/**
+ * \brief A Yans wifi channel
+ * \ingroup wifi
+ *
+ * This wifi channel implements the propagation model described in
+ * "Yet Another Network Simulator", (http://cutebugs.net/files/wns2-yans.pdf).
+ *
+ * This class is expected to be used in tandem with the ns3::YansWifiPhy
+ * class and contains a ns3::PropagationLossModel and a ns3::PropagationDelayModel.
+ * By default, no propagation models are set so, it is the caller's responsability
+ * to set them before using the channel.
+ */
+class YansWifiChannel : public WifiChannel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  YansWifiChannel ();
+  virtual ~YansWifiChannel ();
+
+  //inherited from Channel.
+  virtual uint32_t GetNDevices (void) const;
+  virtual Ptr<NetDevice> GetDevice (uint32_t i) const;
+
+  /**
+   * Adds the given YansWifiPhy to the PHY list
+   *
+   * \param phy the YansWifiPhy to be added to the PHY list
+   */
+  void Add (Ptr<YansWifiPhy> phy);
+
+  /**
+   * \param loss the new propagation loss model.
+   */
+  void SetPropagationLossModel (Ptr<PropagationLossModel> loss);
+  /**
+   * \param delay the new propagation delay model.
+   */
+  void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay);
+  /**
+   * Compute the smallest propagation delay between two PHYs operating
+   * on the same channel number, for the current PHY positions.  This is
+   * a suitable lookahead for the MultithreadedSimulatorImpl as long as
+   * the nodes do not move closer to each other.
+   *
+   * \return the smallest propagation delay, or zero if the channel has
+   *         less than two PHYs on the same channel number.
+   */
+  Time GetMinimumDelay (void) const;
+
+  /**
+   * \param sender the device from which the packet is originating.
+   * \param packet the packet to send
+   * \param txPowerDbm the tx power associated to the packet
+   * \param txVector the TXVECTOR associated to the packet
+   * \param preamble the preamble associated to the packet
+   * \param mpdutype the type of the MPDU as defined in WifiPhy::mpduType.
+   * \param duration the transmission duration associated to the packet
+   *
+   * This method should not be invoked by normal users. It is
+   * currently invoked only from WifiPhy::Send. YansWifiChannel
+   * delivers packets only between PHYs with the same m_channelNumber,
+   * e.g. PHYs that are operating on the same channel.
+   *
+   * With the MultithreadedSimulatorImpl, the receptions are computed by
+   * an event given to MultithreadedSimulatorImpl::ScheduleShared, at the
+   * end of the current window, since the positions and the antennas of
+   * the receivers, and the random variables of the propagation models,
+   * are shared with the other partitions.
+   */
+  void Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
+             WifiTxVector txVector, WifiPreamble preamble, enum mpduType mpdutype, Time duration) const;
+
+  /**
+   * Send TRN Field.
+   * \param sender the device from which the packet is originating.
+   * \param txPowerDbm the tx power associated to the packet.
+   * \param txVector the TXVECTOR associated to the packet.
+   */
+  void SendTrn (Ptr<YansWifiPhy> sender, double txPowerDbm, WifiTxVector txVector, uint8_t fieldsRemaining) const;
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.
+   *
+   * \param stream first stream index to use
+   *
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+  /**
+   * Add bloackage on a certain path between two WifiPhy objects.
+   * \param srcWifiPhy
+   * \param dstWifiPhy
+   */
+  void AddBlockage (double (*blockage)(), Ptr<WifiPhy> srcWifiPhy, Ptr<WifiPhy> dstWifiPhy);
+  void AddPacketDropper (bool (*dropper)(), Ptr<WifiPhy> srcWifiPhy, Ptr<WifiPhy> dstWifiPhy);
+
+private:
+  /**
+   * A vector of pointers to YansWifiPhy.
+   */
+  typedef std::vector<Ptr<YansWifiPhy> > PhyList;
+
+  /**
+   * Compute the power received by every other PHY on the same channel
+   * number, and schedule the receptions.
+   *
+   * \param sender the device from which the packet is originating
+   * \param packet the packet to send
+   * \param parameters the parameters of the packet, with the tx power
+   *        in the rxPowerDbm field
+   */
+  void DoSend (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, struct Parameters parameters) const;
+  /**
+   * Compute the power received by every other PHY on the same channel
+   * number, without the gain of its antenna, and schedule the receptions
+   * of the TRN Field.
+   *
+   * \param sender the device from which the TRN Field is originating.
+   * \param txPowerDbm the tx power associated to the TRN Field.
+   * \param txVector the TXVECTOR associated to the TRN Field.
+   * \param fieldsRemaining the number of TRN Fields remaining after this one.
+   */
+  void DoSendTrn (Ptr<YansWifiPhy> sender, double txPowerDbm, WifiTxVector txVector, uint8_t fieldsRemaining) const;
+
+  /**
+   * This method is scheduled by Send for each associated YansWifiPhy.
+   * The method then calls the corresponding YansWifiPhy that the first
+   * bit of the packet has arrived.
+   *
+   * \param i index of the corresponding YansWifiPhy in the PHY list
+   * \param packet the packet being sent
+   * \param atts a vector containing the received power in dBm and the packet type
+   * \param txVector the TXVECTOR of the packet
+   * \param preamble the type of preamble being used to send the packet
+   */
+  void Receive (uint32_t i, Ptr<Packet> packet, struct Parameters parameters) const;
+  /**
+   * \param i index of the corresponding YansWifiPhy in the PHY list.
+   * \param txVector the TXVECTOR of the packet.
+   * \param rxPowerDbm the received signal strength [dBm], without the
+   *        gain of the receiver's antenna.
+   * \param azimuthRx the angle of arrival of the signal.
+   * \param fieldsRemaining the number of TRN Fields remaining after this one.
+   */
+  void ReceiveTrn (uint32_t i, WifiTxVector txVector, double rxPowerDbm,
+                   double azimuthRx, uint8_t fieldsRemaining) const;
+
+  PhyList m_phyList;                    //!< List of YansWifiPhys connected to this YansWifiChannel
+  Ptr<PropagationLossModel> m_loss;     //!< Propagation loss model
+  Ptr<PropagationDelayModel> m_delay;   //!< Propagation delay model
+  double (*m_blockage) ();              //!< Blockage model.
+  bool (*m_packetDropper) ();           //!< Packet Dropper Model.
+  Ptr<WifiPhy> m_srcWifiPhy;
+  Ptr<WifiPhy> m_dstWifiPhy;
+
+};
+
+} //namespace ns3
+
+#endif /* YANS_WIFI_CHANNEL_H */
@@ -0,0 +1,8 @@
+#! /usr/bin/env python
+
+# Programs that are runnable.
+ns3_runnable_programs = ['build-bench-debug/scratch/ns3.25-evaluate_fst_mechanism-debug', 'build-bench-debug/scratch/ns3.25-evaluate_tcp_sack_blockage-debug', 'build-bench-debug/scratch/subdir/ns3.25-subdir-debug', 'build-bench-debug/scratch/ns3.25-evaluate_beamforming-debug', 'build-bench-debug/scratch/ns3.25-evaluate_dmg_throughput-debug', 'build-bench-debug/scratch/ns3.25-evaluate_service_period-debug', 'build-bench-debug/scratch/ns3.25-evaluate_tcp_congestion_control-debug', 'build-bench-debug/scratch/ns3.25-test_fst-debug', 'build-bench-debug/scratch/ns3.25-evaluate_relay_operation-debug']
+
+# Scripts that are runnable.
+ns3_runnable_scripts = []
+
@@ -0,0 +1,164 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BATCH_RUN_HELPER_H
+#define BATCH_RUN_HELPER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "ns3/callback.h"
+
+namespace ns3 {
+
+class DataCollector;
+
+/**
+ * \ingroup stats
+ *
+ * \brief Run the points of a parameter sweep in parallel, within one process.
+ *
+ * The helper runs every sweep point a number of times (the replications).
+ * Each (point, replication) pair is a job, which is given its own
+ * RngSeedManager run number: <tt>base run + point * replications +
+ * replication</tt>.  The results therefore do not depend on the number of
+ * workers nor on the order in which the jobs complete.
+ *
+ * The jobs are run in child processes forked from the calling process,
+ * at most SetWorkers () of them at a time.  The type registrations and
+ * the attribute defaults set before Run () are thus inherited by every
+ * job instead of being rebuilt by a new process, while the changes made
+ * by a job (attribute defaults, node ids, static counters) stay private
+ * to it.  With zero workers, the jobs are run sequentially in the calling
+ * process, which is convenient for debugging; the jobs then share the
+ * automatic random stream assignments, so that their results match those
+ * of forked jobs only if the streams are assigned explicitly.
+ *
+ * The run callback is given the index of the sweep point and a
+ * DataCollector, already described with the experiment label, the point
+ * label as strategy, the replication as input and the run number as run
+ * label.  It must build and run the simulation, and register in the
+ * DataCollector the calculators holding the results.  The helper calls
+ * Simulator::Destroy () after each job.  The content of all the data
+ * collectors is written in a single CSV file, in job order, with one line
+ * per metadata or calculator value:
+ *
+ * \verbatim
+   run,experiment,strategy,input,key,variable,value
+   \endverbatim
+ *
+ * Example:
+ * \code
+ *   BatchRunHelper batch;
+ *   batch.SetExperiment ("dmg-throughput");
+ *   batch.AddPoint ("mcs-1");
+ *   batch.AddPoint ("mcs-2");
+ *   batch.SetReplications (10);
+ *   batch.SetWorkers (8);
+ *   batch.SetRunCallback (MakeCallback (&RunPoint));
+ *   batch.Run ("throughput.csv");
+ * \endcode
+ */
+class BatchRunHelper
+{
+public:
+  /**
+   * Callback type to run one job.  Its arguments are the index of the
+   * sweep point and the DataCollector to fill.
+   */
+  typedef Callback<void, uint32_t, DataCollector &> RunCallback;
+
+  /** Create a helper with no sweep point, one replication and one worker. */
+  BatchRunHelper ();
+  virtual ~BatchRunHelper ();
+
+  /**
+   * \param experiment the experiment label of all the jobs.
+   */
+  void SetExperiment (std::string experiment);
+  /**
+   * \param label the label of the new sweep point.
+   * \returns the index of the new sweep point.
+   */
+  uint32_t AddPoint (std::string label);
+  /**
+   * \param replications the number of runs of each sweep point.
+   */
+  void SetReplications (uint32_t replications);
+  /**
+   * \param workers the maximum number of jobs running at the same time,
+   *        or zero to run the jobs in the calling process.
+   */
+  void SetWorkers (uint32_t workers);
+  /**
+   * \param run the RngSeedManager run number of the first job.
+   */
+  void SetBaseRun (uint64_t run);
+  /**
+   * \param callback the callback which runs one job.
+   */
+  void SetRunCallback (RunCallback callback);
+
+  /**
+   * \param point the index of a sweep point.
+   * \param replication the replication index.
+   * \returns the RngSeedManager run number of this job.
+   */
+  uint64_t GetRun (uint32_t point, uint32_t replication) const;
+  /** \returns the number of jobs. */
+  uint32_t GetJobCount (void) const;
+
+  /**
+   * Run all the jobs and aggregate their results.
+   *
+   * \param fileName the name of the CSV output file.
+   * \returns the number of jobs which failed.
+   */
+  uint32_t Run (std::string fileName);
+
+  /**
+   * \returns the job throughput of the last call to Run (), in runs
+   *          per hour of wall clock time.
+   */
+  double GetRunsPerHour (void) const;
+
+private:
+  /**
+   * Run one job and write its results.
+   * \param job the job index.
+   * \param fileName the name of the file to write the results to.
+   * \returns true if the results were written.
+   */
+  bool RunJob (uint32_t job, std::string fileName);
+  /**
+   * \param fileName the name of the CSV output file.
+   * \param job the job index.
+   * \returns the name of the temporary result file of a job.
+   */
+  std::string GetJobFileName (std::string fileName, uint32_t job) const;
+
+  std::string m_experiment;              //!< Experiment label
+  std::vector<std::string> m_points;     //!< Sweep point labels
+  uint32_t m_replications;               //!< Runs per sweep point
+  uint32_t m_workers;                    //!< Maximum number of running jobs
+  uint64_t m_baseRun;                    //!< Run number of the first job
+  RunCallback m_runCallback;             //!< Callback running one job
+  double m_runsPerHour;                  //!< Throughput of the last Run
+};
+
+} // namespace ns3
+
+#endif /* BATCH_RUN_HELPER_H */
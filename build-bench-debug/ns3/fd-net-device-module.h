@@ -0,0 +1,14 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_FD_NET_DEVICE
+    
+
+// Module headers:
+#include "emu-fd-net-device-helper.h"
+#include "fd-net-device-helper.h"
+#include "fd-net-device.h"
+#include "tap-fd-net-device-helper.h"
+#endif
@@ -0,0 +1,339 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2006 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
+ */
+#ifndef PACKET_TAG_LIST_H
+#define PACKET_TAG_LIST_H
+
+/**
+\file   packet-tag-list.h
+\brief  Defines a flat array of Packet tags, including copy-on-write semantics.
+*/
+
+#include <stdint.h>
+#include <cstddef>
+#include <ostream>
+#include "ns3/type-id.h"
+#include "ns3/atomic-counter.h"
+#include "packet-arena.h"
+
+namespace ns3 {
+
+class Tag;
+
+/**
+ * \ingroup packet
+ *
+ * \brief List of the packet tags stored in a packet.
+ *
+ * This class is mostly private to the Packet implementation and users
+ * should never have to access it directly.
+ *
+ * \internal
+ *
+ * The tags are stored in serialized form in a TagData array, which
+ * lives in a single TagBlock allocated from the PacketArena, after a
+ * small header:
+ *
+ *   - \c count is the number of PacketTagList's sharing the block.
+ *
+ *   - \c size and \c capacity are the number of tags in the array and
+ *     the number of tags which fit in the block.  The first block
+ *     holds up to #INITIAL_CAPACITY tags, so that the handful of tags
+ *     carried by a packet live in one cache friendly allocation.
+ *
+ *   - \c index is a table indexed by the low bits of the TypeId uid
+ *     of the tags.  An empty slot means that no tag of this hash is
+ *     present, #COLLISION means that several tags share the slot, and
+ *     any other value is the position of the only such tag, plus one.
+ *     #Peek, #Remove and #Replace thus find or reject the common tags
+ *     in constant time, and only walk the array on collisions.
+ *
+ * \par <b> Copy-on-write </b> is implemented as follows:
+ *
+ *   - Copy constructor (PacketTagList(const PacketTagList & o))
+ *     and assignment (#operator=(const PacketTagList & o)
+ *     share the block of \c o, incrementing the \c count.
+ *
+ *   - #Add, #Remove and #Replace modify the block in place when it is
+ *     not shared, and otherwise first copy it into a new block owned
+ *     by this list.  #Add appends the tag, and grows the block when
+ *     it is full.  #Add does not affect any other PacketTagList's,
+ *     hence this is a \c const function.
+ *
+ *   - The tags are iterated from the most recent one, in the order in
+ *     which the former linked list implementation returned them.
+ *
+ * \par <b> Memory Management: </b>
+ * \n
+ * Packet tags must serialize to a finite maximum size, see TagData
+ */
+class PacketTagList 
+{
+public:
+  /**
+   * Serialized tag.
+   *
+   * See PacketTagList for a discussion of the data structure.
+   *
+   * See TagData::TagData_e for a discussion of the size limit on
+   * tag serialization.
+   */
+  struct TagData
+  {
+    /**
+     * \brief Packet Tag maximum size
+     *
+     * The maximum size (in bytes) of a Tag is stored
+     * in this constant.
+     *
+     * \internal
+     * ns3:Ipv6PacketInfoTag needs 19 bytes.  The current
+     * implementation allows 21 bytes, which, with the 2 bytes
+     * of \c #tid, gives TagData a size of 24 bytes.
+     */
+    enum TagData_e
+    {
+      MAX_SIZE = 21           /**< Size of serialization buffer #data */
+  };
+
+    uint8_t data[MAX_SIZE];   /**< Serialization buffer */
+    TypeId tid;               /**< Type of the tag serialized into #data */
+  };  /* struct TagData */
+
+  /**
+   * Create a new PacketTagList.
+   */
+  inline PacketTagList ();
+  /**
+   * Copy constructor
+   *
+   * \param [in] o The PacketTagList to copy.
+   *
+   * This makes a light-weight copy by sharing the \ref TagData
+   * of \pname{o}.
+   */
+  inline PacketTagList (PacketTagList const &o);
+  /**
+   * Assignment
+   *
+   * \param [in] o The PacketTagList to copy.
+   * \returns the copied object
+   *
+   * This makes a light-weight copy by #RemoveAll, then
+   * sharing the \ref TagData of \pname{o}.
+   */
+  inline PacketTagList &operator = (PacketTagList const &o);
+  /**
+   * Destructor
+   *
+   * #RemoveAll's the tags.
+   */
+  inline ~PacketTagList ();
+
+  /**
+   * Add a tag to the list.
+   *
+   * \param [in] tag The tag to add
+   */
+  void Add (Tag const&tag) const;
+  /**
+   * Remove tag from the list.
+   *
+   * \param [in,out] tag The tag type to remove.  If found,
+   *          \pname{tag} is set to the value of the tag found.
+   * \returns True if \pname{tag} is found, false otherwise.
+   */
+  bool Remove (Tag &tag);
+  /**
+   * Replace the value of a tag.
+   *
+   * \param [in] tag The tag type to replace.  To get the old
+   *        value of the tag, use #Peek first.
+   * \returns True if \pname{tag} is found, false otherwise.
+   *        If \pname{tag} wasn't found, Add is performed instead (so
+   *        the list is guaranteed to have the new tag value either way).
+   */
+  bool Replace (Tag &tag);
+  /**
+   * Find a tag and return its value.
+   *
+   * \param [in,out] tag The tag type to find.  If found,
+   *          \pname{tag} is set to the value of the tag found.
+   * \returns True if \pname{tag} is found, false otherwise.
+   */
+  bool Peek (Tag &tag) const;
+  /**
+   * Remove all tags from this list.
+   */
+  inline void RemoveAll (void);
+  /**
+   * \returns pointer to the first (oldest) tag of the list
+   */
+  inline const struct PacketTagList::TagData *Begin (void) const;
+  /**
+   * \returns pointer past the last (most recent) tag of the list
+   */
+  inline const struct PacketTagList::TagData *End (void) const;
+
+private:
+  /** Sizes of the tag blocks. */
+  enum TagBlock_e
+  {
+    INITIAL_CAPACITY = 4,     /**< Number of tags of the first block */
+    INDEX_SIZE = 16,          /**< Number of slots of the index */
+    COLLISION = 0xff          /**< Index slot shared by several tags */
+  };
+
+  /**
+   * Header of the block holding the tags, which follow it.
+   */
+  struct TagBlock
+  {
+    uint32_t count;               /**< Number of lists sharing the block */
+    uint16_t size;                /**< Number of tags */
+    uint16_t capacity;            /**< Number of tags which fit in the block */
+    uint8_t index[INDEX_SIZE];    /**< Position plus one of the tag of each uid hash */
+
+    /** \returns the tags stored after the header. */
+    inline struct TagData *GetTags (void);
+  };
+
+  /**
+   * \param [in] tid The type of a tag.
+   * \returns The position of the tag in the block, or -1 if not found.
+   */
+  int32_t Find (TypeId tid) const;
+  /**
+   * Make sure that this list owns its block, and that the block can
+   * hold \pname{capacity} tags.
+   *
+   * \param [in] capacity The number of tags needed.
+   */
+  void Reserve (uint32_t capacity);
+  /**
+   * Rebuild the index of the block.
+   *
+   * \param [in] block The block to index.
+   */
+  static void Reindex (struct TagBlock * block);
+  /**
+   * \param [in] capacity The number of tags needed.
+   * \returns A new block with a count of one, no tags and at least
+   *          \pname{capacity} slots.
+   */
+  static struct TagBlock * Allocate (uint32_t capacity);
+  /**
+   * Drop one reference to \pname{block}, and release it to the
+   * PacketArena if no other list shares it.
+   *
+   * \param [in] block Pointer to the block.
+   */
+  static inline void Release (struct TagBlock * block);
+
+  /**
+   * Pointer to the block holding the tags, or 0 if the list is empty
+   */
+  struct TagBlock *m_block;
+};
+
+} // namespace ns3
+
+/****************************************************
+ *  Implementation of inline methods for performance
+ ****************************************************/
+
+namespace ns3 {
+
+struct PacketTagList::TagData *
+PacketTagList::TagBlock::GetTags (void)
+{
+  return reinterpret_cast<struct TagData *> (this + 1);
+}
+
+PacketTagList::PacketTagList ()
+  : m_block (0)
+{
+}
+
+PacketTagList::PacketTagList (PacketTagList const &o)
+  : m_block (o.m_block)
+{
+  if (m_block != 0)
+    {
+      AtomicIncrement (m_block->count);
+    }
+}
+
+PacketTagList &
+PacketTagList::operator = (PacketTagList const &o)
+{
+  // self assignment
+  if (m_block == o.m_block) 
+    {
+      return *this;
+    }
+  RemoveAll ();
+  m_block = o.m_block;
+  if (m_block != 0) 
+    {
+      AtomicIncrement (m_block->count);
+    }
+  return *this;
+}
+
+PacketTagList::~PacketTagList ()
+{
+  RemoveAll ();
+}
+
+void
+PacketTagList::RemoveAll (void)
+{
+  if (m_block != 0)
+    {
+      Release (m_block);
+      m_block = 0;
+    }
+}
+
+const struct PacketTagList::TagData *
+PacketTagList::Begin (void) const
+{
+  return m_block != 0 ? m_block->GetTags () : 0;
+}
+
+const struct PacketTagList::TagData *
+PacketTagList::End (void) const
+{
+  return m_block != 0 ? m_block->GetTags () + m_block->size : 0;
+}
+
+void
+PacketTagList::Release (struct TagBlock *block)
+{
+  if (AtomicDecrement (block->count) == 0)
+    {
+      PacketArena::Deallocate (block, sizeof (struct TagBlock)
+                               + block->capacity * sizeof (struct TagData));
+    }
+}
+
+} // namespace ns3
+
+#endif /* PACKET_TAG_LIST_H */
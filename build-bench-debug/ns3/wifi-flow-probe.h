@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef WIFI_FLOW_PROBE_H
+#define WIFI_FLOW_PROBE_H
+
+#include <vector>
+
+#include "ns3/flow-probe.h"
+#include "ns3/flat-hash-map.h"
+#include "ns3/mac48-address.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/dmg-wifi-mac.h"
+
+namespace ns3 {
+
+class FlowMonitor;
+class WifiNetDevice;
+class WifiMacHeader;
+
+/// \ingroup flow-monitor
+/// \brief Class that monitors the MAC and PHY layers of a WifiNetDevice
+///
+/// The probe connects callbacks to the trace sources of the MacLow, of
+/// the EdcaTxopN queues (the block acks of their BlockAckManager), of
+/// the WifiPhy and, for DMG devices, of the DmgWifiMac of the device,
+/// through their object pointers.  It counts, per link, i.e., per peer
+/// station and TID, the MPDUs sent and received, their retransmissions,
+/// the A-MPDUs and the MPDUs acknowledged or lost by the block acks, and
+/// per peer station and local antenna sector, the SNR of the received
+/// frames and the sector level sweeps completed.
+///
+/// The probe is added to the FlowMonitor like the IP probes, and its
+/// statistics are part of the XML output of the probes.  It does not
+/// report any IP flow to the FlowMonitor.
+class WifiFlowProbe : public FlowProbe
+{
+public:
+  /// \brief Constructor
+  /// \param monitor the FlowMonitor this probe is associated with
+  /// \param device the WifiNetDevice this probe is associated with
+  WifiFlowProbe (Ptr<FlowMonitor> monitor, Ptr<WifiNetDevice> device);
+  virtual ~WifiFlowProbe ();
+
+  /// Register this type.
+  /// \return The TypeId.
+  static TypeId GetTypeId (void);
+
+  /// The TID of the non-QoS data frames
+  static const uint8_t NON_QOS_TID = 16;
+
+  /// Statistics of the data frames exchanged with a peer station on a TID
+  struct LinkStats
+  {
+    LinkStats ();
+
+    Mac48Address peer;        //!< The address of the peer station
+    uint8_t tid;              //!< The TID, or NON_QOS_TID
+    uint64_t txMpdus;         //!< Number of MPDUs sent, retransmissions included
+    uint64_t txBytes;         //!< Number of bytes of the MPDUs sent
+    uint64_t txRetries;       //!< Number of MPDUs retransmitted
+    uint64_t txAmpdus;        //!< Number of A-MPDUs sent
+    uint64_t txAmpduMpdus;    //!< Number of MPDUs in the A-MPDUs sent
+    uint64_t txAmpduBytes;    //!< Number of bytes of the A-MPDUs sent
+    uint32_t maxAmpduMpdus;   //!< Largest number of MPDUs in an A-MPDU
+    uint64_t blockAcks;       //!< Number of block acks received
+    uint64_t missedBlockAcks; //!< Number of block acks missed
+    uint64_t baAckedMpdus;    //!< Number of MPDUs acknowledged by block acks
+    uint64_t baLostMpdus;     //!< Number of MPDUs not acknowledged, block acks missed included
+    uint64_t rxMpdus;         //!< Number of MPDUs received
+    uint64_t rxBytes;         //!< Number of bytes of the MPDUs received
+    uint64_t rxRetries;       //!< Number of retransmitted MPDUs received
+  };
+
+  /// Statistics of the frames received from a peer station on a sector
+  struct SectorStats
+  {
+    SectorStats ();
+
+    Mac48Address peer;        //!< The address of the peer station
+    uint8_t sector;           //!< The sector of the local antenna, 0 without directional antenna
+    uint64_t rxFrames;        //!< Number of frames received
+    double snrSum;            //!< Sum of the SNR of the frames, in dB
+    double snrMin;            //!< Lowest SNR, in dB
+    double snrMax;            //!< Highest SNR, in dB
+    uint32_t slsCompleted;    //!< Number of sector level sweeps which selected the sector
+  };
+
+  /// \returns the statistics of all the links, in the order of their first frame
+  const std::vector<LinkStats> & GetLinkStats (void) const;
+  /// \param peer the address of the peer station
+  /// \param tid the TID
+  /// \returns the statistics of the link, all 0 if it has not been used
+  LinkStats GetLinkStats (Mac48Address peer, uint8_t tid) const;
+  /// \returns the statistics of all the sectors, in the order of their first frame
+  const std::vector<SectorStats> & GetSectorStats (void) const;
+  /// \param peer the address of the peer station
+  /// \param sector the sector of the local antenna
+  /// \returns the statistics of the sector, all 0 if it has not been used
+  SectorStats GetSectorStats (Mac48Address peer, uint8_t sector) const;
+
+  /// Serializes the link and sector statistics to an std::ostream in XML format
+  /// \param os the output stream
+  /// \param indent number of spaces to use as base indentation level
+  /// \param index FlowProbe index
+  virtual void SerializeToXmlStream (std::ostream &os, int indent, uint32_t index) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// Log an MPDU sent by the MacLow
+  /// \param hdr the header of the MPDU
+  /// \param size the size of the MPDU
+  void TxMpduLogger (const WifiMacHeader &hdr, uint32_t size);
+  /// Log an A-MPDU sent by the MacLow
+  /// \param recipient the address of the recipient
+  /// \param tid the TID of the MPDUs
+  /// \param nMpdus the number of MPDUs
+  /// \param size the size of the MPDUs
+  void TxAmpduLogger (Mac48Address recipient, uint8_t tid, uint32_t nMpdus, uint32_t size);
+  /// Log a block ack received, or missed, by an EdcaTxopN
+  /// \param recipient the address of the recipient
+  /// \param tid the TID of the MPDUs
+  /// \param nSuccessfulMpdus the number of MPDUs acknowledged
+  /// \param nFailedMpdus the number of MPDUs not acknowledged
+  void BlockAckLogger (Mac48Address recipient, uint8_t tid, uint32_t nSuccessfulMpdus, uint32_t nFailedMpdus);
+  /// Log a frame received by the WifiPhy
+  /// \param packet the frame
+  /// \param channelFreqMhz the frequency of the channel
+  /// \param channelNumber the channel number
+  /// \param rate the data rate
+  /// \param preamble the preamble
+  /// \param txVector the TXVECTOR of the frame
+  /// \param aMpdu the A-MPDU information of the frame
+  /// \param signalNoise the signal and noise powers, in dBm
+  void RxLogger (Ptr<const Packet> packet, uint16_t channelFreqMhz, uint16_t channelNumber,
+                 uint32_t rate, WifiPreamble preamble, WifiTxVector txVector,
+                 struct mpduInfo aMpdu, struct signalNoiseDbm signalNoise);
+  /// Log a sector level sweep completed by the DmgWifiMac
+  /// \param peer the address of the peer station
+  /// \param accessPeriod the access period of the sweep
+  /// \param sector the sector selected
+  /// \param antenna the antenna selected
+  void SlsLogger (Mac48Address peer, ChannelAccessPeriod accessPeriod, SECTOR_ID sector, ANTENNA_ID antenna);
+
+  /// \param peer the address of the peer station
+  /// \param id the TID or the sector
+  /// \returns the key of the link or sector in the indexes
+  static uint64_t GetKey (Mac48Address peer, uint8_t id);
+  /// \param peer the address of the peer station
+  /// \param tid the TID
+  /// \returns the statistics of the link, created if needed
+  LinkStats & GetLink (Mac48Address peer, uint8_t tid);
+  /// \param peer the address of the peer station
+  /// \param sector the sector of the local antenna
+  /// \returns the statistics of the sector, created if needed
+  SectorStats & GetSector (Mac48Address peer, uint8_t sector);
+
+  Ptr<WifiNetDevice> m_device;                    //!< The device
+  Mac48Address m_address;                         //!< The address of the device
+  std::vector<LinkStats> m_links;                 //!< The statistics of the links
+  FlatHashMap<uint64_t, uint32_t> m_linkIndex;    //!< (peer, TID) --> index in m_links
+  std::vector<SectorStats> m_sectors;             //!< The statistics of the sectors
+  FlatHashMap<uint64_t, uint32_t> m_sectorIndex;  //!< (peer, sector) --> index in m_sectors
+};
+
+
+} // namespace ns3
+
+#endif /* WIFI_FLOW_PROBE_H */
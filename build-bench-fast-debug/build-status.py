@@ -0,0 +1,8 @@
+#! /usr/bin/env python
+
+# Programs that are runnable.
+ns3_runnable_programs = ['build-bench-fast-debug/scratch/ns3.25-evaluate_fst_mechanism-fast-debug', 'build-bench-fast-debug/scratch/ns3.25-evaluate_tcp_sack_blockage-fast-debug', 'build-bench-fast-debug/scratch/subdir/ns3.25-subdir-fast-debug', 'build-bench-fast-debug/scratch/ns3.25-evaluate_beamforming-fast-debug', 'build-bench-fast-debug/scratch/ns3.25-evaluate_dmg_throughput-fast-debug', 'build-bench-fast-debug/scratch/ns3.25-evaluate_service_period-fast-debug', 'build-bench-fast-debug/scratch/ns3.25-evaluate_tcp_congestion_control-fast-debug', 'build-bench-fast-debug/scratch/ns3.25-test_fst-fast-debug', 'build-bench-fast-debug/scratch/ns3.25-evaluate_relay_operation-fast-debug']
+
+# Scripts that are runnable.
+ns3_runnable_scripts = []
+
@@ -0,0 +1,196 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_H
+#define BINARY_TRACE_H
+
+#include <stdint.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "ns3/simple-ref-count.h"
+#include "async-file-writer.h"
+
+namespace ns3 {
+
+/**
+ * \brief An event of a binary trace
+ *
+ * The fixed schema of the binary traces: one record per packet event
+ * of a device, with the PHY information when the device has some.
+ */
+struct BinaryTraceRecord
+{
+  /** The kind of event, as in the ascii traces */
+  enum Event
+  {
+    ENQUEUE = 0,        //!< '+' a packet is queued
+    DEQUEUE = 1,        //!< '-' a packet leaves the queue
+    DROP = 2,           //!< 'd' a packet is dropped
+    TX = 3,             //!< 't' a packet is transmitted
+    RX = 4              //!< 'r' a packet is received
+  };
+
+  /** No MCS, or no sector, is known for this event. */
+  static const uint8_t NONE = 0xff;
+
+  int64_t time;         //!< Simulation time, in nanoseconds
+  uint32_t node;        //!< Node identifier
+  uint32_t device;      //!< Device index in the node
+  uint8_t event;        //!< The Event
+  uint32_t size;        //!< Packet size, in bytes
+  uint8_t mcs;          //!< MCS of the PHY frame, or NONE
+  uint8_t sector;       //!< Antenna sector, or NONE
+  float snr;            //!< Signal to noise ratio in dB, 0 if unknown
+};
+
+/**
+ * \brief A chunk of a binary trace, stored by column
+ *
+ * The records of a chunk are the elements of the same index in all
+ * the columns.
+ */
+struct BinaryTraceChunk
+{
+  std::vector<int64_t> time;     //!< BinaryTraceRecord::time column
+  std::vector<uint32_t> node;    //!< BinaryTraceRecord::node column
+  std::vector<uint32_t> device;  //!< BinaryTraceRecord::device column
+  std::vector<uint8_t> event;    //!< BinaryTraceRecord::event column
+  std::vector<uint32_t> size;    //!< BinaryTraceRecord::size column
+  std::vector<uint8_t> mcs;      //!< BinaryTraceRecord::mcs column
+  std::vector<uint8_t> sector;   //!< BinaryTraceRecord::sector column
+  std::vector<float> snr;        //!< BinaryTraceRecord::snr column
+
+  /** \returns The number of records. */
+  uint32_t GetN (void) const;
+  /**
+   * \param i A record index.
+   * \returns The record.
+   */
+  BinaryTraceRecord Get (uint32_t i) const;
+  /**
+   * Append a record.
+   * \param record The record.
+   */
+  void Add (BinaryTraceRecord const &record);
+  /** Remove all the records. */
+  void Clear (void);
+};
+
+/**
+ * \brief A compact, columnar alternative to the ascii traces
+ *
+ * The records are gathered in chunks, and each chunk is written by
+ * column: the time as varint deltas, the identifiers and the sizes as
+ * varints, the event, MCS and sector as bytes and the SNR as floats.
+ * A record then takes about a dozen bytes instead of a text line with
+ * the whole packet printed, and a reader can decode a chunk column by
+ * column.
+ *
+ * The file starts with the 32 bit MAGIC and the 16 bit VERSION and 16
+ * bit 0, in the byte order of the writing host.  Each chunk is the 32
+ * bit number of records and the 32 bit length of the columns, followed
+ * by the columns.
+ *
+ * The chunks are written through an AsyncFileWriter, by a background
+ * thread if requested.  The records are in the file after Flush () or
+ * Close (); the destructor closes the file.
+ */
+class BinaryTraceWriter : public SimpleRefCount<BinaryTraceWriter>
+{
+public:
+  BinaryTraceWriter ();
+  /** Close the file. */
+  ~BinaryTraceWriter ();
+
+  /**
+   * Create the file.
+   *
+   * \param filename The name of the file.
+   * \param chunkRecords The number of records per chunk.
+   * \param threaded Write the chunks from a background thread.
+   * \returns true if the file was created.
+   */
+  bool Open (std::string const &filename, uint32_t chunkRecords = 4096, bool threaded = true);
+  /** \returns true if a write into the file failed. */
+  bool Fail (void) const;
+  /**
+   * Add a record to the trace.
+   * \param record The record.
+   */
+  void Write (BinaryTraceRecord const &record);
+  /** Write the pending records into the file. */
+  void Flush (void);
+  /** Write the pending records and close the file. */
+  void Close (void);
+
+  static const uint32_t MAGIC = 0x5433534e;     //!< "NS3T" in little endian
+  static const uint16_t VERSION = 1;            //!< Format version
+
+private:
+  /** Encode the pending records as a chunk. */
+  void WriteChunk (void);
+
+  AsyncFileWriter m_writer;           //!< The file
+  BinaryTraceChunk m_chunk;           //!< Pending records
+  uint32_t m_chunkRecords;            //!< Records per chunk
+  std::vector<uint8_t> m_encoded;     //!< Encoding buffer
+#ifdef NS3_MTP
+  SystemMutex m_mutex;                //!< Serializes the writes
+#endif /* NS3_MTP */
+};
+
+/**
+ * \brief Read a binary trace written by BinaryTraceWriter
+ */
+class BinaryTraceReader
+{
+public:
+  BinaryTraceReader ();
+
+  /**
+   * Open a binary trace.
+   * \param filename The name of the file.
+   * \returns false if the file cannot be read or is not a binary trace.
+   */
+  bool Open (std::string const &filename);
+  /**
+   * Read the next chunk of records.
+   * \param [out] chunk The records.
+   * \returns false at the end of the file, or if the file is corrupted.
+   */
+  bool ReadChunk (BinaryTraceChunk &chunk);
+  /**
+   * Read the next record.
+   * \param [out] record The record.
+   * \returns false at the end of the file, or if the file is corrupted.
+   */
+  bool Read (BinaryTraceRecord &record);
+  /** \returns true if the file is corrupted. */
+  bool Fail (void) const;
+
+private:
+  std::ifstream m_file;               //!< The file
+  std::vector<uint8_t> m_encoded;     //!< Decoding buffer
+  BinaryTraceChunk m_chunk;           //!< Chunk for Read
+  uint32_t m_next;                    //!< Next record of m_chunk for Read
+  uint64_t m_remaining;               //!< Bytes of the file not read yet
+  bool m_fail;                        //!< Corrupted file
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_H */
@@ -0,0 +1,158 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include <stdint.h>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler declaration.
+ */
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup simulator
+ *
+ * \brief Measure the wall clock time spent in each scheduled function.
+ *
+ * The simulator implementation calls Invoke() instead of
+ * EventImpl::Invoke() when profiling is enabled.  The wall clock
+ * time and the number of events are then accumulated per scheduled
+ * function and per node context, together with a histogram of the
+ * event durations with power of two bins in nanoseconds.
+ *
+ * The scheduled function is identified by the address returned by
+ * EventImpl::GetFunction(), which is resolved to a symbol name in the
+ * reports when the function is exported by a shared library, and
+ * otherwise by the type of the event.  With DefaultSimulatorImpl, set
+ * the \c EventProfiling attribute to enable the profiler:
+ *
+ * \code
+ *   ./waf --run "my-program --ns3::DefaultSimulatorImpl::EventProfiling=true"
+ * \endcode
+ *
+ * which writes the reports \c event-profile.txt and \c event-profile.json
+ * at the end of Simulator::Run().
+ */
+class EventProfiler
+{
+public:
+  /** Number of bins of the duration histograms. */
+  static const uint32_t HISTOGRAM_BINS = 32;
+
+  /** The statistics of a function or a context. */
+  struct Stats
+  {
+    Stats ();
+    /**
+     * Account for one event.
+     * \param [in] duration The wall clock duration of the event, in ns.
+     */
+    void Add (uint64_t duration);
+    /**
+     * Add the statistics of another function or context.
+     * \param [in] other The statistics to add.
+     */
+    void Merge (const Stats &other);
+
+    uint64_t count;   //!< Number of events
+    uint64_t total;   //!< Total wall clock time, in ns
+    uint64_t max;     //!< Longest event, in ns
+    /**
+     * Number of events which lasted [2^i, 2^(i+1)) ns, the first bin
+     * including zero and the last one all the longer events.
+     */
+    uint64_t histogram[HISTOGRAM_BINS];
+  };
+
+  EventProfiler ();
+
+  /**
+   * Invoke an event and account for its wall clock time.
+   *
+   * \param [in] event The event to invoke.
+   * \param [in] context The context of the event.
+   */
+  void Invoke (EventImpl *event, uint32_t context);
+  /** Forget all the statistics. */
+  void Clear (void);
+
+  /** \returns The number of events invoked. */
+  uint64_t GetEventCount (void) const;
+  /** \returns The wall clock time spent in the events, in ns. */
+  uint64_t GetTotalTime (void) const;
+  /**
+   * \returns The statistics per scheduled function name, which merge
+   * the functions which resolve to the same name.
+   */
+  std::map<std::string, Stats> GetFunctionStats (void) const;
+
+  /**
+   * Print the functions and the contexts sorted by decreasing time.
+   * \param [in] os The output stream.
+   */
+  void Print (std::ostream &os) const;
+  /**
+   * Print the statistics, with the histograms, as a JSON object.
+   * \param [in] os The output stream.
+   */
+  void PrintJson (std::ostream &os) const;
+  /**
+   * Write the reports into <prefix>.txt and <prefix>.json.
+   * \param [in] prefix The file name prefix.
+   */
+  void Write (std::string prefix) const;
+
+private:
+  /**
+   * The identity of a scheduled function: its address, if known, and
+   * the mangled type name of the event.
+   */
+  typedef std::pair<const void *, const char *> FunctionKey;
+
+  /**
+   * \param [in] key A scheduled function.
+   * \returns The demangled name of the function.
+   */
+  static std::string GetFunctionName (FunctionKey key);
+
+  /** The statistics per scheduled function. */
+  std::map<FunctionKey, Stats> m_functions;
+  /** The statistics per context. */
+  std::map<uint32_t, Stats> m_contexts;
+  /** The function of the last event, to avoid most map lookups. */
+  FunctionKey m_lastFunction;
+  /** The statistics of the function of the last event. */
+  Stats *m_lastStats;
+  /** Number of events. */
+  uint64_t m_count;
+  /** Total wall clock time, in ns. */
+  uint64_t m_total;
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
@@ -0,0 +1,362 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+#include <stdint.h>
+#include <vector>
+#include "assert.h"
+
+/**
+ * \file
+ * \ingroup core
+ * ns3::FlatHashMap declaration and implementation.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup core
+ * \brief The default hash of the FlatHashMap keys: the integer types.
+ */
+template <typename Key>
+struct FlatHashMapHash
+{
+  /**
+   * \param key an integer key.
+   * \returns the hash of the key.
+   */
+  uint32_t operator () (Key key) const
+  {
+    uint64_t h = static_cast<uint64_t> (key);
+    // the finalizer of MurmurHash3, which spreads all the bits
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return static_cast<uint32_t> (h);
+  }
+};
+
+/**
+ * \ingroup core
+ * \brief A hash table with open addressing
+ *
+ * The entries are stored in a single array, and a key is looked up by
+ * probing the slots which follow the one of its hash, until the key or
+ * an empty slot is found.  Erase moves the following entries of the
+ * same probe sequence back, so that there are no tombstones and the
+ * lookups never slow down.  The array doubles when it is 3/4 full.
+ *
+ * Compared to a std::map, a lookup touches one or two cache lines
+ * instead of a path in a tree, and an insertion does not allocate.
+ * The order of the iteration is unspecified, and an insertion or an
+ * erasure invalidates the iterators and the pointers to the values:
+ * the entries to remove while iterating must be erased afterwards.
+ *
+ * \tparam Key the type of the keys, copyable and comparable with ==.
+ * \tparam Value the type of the values, copyable and default
+ *         constructible.
+ * \tparam Hash a functor returning the 32 bit hash of a key.
+ */
+template <typename Key, typename Value, typename Hash = FlatHashMapHash<Key> >
+class FlatHashMap
+{
+public:
+  /** An entry of the table. */
+  struct Entry
+  {
+    Key first;          //!< The key
+    Value second;       //!< The value
+  };
+
+  /** Iterator on the entries, like a std::map iterator. */
+  class Iterator
+  {
+public:
+    /**
+     * \param map the table.
+     * \param slot the current slot.
+     */
+    Iterator (FlatHashMap *map, uint32_t slot)
+      : m_map (map),
+        m_slot (slot)
+    {
+      Skip ();
+    }
+    /** \returns the current entry. */
+    Entry &operator * (void) const
+    {
+      return m_map->m_entries[m_slot];
+    }
+    /** \returns the current entry. */
+    Entry *operator -> (void) const
+    {
+      return &m_map->m_entries[m_slot];
+    }
+    /** \returns this iterator, moved to the next entry. */
+    Iterator &operator ++ (void)
+    {
+      m_slot++;
+      Skip ();
+      return *this;
+    }
+    /**
+     * \param o another iterator.
+     * \returns true if both iterators are on the same slot.
+     */
+    bool operator == (Iterator const &o) const
+    {
+      return m_slot == o.m_slot;
+    }
+    /**
+     * \param o another iterator.
+     * \returns true if the iterators are on different slots.
+     */
+    bool operator != (Iterator const &o) const
+    {
+      return m_slot != o.m_slot;
+    }
+private:
+    /** Move to the next used slot. */
+    void Skip (void)
+    {
+      while (m_slot < m_map->m_used.size () && !m_map->m_used[m_slot])
+        {
+          m_slot++;
+        }
+    }
+    FlatHashMap *m_map;   //!< The table
+    uint32_t m_slot;      //!< The current slot
+  };
+
+  /**
+   * Create an empty table.
+   * \param capacity the number of slots to allocate first, rounded up
+   *        to a power of two.
+   */
+  FlatHashMap (uint32_t capacity = 16)
+    : m_size (0)
+  {
+    uint32_t slots = 16;
+    while (slots < capacity)
+      {
+        slots *= 2;
+      }
+    Allocate (slots);
+  }
+
+  /** \returns the number of entries. */
+  uint32_t GetSize (void) const
+  {
+    return m_size;
+  }
+  /** \returns true if there is no entry. */
+  bool IsEmpty (void) const
+  {
+    return m_size == 0;
+  }
+
+  /**
+   * \param key a key.
+   * \returns the value of this key, or 0 if the key is not in the table.
+   */
+  Value *Find (Key const &key)
+  {
+    uint32_t slot;
+    return Lookup (key, slot) ? &m_entries[slot].second : 0;
+  }
+  /**
+   * \param key a key.
+   * \returns the value of this key, or 0 if the key is not in the table.
+   */
+  Value const *Find (Key const &key) const
+  {
+    uint32_t slot;
+    return Lookup (key, slot) ? &m_entries[slot].second : 0;
+  }
+
+  /**
+   * Add a key, unless it is already in the table.
+   * \param key the key.
+   * \param value the value of the key, if added.
+   * \param [out] inserted true if the key was added.
+   * \returns the value of the key.
+   */
+  Value &Insert (Key const &key, Value const &value, bool &inserted)
+  {
+    uint32_t slot;
+    inserted = !Lookup (key, slot);
+    if (inserted)
+      {
+        if ((m_size + 1) * 4 > m_used.size () * 3)
+          {
+            Grow ();
+            Lookup (key, slot);
+          }
+        m_used[slot] = 1;
+        m_entries[slot].first = key;
+        m_entries[slot].second = value;
+        m_size++;
+      }
+    return m_entries[slot].second;
+  }
+  /**
+   * \param key a key.
+   * \returns the value of this key, added with a default value if
+   *          the key is not in the table.
+   */
+  Value &operator [] (Key const &key)
+  {
+    bool inserted;
+    return Insert (key, Value (), inserted);
+  }
+
+  /**
+   * Remove a key.
+   * \param key the key.
+   * \returns true if the key was in the table.
+   */
+  bool Erase (Key const &key)
+  {
+    uint32_t slot;
+    if (!Lookup (key, slot))
+      {
+        return false;
+      }
+    EraseSlot (slot);
+    return true;
+  }
+  /** Remove all the entries, keeping the allocated slots. */
+  void Clear (void)
+  {
+    for (uint32_t i = 0; i < m_used.size (); i++)
+      {
+        if (m_used[i])
+          {
+            m_entries[i] = Entry ();
+            m_used[i] = 0;
+          }
+      }
+    m_size = 0;
+  }
+
+  /** \returns an iterator on the first entry. */
+  Iterator Begin (void)
+  {
+    return Iterator (this, 0);
+  }
+  /** \returns the iterator past the last entry. */
+  Iterator End (void)
+  {
+    return Iterator (this, m_used.size ());
+  }
+
+private:
+  /**
+   * \param key a key.
+   * \returns the first slot of the probe sequence of the key.
+   */
+  uint32_t GetHome (Key const &key) const
+  {
+    return m_hash (key) & m_mask;
+  }
+  /**
+   * \param key a key.
+   * \param [out] slot the slot of the key if found, or the empty
+   *        slot where it would be inserted.
+   * \returns true if the key is in the table.
+   */
+  bool Lookup (Key const &key, uint32_t &slot) const
+  {
+    slot = GetHome (key);
+    while (m_used[slot])
+      {
+        if (m_entries[slot].first == key)
+          {
+            return true;
+          }
+        slot = (slot + 1) & m_mask;
+      }
+    return false;
+  }
+  /**
+   * Empty a slot, and move back the entries which follow it in their
+   * probe sequence.
+   * \param slot the slot.
+   */
+  void EraseSlot (uint32_t slot)
+  {
+    uint32_t hole = slot;
+    uint32_t next = (hole + 1) & m_mask;
+    while (m_used[next])
+      {
+        uint32_t home = GetHome (m_entries[next].first);
+        // move the entry back unless its home is in (hole, next]
+        if (((next - home) & m_mask) >= ((next - hole) & m_mask))
+          {
+            m_entries[hole] = m_entries[next];
+            hole = next;
+          }
+        next = (next + 1) & m_mask;
+      }
+    m_entries[hole] = Entry ();
+    m_used[hole] = 0;
+    m_size--;
+  }
+  /**
+   * Allocate empty slots.
+   * \param slots the number of slots, a power of two.
+   */
+  void Allocate (uint32_t slots)
+  {
+    NS_ASSERT ((slots & (slots - 1)) == 0);
+    m_entries.assign (slots, Entry ());
+    m_used.assign (slots, 0);
+    m_mask = slots - 1;
+  }
+  /** Double the number of slots. */
+  void Grow (void)
+  {
+    std::vector<Entry> entries;
+    std::vector<uint8_t> used;
+    entries.swap (m_entries);
+    used.swap (m_used);
+    Allocate (used.size () * 2);
+    for (uint32_t i = 0; i < used.size (); i++)
+      {
+        if (used[i])
+          {
+            uint32_t slot;
+            Lookup (entries[i].first, slot);
+            m_used[slot] = 1;
+            m_entries[slot] = entries[i];
+          }
+      }
+  }
+
+  std::vector<Entry> m_entries;   //!< The slots
+  std::vector<uint8_t> m_used;    //!< Whether each slot holds an entry
+  uint32_t m_mask;                //!< Number of slots minus one
+  uint32_t m_size;                //!< Number of entries
+  Hash m_hash;                    //!< The hash functor
+};
+
+} // namespace ns3
+
+#endif /* FLAT_HASH_MAP_H */
@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PACKET_ARENA_H
+#define PACKET_ARENA_H
+
+#include <stdint.h>
+#include <ostream>
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ *
+ * \brief Memory allocator shared by the packet data structures
+ *
+ * The Buffer data, the PacketMetadata data, the ByteTagList data and
+ * the PacketTagList blocks are all allocated from this arena.  The
+ * blocks are rounded up to power of two size classes, from 16 bytes
+ * to 64 KiB, and the released blocks are kept in one free list per
+ * class, so that a block released by one kind of object can be reused
+ * by another one of the same size class.  Larger blocks are returned
+ * to the system immediately.  Each free list keeps at most 4 MiB.
+ *
+ * Reset () releases the free lists and restarts the statistics; it is
+ * scheduled by the NodeList to run at Simulator::Destroy (), so that
+ * the memory of a simulation is not kept by the next one.
+ *
+ * When configured with --enable-mtp, the packets may be released by
+ * any thread: the arena then forwards all the requests to the system
+ * allocator and does not keep statistics.
+ */
+class PacketArena
+{
+public:
+  /**
+   * \brief The statistics of the arena
+   */
+  struct Stats
+  {
+    uint64_t allocations;       //!< Number of blocks handed out
+    uint64_t reuses;            //!< Number of blocks taken from a free list
+    uint64_t liveObjects;       //!< Number of blocks in use
+    uint64_t liveBytes;         //!< Size of the blocks in use
+    uint64_t peakBytes;         //!< Largest liveBytes since the last Reset
+    uint64_t cachedBytes;       //!< Size of the blocks in the free lists
+  };
+
+  /**
+   * \param size the requested size, in bytes.
+   * \returns a block of GetBlockSize (size) bytes.
+   */
+  static uint8_t *Allocate (uint32_t size);
+  /**
+   * \param block a block returned by Allocate.
+   * \param size the size requested for this block, or the size of the
+   *        block.
+   */
+  static void Deallocate (void *block, uint32_t size);
+  /**
+   * \param size the requested size, in bytes.
+   * \returns the size of the block which Allocate would return.
+   */
+  static uint32_t GetBlockSize (uint32_t size);
+
+  /**
+   * Release the free lists, and restart the statistics from the blocks
+   * which are still in use.
+   */
+  static void Reset (void);
+  /** \returns the statistics of the arena. */
+  static Stats GetStats (void);
+  /**
+   * Print the statistics of the arena.
+   * \param os the output stream.
+   */
+  static void PrintStats (std::ostream &os);
+};
+
+} // namespace ns3
+
+#endif /* PACKET_ARENA_H */
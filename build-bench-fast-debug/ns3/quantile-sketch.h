@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#ifndef NS3_QUANTILE_SKETCH_H
+#define NS3_QUANTILE_SKETCH_H
+
+#include <vector>
+#include <stdint.h>
+#include <ostream>
+#include <string>
+
+namespace ns3 {
+
+/**
+ * \brief Summary of the distribution of positive values, with a
+ * bounded relative error on the quantiles.
+ *
+ * The values are counted in bins of exponentially growing width: bin
+ * \a i holds the values in (gamma^(i-1), gamma^i], with
+ * gamma = (1 + a) / (1 - a) for a relative accuracy \a a.  Any quantile
+ * is then known within a factor (1 +- a) of the exact value, e.g.,
+ * 1 us on a delay of 100 us with a = 1%, whatever the range of the
+ * values.  Values less than MIN_VALUE, and in particular 0, are
+ * counted apart as 0.
+ *
+ * Only the bins between the smallest and the largest values are
+ * stored.  When they exceed a maximum number, the lowest bins are
+ * merged, which keeps the memory bounded and the upper quantiles,
+ * i.e., the tail of the delays, accurate.
+ *
+ * Two sketches of the same accuracy are merged exactly, e.g., to get
+ * the distribution of several flows or of several intervals.
+ */
+class QuantileSketch
+{
+public:
+  /**
+   * \brief Constructor
+   * \param relativeAccuracy the relative error on the quantiles, in (0, 1)
+   * \param maxBins the maximum number of bins stored
+   */
+  QuantileSketch (double relativeAccuracy = 0.01, uint32_t maxBins = 2048);
+
+  /**
+   * \brief Add a value to the sketch
+   * \param value the value to add, 0 or positive
+   */
+  void AddValue (double value);
+  /**
+   * \brief Add the values of another sketch
+   * \param other a sketch with the same relative accuracy
+   */
+  void Merge (const QuantileSketch &other);
+  /**
+   * \brief Remove all the values
+   */
+  void Clear (void);
+
+  /**
+   * \returns the number of values added
+   */
+  uint64_t GetCount (void) const;
+  /**
+   * \returns the smallest value added, 0 if none
+   */
+  double GetMin (void) const;
+  /**
+   * \returns the largest value added, 0 if none
+   */
+  double GetMax (void) const;
+  /**
+   * \returns the relative accuracy of the quantiles
+   */
+  double GetRelativeAccuracy (void) const;
+  /**
+   * \returns the number of bins stored
+   */
+  uint32_t GetNBins (void) const;
+  /**
+   * \brief Estimate a quantile
+   * \param quantile the quantile, in [0, 1], e.g., 0.999 for the 99.9th percentile
+   * \returns the estimate of the quantile, or 0 if the sketch is empty
+   */
+  double GetQuantile (double quantile) const;
+
+  /**
+   * \brief Serializes the sketch to an std::ostream in XML format.
+   *
+   * The element has the count, minimum and maximum, a few quantiles,
+   * and the non-empty bins, with their index, upper bound and count.
+   *
+   * \param os the output stream
+   * \param indent number of spaces to use as base indentation level
+   * \param elementName name of the element to serialize.
+   */
+  void SerializeToXmlStream (std::ostream &os, int indent, std::string elementName) const;
+
+  /** The smallest value which is not counted as 0. */
+  static const double MIN_VALUE;
+
+private:
+  /**
+   * \param value a value, at least MIN_VALUE
+   * \returns the index of the bin of the value
+   */
+  int32_t GetIndex (double value) const;
+  /**
+   * \param index the index of a bin
+   * \returns the value which represents the bin, within the relative
+   *          accuracy of any value of the bin
+   */
+  double GetBinValue (int32_t index) const;
+  /**
+   * \brief Make the bins cover a range of indices, merging the lowest
+   * ones if the range is larger than the maximum number of bins
+   * \param low the lowest index, at most the lowest stored bin
+   * \param high the highest index, at least the highest stored bin
+   */
+  void SetRange (int32_t low, int32_t high);
+  /**
+   * \brief Add values to a bin, growing or collapsing the bins as needed
+   * \param index the index of the bin
+   * \param count the number of values to add
+   */
+  void AddToBin (int32_t index, uint64_t count);
+
+  double m_relativeAccuracy;        //!< Relative accuracy of the quantiles
+  double m_gamma;                   //!< Ratio between the bounds of a bin
+  double m_logGamma;                //!< log (m_gamma)
+  uint32_t m_maxBins;               //!< Maximum number of bins
+  std::vector<uint64_t> m_bins;     //!< Counts of the bins
+  int32_t m_offset;                 //!< Index of the bin in m_bins[0]
+  uint64_t m_zeroCount;             //!< Number of values less than MIN_VALUE
+  uint64_t m_count;                 //!< Number of values
+  double m_min;                     //!< Smallest value
+  double m_max;                     //!< Largest value
+};
+
+} // namespace ns3
+
+#endif /* NS3_QUANTILE_SKETCH_H */
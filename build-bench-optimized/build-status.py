@@ -0,0 +1,8 @@
+#! /usr/bin/env python
+
+# Programs that are runnable.
+ns3_runnable_programs = ['build-bench-optimized/scratch/ns3.25-evaluate_fst_mechanism-optimized', 'build-bench-optimized/scratch/ns3.25-evaluate_tcp_sack_blockage-optimized', 'build-bench-optimized/scratch/subdir/ns3.25-subdir-optimized', 'build-bench-optimized/scratch/ns3.25-evaluate_beamforming-optimized', 'build-bench-optimized/scratch/ns3.25-evaluate_dmg_throughput-optimized', 'build-bench-optimized/scratch/ns3.25-evaluate_service_period-optimized', 'build-bench-optimized/scratch/ns3.25-evaluate_tcp_congestion_control-optimized', 'build-bench-optimized/scratch/ns3.25-test_fst-optimized', 'build-bench-optimized/scratch/ns3.25-evaluate_relay_operation-optimized']
+
+# Scripts that are runnable.
+ns3_runnable_scripts = []
+
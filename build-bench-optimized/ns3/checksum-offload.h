@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef CHECKSUM_OFFLOAD_H
+#define CHECKSUM_OFFLOAD_H
+
+#include "ns3/tag.h"
+#include "ns3/packet.h"
+#include "ns3/buffer.h"
+#include "ns3/callback.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup network
+ *
+ * \brief Byte tag marking the payload of a packet whose checksums are
+ * deferred
+ *
+ * The tag covers the payload of the protocol, which is preceded by the
+ * protocol header.  A tag whose range no longer matches the payload size
+ * (because the packet was fragmented, or its header removed) is stale
+ * and ignored.
+ */
+class ChecksumOffloadTag : public Tag
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer buf) const;
+  virtual void Deserialize (TagBuffer buf);
+  virtual void Print (std::ostream &os) const;
+  ChecksumOffloadTag ();
+
+  /**
+   * Constructs a ChecksumOffloadTag
+   *
+   * \param protocol the protocol number
+   * \param headerSize the size of the protocol header
+   * \param payloadSize the size of the payload
+   */
+  ChecksumOffloadTag (uint16_t protocol, uint16_t headerSize, uint32_t payloadSize);
+  /**
+   * \returns the protocol number
+   */
+  uint16_t GetProtocol (void) const;
+  /**
+   * \returns the size of the protocol header preceding the tagged bytes
+   */
+  uint16_t GetHeaderSize (void) const;
+  /**
+   * \returns the number of tagged bytes
+   */
+  uint32_t GetPayloadSize (void) const;
+private:
+  uint16_t m_protocol;    //!< Protocol number
+  uint16_t m_headerSize;  //!< Size of the protocol header
+  uint32_t m_payloadSize; //!< Size of the payload
+};
+
+/**
+ * \ingroup network
+ *
+ * \brief Registry of the functions computing the deferred checksums
+ *
+ * When the global value ChecksumOffload is set and ChecksumEnabled is
+ * not, the protocols neither compute nor verify their checksums, as if
+ * they were disabled: the packets cost the same.  Instead, a protocol
+ * marks its packets with a ChecksumOffloadTag, and registers the function
+ * which fills the checksums of its header and of the headers it carries.
+ * The consumers of the bytes of the packets, such as the pcap traces and
+ * the devices writing to a file descriptor, call Complete before reading
+ * them, and get packets whose checksums are valid.
+ */
+class ChecksumOffload
+{
+public:
+  /**
+   * Callback filling the checksums of a packet of a protocol, given an
+   * iterator on its header and the size of the packet, header included
+   */
+  typedef Callback<void, Buffer::Iterator, uint32_t> CompleteCallback;
+
+  /**
+   * \returns true if the checksums are deferred to the byte-level
+   * consumers, i.e., if ChecksumOffload is set and ChecksumEnabled is not
+   */
+  static bool IsEnabled (void);
+
+  /**
+   * \brief Register the function filling the checksums of a protocol
+   * \param protocol the protocol number, as given to NetDevice::Send
+   * \param cb the function filling the checksums
+   */
+  static void Register (uint16_t protocol, CompleteCallback cb);
+
+  /**
+   * \brief Mark a payload whose checksums are to be filled
+   * \param payload the payload, without the protocol header
+   * \param protocol the protocol number
+   * \param headerSize the size of the protocol header to be added
+   */
+  static void Defer (Ptr<Packet> payload, uint16_t protocol, uint16_t headerSize);
+
+  /**
+   * \brief Fill the deferred checksums of a packet
+   *
+   * A packet without ChecksumOffloadTag is returned as it is. Otherwise,
+   * the returned packet only holds the bytes of the packet, with valid
+   * checksums.
+   *
+   * \param packet the packet
+   * \returns the packet with valid checksums
+   */
+  static Ptr<const Packet> Complete (Ptr<const Packet> packet);
+};
+
+} // namespace ns3
+
+#endif /* CHECKSUM_OFFLOAD_H */
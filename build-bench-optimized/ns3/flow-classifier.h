@@ -0,0 +1,179 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// Copyright (c) 2009 INESC Porto
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+// Author: Gustavo J. A. M. Carneiro  <gjc@inescporto.pt> <gjcarneiro@gmail.com>
+//
+
+#ifndef FLOW_CLASSIFIER_H
+#define FLOW_CLASSIFIER_H
+
+#include "ns3/simple-ref-count.h"
+#include <deque>
+#include <ostream>
+
+namespace ns3 {
+
+/**
+ * \ingroup flow-monitor
+ * \brief Abstract identifier of a packet flow
+ */
+typedef uint32_t FlowId;
+
+/**
+ * \ingroup flow-monitor
+ * \brief Abstract identifier of a packet within a flow
+ */
+typedef uint32_t FlowPacketId;
+
+/**
+ * \ingroup flow-monitor
+ * \brief The flow ids below this limit find their stats without a map lookup
+ */
+static const FlowId MAX_INDEXED_FLOW_ID = 1 << 20;
+
+/**
+ * \ingroup flow-monitor
+ * \brief Direct index from the flow ids to the stats of the flows
+ *
+ * The stats live in a std::map, whose elements never move, and this
+ * index finds them without a map lookup.  It covers a window of at
+ * most MAX_INDEXED_FLOW_ID consecutive flow ids, starting at the oldest
+ * flow not removed, so that it does not grow with the number of flows
+ * when the idle flows are removed.  The flows out of the window are
+ * only found through the map.
+ */
+template <typename T>
+class FlowIdIndex
+{
+public:
+  FlowIdIndex ()
+    : m_first (0)
+  {
+  }
+  /**
+   * \param flowId the flow id
+   * \returns the stats of the flow, or 0 if not indexed
+   */
+  T *Find (FlowId flowId) const
+  {
+    if (flowId >= m_first && flowId - m_first < m_index.size ())
+      {
+        return m_index[flowId - m_first];
+      }
+    return 0;
+  }
+  /**
+   * \brief Index the stats of a new flow, if in the window
+   * \param flowId the flow id
+   * \param stats the stats of the flow
+   */
+  void Insert (FlowId flowId, T *stats)
+  {
+    if (m_index.empty ())
+      {
+        m_first = flowId;
+      }
+    if (flowId < m_first || flowId - m_first >= MAX_INDEXED_FLOW_ID)
+      {
+        return;
+      }
+    if (flowId - m_first >= m_index.size ())
+      {
+        m_index.resize (flowId - m_first + 1, 0);
+      }
+    m_index[flowId - m_first] = stats;
+  }
+  /**
+   * \brief Forget a flow, and the empty slots at both ends of the window
+   * \param flowId the flow id
+   */
+  void Remove (FlowId flowId)
+  {
+    if (Find (flowId) == 0)
+      {
+        return;
+      }
+    m_index[flowId - m_first] = 0;
+    while (!m_index.empty () && m_index.front () == 0)
+      {
+        m_index.pop_front ();
+        m_first++;
+      }
+    while (!m_index.empty () && m_index.back () == 0)
+      {
+        m_index.pop_back ();
+      }
+  }
+  /// \returns the number of slots of the window
+  uint32_t GetSize (void) const
+  {
+    return m_index.size ();
+  }
+private:
+  std::deque<T *> m_index;  //!< Stats of the flows from m_first on
+  FlowId m_first;           //!< Flow id of m_index[0]
+};
+
+
+/// \ingroup flow-monitor
+/// Provides a method to translate raw packet data into abstract
+/// `flow identifier` and `packet identifier` parameters.  These
+/// identifiers are unsigned 32-bit integers that uniquely identify a
+/// flow and a packet within that flow, respectively, for the whole
+/// simulation, regardless of the point in which the packet was
+/// captured.  These abstract identifiers are used in the
+/// communication between FlowProbe and FlowMonitor, and all collected
+/// statistics reference only those abstract identifiers in order to
+/// keep the core architecture generic and not tied down to any
+/// particular flow capture method or classification system.
+class FlowClassifier : public SimpleRefCount<FlowClassifier>
+{
+private:
+  FlowId m_lastNewFlowId; //!< Last known Flow ID
+
+  /// Defined and not implemented to avoid misuse
+  FlowClassifier (FlowClassifier const &);
+  /// Defined and not implemented to avoid misuse
+  /// \returns
+  FlowClassifier& operator= (FlowClassifier const &);
+
+public:
+
+  FlowClassifier ();
+  virtual ~FlowClassifier ();
+
+  /// Serializes the results to an std::ostream in XML format
+  /// \param os the output stream
+  /// \param indent number of spaces to use as base indentation level
+  virtual void SerializeToXmlStream (std::ostream &os, int indent) const = 0;
+
+  /// Forget a flow, e.g., after it was idle for long.  The next packet
+  /// of the same flow gets a new flow identifier.
+  /// \param flowId the flow identifier
+  virtual void RemoveFlow (FlowId flowId);
+
+protected:
+  /// Returns a new, unique Flow Identifier
+  /// \returns a new FlowId
+  FlowId GetNewFlowId ();
+
+};
+
+
+} // namespace ns3
+
+#endif /* FLOW_CLASSIFIER_H */
@@ -0,0 +1,344 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "object-factory.h"
+#include "nstime.h"
+#include "system-thread.h"
+#include "system-mutex.h"
+
+#include "ptr.h"
+
+#include <list>
+#include <map>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * Declaration of class ns3::MultithreadedSimulatorImpl.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * \brief A conservative, shared-memory parallel simulator implementation.
+ *
+ * The event contexts (that is, the node ids) are partitioned over a
+ * number of worker threads.  Every partition owns its own event queue
+ * and simulation clock.  The simulation advances in windows: at the
+ * beginning of each window all threads agree on the smallest pending
+ * event timestamp \f$T\f$ and then process, in parallel, all their
+ * events in \f$[T, T+L)\f$ where \f$L\f$ is the lookahead.  Events
+ * scheduled for another context (Simulator::ScheduleWithContext) are
+ * buffered until the end of the window, and delivered while all the
+ * threads wait on the barrier.
+ *
+ * Unlike the MPI based simulators, this implementation does not need
+ * the topology to be split along point-to-point links: a single shared
+ * YansWifiChannel can be used, with a lookahead equal to the smallest
+ * propagation delay between two of its PHYs (see
+ * YansWifiChannel::GetMinimumDelay).
+ *
+ * The events scheduled for another context are delivered in an order
+ * which only depends on their timestamp and on the context which
+ * scheduled them, so that a simulation yields the same results
+ * whatever the number of threads, including when run by a single
+ * thread.  This holds as long as the only interactions between
+ * contexts are events scheduled with a delay not smaller than the
+ * lookahead.  Simultaneous events of one context may however be
+ * ordered differently than with the DefaultSimulatorImpl.
+ *
+ * A model which needs the state of the nodes of other partitions, such
+ * as their positions, or state shared by all the nodes, such as the
+ * random variables of a channel, must access it from an event given to
+ * ScheduleShared.
+ *
+ * The threads process their windows in parallel only when ns-3 is
+ * configured with \c --enable-mtp, which makes the reference counts and
+ * the packet buffers safe to share between threads.  Otherwise the
+ * threads process their windows in turn, with the same results.
+ *
+ * Simulator::Stop (delay) stops every partition at exactly the same
+ * simulation time.  Simulator::Stop () called from an event stops the
+ * simulation at the end of the current window.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  MultithreadedSimulatorImpl ();
+  /** Destructor. */
+  ~MultithreadedSimulatorImpl ();
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (Time const &delay);
+  virtual EventId Schedule (Time const &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+
+  /**
+   * Set the lookahead, that is, the smallest delay with which an event
+   * can be scheduled for another context.
+   *
+   * \param [in] lookahead The lookahead.
+   */
+  void SetLookahead (Time lookahead);
+  /** \returns The lookahead. */
+  Time GetLookahead (void) const;
+  /** \returns The number of partitions, that is, of threads. */
+  uint32_t GetPartitionCount (void) const;
+  /**
+   * Assign a context to a partition.  By default context \c c is
+   * assigned to partition <tt>c % GetPartitionCount ()</tt>.  This
+   * must be done before any event is scheduled for that context.
+   *
+   * \param [in] context The context, usually a node id.
+   * \param [in] partition The partition index.
+   */
+  void SetPartition (uint32_t context, uint32_t partition);
+  /**
+   * \param [in] context The context, usually a node id.
+   * \returns The index of the partition which processes this context.
+   */
+  uint32_t GetPartition (uint32_t context) const;
+  /**
+   * Run an event which reads or writes the state of the nodes of other
+   * partitions, or state shared by the nodes.
+   *
+   * The event runs at the end of the current window, while all the
+   * threads wait on the barrier, with the time and the context of the
+   * calling event.  The events run in the order of their time and
+   * context, whatever the number of threads.  Any event they schedule
+   * must not be earlier than the end of the window, that is, it must
+   * be scheduled with a delay not smaller than the lookahead.  The
+   * state it reads must not have been advanced past the time of the
+   * calling event by the events of the window: for instance, the
+   * position of a moving node must only be read by such events.  Outside
+   * of Run, or from such an event, the event runs immediately.
+   *
+   * \param [in] event The event implementation.
+   */
+  void ScheduleShared (EventImpl *event);
+
+private:
+  virtual void DoDispose (void);
+
+  /** An event scheduled for another partition, waiting for the barrier. */
+  struct PendingEvent
+  {
+    uint64_t ts;          /**< Absolute timestamp of the event. */
+    uint64_t senderTs;    /**< Time at which the event was scheduled. */
+    uint32_t sender;      /**< Context which scheduled the event. */
+    uint64_t senderSeq;   /**< Sequence number within the sending context. */
+    uint32_t context;     /**< Context of the event. */
+    uint32_t partition;   /**< Index of the destination partition. */
+    EventImpl *event;     /**< The event implementation. */
+  };
+  /**
+   * Order pending events independently of the partitioning.
+   * \param [in] a The first event.
+   * \param [in] b The second event.
+   * \returns \c true if \pname{a} must be delivered first.
+   */
+  static bool PendingEventLess (const PendingEvent &a, const PendingEvent &b);
+
+  /** The state of one partition. */
+  struct Partition
+  {
+    /** The simulator which owns this partition. */
+    MultithreadedSimulatorImpl *impl;
+    /** The index of this partition. */
+    uint32_t index;
+    /** The event queue of this partition. */
+    Ptr<Scheduler> events;
+    /** Next event unique id of this partition. */
+    uint32_t uid;
+    /**
+     * Unique id of the current event.  Read by other partitions with
+     * LoadClock.
+     */
+    uint32_t currentUid;
+    /**
+     * Timestamp of the current event.  Read by other partitions with
+     * LoadClock.
+     */
+    uint64_t currentTs;
+    /** Execution context of the current event. */
+    uint32_t currentContext;
+    /** Flag set when this partition reached a Stop event. */
+    bool stopped;
+    /** Events scheduled for another partition during the window. */
+    std::vector<PendingEvent> outbox;
+    /** Events given to ScheduleShared during the window. */
+    std::vector<PendingEvent> shared;
+    /** Number of events scheduled by each context of this partition. */
+    std::map<uint32_t, uint64_t> sequences;
+    /** Number of events processed. */
+    uint64_t eventCount;
+
+    /** Worker thread body. */
+    void RunWorker (void);
+  };
+
+  /** Stop the partition which processes this event. */
+  class StopEvent : public EventImpl
+  {
+  protected:
+    virtual void Notify (void);
+  };
+
+  /** Create the partitions, once the number of threads is known. */
+  void CreatePartitions (void);
+  /** \returns The partition of the calling thread, or 0 outside of Run. */
+  Partition * GetCurrentPartition (void) const;
+  /**
+   * \param [in] id An event id.
+   * \returns The partition in which the event was scheduled.
+   */
+  Partition * GetEventPartition (const EventId &id) const;
+  /**
+   * Read the clock of a partition, which another thread may be
+   * advancing.  The result is a consistent, if already outdated,
+   * snapshot of the clock.
+   * \param [in] partition The partition.
+   * \param [out] uid The unique id of the current event of the partition.
+   * \returns The timestamp of the current event of the partition.
+   */
+  static uint64_t LoadClock (const Partition *partition, uint32_t *uid);
+  /**
+   * Insert an event in the queue of a partition.
+   * \param [in] partition The destination partition.
+   * \param [in] ts The absolute timestamp.
+   * \param [in] context The event context.
+   * \param [in] event The event implementation.
+   * \returns The scheduler key.
+   */
+  Scheduler::EventKey Insert (Partition *partition, uint64_t ts,
+                              uint32_t context, EventImpl *event);
+  /**
+   * Buffer an event for another partition until the end of the window.
+   * \param [in] partition The partition of the calling thread.
+   * \param [in] destination The destination partition.
+   * \param [in] ts The absolute timestamp.
+   * \param [in] context The event context.
+   * \param [in] event The event implementation.
+   */
+  void Post (Partition *partition, uint32_t destination, uint64_t ts,
+             uint32_t context, EventImpl *event);
+  /**
+   * Run the events given to ScheduleShared during the last window.
+   * Called by the main thread while all the workers wait on the barrier.
+   */
+  void RunShared (void);
+  /**
+   * Deliver the buffered events and compute the next window.
+   * Called by the main thread while all the workers wait on the barrier.
+   * \returns \c false when the simulation is over.
+   */
+  bool PrepareWindow (void);
+  /**
+   * Process all the events of a partition within the current window.
+   * \param [in] partition The partition.
+   */
+  void ProcessWindow (Partition *partition);
+  /** Wait until all the threads reach the barrier. */
+  void Barrier (void);
+
+  /** The partitions. */
+  std::vector<Partition *> m_partitions;
+  /** Number of worker threads, including the main thread. */
+  uint32_t m_threadCount;
+  /** Lookahead, in time steps. */
+  uint64_t m_lookahead;
+  /** Explicit context to partition assignments. */
+  std::map<uint32_t, uint32_t> m_partitionOf;
+  /** The scheduler factory. */
+  ObjectFactory m_schedulerFactory;
+
+  /** End of the current window, exclusive. */
+  uint64_t m_windowEnd;
+  /** Flag set by PrepareWindow when the simulation is over. */
+  bool m_done;
+  /** Flag set by Stop (). */
+  bool m_stop;
+  /** Mutex protecting m_stop and m_destroyEvents. */
+  mutable SystemMutex m_mutex;
+  /** Flag set while RunShared runs an event. */
+  bool m_runningShared;
+  /**
+   * Mutex taken by the threads to process their windows in turn,
+   * without \c --enable-mtp.
+   */
+  SystemMutex m_serialMutex;
+  /** Timestamp of the last processed event, outside of Run. */
+  uint64_t m_currentTs;
+  /** Number of windows processed. */
+  uint64_t m_windowCount;
+
+  /** Container type for the events from a foreign thread. */
+  typedef std::list<PendingEvent> ForeignEvents;
+  /** Events scheduled by threads which are not simulator threads. */
+  ForeignEvents m_foreignEvents;
+  /** Mutex protecting m_foreignEvents. */
+  SystemMutex m_foreignEventsMutex;
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  /** The container of events to run at Destroy. */
+  DestroyEvents m_destroyEvents;
+
+  /** The worker threads, for the duration of Run. */
+  std::vector<Ptr<SystemThread> > m_threads;
+  /** Number of threads which reached the barrier. */
+  uint32_t m_barrierCount;
+  /** Barrier generation, incremented each time the barrier opens. */
+  uint64_t m_barrierGeneration;
+
+  /** Main execution thread. */
+  SystemThread::ThreadId m_main;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
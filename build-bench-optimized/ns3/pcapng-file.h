@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAPNG_FILE_H
+#define PCAPNG_FILE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "ns3/simple-ref-count.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "async-file-writer.h"
+
+namespace ns3 {
+
+class Header;
+class Packet;
+
+/**
+ * \brief A pcapng file shared by many captures
+ *
+ * Each capture is an interface of the file, described by an Interface
+ * Description Block with its own link type, snapshot length and name,
+ * and each packet is written as an Enhanced Packet Block with the
+ * identifier of its interface and a nanosecond timestamp.  The blocks
+ * are serialized in place into the chunks of an AsyncFileWriter, so
+ * that a single file with large writes replaces one stream per device.
+ *
+ * The file is written in the byte order of the host, as allowed by
+ * the pcapng format.  When configured with --enable-mtp, the writes
+ * are serialized by a mutex.
+ */
+class PcapNgFile : public SimpleRefCount<PcapNgFile>
+{
+public:
+  PcapNgFile ();
+  /** Close the file. */
+  ~PcapNgFile ();
+
+  /**
+   * Create the file and write the Section Header Block.
+   *
+   * \param filename The name of the file.
+   * \param bufferSize The size of the write buffers, in bytes.
+   * \param threaded Write the buffers from a background thread.
+   * \returns true if the file was created.
+   */
+  bool Open (std::string const &filename, uint32_t bufferSize, bool threaded);
+  /** \returns true if the file is open. */
+  bool IsOpen (void) const;
+  /** \returns true if a write into the file failed. */
+  bool Fail (void) const;
+  /** Write the pending data into the file. */
+  void Flush (void);
+  /** Write the pending data and close the file. */
+  void Close (void);
+
+  /**
+   * Add an interface, and write its Interface Description Block.
+   *
+   * \param dataLinkType The link type of the interface.
+   * \param snapLen The maximum number of bytes captured per packet.
+   * \param name The name of the interface, or an empty string.
+   * \returns The identifier of the interface.
+   */
+  uint32_t AddInterface (uint32_t dataLinkType, uint32_t snapLen, std::string const &name);
+  /**
+   * \param interface An interface identifier.
+   * \returns The link type of this interface.
+   */
+  uint32_t GetDataLinkType (uint32_t interface) const;
+  /**
+   * \param interface An interface identifier.
+   * \returns The snapshot length of this interface.
+   */
+  uint32_t GetSnapLen (uint32_t interface) const;
+  /** \returns The number of interfaces. */
+  uint32_t GetNInterfaces (void) const;
+
+  /**
+   * Write a packet captured on an interface.
+   *
+   * \param interface The interface identifier.
+   * \param t The capture time.
+   * \param header A header to write before the packet, or 0.
+   * \param p The packet.
+   */
+  void Write (uint32_t interface, Time t, Header const *header, Ptr<const Packet> p);
+  /**
+   * Write bytes captured on an interface.
+   *
+   * \param interface The interface identifier.
+   * \param t The capture time.
+   * \param buffer The captured bytes.
+   * \param length The number of bytes.
+   */
+  void Write (uint32_t interface, Time t, uint8_t const *buffer, uint32_t length);
+
+  static const uint32_t SHB_TYPE = 0x0A0D0D0A;  //!< Section Header Block type
+  static const uint32_t IDB_TYPE = 0x00000001;  //!< Interface Description Block type
+  static const uint32_t EPB_TYPE = 0x00000006;  //!< Enhanced Packet Block type
+  static const uint32_t BYTE_ORDER_MAGIC = 0x1A2B3C4D;  //!< Byte order magic
+
+private:
+  /** An interface of the file. */
+  struct Interface
+  {
+    uint32_t dataLinkType;  //!< Link type
+    uint32_t snapLen;       //!< Snapshot length
+  };
+
+  /**
+   * Reserve an Enhanced Packet Block, and fill everything but the
+   * packet data.
+   *
+   * \param interface The interface identifier.
+   * \param t The capture time.
+   * \param origLen The length of the packet.
+   * \param [out] capLen The number of bytes to capture.
+   * \returns Where to copy the captured bytes.
+   */
+  uint8_t *ReservePacket (uint32_t interface, Time t, uint32_t origLen, uint32_t &capLen);
+
+  AsyncFileWriter m_writer;               //!< The file
+  std::vector<Interface> m_interfaces;    //!< The interfaces
+#ifdef NS3_MTP
+  SystemMutex m_mutex;                    //!< Serializes the writes
+#endif /* NS3_MTP */
+};
+
+} // namespace ns3
+
+#endif /* PCAPNG_FILE_H */
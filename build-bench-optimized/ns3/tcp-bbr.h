@@ -0,0 +1,225 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef TCPBBR_H
+#define TCPBBR_H
+
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/sequence-number.h"
+#include "ns3/traced-value.h"
+#include "ns3/random-variable-stream.h"
+
+#include <deque>
+
+namespace ns3 {
+
+/**
+ * \brief Implementation of a BBR-style model-based congestion control
+ *
+ * BBR does not react to the losses: it estimates the bottleneck bandwidth
+ * (BtlBw, the windowed maximum of the delivery rate over the last rounds)
+ * and the round-trip propagation time (RTprop, the windowed minimum of the
+ * RTT over the last seconds), and it paces the segments at
+ * pacing_gain * BtlBw, with cWnd capped at cwnd_gain * BtlBw * RTprop.
+ *
+ * The gains are set by the state machine:
+ * - STARTUP doubles the sending rate each round, until the delivery rate
+ *   does not grow by 25% for three rounds (the pipe is full);
+ * - DRAIN empties the queue built in STARTUP;
+ * - PROBE_BW cycles the pacing gain over 1.25, 0.75 and six rounds at 1,
+ *   to probe for more bandwidth and to drain the queue it creates;
+ * - PROBE_RTT reduces cWnd to four segments for 200 ms when RTprop has not
+ *   been refreshed for 10 s, to measure it again.
+ *
+ * The socket paces the segments at TcpSocketState::m_pacingRate. The
+ * delivery rate is sampled once per round, as the bytes ACKed over the
+ * duration of the round; a round ends when the highest segment sent at
+ * its start is cumulatively ACKed.
+ */
+class TcpBbr : public TcpCongestionOps
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief BBR states
+   */
+  typedef enum
+  {
+    BBR_STARTUP,    //!< Ramp up the sending rate
+    BBR_DRAIN,      //!< Drain the queue built in startup
+    BBR_PROBE_BW,   //!< Cycle the pacing gain around the bottleneck bandwidth
+    BBR_PROBE_RTT   //!< Measure the round-trip propagation time
+  } BbrMode_t;
+
+  /**
+   * TracedValue Callback signature for BbrMode_t
+   *
+   * \param [in] oldValue original value of the traced variable
+   * \param [in] newValue new value of the traced variable
+   */
+  typedef void (* BbrModeTracedValueCallback)(const BbrMode_t oldValue,
+                                              const BbrMode_t newValue);
+
+  TcpBbr (void);
+
+  /**
+   * \brief Copy constructor
+   * \param sock the object to copy
+   */
+  TcpBbr (const TcpBbr& sock);
+
+  virtual ~TcpBbr (void);
+
+  virtual std::string GetName () const;
+
+  virtual uint32_t GetSsThresh (Ptr<const TcpSocketState> tcb,
+                                uint32_t bytesInFlight);
+
+  virtual void IncreaseWindow (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked);
+
+  virtual void PktsAcked (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked,
+                          const Time& rtt);
+
+  virtual Ptr<TcpCongestionOps> Fork ();
+
+  /**
+   * \brief Get the current state
+   * \return the BBR state
+   */
+  BbrMode_t GetMode (void) const;
+
+  /**
+   * \brief Get the bottleneck bandwidth estimate
+   * \return the bottleneck bandwidth, in bytes per second
+   */
+  double GetBtlBw (void) const;
+
+  /**
+   * \brief Get the round-trip propagation time estimate
+   * \return the minimum RTT of the window
+   */
+  Time GetRtProp (void) const;
+
+private:
+  /**
+   * \brief Update the round counter and the BtlBw and RTprop estimates
+   * \param tcb internal congestion state
+   */
+  void UpdateModel (Ptr<TcpSocketState> tcb);
+
+  /**
+   * \brief Look for the end of the startup, once per round
+   * \param bw the delivery rate of the round
+   */
+  void CheckFullPipe (double bw);
+
+  /**
+   * \brief Run the state transitions
+   * \param tcb internal congestion state
+   */
+  void UpdateMode (Ptr<TcpSocketState> tcb);
+
+  /**
+   * \brief Enter PROBE_BW, at a random phase of the gain cycle
+   */
+  void EnterProbeBw (void);
+
+  /**
+   * \brief Leave PROBE_RTT, and restore cWnd
+   * \param tcb internal congestion state
+   */
+  void ExitProbeRtt (Ptr<TcpSocketState> tcb);
+
+  /**
+   * \brief Set the pacing rate of the socket
+   * \param tcb internal congestion state
+   */
+  void SetPacingRate (Ptr<TcpSocketState> tcb);
+
+  /**
+   * \brief Get the window for the current estimates
+   * \param tcb internal congestion state
+   * \param gain the gain to apply to the bandwidth-delay product
+   * \return the window, in bytes
+   */
+  uint32_t GetTargetCwnd (Ptr<const TcpSocketState> tcb, double gain) const;
+
+  /**
+   * \brief Get the bytes sent and not cumulatively ACKed yet
+   * \param tcb internal congestion state
+   * \return the bytes in flight
+   */
+  uint32_t GetInFlight (Ptr<const TcpSocketState> tcb) const;
+
+  /**
+   * \brief Get the lowest cWnd
+   * \param tcb internal congestion state
+   * \return four segments, in bytes
+   */
+  uint32_t GetMinCwnd (Ptr<const TcpSocketState> tcb) const;
+
+  static const double PACING_GAIN_CYCLE[]; //!< Pacing gains of PROBE_BW
+  static const uint32_t GAIN_CYCLE_LENGTH;  //!< Phases of the PROBE_BW cycle
+
+  // Parameters
+  double   m_highGain;              //!< Pacing and cWnd gain of the startup
+  double   m_cWndGainProbeBw;       //!< cWnd gain of PROBE_BW
+  uint32_t m_bwWindowLength;        //!< Rounds of the BtlBw filter
+  Time     m_rtPropWindowLength;    //!< Length of the RTprop filter
+  Time     m_probeRttDuration;      //!< Time spent at the lowest cWnd in PROBE_RTT
+
+  // Model
+  TracedValue<BbrMode_t>  m_mode;   //!< Current state
+  double   m_pacingGain;            //!< Current pacing gain
+  double   m_cWndGain;              //!< Current cWnd gain
+  std::deque<std::pair<uint64_t, double> > m_bwFilter; //!< Max filter of the delivery rate, by round
+  Time     m_rtProp;                //!< RTprop estimate, zero when not sampled
+  Time     m_rtPropStamp;           //!< Time of the RTprop sample
+  bool     m_rtPropExpired;         //!< The RTprop estimate expired on the last ACK
+
+  // Rounds
+  uint64_t           m_delivered;      //!< Bytes ACKed, cumulatively or as dupacks
+  uint64_t           m_roundCount;     //!< Rounds since the start
+  bool               m_roundStart;     //!< The last ACK started a round
+  SequenceNumber32   m_nextRoundSeq;   //!< End of the current round
+  uint64_t           m_roundDelivered; //!< m_delivered at the start of the round
+  Time               m_roundStamp;     //!< Start of the round, zero before the first
+
+  // Startup
+  bool     m_fullPipe;              //!< The bottleneck bandwidth was reached
+  double   m_fullBw;                //!< Delivery rate which last grew by 25%
+  uint32_t m_fullBwCount;           //!< Rounds without a 25% growth
+
+  // PROBE_BW
+  uint32_t m_cycleIndex;            //!< Phase of the gain cycle
+  Time     m_cycleStamp;            //!< Start of the phase
+  Ptr<UniformRandomVariable> m_uv;  //!< Draws the first phase
+
+  // PROBE_RTT and recovery
+  Time     m_probeRttDoneStamp;     //!< End of PROBE_RTT, zero until cWnd is low
+  bool     m_probeRttRoundDone;     //!< A round was spent at the lowest cWnd
+  uint32_t m_priorCwnd;             //!< cWnd to restore after PROBE_RTT or a loss
+  bool     m_restoreCwnd;           //!< A loss reduced cWnd, restore it when back in Open
+};
+
+} // namespace ns3
+
+#endif // TCPBBR_H
@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef TCPCUBIC_H
+#define TCPCUBIC_H
+
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/sequence-number.h"
+#include "ns3/traced-value.h"
+
+namespace ns3 {
+
+/**
+ * \brief Implementation of the CUBIC congestion control (RFC 8312), with HyStart
+ *
+ * In congestion avoidance, the window grows following a cubic function of the
+ * time elapsed since the last reduction:
+ *
+ * \f[ W_{cubic}(t) = C (t - K)^3 + W_{max} \f]
+ *
+ * where \f$W_{max}\f$ is the window before the reduction and
+ * \f$K = \sqrt[3]{W_{max} (1 - \beta) / C}\f$ the time to get back to it.
+ * The growth does not depend on the RTT, and it is fast far from
+ * \f$W_{max}\f$, slow around it. The window never grows slower than a
+ * standard TCP with the same reduction factor (TCP-friendly region). Upon a
+ * loss, the window is reduced by the factor \f$\beta\f$; with fast
+ * convergence, a flow that loses before reaching its previous \f$W_{max}\f$
+ * releases some bandwidth to the new flows.
+ *
+ * HyStart ends the slow start before the losses, when either the ACKs of
+ * a train spread over half of the minimum RTT (the train filled the pipe),
+ * or the RTT of the round grows beyond the minimum RTT by a fraction of
+ * it (the queue builds up). The slow start threshold is then set to the
+ * current window.
+ *
+ * The implementation follows the Linux one (net/ipv4/tcp_cubic.c); the
+ * windows are counted in segments.
+ */
+class TcpCubic : public TcpNewReno
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TcpCubic (void);
+
+  /**
+   * \brief Copy constructor
+   * \param sock the object to copy
+   */
+  TcpCubic (const TcpCubic& sock);
+
+  virtual ~TcpCubic (void);
+
+  virtual std::string GetName () const;
+
+  virtual void PktsAcked (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked,
+                          const Time& rtt);
+
+  virtual uint32_t GetSsThresh (Ptr<const TcpSocketState> tcb,
+                                uint32_t bytesInFlight);
+
+  virtual Ptr<TcpCongestionOps> Fork ();
+
+protected:
+  virtual void CongestionAvoidance (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked);
+
+private:
+  /**
+   * \brief Compute how many segments must be ACKed to increase cWnd by one
+   * \param tcb internal congestion state
+   * \param segmentsAcked count of segments acked
+   * \return the number of segments to ACK for one more segment of cWnd
+   */
+  uint32_t Update (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked);
+
+  /**
+   * \brief Start a new HyStart round
+   * \param tcb internal congestion state
+   */
+  void HystartReset (Ptr<const TcpSocketState> tcb);
+
+  /**
+   * \brief Look for the end of the slow start with the HyStart heuristics
+   * \param tcb internal congestion state
+   * \param rtt the last RTT sample
+   */
+  void HystartUpdate (Ptr<TcpSocketState> tcb, const Time& rtt);
+
+  // Parameters
+  bool     m_fastConvergence;      //!< Enable fast convergence
+  double   m_beta;                 //!< Multiplicative decrease factor
+  double   m_c;                    //!< Cubic scaling factor
+  bool     m_hystart;              //!< Enable HyStart
+  uint32_t m_hystartLowWindow;     //!< Lowest cWnd (segments) for HyStart
+  Time     m_hystartAckDelta;      //!< Spacing of the ACKs of a train
+  Time     m_hystartDelayMin;      //!< Lowest RTT increase ending the slow start
+  Time     m_hystartDelayMax;      //!< Highest RTT increase ending the slow start
+  uint8_t  m_hystartMinSamples;    //!< RTT samples of a round for the delay detection
+
+  // Cubic state
+  uint32_t m_cWndCnt;              //!< Segments ACKed since the last increase
+  double   m_lastMaxCwnd;          //!< cWnd (segments) before the last reduction
+  double   m_bicOriginPoint;       //!< Origin point (segments) of the cubic function
+  double   m_bicK;                 //!< Time (s) to reach the origin point
+  double   m_tcpCwnd;              //!< Estimated cWnd (segments) of a standard TCP
+  Time     m_delayMin;             //!< Minimum RTT sample
+  Time     m_epochStart;           //!< Start of the current epoch, zero when not started
+
+  // HyStart state
+  bool               m_found;        //!< The exit point of the slow start was found
+  Time               m_roundStart;   //!< Start of the current round
+  SequenceNumber32   m_endSeq;       //!< End of the current round
+  Time               m_lastAck;      //!< Last ACK of the current train
+  Time               m_currRtt;      //!< Minimum RTT of the current round
+  uint8_t            m_sampleCnt;    //!< RTT samples of the current round
+};
+
+} // namespace ns3
+
+#endif // TCPCUBIC_H
@@ -0,0 +1,338 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2010 Adrian Sai-wah Tam
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Adrian Sai-wah Tam <adrian.sw.tam@gmail.com>
+ */
+
+#ifndef TCP_TX_BUFFER_H
+#define TCP_TX_BUFFER_H
+
+#include <deque>
+#include <list>
+#include <map>
+#include <vector>
+#include "ns3/traced-value.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/object.h"
+#include "ns3/sequence-number.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+class Packet;
+
+/**
+ * \ingroup tcp
+ *
+ * \brief class for keeping the data sent by the application to the TCP socket, i.e.
+ *        the sending buffer.
+ *
+ * The packets of the application are kept in a ring of segments, each
+ * with the offset of its first byte in the byte stream of the connection:
+ * the segment holding a sequence number is found by a binary search
+ * instead of a walk from the head of the buffer, and the acknowledged
+ * segments are dropped from the head without fragmenting the segment
+ * which is partially acknowledged.
+ */
+class TcpTxBuffer : public Object
+{
+public:
+  /// A block of sequence numbers, as [first, last + 1)
+  typedef std::pair<SequenceNumber32, SequenceNumber32> SequenceBlock;
+  /// A list of blocks of sequence numbers
+  typedef std::vector<SequenceBlock> SequenceBlockList;
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief Constructor
+   * \param n initial Sequence number to be transmitted
+   */
+  TcpTxBuffer (uint32_t n = 0);
+  virtual ~TcpTxBuffer (void);
+
+  // Accessors
+
+  /**
+   * Returns the first byte's sequence number
+   * \returns the first byte's sequence number
+   */
+  SequenceNumber32 HeadSequence (void) const;
+
+  /**
+   * Returns the last byte's sequence number + 1
+   * \returns the last byte's sequence number + 1
+   */
+  SequenceNumber32 TailSequence (void) const;
+
+  /**
+   * Returns total number of bytes in this Tx buffer
+   * \returns total number of bytes in this Tx buffer
+   */
+  uint32_t Size (void) const;
+
+  /**
+   * Returns the Tx window size
+   * \returns the Tx window size (in bytes)
+   */
+  uint32_t MaxBufferSize (void) const;
+
+  /**
+   * Set the Tx window size
+   * \param n Tx window size (in bytes)
+   */
+  void SetMaxBufferSize (uint32_t n);
+
+  /**
+   * Returns the available capacity in this Tx window
+   * \returns available capacity in this Tx window
+   */
+  uint32_t Available (void) const;
+
+  /**
+   * Append a data packet to the end of the buffer
+   *
+   * \param p The packet to be appended to the Tx buffer
+   * \return Boolean to indicate success
+   */
+  bool Add (Ptr<Packet> p);
+
+  /**
+   * Returns the number of bytes from the buffer in the range [seq, tailSequence)
+   * \param seq initial sequence number
+   * \returns the number of bytes from the buffer in the range
+   */
+  uint32_t SizeFromSequence (const SequenceNumber32& seq) const;
+
+  /**
+   * Copy data of size numBytes into a packet, data from the range [seq, seq+numBytes)
+   * \param numBytes number of bytes to copy
+   * \param seq start sequence number to extract
+   * \returns a packet
+   */
+  Ptr<Packet> CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq);
+
+  /**
+   * Set the m_firstByteSeq to seq. Supposed to be called only when the
+   * connection is just set up and we did not send any data out yet.
+   * \param seq The sequence number of the head byte
+   */
+  void SetHeadSequence (const SequenceNumber32& seq);
+
+  /**
+   * Discard data up to but not including this sequence number.
+   *
+   * \param seq The sequence number of the head byte
+   */
+  void DiscardUpTo (const SequenceNumber32& seq);
+
+  // SACK scoreboard
+
+  /**
+   * \brief Record the transmission of a segment in the scoreboard
+   *
+   * The bytes beyond the ones sent before make a new segment of the
+   * scoreboard, the segments sent before are marked as retransmitted.
+   *
+   * \param seq the first sequence number of the segment
+   * \param size the size of the segment
+   */
+  void Sent (const SequenceNumber32& seq, uint32_t size);
+
+  /**
+   * \brief Mark as SACKed the segments covered by the blocks of a SACK option
+   * \param blocks the blocks of the SACK option
+   * \returns the number of bytes newly SACKed
+   */
+  uint32_t Update (const SequenceBlockList& blocks);
+
+  /**
+   * \brief Mark as lost the segments which \RFC{6675} IsLost () reports
+   *
+   * A segment not SACKed is lost when either dupThresh discontiguous
+   * blocks, or more than (dupThresh - 1) * segmentSize bytes, have been
+   * SACKed above it.
+   *
+   * \param dupThresh the duplicate ACK threshold (DupThresh)
+   * \param segmentSize the segment size (SMSS)
+   * \returns the number of bytes newly marked as lost
+   */
+  uint32_t DetectLoss (uint32_t dupThresh, uint32_t segmentSize);
+
+  /**
+   * \brief Mark as lost the segments which RACK reports
+   *
+   * A segment in flight is lost when it was sent before the most recently
+   * delivered segment, and more than the RTT of that segment plus a
+   * reordering window ago.
+   *
+   * \param reoWnd the reordering window
+   * \param lost set to the number of bytes newly marked as lost
+   * \returns the time until the next segment in flight may be marked as
+   *          lost, or zero if no segment in flight was sent before the most
+   *          recently delivered one
+   */
+  Time DetectLossByTime (Time reoWnd, uint32_t *lost);
+
+  /**
+   * \brief Mark as lost all the segments not SACKed, upon a retransmission
+   *        timeout
+   */
+  void MarkAllLost (void);
+
+  /**
+   * \brief Find the next segment to retransmit, as \RFC{6675} NextSeg ()
+   *
+   * Rule 1 returns the first segment lost and not retransmitted yet. Rule 3
+   * returns the first segment neither SACKed, lost nor retransmitted below
+   * the highest SACKed byte. Rule 2, the new data, is left to the caller.
+   *
+   * \param seq set to the first sequence number of the segment
+   * \param size set to the size of the segment
+   * \param lostOnly true to apply rule 1 only, false to apply rule 3 too
+   * \returns true if a segment is found
+   */
+  bool NextSeg (SequenceNumber32 *seq, uint32_t *size, bool lostOnly);
+
+  /**
+   * \brief Get the bytes in flight, as \RFC{6675} SetPipe ()
+   *
+   * The bytes sent and neither acknowledged, SACKed nor lost, plus the
+   * bytes retransmitted and not SACKed.
+   *
+   * \returns the pipe
+   */
+  uint32_t BytesInFlight (void) const;
+
+  /**
+   * \returns the number of bytes SACKed in the scoreboard
+   */
+  uint32_t GetSackedBytes (void) const;
+
+  /**
+   * \returns the number of bytes lost and not SACKed in the scoreboard
+   */
+  uint32_t GetLostBytes (void) const;
+
+  /**
+   * \returns the minimum RTT of the segments delivered, or Time::Max () if
+   *          no RTT has been measured
+   */
+  Time GetMinRtt (void) const;
+
+private:
+  /// A packet of the application in the buffer
+  struct Segment
+  {
+    Ptr<Packet> packet; //!< The packet
+    uint64_t offset;    //!< Offset of the first byte of the packet in the byte stream
+  };
+  /// container for data stored in the buffer
+  typedef std::deque<Segment> Segments;
+
+  /**
+   * Find the segment holding a byte of the buffer
+   * \param offset the offset of the byte in the byte stream
+   * \returns the index of the segment in m_data
+   */
+  uint32_t FindSegment (uint64_t offset) const;
+
+  struct SentSegment;
+  /// list of the segments in flight, in the order of their last transmission
+  typedef std::list<SentSegment *> InFlightList;
+
+  /// A segment sent and not acknowledged yet
+  struct SentSegment
+  {
+    uint64_t offset;   //!< Offset of the first byte of the segment in the byte stream
+    uint32_t size;     //!< Size of the segment
+    bool sacked;       //!< The segment has been SACKed
+    bool lost;         //!< The segment has been deemed lost
+    bool retrans;      //!< The segment has been retransmitted, and the retransmission is not deemed lost
+    Time lastSent;     //!< Time of the last transmission of the segment
+    InFlightList::iterator inFlight; //!< Position in m_inFlight, if in flight
+  };
+
+  /**
+   * \param segment the segment
+   * \returns true if the segment is in flight: neither SACKed nor lost, or
+   *          retransmitted
+   */
+  static bool IsInFlight (const SentSegment &segment);
+
+  /**
+   * Change the marks of a segment of the scoreboard, and update the counts
+   * of bytes and the list of segments in flight
+   * \param segment the segment
+   * \param sacked the segment has been SACKed
+   * \param lost the segment has been deemed lost
+   * \param retrans the segment has been retransmitted
+   */
+  void SetMarks (SentSegment &segment, bool sacked, bool lost, bool retrans);
+
+  /**
+   * Add or remove the bytes of a segment from the counts of bytes
+   * \param segment the segment
+   * \param add true to add the bytes, false to remove them
+   */
+  void Count (const SentSegment &segment, bool add);
+
+  /**
+   * Take into account the delivery of a segment for RACK
+   * \param segment the segment SACKed or acknowledged
+   */
+  void Delivered (const SentSegment &segment);
+
+  /**
+   * Find the segment of the scoreboard holding a byte
+   * \param offset the offset of the byte in the byte stream
+   * \returns the index of the segment in m_sent
+   */
+  uint32_t FindSent (uint64_t offset) const;
+
+  /**
+   * \returns the offset following the last byte sent
+   */
+  uint64_t SentEnd (void) const;
+
+  TracedValue<SequenceNumber32> m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
+  uint32_t m_size;                              //!< Number of data bytes
+  uint32_t m_maxBuffer;                         //!< Max number of data bytes in buffer (SND.WND)
+  uint64_t m_headOffset;                        //!< Offset of the first byte in data in the byte stream
+  Segments m_data;                              //!< Corresponding data, from the segment holding the first byte
+
+  std::deque<SentSegment> m_sent;          //!< The scoreboard, from the segment holding the first byte
+  std::map<uint64_t, uint64_t> m_sacked;   //!< Blocks of bytes SACKed, by offset of their first byte
+  InFlightList m_inFlight;                 //!< The segments in flight, by time of their last transmission
+  uint32_t m_sackedBytes;                  //!< Number of bytes SACKed
+  uint32_t m_lostBytes;                    //!< Number of bytes lost and not SACKed
+  uint32_t m_retransBytes;                 //!< Number of bytes retransmitted and not SACKed
+  uint64_t m_lostScanOffset;               //!< The segments ending before this offset are checked by DetectLoss ()
+  uint64_t m_nextSegHint;                  //!< No segment before this offset is lost and not retransmitted
+  uint64_t m_holeHint;                     //!< No segment before this offset is neither SACKed, lost nor retransmitted
+  Time m_rackXmitTime;                     //!< RACK: time of transmission of the most recently sent segment delivered
+  uint64_t m_rackEndOffset;                //!< RACK: offset following that segment, or zero if none
+  Time m_rackRtt;                          //!< RACK: RTT of that segment
+  Time m_minRtt;                           //!< Minimum RTT of the segments delivered
+};
+
+} // namepsace ns3
+
+#endif /* TCP_TX_BUFFER_H */
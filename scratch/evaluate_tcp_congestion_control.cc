@@ -0,0 +1,265 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+#include <string>
+
+/**
+ * This script is used to compare the congestion controls for high bandwidth-delay products
+ * over an IEEE 802.11ad link. Network topology is simple and consists of One Access Point
+ * + One Station. The station sends a bulk TCP flow to the access point, with SACK enabled.
+ *
+ * To compare the goodput and the queueing delay of NewReno, CUBIC and BBR:
+ * ./waf --run "evaluate_tcp_congestion_control"
+ *
+ * To let TCP send super-segments of up to 64 KB, split in MSDUs by the DMG MAC queue:
+ * ./waf --run "evaluate_tcp_congestion_control --gsoMaxSize=65000"
+ *
+ * To let the receiver merge the TCP segments of each A-MPDU before passing them up the stack:
+ * ./waf --run "evaluate_tcp_congestion_control --receiveCoalescing=1"
+ *
+ * The script will print, for each congestion control, the achieved goodput in Mbps, the
+ * minimum RTT, and the average queueing delay, i.e. the average smoothed RTT minus the
+ * minimum RTT.
+ */
+
+NS_LOG_COMPONENT_DEFINE ("EvaluateTcpCongestionControl");
+
+using namespace ns3;
+using namespace std;
+
+Ptr<Node> apWifiNode;
+Ptr<Node> staWifiNode;
+
+Time m_minRtt = Time::Max ();              /* Minimum RTT of the flow */
+Time m_rttSum = Time (0);                 /* Sum of the RTT estimates */
+uint32_t m_rttSamples = 0;                /* Number of RTT estimates */
+
+/**
+ * Record an RTT estimate of the sender.
+ * \param oldValue The previous RTT estimate.
+ * \param newValue The new RTT estimate.
+ */
+void
+RttTrace (Time oldValue, Time newValue)
+{
+  m_minRtt = std::min (m_minRtt, newValue);
+  m_rttSum += newValue;
+  m_rttSamples++;
+}
+
+/**
+ * Connect the RTT trace of the sender socket, once the application created it.
+ * \param app The bulk send application.
+ */
+void
+ConnectRttTrace (Ptr<BulkSendApplication> app)
+{
+  app->GetSocket ()->TraceConnectWithoutContext ("RTT", MakeCallback (&RttTrace));
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t payloadSize = 1448;                  /* Transport Layer Payload size in bytes. */
+  uint32_t bufferSize = 4194304;                /* TCP Send/Receive Buffer Size. */
+  string phyMode = "DMG_MCS12";                 /* Type of the Physical Layer. */
+  double distance = 1.0;                        /* The distance between transmitter and receiver in meters. */
+  bool verbose = false;                         /* Print Logging Information. */
+  double simulationTime = 2;                    /* Simulation time in seconds. */
+  uint32_t gsoMaxSize = 0;                      /* Largest TCP super-segment, 0 to disable them. */
+  bool receiveCoalescing = false;               /* Merge the received TCP segments of each A-MPDU. */
+
+  /* Command line argument parser setup. */
+  CommandLine cmd;
+  cmd.AddValue ("payloadSize", "Payload size in bytes", payloadSize);
+  cmd.AddValue ("bufferSize", "TCP Buffer Size (Send/Receive)", bufferSize);
+  cmd.AddValue ("phyMode", "802.11ad PHY Mode", phyMode);
+  cmd.AddValue ("dist", "distance between nodes", distance);
+  cmd.AddValue ("verbose", "turn on all WifiNetDevice log components", verbose);
+  cmd.AddValue ("simulationTime", "Simulation time in seconds", simulationTime);
+  cmd.AddValue ("gsoMaxSize", "Largest TCP super-segment, split in MSDUs by the MAC (0 to disable)", gsoMaxSize);
+  cmd.AddValue ("receiveCoalescing", "Merge the received TCP segments of each A-MPDU", receiveCoalescing);
+  cmd.Parse (argc, argv);
+
+  /* Global params: no fragmentation, no RTS/CTS, fixed rate for all packets */
+  Config::SetDefault ("ns3::WifiRemoteStationManager::FragmentationThreshold", StringValue ("999999"));
+  Config::SetDefault ("ns3::WifiRemoteStationManager::RtsCtsThreshold", StringValue ("999999"));
+
+  /*** Configure TCP Options ***/
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (payloadSize));
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (bufferSize));
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (bufferSize));
+  Config::SetDefault ("ns3::TcpSocketBase::MinRto", TimeValue (MilliSeconds (200)));
+  Config::SetDefault ("ns3::TcpSocketBase::Sack", BooleanValue (true));
+  /* The timestamps count in milliseconds: measure the RTT of the sub-millisecond link from the segments */
+  Config::SetDefault ("ns3::TcpSocketBase::Timestamp", BooleanValue (false));
+  Config::SetDefault ("ns3::TcpSocketBase::GsoMaxSize", UintegerValue (gsoMaxSize));
+  Config::SetDefault ("ns3::WifiNetDevice::ReceiveCoalescing", BooleanValue (receiveCoalescing));
+
+  TypeId congestionControls[] = {TcpNewReno::GetTypeId (), TcpCubic::GetTypeId (), TcpBbr::GetTypeId ()};
+
+  cout << "Congestion Control" << '\t' << "Goodput (Mbps)" << '\t' << "Minimum RTT (us)" << '\t'
+       << "Queueing Delay (us)" << endl;
+
+  for (uint32_t cc = 0; cc < 3; cc++)
+    {
+      Config::SetDefault ("ns3::TcpL4Protocol::SocketType", TypeIdValue (congestionControls[cc]));
+      m_minRtt = Time::Max ();
+      m_rttSum = Time (0);
+      m_rttSamples = 0;
+
+      /**** WifiHelper is a meta-helper: it helps creates helpers ****/
+      WifiHelper wifi;
+
+      /* Basic setup */
+      wifi.SetStandard (WIFI_PHY_STANDARD_80211ad);
+
+      /* Turn on logging */
+      if (verbose)
+        {
+          wifi.EnableLogComponents ();
+          LogComponentEnable ("EvaluateTcpCongestionControl", LOG_LEVEL_ALL);
+        }
+
+      /**** Set up Channel ****/
+      YansWifiChannelHelper wifiChannel ;
+      /* Simple propagation delay model */
+      wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+      /* Friis model with standard-specific wavelength */
+      wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (56.16e9));
+
+      /**** SETUP ALL NODES ****/
+      YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+      /* Nodes will be added to the channel we set up earlier */
+      Ptr<YansWifiChannel> channel = wifiChannel.Create ();
+      wifiPhy.SetChannel (channel);
+      /* All nodes transmit at 10 dBm == 10 mW, no adaptation */
+      wifiPhy.Set ("TxPowerStart", DoubleValue (10.0));
+      wifiPhy.Set ("TxPowerEnd", DoubleValue (10.0));
+      wifiPhy.Set ("TxPowerLevels", UintegerValue (1));
+      wifiPhy.Set ("TxGain", DoubleValue (0));
+      wifiPhy.Set ("RxGain", DoubleValue (0));
+      /* Sensitivity model includes implementation loss and noise figure */
+      wifiPhy.Set ("RxNoiseFigure", DoubleValue (3));
+      wifiPhy.Set ("CcaMode1Threshold", DoubleValue (-79));
+      wifiPhy.Set ("EnergyDetectionThreshold", DoubleValue (-79 + 3));
+      /* Set the phy layer error model */
+      wifiPhy.SetErrorRateModel ("ns3::SensitivityModel60GHz");
+      /* Set default algorithm for all nodes to be constant rate */
+      wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "ControlMode", StringValue ("DMG_MCS0"),
+                                                                    "DataMode", StringValue (phyMode));
+      /* Give all nodes steerable antenna */
+      wifiPhy.EnableAntenna (true, true);
+      wifiPhy.SetAntenna ("ns3::Directional60GhzAntenna",
+                          "Sectors", UintegerValue (8),
+                          "Antennas", UintegerValue (1),
+                          "AngleOffset", DoubleValue (0));
+
+      /* Make two nodes and set them up with the phy and the mac */
+      NodeContainer wifiNodes;
+      wifiNodes.Create (2);
+      apWifiNode = wifiNodes.Get (0);
+      staWifiNode = wifiNodes.Get (1);
+
+      /**** Allocate a default Adhoc Wifi MAC ****/
+      /* Add a DMG upper mac */
+      DmgWifiMacHelper wifiMac = DmgWifiMacHelper::Default ();
+
+      Ssid ssid = Ssid ("test802.11ad");
+      wifiMac.SetType ("ns3::DmgApWifiMac",
+                       "Ssid", SsidValue (ssid),
+                       "QosSupported", BooleanValue (true), "DmgSupported", BooleanValue (true),
+                       "BE_MaxAmpduSize", UintegerValue (262143), //Enable A-MPDU with the highest maximum size allowed by the standard
+                       "BE_MaxAmsduSize", UintegerValue (7935),
+                       "SSSlotsPerABFT", UintegerValue (8), "SSFramesPerSlot", UintegerValue (8),
+                       "BeaconInterval", TimeValue (MicroSeconds (102400)),
+                       "BeaconTransmissionInterval", TimeValue (MicroSeconds (400)),
+                       "ATIDuration", TimeValue (MicroSeconds (300)));
+
+      NetDeviceContainer apDevice;
+      apDevice = wifi.Install (wifiPhy, wifiMac, apWifiNode);
+
+      wifiMac.SetType ("ns3::DmgStaWifiMac",
+                       "Ssid", SsidValue (ssid),
+                       "ActiveProbing", BooleanValue (false),
+                       "BE_MaxAmpduSize", UintegerValue (262143), //Enable A-MPDU with the highest maximum size allowed by the standard
+                       "BE_MaxAmsduSize", UintegerValue (7935),
+                       "QosSupported", BooleanValue (true), "DmgSupported", BooleanValue (true));
+
+      NetDeviceContainer staDevice;
+      staDevice = wifi.Install (wifiPhy, wifiMac, staWifiNode);
+
+      /* Setting mobility model, Initial Position 1 meter apart */
+      MobilityHelper mobility;
+      Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+      positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+      positionAlloc->Add (Vector (distance, 0.0, 0.0));
+
+      mobility.SetPositionAllocator (positionAlloc);
+      mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+      mobility.Install (wifiNodes);
+
+      /* Internet stack*/
+      InternetStackHelper stack;
+      stack.Install (wifiNodes);
+
+      Ipv4AddressHelper address;
+      address.SetBase ("10.0.0.0", "255.255.255.0");
+      Ipv4InterfaceContainer apInterface;
+      apInterface = address.Assign (apDevice);
+      Ipv4InterfaceContainer staInterface;
+      staInterface = address.Assign (staDevice);
+
+      /* Populate routing table */
+      Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+      /* We do not want any ARP nor NDisc packets */
+      InternetStackHelper::PopulateStaticNeighborTables ();
+
+      /* Install TCP Receiver on the access point */
+      PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), 9999));
+      ApplicationContainer sinkApp = sinkHelper.Install (apWifiNode);
+      Ptr<PacketSink> sink = StaticCast<PacketSink> (sinkApp.Get (0));
+      sinkApp.Start (Seconds (0.0));
+
+      /* Install TCP Transmitter on the station */
+      BulkSendHelper src ("ns3::TcpSocketFactory", InetSocketAddress (apInterface.GetAddress (0), 9999));
+      ApplicationContainer srcApp = src.Install (staWifiNode);
+      srcApp.Start (Seconds (1.0));
+
+      /* Trace the RTT of the sender */
+      Simulator::Schedule (Seconds (1.0) + MilliSeconds (1), &ConnectRttTrace,
+                           StaticCast<BulkSendApplication> (srcApp.Get (0)));
+
+      Simulator::Stop (Seconds (simulationTime));
+      Simulator::Run ();
+
+      /* Calculate Goodput and Queueing Delay */
+      double goodput = sink->GetTotalRx () * (double) 8 / ((simulationTime - 1) * 1e6);
+      double minRtt = m_minRtt.GetMicroSeconds ();
+      double queueingDelay = m_rttSamples ? (m_rttSum.GetMicroSeconds () / (double) m_rttSamples) - minRtt : 0;
+      cout << congestionControls[cc].GetName () << '\t' << goodput << '\t' << minRtt << '\t' << queueingDelay << endl;
+
+      Simulator::Destroy ();
+    }
+
+  return 0;
+}
@@ -0,0 +1,252 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+#include <string>
+
+/**
+ * This script is used to compare the TCP loss recovery schemes over an IEEE 802.11ad link
+ * with bursty blockage losses. Network topology is simple and consists of One Access Point
+ * + One Station. The station sends a bulk TCP flow to the access point, and the path from the
+ * station to the access point is blocked periodically for a short time, long enough for the
+ * MAC to drop a burst of MPDUs.
+ *
+ * To compare the throughput of NewReno recovery, SACK recovery and SACK + RACK recovery:
+ * ./waf --run "evaluate_tcp_sack_blockage"
+ *
+ * The script will print the achieved throughput in Mbps for each recovery scheme.
+ */
+
+NS_LOG_COMPONENT_DEFINE ("EvaluateTcpSackBlockage");
+
+using namespace ns3;
+using namespace std;
+
+Ptr<Node> apWifiNode;
+Ptr<Node> staWifiNode;
+
+double m_blockageValue = -45;             /* in dB */
+bool m_blocked = false;                   /* The path is blocked */
+
+/**
+ * Insert Blockage
+ * \return The actual value of the blockage we introduce in the simulator.
+ */
+double
+DoInsertBlockage ()
+{
+  return m_blocked ? m_blockageValue : 0;
+}
+
+/**
+ * Block the path for a while, and schedule the next blockage.
+ * \param duration The duration of the blockage.
+ * \param period The time between the start of two blockages.
+ */
+void
+ToggleBlockage (Time duration, Time period)
+{
+  m_blocked = !m_blocked;
+  Simulator::Schedule (m_blocked ? duration : period - duration, &ToggleBlockage, duration, period);
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t payloadSize = 1448;                  /* Transport Layer Payload size in bytes. */
+  uint32_t bufferSize = 4194304;                /* TCP Send/Receive Buffer Size. */
+  string phyMode = "DMG_MCS12";                 /* Type of the Physical Layer. */
+  double distance = 1.0;                        /* The distance between transmitter and receiver in meters. */
+  double blockageDuration = 5;                  /* Duration of each blockage in milliseconds. */
+  double blockagePeriod = 100;                  /* Time between the blockages in milliseconds. */
+  bool verbose = false;                         /* Print Logging Information. */
+  double simulationTime = 2;                    /* Simulation time in seconds. */
+
+  /* Command line argument parser setup. */
+  CommandLine cmd;
+  cmd.AddValue ("payloadSize", "Payload size in bytes", payloadSize);
+  cmd.AddValue ("bufferSize", "TCP Buffer Size (Send/Receive)", bufferSize);
+  cmd.AddValue ("phyMode", "802.11ad PHY Mode", phyMode);
+  cmd.AddValue ("dist", "distance between nodes", distance);
+  cmd.AddValue ("blockageValue", "Attenuation of the blockage in dB", m_blockageValue);
+  cmd.AddValue ("blockageDuration", "Duration of each blockage in milliseconds", blockageDuration);
+  cmd.AddValue ("blockagePeriod", "Time between the blockages in milliseconds", blockagePeriod);
+  cmd.AddValue ("verbose", "turn on all WifiNetDevice log components", verbose);
+  cmd.AddValue ("simulationTime", "Simulation time in seconds", simulationTime);
+  cmd.Parse (argc, argv);
+
+  /* Global params: no fragmentation, no RTS/CTS, fixed rate for all packets */
+  Config::SetDefault ("ns3::WifiRemoteStationManager::FragmentationThreshold", StringValue ("999999"));
+  Config::SetDefault ("ns3::WifiRemoteStationManager::RtsCtsThreshold", StringValue ("999999"));
+
+  /*** Configure TCP Options ***/
+  Config::SetDefault ("ns3::TcpL4Protocol::SocketType", TypeIdValue (TcpNewReno::GetTypeId ()));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (payloadSize));
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (bufferSize));
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (bufferSize));
+  Config::SetDefault ("ns3::TcpSocketBase::MinRto", TimeValue (MilliSeconds (200)));
+
+  cout << "Recovery" << '\t' << "Throughput (Mbps)" << endl;
+
+  for (uint32_t scheme = 0; scheme < 3; scheme++)
+    {
+      /* NewReno, then SACK, then SACK + RACK */
+      Config::SetDefault ("ns3::TcpSocketBase::Sack", BooleanValue (scheme > 0));
+      Config::SetDefault ("ns3::TcpSocketBase::Rack", BooleanValue (scheme > 1));
+      m_blocked = false;
+
+      /**** WifiHelper is a meta-helper: it helps creates helpers ****/
+      WifiHelper wifi;
+
+      /* Basic setup */
+      wifi.SetStandard (WIFI_PHY_STANDARD_80211ad);
+
+      /* Turn on logging */
+      if (verbose)
+        {
+          wifi.EnableLogComponents ();
+          LogComponentEnable ("EvaluateTcpSackBlockage", LOG_LEVEL_ALL);
+        }
+
+      /**** Set up Channel ****/
+      YansWifiChannelHelper wifiChannel ;
+      /* Simple propagation delay model */
+      wifiChannel.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+      /* Friis model with standard-specific wavelength */
+      wifiChannel.AddPropagationLoss ("ns3::FriisPropagationLossModel", "Frequency", DoubleValue (56.16e9));
+
+      /**** SETUP ALL NODES ****/
+      YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+      /* Nodes will be added to the channel we set up earlier */
+      Ptr<YansWifiChannel> channel = wifiChannel.Create ();
+      wifiPhy.SetChannel (channel);
+      /* All nodes transmit at 10 dBm == 10 mW, no adaptation */
+      wifiPhy.Set ("TxPowerStart", DoubleValue (10.0));
+      wifiPhy.Set ("TxPowerEnd", DoubleValue (10.0));
+      wifiPhy.Set ("TxPowerLevels", UintegerValue (1));
+      wifiPhy.Set ("TxGain", DoubleValue (0));
+      wifiPhy.Set ("RxGain", DoubleValue (0));
+      /* Sensitivity model includes implementation loss and noise figure */
+      wifiPhy.Set ("RxNoiseFigure", DoubleValue (3));
+      wifiPhy.Set ("CcaMode1Threshold", DoubleValue (-79));
+      wifiPhy.Set ("EnergyDetectionThreshold", DoubleValue (-79 + 3));
+      /* Set the phy layer error model */
+      wifiPhy.SetErrorRateModel ("ns3::SensitivityModel60GHz");
+      /* Set default algorithm for all nodes to be constant rate */
+      wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "ControlMode", StringValue ("DMG_MCS0"),
+                                                                    "DataMode", StringValue (phyMode));
+      /* Give all nodes steerable antenna */
+      wifiPhy.EnableAntenna (true, true);
+      wifiPhy.SetAntenna ("ns3::Directional60GhzAntenna",
+                          "Sectors", UintegerValue (8),
+                          "Antennas", UintegerValue (1),
+                          "AngleOffset", DoubleValue (0));
+
+      /* Make two nodes and set them up with the phy and the mac */
+      NodeContainer wifiNodes;
+      wifiNodes.Create (2);
+      apWifiNode = wifiNodes.Get (0);
+      staWifiNode = wifiNodes.Get (1);
+
+      /**** Allocate a default Adhoc Wifi MAC ****/
+      /* Add a DMG upper mac */
+      DmgWifiMacHelper wifiMac = DmgWifiMacHelper::Default ();
+
+      Ssid ssid = Ssid ("test802.11ad");
+      wifiMac.SetType ("ns3::DmgApWifiMac",
+                       "Ssid", SsidValue (ssid),
+                       "QosSupported", BooleanValue (true), "DmgSupported", BooleanValue (true),
+                       "BE_MaxAmpduSize", UintegerValue (262143), //Enable A-MPDU with the highest maximum size allowed by the standard
+                       "BE_MaxAmsduSize", UintegerValue (7935),
+                       "SSSlotsPerABFT", UintegerValue (8), "SSFramesPerSlot", UintegerValue (8),
+                       "BeaconInterval", TimeValue (MicroSeconds (102400)),
+                       "BeaconTransmissionInterval", TimeValue (MicroSeconds (400)),
+                       "ATIDuration", TimeValue (MicroSeconds (300)));
+
+      NetDeviceContainer apDevice;
+      apDevice = wifi.Install (wifiPhy, wifiMac, apWifiNode);
+
+      wifiMac.SetType ("ns3::DmgStaWifiMac",
+                       "Ssid", SsidValue (ssid),
+                       "ActiveProbing", BooleanValue (false),
+                       "BE_MaxAmpduSize", UintegerValue (262143), //Enable A-MPDU with the highest maximum size allowed by the standard
+                       "BE_MaxAmsduSize", UintegerValue (7935),
+                       "QosSupported", BooleanValue (true), "DmgSupported", BooleanValue (true));
+
+      NetDeviceContainer staDevice;
+      staDevice = wifi.Install (wifiPhy, wifiMac, staWifiNode);
+
+      /* Setting mobility model, Initial Position 1 meter apart */
+      MobilityHelper mobility;
+      Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+      positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+      positionAlloc->Add (Vector (distance, 0.0, 0.0));
+
+      mobility.SetPositionAllocator (positionAlloc);
+      mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+      mobility.Install (wifiNodes);
+
+      /* Internet stack*/
+      InternetStackHelper stack;
+      stack.Install (wifiNodes);
+
+      Ipv4AddressHelper address;
+      address.SetBase ("10.0.0.0", "255.255.255.0");
+      Ipv4InterfaceContainer apInterface;
+      apInterface = address.Assign (apDevice);
+      Ipv4InterfaceContainer staInterface;
+      staInterface = address.Assign (staDevice);
+
+      /* Populate routing table */
+      Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+      /* We do not want any ARP nor NDisc packets */
+      InternetStackHelper::PopulateStaticNeighborTables ();
+
+      /* Install TCP Receiver on the access point */
+      PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), 9999));
+      ApplicationContainer sinkApp = sinkHelper.Install (apWifiNode);
+      Ptr<PacketSink> sink = StaticCast<PacketSink> (sinkApp.Get (0));
+      sinkApp.Start (Seconds (0.0));
+
+      /* Install TCP Transmitter on the station */
+      BulkSendHelper src ("ns3::TcpSocketFactory", InetSocketAddress (apInterface.GetAddress (0), 9999));
+      ApplicationContainer srcApp = src.Install (staWifiNode);
+      srcApp.Start (Seconds (1.0));
+
+      /* Block the path from the station to the access point periodically */
+      Ptr<WifiPhy> srcWifiPhy = StaticCast<WifiNetDevice> (staDevice.Get (0))->GetPhy ();
+      Ptr<WifiPhy> dstWifiPhy = StaticCast<WifiNetDevice> (apDevice.Get (0))->GetPhy ();
+      channel->AddBlockage (&DoInsertBlockage, srcWifiPhy, dstWifiPhy);
+      Simulator::Schedule (Seconds (1.0) + MilliSeconds (blockagePeriod), &ToggleBlockage,
+                           MilliSeconds (blockageDuration), MilliSeconds (blockagePeriod));
+
+      Simulator::Stop (Seconds (simulationTime));
+      Simulator::Run ();
+
+      /* Calculate Throughput */
+      double throughput = sink->GetTotalRx () * (double) 8 / ((simulationTime - 1) * 1e6);
+      cout << (scheme == 0 ? "NewReno" : scheme == 1 ? "SACK" : "SACK+RACK") << '\t' << throughput << endl;
+
+      Simulator::Destroy ();
+    }
+
+  return 0;
+}
@@ -24,8 +24,8 @@
 /**
  * \file
  * \ingroup debugging
- * Definition of build profile macros NS_BUILD_DEBUG, NS_BUILD_RELEASE,
- * and NS_BUILD_OPTIMIZED.
+ * Definition of build profile macros NS_BUILD_DEBUG, NS_BUILD_FAST_DEBUG,
+ * NS_BUILD_RELEASE, and NS_BUILD_OPTIMIZED.
  */
 
 /**
@@ -65,6 +65,18 @@
 #define NS_BUILD_DEBUG(code)     NS_BUILD_PROFILE_NOOP (code)
 #endif
 
+#ifdef NS3_BUILD_PROFILE_FAST_DEBUG
+/**
+ * \ingroup debugging
+ * Execute a code snippet in fast-debug builds: optimized code with the
+ * asserts enabled and the logging compiled out.
+ * \param [in] code The code to execute.
+ */
+#define NS_BUILD_FAST_DEBUG(code) NS_BUILD_PROFILE_OP (code)
+#else
+#define NS_BUILD_FAST_DEBUG(code) NS_BUILD_PROFILE_NOOP (code)
+#endif
+
 #ifdef NS3_BUILD_PROFILE_RELEASE
 /**
  * \ingroup debugging
@@ -31,6 +31,62 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Callback");
 
+namespace {
+
+/** Size granularity of the callback implementation free lists. */
+const size_t CALLBACK_BLOCK_GRANULE = 16;
+/** Number of free lists: larger implementations use the heap. */
+const size_t CALLBACK_BLOCK_CLASSES = 8;
+/** Maximum number of blocks kept in each free list. */
+const uint32_t CALLBACK_BLOCK_MAX_FREE = 4096;
+
+/** A block in a free list. */
+struct CallbackFreeBlock
+{
+  CallbackFreeBlock *next; //!< Next free block of the same size
+};
+
+/** The free lists of the calling thread, one per block size. */
+__thread CallbackFreeBlock *g_callbackFreeBlocks[CALLBACK_BLOCK_CLASSES];
+/** The length of the free lists of the calling thread. */
+__thread uint32_t g_callbackFreeCount[CALLBACK_BLOCK_CLASSES];
+
+} // anonymous namespace
+
+void *
+CallbackImplBase::operator new (size_t size)
+{
+  size_t index = (size - 1) / CALLBACK_BLOCK_GRANULE;
+  if (index >= CALLBACK_BLOCK_CLASSES)
+    {
+      return ::operator new (size);
+    }
+  CallbackFreeBlock *block = g_callbackFreeBlocks[index];
+  if (block == 0)
+    {
+      return ::operator new ((index + 1) * CALLBACK_BLOCK_GRANULE);
+    }
+  g_callbackFreeBlocks[index] = block->next;
+  g_callbackFreeCount[index]--;
+  return block;
+}
+
+void
+CallbackImplBase::operator delete (void *p, size_t size)
+{
+  size_t index = (size - 1) / CALLBACK_BLOCK_GRANULE;
+  if (index >= CALLBACK_BLOCK_CLASSES
+      || g_callbackFreeCount[index] >= CALLBACK_BLOCK_MAX_FREE)
+    {
+      ::operator delete (p);
+      return;
+    }
+  CallbackFreeBlock *block = static_cast<CallbackFreeBlock *> (p);
+  block->next = g_callbackFreeBlocks[index];
+  g_callbackFreeBlocks[index] = block;
+  g_callbackFreeCount[index]++;
+}
+
 CallbackValue::CallbackValue ()
   : m_value ()
 {
@@ -135,12 +135,30 @@ struct CallbackTraits<T *>
  * \ingroup callbackimpl
  * Abstract base class for CallbackImpl
  * Provides reference counting and equality test.
+ *
+ * The implementations are small, short-lived objects created by every
+ * MakeCallback and Bind: they are allocated from per-thread free lists
+ * of fixed size blocks rather than from the general purpose heap.
  */
 class CallbackImplBase : public SimpleRefCount<CallbackImplBase>
 {
 public:
   /** Virtual destructor */
   virtual ~CallbackImplBase () {}
+  /**
+   * Allocate a callback implementation.
+   *
+   * \param [in] size The size of the implementation object.
+   * \return The memory block.
+   */
+  static void * operator new (size_t size);
+  /**
+   * Release a callback implementation.
+   *
+   * \param [in] p The memory block.
+   * \param [in] size The size of the implementation object.
+   */
+  static void operator delete (void *p, size_t size);
   /**
    * Equality test
    *
@@ -25,8 +25,12 @@
 #include "names.h"
 #include "pointer.h"
 #include "log.h"
+#include "flat-hash-map.h"
+#include "simple-ref-count.h"
+#include "trace-source-accessor.h"
 
 #include <sstream>
+#include <algorithm>
 
 /**
  * \file
@@ -746,6 +750,561 @@ ConfigImpl::GetRootNamespaceObject (uint32_t i) const
 
 namespace Config {
 
+/** The parsed elements of a CompiledPath, and their caches. */
+class CompiledPathImpl : public SimpleRefCount<CompiledPathImpl>
+{
+public:
+  /**
+   * Parse a path.
+   *
+   * \param [in] path The path of the objects followed by the name of an
+   *             attribute or trace source.
+   */
+  CompiledPathImpl (std::string path);
+
+  /**
+   * Find the objects which match the path without its last element.
+   *
+   * \param [out] objects The objects.
+   * \param [out] contexts The contexts of the objects.
+   */
+  void Resolve (std::vector<Ptr<Object> > &objects, std::vector<std::string> &contexts);
+  /**
+   * \param [in] object An object matching the path.
+   * \returns The accessor of the trace source of the path in the object,
+   *          or 0 if there is none.
+   */
+  Ptr<const TraceSourceAccessor> LookupTraceSource (Ptr<Object> object);
+
+  /** The path. */
+  std::string m_path;
+  /** The path without its last element. */
+  std::string m_root;
+  /** The last element of the path. */
+  std::string m_leaf;
+
+private:
+  /** An attribute which leads to other objects. */
+  struct Attribute
+  {
+    /** The name of the attribute. */
+    std::string name;
+    /** The accessor of the attribute. */
+    Ptr<const AttributeAccessor> accessor;
+    /** Whether the attribute is an ObjectPtrContainer, or a Pointer. */
+    bool isContainer;
+  };
+  /** An element of the path, between two slashes. */
+  struct Element
+  {
+    /** The element. */
+    std::string name;
+    /** Whether the element is a GetObject, i.e., starts with '$'. */
+    bool isGetObject;
+    /** The TypeId of a GetObject element. */
+    TypeId tid;
+    /** Whether the element matches any index of a container. */
+    bool anyIndex;
+    /** The ranges of the indices matched by the element, bounds included. */
+    std::vector<std::pair<uint32_t, uint32_t> > indices;
+    /** TypeId uid --> the attributes of the TypeId named by the element. */
+    FlatHashMap<uint32_t, std::vector<Attribute> > attributes;
+
+    /**
+     * \param [in] index The index of an object in a container.
+     * \returns \c true if the element matches the index.
+     */
+    bool Matches (uint32_t index) const;
+  };
+
+  /**
+   * Parse an index, as ArrayMatcher does.
+   *
+   * \param [in] str The string.
+   * \param [out] value The index.
+   * \returns \c true if the string could be converted.
+   */
+  static bool StringToUint32 (std::string str, uint32_t *value);
+  /**
+   * \param [in] element An element of the path.
+   * \param [in] tid The TypeId of an object.
+   * \returns The attributes of the TypeId and its parents which are
+   *          named by the element, in the order of Resolver.
+   */
+  const std::vector<Attribute> & GetAttributes (Element &element, TypeId tid);
+  /**
+   * Resolve the elements of the path from an object.
+   *
+   * \param [in] i The index of the element.
+   * \param [in] root The object, or 0 for the root of the Names.
+   */
+  void DoResolve (uint32_t i, Ptr<Object> root);
+  /**
+   * Resolve the index of a container and the following elements.
+   *
+   * \param [in] i The index of the element of the index.
+   * \param [in] root The object of the container.
+   * \param [in] attribute The container attribute.
+   */
+  void DoArrayResolve (uint32_t i, Ptr<Object> root, const Attribute &attribute);
+  /**
+   * Resolve the following elements from an object.
+   *
+   * \param [in] i The index of the element.
+   * \param [in] name The name of the object in the context.
+   * \param [in] object The object.
+   */
+  void Push (uint32_t i, const std::string &name, Ptr<Object> object);
+
+  /** The elements of m_root. */
+  std::vector<Element> m_elements;
+  /** TypeId uid --> the accessor of the trace source m_leaf. */
+  FlatHashMap<uint32_t, Ptr<const TraceSourceAccessor> > m_traceSources;
+  /** The context of the object being resolved. */
+  std::string m_context;
+  /** The objects found by Resolve. */
+  std::vector<Ptr<Object> > *m_objects;
+  /** The contexts found by Resolve. */
+  std::vector<std::string> *m_contexts;
+};
+
+CompiledPathImpl::CompiledPathImpl (std::string path)
+  : m_path (path),
+    m_objects (0),
+    m_contexts (0)
+{
+  NS_LOG_FUNCTION (this << path);
+  std::string::size_type slash = path.find_last_of ("/");
+  NS_ASSERT (slash != std::string::npos);
+  m_root = path.substr (0, slash);
+  m_leaf = path.substr (slash + 1, path.size () - (slash + 1));
+
+  // the elements between the slashes of the canonical path of Resolver
+  std::string canonical = m_root;
+  if (canonical.find ("/") != 0)
+    {
+      canonical = "/" + canonical;
+    }
+  if (canonical.find_last_of ("/") != canonical.size () - 1)
+    {
+      canonical = canonical + "/";
+    }
+  std::string::size_type start = 1;
+  while (start < canonical.size ())
+    {
+      std::string::size_type next = canonical.find ("/", start);
+      std::string item = canonical.substr (start, next - start);
+      start = next + 1;
+      Element element;
+      element.name = item;
+      element.isGetObject = item.find ("$") == 0;
+      if (element.isGetObject)
+        {
+          element.tid = TypeId::LookupByName (item.substr (1, item.size () - 1));
+        }
+      element.anyIndex = false;
+      // the alternatives of ArrayMatcher
+      std::string alternatives = item;
+      while (!alternatives.empty ())
+        {
+          std::string::size_type bar = alternatives.find ("|");
+          std::string alternative = alternatives.substr (0, bar);
+          alternatives = bar == std::string::npos ? "" : alternatives.substr (bar + 1);
+          std::string::size_type leftBracket = alternative.find ("[");
+          std::string::size_type rightBracket = alternative.find ("]");
+          std::string::size_type dash = alternative.find ("-");
+          uint32_t min;
+          uint32_t max;
+          if (alternative == "*")
+            {
+              element.anyIndex = true;
+            }
+          else if (leftBracket == 0 && rightBracket == alternative.size () - 1 &&
+                   dash > leftBracket && dash < rightBracket)
+            {
+              if (StringToUint32 (alternative.substr (leftBracket + 1, dash - (leftBracket + 1)), &min) &&
+                  StringToUint32 (alternative.substr (dash + 1, rightBracket - (dash + 1)), &max))
+                {
+                  element.indices.push_back (std::make_pair (min, max));
+                }
+            }
+          else if (StringToUint32 (alternative, &min))
+            {
+              element.indices.push_back (std::make_pair (min, min));
+            }
+        }
+      m_elements.push_back (element);
+    }
+}
+
+bool
+CompiledPathImpl::StringToUint32 (std::string str, uint32_t *value)
+{
+  std::istringstream iss;
+  iss.str (str);
+  iss >> (*value);
+  return !iss.bad () && !iss.fail ();
+}
+
+bool
+CompiledPathImpl::Element::Matches (uint32_t index) const
+{
+  if (anyIndex)
+    {
+      return true;
+    }
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator i = indices.begin (); i != indices.end (); ++i)
+    {
+      if (index >= i->first && index <= i->second)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+const std::vector<CompiledPathImpl::Attribute> &
+CompiledPathImpl::GetAttributes (Element &element, TypeId instanceTid)
+{
+  bool inserted;
+  std::vector<Attribute> &attributes = element.attributes.Insert (instanceTid.GetUid (), std::vector<Attribute> (), inserted);
+  if (!inserted)
+    {
+      return attributes;
+    }
+  TypeId tid;
+  TypeId nextTid = instanceTid;
+  do
+    {
+      tid = nextTid;
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+          if (info.name != element.name && element.name != "*")
+            {
+              continue;
+            }
+          Attribute attribute;
+          attribute.name = info.name;
+          attribute.accessor = info.accessor;
+          if (dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.isContainer = false;
+              attributes.push_back (attribute);
+            }
+          else if (dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.isContainer = true;
+              attributes.push_back (attribute);
+            }
+        }
+      nextTid = tid.GetParent ();
+    }
+  while (nextTid != tid);
+  return attributes;
+}
+
+void
+CompiledPathImpl::Resolve (std::vector<Ptr<Object> > &objects, std::vector<std::string> &contexts)
+{
+  NS_LOG_FUNCTION (this);
+  m_objects = &objects;
+  m_contexts = &contexts;
+  ConfigImpl *config = ConfigImpl::Get ();
+  for (uint32_t i = 0; i < config->GetRootNamespaceObjectN (); i++)
+    {
+      m_context = "/";
+      DoResolve (0, config->GetRootNamespaceObject (i));
+    }
+  m_context = "/";
+  DoResolve (0, 0);
+  m_objects = 0;
+  m_contexts = 0;
+}
+
+void
+CompiledPathImpl::Push (uint32_t i, const std::string &name, Ptr<Object> object)
+{
+  std::string::size_type size = m_context.size ();
+  m_context += name;
+  m_context += '/';
+  DoResolve (i, object);
+  m_context.resize (size);
+}
+
+void
+CompiledPathImpl::DoResolve (uint32_t i, Ptr<Object> root)
+{
+  if (i == m_elements.size ())
+    {
+      if (root)
+        {
+          m_objects->push_back (root);
+          m_contexts->push_back (m_context);
+        }
+      return;
+    }
+  Element &element = m_elements[i];
+
+  // the same steps as Resolver::DoResolve
+  if (root == 0 && element.name.compare (0, 5, "Names") == 0)
+    {
+      Push (i + 1, element.name, root);
+      return;
+    }
+  Ptr<Object> namedObject = Names::Find<Object> (root, element.name);
+  if (namedObject)
+    {
+      Push (i + 1, element.name, namedObject);
+      return;
+    }
+  if (root == 0)
+    {
+      return;
+    }
+  if (element.isGetObject)
+    {
+      Ptr<Object> object = root->GetObject<Object> (element.tid);
+      if (object != 0)
+        {
+          Push (i + 1, element.name, object);
+        }
+      return;
+    }
+  const std::vector<Attribute> &attributes = GetAttributes (element, root->GetInstanceTypeId ());
+  for (std::vector<Attribute>::const_iterator attribute = attributes.begin (); attribute != attributes.end (); ++attribute)
+    {
+      if (attribute->isContainer)
+        {
+          DoArrayResolve (i + 1, root, *attribute);
+          continue;
+        }
+      PointerValue ptr;
+      attribute->accessor->Get (PeekPointer (root), ptr);
+      Ptr<Object> object = ptr.Get<Object> ();
+      if (object == 0)
+        {
+          NS_LOG_ERROR ("Requested object name=\"" << element.name <<
+                        "\" exists on path=\"" << m_context << "\""
+                        " but is null.");
+          continue;
+        }
+      Push (i + 1, attribute->name, object);
+    }
+}
+
+/**
+ * \param [in] a An object of a container and its index.
+ * \param [in] b An object of a container and its index.
+ * \returns \c true if the index of a is lower than the index of b.
+ */
+static bool
+IndexLess (const std::pair<uint32_t, Ptr<Object> > &a, const std::pair<uint32_t, Ptr<Object> > &b)
+{
+  return a.first < b.first;
+}
+/**
+ * \param [in] a An object of a container and its index.
+ * \param [in] b An object of a container and its index.
+ * \returns \c true if a and b have the same index.
+ */
+static bool
+IndexEqual (const std::pair<uint32_t, Ptr<Object> > &a, const std::pair<uint32_t, Ptr<Object> > &b)
+{
+  return a.first == b.first;
+}
+
+void
+CompiledPathImpl::DoArrayResolve (uint32_t i, Ptr<Object> root, const Attribute &attribute)
+{
+  if (i == m_elements.size ())
+    {
+      return;
+    }
+  const ObjectPtrContainerAccessor *accessor =
+    dynamic_cast<const ObjectPtrContainerAccessor *> (PeekPointer (attribute.accessor));
+  uint32_t n;
+  if (accessor == 0 || !accessor->GetN (PeekPointer (root), &n))
+    {
+      return;
+    }
+  std::string::size_type size = m_context.size ();
+  m_context += attribute.name;
+  m_context += '/';
+  const Element &element = m_elements[i];
+  uint32_t index;
+  Ptr<Object> object;
+  if (!element.anyIndex && element.indices.size () == 1
+      && element.indices[0].first == element.indices[0].second
+      && element.indices[0].first < n)
+    {
+      // most containers hold the object of index i at the position i
+      object = accessor->GetAt (PeekPointer (root), element.indices[0].first, &index);
+      if (index == element.indices[0].first)
+        {
+          std::ostringstream oss;
+          oss << index;
+          Push (i + 1, oss.str (), object);
+          m_context.resize (size);
+          return;
+        }
+    }
+  // as the ObjectPtrContainerValue of Resolver, sorted by index
+  std::vector<std::pair<uint32_t, Ptr<Object> > > matches;
+  bool sorted = true;
+  for (uint32_t position = 0; position < n; position++)
+    {
+      object = accessor->GetAt (PeekPointer (root), position, &index);
+      if (element.Matches (index))
+        {
+          sorted = sorted && (matches.empty () || matches.back ().first < index);
+          matches.push_back (std::make_pair (index, object));
+        }
+    }
+  if (!sorted)
+    {
+      std::stable_sort (matches.begin (), matches.end (), IndexLess);
+      matches.erase (std::unique (matches.begin (), matches.end (), IndexEqual), matches.end ());
+    }
+  for (std::vector<std::pair<uint32_t, Ptr<Object> > >::const_iterator match = matches.begin ();
+       match != matches.end (); ++match)
+    {
+      std::ostringstream oss;
+      oss << match->first;
+      Push (i + 1, oss.str (), match->second);
+    }
+  m_context.resize (size);
+}
+
+Ptr<const TraceSourceAccessor>
+CompiledPathImpl::LookupTraceSource (Ptr<Object> object)
+{
+  TypeId tid = object->GetInstanceTypeId ();
+  bool inserted;
+  Ptr<const TraceSourceAccessor> &accessor = m_traceSources.Insert (tid.GetUid (), Ptr<const TraceSourceAccessor> (), inserted);
+  if (inserted)
+    {
+      accessor = tid.LookupTraceSourceByName (m_leaf);
+    }
+  return accessor;
+}
+
+CompiledPath::CompiledPath (std::string path)
+  : m_impl (new CompiledPathImpl (path))
+{
+  NS_LOG_FUNCTION (this << path);
+}
+CompiledPath::CompiledPath (const CompiledPath &o)
+  : m_impl (o.m_impl)
+{
+  NS_LOG_FUNCTION (this << &o);
+  m_impl->Ref ();
+}
+CompiledPath &
+CompiledPath::operator = (const CompiledPath &o)
+{
+  NS_LOG_FUNCTION (this << &o);
+  o.m_impl->Ref ();
+  m_impl->Unref ();
+  m_impl = o.m_impl;
+  return *this;
+}
+CompiledPath::~CompiledPath ()
+{
+  NS_LOG_FUNCTION (this);
+  m_impl->Unref ();
+  m_impl = 0;
+}
+std::string
+CompiledPath::GetPath (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_impl->m_path;
+}
+MatchContainer
+CompiledPath::LookupMatches (void) const
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<Ptr<Object> > objects;
+  std::vector<std::string> contexts;
+  m_impl->Resolve (objects, contexts);
+  return MatchContainer (objects, contexts, m_impl->m_root);
+}
+void
+CompiledPath::Set (const AttributeValue &value) const
+{
+  NS_LOG_FUNCTION (this << &value);
+  LookupMatches ().Set (m_impl->m_leaf, value);
+}
+void
+CompiledPath::Connect (const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << &cb);
+  std::vector<Ptr<Object> > objects;
+  std::vector<std::string> contexts;
+  m_impl->Resolve (objects, contexts);
+  for (uint32_t i = 0; i < objects.size (); i++)
+    {
+      Ptr<const TraceSourceAccessor> accessor = m_impl->LookupTraceSource (objects[i]);
+      if (accessor != 0)
+        {
+          accessor->Connect (PeekPointer (objects[i]), contexts[i] + m_impl->m_leaf, cb);
+        }
+    }
+}
+void
+CompiledPath::ConnectWithoutContext (const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << &cb);
+  std::vector<Ptr<Object> > objects;
+  std::vector<std::string> contexts;
+  m_impl->Resolve (objects, contexts);
+  for (uint32_t i = 0; i < objects.size (); i++)
+    {
+      Ptr<const TraceSourceAccessor> accessor = m_impl->LookupTraceSource (objects[i]);
+      if (accessor != 0)
+        {
+          accessor->ConnectWithoutContext (PeekPointer (objects[i]), cb);
+        }
+    }
+}
+void
+CompiledPath::Disconnect (const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << &cb);
+  std::vector<Ptr<Object> > objects;
+  std::vector<std::string> contexts;
+  m_impl->Resolve (objects, contexts);
+  for (uint32_t i = 0; i < objects.size (); i++)
+    {
+      Ptr<const TraceSourceAccessor> accessor = m_impl->LookupTraceSource (objects[i]);
+      if (accessor != 0)
+        {
+          accessor->Disconnect (PeekPointer (objects[i]), contexts[i] + m_impl->m_leaf, cb);
+        }
+    }
+}
+void
+CompiledPath::DisconnectWithoutContext (const CallbackBase &cb) const
+{
+  NS_LOG_FUNCTION (this << &cb);
+  std::vector<Ptr<Object> > objects;
+  std::vector<std::string> contexts;
+  m_impl->Resolve (objects, contexts);
+  for (uint32_t i = 0; i < objects.size (); i++)
+    {
+      Ptr<const TraceSourceAccessor> accessor = m_impl->LookupTraceSource (objects[i]);
+      if (accessor != 0)
+        {
+          accessor->DisconnectWithoutContext (PeekPointer (objects[i]), cb);
+        }
+    }
+}
+
+} // namespace Config
+
+namespace Config {
+
 void Reset (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -250,6 +250,104 @@ private:
   std::string m_path;
 };
 
+class CompiledPathImpl;
+
+/**
+ * \ingroup config
+ * \brief A Config path parsed once, to be resolved many times.
+ *
+ * The path has the syntax of the paths of Config::Set and
+ * Config::Connect: the path of the objects followed by the name of an
+ * attribute or trace source, e.g.,
+ * "/NodeList/[0-9]/DeviceList/0/$ns3::WifiNetDevice/Phy/PhyTxBegin".
+ *
+ * Config::Connect parses the path again for each object it visits, and
+ * looks up the attributes of each object by name.  A CompiledPath
+ * splits the path into its elements and parses the indices and the
+ * TypeIds of GetObject elements when it is constructed.  While
+ * resolving it, it keeps for each element and TypeId the attributes
+ * and trace sources which match, and it fetches the objects of an
+ * exact index directly from the container attributes, instead of
+ * fetching all the objects of the containers, e.g., all the nodes for
+ * "/NodeList/12/...".  Connecting a trace sink per node with a
+ * CompiledPath per node is then linear in the number of nodes.
+ *
+ * The objects matched, their order and their contexts are the same as
+ * with Config::LookupMatches and Config::Connect.
+ */
+class CompiledPath
+{
+public:
+  /**
+   * Parse a path.
+   *
+   * \param [in] path The path of the objects followed by the name of an
+   *             attribute or trace source.
+   */
+  CompiledPath (std::string path);
+  /**
+   * Copy constructor: the copies share the parsed path.
+   * \param [in] o The other compiled path.
+   */
+  CompiledPath (const CompiledPath &o);
+  /**
+   * Assignment: the copies share the parsed path.
+   * \param [in] o The other compiled path.
+   * \returns This compiled path.
+   */
+  CompiledPath &operator = (const CompiledPath &o);
+  ~CompiledPath ();
+
+  /**
+   * \returns The path.
+   */
+  std::string GetPath (void) const;
+  /**
+   * \returns The objects which match the path without its last element,
+   *          i.e., the objects of the attribute or trace source.
+   */
+  MatchContainer LookupMatches (void) const;
+  /**
+   * Set the attribute of all the objects matching the path.
+   *
+   * \param [in] value The value to set.
+   * \sa Config::Set
+   */
+  void Set (const AttributeValue &value) const;
+  /**
+   * Connect a sink to the trace source of all the objects matching the
+   * path, with their context.
+   *
+   * \param [in] cb The sink.
+   * \sa Config::Connect
+   */
+  void Connect (const CallbackBase &cb) const;
+  /**
+   * Connect a sink to the trace source of all the objects matching the
+   * path.
+   *
+   * \param [in] cb The sink.
+   * \sa Config::ConnectWithoutContext
+   */
+  void ConnectWithoutContext (const CallbackBase &cb) const;
+  /**
+   * Undo the work of Connect.
+   *
+   * \param [in] cb The sink.
+   */
+  void Disconnect (const CallbackBase &cb) const;
+  /**
+   * Undo the work of ConnectWithoutContext.
+   *
+   * \param [in] cb The sink.
+   */
+  void DisconnectWithoutContext (const CallbackBase &cb) const;
+
+private:
+  /** The parsed path. */
+  CompiledPathImpl *m_impl;
+};
+
 /**
  * \ingroup config
  * \param [in] path The path to perform a match against
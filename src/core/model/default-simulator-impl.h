@@ -24,6 +24,7 @@
 #include "simulator-impl.h"
 #include "scheduler.h"
 #include "event-impl.h"
+#include "event-profiler.h"
 #include "system-thread.h"
 #include "ns3/system-mutex.h"
 
@@ -132,6 +133,13 @@ private:
 
   /** Main execution thread. */
   SystemThread::ThreadId m_main;
+
+  /** Flag \c true if the events are run through the profiler. */
+  bool m_profiling;
+  /** Prefix of the event profile report files. */
+  std::string m_profileFile;
+  /** The event profiler. */
+  EventProfiler m_profiler;
 };
 
 } // namespace ns3
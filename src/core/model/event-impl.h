@@ -65,6 +65,15 @@ public:
    * Checked by the simulation engine before calling Invoke().
    */
   bool IsCancelled (void);
+  /**
+   * \returns The address of the function or method called by this
+   * event, or zero if it is not known.
+   *
+   * Used by the EventProfiler to attribute the execution time of the
+   * event to the scheduled function.  It must only be called on an
+   * event which is not cancelled, before Invoke().
+   */
+  virtual const void * GetFunction (void) const;
 
 protected:
   /**
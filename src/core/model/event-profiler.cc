@@ -0,0 +1,407 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-profiler.h"
+#include "event-impl.h"
+#include "log.h"
+#include "ns3/core-config.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <typeinfo>
+#include <vector>
+#include <time.h>
+
+#ifdef HAVE_DLFCN_H
+#include <dlfcn.h>
+#endif
+#if (__GNUC__ >= 3)
+#include <cxxabi.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EventProfiler");
+
+namespace {
+
+/** \returns The monotonic wall clock time, in ns. */
+inline uint64_t
+GetWallClockNs (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * \param [in] mangled A mangled C++ name.
+ * \returns The demangled name, or the mangled one on failure.
+ */
+std::string
+Demangle (const char *mangled)
+{
+#if (__GNUC__ >= 3)
+  int status;
+  char *demangled = abi::__cxa_demangle (mangled, NULL, NULL, &status);
+  if (status == 0 && demangled != 0)
+    {
+      std::string ret = demangled;
+      std::free (demangled);
+      return ret;
+    }
+  std::free (demangled);
+#endif
+  return mangled;
+}
+
+/**
+ * \param [in] s A string.
+ * \returns The string, quoted and escaped for JSON.
+ */
+std::string
+JsonQuote (const std::string &s)
+{
+  std::ostringstream oss;
+  oss << '"';
+  for (std::string::const_iterator i = s.begin (); i != s.end (); i++)
+    {
+      if (*i == '"' || *i == '\\')
+        {
+          oss << '\\' << *i;
+        }
+      else if ((unsigned char)*i < 0x20)
+        {
+          oss << "\\u" << std::hex << std::setw (4) << std::setfill ('0')
+              << (int)*i << std::dec << std::setfill (' ');
+        }
+      else
+        {
+          oss << *i;
+        }
+    }
+  oss << '"';
+  return oss.str ();
+}
+
+/**
+ * Sort the statistics by decreasing total time.
+ * \param [in] a The first statistics.
+ * \param [in] b The second statistics.
+ * \returns true if a took longer than b.
+ */
+template <typename T>
+bool
+CompareTotal (const std::pair<T, EventProfiler::Stats> &a,
+              const std::pair<T, EventProfiler::Stats> &b)
+{
+  if (a.second.total != b.second.total)
+    {
+      return a.second.total > b.second.total;
+    }
+  return a.first < b.first;
+}
+
+/**
+ * \param [in] context A context.
+ * \returns The context as a string.
+ */
+std::string
+ContextName (uint32_t context)
+{
+  if (context == 0xffffffff)
+    {
+      return "none";
+    }
+  std::ostringstream oss;
+  oss << context;
+  return oss.str ();
+}
+
+/**
+ * Print the histogram and the other statistics as JSON members.
+ * \param [in] os The output stream.
+ * \param [in] stats The statistics.
+ */
+void
+PrintJsonStats (std::ostream &os, const EventProfiler::Stats &stats)
+{
+  os << "\"count\": " << stats.count
+     << ", \"totalNs\": " << stats.total
+     << ", \"maxNs\": " << stats.max
+     << ", \"histogram\": [";
+  uint32_t bins = EventProfiler::HISTOGRAM_BINS;
+  while (bins > 1 && stats.histogram[bins - 1] == 0)
+    {
+      bins--;
+    }
+  for (uint32_t i = 0; i < bins; i++)
+    {
+      os << (i == 0 ? "" : ", ") << stats.histogram[i];
+    }
+  os << "]";
+}
+
+} // anonymous namespace
+
+EventProfiler::Stats::Stats ()
+  : count (0),
+    total (0),
+    max (0)
+{
+  std::fill (histogram, histogram + HISTOGRAM_BINS, 0);
+}
+
+void
+EventProfiler::Stats::Add (uint64_t duration)
+{
+  count++;
+  total += duration;
+  max = std::max (max, duration);
+  uint32_t bin = 0;
+  while (bin < HISTOGRAM_BINS - 1 && (duration >> (bin + 1)) != 0)
+    {
+      bin++;
+    }
+  histogram[bin]++;
+}
+
+void
+EventProfiler::Stats::Merge (const Stats &other)
+{
+  count += other.count;
+  total += other.total;
+  max = std::max (max, other.max);
+  for (uint32_t i = 0; i < HISTOGRAM_BINS; i++)
+    {
+      histogram[i] += other.histogram[i];
+    }
+}
+
+EventProfiler::EventProfiler ()
+  : m_lastFunction (0, 0),
+    m_lastStats (0),
+    m_count (0),
+    m_total (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+EventProfiler::Invoke (EventImpl *event, uint32_t context)
+{
+  if (event->IsCancelled ())
+    {
+      event->Invoke ();
+      return;
+    }
+  FunctionKey key (event->GetFunction (), typeid (*event).name ());
+  uint64_t start = GetWallClockNs ();
+  event->Invoke ();
+  uint64_t duration = GetWallClockNs () - start;
+
+  if (m_lastStats == 0 || key != m_lastFunction)
+    {
+      m_lastFunction = key;
+      m_lastStats = &m_functions[key];
+    }
+  m_lastStats->Add (duration);
+  m_contexts[context].Add (duration);
+  m_count++;
+  m_total += duration;
+}
+
+void
+EventProfiler::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_functions.clear ();
+  m_contexts.clear ();
+  m_lastStats = 0;
+  m_count = 0;
+  m_total = 0;
+}
+
+uint64_t
+EventProfiler::GetEventCount (void) const
+{
+  return m_count;
+}
+
+uint64_t
+EventProfiler::GetTotalTime (void) const
+{
+  return m_total;
+}
+
+std::string
+EventProfiler::GetFunctionName (FunctionKey key)
+{
+#ifdef HAVE_DLFCN_H
+  Dl_info info;
+  if (key.first != 0 && dladdr (key.first, &info) != 0
+      && info.dli_sname != 0 && info.dli_saddr == key.first)
+    {
+      return Demangle (info.dli_sname);
+    }
+#endif
+  return Demangle (key.second);
+}
+
+std::map<std::string, EventProfiler::Stats>
+EventProfiler::GetFunctionStats (void) const
+{
+  NS_LOG_FUNCTION (this);
+  std::map<std::string, Stats> functions;
+  for (std::map<FunctionKey, Stats>::const_iterator i = m_functions.begin ();
+       i != m_functions.end (); i++)
+    {
+      functions[GetFunctionName (i->first)].Merge (i->second);
+    }
+  return functions;
+}
+
+void
+EventProfiler::Print (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << &os);
+  std::map<std::string, Stats> functionMap = GetFunctionStats ();
+  std::vector<std::pair<std::string, Stats> > functions (functionMap.begin (), functionMap.end ());
+  std::sort (functions.begin (), functions.end (), CompareTotal<std::string>);
+  std::vector<std::pair<uint32_t, Stats> > contexts (m_contexts.begin (), m_contexts.end ());
+  std::sort (contexts.begin (), contexts.end (), CompareTotal<uint32_t>);
+  double total = m_total > 0 ? m_total : 1;
+
+  std::ios::fmtflags flags = os.flags ();
+  std::streamsize precision = os.precision ();
+  os << std::fixed;
+  os << "Event profile: " << m_count << " events, "
+     << std::setprecision (3) << m_total / 1e6 << " ms" << std::endl
+     << std::endl;
+  os << std::setw (12) << "count" << std::setw (14) << "total (ms)"
+     << std::setw (8) << "%" << std::setw (12) << "mean (us)"
+     << std::setw (12) << "max (us)" << "  function" << std::endl;
+  for (std::vector<std::pair<std::string, Stats> >::const_iterator i = functions.begin ();
+       i != functions.end (); i++)
+    {
+      const Stats &stats = i->second;
+      os << std::setw (12) << stats.count
+         << std::setw (14) << std::setprecision (3) << stats.total / 1e6
+         << std::setw (8) << std::setprecision (2) << 100 * stats.total / total
+         << std::setw (12) << std::setprecision (3) << stats.total / 1e3 / stats.count
+         << std::setw (12) << stats.max / 1e3
+         << "  " << i->first << std::endl;
+    }
+  os << std::endl;
+  os << std::setw (12) << "count" << std::setw (14) << "total (ms)"
+     << std::setw (8) << "%" << std::setw (12) << "mean (us)"
+     << std::setw (12) << "max (us)" << "  context" << std::endl;
+  for (std::vector<std::pair<uint32_t, Stats> >::const_iterator i = contexts.begin ();
+       i != contexts.end (); i++)
+    {
+      const Stats &stats = i->second;
+      os << std::setw (12) << stats.count
+         << std::setw (14) << std::setprecision (3) << stats.total / 1e6
+         << std::setw (8) << std::setprecision (2) << 100 * stats.total / total
+         << std::setw (12) << std::setprecision (3) << stats.total / 1e3 / stats.count
+         << std::setw (12) << stats.max / 1e3
+         << "  " << ContextName (i->first) << std::endl;
+    }
+  os.flags (flags);
+  os.precision (precision);
+}
+
+void
+EventProfiler::PrintJson (std::ostream &os) const
+{
+  NS_LOG_FUNCTION (this << &os);
+  std::map<std::string, Stats> functionMap = GetFunctionStats ();
+  std::vector<std::pair<std::string, Stats> > functions (functionMap.begin (), functionMap.end ());
+  std::sort (functions.begin (), functions.end (), CompareTotal<std::string>);
+  std::vector<std::pair<uint32_t, Stats> > contexts (m_contexts.begin (), m_contexts.end ());
+  std::sort (contexts.begin (), contexts.end (), CompareTotal<uint32_t>);
+
+  os << "{" << std::endl
+     << "  \"events\": " << m_count << "," << std::endl
+     << "  \"totalNs\": " << m_total << "," << std::endl
+     << "  \"histogramBins\": \"log2(ns)\"," << std::endl
+     << "  \"functions\": [";
+  for (std::vector<std::pair<std::string, Stats> >::const_iterator i = functions.begin ();
+       i != functions.end (); i++)
+    {
+      os << (i == functions.begin () ? "" : ",") << std::endl
+         << "    {\"name\": " << JsonQuote (i->first) << ", ";
+      PrintJsonStats (os, i->second);
+      os << "}";
+    }
+  os << std::endl << "  ]," << std::endl
+     << "  \"contexts\": [";
+  for (std::vector<std::pair<uint32_t, Stats> >::const_iterator i = contexts.begin ();
+       i != contexts.end (); i++)
+    {
+      os << (i == contexts.begin () ? "" : ",") << std::endl
+         << "    {\"context\": ";
+      if (i->first == 0xffffffff)
+        {
+          os << "null";
+        }
+      else
+        {
+          os << i->first;
+        }
+      os << ", ";
+      PrintJsonStats (os, i->second);
+      os << "}";
+    }
+  os << std::endl << "  ]" << std::endl
+     << "}" << std::endl;
+}
+
+void
+EventProfiler::Write (std::string prefix) const
+{
+  NS_LOG_FUNCTION (this << prefix);
+  std::string text = prefix + ".txt";
+  std::ofstream os (text.c_str ());
+  if (!os.is_open ())
+    {
+      NS_LOG_WARN ("Cannot write the event profile into " << text);
+      return;
+    }
+  Print (os);
+  os.close ();
+
+  std::string json = prefix + ".json";
+  os.open (json.c_str ());
+  if (!os.is_open ())
+    {
+      NS_LOG_WARN ("Cannot write the event profile into " << json);
+      return;
+    }
+  PrintJson (os);
+  os.close ();
+}
+
+} // namespace ns3
@@ -78,6 +78,15 @@
  *   NS_LOG_FUNCTION (this << arg1 << args);
  * \endcode
  * Use NS_LOG_FUNCTION_NOARGS() only in static functions with no arguments.
+ *
+ * The logging macros are only compiled in the debug build profile.  They
+ * are compiled out in the fast-debug, optimized and release profiles, and
+ * in the modules listed with
+ * \code
+ *   $ ./waf configure --disable-logging-modules=wifi,antenna
+ * \endcode
+ * so that the arguments of the macros cost nothing in the hot paths of
+ * those modules, whatever the build profile.
  */
 /** @{ */
 
@@ -409,6 +418,16 @@ private:
 
 };  // class LogComponent
 
+/*
+ * Inlined, since every NS_LOG macro checks it, most of the time
+ * for a disabled level.
+ */
+inline bool
+LogComponent::IsEnabled (const enum LogLevel level) const
+{
+  return (level & m_levels) ? 1 : 0;
+}
+
   
 /**
  * Insert `, ` when streaming function arguments.
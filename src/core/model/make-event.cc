@@ -48,6 +48,10 @@ public:
     {
     }
 protected:
+    virtual const void * GetFunction (void) const
+    {
+      return EventFunctionImplGetFunction (m_function);
+    }
     virtual void Notify (void)
     {
       (*m_function)();
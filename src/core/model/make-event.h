@@ -302,6 +302,48 @@ struct EventMemberImplObjTraits<T *>
   }
 };
 
+/**
+ * \ingroup makeeventmemptr
+ * Helper for the MakeEvent functions which take a class method.
+ *
+ * Get the address of the code called by the event, resolving
+ * virtual methods on the bound object.  This relies on a GNU C++
+ * extension; other compilers return zero, and the event is then
+ * only identified by its type.
+ *
+ * \tparam MEM \deduced The class method function signature.
+ * \tparam OBJ \deduced The class type holding the method.
+ * \param [in] function The class method pointer.
+ * \param [in] obj The object on which the method is called.
+ * \returns The address of the method, or zero.
+ */
+template <typename MEM, typename OBJ>
+const void * EventMemberImplGetFunction (MEM function, OBJ obj)
+{
+#if defined (__GNUC__) && !defined (__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpmf-conversions"
+  return (const void *)(EventMemberImplObjTraits<OBJ>::GetReference (obj).*function);
+#pragma GCC diagnostic pop
+#else
+  return 0;
+#endif
+}
+
+/**
+ * \ingroup makeeventfnptr
+ * Helper for the MakeEvent functions which take a function pointer.
+ *
+ * \tparam F \deduced The function pointer type.
+ * \param [in] function The function pointer.
+ * \returns The address of the function.
+ */
+template <typename F>
+const void * EventFunctionImplGetFunction (F function)
+{
+  return reinterpret_cast<const void *> (function);
+}
+
 template <typename MEM, typename OBJ>
 EventImpl * MakeEvent (MEM mem_ptr, OBJ obj)
 {
@@ -318,6 +360,10 @@ public:
     {
     }
 private:
+    virtual const void * GetFunction (void) const
+    {
+      return EventMemberImplGetFunction (m_function, m_obj);
+    }
     virtual void Notify (void)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)();
@@ -348,6 +394,10 @@ protected:
     {
     }
 private:
+    virtual const void * GetFunction (void) const
+    {
+      return EventMemberImplGetFunction (m_function, m_obj);
+    }
     virtual void Notify (void)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1);
@@ -379,6 +429,10 @@ protected:
     {
     }
 private:
+    virtual const void * GetFunction (void) const
+    {
+      return EventMemberImplGetFunction (m_function, m_obj);
+    }
     virtual void Notify (void)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2);
@@ -412,6 +466,10 @@ protected:
     {
     }
 private:
+    virtual const void * GetFunction (void) const
+    {
+      return EventMemberImplGetFunction (m_function, m_obj);
+    }
     virtual void Notify (void)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3);
@@ -447,6 +505,10 @@ protected:
     {
     }
 private:
+    virtual const void * GetFunction (void) const
+    {
+      return EventMemberImplGetFunction (m_function, m_obj);
+    }
     virtual void Notify (void)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4);
@@ -485,6 +547,10 @@ protected:
     {
     }
 private:
+    virtual const void * GetFunction (void) const
+    {
+      return EventMemberImplGetFunction (m_function, m_obj);
+    }
     virtual void Notify (void)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5);
@@ -519,6 +585,10 @@ protected:
     {
     }
 private:
+    virtual const void * GetFunction (void) const
+    {
+      return EventFunctionImplGetFunction (m_function);
+    }
     virtual void Notify (void)
     {
       (*m_function)(m_a1);
@@ -549,6 +619,10 @@ protected:
     {
     }
 private:
+    virtual const void * GetFunction (void) const
+    {
+      return EventFunctionImplGetFunction (m_function);
+    }
     virtual void Notify (void)
     {
       (*m_function)(m_a1, m_a2);
@@ -582,6 +656,10 @@ protected:
     {
     }
 private:
+    virtual const void * GetFunction (void) const
+    {
+      return EventFunctionImplGetFunction (m_function);
+    }
     virtual void Notify (void)
     {
       (*m_function)(m_a1, m_a2, m_a3);
@@ -617,6 +695,10 @@ protected:
     {
     }
 private:
+    virtual const void * GetFunction (void) const
+    {
+      return EventFunctionImplGetFunction (m_function);
+    }
     virtual void Notify (void)
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4);
@@ -654,6 +736,10 @@ protected:
     {
     }
 private:
+    virtual const void * GetFunction (void) const
+    {
+      return EventFunctionImplGetFunction (m_function);
+    }
     virtual void Notify (void)
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5);
@@ -0,0 +1,888 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/core-config.h"
+#include "simulator.h"
+#include "multithreaded-simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+
+#include "ptr.h"
+#include "pointer.h"
+#include "uinteger.h"
+#include "assert.h"
+#include "fatal-error.h"
+#include "log.h"
+
+#include <algorithm>
+#include <sched.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * Implementation of class ns3::MultithreadedSimulatorImpl.
+ */
+
+namespace ns3 {
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+namespace {
+
+/**
+ * \ingroup simulator
+ * The MultithreadedSimulatorImpl::Partition processed by the calling
+ * thread, or 0 when the calling thread is not running a partition.
+ * (Stored as void * because the type is private to the simulator.)
+ */
+__thread void *g_currentPartition = 0;
+
+/**
+ * \ingroup simulator
+ * Number of spins on the barrier before yielding the processor.
+ */
+const uint32_t BARRIER_SPIN_COUNT = 4096;
+
+} // unnamed namespace
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Core")
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("ThreadCount",
+                   "The number of partitions, each processed by its own thread. "
+                   "Must be set before the simulator is created.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_threadCount),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Lookahead",
+                   "The smallest delay with which an event can be scheduled "
+                   "for a context processed by another partition.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&MultithreadedSimulatorImpl::SetLookahead,
+                                     &MultithreadedSimulatorImpl::GetLookahead),
+                   MakeTimeChecker (Seconds (0)))
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+  : m_threadCount (1),
+    m_lookahead (0),
+    m_windowEnd (0),
+    m_done (false),
+    m_stop (false),
+    m_runningShared (false),
+    m_currentTs (0),
+    m_windowCount (0),
+    m_barrierCount (0),
+    m_barrierGeneration (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_main = SystemThread::Self ();
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (ForeignEvents::iterator i = m_foreignEvents.begin (); i != m_foreignEvents.end (); ++i)
+    {
+      i->event->Unref ();
+    }
+  m_foreignEvents.clear ();
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      Partition *partition = *i;
+      while (!partition->events->IsEmpty ())
+        {
+          Scheduler::Event next = partition->events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      for (std::vector<PendingEvent>::iterator j = partition->outbox.begin ();
+           j != partition->outbox.end (); ++j)
+        {
+          j->event->Unref ();
+        }
+      for (std::vector<PendingEvent>::iterator j = partition->shared.begin ();
+           j != partition->shared.end (); ++j)
+        {
+          j->event->Unref ();
+        }
+      partition->events = 0;
+      delete partition;
+    }
+  m_partitions.clear ();
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::CreatePartitions (void)
+{
+  NS_LOG_FUNCTION (this << m_threadCount);
+  NS_ASSERT (m_partitions.empty ());
+  for (uint32_t i = 0; i < m_threadCount; ++i)
+    {
+      Partition *partition = new Partition ();
+      partition->impl = this;
+      partition->index = i;
+      // uids are allocated from 4.
+      // uid 0 is "invalid" events
+      // uid 1 is "now" events
+      // uid 2 is "destroy" events
+      partition->uid = 4;
+      partition->currentUid = 0;
+      partition->currentTs = 0;
+      partition->currentContext = 0xffffffff;
+      partition->stopped = false;
+      partition->eventCount = 0;
+      m_partitions.push_back (partition);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  m_schedulerFactory = schedulerFactory;
+  if (m_partitions.empty ())
+    {
+      CreatePartitions ();
+    }
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      Partition *partition = *i;
+      Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+      if (partition->events != 0)
+        {
+          while (!partition->events->IsEmpty ())
+            {
+              Scheduler::Event next = partition->events->RemoveNext ();
+              scheduler->Insert (next);
+            }
+        }
+      partition->events = scheduler;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetLookahead (Time lookahead)
+{
+  NS_LOG_FUNCTION (this << lookahead);
+  NS_ASSERT (!lookahead.IsStrictlyNegative ());
+  m_lookahead = lookahead.GetTimeStep ();
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead (void) const
+{
+  return TimeStep (m_lookahead);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartitionCount (void) const
+{
+  return m_partitions.size ();
+}
+
+void
+MultithreadedSimulatorImpl::SetPartition (uint32_t context, uint32_t partition)
+{
+  NS_LOG_FUNCTION (this << context << partition);
+  NS_ASSERT_MSG (partition < m_partitions.size (), "Partition " << partition << " does not exist");
+  NS_ASSERT_MSG (context != 0xffffffff, "Events without context always run in partition 0");
+  m_partitionOf[context] = partition;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartition (uint32_t context) const
+{
+  if (context == 0xffffffff)
+    {
+      return 0;
+    }
+  std::map<uint32_t, uint32_t>::const_iterator i = m_partitionOf.find (context);
+  if (i != m_partitionOf.end ())
+    {
+      return i->second;
+    }
+  return context % m_partitions.size ();
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::GetCurrentPartition (void) const
+{
+  return static_cast<Partition *> (g_currentPartition);
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::GetEventPartition (const EventId &id) const
+{
+  return m_partitions[GetPartition (id.GetContext ())];
+}
+
+uint64_t
+MultithreadedSimulatorImpl::LoadClock (const Partition *partition, uint32_t *uid)
+{
+  // ProcessWindow stores the uid before the timestamp: if the timestamp
+  // read is that of an event, the uid read is that of this event or of
+  // a later one, which is only possible once all the events with this
+  // timestamp have run.
+  uint64_t ts = __atomic_load_n (&partition->currentTs, __ATOMIC_ACQUIRE);
+  *uid = __atomic_load_n (&partition->currentUid, __ATOMIC_RELAXED);
+  return ts;
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+bool
+MultithreadedSimulatorImpl::PendingEventLess (const PendingEvent &a, const PendingEvent &b)
+{
+  if (a.ts != b.ts)
+    {
+      return a.ts < b.ts;
+    }
+  if (a.senderTs != b.senderTs)
+    {
+      return a.senderTs < b.senderTs;
+    }
+  if (a.sender != b.sender)
+    {
+      return a.sender < b.sender;
+    }
+  return a.senderSeq < b.senderSeq;
+}
+
+Scheduler::EventKey
+MultithreadedSimulatorImpl::Insert (Partition *partition, uint64_t ts,
+                                    uint32_t context, EventImpl *event)
+{
+  NS_ASSERT (ts >= partition->currentTs);
+  NS_ASSERT_MSG (!m_runningShared || ts + 1 >= m_windowEnd,
+                 "Event scheduled by a shared event within the lookahead");
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = ts;
+  ev.key.m_context = context;
+  ev.key.m_uid = partition->uid;
+  partition->uid++;
+  partition->events->Insert (ev);
+  return ev.key;
+}
+
+void
+MultithreadedSimulatorImpl::Post (Partition *partition, uint32_t destination, uint64_t ts,
+                                  uint32_t context, EventImpl *event)
+{
+  PendingEvent ev;
+  ev.ts = ts;
+  ev.senderTs = partition->currentTs;
+  ev.sender = partition->currentContext;
+  ev.senderSeq = partition->sequences[partition->currentContext]++;
+  ev.context = context;
+  ev.partition = destination;
+  ev.event = event;
+  partition->outbox.push_back (ev);
+}
+
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep () << event);
+  Partition *partition = GetCurrentPartition ();
+  uint64_t now;
+  uint32_t context;
+  if (partition == 0)
+    {
+      NS_ASSERT_MSG (SystemThread::Equals (m_main), "Simulator::Schedule Thread-unsafe invocation!");
+      now = m_currentTs;
+      context = 0xffffffff;
+      partition = m_partitions[0];
+    }
+  else
+    {
+      now = partition->currentTs;
+      context = partition->currentContext;
+    }
+  Time tAbsolute = delay + TimeStep (now);
+  NS_ASSERT (tAbsolute.IsPositive ());
+  NS_ASSERT (tAbsolute >= TimeStep (now));
+  Scheduler::EventKey key = Insert (partition, tAbsolute.GetTimeStep (), context, event);
+  return EventId (event, key.m_ts, key.m_context, key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+  Partition *partition = GetCurrentPartition ();
+  uint32_t destination = GetPartition (context);
+  if (partition == 0)
+    {
+      if (SystemThread::Equals (m_main))
+        {
+          Insert (m_partitions[destination], m_currentTs + delay.GetTimeStep (), context, event);
+        }
+      else
+        {
+          PendingEvent ev;
+          // Current time added in PrepareWindow()
+          ev.ts = delay.GetTimeStep ();
+          ev.senderTs = 0;
+          ev.sender = 0xffffffff;
+          ev.senderSeq = 0;
+          ev.context = context;
+          ev.partition = destination;
+          ev.event = event;
+          CriticalSection cs (m_foreignEventsMutex);
+          m_foreignEvents.push_back (ev);
+        }
+      return;
+    }
+
+  uint64_t ts = partition->currentTs + delay.GetTimeStep ();
+  if (context == partition->currentContext)
+    {
+      Insert (partition, ts, context, event);
+    }
+  else if ((uint64_t) delay.GetTimeStep () >= m_lookahead)
+    {
+      // Also for the contexts of this partition, so that the order of
+      // the events does not depend on the partitioning.
+      Post (partition, destination, ts, context, event);
+    }
+  else if (destination == partition->index)
+    {
+      Insert (partition, ts, context, event);
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Event scheduled from context " << partition->currentContext <<
+                      " to context " << context << " with a delay of " << delay <<
+                      ", smaller than the lookahead " << TimeStep (m_lookahead));
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleShared (EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << event);
+  Partition *partition = GetCurrentPartition ();
+  if (partition == 0 || m_runningShared)
+    {
+      event->Invoke ();
+      event->Unref ();
+      return;
+    }
+  PendingEvent ev;
+  ev.ts = partition->currentTs;
+  ev.senderTs = partition->currentTs;
+  ev.sender = partition->currentContext;
+  ev.senderSeq = partition->sequences[partition->currentContext]++;
+  ev.context = partition->currentContext;
+  ev.partition = partition->index;
+  ev.event = event;
+  partition->shared.push_back (ev);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  return Schedule (TimeStep (0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  Partition *partition = GetCurrentPartition ();
+  uint64_t now = partition != 0 ? partition->currentTs : m_currentTs;
+  EventId id (Ptr<EventImpl> (event, false), now, 0xffffffff, 2);
+  CriticalSection cs (m_mutex);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+void
+MultithreadedSimulatorImpl::StopEvent::Notify (void)
+{
+  static_cast<Partition *> (g_currentPartition)->stopped = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  Partition *partition = GetCurrentPartition ();
+  if (partition != 0)
+    {
+      partition->stopped = true;
+    }
+  CriticalSection cs (m_mutex);
+  m_stop = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  Partition *partition = GetCurrentPartition ();
+  if (partition == 0)
+    {
+      NS_ASSERT_MSG (SystemThread::Equals (m_main), "Simulator::Stop Thread-unsafe invocation!");
+      uint64_t ts = m_currentTs + delay.GetTimeStep ();
+      for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+        {
+          Insert (*i, ts, 0xffffffff, new StopEvent ());
+        }
+      return;
+    }
+  if ((uint64_t) delay.GetTimeStep () < m_lookahead && m_partitions.size () > 1)
+    {
+      NS_LOG_WARN ("Stop delay " << delay << " smaller than the lookahead: "
+                   "stopping at the end of the window");
+      Stop ();
+      return;
+    }
+  uint64_t ts = partition->currentTs + delay.GetTimeStep ();
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      if (*i == partition)
+        {
+          Insert (partition, ts, 0xffffffff, new StopEvent ());
+        }
+      else
+        {
+          Post (partition, (*i)->index, ts, 0xffffffff, new StopEvent ());
+        }
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  if (m_stop)
+    {
+      return true;
+    }
+  for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      if (!(*i)->events->IsEmpty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+MultithreadedSimulatorImpl::Barrier (void)
+{
+  uint32_t n = m_partitions.size ();
+  if (n == 1)
+    {
+      return;
+    }
+  volatile uint64_t *generation = &m_barrierGeneration;
+  uint64_t current = *generation;
+  if (__sync_add_and_fetch (&m_barrierCount, 1) == n)
+    {
+      m_barrierCount = 0;
+      __sync_synchronize ();
+      *generation = current + 1;
+      return;
+    }
+  uint32_t spins = 0;
+  while (*generation == current)
+    {
+      if (++spins > BARRIER_SPIN_COUNT)
+        {
+          sched_yield ();
+        }
+    }
+  __sync_synchronize ();
+}
+
+void
+MultithreadedSimulatorImpl::RunShared (void)
+{
+  std::vector<PendingEvent> shared;
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      shared.insert (shared.end (), (*i)->shared.begin (), (*i)->shared.end ());
+      (*i)->shared.clear ();
+    }
+  if (shared.empty ())
+    {
+      return;
+    }
+  std::sort (shared.begin (), shared.end (), &MultithreadedSimulatorImpl::PendingEventLess);
+  void *current = g_currentPartition;
+  m_runningShared = true;
+  for (std::vector<PendingEvent>::iterator i = shared.begin (); i != shared.end (); ++i)
+    {
+      // run the event as if from the event which scheduled it
+      Partition *partition = m_partitions[i->partition];
+      uint64_t ts = partition->currentTs;
+      uint32_t context = partition->currentContext;
+      partition->currentTs = i->ts;
+      partition->currentContext = i->context;
+      g_currentPartition = partition;
+      i->event->Invoke ();
+      i->event->Unref ();
+      partition->currentTs = ts;
+      partition->currentContext = context;
+    }
+  m_runningShared = false;
+  g_currentPartition = current;
+}
+
+bool
+MultithreadedSimulatorImpl::PrepareWindow (void)
+{
+  RunShared ();
+
+  uint64_t now = 0;
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      now = std::max (now, (*i)->currentTs);
+    }
+
+  // Events scheduled by foreign threads: timestamped on arrival, like in
+  // the DefaultSimulatorImpl.
+  {
+    CriticalSection cs (m_foreignEventsMutex);
+    while (!m_foreignEvents.empty ())
+      {
+        PendingEvent ev = m_foreignEvents.front ();
+        m_foreignEvents.pop_front ();
+        Partition *partition = m_partitions[ev.partition];
+        Insert (partition, std::max (now, partition->currentTs) + ev.ts, ev.context, ev.event);
+      }
+  }
+
+  // Events scheduled for other contexts during the last window.
+  std::vector<PendingEvent> pending;
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      pending.insert (pending.end (), (*i)->outbox.begin (), (*i)->outbox.end ());
+      (*i)->outbox.clear ();
+    }
+  std::sort (pending.begin (), pending.end (), &MultithreadedSimulatorImpl::PendingEventLess);
+  for (std::vector<PendingEvent>::iterator i = pending.begin (); i != pending.end (); ++i)
+    {
+      Insert (m_partitions[i->partition], i->ts, i->context, i->event);
+    }
+
+  if (m_stop)
+    {
+      return false;
+    }
+
+  bool found = false;
+  uint64_t windowStart = 0;
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      Partition *partition = *i;
+      if (partition->stopped || partition->events->IsEmpty ())
+        {
+          continue;
+        }
+      uint64_t ts = partition->events->PeekNext ().key.m_ts;
+      if (!found || ts < windowStart)
+        {
+          windowStart = ts;
+          found = true;
+        }
+    }
+  if (!found)
+    {
+      return false;
+    }
+  uint64_t width = std::max (m_lookahead, (uint64_t) 1);
+  m_windowEnd = windowStart + width;
+  if (m_windowEnd < windowStart)
+    {
+      m_windowEnd = ~(uint64_t) 0;
+    }
+  m_windowCount++;
+  return true;
+}
+
+void
+MultithreadedSimulatorImpl::ProcessWindow (Partition *partition)
+{
+#ifndef NS3_MTP
+  // the reference counts and the packet buffers are not thread safe:
+  // the threads process their windows in turn
+  bool serial = m_partitions.size () > 1;
+  if (serial)
+    {
+      m_serialMutex.Lock ();
+    }
+#endif /* NS3_MTP */
+  while (!partition->stopped && !partition->events->IsEmpty ())
+    {
+      if (partition->events->PeekNext ().key.m_ts >= m_windowEnd)
+        {
+          break;
+        }
+      Scheduler::Event next = partition->events->RemoveNext ();
+
+      NS_ASSERT (next.key.m_ts >= partition->currentTs);
+      partition->currentTs = next.key.m_ts;
+      partition->currentContext = next.key.m_context;
+      // other partitions read the clock with LoadClock
+      __atomic_store_n (&partition->currentUid, next.key.m_uid, __ATOMIC_RELAXED);
+      __atomic_store_n (&partition->currentTs, next.key.m_ts, __ATOMIC_RELEASE);
+      next.impl->Invoke ();
+      next.impl->Unref ();
+      partition->eventCount++;
+    }
+#ifndef NS3_MTP
+  if (serial)
+    {
+      m_serialMutex.Unlock ();
+    }
+#endif /* NS3_MTP */
+}
+
+void
+MultithreadedSimulatorImpl::Partition::RunWorker (void)
+{
+  g_currentPartition = this;
+  while (true)
+    {
+      impl->Barrier ();
+      if (impl->m_done)
+        {
+          break;
+        }
+      impl->ProcessWindow (this);
+      impl->Barrier ();
+    }
+  g_currentPartition = 0;
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  // Set the current threadId as the main threadId
+  m_main = SystemThread::Self ();
+  m_stop = false;
+  m_done = false;
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      (*i)->stopped = false;
+    }
+
+  for (uint32_t i = 1; i < m_partitions.size (); ++i)
+    {
+      Ptr<SystemThread> thread = Create<SystemThread> (MakeCallback (&Partition::RunWorker, m_partitions[i]));
+      m_threads.push_back (thread);
+      thread->Start ();
+    }
+
+  g_currentPartition = m_partitions[0];
+  while (true)
+    {
+      m_done = !PrepareWindow ();
+      Barrier ();
+      if (m_done)
+        {
+          break;
+        }
+      ProcessWindow (m_partitions[0]);
+      Barrier ();
+    }
+  g_currentPartition = 0;
+
+  for (std::vector<Ptr<SystemThread> >::iterator i = m_threads.begin (); i != m_threads.end (); ++i)
+    {
+      (*i)->Join ();
+    }
+  m_threads.clear ();
+
+  uint64_t events = 0;
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      m_currentTs = std::max (m_currentTs, (*i)->currentTs);
+      events += (*i)->eventCount;
+    }
+  NS_LOG_LOGIC ("processed " << events << " events in " << m_windowCount << " windows");
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  Partition *partition = GetCurrentPartition ();
+  if (partition != 0)
+    {
+      return TimeStep (partition->currentTs);
+    }
+  return TimeStep (m_currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      uint32_t uid;
+      return TimeStep (id.GetTs () - LoadClock (GetEventPartition (id), &uid));
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      CriticalSection cs (m_mutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Partition *partition = GetEventPartition (id);
+  NS_ASSERT_MSG (GetCurrentPartition () == 0 || GetCurrentPartition () == partition,
+                 "Simulator::Remove of an event of another partition");
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  partition->events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0 ||
+          id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      CriticalSection cs (m_mutex);
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  if (id.PeekEventImpl () == 0)
+    {
+      return true;
+    }
+  uint32_t uid;
+  uint64_t ts = LoadClock (GetEventPartition (id), &uid);
+  if (id.GetTs () < ts ||
+      (id.GetTs () == ts && id.GetUid () <= uid) ||
+      id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  Partition *partition = GetCurrentPartition ();
+  if (partition != 0)
+    {
+      return partition->currentContext;
+    }
+  return 0xffffffff;
+}
+
+} // namespace ns3
@@ -721,6 +721,115 @@ SearchAttributesOfParentObjectsTestCase::DoRun (void)
 
 }
 
+// ===========================================================================
+// Test for the compiled paths, which must match the same objects as the
+// paths of Config::LookupMatches, in the same order and with the same
+// contexts.
+// ===========================================================================
+class CompiledPathConfigTestCase : public TestCase
+{
+public:
+  CompiledPathConfigTestCase ();
+  virtual ~CompiledPathConfigTestCase () {}
+
+  void TraceWithPath (std::string path, int16_t old, int16_t newValue) { m_newValue = newValue; m_path = path; }
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check that a compiled path matches the objects of Config::LookupMatches.
+   * \param path The path.
+   */
+  void CheckMatches (std::string path);
+
+  int16_t m_newValue;
+  std::string m_path;
+};
+
+CompiledPathConfigTestCase::CompiledPathConfigTestCase ()
+  : TestCase ("Check that compiled paths match the same objects as Config::LookupMatches")
+{
+}
+
+void
+CompiledPathConfigTestCase::CheckMatches (std::string path)
+{
+  std::string::size_type slash = path.find_last_of ("/");
+  Config::MatchContainer expected = Config::LookupMatches (path.substr (0, slash));
+  Config::CompiledPath compiled (path);
+  Config::MatchContainer matches = compiled.LookupMatches ();
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), expected.GetN (), "Wrong number of matches for " << path);
+  for (uint32_t i = 0; i < matches.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (matches.Get (i), expected.Get (i), "Wrong match " << i << " for " << path);
+      NS_TEST_EXPECT_MSG_EQ (matches.GetMatchedPath (i), expected.GetMatchedPath (i), "Wrong context " << i << " for " << path);
+    }
+  // the caches of the second resolution
+  NS_TEST_EXPECT_MSG_EQ (compiled.LookupMatches ().GetN (), expected.GetN (), "Wrong number of cached matches for " << path);
+}
+
+void
+CompiledPathConfigTestCase::DoRun (void)
+{
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  Ptr<ConfigTestObject> a = CreateObject<ConfigTestObject> ();
+  root->SetNodeA (a);
+  std::vector<Ptr<ConfigTestObject> > objects;
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      Ptr<ConfigTestObject> obj = CreateObject<ConfigTestObject> ();
+      a->AddNodeA (obj);
+      objects.push_back (obj);
+      for (uint32_t j = 0; j < i; j++)
+        {
+          obj->AddNodeB (CreateObject<ConfigTestObject> ());
+        }
+      if (i % 2 == 0)
+        {
+          obj->SetNodeB (CreateObject<DerivedConfigTestObject> ());
+        }
+    }
+  Names::Add ("CompiledPathObject", objects[3]);
+
+  CheckMatches ("/NodeA/A");
+  CheckMatches ("/NodeA/NodesA/*/A");
+  CheckMatches ("/NodeA/NodesA/3/A");
+  CheckMatches ("/NodeA/NodesA/7/A");
+  CheckMatches ("/NodeA/NodesA/[1-3]|0/NodesB/*/A");
+  CheckMatches ("/NodeA/NodesA/4|[0-1]/NodesB/1/A");
+  CheckMatches ("/NodeA/NodesA/*/NodeB/A");
+  CheckMatches ("/NodeA/NodesA/*/NodeB/$DerivedConfigTestObject/A");
+  CheckMatches ("/NodeA/*/*/A");
+  CheckMatches ("/Names/CompiledPathObject/NodesB/*/A");
+  CheckMatches ("/NodeA/NodesA/2/Unknown/A");
+
+  Config::CompiledPath compiled ("/NodeA/NodesA/[0-1]|3/Source");
+  NS_TEST_EXPECT_MSG_EQ (compiled.GetPath (), "/NodeA/NodesA/[0-1]|3/Source", "Wrong path");
+  compiled.Connect (MakeCallback (&CompiledPathConfigTestCase::TraceWithPath, this));
+  m_newValue = 0;
+  m_path = "";
+  objects[3]->SetAttribute ("Source", IntegerValue (-3));
+  NS_TEST_EXPECT_MSG_EQ (m_newValue, -3, "Trace 3 did not fire as expected");
+  NS_TEST_EXPECT_MSG_EQ (m_path, "/NodeA/NodesA/3/Source", "Trace 3 did not provide expected context");
+  m_newValue = 0;
+  objects[2]->SetAttribute ("Source", IntegerValue (-2));
+  NS_TEST_EXPECT_MSG_EQ (m_newValue, 0, "Trace 2 fired unexpectedly");
+  Config::CompiledPath copy = compiled;
+  copy.Disconnect (MakeCallback (&CompiledPathConfigTestCase::TraceWithPath, this));
+  objects[3]->SetAttribute ("Source", IntegerValue (-4));
+  NS_TEST_EXPECT_MSG_EQ (m_newValue, 0, "Trace 3 fired after the disconnection");
+
+  Config::CompiledPath ("/NodeA/NodesA/*/A").Set (IntegerValue (3));
+  for (uint32_t i = 0; i < objects.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (objects[i]->GetA (), 3, "Attribute A of object " << i << " not set");
+    }
+
+  Names::Clear ();
+  Config::UnregisterRootNamespaceObject (root);
+}
+
 // ===========================================================================
 // The Test Suite that glues all of the Test Cases together.
 // ===========================================================================
@@ -737,6 +846,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase, TestCase::QUICK);
   AddTestCase (new ObjectVectorConfigTestCase, TestCase::QUICK);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase, TestCase::QUICK);
+  AddTestCase (new CompiledPathConfigTestCase, TestCase::QUICK);
 }
 
 static ConfigTestSuite configTestSuite;
@@ -0,0 +1,237 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/event-profiler.h"
+#include "ns3/make-event.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/nstime.h"
+#include "ns3/core-config.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * A base class with a virtual method, to check that the profiler
+ * attributes the time to the overriding method.
+ */
+class EventProfilerModel
+{
+public:
+  virtual ~EventProfilerModel ()
+  {
+  }
+  virtual void Work (uint32_t n);
+  void Other (void);
+  uint32_t m_sum;
+};
+
+void
+EventProfilerModel::Work (uint32_t n)
+{
+  m_sum += n;
+}
+
+void
+EventProfilerModel::Other (void)
+{
+  m_sum++;
+}
+
+class EventProfilerDerivedModel : public EventProfilerModel
+{
+public:
+  virtual void Work (uint32_t n);
+};
+
+void
+EventProfilerDerivedModel::Work (uint32_t n)
+{
+  m_sum += 2 * n;
+}
+
+/**
+ * Invoke events through an EventProfiler and check the statistics.
+ */
+class EventProfilerStatsTestCase : public TestCase
+{
+public:
+  EventProfilerStatsTestCase ();
+  virtual void DoRun (void);
+};
+
+EventProfilerStatsTestCase::EventProfilerStatsTestCase ()
+  : TestCase ("Check the event profiler statistics")
+{
+}
+
+void
+EventProfilerStatsTestCase::DoRun (void)
+{
+  EventProfilerDerivedModel model;
+  model.m_sum = 0;
+  EventProfilerModel *base = &model;
+  EventProfiler profiler;
+
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      EventImpl *ev = MakeEvent (&EventProfilerModel::Work, base, i);
+      profiler.Invoke (ev, i % 2);
+      ev->Unref ();
+    }
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      EventImpl *ev = MakeEvent (&EventProfilerModel::Other, base);
+      profiler.Invoke (ev, 7);
+      ev->Unref ();
+    }
+  EventImpl *cancelled = MakeEvent (&EventProfilerModel::Other, base);
+  cancelled->Cancel ();
+  profiler.Invoke (cancelled, 7);
+  cancelled->Unref ();
+
+  NS_TEST_EXPECT_MSG_EQ (model.m_sum, 2 * 45 + 3, "Events were not invoked correctly");
+  NS_TEST_EXPECT_MSG_EQ (profiler.GetEventCount (), 13, "Wrong event count");
+
+  std::map<std::string, EventProfiler::Stats> functions = profiler.GetFunctionStats ();
+  NS_TEST_ASSERT_MSG_EQ (functions.size (), 2, "Wrong number of functions");
+  uint64_t total = 0;
+  uint64_t maximum = 0;
+  for (std::map<std::string, EventProfiler::Stats>::const_iterator i = functions.begin ();
+       i != functions.end (); i++)
+    {
+      uint64_t binned = 0;
+      for (uint32_t j = 0; j < EventProfiler::HISTOGRAM_BINS; j++)
+        {
+          binned += i->second.histogram[j];
+        }
+      NS_TEST_EXPECT_MSG_EQ (binned, i->second.count, "Histogram of " << i->first << " is incomplete");
+      total += i->second.total;
+      maximum = std::max (maximum, i->second.max);
+    }
+  NS_TEST_EXPECT_MSG_EQ (total, profiler.GetTotalTime (), "Function times do not add up");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (maximum, total, "Maximum larger than the total");
+
+#if defined (__GNUC__) && !defined (__clang__) && defined (HAVE_DLFCN_H)
+  // the virtual method is resolved on the object
+  NS_TEST_EXPECT_MSG_EQ (functions.count ("EventProfilerDerivedModel::Work(unsigned int)"), 1,
+                         "Virtual method not resolved");
+  NS_TEST_EXPECT_MSG_EQ (functions["EventProfilerDerivedModel::Work(unsigned int)"].count, 10,
+                         "Wrong count of the virtual method");
+  NS_TEST_EXPECT_MSG_EQ (functions["EventProfilerModel::Other()"].count, 3,
+                         "Wrong count of the non virtual method");
+#endif
+
+  std::ostringstream text;
+  profiler.Print (text);
+  NS_TEST_EXPECT_MSG_NE (text.str ().find ("Event profile: 13 events"), std::string::npos,
+                         "Wrong report header");
+  std::ostringstream json;
+  profiler.PrintJson (json);
+  NS_TEST_EXPECT_MSG_NE (json.str ().find ("\"events\": 13,"), std::string::npos,
+                         "Wrong JSON event count");
+  NS_TEST_EXPECT_MSG_NE (json.str ().find ("{\"context\": 7, \"count\": 3,"), std::string::npos,
+                         "Wrong JSON context statistics");
+
+  profiler.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (profiler.GetEventCount (), 0, "Statistics not cleared");
+  NS_TEST_EXPECT_MSG_EQ (profiler.GetFunctionStats ().size (), 0, "Functions not cleared");
+}
+
+/**
+ * Run a simulation with the EventProfiling attribute set, and check
+ * the reports.
+ */
+class EventProfilerSimulatorTestCase : public TestCase
+{
+public:
+  EventProfilerSimulatorTestCase ();
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  void Tick (uint32_t n);
+};
+
+EventProfilerSimulatorTestCase::EventProfilerSimulatorTestCase ()
+  : TestCase ("Check the event profile written by the default simulator")
+{
+}
+
+void
+EventProfilerSimulatorTestCase::Tick (uint32_t n)
+{
+  if (n > 0)
+    {
+      Simulator::ScheduleWithContext (n % 4, MicroSeconds (1),
+                                      &EventProfilerSimulatorTestCase::Tick, this, n - 1);
+    }
+}
+
+void
+EventProfilerSimulatorTestCase::DoRun (void)
+{
+  std::string prefix = CreateTempDirFilename ("event-profile");
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::EventProfiling", BooleanValue (true));
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::EventProfileFile", StringValue (prefix));
+  Simulator::Destroy ();
+
+  Simulator::Schedule (Seconds (0), &EventProfilerSimulatorTestCase::Tick, this, 20);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::ifstream txt ((prefix + ".txt").c_str ());
+  NS_TEST_ASSERT_MSG_EQ (txt.is_open (), true, "Text report not written");
+  std::ostringstream text;
+  text << txt.rdbuf ();
+  NS_TEST_EXPECT_MSG_NE (text.str ().find ("Event profile: 21 events"), std::string::npos,
+                         "Wrong event count in the text report");
+  NS_TEST_EXPECT_MSG_NE (text.str ().find ("EventProfilerSimulatorTestCase"), std::string::npos,
+                         "Scheduled function missing from the text report");
+
+  std::ifstream js ((prefix + ".json").c_str ());
+  NS_TEST_ASSERT_MSG_EQ (js.is_open (), true, "JSON report not written");
+  std::ostringstream json;
+  json << js.rdbuf ();
+  NS_TEST_EXPECT_MSG_NE (json.str ().find ("{\"context\": null, \"count\": 1,"), std::string::npos,
+                         "Missing the event without context");
+  NS_TEST_EXPECT_MSG_NE (json.str ().find ("{\"context\": 0, \"count\": 5,"), std::string::npos,
+                         "Wrong count of context 0");
+}
+
+void
+EventProfilerSimulatorTestCase::DoTeardown (void)
+{
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::EventProfiling", BooleanValue (false));
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::EventProfileFile", StringValue ("event-profile"));
+}
+
+class EventProfilerTestSuite : public TestSuite
+{
+public:
+  EventProfilerTestSuite ()
+    : TestSuite ("event-profiler", UNIT)
+  {
+    AddTestCase (new EventProfilerStatsTestCase (), TestCase::QUICK);
+    AddTestCase (new EventProfilerSimulatorTestCase (), TestCase::QUICK);
+  }
+};
+
+static EventProfilerTestSuite g_eventProfilerTestSuite;
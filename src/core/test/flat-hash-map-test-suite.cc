@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <map>
+
+#include "ns3/test.h"
+#include "ns3/flat-hash-map.h"
+
+using namespace ns3;
+
+/**
+ * A hash which puts all the keys in a few slots, to check the probe
+ * sequences which wrap around and the erasure in long sequences.
+ */
+struct CollidingHash
+{
+  /**
+   * \param key a key
+   * \returns the hash of the key
+   */
+  uint32_t operator () (uint32_t key) const
+  {
+    return 0xfffffff0U + key % 4;
+  }
+};
+
+/**
+ * Compare a FlatHashMap with a std::map under random insertions and
+ * erasures.
+ */
+template <typename Hash>
+class FlatHashMapTestCase : public TestCase
+{
+public:
+  /**
+   * \param name the name of the test case
+   * \param keyRange the keys are in [0, keyRange)
+   */
+  FlatHashMapTestCase (std::string name, uint32_t keyRange);
+private:
+  virtual void DoRun (void);
+  uint32_t m_keyRange; //!< The keys are in [0, m_keyRange)
+};
+
+template <typename Hash>
+FlatHashMapTestCase<Hash>::FlatHashMapTestCase (std::string name, uint32_t keyRange)
+  : TestCase (name),
+    m_keyRange (keyRange)
+{
+}
+
+template <typename Hash>
+void
+FlatHashMapTestCase<Hash>::DoRun (void)
+{
+  FlatHashMap<uint32_t, uint32_t, Hash> table;
+  std::map<uint32_t, uint32_t> reference;
+  uint32_t random = 12345;
+  for (uint32_t i = 0; i < 20000; i++)
+    {
+      random = random * 1103515245 + 12345;
+      uint32_t key = (random >> 8) % m_keyRange;
+      if ((random >> 4) % 3 == 0)
+        {
+          bool erased = table.Erase (key);
+          NS_TEST_ASSERT_MSG_EQ (erased, (reference.erase (key) == 1), "Wrong erasure of " << key);
+        }
+      else
+        {
+          bool inserted;
+          uint32_t &value = table.Insert (key, i, inserted);
+          NS_TEST_ASSERT_MSG_EQ (inserted, (reference.find (key) == reference.end ()), "Wrong insertion of " << key);
+          if (inserted)
+            {
+              reference[key] = i;
+            }
+          NS_TEST_ASSERT_MSG_EQ (value, reference[key], "Wrong value of " << key);
+        }
+      NS_TEST_ASSERT_MSG_EQ (table.GetSize (), reference.size (), "Wrong size");
+    }
+
+  for (uint32_t key = 0; key < m_keyRange; key++)
+    {
+      uint32_t const *value = table.Find (key);
+      std::map<uint32_t, uint32_t>::const_iterator i = reference.find (key);
+      NS_TEST_ASSERT_MSG_EQ ((value != 0), (i != reference.end ()), "Wrong lookup of " << key);
+      if (value != 0)
+        {
+          NS_TEST_EXPECT_MSG_EQ (*value, i->second, "Wrong value of " << key);
+        }
+    }
+
+  uint32_t count = 0;
+  for (typename FlatHashMap<uint32_t, uint32_t, Hash>::Iterator i = table.Begin (); i != table.End (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (i->second, reference[i->first], "Wrong entry " << i->first);
+      count++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (count, reference.size (), "Wrong number of entries");
+
+  table[7] = 1;
+  table.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (table.IsEmpty (), true, "Entries left after Clear");
+  NS_TEST_EXPECT_MSG_EQ ((table.Find (7) == 0), true, "Key found after Clear");
+  NS_TEST_EXPECT_MSG_EQ ((table.Begin () == table.End ()), true, "Iteration after Clear");
+}
+
+class FlatHashMapTestSuite : public TestSuite
+{
+public:
+  FlatHashMapTestSuite ()
+    : TestSuite ("flat-hash-map", UNIT)
+  {
+    AddTestCase (new FlatHashMapTestCase<FlatHashMapHash<uint32_t> > ("Check a table with spread keys", 5000), TestCase::QUICK);
+    AddTestCase (new FlatHashMapTestCase<CollidingHash> ("Check a table with colliding keys", 200), TestCase::QUICK);
+  }
+};
+
+static FlatHashMapTestSuite g_flatHashMapTestSuite;
@@ -0,0 +1,312 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+#include "ns3/multithreaded-simulator-impl.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * A toy model made of a set of nodes which forward tokens to each
+ * other with delays larger than the lookahead.  Every node keeps a
+ * hash of the events it processed, in order, so that two runs can be
+ * compared event by event.
+ */
+class MultithreadedTokenModel
+{
+public:
+  MultithreadedTokenModel (uint32_t nodes);
+  void Start (uint32_t hops);
+  void Receive (uint32_t from, uint32_t hops);
+  void Local (uint32_t value);
+  void Mix (uint32_t me, uint64_t value);
+
+  uint32_t m_nodes;
+  std::vector<uint64_t> m_hash;
+  std::vector<uint32_t> m_count;
+  std::vector<int64_t> m_last;
+};
+
+MultithreadedTokenModel::MultithreadedTokenModel (uint32_t nodes)
+  : m_nodes (nodes),
+    m_hash (nodes, 14695981039346656037ULL),
+    m_count (nodes, 0),
+    m_last (nodes, 0)
+{
+}
+
+void
+MultithreadedTokenModel::Start (uint32_t hops)
+{
+  for (uint32_t i = 0; i < m_nodes; i++)
+    {
+      Simulator::ScheduleWithContext (i, NanoSeconds (i % 3),
+                                      &MultithreadedTokenModel::Receive, this, i, hops);
+    }
+}
+
+void
+MultithreadedTokenModel::Mix (uint32_t me, uint64_t value)
+{
+  m_hash[me] = (m_hash[me] ^ value) * 1099511628211ULL;
+  m_count[me]++;
+  m_last[me] = Simulator::Now ().GetTimeStep ();
+}
+
+void
+MultithreadedTokenModel::Receive (uint32_t from, uint32_t hops)
+{
+  uint32_t me = Simulator::GetContext ();
+  Mix (me, Simulator::Now ().GetTimeStep () * 31 + from * 7 + hops);
+  if (hops == 0)
+    {
+      return;
+    }
+  uint64_t h = m_hash[me];
+  uint32_t to = (me * 7 + hops) % m_nodes;
+  Simulator::ScheduleWithContext (to, NanoSeconds (10 + (h % 3) * 5),
+                                  &MultithreadedTokenModel::Receive, this, me, hops - 1);
+  if (hops % 4 == 0)
+    {
+      // fan out, so that tokens meet on some nodes at the same time
+      Simulator::ScheduleWithContext ((to + 1) % m_nodes, NanoSeconds (10),
+                                      &MultithreadedTokenModel::Receive, this, me, hops / 2);
+    }
+  Simulator::Schedule (NanoSeconds (h % 4), &MultithreadedTokenModel::Local, this, hops);
+}
+
+void
+MultithreadedTokenModel::Local (uint32_t value)
+{
+  Mix (Simulator::GetContext (), value);
+}
+
+/**
+ * Base class of the test cases, which selects the
+ * MultithreadedSimulatorImpl for the duration of the test.
+ */
+class MultithreadedSimulatorTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorTestCase (std::string name);
+  virtual void DoSetup (void);
+  virtual void DoTeardown (void);
+  void Configure (uint32_t threads, Time lookahead);
+};
+
+MultithreadedSimulatorTestCase::MultithreadedSimulatorTestCase (std::string name)
+  : TestCase (name)
+{
+}
+
+void
+MultithreadedSimulatorTestCase::DoSetup (void)
+{
+  GlobalValue::Bind ("SimulatorImplementationType",
+                     StringValue ("ns3::MultithreadedSimulatorImpl"));
+}
+
+void
+MultithreadedSimulatorTestCase::DoTeardown (void)
+{
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::ThreadCount", UintegerValue (1));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Lookahead", TimeValue (Seconds (0)));
+  GlobalValue::Bind ("SimulatorImplementationType",
+                     StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+void
+MultithreadedSimulatorTestCase::Configure (uint32_t threads, Time lookahead)
+{
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::ThreadCount", UintegerValue (threads));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Lookahead", TimeValue (lookahead));
+}
+
+/**
+ * Check event scheduling, cancellation and expiration, and Stop (delay).
+ */
+class MultithreadedSimulatorEventsTestCase : public MultithreadedSimulatorTestCase
+{
+public:
+  MultithreadedSimulatorEventsTestCase ();
+  virtual void DoRun (void);
+  void EventA (void);
+  void EventB (void);
+  void EventC (void);
+  void Destroy (void);
+
+  bool m_a;
+  bool m_b;
+  bool m_c;
+  bool m_destroy;
+  EventId m_idA;
+  EventId m_idC;
+  Time m_delayLeft;
+};
+
+MultithreadedSimulatorEventsTestCase::MultithreadedSimulatorEventsTestCase ()
+  : MultithreadedSimulatorTestCase ("Check basic event handling of the multithreaded simulator")
+{
+}
+
+void
+MultithreadedSimulatorEventsTestCase::EventA (void)
+{
+  m_a = true;
+  m_delayLeft = Simulator::GetDelayLeft (m_idC);
+}
+
+void
+MultithreadedSimulatorEventsTestCase::EventB (void)
+{
+  m_b = m_idA.IsExpired () && !m_idC.IsExpired ();
+  Simulator::Cancel (m_idC);
+}
+
+void
+MultithreadedSimulatorEventsTestCase::EventC (void)
+{
+  m_c = true;
+}
+
+void
+MultithreadedSimulatorEventsTestCase::Destroy (void)
+{
+  m_destroy = true;
+}
+
+void
+MultithreadedSimulatorEventsTestCase::DoRun (void)
+{
+  Configure (1, NanoSeconds (10));
+  m_a = false;
+  m_b = false;
+  m_c = false;
+  m_destroy = false;
+
+  m_idA = Simulator::Schedule (MicroSeconds (10), &MultithreadedSimulatorEventsTestCase::EventA, this);
+  Simulator::Schedule (MicroSeconds (11), &MultithreadedSimulatorEventsTestCase::EventB, this);
+  m_idC = Simulator::Schedule (MicroSeconds (12), &MultithreadedSimulatorEventsTestCase::EventC, this);
+  Simulator::ScheduleDestroy (&MultithreadedSimulatorEventsTestCase::Destroy, this);
+  NS_TEST_EXPECT_MSG_EQ (m_idA.IsExpired (), false, "Event should not have expired yet");
+
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_a, true, "Event A did not run");
+  NS_TEST_EXPECT_MSG_EQ (m_b, true, "Event B did not see A expired and C pending");
+  NS_TEST_EXPECT_MSG_EQ (m_c, false, "Cancelled event C did run");
+  NS_TEST_EXPECT_MSG_EQ (m_delayLeft, MicroSeconds (2), "Wrong delay left");
+  NS_TEST_EXPECT_MSG_EQ (m_idC.IsExpired (), true, "Cancelled event is not expired");
+  // a cancelled event still advances the clock, as with the default implementation
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), MicroSeconds (12), "Wrong time after Run");
+
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (m_destroy, true, "Destroy event did not run");
+}
+
+/**
+ * Run the token model and compare the results with those of a
+ * reference run.
+ */
+class MultithreadedSimulatorDeterminismTestCase : public MultithreadedSimulatorTestCase
+{
+public:
+  MultithreadedSimulatorDeterminismTestCase ();
+  virtual void DoRun (void);
+  MultithreadedTokenModel RunModel (uint32_t threads, Time stop);
+};
+
+MultithreadedSimulatorDeterminismTestCase::MultithreadedSimulatorDeterminismTestCase ()
+  : MultithreadedSimulatorTestCase ("Check that the results do not depend on the number of threads")
+{
+}
+
+MultithreadedTokenModel
+MultithreadedSimulatorDeterminismTestCase::RunModel (uint32_t threads, Time stop)
+{
+  Configure (threads, NanoSeconds (10));
+  MultithreadedTokenModel model (16);
+  model.Start (24);
+  if (!stop.IsZero ())
+    {
+      Simulator::Stop (stop);
+    }
+  Simulator::Run ();
+  if (!stop.IsZero ())
+    {
+      NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), stop, "Simulation did not stop at the requested time");
+    }
+  Simulator::Destroy ();
+  return model;
+}
+
+void
+MultithreadedSimulatorDeterminismTestCase::DoRun (void)
+{
+  MultithreadedTokenModel reference = RunModel (1, Seconds (0));
+  uint32_t total = 0;
+  for (uint32_t i = 0; i < reference.m_nodes; i++)
+    {
+      total += reference.m_count[i];
+    }
+  NS_TEST_ASSERT_MSG_GT (total, reference.m_nodes * 24, "Too few events were processed");
+
+  MultithreadedTokenModel stopped = RunModel (1, NanoSeconds (155));
+  for (uint32_t i = 0; i < stopped.m_nodes; i++)
+    {
+      NS_TEST_EXPECT_MSG_LT (stopped.m_last[i], NanoSeconds (155).GetTimeStep (),
+                             "Event processed after the stop time on node " << i);
+    }
+
+  for (uint32_t threads = 2; threads <= 4; threads++)
+    {
+      MultithreadedTokenModel model = RunModel (threads, Seconds (0));
+      for (uint32_t i = 0; i < model.m_nodes; i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (model.m_count[i], reference.m_count[i],
+                                 "Event count differs on node " << i << " with " << threads << " threads");
+          NS_TEST_EXPECT_MSG_EQ (model.m_hash[i], reference.m_hash[i],
+                                 "Event order differs on node " << i << " with " << threads << " threads");
+        }
+      model = RunModel (threads, NanoSeconds (155));
+      for (uint32_t i = 0; i < model.m_nodes; i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (model.m_hash[i], stopped.m_hash[i],
+                                 "Stopped run differs on node " << i << " with " << threads << " threads");
+        }
+    }
+}
+
+class MultithreadedSimulatorTestSuite : public TestSuite
+{
+public:
+  MultithreadedSimulatorTestSuite ()
+    : TestSuite ("multithreaded-simulator")
+  {
+    AddTestCase (new MultithreadedSimulatorEventsTestCase (), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorDeterminismTestCase (), TestCase::QUICK);
+  }
+};
+
+static MultithreadedSimulatorTestSuite g_multithreadedSimulatorTestSuite;
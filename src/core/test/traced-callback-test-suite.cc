@@ -108,6 +108,63 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+class ReentrantTracedCallbackTestCase : public TestCase
+{
+public:
+  ReentrantTracedCallbackTestCase ();
+  virtual ~ReentrantTracedCallbackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  void CbConnect (uint32_t a);
+  void CbCount (uint32_t a);
+
+  TracedCallback<uint32_t> m_trace;
+  uint32_t m_count;
+};
+
+ReentrantTracedCallbackTestCase::ReentrantTracedCallbackTestCase ()
+  : TestCase ("Check connecting to a TracedCallback while it is invoked")
+{
+}
+
+void
+ReentrantTracedCallbackTestCase::CbConnect (uint32_t a)
+{
+  // grow the chain enough to move it in memory
+  for (uint32_t i = 0; i < 16; i++)
+    {
+      m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbCount, this));
+    }
+}
+
+void
+ReentrantTracedCallbackTestCase::CbCount (uint32_t a)
+{
+  m_count += a;
+}
+
+void
+ReentrantTracedCallbackTestCase::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "New TracedCallback not empty");
+  m_trace.ConnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbConnect, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), false, "TracedCallback empty after Connect");
+
+  // the callbacks connected during the invocation are invoked too
+  m_count = 0;
+  m_trace (1);
+  NS_TEST_ASSERT_MSG_EQ (m_count, 16, "Callbacks connected during the invocation not called");
+
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbConnect, this));
+  m_trace.DisconnectWithoutContext (MakeCallback (&ReentrantTracedCallbackTestCase::CbCount, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "TracedCallback not empty after Disconnect");
+  m_count = 0;
+  m_trace (1);
+  NS_TEST_ASSERT_MSG_EQ (m_count, 0, "Disconnected callbacks called");
+}
+
 class TracedCallbackTestSuite : public TestSuite
 {
 public:
@@ -118,6 +175,7 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new ReentrantTracedCallbackTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite tracedCallbackTestSuite;
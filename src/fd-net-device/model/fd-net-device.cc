@@ -24,6 +24,7 @@
 #include "ns3/abort.h"
 #include "ns3/boolean.h"
 #include "ns3/channel.h"
+#include "ns3/checksum-offload.h"
 #include "ns3/enum.h"
 #include "ns3/ethernet-header.h"
 #include "ns3/ethernet-trailer.h"
@@ -579,7 +580,7 @@ FdNetDevice::SendFrom (Ptr<Packet> packet, const Address& src, const Address& de
 
   ssize_t len =  (ssize_t) packet->GetSize ();
   uint8_t *buffer = (uint8_t*)malloc (len);
-  packet->CopyData (buffer, len);
+  ChecksumOffload::Complete (packet)->CopyData (buffer, len);
 
   // We need to add the PI header
   if (m_encapMode == DIXPI)
@@ -29,6 +29,8 @@
 #include "ns3/ipv6-l3-protocol.h"
 #include "ns3/node.h"
 #include "ns3/node-list.h"
+#include "ns3/wifi-flow-probe.h"
+#include "ns3/wifi-net-device.h"
 
 
 namespace ns3 {
@@ -145,6 +147,21 @@ FlowMonitorHelper::InstallAll ()
   return m_flowMonitor;
 }
 
+Ptr<FlowMonitor>
+FlowMonitorHelper::InstallWifi (NetDeviceContainer devices)
+{
+  Ptr<FlowMonitor> monitor = GetMonitor ();
+  for (NetDeviceContainer::Iterator i = devices.Begin (); i != devices.End (); ++i)
+    {
+      Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (*i);
+      if (device)
+        {
+          Ptr<WifiFlowProbe> probe = Create<WifiFlowProbe> (monitor, device);
+        }
+    }
+  return m_flowMonitor;
+}
+
 void
 FlowMonitorHelper::SerializeToXmlStream (std::ostream &os, int indent, bool enableHistograms, bool enableProbes)
 {
@@ -21,6 +21,7 @@
 #define FLOW_MONITOR_HELPER_H
 
 #include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
 #include "ns3/object-factory.h"
 #include "ns3/flow-monitor.h"
 #include "ns3/flow-classifier.h"
@@ -67,6 +68,16 @@ public:
    * \returns a pointer to the FlowMonitor object
    */
   Ptr<FlowMonitor> InstallAll ();
+  /**
+   * \brief Enable the monitoring of the MAC and PHY layers of a set of
+   * wifi devices, with a WifiFlowProbe per device
+   *
+   * The devices which are not WifiNetDevice are ignored.
+   *
+   * \param devices A NetDeviceContainer holding the set of devices to work with.
+   * \returns a pointer to the FlowMonitor object
+   */
+  Ptr<FlowMonitor> InstallWifi (NetDeviceContainer devices);
 
   /**
    * \brief Retrieve the FlowMonitor object created by the Install* methods
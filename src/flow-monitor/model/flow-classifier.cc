@@ -38,6 +38,11 @@ FlowClassifier::GetNewFlowId ()
   return ++m_lastNewFlowId;
 }
 
+void
+FlowClassifier::RemoveFlow (FlowId flowId)
+{
+}
+
 
 } // namespace ns3
 
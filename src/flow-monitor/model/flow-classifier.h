@@ -22,6 +22,7 @@
 #define FLOW_CLASSIFIER_H
 
 #include "ns3/simple-ref-count.h"
+#include <deque>
 #include <ostream>
 
 namespace ns3 {
@@ -38,6 +39,95 @@ typedef uint32_t FlowId;
  */
 typedef uint32_t FlowPacketId;
 
+/**
+ * \ingroup flow-monitor
+ * \brief The flow ids below this limit find their stats without a map lookup
+ */
+static const FlowId MAX_INDEXED_FLOW_ID = 1 << 20;
+
+/**
+ * \ingroup flow-monitor
+ * \brief Direct index from the flow ids to the stats of the flows
+ *
+ * The stats live in a std::map, whose elements never move, and this
+ * index finds them without a map lookup.  It covers a window of at
+ * most MAX_INDEXED_FLOW_ID consecutive flow ids, starting at the oldest
+ * flow not removed, so that it does not grow with the number of flows
+ * when the idle flows are removed.  The flows out of the window are
+ * only found through the map.
+ */
+template <typename T>
+class FlowIdIndex
+{
+public:
+  FlowIdIndex ()
+    : m_first (0)
+  {
+  }
+  /**
+   * \param flowId the flow id
+   * \returns the stats of the flow, or 0 if not indexed
+   */
+  T *Find (FlowId flowId) const
+  {
+    if (flowId >= m_first && flowId - m_first < m_index.size ())
+      {
+        return m_index[flowId - m_first];
+      }
+    return 0;
+  }
+  /**
+   * \brief Index the stats of a new flow, if in the window
+   * \param flowId the flow id
+   * \param stats the stats of the flow
+   */
+  void Insert (FlowId flowId, T *stats)
+  {
+    if (m_index.empty ())
+      {
+        m_first = flowId;
+      }
+    if (flowId < m_first || flowId - m_first >= MAX_INDEXED_FLOW_ID)
+      {
+        return;
+      }
+    if (flowId - m_first >= m_index.size ())
+      {
+        m_index.resize (flowId - m_first + 1, 0);
+      }
+    m_index[flowId - m_first] = stats;
+  }
+  /**
+   * \brief Forget a flow, and the empty slots at both ends of the window
+   * \param flowId the flow id
+   */
+  void Remove (FlowId flowId)
+  {
+    if (Find (flowId) == 0)
+      {
+        return;
+      }
+    m_index[flowId - m_first] = 0;
+    while (!m_index.empty () && m_index.front () == 0)
+      {
+        m_index.pop_front ();
+        m_first++;
+      }
+    while (!m_index.empty () && m_index.back () == 0)
+      {
+        m_index.pop_back ();
+      }
+  }
+  /// \returns the number of slots of the window
+  uint32_t GetSize (void) const
+  {
+    return m_index.size ();
+  }
+private:
+  std::deque<T *> m_index;  //!< Stats of the flows from m_first on
+  FlowId m_first;           //!< Flow id of m_index[0]
+};
+
 
 /// \ingroup flow-monitor
 /// Provides a method to translate raw packet data into abstract
@@ -71,6 +161,11 @@ public:
   /// \param indent number of spaces to use as base indentation level
   virtual void SerializeToXmlStream (std::ostream &os, int indent) const = 0;
 
+  /// Forget a flow, e.g., after it was idle for long.  The next packet
+  /// of the same flow gets a new flow identifier.
+  /// \param flowId the flow identifier
+  virtual void RemoveFlow (FlowId flowId);
+
 protected:
   /// Returns a new, unique Flow Identifier
   /// \returns a new FlowId
@@ -22,8 +22,12 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
 #include <fstream>
 #include <sstream>
+#include <cstring>
+#include <cmath>
 
 #define INDENT(level) for (int __xpto = 0; __xpto < level; __xpto++) os << ' ';
 
@@ -72,6 +76,27 @@ FlowMonitor::GetTypeId (void)
                    TimeValue (Seconds (0.5)),
                    MakeTimeAccessor (&FlowMonitor::m_flowInterruptionsMinTime),
                    MakeTimeChecker ())
+    .AddAttribute ("QuantileSketches", ("Record the delays, jitters and packet sizes in quantile sketches "
+                                        "instead of the fixed width histograms."),
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&FlowMonitor::m_quantileSketches),
+                   MakeBooleanChecker ())
+    .AddAttribute ("SketchRelativeAccuracy", ("The relative error on the quantiles of the sketches, "
+                                              "including the ones of the snapshots."),
+                   DoubleValue (0.01),
+                   MakeDoubleAccessor (&FlowMonitor::m_sketchRelativeAccuracy),
+                   MakeDoubleChecker <double> (1e-6, 0.5))
+    .AddAttribute ("SketchMaxBins", ("The maximum number of bins of a sketch: the lowest bins are merged "
+                                     "beyond."),
+                   UintegerValue (2048),
+                   MakeUintegerAccessor (&FlowMonitor::m_sketchMaxBins),
+                   MakeUintegerChecker <uint32_t> (1))
+    .AddAttribute ("IdleFlowTimeout", ("When writing snapshots, the time after which a flow without any packet "
+                                       "transmitted or received is forgotten (0 means never).  Flows are never "
+                                       "forgotten before MaxPerHopDelay."),
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&FlowMonitor::m_idleFlowTimeout),
+                   MakeTimeChecker ())
   ;
   return tid;
 }
@@ -82,8 +107,16 @@ FlowMonitor::GetInstanceTypeId (void) const
   return GetTypeId ();
 }
 
+const uint32_t FlowMonitor::SNAPSHOT_MAGIC;
+const uint16_t FlowMonitor::SNAPSHOT_VERSION;
+const uint16_t FlowMonitor::SNAPSHOT_RECORD_SIZE;
+
 FlowMonitor::FlowMonitor ()
-  : m_enabled (false)
+  : m_enabled (false),
+    m_quantileSketches (false),
+    m_sketchRelativeAccuracy (0.01),
+    m_sketchMaxBins (2048),
+    m_snapshotFormat (SNAPSHOT_CSV)
 {
   // m_histogramBinWidth=DEFAULT_BIN_WIDTH;
 }
@@ -91,6 +124,8 @@ FlowMonitor::FlowMonitor ()
 void
 FlowMonitor::DoDispose (void)
 {
+  Simulator::Cancel (m_snapshotEvent);
+  m_snapshotWriter.Close ();
   for (std::list<Ptr<FlowClassifier> >::iterator iter = m_classifiers.begin ();
       iter != m_classifiers.end ();
       iter ++)
@@ -105,9 +140,20 @@ FlowMonitor::DoDispose (void)
   Object::DoDispose ();
 }
 
+inline uint64_t
+FlowMonitor::GetTrackedPacketKey (FlowId flowId, FlowPacketId packetId)
+{
+  return (static_cast<uint64_t> (flowId) << 32) | packetId;
+}
+
 inline FlowMonitor::FlowStats&
 FlowMonitor::GetStatsForFlow (FlowId flowId)
 {
+  FlowStats *indexed = m_flowStatsIndex.Find (flowId);
+  if (indexed != 0)
+    {
+      return *indexed;
+    }
   FlowStatsContainerI iter;
   iter = m_flowStats.find (flowId);
   if (iter == m_flowStats.end ())
@@ -126,6 +172,14 @@ FlowMonitor::GetStatsForFlow (FlowId flowId)
       ref.jitterHistogram.SetDefaultBinWidth (m_jitterBinWidth);
       ref.packetSizeHistogram.SetDefaultBinWidth (m_packetSizeBinWidth);
       ref.flowInterruptionsHistogram.SetDefaultBinWidth (m_flowInterruptionsBinWidth);
+      if (m_quantileSketches)
+        {
+          QuantileSketch sketch (m_sketchRelativeAccuracy, m_sketchMaxBins);
+          ref.delaySketch = sketch;
+          ref.jitterSketch = sketch;
+          ref.packetSizeSketch = sketch;
+        }
+      m_flowStatsIndex.Insert (flowId, &ref);
       return ref;
     }
   else
@@ -143,10 +197,12 @@ FlowMonitor::ReportFirstTx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t pack
       return;
     }
   Time now = Simulator::Now ();
-  TrackedPacket &tracked = m_trackedPackets[std::make_pair (flowId, packetId)];
+  uint64_t key = GetTrackedPacketKey (flowId, packetId);
+  TrackedPacket &tracked = m_trackedPackets[key];
   tracked.firstSeenTime = now;
   tracked.lastSeenTime = tracked.firstSeenTime;
   tracked.timesForwarded = 0;
+  m_trackedPacketEvents.push_back (TrackedPacketEvent (key, now));
   NS_LOG_DEBUG ("ReportFirstTx: adding tracked packet (flowId=" << flowId << ", packetId=" << packetId
                                                                 << ").");
 
@@ -170,19 +226,21 @@ FlowMonitor::ReportForwarding (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t p
     {
       return;
     }
-  std::pair<FlowId, FlowPacketId> key (flowId, packetId);
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (key);
-  if (tracked == m_trackedPackets.end ())
+  uint64_t key = GetTrackedPacketKey (flowId, packetId);
+  TrackedPacket *tracked = m_trackedPackets.Find (key);
+  if (tracked == 0)
     {
       NS_LOG_WARN ("Received packet forward report (flowId=" << flowId << ", packetId=" << packetId
                                                              << ") but not known to be transmitted.");
       return;
     }
 
-  tracked->second.timesForwarded++;
-  tracked->second.lastSeenTime = Simulator::Now ();
+  Time now = Simulator::Now ();
+  tracked->timesForwarded++;
+  tracked->lastSeenTime = now;
+  m_trackedPacketEvents.push_back (TrackedPacketEvent (key, now));
 
-  Time delay = (Simulator::Now () - tracked->second.firstSeenTime);
+  Time delay = (now - tracked->firstSeenTime);
   probe->AddPacketStats (flowId, packetSize, delay);
 }
 
@@ -194,8 +252,9 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
     {
       return;
     }
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
-  if (tracked == m_trackedPackets.end ())
+  uint64_t key = GetTrackedPacketKey (flowId, packetId);
+  TrackedPacket *tracked = m_trackedPackets.Find (key);
+  if (tracked == 0)
     {
       NS_LOG_WARN ("Received packet last-tx report (flowId=" << flowId << ", packetId=" << packetId
                                                              << ") but not known to be transmitted.");
@@ -203,30 +262,56 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
     }
 
   Time now = Simulator::Now ();
-  Time delay = (now - tracked->second.firstSeenTime);
+  Time delay = (now - tracked->firstSeenTime);
   probe->AddPacketStats (flowId, packetSize, delay);
 
   FlowStats &stats = GetStatsForFlow (flowId);
+  FlowInterval *interval = m_snapshotWriter.IsOpen () ? &GetIntervalForFlow (flowId) : 0;
   stats.delaySum += delay;
-  stats.delayHistogram.AddValue (delay.GetSeconds ());
+  if (m_quantileSketches)
+    {
+      stats.delaySketch.AddValue (delay.GetSeconds ());
+    }
+  else
+    {
+      stats.delayHistogram.AddValue (delay.GetSeconds ());
+    }
+  if (interval != 0)
+    {
+      interval->delaySketch.AddValue (delay.GetSeconds ());
+    }
   if (stats.rxPackets > 0 )
     {
       Time jitter = stats.lastDelay - delay;
-      if (jitter > Seconds (0))
+      if (jitter < Seconds (0))
+        {
+          jitter = delay - stats.lastDelay;
+        }
+      stats.jitterSum += jitter;
+      if (m_quantileSketches)
+        {
+          stats.jitterSketch.AddValue (jitter.GetSeconds ());
+        }
+      else
         {
-          stats.jitterSum += jitter;
           stats.jitterHistogram.AddValue (jitter.GetSeconds ());
         }
-      else 
+      if (interval != 0)
         {
-          stats.jitterSum -= jitter;
-          stats.jitterHistogram.AddValue (-jitter.GetSeconds ());
+          interval->jitterSketch.AddValue (jitter.GetSeconds ());
         }
     }
   stats.lastDelay = delay;
 
   stats.rxBytes += packetSize;
-  stats.packetSizeHistogram.AddValue ((double) packetSize);
+  if (m_quantileSketches)
+    {
+      stats.packetSizeSketch.AddValue ((double) packetSize);
+    }
+  else
+    {
+      stats.packetSizeHistogram.AddValue ((double) packetSize);
+    }
   stats.rxPackets++;
   if (stats.rxPackets == 1)
     {
@@ -242,12 +327,12 @@ FlowMonitor::ReportLastRx (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packe
         }
     }
   stats.timeLastRxPacket = now;
-  stats.timesForwarded += tracked->second.timesForwarded;
+  stats.timesForwarded += tracked->timesForwarded;
 
   NS_LOG_DEBUG ("ReportLastTx: removing tracked packet (flowId="
                 << flowId << ", packetId=" << packetId << ").");
 
-  m_trackedPackets.erase (tracked); // we don't need to track this packet anymore
+  m_trackedPackets.Erase (key); // we don't need to track this packet anymore
 }
 
 void
@@ -272,14 +357,12 @@ FlowMonitor::ReportDrop (Ptr<FlowProbe> probe, uint32_t flowId, uint32_t packetI
   stats.bytesDropped[reasonCode] += packetSize;
   NS_LOG_DEBUG ("++stats.packetsDropped[" << reasonCode<< "]; // becomes: " << stats.packetsDropped[reasonCode]);
 
-  TrackedPacketMap::iterator tracked = m_trackedPackets.find (std::make_pair (flowId, packetId));
-  if (tracked != m_trackedPackets.end ())
+  // we don't need to track this packet anymore
+  // FIXME: this will not necessarily be true with broadcast/multicast
+  if (m_trackedPackets.Erase (GetTrackedPacketKey (flowId, packetId)))
     {
-      // we don't need to track this packet anymore
-      // FIXME: this will not necessarily be true with broadcast/multicast
-      NS_LOG_DEBUG ("ReportDrop: removing tracked packet (flowId="
+      NS_LOG_DEBUG ("ReportDrop: removed tracked packet (flowId="
                     << flowId << ", packetId=" << packetId << ").");
-      m_trackedPackets.erase (tracked);
     }
 }
 
@@ -295,23 +378,27 @@ FlowMonitor::CheckForLostPackets (Time maxDelay)
 {
   Time now = Simulator::Now ();
 
-  for (TrackedPacketMap::iterator iter = m_trackedPackets.begin ();
-       iter != m_trackedPackets.end (); )
+  // The events are in time order: only the events older than maxDelay
+  // are visited, and each event is visited once.  A packet is lost if
+  // its last event is older than maxDelay.
+  while (!m_trackedPacketEvents.empty ()
+         && now - m_trackedPacketEvents.front ().second >= maxDelay)
     {
-      if (now - iter->second.lastSeenTime >= maxDelay)
+      TrackedPacketEvent event = m_trackedPacketEvents.front ();
+      m_trackedPacketEvents.pop_front ();
+      TrackedPacket *tracked = m_trackedPackets.Find (event.first);
+      if (tracked == 0 || tracked->lastSeenTime != event.second)
         {
-          // packet is considered lost, add it to the loss statistics
-          FlowStatsContainerI flow = m_flowStats.find (iter->first.first);
-          NS_ASSERT (flow != m_flowStats.end ());
-          flow->second.lostPackets++;
-
-          // we won't track it anymore
-          m_trackedPackets.erase (iter++);
-        }
-      else
-        {
-          iter++;
+          // the packet was received, dropped, or seen again since
+          continue;
         }
+      // packet is considered lost, add it to the loss statistics
+      // (of a new entry if the flow was forgotten as idle meanwhile)
+      FlowId flowId = static_cast<FlowId> (event.first >> 32);
+      GetStatsForFlow (flowId).lostPackets++;
+
+      // we won't track it anymore
+      m_trackedPackets.Erase (event.first);
     }
 }
 
@@ -400,6 +487,197 @@ FlowMonitor::AddFlowClassifier (Ptr<FlowClassifier> classifier)
   m_classifiers.push_back (classifier);
 }
 
+FlowMonitor::FlowInterval&
+FlowMonitor::GetIntervalForFlow (FlowId flowId)
+{
+  FlowInterval *interval = m_flowIntervals.Find (flowId);
+  if (interval != 0)
+    {
+      return *interval;
+    }
+  FlowInterval initial;
+  initial.txBytes = 0;
+  initial.rxBytes = 0;
+  initial.txPackets = 0;
+  initial.rxPackets = 0;
+  initial.lostPackets = 0;
+  initial.delaySum = Seconds (0);
+  initial.delaySketch = QuantileSketch (m_sketchRelativeAccuracy, m_sketchMaxBins);
+  initial.jitterSketch = initial.delaySketch;
+  bool inserted;
+  return m_flowIntervals.Insert (flowId, initial, inserted);
+}
+
+void
+FlowMonitor::WriteFlowSnapshot (FlowId flowId, const FlowStats &stats, FlowInterval &interval, bool evicted)
+{
+  uint32_t txPackets = stats.txPackets - interval.txPackets;
+  uint32_t rxPackets = stats.rxPackets - interval.rxPackets;
+  uint32_t lostPackets = stats.lostPackets - interval.lostPackets;
+  if (txPackets == 0 && rxPackets == 0 && lostPackets == 0 && !evicted)
+    {
+      return;
+    }
+  Time now = Simulator::Now ();
+  uint64_t txBytes = stats.txBytes - interval.txBytes;
+  uint64_t rxBytes = stats.rxBytes - interval.rxBytes;
+  double seconds = (now - m_lastSnapshotTime).GetSeconds ();
+  double values[8];
+  values[0] = seconds > 0 ? rxBytes * 8.0 / seconds : 0;
+  values[1] = rxPackets > 0 ? (stats.delaySum - interval.delaySum).GetSeconds () / rxPackets : 0;
+  values[2] = interval.delaySketch.GetQuantile (0.5);
+  values[3] = interval.delaySketch.GetQuantile (0.95);
+  values[4] = interval.delaySketch.GetQuantile (0.99);
+  values[5] = interval.delaySketch.GetQuantile (0.999);
+  values[6] = interval.jitterSketch.GetQuantile (0.5);
+  values[7] = interval.jitterSketch.GetQuantile (0.99);
+
+  if (m_snapshotFormat == SNAPSHOT_CSV)
+    {
+      std::ostringstream os;
+      os << now.GetSeconds () << ',' << flowId
+         << ',' << txPackets << ',' << txBytes
+         << ',' << rxPackets << ',' << rxBytes
+         << ',' << lostPackets << ',' << evicted;
+      for (uint32_t i = 0; i < 8; i++)
+        {
+          os << ',' << values[i];
+        }
+      os << '\n';
+      std::string line = os.str ();
+      m_snapshotWriter.Write (line.data (), line.size ());
+    }
+  else
+    {
+      int64_t time = now.GetNanoSeconds ();
+      uint32_t flags = evicted;
+      uint8_t *p = m_snapshotWriter.Reserve (SNAPSHOT_RECORD_SIZE);
+      std::memcpy (p, &time, 8);
+      std::memcpy (p + 8, &flowId, 4);
+      std::memcpy (p + 12, &txPackets, 4);
+      std::memcpy (p + 16, &txBytes, 8);
+      std::memcpy (p + 24, &rxPackets, 4);
+      std::memcpy (p + 28, &rxBytes, 8);
+      std::memcpy (p + 36, &lostPackets, 4);
+      std::memcpy (p + 40, &flags, 4);
+      std::memcpy (p + 44, values, sizeof (values));
+    }
+
+  interval.txBytes = stats.txBytes;
+  interval.rxBytes = stats.rxBytes;
+  interval.txPackets = stats.txPackets;
+  interval.rxPackets = stats.rxPackets;
+  interval.lostPackets = stats.lostPackets;
+  interval.delaySum = stats.delaySum;
+  interval.delaySketch.Clear ();
+  interval.jitterSketch.Clear ();
+}
+
+void
+FlowMonitor::RemoveFlow (FlowId flowId)
+{
+  NS_LOG_DEBUG ("Forgetting idle flow " << flowId);
+  m_flowStatsIndex.Remove (flowId);
+  m_flowStats.erase (flowId);
+  m_flowIntervals.Erase (flowId);
+  for (uint32_t i = 0; i < m_flowProbes.size (); i++)
+    {
+      m_flowProbes[i]->RemoveStats (flowId);
+    }
+  for (std::list<Ptr<FlowClassifier> >::iterator iter = m_classifiers.begin ();
+       iter != m_classifiers.end (); iter++)
+    {
+      (*iter)->RemoveFlow (flowId);
+    }
+}
+
+void
+FlowMonitor::WriteSnapshot ()
+{
+  CheckForLostPackets ();
+  Time now = Simulator::Now ();
+  Time idleTimeout = Max (m_idleFlowTimeout, m_maxPerHopDelay);
+  std::vector<FlowId> idleFlows;
+  for (FlowStatsContainerCI flowI = m_flowStats.begin (); flowI != m_flowStats.end (); flowI++)
+    {
+      const FlowStats &stats = flowI->second;
+      bool idle = m_idleFlowTimeout.IsStrictlyPositive ()
+        && now - Max (stats.timeLastTxPacket, stats.timeLastRxPacket) > idleTimeout;
+      WriteFlowSnapshot (flowI->first, stats, GetIntervalForFlow (flowI->first), idle);
+      if (idle)
+        {
+          idleFlows.push_back (flowI->first);
+        }
+    }
+  for (std::vector<FlowId>::const_iterator i = idleFlows.begin (); i != idleFlows.end (); i++)
+    {
+      RemoveFlow (*i);
+    }
+  m_lastSnapshotTime = now;
+  m_snapshotEvent = Simulator::Schedule (m_snapshotInterval, &FlowMonitor::WriteSnapshot, this);
+}
+
+bool
+FlowMonitor::StartSnapshots (Time interval, std::string fileName, SnapshotFormat format)
+{
+  NS_LOG_FUNCTION (this << interval << fileName << format);
+  NS_ASSERT (interval.IsStrictlyPositive ());
+  StopSnapshots ();
+  if (!m_snapshotWriter.Open (fileName, 1 << 16, 4, true))
+    {
+      NS_LOG_WARN ("Cannot create the snapshot file " << fileName);
+      return false;
+    }
+  m_snapshotFormat = format;
+  if (format == SNAPSHOT_CSV)
+    {
+      std::string header = "time,flowId,txPackets,txBytes,rxPackets,rxBytes,lostPackets,evicted,"
+        "throughput,delayMean,delayP50,delayP95,delayP99,delayP999,jitterP50,jitterP99\n";
+      m_snapshotWriter.Write (header.data (), header.size ());
+    }
+  else
+    {
+      uint32_t magic = SNAPSHOT_MAGIC;
+      uint16_t version[2] = { SNAPSHOT_VERSION, SNAPSHOT_RECORD_SIZE };
+      m_snapshotWriter.Write (&magic, sizeof (magic));
+      m_snapshotWriter.Write (version, sizeof (version));
+    }
+
+  // the first interval starts now
+  for (FlowStatsContainerCI flowI = m_flowStats.begin (); flowI != m_flowStats.end (); flowI++)
+    {
+      FlowInterval &flowInterval = GetIntervalForFlow (flowI->first);
+      flowInterval.txBytes = flowI->second.txBytes;
+      flowInterval.rxBytes = flowI->second.rxBytes;
+      flowInterval.txPackets = flowI->second.txPackets;
+      flowInterval.rxPackets = flowI->second.rxPackets;
+      flowInterval.lostPackets = flowI->second.lostPackets;
+      flowInterval.delaySum = flowI->second.delaySum;
+    }
+  m_snapshotInterval = interval;
+  m_lastSnapshotTime = Simulator::Now ();
+  m_snapshotEvent = Simulator::Schedule (interval, &FlowMonitor::WriteSnapshot, this);
+  return true;
+}
+
+void
+FlowMonitor::StopSnapshots ()
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_snapshotWriter.IsOpen ())
+    {
+      return;
+    }
+  Simulator::Cancel (m_snapshotEvent);
+  if (Simulator::Now () > m_lastSnapshotTime)
+    {
+      WriteSnapshot ();
+      Simulator::Cancel (m_snapshotEvent);
+    }
+  m_snapshotWriter.Close ();
+  m_flowIntervals.Clear ();
+}
+
 void
 FlowMonitor::SerializeToXmlStream (std::ostream &os, int indent, bool enableHistograms, bool enableProbes)
 {
@@ -448,7 +726,14 @@ FlowMonitor::SerializeToXmlStream (std::ostream &os, int indent, bool enableHist
           << " bytes=\"" << flowI->second.bytesDropped[reasonCode]
           << "\" />\n";
         }
-      if (enableHistograms)
+      if (enableHistograms && m_quantileSketches)
+        {
+          flowI->second.delaySketch.SerializeToXmlStream (os, indent, "delaySketch");
+          flowI->second.jitterSketch.SerializeToXmlStream (os, indent, "jitterSketch");
+          flowI->second.packetSizeSketch.SerializeToXmlStream (os, indent, "packetSizeSketch");
+          flowI->second.flowInterruptionsHistogram.SerializeToXmlStream (os, indent, "flowInterruptionsHistogram");
+        }
+      else if (enableHistograms)
         {
           flowI->second.delayHistogram.SerializeToXmlStream (os, indent, "delayHistogram");
           flowI->second.jitterHistogram.SerializeToXmlStream (os, indent, "jitterHistogram");
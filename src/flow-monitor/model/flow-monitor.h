@@ -23,14 +23,18 @@
 
 #include <vector>
 #include <map>
+#include <deque>
 
 #include "ns3/ptr.h"
 #include "ns3/object.h"
 #include "ns3/flow-probe.h"
 #include "ns3/flow-classifier.h"
 #include "ns3/histogram.h"
+#include "ns3/quantile-sketch.h"
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
+#include "ns3/flat-hash-map.h"
+#include "ns3/async-file-writer.h"
 
 namespace ns3 {
 
@@ -116,6 +120,15 @@ public:
     Histogram jitterHistogram;
     /// Histogram of the packet sizes
     Histogram packetSizeHistogram;
+    /// Quantile sketch of the packet delays, used instead of
+    /// delayHistogram with the QuantileSketches attribute
+    QuantileSketch delaySketch;
+    /// Quantile sketch of the packet jitters, used instead of
+    /// jitterHistogram with the QuantileSketches attribute
+    QuantileSketch jitterSketch;
+    /// Quantile sketch of the packet sizes, used instead of
+    /// packetSizeHistogram with the QuantileSketches attribute
+    QuantileSketch packetSizeSketch;
 
     /// This attribute also tracks the number of lost packets and
     /// bytes, but discriminates the losses by a _reason code_.  This
@@ -257,6 +270,52 @@ public:
   void SerializeToXmlFile (std::string fileName, bool enableHistograms, bool enableProbes);
 
 
+  // --- periodic snapshots ---
+
+  /// Format of the files written by StartSnapshots
+  enum SnapshotFormat
+  {
+    SNAPSHOT_CSV,     //!< One text line per flow and interval
+    SNAPSHOT_BINARY   //!< One fixed size record per flow and interval
+  };
+
+  /// Start writing, every \p interval, the activity of each flow
+  /// during the last interval: the packets and bytes transmitted,
+  /// received and lost, the throughput, the mean, median, 95th, 99th
+  /// and 99.9th percentile of the delays, and the median and 99th
+  /// percentile of the jitters.  Only the flows active during the
+  /// interval are written.  The file is written while the simulation
+  /// runs, by a background thread when available.
+  ///
+  /// When the IdleFlowTimeout attribute is set, the flows idle for
+  /// longer are written one last time and then forgotten, so that the
+  /// memory used does not grow with the number of flows of a long run.
+  /// The forgotten flows are no longer in GetFlowStats () nor in the
+  /// XML output.
+  ///
+  /// The CSV file starts with a line naming the columns.  The binary
+  /// file starts with the 32 bit SNAPSHOT_MAGIC, the 16 bit
+  /// SNAPSHOT_VERSION and the 16 bit size of the records, followed by
+  /// the records, in the byte order of the host:
+  /// int64 time (ns), uint32 flowId, uint32 txPackets, uint64 txBytes,
+  /// uint32 rxPackets, uint64 rxBytes, uint32 lostPackets,
+  /// uint32 evicted, then the doubles throughput (bit/s), mean delay,
+  /// median delay, 95th, 99th and 99.9th percentile delays, median and
+  /// 99th percentile jitters (s).  The percentiles are estimated with
+  /// QuantileSketch, within the SketchRelativeAccuracy attribute.
+  ///
+  /// \param interval the time between two snapshots
+  /// \param fileName name or path of the output file that will be created
+  /// \param format the format of the file
+  /// \returns false if the file cannot be created
+  bool StartSnapshots (Time interval, std::string fileName, SnapshotFormat format = SNAPSHOT_CSV);
+  /// Write the last snapshot and close the snapshot file
+  void StopSnapshots ();
+
+  static const uint32_t SNAPSHOT_MAGIC = 0x534e4d46;   //!< "FMNS" in little endian
+  static const uint16_t SNAPSHOT_VERSION = 2;          //!< Binary snapshot format version
+  static const uint16_t SNAPSHOT_RECORD_SIZE = 108;    //!< Size of the binary snapshot records
+
 protected:
 
   virtual void NotifyConstructionCompleted ();
@@ -274,10 +333,16 @@ private:
 
   /// FlowId --> FlowStats
   FlowStatsContainer m_flowStats;
+  /// FlowId --> FlowStats in m_flowStats, for the recent flow ids
+  FlowIdIndex<FlowStats> m_flowStatsIndex;
 
-  /// (FlowId,PacketId) --> TrackedPacket
-  typedef std::map< std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
+  /// (FlowId << 32 | PacketId) --> TrackedPacket
+  typedef FlatHashMap<uint64_t, TrackedPacket> TrackedPacketMap;
   TrackedPacketMap m_trackedPackets; //!< Tracked packets
+  /// A tracked packet key, with a time when the packet was seen
+  typedef std::pair<uint64_t, Time> TrackedPacketEvent;
+  /// Every time a packet was seen, in increasing time order
+  std::deque<TrackedPacketEvent> m_trackedPacketEvents;
   Time m_maxPerHopDelay; //!< Minimum per-hop delay
   FlowProbeContainer m_flowProbes; //!< all the FlowProbes
 
@@ -291,6 +356,9 @@ private:
   double m_jitterBinWidth;  //!< Jitter bin width (for histograms)
   double m_packetSizeBinWidth;  //!< packet size bin width (for histograms)
   double m_flowInterruptionsBinWidth; //!< Flow interruptions bin width (for histograms)
+  bool m_quantileSketches;  //!< Use quantile sketches instead of the histograms
+  double m_sketchRelativeAccuracy; //!< Relative accuracy of the quantile sketches
+  uint32_t m_sketchMaxBins; //!< Maximum number of bins of the quantile sketches
   Time m_flowInterruptionsMinTime; //!< Flow interruptions minimum time
 
   /// Get the stats for a given flow
@@ -298,8 +366,55 @@ private:
   /// \returns the stats of the flow
   FlowStats& GetStatsForFlow (FlowId flowId);
 
+  /// Get the key of a packet in m_trackedPackets
+  /// \param flowId the Flow identification
+  /// \param packetId the Packet identification
+  /// \returns the key
+  static uint64_t GetTrackedPacketKey (FlowId flowId, FlowPacketId packetId);
+
   /// Periodic function to check for lost packets and prune statistics
   void PeriodicCheckForLostPackets ();
+
+  /// The activity of a flow in the current snapshot interval
+  struct FlowInterval
+  {
+    uint64_t txBytes;       //!< FlowStats::txBytes at the last snapshot
+    uint64_t rxBytes;       //!< FlowStats::rxBytes at the last snapshot
+    uint32_t txPackets;     //!< FlowStats::txPackets at the last snapshot
+    uint32_t rxPackets;     //!< FlowStats::rxPackets at the last snapshot
+    uint32_t lostPackets;   //!< FlowStats::lostPackets at the last snapshot
+    Time delaySum;          //!< FlowStats::delaySum at the last snapshot
+    QuantileSketch delaySketch;   //!< Delays of the packets received in the interval
+    QuantileSketch jitterSketch;  //!< Jitters of the packets received in the interval
+  };
+
+  /// Get the interval activity for a given flow
+  /// \param flowId the Flow identification
+  /// \returns the interval activity of the flow
+  FlowInterval& GetIntervalForFlow (FlowId flowId);
+
+  /// Write the activity of the flows since the last snapshot, and
+  /// forget the idle flows
+  void WriteSnapshot ();
+
+  /// Write the snapshot of one flow
+  /// \param flowId the Flow identification
+  /// \param stats the flow statistics
+  /// \param interval the flow activity at the last snapshot
+  /// \param evicted true if the flow is forgotten after this snapshot
+  void WriteFlowSnapshot (FlowId flowId, const FlowStats &stats, FlowInterval &interval, bool evicted);
+
+  /// Forget a flow
+  /// \param flowId the Flow identification
+  void RemoveFlow (FlowId flowId);
+
+  FlatHashMap<FlowId, FlowInterval> m_flowIntervals; //!< Activity of the flows in the current interval
+  AsyncFileWriter m_snapshotWriter;   //!< Snapshot file
+  SnapshotFormat m_snapshotFormat;    //!< Snapshot file format
+  Time m_snapshotInterval;            //!< Time between snapshots
+  Time m_lastSnapshotTime;            //!< Time of the last snapshot
+  EventId m_snapshotEvent;            //!< Next snapshot
+  Time m_idleFlowTimeout;             //!< Idle time after which a flow is forgotten
 };
 
 
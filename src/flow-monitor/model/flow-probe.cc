@@ -53,10 +53,28 @@ FlowProbe::DoDispose (void)
   Object::DoDispose ();
 }
 
+FlowProbe::FlowStats&
+FlowProbe::GetStatsForFlow (FlowId flowId)
+{
+  FlowStats *indexed = m_statsIndex.Find (flowId);
+  if (indexed != 0)
+    {
+      return *indexed;
+    }
+  Stats::iterator iter = m_stats.find (flowId);
+  if (iter != m_stats.end ())
+    {
+      return iter->second;
+    }
+  FlowStats &flow = m_stats[flowId];
+  m_statsIndex.Insert (flowId, &flow);
+  return flow;
+}
+
 void
 FlowProbe::AddPacketStats (FlowId flowId, uint32_t packetSize, Time delayFromFirstProbe)
 {
-  FlowStats &flow = m_stats[flowId];
+  FlowStats &flow = GetStatsForFlow (flowId);
   flow.delayFromFirstProbeSum += delayFromFirstProbe;
   flow.bytes += packetSize;
   ++flow.packets;
@@ -65,7 +83,7 @@ FlowProbe::AddPacketStats (FlowId flowId, uint32_t packetSize, Time delayFromFir
 void
 FlowProbe::AddPacketDropStats (FlowId flowId, uint32_t packetSize, uint32_t reasonCode)
 {
-  FlowStats &flow = m_stats[flowId];
+  FlowStats &flow = GetStatsForFlow (flowId);
 
   if (flow.packetsDropped.size () < reasonCode + 1)
     {
@@ -75,6 +93,13 @@ FlowProbe::AddPacketDropStats (FlowId flowId, uint32_t packetSize, uint32_t reas
   ++flow.packetsDropped[reasonCode];
   flow.bytesDropped[reasonCode] += packetSize;
 }
+
+void
+FlowProbe::RemoveStats (FlowId flowId)
+{
+  m_statsIndex.Remove (flowId);
+  m_stats.erase (flowId);
+}
  
 FlowProbe::Stats
 FlowProbe::GetStats () const 
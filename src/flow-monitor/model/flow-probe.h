@@ -89,6 +89,10 @@ public:
   /// \param packetSize the packet size
   /// \param reasonCode reason code for the drop
   void AddPacketDropStats (FlowId flowId, uint32_t packetSize, uint32_t reasonCode);
+  /// Forget the stats of a flow, e.g., when the FlowMonitor evicts an
+  /// idle flow
+  /// \param flowId the flow Identifier
+  void RemoveStats (FlowId flowId);
 
   /// Get the partial flow statistics stored in this probe.  With this
   /// information you can, for example, find out what is the delay
@@ -100,12 +104,20 @@ public:
   /// \param os the output stream
   /// \param indent number of spaces to use as base indentation level
   /// \param index FlowProbe index
-  void SerializeToXmlStream (std::ostream &os, int indent, uint32_t index) const;
+  virtual void SerializeToXmlStream (std::ostream &os, int indent, uint32_t index) const;
 
 protected:
   Ptr<FlowMonitor> m_flowMonitor; //!< the FlowMonitor instance
   Stats m_stats; //!< The flow stats
 
+private:
+  /// Get the stats for a given flow, created if needed
+  /// \param flowId the Flow identification
+  /// \returns the stats of the flow
+  FlowStats& GetStatsForFlow (FlowId flowId);
+
+  /// FlowId --> FlowStats in m_stats, for the recent flow ids
+  FlowIdIndex<FlowStats> m_statsIndex;
 };
 
 
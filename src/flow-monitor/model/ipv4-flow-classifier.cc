@@ -18,6 +18,8 @@
 // Author: Gustavo J. A. M. Carneiro  <gjc@inescporto.pt> <gjcarneiro@gmail.com>
 //
 
+#include <map>
+
 #include "ns3/packet.h"
 
 #include "ipv4-flow-classifier.h"
@@ -94,8 +96,19 @@ bool operator == (const Ipv4FlowClassifier::FiveTuple &t1,
 }
 
 
+uint32_t
+Ipv4FlowClassifier::FiveTupleHash::operator () (const FiveTuple &tuple) const
+{
+  uint64_t addresses = tuple.sourceAddress.Get ();
+  addresses = (addresses << 32) | tuple.destinationAddress.Get ();
+  uint64_t ports = tuple.protocol;
+  ports = (ports << 32) | (static_cast<uint32_t> (tuple.sourcePort) << 16) | tuple.destinationPort;
+  return FlatHashMapHash<uint64_t> () (addresses ^ (ports * 0x9e3779b97f4a7c15ULL));
+}
+
 
 Ipv4FlowClassifier::Ipv4FlowClassifier ()
+  : m_firstFlowId (0)
 {
 }
 
@@ -147,23 +160,32 @@ Ipv4FlowClassifier::Classify (const Ipv4Header &ipHeader, Ptr<const Packet> ipPa
   tuple.destinationPort = dstPort;
 
   // try to insert the tuple, but check if it already exists
-  std::pair<std::map<FiveTuple, FlowId>::iterator, bool> insert
-    = m_flowMap.insert (std::pair<FiveTuple, FlowId> (tuple, 0));
+  bool inserted;
+  FlowId &flowId = m_flowMap.Insert (tuple, 0, inserted);
 
   // if the insertion succeeded, we need to assign this tuple a new flow identifier
-  if (insert.second)
+  if (inserted)
     {
-      FlowId newFlowId = GetNewFlowId ();
-      insert.first->second = newFlowId;
-      m_flowPktIdMap[newFlowId] = 0;
+      flowId = GetNewFlowId ();
+      if (m_flowTuples.empty ())
+        {
+          m_firstFlowId = flowId;
+        }
+      if (flowId - m_firstFlowId >= m_flowPktIds.size ())
+        {
+          m_flowPktIds.resize (flowId - m_firstFlowId + 1, 0);
+          m_flowTuples.resize (flowId - m_firstFlowId + 1);
+        }
+      m_flowPktIds[flowId - m_firstFlowId] = 0;
+      m_flowTuples[flowId - m_firstFlowId] = tuple;
     }
   else
     {
-      m_flowPktIdMap[insert.first->second] ++;
+      m_flowPktIds[flowId - m_firstFlowId] ++;
     }
 
-  *out_flowId = insert.first->second;
-  *out_packetId = m_flowPktIdMap[*out_flowId];
+  *out_flowId = flowId;
+  *out_packetId = m_flowPktIds[flowId - m_firstFlowId];
 
   return true;
 }
@@ -172,12 +194,13 @@ Ipv4FlowClassifier::Classify (const Ipv4Header &ipHeader, Ptr<const Packet> ipPa
 Ipv4FlowClassifier::FiveTuple
 Ipv4FlowClassifier::FindFlow (FlowId flowId) const
 {
-  for (std::map<FiveTuple, FlowId>::const_iterator
-       iter = m_flowMap.begin (); iter != m_flowMap.end (); iter++)
+  if (flowId >= m_firstFlowId && flowId - m_firstFlowId < m_flowTuples.size ())
     {
-      if (iter->second == flowId)
+      const FiveTuple &tuple = m_flowTuples[flowId - m_firstFlowId];
+      const FlowId *found = m_flowMap.Find (tuple);
+      if (found != 0 && *found == flowId)
         {
-          return iter->first;
+          return tuple;
         }
     }
   NS_FATAL_ERROR ("Could not find the flow with ID " << flowId);
@@ -185,6 +208,33 @@ Ipv4FlowClassifier::FindFlow (FlowId flowId) const
   return retval;
 }
 
+void
+Ipv4FlowClassifier::RemoveFlow (FlowId flowId)
+{
+  if (flowId < m_firstFlowId || flowId - m_firstFlowId >= m_flowTuples.size ())
+    {
+      return;
+    }
+  const FiveTuple &tuple = m_flowTuples[flowId - m_firstFlowId];
+  const FlowId *found = m_flowMap.Find (tuple);
+  if (found != 0 && *found == flowId)
+    {
+      m_flowMap.Erase (tuple);
+    }
+  // forget the oldest flows once all of them are removed
+  while (!m_flowTuples.empty ())
+    {
+      found = m_flowMap.Find (m_flowTuples.front ());
+      if (found != 0 && *found == m_firstFlowId)
+        {
+          break;
+        }
+      m_flowTuples.pop_front ();
+      m_flowPktIds.pop_front ();
+      m_firstFlowId++;
+    }
+}
+
 void
 Ipv4FlowClassifier::SerializeToXmlStream (std::ostream &os, int indent) const
 {
@@ -192,9 +242,20 @@ Ipv4FlowClassifier::SerializeToXmlStream (std::ostream &os, int indent) const
 
   INDENT (indent); os << "<Ipv4FlowClassifier>\n";
 
+  // the flows are listed in the order of the tuples
+  std::map<FiveTuple, FlowId> flows;
+  for (uint32_t i = 0; i < m_flowTuples.size (); i++)
+    {
+      const FlowId *found = m_flowMap.Find (m_flowTuples[i]);
+      if (found != 0 && *found == m_firstFlowId + i)
+        {
+          flows[m_flowTuples[i]] = m_firstFlowId + i;
+        }
+    }
+
   indent += 2;
   for (std::map<FiveTuple, FlowId>::const_iterator
-       iter = m_flowMap.begin (); iter != m_flowMap.end (); iter++)
+       iter = flows.begin (); iter != flows.end (); iter++)
     {
       INDENT (indent);
       os << "<Flow flowId=\"" << iter->second << "\""
@@ -22,10 +22,11 @@
 #define IPV4_FLOW_CLASSIFIER_H
 
 #include <stdint.h>
-#include <map>
+#include <deque>
 
 #include "ns3/ipv4-header.h"
 #include "ns3/flow-classifier.h"
+#include "ns3/flat-hash-map.h"
 
 namespace ns3 {
 
@@ -49,6 +50,14 @@ public:
     uint16_t destinationPort;       //!< Destination port
   };
 
+  /// Hash function of the FiveTuple
+  struct FiveTupleHash
+  {
+    /// \param tuple the FiveTuple
+    /// \returns the hash of the FiveTuple
+    uint32_t operator () (const FiveTuple &tuple) const;
+  };
+
   Ipv4FlowClassifier ();
 
   /// \brief try to classify the packet into flow-id and packet-id
@@ -71,12 +80,18 @@ public:
 
   virtual void SerializeToXmlStream (std::ostream &os, int indent) const;
 
+  virtual void RemoveFlow (FlowId flowId);
+
 private:
 
   /// Map to Flows Identifiers to FlowIds
-  std::map<FiveTuple, FlowId> m_flowMap;
-  /// Map to FlowIds to FlowPacketId
-  std::map<FlowId, FlowPacketId> m_flowPktIdMap;
+  FlatHashMap<FiveTuple, FlowId, FiveTupleHash> m_flowMap;
+  /// FlowId - m_firstFlowId --> FlowPacketId of the last packet of the flow
+  std::deque<FlowPacketId> m_flowPktIds;
+  /// FlowId - m_firstFlowId --> Flow Identifiers
+  std::deque<FiveTuple> m_flowTuples;
+  /// FlowId of the oldest flow in m_flowPktIds and m_flowTuples
+  FlowId m_firstFlowId;
 
 };
 
@@ -0,0 +1,272 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <algorithm>
+#include <cmath>
+
+#include "quantile-sketch.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("QuantileSketch");
+
+const double QuantileSketch::MIN_VALUE = 1e-12;
+
+QuantileSketch::QuantileSketch (double relativeAccuracy, uint32_t maxBins)
+  : m_relativeAccuracy (relativeAccuracy),
+    m_maxBins (std::max (maxBins, 1U)),
+    m_offset (0),
+    m_zeroCount (0),
+    m_count (0),
+    m_min (0),
+    m_max (0)
+{
+  NS_ASSERT (relativeAccuracy > 0 && relativeAccuracy < 1);
+  m_gamma = (1 + relativeAccuracy) / (1 - relativeAccuracy);
+  m_logGamma = std::log (m_gamma);
+}
+
+int32_t
+QuantileSketch::GetIndex (double value) const
+{
+  return static_cast<int32_t> (std::ceil (std::log (value) / m_logGamma));
+}
+
+double
+QuantileSketch::GetBinValue (int32_t index) const
+{
+  // the values of the bin are in (gamma^(index-1), gamma^index]: this
+  // value is within the relative accuracy of both bounds
+  return 2 * std::exp (index * m_logGamma) / (1 + m_gamma);
+}
+
+void
+QuantileSketch::SetRange (int32_t low, int32_t high)
+{
+  if (static_cast<uint32_t> (high - low) >= m_maxBins)
+    {
+      // merge the lowest bins, to keep the upper quantiles accurate
+      low = high - m_maxBins + 1;
+    }
+  if (m_bins.empty ())
+    {
+      m_offset = low;
+      m_bins.assign (high - low + 1, 0);
+    }
+  else if (low == m_offset)
+    {
+      m_bins.resize (high - low + 1, 0);
+    }
+  else
+    {
+      NS_LOG_LOGIC ("Moving the bins from " << m_offset << " to " << low);
+      std::vector<uint64_t> bins (high - low + 1, 0);
+      for (uint32_t i = 0; i < m_bins.size (); i++)
+        {
+          bins[std::max (m_offset + static_cast<int32_t> (i), low) - low] += m_bins[i];
+        }
+      m_bins.swap (bins);
+      m_offset = low;
+    }
+}
+
+void
+QuantileSketch::AddToBin (int32_t index, uint64_t count)
+{
+  int32_t low = index;
+  int32_t high = index;
+  if (!m_bins.empty ())
+    {
+      low = std::min (index, m_offset);
+      high = std::max (index, static_cast<int32_t> (m_offset + m_bins.size () - 1));
+    }
+  SetRange (low, high);
+  m_bins[std::max (index, m_offset) - m_offset] += count;
+}
+
+void
+QuantileSketch::AddValue (double value)
+{
+  if (m_count == 0 || value < m_min)
+    {
+      m_min = value;
+    }
+  if (m_count == 0 || value > m_max)
+    {
+      m_max = value;
+    }
+  m_count++;
+  if (value < MIN_VALUE)
+    {
+      m_zeroCount++;
+    }
+  else
+    {
+      AddToBin (GetIndex (value), 1);
+    }
+}
+
+void
+QuantileSketch::Merge (const QuantileSketch &other)
+{
+  NS_ASSERT_MSG (other.m_relativeAccuracy == m_relativeAccuracy,
+                 "Cannot merge sketches of different accuracies");
+  if (other.m_count == 0)
+    {
+      return;
+    }
+  if (m_count == 0 || other.m_min < m_min)
+    {
+      m_min = other.m_min;
+    }
+  if (m_count == 0 || other.m_max > m_max)
+    {
+      m_max = other.m_max;
+    }
+  m_count += other.m_count;
+  m_zeroCount += other.m_zeroCount;
+  if (other.m_bins.empty ())
+    {
+      return;
+    }
+  // the bins are moved at most once, to the union of both ranges
+  int32_t low = other.m_offset;
+  int32_t high = static_cast<int32_t> (other.m_offset + other.m_bins.size () - 1);
+  if (!m_bins.empty ())
+    {
+      low = std::min (low, m_offset);
+      high = std::max (high, static_cast<int32_t> (m_offset + m_bins.size () - 1));
+    }
+  SetRange (low, high);
+  for (uint32_t i = 0; i < other.m_bins.size (); i++)
+    {
+      int32_t index = other.m_offset + static_cast<int32_t> (i);
+      m_bins[std::max (index, m_offset) - m_offset] += other.m_bins[i];
+    }
+}
+
+void
+QuantileSketch::Clear (void)
+{
+  m_bins.clear ();
+  m_offset = 0;
+  m_zeroCount = 0;
+  m_count = 0;
+  m_min = 0;
+  m_max = 0;
+}
+
+uint64_t
+QuantileSketch::GetCount (void) const
+{
+  return m_count;
+}
+
+double
+QuantileSketch::GetMin (void) const
+{
+  return m_min;
+}
+
+double
+QuantileSketch::GetMax (void) const
+{
+  return m_max;
+}
+
+double
+QuantileSketch::GetRelativeAccuracy (void) const
+{
+  return m_relativeAccuracy;
+}
+
+uint32_t
+QuantileSketch::GetNBins (void) const
+{
+  return m_bins.size ();
+}
+
+double
+QuantileSketch::GetQuantile (double quantile) const
+{
+  if (m_count == 0)
+    {
+      return 0;
+    }
+  if (quantile <= 0)
+    {
+      return m_min;
+    }
+  if (quantile >= 1)
+    {
+      return m_max;
+    }
+  double rank = quantile * (m_count - 1);
+  uint64_t seen = m_zeroCount;
+  if (rank < seen)
+    {
+      return m_min;
+    }
+  for (uint32_t i = 0; i < m_bins.size (); i++)
+    {
+      seen += m_bins[i];
+      if (rank < seen)
+        {
+          double value = GetBinValue (m_offset + static_cast<int32_t> (i));
+          return std::min (std::max (value, m_min), m_max);
+        }
+    }
+  return m_max;
+}
+
+void
+QuantileSketch::SerializeToXmlStream (std::ostream &os, int indent, std::string elementName) const
+{
+#define INDENT(level) for (int __xpto = 0; __xpto < level; __xpto++) os << ' ';
+
+  INDENT (indent); os << "<" << elementName
+                      << " count=\"" << m_count << "\""
+                      << " min=\"" << m_min << "\""
+                      << " max=\"" << m_max << "\""
+                      << " relativeAccuracy=\"" << m_relativeAccuracy << "\""
+                      << " zeroCount=\"" << m_zeroCount << "\""
+                      << " p50=\"" << GetQuantile (0.5) << "\""
+                      << " p90=\"" << GetQuantile (0.9) << "\""
+                      << " p99=\"" << GetQuantile (0.99) << "\""
+                      << " p999=\"" << GetQuantile (0.999) << "\""
+                      << " >\n";
+  indent += 2;
+  for (uint32_t i = 0; i < m_bins.size (); i++)
+    {
+      if (m_bins[i])
+        {
+          int32_t index = m_offset + static_cast<int32_t> (i);
+          INDENT (indent);
+          os << "<bin"
+             << " index=\"" << index << "\""
+             << " end=\"" << std::exp (index * m_logGamma) << "\""
+             << " count=\"" << m_bins[i] << "\""
+             << " />\n";
+        }
+    }
+  indent -= 2;
+  INDENT (indent); os << "</" << elementName << ">\n";
+#undef INDENT
+}
+
+} // namespace ns3
@@ -0,0 +1,386 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <algorithm>
+
+#include "ns3/wifi-flow-probe.h"
+#include "ns3/flow-monitor.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/regular-wifi-mac.h"
+#include "ns3/edca-txop-n.h"
+#include "ns3/mac-low.h"
+#include "ns3/ampdu-tag.h"
+#include "ns3/ampdu-subframe-header.h"
+#include "ns3/directional-antenna.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WifiFlowProbe");
+
+const uint8_t WifiFlowProbe::NON_QOS_TID;
+
+WifiFlowProbe::LinkStats::LinkStats ()
+  : tid (0),
+    txMpdus (0),
+    txBytes (0),
+    txRetries (0),
+    txAmpdus (0),
+    txAmpduMpdus (0),
+    txAmpduBytes (0),
+    maxAmpduMpdus (0),
+    blockAcks (0),
+    missedBlockAcks (0),
+    baAckedMpdus (0),
+    baLostMpdus (0),
+    rxMpdus (0),
+    rxBytes (0),
+    rxRetries (0)
+{
+}
+
+WifiFlowProbe::SectorStats::SectorStats ()
+  : sector (0),
+    rxFrames (0),
+    snrSum (0),
+    snrMin (0),
+    snrMax (0),
+    slsCompleted (0)
+{
+}
+
+WifiFlowProbe::WifiFlowProbe (Ptr<FlowMonitor> monitor, Ptr<WifiNetDevice> device)
+  : FlowProbe (monitor),
+    m_device (device)
+{
+  NS_LOG_FUNCTION (this << device);
+
+  m_address = Mac48Address::ConvertFrom (device->GetAddress ());
+
+  if (!device->GetPhy ()->TraceConnectWithoutContext ("MonitorSnifferRx",
+                                                      MakeCallback (&WifiFlowProbe::RxLogger, Ptr<WifiFlowProbe> (this))))
+    {
+      NS_FATAL_ERROR ("trace fail");
+    }
+
+  Ptr<RegularWifiMac> mac = DynamicCast<RegularWifiMac> (device->GetMac ());
+  if (mac == 0)
+    {
+      NS_LOG_WARN ("No MAC trace sources on " << device->GetMac ()->GetInstanceTypeId ().GetName ());
+      return;
+    }
+  // the DCF and the EDCA queues share the MacLow of the device
+  Ptr<MacLow> low = mac->GetBEQueue ()->Low ();
+  if (!low->TraceConnectWithoutContext ("TxMpdu",
+                                        MakeCallback (&WifiFlowProbe::TxMpduLogger, Ptr<WifiFlowProbe> (this))))
+    {
+      NS_FATAL_ERROR ("trace fail");
+    }
+  if (!low->TraceConnectWithoutContext ("TxAmpdu",
+                                        MakeCallback (&WifiFlowProbe::TxAmpduLogger, Ptr<WifiFlowProbe> (this))))
+    {
+      NS_FATAL_ERROR ("trace fail");
+    }
+  Ptr<EdcaTxopN> queues[] = { mac->GetVOQueue (), mac->GetVIQueue (), mac->GetBEQueue (), mac->GetBKQueue () };
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      if (!queues[i]->TraceConnectWithoutContext ("BlockAckStatus",
+                                                  MakeCallback (&WifiFlowProbe::BlockAckLogger, Ptr<WifiFlowProbe> (this))))
+        {
+          NS_FATAL_ERROR ("trace fail");
+        }
+    }
+  Ptr<DmgWifiMac> dmgMac = DynamicCast<DmgWifiMac> (mac);
+  if (dmgMac != 0)
+    {
+      if (!dmgMac->TraceConnectWithoutContext ("SLSCompleted",
+                                               MakeCallback (&WifiFlowProbe::SlsLogger, Ptr<WifiFlowProbe> (this))))
+        {
+          NS_FATAL_ERROR ("trace fail");
+        }
+    }
+}
+
+WifiFlowProbe::~WifiFlowProbe ()
+{
+}
+
+/* static */
+TypeId
+WifiFlowProbe::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::WifiFlowProbe")
+    .SetParent<FlowProbe> ()
+    .SetGroupName ("FlowMonitor")
+    // No AddConstructor because this class has no default constructor.
+    ;
+
+  return tid;
+}
+
+void
+WifiFlowProbe::DoDispose ()
+{
+  m_device = 0;
+  FlowProbe::DoDispose ();
+}
+
+uint64_t
+WifiFlowProbe::GetKey (Mac48Address peer, uint8_t id)
+{
+  uint8_t buffer[6];
+  peer.CopyTo (buffer);
+  uint64_t key = 0;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      key = (key << 8) | buffer[i];
+    }
+  return (key << 8) | id;
+}
+
+WifiFlowProbe::LinkStats &
+WifiFlowProbe::GetLink (Mac48Address peer, uint8_t tid)
+{
+  bool inserted;
+  uint32_t &index = m_linkIndex.Insert (GetKey (peer, tid), m_links.size (), inserted);
+  if (inserted)
+    {
+      m_links.push_back (LinkStats ());
+      m_links.back ().peer = peer;
+      m_links.back ().tid = tid;
+    }
+  return m_links[index];
+}
+
+WifiFlowProbe::SectorStats &
+WifiFlowProbe::GetSector (Mac48Address peer, uint8_t sector)
+{
+  bool inserted;
+  uint32_t &index = m_sectorIndex.Insert (GetKey (peer, sector), m_sectors.size (), inserted);
+  if (inserted)
+    {
+      m_sectors.push_back (SectorStats ());
+      m_sectors.back ().peer = peer;
+      m_sectors.back ().sector = sector;
+    }
+  return m_sectors[index];
+}
+
+void
+WifiFlowProbe::TxMpduLogger (const WifiMacHeader &hdr, uint32_t size)
+{
+  if (!hdr.IsData ())
+    {
+      return;
+    }
+  LinkStats &link = GetLink (hdr.GetAddr1 (), hdr.IsQosData () ? hdr.GetQosTid () : NON_QOS_TID);
+  link.txMpdus++;
+  link.txBytes += size;
+  if (hdr.IsRetry ())
+    {
+      link.txRetries++;
+    }
+}
+
+void
+WifiFlowProbe::TxAmpduLogger (Mac48Address recipient, uint8_t tid, uint32_t nMpdus, uint32_t size)
+{
+  LinkStats &link = GetLink (recipient, tid);
+  link.txAmpdus++;
+  link.txAmpduMpdus += nMpdus;
+  link.txAmpduBytes += size;
+  link.maxAmpduMpdus = std::max (link.maxAmpduMpdus, nMpdus);
+}
+
+void
+WifiFlowProbe::BlockAckLogger (Mac48Address recipient, uint8_t tid, uint32_t nSuccessfulMpdus, uint32_t nFailedMpdus)
+{
+  LinkStats &link = GetLink (recipient, tid);
+  if (nSuccessfulMpdus == 0 && nFailedMpdus > 0)
+    {
+      link.missedBlockAcks++;
+    }
+  else
+    {
+      link.blockAcks++;
+    }
+  link.baAckedMpdus += nSuccessfulMpdus;
+  link.baLostMpdus += nFailedMpdus;
+}
+
+void
+WifiFlowProbe::RxLogger (Ptr<const Packet> packet, uint16_t channelFreqMhz, uint16_t channelNumber,
+                         uint32_t rate, WifiPreamble preamble, WifiTxVector txVector,
+                         struct mpduInfo aMpdu, struct signalNoiseDbm signalNoise)
+{
+  WifiMacHeader hdr;
+  uint32_t size = packet->GetSize ();
+  AmpduTag ampdu;
+  if (packet->PeekPacketTag (ampdu))
+    {
+      // the subframes of an A-MPDU are received with their delimiter
+      // and their padding
+      Ptr<Packet> mpdu = packet->Copy ();
+      AmpduSubframeHeader delimiter;
+      mpdu->RemoveHeader (delimiter);
+      mpdu->PeekHeader (hdr);
+      size = delimiter.GetLength ();
+    }
+  else
+    {
+      packet->PeekHeader (hdr);
+    }
+  // the control frames, e.g., the acks, do not identify their transmitter
+  if (!hdr.IsData () && !hdr.IsMgt ())
+    {
+      return;
+    }
+  if (hdr.GetAddr1 () != m_address && !hdr.GetAddr1 ().IsGroup ())
+    {
+      return;
+    }
+
+  uint8_t sectorId = 0;
+  Ptr<DirectionalAntenna> antenna = m_device->GetPhy ()->GetDirectionalAntenna ();
+  if (antenna != 0)
+    {
+      sectorId = antenna->GetCurrentRxSectorID ();
+    }
+  double snr = signalNoise.signal - signalNoise.noise;
+  SectorStats &sector = GetSector (hdr.GetAddr2 (), sectorId);
+  if (sector.rxFrames == 0 || snr < sector.snrMin)
+    {
+      sector.snrMin = snr;
+    }
+  if (sector.rxFrames == 0 || snr > sector.snrMax)
+    {
+      sector.snrMax = snr;
+    }
+  sector.rxFrames++;
+  sector.snrSum += snr;
+
+  if (hdr.IsData ())
+    {
+      LinkStats &link = GetLink (hdr.GetAddr2 (), hdr.IsQosData () ? hdr.GetQosTid () : NON_QOS_TID);
+      link.rxMpdus++;
+      link.rxBytes += size;
+      if (hdr.IsRetry ())
+        {
+          link.rxRetries++;
+        }
+    }
+}
+
+void
+WifiFlowProbe::SlsLogger (Mac48Address peer, ChannelAccessPeriod accessPeriod, SECTOR_ID sector, ANTENNA_ID antenna)
+{
+  NS_LOG_FUNCTION (this << peer << accessPeriod << static_cast<uint32_t> (sector) << static_cast<uint32_t> (antenna));
+  GetSector (peer, sector).slsCompleted++;
+}
+
+const std::vector<WifiFlowProbe::LinkStats> &
+WifiFlowProbe::GetLinkStats (void) const
+{
+  return m_links;
+}
+
+WifiFlowProbe::LinkStats
+WifiFlowProbe::GetLinkStats (Mac48Address peer, uint8_t tid) const
+{
+  uint32_t const *index = m_linkIndex.Find (GetKey (peer, tid));
+  if (index == 0)
+    {
+      LinkStats link;
+      link.peer = peer;
+      link.tid = tid;
+      return link;
+    }
+  return m_links[*index];
+}
+
+const std::vector<WifiFlowProbe::SectorStats> &
+WifiFlowProbe::GetSectorStats (void) const
+{
+  return m_sectors;
+}
+
+WifiFlowProbe::SectorStats
+WifiFlowProbe::GetSectorStats (Mac48Address peer, uint8_t sector) const
+{
+  uint32_t const *index = m_sectorIndex.Find (GetKey (peer, sector));
+  if (index == 0)
+    {
+      SectorStats stats;
+      stats.peer = peer;
+      stats.sector = sector;
+      return stats;
+    }
+  return m_sectors[*index];
+}
+
+void
+WifiFlowProbe::SerializeToXmlStream (std::ostream &os, int indent, uint32_t index) const
+{
+  #define INDENT(level) for (int __xpto = 0; __xpto < level; __xpto++) os << ' ';
+
+  INDENT (indent); os << "<FlowProbe index=\"" << index << "\""
+                      << " wifiAddress=\"" << m_address << "\">\n";
+
+  indent += 2;
+
+  for (std::vector<LinkStats>::const_iterator iter = m_links.begin (); iter != m_links.end (); iter++)
+    {
+      INDENT (indent);
+      os << "<WifiLinkStats "
+         << " peer=\"" << iter->peer << "\""
+         << " tid=\"" << static_cast<uint32_t> (iter->tid) << "\""
+         << " txMpdus=\"" << iter->txMpdus << "\""
+         << " txBytes=\"" << iter->txBytes << "\""
+         << " txRetries=\"" << iter->txRetries << "\""
+         << " txAmpdus=\"" << iter->txAmpdus << "\""
+         << " txAmpduMpdus=\"" << iter->txAmpduMpdus << "\""
+         << " txAmpduBytes=\"" << iter->txAmpduBytes << "\""
+         << " maxAmpduMpdus=\"" << iter->maxAmpduMpdus << "\""
+         << " blockAcks=\"" << iter->blockAcks << "\""
+         << " missedBlockAcks=\"" << iter->missedBlockAcks << "\""
+         << " baAckedMpdus=\"" << iter->baAckedMpdus << "\""
+         << " baLostMpdus=\"" << iter->baLostMpdus << "\""
+         << " rxMpdus=\"" << iter->rxMpdus << "\""
+         << " rxBytes=\"" << iter->rxBytes << "\""
+         << " rxRetries=\"" << iter->rxRetries << "\""
+         << " />\n";
+    }
+  for (std::vector<SectorStats>::const_iterator iter = m_sectors.begin (); iter != m_sectors.end (); iter++)
+    {
+      INDENT (indent);
+      os << "<WifiSectorStats "
+         << " peer=\"" << iter->peer << "\""
+         << " sector=\"" << static_cast<uint32_t> (iter->sector) << "\""
+         << " rxFrames=\"" << iter->rxFrames << "\""
+         << " snrMean=\"" << (iter->rxFrames ? iter->snrSum / iter->rxFrames : 0) << "\""
+         << " snrMin=\"" << iter->snrMin << "\""
+         << " snrMax=\"" << iter->snrMax << "\""
+         << " slsCompleted=\"" << iter->slsCompleted << "\""
+         << " />\n";
+    }
+  indent -= 2;
+  INDENT (indent); os << "</FlowProbe>\n";
+  #undef INDENT
+}
+
+} // namespace ns3
@@ -0,0 +1,326 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/boolean.h"
+#include "ns3/flow-monitor.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/packet.h"
+
+using namespace ns3;
+
+/**
+ * A probe which is not attached to any node: the test reports the
+ * packet events itself.
+ */
+class SnapshotTestProbe : public FlowProbe
+{
+public:
+  /**
+   * \param monitor the flow monitor
+   */
+  SnapshotTestProbe (Ptr<FlowMonitor> monitor)
+    : FlowProbe (monitor)
+  {
+  }
+};
+
+/**
+ * Check the periodic snapshots of the FlowMonitor.
+ *
+ * Flow 1 sends a packet every 100 ms from 50 ms to 3 s, received 10 ms later,
+ * except the packets sent at 1.55 s and 2.55 s which are lost.  Flow 2
+ * sends 5 packets during the first 0.5 s, and is then idle.
+ */
+class FlowMonitorSnapshotTestCase : public TestCase
+{
+public:
+  /**
+   * \param format the format of the snapshots
+   */
+  FlowMonitorSnapshotTestCase (FlowMonitor::SnapshotFormat format);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Send a packet
+   * \param flowId the flow
+   * \param packetId the packet
+   * \param lost true if the packet is never received
+   */
+  void Send (FlowId flowId, FlowPacketId packetId, bool lost);
+  /**
+   * Receive a packet
+   * \param flowId the flow
+   * \param packetId the packet
+   */
+  void Receive (FlowId flowId, FlowPacketId packetId);
+
+  FlowMonitor::SnapshotFormat m_format;  //!< The format of the snapshots
+  Ptr<FlowMonitor> m_monitor;           //!< The monitor
+  Ptr<FlowProbe> m_probe;               //!< The probe
+};
+
+FlowMonitorSnapshotTestCase::FlowMonitorSnapshotTestCase (FlowMonitor::SnapshotFormat format)
+  : TestCase (format == FlowMonitor::SNAPSHOT_CSV ? "Check the CSV snapshots" : "Check the binary snapshots"),
+    m_format (format)
+{
+}
+
+void
+FlowMonitorSnapshotTestCase::Send (FlowId flowId, FlowPacketId packetId, bool lost)
+{
+  m_monitor->ReportFirstTx (m_probe, flowId, packetId, 1000);
+  if (!lost)
+    {
+      Simulator::Schedule (MilliSeconds (10), &FlowMonitorSnapshotTestCase::Receive, this, flowId, packetId);
+    }
+}
+
+void
+FlowMonitorSnapshotTestCase::Receive (FlowId flowId, FlowPacketId packetId)
+{
+  m_monitor->ReportLastRx (m_probe, flowId, packetId, 1000);
+}
+
+void
+FlowMonitorSnapshotTestCase::DoRun (void)
+{
+  m_monitor = CreateObject<FlowMonitor> ();
+  m_monitor->SetAttribute ("MaxPerHopDelay", TimeValue (Seconds (0.2)));
+  m_monitor->SetAttribute ("IdleFlowTimeout", TimeValue (Seconds (1)));
+  m_monitor->SetAttribute ("QuantileSketches", BooleanValue (true));
+  m_probe = CreateObject<SnapshotTestProbe> (m_monitor);
+  m_monitor->StartRightNow ();
+  std::string filename = CreateTempDirFilename ("snapshots");
+  NS_TEST_ASSERT_MSG_EQ (m_monitor->StartSnapshots (Seconds (1), filename, m_format), true,
+                         "Cannot create the snapshot file");
+  for (uint32_t i = 0; i < 30; i++)
+    {
+      Simulator::Schedule (MilliSeconds (100 * i + 50), &FlowMonitorSnapshotTestCase::Send, this,
+                           1, i, i == 15 || i == 25);
+    }
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      Simulator::Schedule (MilliSeconds (100 * i + 50), &FlowMonitorSnapshotTestCase::Send, this, 2, i, false);
+    }
+  Simulator::Stop (Seconds (3.5));
+  Simulator::Run ();
+  m_monitor->StopSnapshots ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_monitor->GetFlowStats ().size (), 1, "The idle flow was not forgotten");
+  const FlowMonitor::FlowStats &stats = m_monitor->GetFlowStats ().begin ()->second;
+  NS_TEST_EXPECT_MSG_EQ (stats.delaySketch.GetCount (), 28, "Wrong number of delays");
+  NS_TEST_EXPECT_MSG_EQ (stats.delayHistogram.GetNBins (), 0, "Histogram used with the sketches");
+  std::string xml = m_monitor->SerializeToXmlString (0, true, false);
+  NS_TEST_EXPECT_MSG_NE (xml.find ("<delaySketch count=\"28\""), std::string::npos, "No delay sketch in the XML");
+
+  // time, flowId, txPackets, txBytes, rxPackets, rxBytes, lostPackets,
+  // evicted, throughput, delayMean, delayP50, delayP95, delayP99,
+  // delayP999, jitterP50, jitterP99
+  std::vector<std::vector<double> > rows;
+  std::ifstream file (filename.c_str (), std::ios::binary);
+  if (m_format == FlowMonitor::SNAPSHOT_CSV)
+    {
+      std::string line;
+      std::getline (file, line);
+      NS_TEST_EXPECT_MSG_EQ (line.substr (0, 12), "time,flowId,", "Wrong CSV header");
+      while (std::getline (file, line))
+        {
+          std::istringstream is (line);
+          std::vector<double> row;
+          double value;
+          char comma;
+          while (is >> value)
+            {
+              row.push_back (value);
+              is >> comma;
+            }
+          NS_TEST_ASSERT_MSG_EQ (row.size (), 16, "Wrong CSV line " << line);
+          rows.push_back (row);
+        }
+    }
+  else
+    {
+      uint32_t magic;
+      uint16_t version[2];
+      file.read (reinterpret_cast<char *> (&magic), sizeof (magic));
+      file.read (reinterpret_cast<char *> (version), sizeof (version));
+      NS_TEST_ASSERT_MSG_EQ (magic, FlowMonitor::SNAPSHOT_MAGIC, "Wrong magic");
+      NS_TEST_ASSERT_MSG_EQ (version[0], FlowMonitor::SNAPSHOT_VERSION, "Wrong version");
+      NS_TEST_ASSERT_MSG_EQ (version[1], FlowMonitor::SNAPSHOT_RECORD_SIZE, "Wrong record size");
+      uint8_t record[FlowMonitor::SNAPSHOT_RECORD_SIZE];
+      while (file.read (reinterpret_cast<char *> (record), sizeof (record)))
+        {
+          int64_t time;
+          uint32_t u32[2];
+          uint64_t u64;
+          double doubles[8];
+          std::vector<double> row;
+          std::memcpy (&time, record, 8);
+          row.push_back (time / 1e9);
+          std::memcpy (u32, record + 8, 8);
+          row.push_back (u32[0]);
+          row.push_back (u32[1]);
+          std::memcpy (&u64, record + 16, 8);
+          row.push_back (u64);
+          std::memcpy (u32, record + 24, 4);
+          row.push_back (u32[0]);
+          std::memcpy (&u64, record + 28, 8);
+          row.push_back (u64);
+          std::memcpy (u32, record + 36, 8);
+          row.push_back (u32[0]);
+          row.push_back (u32[1]);
+          std::memcpy (doubles, record + 44, sizeof (doubles));
+          row.insert (row.end (), doubles, doubles + 8);
+          rows.push_back (row);
+        }
+      NS_TEST_EXPECT_MSG_EQ (file.gcount (), 0, "Truncated record");
+    }
+
+  // flow 1 in [0,1), [1,2) and [2,3) but not in [3,3.5) where it is
+  // inactive, and flow 2 in [0,1) and once more when forgotten at 2 s
+  NS_TEST_ASSERT_MSG_EQ (rows.size (), 5, "Wrong number of snapshots");
+  double expected[5][8] = {
+    { 1, 1, 10, 10000, 10, 10000, 0, 0 },
+    { 1, 2, 5, 5000, 5, 5000, 0, 0 },
+    { 2, 1, 10, 10000, 9, 9000, 1, 0 },
+    { 2, 2, 0, 0, 0, 0, 0, 1 },
+    { 3, 1, 10, 10000, 9, 9000, 1, 0 },
+  };
+  for (uint32_t i = 0; i < rows.size (); i++)
+    {
+      for (uint32_t j = 0; j < 8; j++)
+        {
+          NS_TEST_EXPECT_MSG_EQ_TOL (rows[i][j], expected[i][j], 1e-9, "Wrong column " << j << " of snapshot " << i);
+        }
+    }
+  // the percentiles are known within 1%, and all the delays are 10 ms
+  NS_TEST_EXPECT_MSG_EQ_TOL (rows[0][8], 80000, 1e-6, "Wrong throughput");
+  NS_TEST_EXPECT_MSG_EQ_TOL (rows[0][9], 0.01, 1e-9, "Wrong mean delay");
+  NS_TEST_EXPECT_MSG_EQ_TOL (rows[0][10], 0.01, 1e-4, "Wrong median delay");
+  NS_TEST_EXPECT_MSG_EQ_TOL (rows[0][12], 0.01, 1e-4, "Wrong 99th percentile delay");
+  NS_TEST_EXPECT_MSG_EQ_TOL (rows[0][13], 0.01, 1e-4, "Wrong 99.9th percentile delay");
+  NS_TEST_EXPECT_MSG_EQ (rows[0][15], 0, "Wrong 99th percentile jitter");
+  NS_TEST_EXPECT_MSG_EQ (rows[3][10], 0, "Delay percentile without packets");
+
+  Simulator::Destroy ();
+  m_monitor = 0;
+  m_probe = 0;
+}
+
+/**
+ * Check that the classifier and the flow id indexes forget the removed
+ * flows.
+ */
+class FlowMonitorRemoveFlowTestCase : public TestCase
+{
+public:
+  FlowMonitorRemoveFlowTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Classify a UDP packet.
+   * \param classifier the classifier
+   * \param port the source port of the packet
+   * \returns the flow id of the packet
+   */
+  FlowId Classify (Ptr<Ipv4FlowClassifier> classifier, uint16_t port);
+};
+
+FlowMonitorRemoveFlowTestCase::FlowMonitorRemoveFlowTestCase ()
+  : TestCase ("Check that the removed flows are forgotten")
+{
+}
+
+FlowId
+FlowMonitorRemoveFlowTestCase::Classify (Ptr<Ipv4FlowClassifier> classifier, uint16_t port)
+{
+  Ipv4Header ipHeader;
+  ipHeader.SetSource (Ipv4Address ("10.0.0.1"));
+  ipHeader.SetDestination (Ipv4Address ("10.0.0.2"));
+  ipHeader.SetProtocol (17);
+  uint8_t ports[4] = { static_cast<uint8_t> (port >> 8), static_cast<uint8_t> (port), 0, 9 };
+  Ptr<Packet> payload = Create<Packet> (ports, sizeof (ports));
+  FlowId flowId = 0;
+  FlowPacketId packetId = 0;
+  NS_TEST_EXPECT_MSG_EQ (classifier->Classify (ipHeader, payload, &flowId, &packetId), true,
+                         "Packet not classified");
+  return flowId;
+}
+
+void
+FlowMonitorRemoveFlowTestCase::DoRun (void)
+{
+  Ptr<Ipv4FlowClassifier> classifier = Create<Ipv4FlowClassifier> ();
+  FlowId first = Classify (classifier, 1000);
+  FlowId second = Classify (classifier, 1001);
+  FlowId third = Classify (classifier, 1002);
+  NS_TEST_EXPECT_MSG_EQ (Classify (classifier, 1000), first, "Wrong flow id");
+
+  classifier->RemoveFlow (second);
+  classifier->RemoveFlow (first);
+  NS_TEST_EXPECT_MSG_EQ (classifier->FindFlow (third).sourcePort, 1002, "Wrong remaining flow");
+  FlowId again = Classify (classifier, 1000);
+  NS_TEST_EXPECT_MSG_GT (again, third, "A removed flow kept its flow id");
+  NS_TEST_EXPECT_MSG_EQ (Classify (classifier, 1002), third, "Wrong flow id after removals");
+  std::ostringstream xml;
+  classifier->SerializeToXmlStream (xml, 0);
+  NS_TEST_EXPECT_MSG_EQ (xml.str ().find ("sourcePort=\"1001\""), std::string::npos,
+                         "Removed flow in the XML");
+
+  // the window of the index follows the oldest flow not removed
+  FlowIdIndex<uint32_t> index;
+  uint32_t stats[4];
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      index.Insert (i + 1, &stats[i]);
+    }
+  index.Remove (2);
+  NS_TEST_EXPECT_MSG_EQ (index.GetSize (), 4, "Gap removed from the index");
+  index.Remove (1);
+  NS_TEST_EXPECT_MSG_EQ (index.GetSize (), 2, "Oldest flows not removed from the index");
+  NS_TEST_EXPECT_MSG_EQ (index.Find (3), &stats[2], "Wrong flow in the index");
+  NS_TEST_EXPECT_MSG_EQ (index.Find (1), 0, "Removed flow in the index");
+  index.Remove (4);
+  index.Remove (3);
+  NS_TEST_EXPECT_MSG_EQ (index.GetSize (), 0, "Index not empty");
+  index.Insert (MAX_INDEXED_FLOW_ID + 10, &stats[0]);
+  NS_TEST_EXPECT_MSG_EQ (index.Find (MAX_INDEXED_FLOW_ID + 10), &stats[0], "Large flow id not indexed");
+}
+
+class FlowMonitorSnapshotTestSuite : public TestSuite
+{
+public:
+  FlowMonitorSnapshotTestSuite ()
+    : TestSuite ("flow-monitor-snapshot", UNIT)
+  {
+    AddTestCase (new FlowMonitorSnapshotTestCase (FlowMonitor::SNAPSHOT_CSV), TestCase::QUICK);
+    AddTestCase (new FlowMonitorSnapshotTestCase (FlowMonitor::SNAPSHOT_BINARY), TestCase::QUICK);
+    AddTestCase (new FlowMonitorRemoveFlowTestCase (), TestCase::QUICK);
+  }
+};
+
+static FlowMonitorSnapshotTestSuite g_flowMonitorSnapshotTestSuite;
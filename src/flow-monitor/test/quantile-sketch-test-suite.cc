@@ -0,0 +1,156 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation;
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "ns3/quantile-sketch.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * Compare the quantiles of sketches with the exact quantiles of delays
+ * spread over several orders of magnitude, with a heavy tail.
+ */
+class QuantileSketchTestCase : public TestCase
+{
+public:
+  QuantileSketchTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+QuantileSketchTestCase::QuantileSketchTestCase ()
+  : TestCase ("Check the accuracy of the quantiles, merged or not")
+{
+}
+
+void
+QuantileSketchTestCase::DoRun (void)
+{
+  QuantileSketch all (0.01);
+  QuantileSketch halves[2] = { QuantileSketch (0.01), QuantileSketch (0.01) };
+  std::vector<double> values;
+  uint32_t random = 1;
+  for (uint32_t i = 0; i < 100000; i++)
+    {
+      random = random * 1103515245 + 12345;
+      // from 1 us to about 100 ms, most of them under 100 us
+      double value = 1e-6 * std::exp (-std::log ((random >> 8) / 16777216.0 + 1e-6));
+      value = i % 50 == 0 ? 0 : value;
+      values.push_back (value);
+      all.AddValue (value);
+      halves[i % 2].AddValue (value);
+    }
+  QuantileSketch merged = halves[0];
+  merged.Merge (halves[1]);
+  std::sort (values.begin (), values.end ());
+
+  NS_TEST_EXPECT_MSG_EQ (all.GetCount (), values.size (), "Wrong count");
+  NS_TEST_EXPECT_MSG_EQ (merged.GetCount (), values.size (), "Wrong merged count");
+  NS_TEST_EXPECT_MSG_EQ (all.GetMin (), values.front (), "Wrong minimum");
+  NS_TEST_EXPECT_MSG_EQ (all.GetMax (), values.back (), "Wrong maximum");
+  NS_TEST_EXPECT_MSG_LT (all.GetNBins (), 1000, "Too many bins");
+
+  double quantiles[] = { 0, 0.01, 0.1, 0.5, 0.9, 0.99, 0.999, 0.9999, 1 };
+  for (uint32_t i = 0; i < sizeof (quantiles) / sizeof (quantiles[0]); i++)
+    {
+      double exact = values[static_cast<uint32_t> (quantiles[i] * (values.size () - 1))];
+      NS_TEST_EXPECT_MSG_EQ_TOL (all.GetQuantile (quantiles[i]), exact, exact * 0.01 + 1e-15,
+                                 "Wrong quantile " << quantiles[i]);
+      NS_TEST_EXPECT_MSG_EQ (merged.GetQuantile (quantiles[i]), all.GetQuantile (quantiles[i]),
+                             "Wrong merged quantile " << quantiles[i]);
+    }
+
+  all.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (all.GetCount (), 0, "Values left after Clear");
+  NS_TEST_EXPECT_MSG_EQ (all.GetQuantile (0.5), 0, "Quantile of an empty sketch");
+}
+
+/**
+ * Check that the tail quantiles stay accurate when the number of bins
+ * is bounded.
+ */
+class QuantileSketchMaxBinsTestCase : public TestCase
+{
+public:
+  QuantileSketchMaxBinsTestCase ();
+private:
+  virtual void DoRun (void);
+};
+
+QuantileSketchMaxBinsTestCase::QuantileSketchMaxBinsTestCase ()
+  : TestCase ("Check the tail quantiles with a bounded number of bins")
+{
+}
+
+void
+QuantileSketchMaxBinsTestCase::DoRun (void)
+{
+  QuantileSketch sketch (0.01, 100);
+  // 1 ns to 1 s, in increasing order then in decreasing order
+  for (uint32_t i = 0; i <= 900; i++)
+    {
+      sketch.AddValue (1e-9 * std::pow (10, i / 100.0));
+    }
+  for (uint32_t i = 0; i <= 900; i++)
+    {
+      sketch.AddValue (1e-9 * std::pow (10, (900 - i) / 100.0));
+    }
+  NS_TEST_EXPECT_MSG_EQ (sketch.GetNBins (), 100, "Wrong number of bins");
+  NS_TEST_EXPECT_MSG_EQ (sketch.GetCount (), 1802, "Wrong count");
+  // the 100 bins of 2% cover the values above 1 s / 7.2
+  double p99 = 1e-9 * std::pow (10, 891 / 100.0);
+  NS_TEST_EXPECT_MSG_EQ_TOL (sketch.GetQuantile (0.99), p99, p99 * 0.01, "Wrong 99th percentile");
+  NS_TEST_EXPECT_MSG_EQ_TOL (sketch.GetQuantile (1), 1, 1e-9, "Wrong maximum");
+  NS_TEST_EXPECT_MSG_LT (sketch.GetQuantile (0.5), 1 / 7.0, "Wrong merged low bins");
+
+  // merging disjoint ranges collapses the low bins as adding the values does
+  QuantileSketch low (0.01, 100);
+  QuantileSketch high (0.01, 100);
+  for (uint32_t i = 0; i <= 900; i++)
+    {
+      double value = 1e-9 * std::pow (10, i / 100.0);
+      (i < 450 ? low : high).AddValue (value);
+      (i < 450 ? low : high).AddValue (value);
+    }
+  low.Merge (high);
+  NS_TEST_EXPECT_MSG_EQ (low.GetNBins (), 100, "Wrong number of merged bins");
+  NS_TEST_EXPECT_MSG_EQ (low.GetCount (), sketch.GetCount (), "Wrong merged count");
+  double quantiles[] = { 0, 0.1, 0.5, 0.9, 0.99, 1 };
+  for (uint32_t i = 0; i < sizeof (quantiles) / sizeof (quantiles[0]); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (low.GetQuantile (quantiles[i]), sketch.GetQuantile (quantiles[i]),
+                             "Wrong merged quantile " << quantiles[i]);
+    }
+}
+
+class QuantileSketchTestSuite : public TestSuite
+{
+public:
+  QuantileSketchTestSuite ();
+};
+
+QuantileSketchTestSuite::QuantileSketchTestSuite ()
+  : TestSuite ("quantile-sketch", UNIT)
+{
+  AddTestCase (new QuantileSketchTestCase, TestCase::QUICK);
+  AddTestCase (new QuantileSketchMaxBinsTestCase, TestCase::QUICK);
+}
+
+static QuantileSketchTestSuite g_quantileSketchTestSuite;
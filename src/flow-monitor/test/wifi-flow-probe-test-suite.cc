@@ -0,0 +1,147 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <string>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/node-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/ht-wifi-mac-helper.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/ssid.h"
+#include "ns3/flow-monitor-helper.h"
+#include "ns3/wifi-flow-probe.h"
+
+using namespace ns3;
+
+/**
+ * Check the statistics of the WifiFlowProbes of an 802.11n station
+ * sending a burst of packets to its access point, which are sent in
+ * A-MPDUs under a block ack agreement.
+ */
+class WifiFlowProbeTestCase : public TestCase
+{
+public:
+  WifiFlowProbeTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Send a burst of packets
+   * \param device the device of the station
+   * \param to the address of the access point
+   */
+  void SendBurst (Ptr<NetDevice> device, Mac48Address to);
+};
+
+WifiFlowProbeTestCase::WifiFlowProbeTestCase ()
+  : TestCase ("Check the link and sector statistics of the wifi probes")
+{
+}
+
+void
+WifiFlowProbeTestCase::SendBurst (Ptr<NetDevice> device, Mac48Address to)
+{
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      device->Send (Create<Packet> (1000), to, 0x0800);
+    }
+}
+
+void
+WifiFlowProbeTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  MobilityHelper mobility;
+  mobility.Install (nodes);
+
+  WifiHelper wifi = WifiHelper::Default ();
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211n_5GHZ);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("HtMcs7"),
+                                "ControlMode", StringValue ("HtMcs0"));
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  HtWifiMacHelper mac = HtWifiMacHelper::Default ();
+  Ssid ssid = Ssid ("wifi-flow-probe");
+  mac.SetType ("ns3::ApWifiMac", "Ssid", SsidValue (ssid));
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes.Get (0));
+  mac.SetType ("ns3::StaWifiMac", "Ssid", SsidValue (ssid));
+  devices.Add (wifi.Install (phy, mac, nodes.Get (1)));
+  Mac48Address apAddress = Mac48Address::ConvertFrom (devices.Get (0)->GetAddress ());
+  Mac48Address staAddress = Mac48Address::ConvertFrom (devices.Get (1)->GetAddress ());
+
+  FlowMonitorHelper helper;
+  Ptr<FlowMonitor> monitor = helper.InstallWifi (devices);
+  NS_TEST_ASSERT_MSG_EQ (monitor->GetAllProbes ().size (), 2, "Wrong number of probes");
+  Ptr<WifiFlowProbe> apProbe = DynamicCast<WifiFlowProbe> (monitor->GetAllProbes ()[0]);
+  Ptr<WifiFlowProbe> staProbe = DynamicCast<WifiFlowProbe> (monitor->GetAllProbes ()[1]);
+  NS_TEST_ASSERT_MSG_NE (apProbe, 0, "Not a wifi probe");
+  NS_TEST_ASSERT_MSG_NE (staProbe, 0, "Not a wifi probe");
+
+  Simulator::Schedule (Seconds (1), &WifiFlowProbeTestCase::SendBurst, this, devices.Get (1), apAddress);
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+
+  WifiFlowProbe::LinkStats tx = staProbe->GetLinkStats (apAddress, 0);
+  WifiFlowProbe::LinkStats rx = apProbe->GetLinkStats (staAddress, 0);
+  NS_TEST_EXPECT_MSG_EQ (tx.peer, apAddress, "Wrong peer");
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (tx.txMpdus, 100, "Missing MPDUs");
+  NS_TEST_EXPECT_MSG_EQ (tx.txMpdus, tx.txRetries + rx.rxMpdus, "MPDUs lost on a clear channel");
+  NS_TEST_EXPECT_MSG_GT (tx.txAmpdus, 0, "No A-MPDU");
+  NS_TEST_EXPECT_MSG_GT (tx.maxAmpduMpdus, 1, "No aggregation");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (tx.txAmpduMpdus, tx.txMpdus, "More MPDUs in the A-MPDUs than sent");
+  NS_TEST_EXPECT_MSG_EQ (tx.blockAcks, tx.txAmpdus, "Wrong number of block acks");
+  NS_TEST_EXPECT_MSG_EQ (tx.missedBlockAcks, 0, "Block ack missed on a clear channel");
+  NS_TEST_EXPECT_MSG_EQ (tx.baAckedMpdus, tx.txAmpduMpdus, "Wrong number of MPDUs acknowledged");
+  NS_TEST_EXPECT_MSG_EQ (tx.rxMpdus, 0, "Data received by the station");
+  NS_TEST_EXPECT_MSG_EQ (rx.rxBytes, tx.txBytes, "Wrong number of bytes received");
+  NS_TEST_EXPECT_MSG_EQ (rx.txMpdus, 0, "Data sent by the access point");
+
+  // the SNR of the frames of the station, including its association
+  // request, without directional antenna
+  WifiFlowProbe::SectorStats sector = apProbe->GetSectorStats (staAddress, 0);
+  NS_TEST_EXPECT_MSG_GT (sector.rxFrames, rx.rxMpdus, "Missing frames");
+  NS_TEST_EXPECT_MSG_GT (sector.snrMin, 10, "Wrong SNR");
+  NS_TEST_EXPECT_MSG_LT_OR_EQ (sector.snrMin, sector.snrMax, "Wrong SNR range");
+  NS_TEST_EXPECT_MSG_EQ (sector.slsCompleted, 0, "Sector sweep without DMG");
+  NS_TEST_EXPECT_MSG_EQ (apProbe->GetSectorStats (staAddress, 1).rxFrames, 0, "Unknown sector");
+  // the beacons of the access point
+  NS_TEST_EXPECT_MSG_GT (staProbe->GetSectorStats (apAddress, 0).rxFrames, 0, "No beacon received");
+
+  std::string xml = monitor->SerializeToXmlString (0, false, true);
+  NS_TEST_EXPECT_MSG_NE (xml.find ("<WifiLinkStats "), std::string::npos, "No link statistics in the XML");
+  NS_TEST_EXPECT_MSG_NE (xml.find ("<WifiSectorStats "), std::string::npos, "No sector statistics in the XML");
+
+  Simulator::Destroy ();
+}
+
+class WifiFlowProbeTestSuite : public TestSuite
+{
+public:
+  WifiFlowProbeTestSuite ()
+    : TestSuite ("wifi-flow-probe", UNIT)
+  {
+    AddTestCase (new WifiFlowProbeTestCase, TestCase::QUICK);
+  }
+};
+
+static WifiFlowProbeTestSuite g_wifiFlowProbeTestSuite;
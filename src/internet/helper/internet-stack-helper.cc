@@ -335,6 +335,78 @@ void InternetStackHelper::SetIpv6NsRsJitter (bool enable)
   m_ipv6NsRsJitterEnabled = enable;
 }
 
+Ptr<StaticNeighborTable>
+InternetStackHelper::PopulateStaticNeighborTables (void)
+{
+  return PopulateStaticNeighborTables (NodeContainer::GetGlobal ());
+}
+
+Ptr<StaticNeighborTable>
+InternetStackHelper::PopulateStaticNeighborTables (NodeContainer c)
+{
+  Ptr<StaticNeighborTable> table = CreateObject<StaticNeighborTable> ();
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<Ipv4> ipv4 = (*i)->GetObject<Ipv4> ();
+      if (ipv4 != 0)
+        {
+          for (uint32_t j = 0; j < ipv4->GetNInterfaces (); j++)
+            {
+              Ptr<NetDevice> device = ipv4->GetNetDevice (j);
+              if (!device->NeedsArp ())
+                {
+                  continue;
+                }
+              for (uint32_t k = 0; k < ipv4->GetNAddresses (j); k++)
+                {
+                  Ipv4Address address = ipv4->GetAddress (j, k).GetLocal ();
+                  if (!address.IsLocalhost ())
+                    {
+                      table->Add (address, device->GetAddress ());
+                    }
+                }
+            }
+        }
+      Ptr<Ipv6> ipv6 = (*i)->GetObject<Ipv6> ();
+      if (ipv6 != 0)
+        {
+          for (uint32_t j = 0; j < ipv6->GetNInterfaces (); j++)
+            {
+              Ptr<NetDevice> device = ipv6->GetNetDevice (j);
+              if (!device->NeedsArp ())
+                {
+                  continue;
+                }
+              for (uint32_t k = 0; k < ipv6->GetNAddresses (j); k++)
+                {
+                  Ipv6Address address = ipv6->GetAddress (j, k).GetAddress ();
+                  if (!address.IsLocalhost ())
+                    {
+                      table->Add (address, device->GetAddress ());
+                    }
+                }
+            }
+        }
+    }
+  NS_LOG_INFO ("Static neighbor table with " << table->GetNIpv4Addresses () << " IPv4 and "
+               << table->GetNIpv6Addresses () << " IPv6 addresses");
+
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<ArpL3Protocol> arp = (*i)->GetObject<ArpL3Protocol> ();
+      if (arp != 0)
+        {
+          arp->SetStaticNeighborTable (table);
+        }
+      Ptr<Icmpv6L4Protocol> icmpv6 = (*i)->GetObject<Icmpv6L4Protocol> ();
+      if (icmpv6 != 0)
+        {
+          icmpv6->SetStaticNeighborTable (table);
+        }
+    }
+  return table;
+}
+
 int64_t
 InternetStackHelper::AssignStreams (NodeContainer c, int64_t stream)
 {
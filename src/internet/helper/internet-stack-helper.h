@@ -28,6 +28,7 @@
 #include "ns3/object-factory.h"
 #include "ns3/ipv4-l3-protocol.h"
 #include "ns3/ipv6-l3-protocol.h"
+#include "ns3/static-neighbor-table.h"
 #include "internet-trace-helper.h"
 
 namespace ns3 {
@@ -211,6 +212,31 @@ public:
   */
   int64_t AssignStreams (NodeContainer c, int64_t stream);
 
+  /**
+   * \brief Resolve the IP addresses of all the nodes without ARP nor NDisc.
+   *
+   * Build a single StaticNeighborTable holding the IPv4 and IPv6 addresses
+   * of the devices of all the nodes, and share it between their ARP and
+   * ICMPv6 protocols.  The addresses must have been assigned beforehand;
+   * the addresses assigned later, and the addresses of the nodes created
+   * later, are resolved by ARP and NDisc as usual.
+   *
+   * \returns the static neighbor table
+   */
+  static Ptr<StaticNeighborTable> PopulateStaticNeighborTables (void);
+
+  /**
+   * \brief Resolve the IP addresses of a set of nodes without ARP nor NDisc.
+   *
+   * Build a single StaticNeighborTable holding the IPv4 and IPv6 addresses
+   * of the devices of the nodes, and share it between their ARP and ICMPv6
+   * protocols.  The addresses must have been assigned beforehand.
+   *
+   * \param c the nodes
+   * \returns the static neighbor table
+   */
+  static Ptr<StaticNeighborTable> PopulateStaticNeighborTables (NodeContainer c);
+
 private:
   /**
    * @brief Enable pcap output the indicated Ipv4 and interface pair.
@@ -30,6 +30,7 @@
 #include "arp-l3-protocol.h"
 #include "arp-header.h"
 #include "arp-cache.h"
+#include "static-neighbor-table.h"
 #include "ipv4-interface.h"
 
 namespace ns3 {
@@ -127,6 +128,7 @@ ArpL3Protocol::DoDispose (void)
     }
   m_cacheList.clear ();
   m_node = 0;
+  m_neighbors = 0;
   Object::DoDispose ();
 }
 
@@ -263,6 +265,19 @@ ArpL3Protocol::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t pro
     }
 }
 
+void
+ArpL3Protocol::SetStaticNeighborTable (Ptr<StaticNeighborTable> table)
+{
+  NS_LOG_FUNCTION (this << table);
+  m_neighbors = table;
+}
+
+Ptr<StaticNeighborTable>
+ArpL3Protocol::GetStaticNeighborTable (void) const
+{
+  return m_neighbors;
+}
+
 bool 
 ArpL3Protocol::Lookup (Ptr<Packet> packet, const Ipv4Header & ipHeader, Ipv4Address destination,
                        Ptr<NetDevice> device,
@@ -270,6 +285,12 @@ ArpL3Protocol::Lookup (Ptr<Packet> packet, const Ipv4Header & ipHeader, Ipv4Addr
                        Address *hardwareDestination)
 {
   NS_LOG_FUNCTION (this << packet << destination << device << cache << hardwareDestination);
+  if (m_neighbors != 0 && m_neighbors->Lookup (destination, hardwareDestination))
+    {
+      NS_LOG_LOGIC ("node="<<m_node->GetId ()<<
+                    ", static neighbor " << destination << " -- send");
+      return true;
+    }
   ArpCache::Entry *entry = cache->Lookup (destination);
   if (entry != 0)
     {
@@ -35,6 +35,7 @@ class NetDevice;
 class Node;
 class Packet;
 class Ipv4Interface;
+class StaticNeighborTable;
 
 /**
  * \ingroup internet
@@ -99,6 +100,21 @@ public:
                Ptr<ArpCache> cache,
                Address *hardwareDestination);
 
+  /**
+   * \brief Set the static neighbor table
+   *
+   * The destinations found in the table are resolved without any ARP
+   * exchange nor cache entry.
+   *
+   * \param table the static neighbor table, shared by all the nodes
+   */
+  void SetStaticNeighborTable (Ptr<StaticNeighborTable> table);
+  /**
+   * \brief Get the static neighbor table
+   * \returns the static neighbor table, or null if there is none
+   */
+  Ptr<StaticNeighborTable> GetStaticNeighborTable (void) const;
+
   /**
    * Assign a fixed random variable stream number to the random variables
    * used by this model.  Return the number of streams (possibly zero) that
@@ -160,6 +176,7 @@ private:
   Ptr<Node> m_node; //!< node the ARP L3 protocol is associated with
   TracedCallback<Ptr<const Packet> > m_dropTrace; //!< trace for packets dropped by ARP
   Ptr<RandomVariableStream> m_requestJitter; //!< jitter to de-sync ARP requests
+  Ptr<StaticNeighborTable> m_neighbors; //!< static neighbor table, looked up before the caches
 
 };
 
@@ -49,24 +49,28 @@ operator<< (std::ostream& os, const SPFVertex::VertexType& t)
 std::ostream& 
 operator<< (std::ostream& os, const CandidateQueue& q)
 {
-  typedef CandidateQueue::CandidateList_t List_t;
+  typedef CandidateQueue::CandidateHeap_t List_t;
   typedef List_t::const_iterator CIter_t;
-  const CandidateQueue::CandidateList_t& list = q.m_candidates;
+  List_t list = q.m_candidates;
+  std::sort (list.begin (), list.end (), &CandidateQueue::CompareCandidate);
 
   os << "*** CandidateQueue Begin (<id, distance, LSA-type>) ***" << std::endl;
   for (CIter_t iter = list.begin (); iter != list.end (); iter++)
     {
       os << "<" 
-      << (*iter)->GetVertexId () << ", "
-      << (*iter)->GetDistanceFromRoot () << ", "
-      << (*iter)->GetVertexType () << ">" << std::endl;
+      << iter->vertex->GetVertexId () << ", "
+      << iter->vertex->GetDistanceFromRoot () << ", "
+      << iter->vertex->GetVertexType () << ">" << std::endl;
     }
   os << "*** CandidateQueue End ***";
   return os;
 }
 
 CandidateQueue::CandidateQueue()
-  : m_candidates ()
+  : m_candidates (),
+    m_positions (),
+    m_ids (),
+    m_sequence (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -94,11 +98,16 @@ CandidateQueue::Push (SPFVertex *vNew)
 {
   NS_LOG_FUNCTION (this << vNew);
 
-  CandidateList_t::iterator i = std::upper_bound (
-      m_candidates.begin (), m_candidates.end (), vNew,
-      &CandidateQueue::CompareSPFVertex
-      );
-  m_candidates.insert (i, vNew);
+  VertexId id;
+  id.vertex = vNew;
+  id.count = 0;
+  bool inserted;
+  m_ids.Insert (vNew->GetVertexId ().Get (), id, inserted).count++;
+  Candidate c;
+  c.vertex = vNew;
+  c.sequence = m_sequence++;
+  m_candidates.push_back (c);
+  SiftUp (m_candidates.size () - 1);
 }
 
 SPFVertex *
@@ -110,8 +119,25 @@ CandidateQueue::Pop (void)
       return 0;
     }
 
-  SPFVertex *v = m_candidates.front ();
-  m_candidates.pop_front ();
+  SPFVertex *v = m_candidates.front ().vertex;
+  m_positions.Erase (reinterpret_cast<uintptr_t> (v));
+  Candidate last = m_candidates.back ();
+  m_candidates.pop_back ();
+  if (!m_candidates.empty ())
+    {
+      Place (0, last);
+      SiftDown (0);
+    }
+  VertexId *id = m_ids.Find (v->GetVertexId ().Get ());
+  NS_ASSERT (id != 0);
+  if (--id->count == 0)
+    {
+      m_ids.Erase (v->GetVertexId ().Get ());
+    }
+  else if (id->count == 1)
+    {
+      id->vertex = FindFirst (v->GetVertexId ());
+    }
   return v;
 }
 
@@ -124,7 +150,7 @@ CandidateQueue::Top (void) const
       return 0;
     }
 
-  return m_candidates.front ();
+  return m_candidates.front ().vertex;
 }
 
 bool
@@ -145,18 +171,30 @@ SPFVertex *
 CandidateQueue::Find (const Ipv4Address addr) const
 {
   NS_LOG_FUNCTION (this);
-  CandidateList_t::const_iterator i = m_candidates.begin ();
+  const VertexId *id = m_ids.Find (addr.Get ());
+  if (id == 0)
+    {
+      return 0;
+    }
+  if (id->count > 1)
+    {
+      return FindFirst (addr);
+    }
+  return id->vertex;
+}
 
-  for (; i != m_candidates.end (); i++)
+SPFVertex *
+CandidateQueue::FindFirst (const Ipv4Address addr) const
+{
+  const Candidate *first = 0;
+  for (CandidateHeap_t::const_iterator i = m_candidates.begin (); i != m_candidates.end (); i++)
     {
-      SPFVertex *v = *i;
-      if (v->GetVertexId () == addr)
+      if (i->vertex->GetVertexId () == addr && (first == 0 || CompareCandidate (*i, *first)))
         {
-          return v;
+          first = &*i;
         }
     }
-
-  return 0;
+  return first == 0 ? 0 : first->vertex;
 }
 
 void
@@ -164,11 +202,90 @@ CandidateQueue::Reorder (void)
 {
   NS_LOG_FUNCTION (this);
 
-  m_candidates.sort (&CandidateQueue::CompareSPFVertex);
+  // the heap is rebuilt from the leaves; the vertices of the same priority
+  // keep their relative order
+  for (uint32_t i = m_candidates.size () / 2; i > 0; i--)
+    {
+      SiftDown (i - 1);
+    }
   NS_LOG_LOGIC ("After reordering the CandidateQueue");
   NS_LOG_LOGIC (*this);
 }
 
+void
+CandidateQueue::Update (SPFVertex *v)
+{
+  NS_LOG_FUNCTION (this << v);
+
+  uint32_t *i = m_positions.Find (reinterpret_cast<uintptr_t> (v));
+  NS_ASSERT_MSG (i != 0, "CandidateQueue::Update (): vertex " << v->GetVertexId () << " not queued");
+  NS_ASSERT (m_candidates[*i].vertex == v);
+  // like a stable sort of a list, which would leave the vertex after the
+  // ones of its new priority
+  m_candidates[*i].sequence = m_sequence++;
+  SiftUp (*i);
+}
+
+void
+CandidateQueue::Place (uint32_t i, const Candidate &c)
+{
+  m_candidates[i] = c;
+  m_positions[reinterpret_cast<uintptr_t> (c.vertex)] = i;
+}
+
+void
+CandidateQueue::SiftUp (uint32_t i)
+{
+  Candidate c = m_candidates[i];
+  while (i > 0)
+    {
+      uint32_t parent = (i - 1) / 2;
+      if (!CompareCandidate (c, m_candidates[parent]))
+        {
+          break;
+        }
+      Place (i, m_candidates[parent]);
+      i = parent;
+    }
+  Place (i, c);
+}
+
+void
+CandidateQueue::SiftDown (uint32_t i)
+{
+  Candidate c = m_candidates[i];
+  uint32_t n = m_candidates.size ();
+  while (2 * i + 1 < n)
+    {
+      uint32_t child = 2 * i + 1;
+      if (child + 1 < n && CompareCandidate (m_candidates[child + 1], m_candidates[child]))
+        {
+          child++;
+        }
+      if (!CompareCandidate (m_candidates[child], c))
+        {
+          break;
+        }
+      Place (i, m_candidates[child]);
+      i = child;
+    }
+  Place (i, c);
+}
+
+bool
+CandidateQueue::CompareCandidate (const Candidate &c1, const Candidate &c2)
+{
+  if (CompareSPFVertex (c1.vertex, c2.vertex))
+    {
+      return true;
+    }
+  if (CompareSPFVertex (c2.vertex, c1.vertex))
+    {
+      return false;
+    }
+  return c1.sequence < c2.sequence;
+}
+
 /*
  * In this implementation, SPFVertex follows the ordering where
  * a vertex is ranked first if its GetDistanceFromRoot () is smaller;
@@ -22,8 +22,9 @@
 #define CANDIDATE_QUEUE_H
 
 #include <stdint.h>
-#include <list>
+#include <vector>
 #include "ns3/ipv4-address.h"
+#include "ns3/flat-hash-map.h"
 
 namespace ns3 {
 
@@ -45,6 +46,12 @@ class SPFVertex;
  * for a Find () operation, the dynamic nature of the data and the derived
  * requirement for a Reorder () operation led us to implement this simple 
  * enhanced priority queue.
+ *
+ * The queue is a binary heap indexed by vertex, so that Push (), Pop ()
+ * and Update () take a logarithmic time, and Find () a constant time
+ * unless several queued vertices have the same ID.  The vertices of equal
+ * priority are popped in the order in which they were pushed or last
+ * updated, as they were when the queue was a sorted list.
  */
 class CandidateQueue
 {
@@ -152,6 +159,19 @@ public:
  */
   void Reorder (void);
 
+/**
+ * @brief Move a vertex of the Candidate Queue according to the priority
+ * scheme after its distance from the root decreased.
+ *
+ * This is the decrease-key operation of the priority queue: unlike
+ * Reorder (), it only moves the given vertex, which is ranked after the
+ * other vertices of the same priority.
+ *
+ * @see SPFVertex
+ * @param v The Shortest Path First Vertex which is in the queue.
+ */
+  void Update (SPFVertex *v);
+
 private:
 /**
  * Candidate Queue copy construction is disallowed (not implemented) to 
@@ -182,8 +202,60 @@ private:
  */
   static bool CompareSPFVertex (const SPFVertex* v1, const SPFVertex* v2);
 
-  typedef std::list<SPFVertex*> CandidateList_t; //!< container of SPFVertex pointers
-  CandidateList_t m_candidates;  //!< SPFVertex candidates
+  /**
+   * \brief A vertex of the heap and the order in which it was queued
+   */
+  struct Candidate
+  {
+    SPFVertex *vertex;  //!< the vertex
+    uint64_t sequence;  //!< the order of the vertex among the vertices of the same priority
+  };
+
+/**
+ * \param c1 first operand
+ * \param c2 second operand
+ * \return True if c1 should be popped before c2; false otherwise
+ */
+  static bool CompareCandidate (const Candidate &c1, const Candidate &c2);
+/**
+ * \brief Move a candidate towards the top of the heap until it is in order
+ * \param i the index of the candidate in the heap
+ */
+  void SiftUp (uint32_t i);
+/**
+ * \brief Move a candidate towards the leaves of the heap until it is in order
+ * \param i the index of the candidate in the heap
+ */
+  void SiftDown (uint32_t i);
+/**
+ * \brief Store a candidate in the heap and index it
+ * \param i the index of the candidate in the heap
+ * \param c the candidate
+ */
+  void Place (uint32_t i, const Candidate &c);
+
+/**
+ * \brief Find the queued vertex with a given ID which is popped first, when
+ * several queued vertices have this ID
+ * \param addr the vertex ID
+ * \returns the vertex
+ */
+  SPFVertex* FindFirst (const Ipv4Address addr) const;
+
+  /**
+   * \brief The queued vertices of an ID
+   */
+  struct VertexId
+  {
+    SPFVertex *vertex;  //!< the vertex, if count is 1
+    uint32_t count;     //!< the number of queued vertices with this ID
+  };
+
+  typedef std::vector<Candidate> CandidateHeap_t; //!< container of SPFVertex candidates
+  CandidateHeap_t m_candidates;  //!< SPFVertex candidates, in a binary heap
+  FlatHashMap<uintptr_t, uint32_t> m_positions; //!< the index in the heap of the vertices, by vertex address
+  FlatHashMap<uint32_t, VertexId> m_ids; //!< the queued vertices, by vertex ID
+  uint64_t m_sequence;  //!< the sequence number of the next candidate
 
   /**
    * \brief Stream insertion operator.
@@ -676,9 +676,11 @@ public:
 private:
   typedef std::map<Ipv4Address, GlobalRoutingLSA*> LSDBMap_t; //!< container of IPv4 addresses / Link State Advertisements
   typedef std::pair<Ipv4Address, GlobalRoutingLSA*> LSDBPair_t; //!< pair of IPv4 addresses / Link State Advertisements
+  typedef std::map<Ipv4Address, LSDBMap_t::const_iterator> LinkDataMap_t; //!< container of IPv4 addresses / Link State Advertisements of m_database
 
   LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
   std::vector<GlobalRoutingLSA*> m_extdatabase; //!< database of External Link State Advertisements
+  LinkDataMap_t m_linkData; //!< the first Link State Advertisement of m_database with a transit link record of a given link data
 
 /**
  * @brief GlobalRouteManagerLSDB copy construction is disallowed.  There's no 
@@ -765,8 +767,17 @@ private:
   GlobalRouteManagerImpl& operator= (GlobalRouteManagerImpl& srmi);
 
   SPFVertex* m_spfroot; //!< the root node
+  Ptr<Node> m_spfrootNode; //!< the node of the root router
   GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
 
+  /**
+   * \brief Find the node of a router
+   *
+   * \param lsa the Router LSA of the router
+   * \returns the node, or 0 if no node has the router ID
+   */
+  Ptr<Node> FindRouterNode (GlobalRoutingLSA* lsa) const;
+
   /**
    * \brief Test if a node is a stub, from an OSPF sense.
    *
@@ -35,6 +35,7 @@
 #include "ipv6-l3-protocol.h"
 #include "ipv6-interface.h"
 #include "icmpv6-l4-protocol.h"
+#include "static-neighbor-table.h"
 
 namespace ns3 {
 
@@ -106,6 +107,7 @@ void Icmpv6L4Protocol::DoDispose ()
   m_cacheList.clear ();
   m_downTarget.Nullify ();
 
+  m_neighbors = 0;
   m_node = 0;
   IpL4Protocol::DoDispose ();
 }
@@ -169,6 +171,17 @@ bool Icmpv6L4Protocol::IsAlwaysDad () const
   return m_alwaysDad;
 }
 
+void Icmpv6L4Protocol::SetStaticNeighborTable (Ptr<StaticNeighborTable> table)
+{
+  NS_LOG_FUNCTION (this << table);
+  m_neighbors = table;
+}
+
+Ptr<StaticNeighborTable> Icmpv6L4Protocol::GetStaticNeighborTable () const
+{
+  return m_neighbors;
+}
+
 void Icmpv6L4Protocol::DoDAD (Ipv6Address target, Ptr<Ipv6Interface> interface)
 {
   NS_LOG_FUNCTION (this << target << interface);
@@ -182,6 +195,14 @@ void Icmpv6L4Protocol::DoDAD (Ipv6Address target, Ptr<Ipv6Interface> interface)
       return;
     }
 
+  Address hardwareAddress;
+  if (m_neighbors && m_neighbors->Lookup (target, &hardwareAddress))
+    {
+      /* the address is known to be unique */
+      NS_LOG_LOGIC ("Static neighbor " << target << ", no DAD");
+      return;
+    }
+
   /** \todo disable multicast loopback to prevent NS probing to be received by the sender */
 
   NdiscCache::Ipv6PayloadHeaderPair p = ForgeNS ("::",Ipv6Address::MakeSolicitedAddress (target), target, interface->GetDevice ()->GetAddress ());
@@ -1282,6 +1303,11 @@ bool Icmpv6L4Protocol::Lookup (Ipv6Address dst, Ptr<NetDevice> device, Ptr<Ndisc
 {
   NS_LOG_FUNCTION (this << dst << device << cache << hardwareDestination);
 
+  if (m_neighbors && m_neighbors->Lookup (dst, hardwareDestination))
+    {
+      return true;
+    }
+
   if (!cache)
     {
       /* try to find the cache */
@@ -1313,6 +1339,11 @@ bool Icmpv6L4Protocol::Lookup (Ptr<Packet> p, const Ipv6Header & ipHeader, Ipv6A
 {
   NS_LOG_FUNCTION (this << p << ipHeader << dst << device << cache << hardwareDestination);
 
+  if (m_neighbors && m_neighbors->Lookup (dst, hardwareDestination))
+    {
+      return true;
+    }
+
   if (!cache)
     {
       /* try to find the cache */
@@ -38,6 +38,7 @@ class NetDevice;
 class Node;
 class Packet;
 class TraceContext;
+class StaticNeighborTable;
 
 /**
  * \class Icmpv6L4Protocol
@@ -412,6 +413,22 @@ public:
    */
   bool IsAlwaysDad () const;
 
+  /**
+   * \brief Set the static neighbor table.
+   *
+   * The destinations found in the table are resolved without any NDisc
+   * exchange nor cache entry, and their addresses skip the DAD.
+   *
+   * \param table the static neighbor table, shared by all the nodes
+   */
+  void SetStaticNeighborTable (Ptr<StaticNeighborTable> table);
+
+  /**
+   * \brief Get the static neighbor table.
+   * \return the static neighbor table, or null if there is none
+   */
+  Ptr<StaticNeighborTable> GetStaticNeighborTable () const;
+
   /**
    * Assign a fixed random variable stream number to the random variables
    * used by this model.  Return the number of streams (possibly zero) that
@@ -441,6 +458,11 @@ private:
    */
   CacheList m_cacheList;
 
+  /**
+   * \brief The static neighbor table, looked up before the caches.
+   */
+  Ptr<StaticNeighborTable> m_neighbors;
+
   /**
    * \brief Always do DAD ?
    */
@@ -21,13 +21,15 @@
 #include "ipv4-end-point-demux.h"
 #include "ipv4-end-point.h"
 #include "ns3/log.h"
+#include <algorithm>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Ipv4EndPointDemux");
 
 Ipv4EndPointDemux::Ipv4EndPointDemux ()
-  : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152)
+  : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152),
+    m_sequence (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -38,6 +40,7 @@ Ipv4EndPointDemux::~Ipv4EndPointDemux ()
   for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
     {
       Ipv4EndPoint *endPoint = *i;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
   m_endPoints.clear ();
@@ -47,20 +50,17 @@ bool
 Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
 {
   NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
-    {
-      if ((*i)->GetLocalPort  () == port) 
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_ports.Find (port) != 0;
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal (Ipv4Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
+  if (!LookupPortLocal (port))
+    {
+      return false;
+    }
   for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
     {
       if ((*i)->GetLocalPort () == port &&
@@ -82,10 +82,7 @@ Ipv4EndPointDemux::Allocate (void)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (Ipv4Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Add (new Ipv4EndPoint (Ipv4Address::GetAny (), port));
 }
 
 Ipv4EndPoint *
@@ -98,10 +95,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Add (new Ipv4EndPoint (address, port));
 }
 
 Ipv4EndPoint *
@@ -121,10 +115,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address, uint16_t port)
       NS_LOG_WARN ("Duplicate address/port; failing.");
       return 0;
     }
-  Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Add (new Ipv4EndPoint (address, port));
 }
 
 Ipv4EndPoint *
@@ -132,12 +123,22 @@ Ipv4EndPointDemux::Allocate (Ipv4Address localAddress, uint16_t localPort,
                              Ipv4Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  FourTuple tuple;
+  const Bucket *bucket;
+  if (GetFourTuple (localAddress, localPort, peerAddress, peerPort, tuple))
     {
-      if ((*i)->GetLocalPort () == localPort &&
-          (*i)->GetLocalAddress () == localAddress &&
-          (*i)->GetPeerPort () == peerPort &&
-          (*i)->GetPeerAddress () == peerAddress) 
+      bucket = m_connected.Find (tuple);
+    }
+  else
+    {
+      bucket = m_wildcards.Find (localPort);
+    }
+  for (uint32_t i = 0; bucket != 0 && i < bucket->size (); i++)
+    {
+      Ipv4EndPoint *other = (*bucket)[i].second;
+      if (other->GetLocalAddress () == localAddress &&
+          other->GetPeerPort () == peerPort &&
+          other->GetPeerAddress () == peerAddress) 
         {
           NS_LOG_WARN ("No way we can allocate this end-point.");
           /* no way we can allocate this end-point. */
@@ -146,26 +147,101 @@ Ipv4EndPointDemux::Allocate (Ipv4Address localAddress, uint16_t localPort,
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
+  return Add (endPoint);
+}
 
+Ipv4EndPoint *
+Ipv4EndPointDemux::Add (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  m_endPoints.push_back (endPoint);
+  Record record;
+  record.position = --m_endPoints.end ();
+  record.sequence = m_sequence++;
+  m_records[reinterpret_cast<uintptr_t> (endPoint)] = record;
+  endPoint->m_demux = this;
+  Index (endPoint);
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
   return endPoint;
 }
 
-void 
-Ipv4EndPointDemux::DeAllocate (Ipv4EndPoint *endPoint)
+bool
+Ipv4EndPointDemux::GetFourTuple (Ipv4Address localAddress, uint16_t localPort,
+                                 Ipv4Address peerAddress, uint16_t peerPort,
+                                 FourTuple &tuple)
+{
+  tuple.localAddress = localAddress.Get ();
+  tuple.peerAddress = peerAddress.Get ();
+  tuple.localPort = localPort;
+  tuple.peerPort = peerPort;
+  return localAddress != Ipv4Address::GetAny ()
+         && peerAddress != Ipv4Address::GetAny ()
+         && peerPort != 0;
+}
+
+bool
+Ipv4EndPointDemux::GetFourTuple (Ipv4EndPoint *endPoint, FourTuple &tuple)
+{
+  return GetFourTuple (endPoint->GetLocalAddress (), endPoint->GetLocalPort (),
+                       endPoint->GetPeerAddress (), endPoint->GetPeerPort (),
+                       tuple);
+}
+
+void
+Ipv4EndPointDemux::Index (Ipv4EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this << endPoint);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  std::pair<uint64_t, Ipv4EndPoint *> entry (m_records.Find (reinterpret_cast<uintptr_t> (endPoint))->sequence, endPoint);
+  FourTuple tuple;
+  Bucket &bucket = GetFourTuple (endPoint, tuple) ? m_connected[tuple] : m_wildcards[endPoint->GetLocalPort ()];
+  bucket.insert (std::upper_bound (bucket.begin (), bucket.end (), entry), entry);
+  m_ports[endPoint->GetLocalPort ()]++;
+}
+
+void
+Ipv4EndPointDemux::Unindex (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  std::pair<uint64_t, Ipv4EndPoint *> entry (m_records.Find (reinterpret_cast<uintptr_t> (endPoint))->sequence, endPoint);
+  FourTuple tuple;
+  bool connected = GetFourTuple (endPoint, tuple);
+  Bucket *bucket = connected ? m_connected.Find (tuple) : m_wildcards.Find (endPoint->GetLocalPort ());
+  NS_ASSERT (bucket != 0);
+  Bucket::iterator i = std::lower_bound (bucket->begin (), bucket->end (), entry);
+  NS_ASSERT (i != bucket->end () && *i == entry);
+  bucket->erase (i);
+  if (bucket->empty ())
     {
-      if (*i == endPoint)
+      if (connected)
+        {
+          m_connected.Erase (tuple);
+        }
+      else
         {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
+          m_wildcards.Erase (endPoint->GetLocalPort ());
         }
     }
+  uint32_t *count = m_ports.Find (endPoint->GetLocalPort ());
+  if (--*count == 0)
+    {
+      m_ports.Erase (endPoint->GetLocalPort ());
+    }
+}
+
+void 
+Ipv4EndPointDemux::DeAllocate (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  Record *record = m_records.Find (reinterpret_cast<uintptr_t> (endPoint));
+  if (record == 0)
+    {
+      return;
+    }
+  m_endPoints.erase (record->position);
+  Unindex (endPoint);
+  m_records.Erase (reinterpret_cast<uintptr_t> (endPoint));
+  endPoint->m_demux = 0;
+  delete endPoint;
 }
 
 /*
@@ -203,8 +279,54 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
   EndPoints retval3; // Matches all but local address
   EndPoints retval4; // Exact match on all 4
 
+  bool subnetDirected = false;
+  Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
+  for (uint32_t i = 0; incomingInterface != 0 && i < incomingInterface->GetNAddresses (); i++)
+    {
+      Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
+      if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
+          daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
+        {
+          subnetDirected = true;
+          incomingInterfaceAddr = addr.GetLocal ();
+        }
+    }
+  bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
+  NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
+
+  // The end points which may match, in the order of their allocation: a
+  // connected end point matches only the packets of its four-tuple,
+  // unless the packet is a broadcast
+  std::vector<Ipv4EndPoint *> candidates;
+  if (isBroadcast)
+    {
+      candidates.assign (m_endPoints.begin (), m_endPoints.end ());
+    }
+  else
+    {
+      FourTuple tuple;
+      GetFourTuple (daddr, dport, saddr, sport, tuple);
+      const Bucket *connected = m_connected.Find (tuple);
+      const Bucket *wildcards = m_wildcards.Find (dport);
+      Bucket merged;
+      if (connected != 0)
+        {
+          merged = *connected;
+        }
+      if (wildcards != 0)
+        {
+          uint32_t n = merged.size ();
+          merged.insert (merged.end (), wildcards->begin (), wildcards->end ());
+          std::inplace_merge (merged.begin (), merged.begin () + n, merged.end ());
+        }
+      for (Bucket::const_iterator i = merged.begin (); i != merged.end (); i++)
+        {
+          candidates.push_back (i->second);
+        }
+    }
+
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  for (std::vector<Ipv4EndPoint *>::iterator i = candidates.begin (); i != candidates.end (); i++) 
     {
       Ipv4EndPoint* endP = *i;
 
@@ -239,20 +361,6 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
               continue;
             }
         }
-      bool subnetDirected = false;
-      Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
-      for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
-        {
-          Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
-          if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
-              daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
-            {
-              subnetDirected = true;
-              incomingInterfaceAddr = addr.GetLocal ();
-            }
-        }
-      bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
-      NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
       bool localAddressMatchesWildCard = 
         endP->GetLocalAddress () == Ipv4Address::GetAny ();
       bool localAddressMatchesExact = endP->GetLocalAddress () == daddr;
@@ -324,6 +432,22 @@ Ipv4EndPointDemux::SimpleLookup (Ipv4Address daddr,
 {
   NS_LOG_FUNCTION (this << daddr << dport << saddr << sport);
 
+  if (!LookupPortLocal (dport))
+    {
+      return 0;
+    }
+  // a fully specified four-tuple can only match a connected end point
+  FourTuple tuple;
+  if (GetFourTuple (daddr, dport, saddr, sport, tuple))
+    {
+      const Bucket *connected = m_connected.Find (tuple);
+      if (connected != 0)
+        {
+          /* this is an exact match. */
+          return connected->front ().second;
+        }
+    }
+
   // this code is a copy/paste version of an old BSD ip stack lookup
   // function.
   uint32_t genericity = 3;
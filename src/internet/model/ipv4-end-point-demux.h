@@ -23,7 +23,10 @@
 
 #include <stdint.h>
 #include <list>
+#include <vector>
+#include <utility>
 #include "ns3/ipv4-address.h"
+#include "ns3/flat-hash-map.h"
 #include "ipv4-interface.h"
 
 namespace ns3 {
@@ -38,6 +41,12 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * The end points with a local address, a peer address and a peer port,
+ * i.e., the connected TCP sockets, are indexed by their four-tuple in a
+ * hash table, and the other end points by their local port, so that a
+ * lookup does not visit the end points of the other connections.  The
+ * end points tell the demux when their addresses change.
  */
 
 class Ipv4EndPointDemux {
@@ -161,6 +170,100 @@ public:
   void DeAllocate (Ipv4EndPoint *endPoint);
 
 private:
+  friend class Ipv4EndPoint;
+
+  /**
+   * \brief The four-tuple of a connected end point.
+   */
+  struct FourTuple
+  {
+    uint32_t localAddress; //!< The local address
+    uint32_t peerAddress;  //!< The peer address
+    uint16_t localPort;    //!< The local port
+    uint16_t peerPort;     //!< The peer port
+    /**
+     * \param o another four-tuple
+     * \returns true if the four-tuples are equal
+     */
+    bool operator == (const FourTuple &o) const
+    {
+      return localAddress == o.localAddress && peerAddress == o.peerAddress
+             && localPort == o.localPort && peerPort == o.peerPort;
+    }
+  };
+
+  /**
+   * \brief The hash of a four-tuple.
+   */
+  struct FourTupleHash
+  {
+    /**
+     * \param t a four-tuple
+     * \returns the hash of the four-tuple
+     */
+    uint32_t operator () (const FourTuple &t) const
+    {
+      FlatHashMapHash<uint64_t> hash;
+      uint64_t ports = (static_cast<uint64_t> (t.localPort) << 16) | t.peerPort;
+      return hash ((static_cast<uint64_t> (t.localAddress) << 32 | t.peerAddress) ^ hash (ports));
+    }
+  };
+
+  /**
+   * \brief The end points of a four-tuple or of a local port, with the
+   * order in which they were allocated.
+   */
+  typedef std::vector<std::pair<uint64_t, Ipv4EndPoint *> > Bucket;
+
+  /**
+   * \brief Where an end point is kept.
+   */
+  struct Record
+  {
+    EndPointsI position; //!< The position in the list of the end points
+    uint64_t sequence;   //!< The order in which the end point was allocated
+  };
+
+  /**
+   * \brief Add an end point to the demux.
+   * \param endPoint the end point
+   * \returns the end point
+   */
+  Ipv4EndPoint *Add (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Index an end point by its four-tuple or by its local port, and
+   * count it in the end points of its local port.
+   * \param endPoint the end point
+   */
+  void Index (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Remove an end point from the index of Index ().
+   * \param endPoint the end point
+   */
+  void Unindex (Ipv4EndPoint *endPoint);
+
+  /**
+   * \param localAddress the local address
+   * \param localPort the local port
+   * \param peerAddress the peer address
+   * \param peerPort the peer port
+   * \param [out] tuple the four-tuple
+   * \returns true if the local address, the peer address and the peer
+   *          port are specified
+   */
+  static bool GetFourTuple (Ipv4Address localAddress, uint16_t localPort,
+                            Ipv4Address peerAddress, uint16_t peerPort,
+                            FourTuple &tuple);
+
+  /**
+   * \param endPoint an end point
+   * \param [out] tuple the four-tuple of the end point
+   * \returns true if the end point has a local address, a peer address
+   *          and a peer port
+   */
+  static bool GetFourTuple (Ipv4EndPoint *endPoint, FourTuple &tuple);
 
   /**
    * \brief Allocate an ephemeral port.
@@ -187,6 +290,31 @@ private:
    * \brief A list of IPv4 end points.
    */
   EndPoints m_endPoints;
+
+  /**
+   * \brief The position and the sequence of the end points, by address.
+   */
+  FlatHashMap<uintptr_t, Record> m_records;
+
+  /**
+   * \brief The number of end points of the local ports.
+   */
+  FlatHashMap<uint16_t, uint32_t> m_ports;
+
+  /**
+   * \brief The connected end points, by four-tuple.
+   */
+  FlatHashMap<FourTuple, Bucket, FourTupleHash> m_connected;
+
+  /**
+   * \brief The other end points, by local port.
+   */
+  FlatHashMap<uint16_t, Bucket> m_wildcards;
+
+  /**
+   * \brief The sequence of the next end point.
+   */
+  uint64_t m_sequence;
 };
 
 } // namespace ns3
@@ -18,6 +18,7 @@
 
 #include <vector>
 #include <iomanip>
+#include <algorithm>
 #include "ns3/names.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
@@ -80,6 +81,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, nextHop, interface);
   m_hostRoutes.push_back (route);
+  m_hostTrie.Add (route);
 }
 
 void 
@@ -90,6 +92,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, interface);
   m_hostRoutes.push_back (route);
+  m_hostTrie.Add (route);
 }
 
 void 
@@ -105,6 +108,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_networkRoutes.push_back (route);
+  m_networkTrie.Add (route);
 }
 
 void 
@@ -118,6 +122,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         interface);
   m_networkRoutes.push_back (route);
+  m_networkTrie.Add (route);
 }
 
 void 
@@ -133,6 +138,7 @@ Ipv4GlobalRouting::AddASExternalRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_ASexternalRoutes.push_back (route);
+  m_ASexternalTrie.Add (route);
 }
 
 
@@ -146,73 +152,108 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
   typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
   RouteVec_t allRoutes;
 
+  const Ipv4RoutingTrie::Routes *matches[Ipv4RoutingTrie::MAX_MATCHES];
+  uint8_t lengths[Ipv4RoutingTrie::MAX_MATCHES];
+
   NS_LOG_LOGIC ("Number of m_hostRoutes = " << m_hostRoutes.size ());
-  for (HostRoutesCI i = m_hostRoutes.begin (); 
-       i != m_hostRoutes.end (); 
-       i++) 
+  uint32_t nMatches = m_hostTrie.Lookup (dest, matches, lengths);
+  for (uint32_t m = 0; m < nMatches; m++)
     {
-      NS_ASSERT ((*i)->IsHost ());
-      if ((*i)->GetDest ().IsEqual (dest)) 
+      for (Ipv4RoutingTrie::Routes::const_iterator i = matches[m]->begin ();
+           i != matches[m]->end ();
+           i++)
         {
-          if (oif != 0)
+          NS_ASSERT (i->entry->IsHost ());
+          if (i->entry->GetDest ().IsEqual (dest))
             {
-              if (oif != m_ipv4->GetNetDevice ((*i)->GetInterface ()))
+              if (oif != 0)
                 {
-                  NS_LOG_LOGIC ("Not on requested interface, skipping");
-                  continue;
+                  if (oif != m_ipv4->GetNetDevice (i->entry->GetInterface ()))
+                    {
+                      NS_LOG_LOGIC ("Not on requested interface, skipping");
+                      continue;
+                    }
                 }
+              allRoutes.push_back (i->entry);
+              NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << i->entry);
             }
-          allRoutes.push_back (*i);
-          NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << *i); 
         }
     }
   if (allRoutes.size () == 0) // if no host route is found
     {
       NS_LOG_LOGIC ("Number of m_networkRoutes" << m_networkRoutes.size ());
-      for (NetworkRoutesI j = m_networkRoutes.begin (); 
-           j != m_networkRoutes.end (); 
-           j++) 
+      // all the network routes containing dest are equal cost routes,
+      // in the order in which they were added, whatever their prefix
+      std::vector<std::pair<uint64_t, Ipv4RoutingTableEntry*> > found;
+      nMatches = m_networkTrie.Lookup (dest, matches, lengths);
+      for (uint32_t m = 0; m < nMatches; m++)
         {
-          Ipv4Mask mask = (*j)->GetDestNetworkMask ();
-          Ipv4Address entry = (*j)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry)) 
+          for (Ipv4RoutingTrie::Routes::const_iterator j = matches[m]->begin ();
+               j != matches[m]->end ();
+               j++)
             {
-              if (oif != 0)
+              Ipv4Mask mask = j->entry->GetDestNetworkMask ();
+              Ipv4Address entry = j->entry->GetDestNetwork ();
+              if (mask.IsMatch (dest, entry))
                 {
-                  if (oif != m_ipv4->GetNetDevice ((*j)->GetInterface ()))
+                  if (oif != 0)
                     {
-                      NS_LOG_LOGIC ("Not on requested interface, skipping");
-                      continue;
+                      if (oif != m_ipv4->GetNetDevice (j->entry->GetInterface ()))
+                        {
+                          NS_LOG_LOGIC ("Not on requested interface, skipping");
+                          continue;
+                        }
                     }
+                  found.push_back (std::make_pair (j->sequence, j->entry));
+                  NS_LOG_LOGIC (found.size () << "Found global network route" << j->entry);
                 }
-              allRoutes.push_back (*j);
-              NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << *j);
             }
         }
+      if (nMatches > 1)
+        {
+          std::sort (found.begin (), found.end ());
+        }
+      for (uint32_t f = 0; f < found.size (); f++)
+        {
+          allRoutes.push_back (found[f].second);
+        }
     }
   if (allRoutes.size () == 0)  // consider external if no host/network found
     {
-      for (ASExternalRoutesI k = m_ASexternalRoutes.begin ();
-           k != m_ASexternalRoutes.end ();
-           k++)
+      // the first external route containing dest
+      const Ipv4RoutingTrie::Route *first = 0;
+      nMatches = m_ASexternalTrie.Lookup (dest, matches, lengths);
+      for (uint32_t m = 0; m < nMatches; m++)
         {
-          Ipv4Mask mask = (*k)->GetDestNetworkMask ();
-          Ipv4Address entry = (*k)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry))
+          for (Ipv4RoutingTrie::Routes::const_iterator k = matches[m]->begin ();
+               k != matches[m]->end ();
+               k++)
             {
-              NS_LOG_LOGIC ("Found external route" << *k);
-              if (oif != 0)
+              Ipv4Mask mask = k->entry->GetDestNetworkMask ();
+              Ipv4Address entry = k->entry->GetDestNetwork ();
+              if (mask.IsMatch (dest, entry))
                 {
-                  if (oif != m_ipv4->GetNetDevice ((*k)->GetInterface ()))
+                  if (oif != 0)
                     {
-                      NS_LOG_LOGIC ("Not on requested interface, skipping");
-                      continue;
+                      if (oif != m_ipv4->GetNetDevice (k->entry->GetInterface ()))
+                        {
+                          NS_LOG_LOGIC ("Not on requested interface, skipping");
+                          continue;
+                        }
+                    }
+                  if (first == 0 || k->sequence < first->sequence)
+                    {
+                      first = &(*k);
                     }
+                  break;
                 }
-              allRoutes.push_back (*k);
-              break;
             }
         }
+      if (first != 0)
+        {
+          NS_LOG_LOGIC ("Found external route" << first->entry);
+          allRoutes.push_back (first->entry);
+        }
     }
   if (allRoutes.size () > 0 ) // if route(s) is found
     {
@@ -319,6 +360,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
           if (tmp  == index)
             {
               NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_hostRoutes.size ());
+              m_hostTrie.Remove (*i);
               delete *i;
               m_hostRoutes.erase (i);
               NS_LOG_LOGIC ("Done removing host route " << index << "; host route remaining size = " << m_hostRoutes.size ());
@@ -336,6 +378,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
       if (tmp == index)
         {
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_networkRoutes.size ());
+          m_networkTrie.Remove (*j);
           delete *j;
           m_networkRoutes.erase (j);
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
@@ -352,6 +395,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
       if (tmp == index)
         {
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_ASexternalRoutes.size ());
+          m_ASexternalTrie.Remove (*k);
           delete *k;
           m_ASexternalRoutes.erase (k);
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
@@ -374,6 +418,9 @@ void
 Ipv4GlobalRouting::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  m_hostTrie.Clear ();
+  m_networkTrie.Clear ();
+  m_ASexternalTrie.Clear ();
   for (HostRoutesI i = m_hostRoutes.begin (); 
        i != m_hostRoutes.end (); 
        i = m_hostRoutes.erase (i)) 
@@ -28,6 +28,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/ipv4-routing-trie.h"
 
 namespace ns3 {
 
@@ -264,6 +265,10 @@ private:
   NetworkRoutes m_networkRoutes;       //!< Routes to networks
   ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+  Ipv4RoutingTrie m_hostTrie;          //!< Index of the routes to hosts
+  Ipv4RoutingTrie m_networkTrie;       //!< Index of the routes to networks
+  Ipv4RoutingTrie m_ASexternalTrie;    //!< Index of the external routes
+
   Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
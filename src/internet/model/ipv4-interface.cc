@@ -25,6 +25,7 @@
 #include "arp-l3-protocol.h"
 #include "arp-cache.h"
 #include "ns3/net-device.h"
+#include "ns3/checksum-offload.h"
 #include "ns3/log.h"
 #include "ns3/packet.h"
 #include "ns3/node.h"
@@ -242,6 +243,12 @@ Ipv4Interface::Send (Ptr<Packet> p, const Ipv4Header & hdr, Ipv4Address dest)
           return;
         }
     }
+  // The checksums of the packets leaving the node are filled if needed only
+  if (ChecksumOffload::IsEnabled ())
+    {
+      ChecksumOffload::Defer (p, Ipv4L3Protocol::PROT_NUMBER, hdr.GetSerializedSize ());
+    }
+
   if (m_device->NeedsArp ())
     {
       NS_LOG_LOGIC ("Needs ARP" << " " << dest);
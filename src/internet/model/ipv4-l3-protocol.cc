@@ -33,6 +33,8 @@
 #include "ns3/boolean.h"
 #include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/traffic-control-layer.h"
+#include "ns3/segmentation-offload.h"
+#include "ns3/checksum-offload.h"
 
 #include "loopback-net-device.h"
 #include "arp-l3-protocol.h"
@@ -40,6 +42,10 @@
 #include "icmpv4-l4-protocol.h"
 #include "ipv4-interface.h"
 #include "ipv4-raw-socket-impl.h"
+#include "tcp-header.h"
+#include "tcp-l4-protocol.h"
+#include "tcp-option-ts.h"
+#include "udp-l4-protocol.h"
 
 namespace ns3 {
 
@@ -115,6 +121,9 @@ Ipv4L3Protocol::GetTypeId (void)
 Ipv4L3Protocol::Ipv4L3Protocol()
 {
   NS_LOG_FUNCTION (this);
+  SegmentationOffload::Register (PROT_NUMBER, MakeCallback (&Ipv4L3Protocol::SegmentPacket));
+  SegmentationOffload::RegisterCoalesce (PROT_NUMBER, MakeCallback (&Ipv4L3Protocol::CoalescePackets));
+  ChecksumOffload::Register (PROT_NUMBER, MakeCallback (&Ipv4L3Protocol::CompleteChecksums));
 }
 
 Ipv4L3Protocol::~Ipv4L3Protocol ()
@@ -900,15 +909,35 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
   Ptr<Ipv4Interface> outInterface = GetInterface (interface);
   NS_LOG_LOGIC ("Send via NetDevice ifIndex " << outDev->GetIfIndex () << " ipv4InterfaceIndex " << interface);
 
+  // A super-segment is split by the device if it can, here otherwise
+  GsoTag gsoTag;
+  bool superSegment = packet->PeekPacketTag (gsoTag);
+  bool offload = superSegment && outDev->SupportsSegmentationOffload ();
+  if (superSegment)
+    {
+      // Reserve the identifications of the segments
+      uint32_t segments = (packet->GetSize () + gsoTag.GetSegmentSize () - 1) / gsoTag.GetSegmentSize ();
+      uint64_t srcDst = ipHeader.GetDestination ().Get () | (uint64_t (ipHeader.GetSource ().Get ()) << 32);
+      m_identification[std::make_pair (srcDst, ipHeader.GetProtocol ())] += segments - 1;
+    }
+
   if (!route->GetGateway ().IsEqual (Ipv4Address ("0.0.0.0")))
     {
       if (outInterface->IsUp ())
         {
           NS_LOG_LOGIC ("Send to gateway " << route->GetGateway ());
-          if ( packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu () )
+          if (!offload
+              && (superSegment || packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu ()))
             {
               std::list<Ipv4PayloadHeaderPair> listFragments;
-              DoFragmentation (packet, ipHeader, outInterface->GetDevice ()->GetMtu (), listFragments);
+              if (superSegment)
+                {
+                  DoSegmentation (packet, ipHeader, gsoTag.GetSegmentSize (), listFragments);
+                }
+              else
+                {
+                  DoFragmentation (packet, ipHeader, outInterface->GetDevice ()->GetMtu (), listFragments);
+                }
               for ( std::list<Ipv4PayloadHeaderPair>::iterator it = listFragments.begin (); it != listFragments.end (); it++ )
                 {
                   CallTxTrace (it->second, it->first, m_node->GetObject<Ipv4> (), interface);
@@ -932,10 +961,18 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
       if (outInterface->IsUp ())
         {
           NS_LOG_LOGIC ("Send to destination " << ipHeader.GetDestination ());
-          if ( packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu () )
+          if (!offload
+              && (superSegment || packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu ()))
             {
               std::list<Ipv4PayloadHeaderPair> listFragments;
-              DoFragmentation (packet, ipHeader, outInterface->GetDevice ()->GetMtu (), listFragments);
+              if (superSegment)
+                {
+                  DoSegmentation (packet, ipHeader, gsoTag.GetSegmentSize (), listFragments);
+                }
+              else
+                {
+                  DoFragmentation (packet, ipHeader, outInterface->GetDevice ()->GetMtu (), listFragments);
+                }
               for ( std::list<Ipv4PayloadHeaderPair>::iterator it = listFragments.begin (); it != listFragments.end (); it++ )
                 {
                   NS_LOG_LOGIC ("Sending fragment " << *(it->first) );
@@ -1367,6 +1404,278 @@ Ipv4L3Protocol::RouteInputError (Ptr<const Packet> p, const Ipv4Header & ipHeade
   m_dropTrace (ipHeader, p, DROP_ROUTE_ERROR, m_node->GetObject<Ipv4> (), 0);
 }
 
+void
+Ipv4L3Protocol::DoSegmentation (Ptr<const Packet> packet, const Ipv4Header & ipv4Header, uint16_t segmentSize, std::list<Ipv4PayloadHeaderPair>& listSegments)
+{
+  NS_LOG_FUNCTION (packet << ipv4Header << segmentSize << &listSegments);
+  NS_ASSERT_MSG (ipv4Header.GetProtocol () == TcpL4Protocol::PROT_NUMBER,
+                 "IPv4 segmentation offload implementation only works with TCP.");
+  NS_ASSERT (segmentSize > 0);
+
+  Ptr<Packet> p = packet->Copy ();
+  GsoTag gsoTag;
+  p->RemovePacketTag (gsoTag);
+  TcpHeader tcpHeader;
+  p->RemoveHeader (tcpHeader);
+
+  uint32_t offset = 0;
+  uint16_t index = 0;
+  do
+    {
+      uint32_t currentSegmentSize = std::min<uint32_t> (segmentSize, p->GetSize () - offset);
+      bool lastSegment = (offset + currentSegmentSize == p->GetSize ());
+      Ptr<Packet> segment = p->CreateFragment (offset, currentSegmentSize);
+
+      TcpHeader segmentTcpHeader = tcpHeader;
+      segmentTcpHeader.SetSequenceNumber (tcpHeader.GetSequenceNumber () + offset);
+      uint8_t flags = tcpHeader.GetFlags ();
+      if (!lastSegment)
+        {
+          flags &= ~(TcpHeader::FIN | TcpHeader::PSH);
+        }
+      if (offset > 0)
+        {
+          flags &= ~TcpHeader::CWR;
+        }
+      segmentTcpHeader.SetFlags (flags);
+      if (Node::ChecksumEnabled ())
+        {
+          segmentTcpHeader.EnableChecksums ();
+          segmentTcpHeader.InitializeChecksum (ipv4Header.GetSource (), ipv4Header.GetDestination (),
+                                               ipv4Header.GetProtocol ());
+        }
+      segment->AddHeader (segmentTcpHeader);
+
+      Ipv4Header segmentHeader = ipv4Header;
+      segmentHeader.SetIdentification (ipv4Header.GetIdentification () + index);
+      segmentHeader.SetPayloadSize (segment->GetSize ());
+      if (Node::ChecksumEnabled ())
+        {
+          segmentHeader.EnableChecksum ();
+        }
+
+      NS_LOG_LOGIC ("New segment " << segmentHeader << " " << *segment);
+
+      listSegments.push_back (Ipv4PayloadHeaderPair (segment, segmentHeader));
+
+      offset += currentSegmentSize;
+      ++index;
+    }
+  while (offset < p->GetSize ());
+}
+
+std::list<Ptr<Packet> >
+Ipv4L3Protocol::SegmentPacket (Ptr<const Packet> packet)
+{
+  NS_LOG_FUNCTION (packet);
+
+  Ptr<Packet> p = packet->Copy ();
+  Ipv4Header ipv4Header;
+  p->RemoveHeader (ipv4Header);
+  GsoTag gsoTag;
+  p->PeekPacketTag (gsoTag);
+
+  std::list<Ipv4PayloadHeaderPair> listSegments;
+  DoSegmentation (p, ipv4Header, gsoTag.GetSegmentSize (), listSegments);
+
+  std::list<Ptr<Packet> > segments;
+  bool deferChecksums = ChecksumOffload::IsEnabled ();
+  for (std::list<Ipv4PayloadHeaderPair>::iterator it = listSegments.begin (); it != listSegments.end (); it++)
+    {
+      if (deferChecksums)
+        {
+          ChecksumOffload::Defer (it->first, PROT_NUMBER, it->second.GetSerializedSize ());
+        }
+      it->first->AddHeader (it->second);
+      segments.push_back (it->first);
+    }
+  return segments;
+}
+
+void
+Ipv4L3Protocol::CompleteChecksums (Buffer::Iterator start, uint32_t size)
+{
+  NS_LOG_FUNCTION (size);
+
+  Buffer::Iterator i = start;
+  uint8_t verIhl = i.ReadU8 ();
+  uint16_t headerSize = (verIhl & 0x0f) * 4;
+  if ((verIhl >> 4) != 4 || headerSize < 20 || headerSize > size)
+    {
+      NS_LOG_WARN ("Not an IPv4 header");
+      return;
+    }
+  i.Next (1);
+  uint16_t totalSize = i.ReadNtohU16 ();
+  i.Next (2);
+  uint16_t fragment = i.ReadNtohU16 ();
+  i.Next (1);
+  uint8_t protocol = i.ReadU8 ();
+  Buffer::Iterator checksum = i;
+  i.WriteU16 (0);
+  i = start;
+  checksum.WriteU16 (i.CalculateIpChecksum (headerSize));
+
+  // The transport checksum covers the whole datagram (MF flag and offset)
+  if ((fragment & 0x3fff) != 0 || totalSize < headerSize || totalSize > size)
+    {
+      return;
+    }
+  uint16_t transportSize = totalSize - headerSize;
+  uint16_t checksumOffset;
+  if (protocol == TcpL4Protocol::PROT_NUMBER)
+    {
+      checksumOffset = 16;
+    }
+  else if (protocol == UdpL4Protocol::PROT_NUMBER)
+    {
+      checksumOffset = 6;
+    }
+  else if (protocol == Icmpv4L4Protocol::PROT_NUMBER)
+    {
+      checksumOffset = 2;
+    }
+  else
+    {
+      return;
+    }
+  if (transportSize < checksumOffset + 2)
+    {
+      return;
+    }
+
+  uint32_t initialChecksum = 0;
+  if (protocol != Icmpv4L4Protocol::PROT_NUMBER)
+    {
+      // The pseudo-header: the addresses, the protocol and the size, in the
+      // byte order of Buffer::Iterator::ReadU16
+      i = start;
+      i.Next (12);
+      initialChecksum = static_cast<uint16_t> (~i.CalculateIpChecksum (8));
+      initialChecksum += (protocol << 8) + (transportSize >> 8) + ((transportSize & 0xff) << 8);
+    }
+  Buffer::Iterator transport = start;
+  transport.Next (headerSize);
+  checksum = transport;
+  checksum.Next (checksumOffset);
+  i = checksum;
+  i.WriteU16 (0);
+  uint16_t value = transport.CalculateIpChecksum (transportSize, initialChecksum);
+  if (value == 0 && protocol == UdpL4Protocol::PROT_NUMBER)
+    {
+      // A null UDP checksum means no checksum
+      value = 0xffff;
+    }
+  checksum.WriteU16 (value);
+}
+
+bool
+Ipv4L3Protocol::RemoveTcpHeaders (Ptr<Packet> packet, Ipv4Header & ipv4Header, TcpHeader & tcpHeader)
+{
+  NS_LOG_FUNCTION (packet);
+
+  if (Node::ChecksumEnabled ())
+    {
+      ipv4Header.EnableChecksum ();
+    }
+  packet->RemoveHeader (ipv4Header);
+  if (!ipv4Header.IsChecksumOk ()
+      || ipv4Header.GetProtocol () != TcpL4Protocol::PROT_NUMBER
+      || !ipv4Header.IsLastFragment () || ipv4Header.GetFragmentOffset () != 0
+      || packet->GetSize () != ipv4Header.GetPayloadSize ())
+    {
+      return false;
+    }
+
+  if (Node::ChecksumEnabled ())
+    {
+      tcpHeader.EnableChecksums ();
+      tcpHeader.InitializeChecksum (ipv4Header.GetSource (), ipv4Header.GetDestination (),
+                                    ipv4Header.GetProtocol ());
+    }
+  packet->RemoveHeader (tcpHeader);
+  return tcpHeader.IsChecksumOk ();
+}
+
+Ptr<Packet>
+Ipv4L3Protocol::CoalescePackets (Ptr<const Packet> held, Ptr<const Packet> packet)
+{
+  NS_LOG_FUNCTION (held << packet);
+
+  Ptr<Packet> h = held->Copy ();
+  Ipv4Header heldIpHeader;
+  TcpHeader heldTcpHeader;
+  Ptr<Packet> p = packet->Copy ();
+  Ipv4Header ipHeader;
+  TcpHeader tcpHeader;
+  if (!RemoveTcpHeaders (h, heldIpHeader, heldTcpHeader) || !RemoveTcpHeaders (p, ipHeader, tcpHeader))
+    {
+      return 0;
+    }
+
+  // Same flow, and the same IPv4 header but for the identification
+  if (ipHeader.GetSource () != heldIpHeader.GetSource ()
+      || ipHeader.GetDestination () != heldIpHeader.GetDestination ()
+      || tcpHeader.GetSourcePort () != heldTcpHeader.GetSourcePort ()
+      || tcpHeader.GetDestinationPort () != heldTcpHeader.GetDestinationPort ()
+      || ipHeader.GetTos () != heldIpHeader.GetTos ()
+      || ipHeader.GetTtl () != heldIpHeader.GetTtl ()
+      || ipHeader.IsDontFragment () != heldIpHeader.IsDontFragment ())
+    {
+      return 0;
+    }
+
+  // Contiguous data, behind the same ACK and window. Only the last segment
+  // may be shorter, or carry PSH; no other flag than ACK is merged.
+  GsoTag gsoTag;
+  uint32_t segmentSize = h->PeekPacketTag (gsoTag) ? gsoTag.GetSegmentSize () : h->GetSize ();
+  if (h->GetSize () == 0 || p->GetSize () == 0
+      || p->GetSize () > segmentSize || h->GetSize () % segmentSize != 0
+      || tcpHeader.GetSequenceNumber () != heldTcpHeader.GetSequenceNumber () + h->GetSize ()
+      || tcpHeader.GetAckNumber () != heldTcpHeader.GetAckNumber ()
+      || tcpHeader.GetWindowSize () != heldTcpHeader.GetWindowSize ()
+      || heldTcpHeader.GetFlags () != TcpHeader::ACK
+      || (tcpHeader.GetFlags () & ~TcpHeader::PSH) != TcpHeader::ACK
+      || heldIpHeader.GetSerializedSize () + heldTcpHeader.GetSerializedSize ()
+         + h->GetSize () + p->GetSize () > 65535)
+    {
+      return 0;
+    }
+
+  // Same options: only the timestamps, with the same values, so that the
+  // receiver echoes and measures as for each segment
+  if (tcpHeader.GetOptionLength () != heldTcpHeader.GetOptionLength ()
+      || tcpHeader.HasOption (TcpOption::TS) != heldTcpHeader.HasOption (TcpOption::TS)
+      || tcpHeader.HasOption (TcpOption::SACK) || heldTcpHeader.HasOption (TcpOption::SACK))
+    {
+      return 0;
+    }
+  if (tcpHeader.HasOption (TcpOption::TS))
+    {
+      Ptr<const TcpOptionTS> ts = DynamicCast<const TcpOptionTS> (tcpHeader.GetOption (TcpOption::TS));
+      Ptr<const TcpOptionTS> heldTs = DynamicCast<const TcpOptionTS> (heldTcpHeader.GetOption (TcpOption::TS));
+      if (ts->GetTimestamp () != heldTs->GetTimestamp () || ts->GetEcho () != heldTs->GetEcho ())
+        {
+          return 0;
+        }
+    }
+
+  h->RemovePacketTag (gsoTag);
+  h->AddAtEnd (p);
+  h->AddPacketTag (GsoTag (segmentSize));
+
+  heldTcpHeader.SetFlags (heldTcpHeader.GetFlags () | tcpHeader.GetFlags ());
+  if (Node::ChecksumEnabled ())
+    {
+      heldTcpHeader.InitializeChecksum (heldIpHeader.GetSource (), heldIpHeader.GetDestination (),
+                                        heldIpHeader.GetProtocol ());
+    }
+  h->AddHeader (heldTcpHeader);
+  heldIpHeader.SetPayloadSize (h->GetSize ());
+  h->AddHeader (heldIpHeader);
+  return h;
+}
+
 void
 Ipv4L3Protocol::DoFragmentation (Ptr<Packet> packet, const Ipv4Header & ipv4Header, uint32_t outIfaceMtu, std::list<Ipv4PayloadHeaderPair>& listFragments)
 {
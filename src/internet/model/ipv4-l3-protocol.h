@@ -44,6 +44,7 @@ class NetDevice;
 class Ipv4Interface;
 class Ipv4Address;
 class Ipv4Header;
+class TcpHeader;
 class Ipv4RoutingTableEntry;
 class Ipv4Route;
 class Node;
@@ -400,6 +401,64 @@ private:
    */
   void DoFragmentation (Ptr<Packet> packet, const Ipv4Header & ipv4Header, uint32_t outIfaceMtu, std::list<Ipv4PayloadHeaderPair>& listFragments);
 
+  /**
+   * \brief Split a TCP super-segment (see GsoTag) in segments
+   *
+   * Each segment gets a copy of the TCP header, with its own sequence
+   * number, and of the IPv4 header, with its own identification. FIN and
+   * PSH are kept on the last segment only, CWR on the first one.
+   *
+   * \param packet the super-segment, starting with the TCP header
+   * \param ipv4Header the IPv4 header
+   * \param segmentSize the payload of each segment
+   * \param listSegments the list of segments
+   */
+  static void DoSegmentation (Ptr<const Packet> packet, const Ipv4Header & ipv4Header, uint16_t segmentSize, std::list<Ipv4PayloadHeaderPair>& listSegments);
+
+  /**
+   * \brief Split a TCP super-segment, for a device which supports the
+   * segmentation offload
+   * \param packet the super-segment, starting with the IPv4 header
+   * \return the segments, starting with the IPv4 header
+   */
+  static std::list<Ptr<Packet> > SegmentPacket (Ptr<const Packet> packet);
+
+  /**
+   * \brief Merge a received TCP segment into the preceding one, for a
+   * device which coalesces the received segments
+   *
+   * The segments must be of the same flow, contiguous, and carry the same
+   * headers but for the sequence number, the IPv4 identification and PSH,
+   * which the last segment may carry. The merged segment is marked with a
+   * GsoTag carrying the size of the first segment.
+   *
+   * \param held the preceding segment, starting with the IPv4 header
+   * \param packet the segment received after it, starting with the IPv4 header
+   * \return the merged segment, or 0 if they cannot be merged
+   */
+  static Ptr<Packet> CoalescePackets (Ptr<const Packet> held, Ptr<const Packet> packet);
+
+  /**
+   * \brief Remove the IPv4 and TCP headers of a received segment
+   * \param packet the segment
+   * \param ipv4Header the IPv4 header
+   * \param tcpHeader the TCP header
+   * \return true if the segment is an unfragmented TCP segment, with
+   *         valid checksums if enabled
+   */
+  static bool RemoveTcpHeaders (Ptr<Packet> packet, Ipv4Header & ipv4Header, TcpHeader & tcpHeader);
+
+  /**
+   * \brief Fill the checksums of a packet whose checksums were deferred
+   *
+   * Fill the checksum of the IPv4 header and, for an unfragmented packet,
+   * the checksum of the TCP, UDP or ICMP header it carries.
+   *
+   * \param start the start of the IPv4 header
+   * \param size the size of the packet, IPv4 header included
+   */
+  static void CompleteChecksums (Buffer::Iterator start, uint32_t size);
+
   /**
    * \brief Process a packet fragment
    * \param packet the packet
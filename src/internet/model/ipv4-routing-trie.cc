@@ -0,0 +1,240 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ipv4-routing-trie.h"
+#include "ipv4-routing-table-entry.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ipv4RoutingTrie");
+
+const uint32_t Ipv4RoutingTrie::MAX_MATCHES;
+
+Ipv4RoutingTrie::Ipv4RoutingTrie ()
+  : m_root (0),
+    m_n (0),
+    m_sequence (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+Ipv4RoutingTrie::~Ipv4RoutingTrie ()
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+}
+
+uint32_t
+Ipv4RoutingTrie::GetMask (uint8_t length)
+{
+  return length == 0 ? 0 : 0xffffffff << (32 - length);
+}
+
+uint32_t
+Ipv4RoutingTrie::GetBit (uint32_t address, uint8_t index)
+{
+  return (address >> (31 - index)) & 1;
+}
+
+void
+Ipv4RoutingTrie::GetPrefix (const Ipv4RoutingTableEntry *entry, uint32_t *prefix, uint8_t *length)
+{
+  *length = entry->GetDestNetworkMask ().GetPrefixLength ();
+  *prefix = entry->GetDestNetwork ().Get () & GetMask (*length);
+}
+
+void
+Ipv4RoutingTrie::Add (Ipv4RoutingTableEntry *entry, uint32_t metric)
+{
+  NS_LOG_FUNCTION (this << entry << metric);
+  uint32_t prefix;
+  uint8_t length;
+  GetPrefix (entry, &prefix, &length);
+  Route route;
+  route.entry = entry;
+  route.metric = metric;
+  route.sequence = m_sequence++;
+  m_n++;
+
+  Node **link = &m_root;
+  while (true)
+    {
+      Node *node = *link;
+      if (node == 0)
+        {
+          node = new Node;
+          node->prefix = prefix;
+          node->length = length;
+          node->child[0] = 0;
+          node->child[1] = 0;
+          node->routes.push_back (route);
+          *link = node;
+          return;
+        }
+      // the length of the prefix common to the node and the route
+      uint8_t common = 0;
+      uint8_t shortest = std::min (length, node->length);
+      while (common < shortest && GetBit (prefix ^ node->prefix, common) == 0)
+        {
+          common++;
+        }
+      if (common == node->length)
+        {
+          if (length == node->length)
+            {
+              node->routes.push_back (route);
+              return;
+            }
+          link = &node->child[GetBit (prefix, node->length)];
+          continue;
+        }
+      // the route and the node diverge inside the prefix of the node
+      Node *parent = new Node;
+      parent->prefix = prefix & GetMask (common);
+      parent->length = common;
+      parent->child[0] = 0;
+      parent->child[1] = 0;
+      parent->child[GetBit (node->prefix, common)] = node;
+      *link = parent;
+      if (common == length)
+        {
+          parent->routes.push_back (route);
+          return;
+        }
+      link = &parent->child[GetBit (prefix, common)];
+    }
+}
+
+bool
+Ipv4RoutingTrie::Remove (Ipv4RoutingTableEntry *entry)
+{
+  NS_LOG_FUNCTION (this << entry);
+  uint32_t prefix;
+  uint8_t length;
+  GetPrefix (entry, &prefix, &length);
+
+  // the links to the nodes from the root to the node of the prefix
+  Node **links[MAX_MATCHES];
+  uint32_t depth = 0;
+  Node **link = &m_root;
+  while (true)
+    {
+      Node *node = *link;
+      if (node == 0 || node->length > length || (prefix & GetMask (node->length)) != node->prefix)
+        {
+          return false;
+        }
+      links[depth++] = link;
+      if (node->length == length)
+        {
+          break;
+        }
+      link = &node->child[GetBit (prefix, node->length)];
+    }
+
+  Routes &routes = (*links[depth - 1])->routes;
+  Routes::iterator i;
+  for (i = routes.begin (); i != routes.end () && i->entry != entry; i++)
+    {
+    }
+  if (i == routes.end ())
+    {
+      return false;
+    }
+  routes.erase (i);
+  m_n--;
+
+  // remove the nodes left without route and with a single child
+  while (depth > 0)
+    {
+      Node *node = *links[--depth];
+      if (!node->routes.empty () || (node->child[0] != 0 && node->child[1] != 0))
+        {
+          break;
+        }
+      Node *child = node->child[0] != 0 ? node->child[0] : node->child[1];
+      *links[depth] = child;
+      delete node;
+      if (child != 0)
+        {
+          // the parent keeps its number of children
+          break;
+        }
+    }
+  return true;
+}
+
+void
+Ipv4RoutingTrie::Delete (Node *node)
+{
+  if (node != 0)
+    {
+      Delete (node->child[0]);
+      Delete (node->child[1]);
+      delete node;
+    }
+}
+
+void
+Ipv4RoutingTrie::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  Delete (m_root);
+  m_root = 0;
+  m_n = 0;
+}
+
+uint32_t
+Ipv4RoutingTrie::GetN (void) const
+{
+  return m_n;
+}
+
+uint32_t
+Ipv4RoutingTrie::Lookup (Ipv4Address dest, const Routes *matches[MAX_MATCHES], uint8_t lengths[MAX_MATCHES]) const
+{
+  NS_LOG_FUNCTION (this << dest);
+  uint32_t address = dest.Get ();
+  uint32_t n = 0;
+  const Node *node = m_root;
+  while (node != 0 && (address & GetMask (node->length)) == node->prefix)
+    {
+      if (!node->routes.empty ())
+        {
+          matches[n] = &node->routes;
+          lengths[n] = node->length;
+          n++;
+        }
+      if (node->length == 32)
+        {
+          break;
+        }
+      node = node->child[GetBit (address, node->length)];
+    }
+  // from the longest prefix to the shortest
+  for (uint32_t i = 0; i < n / 2; i++)
+    {
+      std::swap (matches[i], matches[n - 1 - i]);
+      std::swap (lengths[i], lengths[n - 1 - i]);
+    }
+  return n;
+}
+
+} // namespace ns3
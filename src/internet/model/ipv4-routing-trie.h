@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef IPV4_ROUTING_TRIE_H
+#define IPV4_ROUTING_TRIE_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "ns3/ipv4-address.h"
+
+namespace ns3 {
+
+class Ipv4RoutingTableEntry;
+
+/**
+ * \ingroup internet
+ *
+ * \brief An index of the routing table entries of Ipv4GlobalRouting and
+ * Ipv4StaticRouting by destination prefix.
+ *
+ * The index is a path compressed binary trie: each node holds a prefix,
+ * i.e., a network address and a prefix length, and the routes to this
+ * prefix, and the nodes with a single child and no route are skipped.
+ * A lookup visits at most 33 nodes whatever the number of routes, and
+ * returns the routes of all the prefixes containing the destination.
+ *
+ * The routes of a prefix are kept in the order in which they were added,
+ * and each route has a sequence number, so that the routing protocols can
+ * choose among the routes of several prefixes as they did with their
+ * lists of routes: several routes of the same prefix are equal cost
+ * multipath routes.
+ *
+ * A route with a non-contiguous mask is indexed by the prefix of the
+ * leading ones of the mask: the routing protocols check the mask of the
+ * routes they find.  The entries are not owned by the trie.
+ */
+class Ipv4RoutingTrie
+{
+public:
+  /** A route of a prefix */
+  struct Route
+  {
+    Ipv4RoutingTableEntry *entry; //!< The routing table entry
+    uint32_t metric;              //!< The metric of the route
+    uint64_t sequence;            //!< The order in which the routes were added
+  };
+  /** The routes of a prefix */
+  typedef std::vector<Route> Routes;
+
+  /** The maximum number of prefixes containing an address: /0 to /32 */
+  static const uint32_t MAX_MATCHES = 33;
+
+  Ipv4RoutingTrie ();
+  ~Ipv4RoutingTrie ();
+
+  /**
+   * \brief Add a route after the routes of its prefix.
+   * \param entry the routing table entry
+   * \param metric the metric of the route
+   */
+  void Add (Ipv4RoutingTableEntry *entry, uint32_t metric = 0);
+  /**
+   * \brief Remove a route.
+   * \param entry the routing table entry
+   * \returns true if the route was found
+   */
+  bool Remove (Ipv4RoutingTableEntry *entry);
+  /**
+   * \brief Remove all the routes.
+   */
+  void Clear (void);
+  /**
+   * \returns the number of routes
+   */
+  uint32_t GetN (void) const;
+  /**
+   * \brief Find the prefixes containing an address.
+   * \param dest the address
+   * \param matches the routes of the prefixes containing the address, from
+   *        the longest prefix to the shortest
+   * \param lengths the lengths of the prefixes
+   * \returns the number of prefixes found, at most MAX_MATCHES
+   */
+  uint32_t Lookup (Ipv4Address dest, const Routes *matches[MAX_MATCHES], uint8_t lengths[MAX_MATCHES]) const;
+
+private:
+  /** A node of the trie */
+  struct Node
+  {
+    uint32_t prefix;   //!< The network address, zero after the prefix length
+    uint8_t length;    //!< The prefix length
+    Node *child[2];    //!< The children, by the bit following the prefix
+    Routes routes;     //!< The routes of the prefix
+  };
+
+  /**
+   * Copy constructor, disabled
+   * \param o the object to copy
+   */
+  Ipv4RoutingTrie (const Ipv4RoutingTrie &o);
+  /**
+   * Assignment, disabled
+   * \param o the object to copy
+   * \returns this
+   */
+  Ipv4RoutingTrie &operator = (const Ipv4RoutingTrie &o);
+
+  /**
+   * \param entry a routing table entry
+   * \param prefix the prefix of the entry
+   * \param length the prefix length of the entry
+   */
+  static void GetPrefix (const Ipv4RoutingTableEntry *entry, uint32_t *prefix, uint8_t *length);
+  /**
+   * \param length a prefix length
+   * \returns the mask of the prefix length
+   */
+  static uint32_t GetMask (uint8_t length);
+  /**
+   * \param address an address
+   * \param index the index of a bit, from the most significant
+   * \returns the bit
+   */
+  static uint32_t GetBit (uint32_t address, uint8_t index);
+  /**
+   * \param node a node and its descendants to delete
+   */
+  static void Delete (Node *node);
+
+  Node *m_root;        //!< The root of the trie, or 0
+  uint32_t m_n;        //!< The number of routes
+  uint64_t m_sequence; //!< The sequence number of the next route
+};
+
+} // namespace ns3
+
+#endif /* IPV4_ROUTING_TRIE_H */
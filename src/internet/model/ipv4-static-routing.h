@@ -31,6 +31,7 @@
 #include "ns3/ptr.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "ns3/ipv4-routing-trie.h"
 
 namespace ns3 {
 
@@ -422,6 +423,11 @@ private:
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the index of the forwarding table for network, by prefix.
+   */
+  Ipv4RoutingTrie m_networkTrie;
+
   /**
    * \brief the forwarding table for multicast.
    */
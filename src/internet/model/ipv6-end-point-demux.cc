@@ -20,6 +20,7 @@
 
 #include "ipv6-end-point-demux.h"
 #include "ipv6-end-point.h"
+#include <algorithm>
 #include "ns3/log.h"
 
 namespace ns3 {
@@ -29,7 +30,8 @@ NS_LOG_COMPONENT_DEFINE ("Ipv6EndPointDemux");
 Ipv6EndPointDemux::Ipv6EndPointDemux ()
   : m_ephemeral (49152),
     m_portFirst (49152),
-    m_portLast (65535)
+    m_portLast (65535),
+    m_sequence (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -40,6 +42,7 @@ Ipv6EndPointDemux::~Ipv6EndPointDemux ()
   for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
     {
       Ipv6EndPoint *endPoint = *i;
+      endPoint->m_demux = 0;
       delete endPoint;
     }
   m_endPoints.clear ();
@@ -48,19 +51,16 @@ Ipv6EndPointDemux::~Ipv6EndPointDemux ()
 bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
 {
   NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
-    {
-      if ((*i)->GetLocalPort  () == port)
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_ports.Find (port) != 0;
 }
 
 bool Ipv6EndPointDemux::LookupLocal (Ipv6Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
+  if (!LookupPortLocal (port))
+    {
+      return false;
+    }
   for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
     {
       if ((*i)->GetLocalPort () == port
@@ -81,10 +81,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate ()
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (Ipv6Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Add (new Ipv6EndPoint (Ipv6Address::GetAny (), port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
@@ -96,10 +93,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
       NS_LOG_WARN ("Ephemeral port allocation failed.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Add (new Ipv6EndPoint (address, port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (uint16_t port)
@@ -117,22 +111,29 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address, uint16_t port)
       NS_LOG_WARN ("Duplicate address/port; failing.");
       return 0;
     }
-  Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-  return endPoint;
+  return Add (new Ipv6EndPoint (address, port));
 }
 
 Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address localAddress, uint16_t localPort,
                                            Ipv6Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  FourTuple tuple;
+  const Bucket *bucket;
+  if (GetFourTuple (localAddress, localPort, peerAddress, peerPort, tuple))
+    {
+      bucket = m_connected.Find (tuple);
+    }
+  else
     {
-      if ((*i)->GetLocalPort () == localPort
-          && (*i)->GetLocalAddress () == localAddress
-          && (*i)->GetPeerPort () == peerPort
-          && (*i)->GetPeerAddress () == peerAddress)
+      bucket = m_wildcards.Find (localPort);
+    }
+  for (uint32_t i = 0; bucket != 0 && i < bucket->size (); i++)
+    {
+      Ipv6EndPoint *other = (*bucket)[i].second;
+      if (other->GetLocalAddress () == localAddress
+          && other->GetPeerPort () == peerPort
+          && other->GetPeerAddress () == peerAddress)
         {
           NS_LOG_WARN ("No way we can allocate this end-point.");
           /* no way we can allocate this end-point. */
@@ -141,25 +142,95 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address localAddress, uint16_t lo
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
+  return Add (endPoint);
+}
 
+Ipv6EndPoint* Ipv6EndPointDemux::Add (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  m_endPoints.push_back (endPoint);
+  Record record;
+  record.position = --m_endPoints.end ();
+  record.sequence = m_sequence++;
+  m_records[reinterpret_cast<uintptr_t> (endPoint)] = record;
+  endPoint->m_demux = this;
+  Index (endPoint);
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
-
   return endPoint;
 }
 
-void Ipv6EndPointDemux::DeAllocate (Ipv6EndPoint *endPoint)
+bool Ipv6EndPointDemux::GetFourTuple (Ipv6Address localAddress, uint16_t localPort,
+                                      Ipv6Address peerAddress, uint16_t peerPort,
+                                      FourTuple &tuple)
 {
-  NS_LOG_FUNCTION_NOARGS ();
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  tuple.localAddress = localAddress;
+  tuple.peerAddress = peerAddress;
+  tuple.localPort = localPort;
+  tuple.peerPort = peerPort;
+  return localAddress != Ipv6Address::GetAny ()
+         && peerAddress != Ipv6Address::GetAny ()
+         && peerPort != 0;
+}
+
+bool Ipv6EndPointDemux::GetFourTuple (Ipv6EndPoint *endPoint, FourTuple &tuple)
+{
+  return GetFourTuple (endPoint->GetLocalAddress (), endPoint->GetLocalPort (),
+                       endPoint->GetPeerAddress (), endPoint->GetPeerPort (),
+                       tuple);
+}
+
+void Ipv6EndPointDemux::Index (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  std::pair<uint64_t, Ipv6EndPoint *> entry (m_records.Find (reinterpret_cast<uintptr_t> (endPoint))->sequence, endPoint);
+  FourTuple tuple;
+  Bucket &bucket = GetFourTuple (endPoint, tuple) ? m_connected[tuple] : m_wildcards[endPoint->GetLocalPort ()];
+  bucket.insert (std::upper_bound (bucket.begin (), bucket.end (), entry), entry);
+  m_ports[endPoint->GetLocalPort ()]++;
+}
+
+void Ipv6EndPointDemux::Unindex (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  std::pair<uint64_t, Ipv6EndPoint *> entry (m_records.Find (reinterpret_cast<uintptr_t> (endPoint))->sequence, endPoint);
+  FourTuple tuple;
+  bool connected = GetFourTuple (endPoint, tuple);
+  Bucket *bucket = connected ? m_connected.Find (tuple) : m_wildcards.Find (endPoint->GetLocalPort ());
+  NS_ASSERT (bucket != 0);
+  Bucket::iterator i = std::lower_bound (bucket->begin (), bucket->end (), entry);
+  NS_ASSERT (i != bucket->end () && *i == entry);
+  bucket->erase (i);
+  if (bucket->empty ())
     {
-      if (*i == endPoint)
+      if (connected)
+        {
+          m_connected.Erase (tuple);
+        }
+      else
         {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
+          m_wildcards.Erase (endPoint->GetLocalPort ());
         }
     }
+  uint32_t *count = m_ports.Find (endPoint->GetLocalPort ());
+  if (--*count == 0)
+    {
+      m_ports.Erase (endPoint->GetLocalPort ());
+    }
+}
+
+void Ipv6EndPointDemux::DeAllocate (Ipv6EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Record *record = m_records.Find (reinterpret_cast<uintptr_t> (endPoint));
+  if (record == 0)
+    {
+      return;
+    }
+  m_endPoints.erase (record->position);
+  Unindex (endPoint);
+  m_records.Erase (reinterpret_cast<uintptr_t> (endPoint));
+  endPoint->m_demux = 0;
+  delete endPoint;
 }
 
 /*
@@ -178,10 +249,28 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
   EndPoints retval3; /* Matches all but local address */
   EndPoints retval4; /* Exact match on all 4 */
 
+  /* The end points which may match, in the order of their allocation: a
+     connected end point matches only the packets of its four-tuple */
+  FourTuple tuple;
+  GetFourTuple (daddr, dport, saddr, sport, tuple);
+  const Bucket *connected = m_connected.Find (tuple);
+  const Bucket *wildcards = m_wildcards.Find (dport);
+  Bucket candidates;
+  if (connected != 0)
+    {
+      candidates = *connected;
+    }
+  if (wildcards != 0)
+    {
+      uint32_t n = candidates.size ();
+      candidates.insert (candidates.end (), wildcards->begin (), wildcards->end ());
+      std::inplace_merge (candidates.begin (), candidates.begin () + n, candidates.end ());
+    }
+
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  for (Bucket::iterator i = candidates.begin (); i != candidates.end (); i++)
     {
-      Ipv6EndPoint* endP = *i;
+      Ipv6EndPoint* endP = i->second;
 
       NS_LOG_DEBUG ("Looking at endpoint dport=" << endP->GetLocalPort ()
                                                  << " daddr=" << endP->GetLocalAddress ()
@@ -293,6 +382,21 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
 
 Ipv6EndPoint* Ipv6EndPointDemux::SimpleLookup (Ipv6Address dst, uint16_t dport, Ipv6Address src, uint16_t sport)
 {
+  if (!LookupPortLocal (dport))
+    {
+      return 0;
+    }
+  /* a fully specified four-tuple can only match a connected end point */
+  FourTuple tuple;
+  if (GetFourTuple (dst, dport, src, sport, tuple))
+    {
+      const Bucket *connected = m_connected.Find (tuple);
+      if (connected != 0)
+        {
+          return connected->front ().second;
+        }
+    }
+
   uint32_t genericity = 3;
   Ipv6EndPoint *generic = 0;
 
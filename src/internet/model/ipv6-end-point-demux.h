@@ -23,7 +23,10 @@
 
 #include <stdint.h>
 #include <list>
+#include <vector>
+#include <utility>
 #include "ns3/ipv6-address.h"
+#include "ns3/flat-hash-map.h"
 #include "ipv6-interface.h"
 
 namespace ns3 {
@@ -33,6 +36,10 @@ class Ipv6EndPoint;
 /**
  * \class Ipv6EndPointDemux
  * \brief Demultiplexor for end points.
+ *
+ * The end points with a local address, a peer address and a peer port
+ * are indexed by their four-tuple in a hash table, and the other end
+ * points by their local port, as in Ipv4EndPointDemux.
  */
 class Ipv6EndPointDemux
 {
@@ -146,6 +153,104 @@ public:
   EndPoints GetEndPoints () const;
 
 private:
+  friend class Ipv6EndPoint;
+
+  /**
+   * \brief The four-tuple of a connected end point.
+   */
+  struct FourTuple
+  {
+    Ipv6Address localAddress; //!< The local address
+    Ipv6Address peerAddress;  //!< The peer address
+    uint16_t localPort;       //!< The local port
+    uint16_t peerPort;        //!< The peer port
+    /**
+     * \param o another four-tuple
+     * \returns true if the four-tuples are equal
+     */
+    bool operator == (const FourTuple &o) const
+    {
+      return localAddress == o.localAddress && peerAddress == o.peerAddress
+             && localPort == o.localPort && peerPort == o.peerPort;
+    }
+  };
+
+  /**
+   * \brief The hash of a four-tuple.
+   */
+  struct FourTupleHash
+  {
+    /**
+     * \param t a four-tuple
+     * \returns the hash of the four-tuple
+     */
+    uint32_t operator () (const FourTuple &t) const
+    {
+      Ipv6AddressHash addressHash;
+      FlatHashMapHash<uint64_t> hash;
+      uint64_t ports = (static_cast<uint64_t> (t.localPort) << 16) | t.peerPort;
+      uint64_t addresses = (static_cast<uint64_t> (addressHash (t.localAddress)) << 32)
+        ^ addressHash (t.peerAddress);
+      return hash (addresses ^ hash (ports));
+    }
+  };
+
+  /**
+   * \brief The end points of a four-tuple or of a local port, with the
+   * order in which they were allocated.
+   */
+  typedef std::vector<std::pair<uint64_t, Ipv6EndPoint *> > Bucket;
+
+  /**
+   * \brief Where an end point is kept.
+   */
+  struct Record
+  {
+    EndPointsI position; //!< The position in the list of the end points
+    uint64_t sequence;   //!< The order in which the end point was allocated
+  };
+
+  /**
+   * \brief Add an end point to the demux.
+   * \param endPoint the end point
+   * \returns the end point
+   */
+  Ipv6EndPoint *Add (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Index an end point by its four-tuple or by its local port, and
+   * count it in the end points of its local port.
+   * \param endPoint the end point
+   */
+  void Index (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Remove an end point from the index of Index ().
+   * \param endPoint the end point
+   */
+  void Unindex (Ipv6EndPoint *endPoint);
+
+  /**
+   * \param localAddress the local address
+   * \param localPort the local port
+   * \param peerAddress the peer address
+   * \param peerPort the peer port
+   * \param [out] tuple the four-tuple
+   * \returns true if the local address, the peer address and the peer
+   *          port are specified
+   */
+  static bool GetFourTuple (Ipv6Address localAddress, uint16_t localPort,
+                            Ipv6Address peerAddress, uint16_t peerPort,
+                            FourTuple &tuple);
+
+  /**
+   * \param endPoint an end point
+   * \param [out] tuple the four-tuple of the end point
+   * \returns true if the end point has a local address, a peer address
+   *          and a peer port
+   */
+  static bool GetFourTuple (Ipv6EndPoint *endPoint, FourTuple &tuple);
+
   /**
    * \brief Allocate a ephemeral port.
    * \return a port
@@ -171,6 +276,31 @@ private:
    * \brief A list of IPv6 end points.
    */
   EndPoints m_endPoints;
+
+  /**
+   * \brief The position and the sequence of the end points, by address.
+   */
+  FlatHashMap<uintptr_t, Record> m_records;
+
+  /**
+   * \brief The number of end points of the local ports.
+   */
+  FlatHashMap<uint16_t, uint32_t> m_ports;
+
+  /**
+   * \brief The connected end points, by four-tuple.
+   */
+  FlatHashMap<FourTuple, Bucket, FourTupleHash> m_connected;
+
+  /**
+   * \brief The other end points, by local port.
+   */
+  FlatHashMap<uint16_t, Bucket> m_wildcards;
+
+  /**
+   * \brief The sequence of the next end point.
+   */
+  uint64_t m_sequence;
 };
 
 } /* namespace ns3 */
@@ -34,6 +34,7 @@ namespace ns3
 
 class Header;
 class Packet;
+class Ipv6EndPointDemux;
 
 /**
  * \brief A representation of an internet IPv6 endpoint/connection
@@ -190,6 +191,13 @@ public:
   bool IsRxEnabled (void);
 
 private:
+  friend class Ipv6EndPointDemux;
+
+  /**
+   * \brief The demux which indexes this end point, or 0.
+   */
+  Ipv6EndPointDemux *m_demux;
+
   /**
    * \brief The local address.
    */
@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "static-neighbor-table.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("StaticNeighborTable");
+
+NS_OBJECT_ENSURE_REGISTERED (StaticNeighborTable);
+
+TypeId
+StaticNeighborTable::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::StaticNeighborTable")
+    .SetParent<Object> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<StaticNeighborTable> ()
+  ;
+  return tid;
+}
+
+StaticNeighborTable::StaticNeighborTable ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+StaticNeighborTable::~StaticNeighborTable ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint32_t
+StaticNeighborTable::GetIndex (const Address &hardwareAddress)
+{
+  // The addresses of a device are added one after the other
+  if (m_hardwareAddresses.empty () || !(m_hardwareAddresses.back () == hardwareAddress))
+    {
+      m_hardwareAddresses.push_back (hardwareAddress);
+    }
+  return m_hardwareAddresses.size () - 1;
+}
+
+void
+StaticNeighborTable::Add (Ipv4Address address, const Address &hardwareAddress)
+{
+  NS_LOG_FUNCTION (this << address << hardwareAddress);
+  if (m_ipv4.Find (address.Get ()) != 0)
+    {
+      NS_LOG_WARN ("Duplicate IPv4 address " << address << ", keeping the first one");
+      return;
+    }
+  m_ipv4[address.Get ()] = GetIndex (hardwareAddress);
+}
+
+void
+StaticNeighborTable::Add (Ipv6Address address, const Address &hardwareAddress)
+{
+  NS_LOG_FUNCTION (this << address << hardwareAddress);
+  if (m_ipv6.Find (address) != 0)
+    {
+      NS_LOG_WARN ("Duplicate IPv6 address " << address << ", keeping the first one");
+      return;
+    }
+  m_ipv6[address] = GetIndex (hardwareAddress);
+}
+
+bool
+StaticNeighborTable::Lookup (Ipv4Address address, Address *hardwareAddress) const
+{
+  NS_LOG_FUNCTION (this << address);
+  uint32_t const *index = m_ipv4.Find (address.Get ());
+  if (index == 0)
+    {
+      return false;
+    }
+  *hardwareAddress = m_hardwareAddresses[*index];
+  return true;
+}
+
+bool
+StaticNeighborTable::Lookup (Ipv6Address address, Address *hardwareAddress) const
+{
+  NS_LOG_FUNCTION (this << address);
+  uint32_t const *index = m_ipv6.Find (address);
+  if (index == 0)
+    {
+      return false;
+    }
+  *hardwareAddress = m_hardwareAddresses[*index];
+  return true;
+}
+
+uint32_t
+StaticNeighborTable::GetNIpv4Addresses (void) const
+{
+  return m_ipv4.GetSize ();
+}
+
+uint32_t
+StaticNeighborTable::GetNIpv6Addresses (void) const
+{
+  return m_ipv6.GetSize ();
+}
+
+} // namespace ns3
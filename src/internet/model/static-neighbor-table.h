@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef STATIC_NEIGHBOR_TABLE_H
+#define STATIC_NEIGHBOR_TABLE_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/address.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv6-address.h"
+#include "ns3/flat-hash-map.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief The hardware addresses of the IPv4 and IPv6 addresses of all the
+ * nodes, shared by their ARP and NDisc.
+ *
+ * The table is built once, usually by
+ * InternetStackHelper::PopulateStaticNeighborTables, and is not modified
+ * afterwards.  ArpL3Protocol and Icmpv6L4Protocol look up the
+ * destinations in it before their caches, so that the addresses it holds
+ * are resolved without ARP or NDisc exchange, and without any per-node
+ * cache entry.  A destination missing from the table is resolved as
+ * usual.
+ *
+ * A lookup is a single probe of a hash table.  The hardware addresses
+ * are stored once for all the IP addresses of a device.  The IP
+ * addresses must be unique in the simulation: the first hardware address
+ * added for an IP address is kept.
+ */
+class StaticNeighborTable : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  StaticNeighborTable ();
+  virtual ~StaticNeighborTable ();
+
+  /**
+   * \brief Add the hardware address of an IPv4 address
+   * \param address the IPv4 address
+   * \param hardwareAddress the hardware address
+   */
+  void Add (Ipv4Address address, const Address &hardwareAddress);
+  /**
+   * \brief Add the hardware address of an IPv6 address
+   * \param address the IPv6 address
+   * \param hardwareAddress the hardware address
+   */
+  void Add (Ipv6Address address, const Address &hardwareAddress);
+
+  /**
+   * \brief Look up the hardware address of an IPv4 address
+   * \param address the IPv4 address
+   * \param [out] hardwareAddress the hardware address, if found
+   * \returns true if the address is in the table
+   */
+  bool Lookup (Ipv4Address address, Address *hardwareAddress) const;
+  /**
+   * \brief Look up the hardware address of an IPv6 address
+   * \param address the IPv6 address
+   * \param [out] hardwareAddress the hardware address, if found
+   * \returns true if the address is in the table
+   */
+  bool Lookup (Ipv6Address address, Address *hardwareAddress) const;
+
+  /**
+   * \returns the number of IPv4 addresses in the table
+   */
+  uint32_t GetNIpv4Addresses (void) const;
+  /**
+   * \returns the number of IPv6 addresses in the table
+   */
+  uint32_t GetNIpv6Addresses (void) const;
+
+private:
+  /**
+   * \brief The hash of an IPv6 address.
+   */
+  struct Ipv6Hash
+  {
+    /**
+     * \param address an IPv6 address
+     * \returns the hash of the address
+     */
+    uint32_t operator () (const Ipv6Address &address) const
+    {
+      return static_cast<uint32_t> (Ipv6AddressHash () (address));
+    }
+  };
+
+  /**
+   * \brief Get the index of a hardware address, adding it if it is not
+   * the last one added
+   * \param hardwareAddress the hardware address
+   * \returns the index of the hardware address
+   */
+  uint32_t GetIndex (const Address &hardwareAddress);
+
+  std::vector<Address> m_hardwareAddresses;                 //!< The hardware addresses
+  FlatHashMap<uint32_t, uint32_t> m_ipv4;                   //!< IPv4 address --> index of the hardware address
+  FlatHashMap<Ipv6Address, uint32_t, Ipv6Hash> m_ipv6;      //!< IPv6 address --> index of the hardware address
+};
+
+} // namespace ns3
+
+#endif /* STATIC_NEIGHBOR_TABLE_H */
@@ -0,0 +1,495 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "tcp-bbr.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/tcp-socket-base.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpBbr");
+NS_OBJECT_ENSURE_REGISTERED (TcpBbr);
+
+const double TcpBbr::PACING_GAIN_CYCLE[] = {1.25, 0.75, 1, 1, 1, 1, 1, 1};
+const uint32_t TcpBbr::GAIN_CYCLE_LENGTH = 8;
+
+TypeId
+TcpBbr::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpBbr")
+    .SetParent<TcpCongestionOps> ()
+    .AddConstructor<TcpBbr> ()
+    .SetGroupName ("Internet")
+    .AddAttribute ("HighGain", "Pacing and cWnd gain of the startup",
+                   DoubleValue (2.885),
+                   MakeDoubleAccessor (&TcpBbr::m_highGain),
+                   MakeDoubleChecker<double> (1.0))
+    .AddAttribute ("CwndGain", "cWnd gain in PROBE_BW",
+                   DoubleValue (2.0),
+                   MakeDoubleAccessor (&TcpBbr::m_cWndGainProbeBw),
+                   MakeDoubleChecker<double> (1.0))
+    .AddAttribute ("BwWindowLength", "Rounds of the bottleneck bandwidth filter",
+                   UintegerValue (10),
+                   MakeUintegerAccessor (&TcpBbr::m_bwWindowLength),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("RtPropWindowLength", "Length of the round-trip propagation time filter",
+                   TimeValue (Seconds (10)),
+                   MakeTimeAccessor (&TcpBbr::m_rtPropWindowLength),
+                   MakeTimeChecker ())
+    .AddAttribute ("ProbeRttDuration", "Time spent at the lowest cWnd in PROBE_RTT",
+                   TimeValue (MilliSeconds (200)),
+                   MakeTimeAccessor (&TcpBbr::m_probeRttDuration),
+                   MakeTimeChecker ())
+    .AddTraceSource ("Mode",
+                     "State of BBR",
+                     MakeTraceSourceAccessor (&TcpBbr::m_mode),
+                     "ns3::TcpBbr::BbrModeTracedValueCallback")
+  ;
+  return tid;
+}
+
+TcpBbr::TcpBbr (void)
+  : TcpCongestionOps (),
+  m_highGain (2.885),
+  m_cWndGainProbeBw (2.0),
+  m_bwWindowLength (10),
+  m_rtPropWindowLength (Seconds (10)),
+  m_probeRttDuration (MilliSeconds (200)),
+  m_mode (BBR_STARTUP),
+  m_pacingGain (2.885),
+  m_cWndGain (2.885),
+  m_rtProp (Time (0)),
+  m_rtPropStamp (Time (0)),
+  m_rtPropExpired (false),
+  m_delivered (0),
+  m_roundCount (0),
+  m_roundStart (false),
+  m_nextRoundSeq (0),
+  m_roundDelivered (0),
+  m_roundStamp (Time (0)),
+  m_fullPipe (false),
+  m_fullBw (0),
+  m_fullBwCount (0),
+  m_cycleIndex (0),
+  m_cycleStamp (Time (0)),
+  m_probeRttDoneStamp (Time (0)),
+  m_probeRttRoundDone (false),
+  m_priorCwnd (0),
+  m_restoreCwnd (false)
+{
+  NS_LOG_FUNCTION (this);
+  m_uv = CreateObject<UniformRandomVariable> ();
+}
+
+TcpBbr::TcpBbr (const TcpBbr &sock)
+  : TcpCongestionOps (sock),
+  m_highGain (sock.m_highGain),
+  m_cWndGainProbeBw (sock.m_cWndGainProbeBw),
+  m_bwWindowLength (sock.m_bwWindowLength),
+  m_rtPropWindowLength (sock.m_rtPropWindowLength),
+  m_probeRttDuration (sock.m_probeRttDuration),
+  m_mode (sock.m_mode),
+  m_pacingGain (sock.m_pacingGain),
+  m_cWndGain (sock.m_cWndGain),
+  m_bwFilter (sock.m_bwFilter),
+  m_rtProp (sock.m_rtProp),
+  m_rtPropStamp (sock.m_rtPropStamp),
+  m_rtPropExpired (sock.m_rtPropExpired),
+  m_delivered (sock.m_delivered),
+  m_roundCount (sock.m_roundCount),
+  m_roundStart (sock.m_roundStart),
+  m_nextRoundSeq (sock.m_nextRoundSeq),
+  m_roundDelivered (sock.m_roundDelivered),
+  m_roundStamp (sock.m_roundStamp),
+  m_fullPipe (sock.m_fullPipe),
+  m_fullBw (sock.m_fullBw),
+  m_fullBwCount (sock.m_fullBwCount),
+  m_cycleIndex (sock.m_cycleIndex),
+  m_cycleStamp (sock.m_cycleStamp),
+  m_probeRttDoneStamp (sock.m_probeRttDoneStamp),
+  m_probeRttRoundDone (sock.m_probeRttRoundDone),
+  m_priorCwnd (sock.m_priorCwnd),
+  m_restoreCwnd (sock.m_restoreCwnd)
+{
+  NS_LOG_FUNCTION (this);
+  m_uv = CreateObject<UniformRandomVariable> ();
+}
+
+TcpBbr::~TcpBbr (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+std::string
+TcpBbr::GetName () const
+{
+  return "TcpBbr";
+}
+
+Ptr<TcpCongestionOps>
+TcpBbr::Fork (void)
+{
+  return CopyObject<TcpBbr> (this);
+}
+
+TcpBbr::BbrMode_t
+TcpBbr::GetMode (void) const
+{
+  return m_mode;
+}
+
+double
+TcpBbr::GetBtlBw (void) const
+{
+  return m_bwFilter.empty () ? 0.0 : m_bwFilter.front ().second;
+}
+
+Time
+TcpBbr::GetRtProp (void) const
+{
+  return m_rtProp;
+}
+
+uint32_t
+TcpBbr::GetInFlight (Ptr<const TcpSocketState> tcb) const
+{
+  if (tcb->m_highTxMark <= tcb->m_lastAckedSeq)
+    {
+      return 0;
+    }
+  return tcb->m_highTxMark - tcb->m_lastAckedSeq;
+}
+
+uint32_t
+TcpBbr::GetMinCwnd (Ptr<const TcpSocketState> tcb) const
+{
+  return 4 * tcb->m_segmentSize;
+}
+
+uint32_t
+TcpBbr::GetTargetCwnd (Ptr<const TcpSocketState> tcb, double gain) const
+{
+  double bw = GetBtlBw ();
+  if (bw == 0.0 || m_rtProp.IsZero ())
+    {
+      return tcb->m_initialCWnd * tcb->m_segmentSize;
+    }
+
+  // Bandwidth-delay product, plus room for the delayed and stretched ACKs
+  double bdp = bw * m_rtProp.GetSeconds ();
+  uint32_t target = static_cast<uint32_t> (gain * bdp) + 3 * tcb->m_segmentSize;
+  return std::max (target, GetMinCwnd (tcb));
+}
+
+void
+TcpBbr::UpdateModel (Ptr<TcpSocketState> tcb)
+{
+  NS_LOG_FUNCTION (this << tcb);
+
+  Time now = Simulator::Now ();
+
+  // RTprop: windowed minimum of the RTT samples
+  m_rtPropExpired = !m_rtProp.IsZero () && now > m_rtPropStamp + m_rtPropWindowLength;
+  Time sample = tcb->m_rttSample;
+  if (!sample.IsZero () && (m_rtProp.IsZero () || sample <= m_rtProp || m_rtPropExpired))
+    {
+      m_rtProp = sample;
+      m_rtPropStamp = now;
+    }
+
+  // A round ends when the highest segment sent at its start is ACKed
+  m_roundStart = false;
+  if (tcb->m_lastAckedSeq < m_nextRoundSeq)
+    {
+      return;
+    }
+
+  m_nextRoundSeq = tcb->m_highTxMark;
+  m_roundStart = true;
+  ++m_roundCount;
+
+  if (!m_roundStamp.IsZero () && now > m_roundStamp)
+    {
+      // BtlBw: windowed maximum of the delivery rate of the rounds
+      double bw = (m_delivered - m_roundDelivered) / (now - m_roundStamp).GetSeconds ();
+      while (!m_bwFilter.empty () && m_bwFilter.back ().second <= bw)
+        {
+          m_bwFilter.pop_back ();
+        }
+      m_bwFilter.push_back (std::make_pair (m_roundCount, bw));
+      while (m_bwFilter.front ().first + m_bwWindowLength <= m_roundCount)
+        {
+          m_bwFilter.pop_front ();
+        }
+      NS_LOG_DEBUG ("Round " << m_roundCount << ": delivery rate " << bw * 8 <<
+                    " bps, BtlBw " << GetBtlBw () * 8 << " bps, RTprop " << m_rtProp);
+
+      CheckFullPipe (GetBtlBw ());
+    }
+
+  m_roundDelivered = m_delivered;
+  m_roundStamp = now;
+}
+
+void
+TcpBbr::CheckFullPipe (double bw)
+{
+  NS_LOG_FUNCTION (this << bw);
+
+  if (m_fullPipe)
+    {
+      return;
+    }
+
+  if (bw >= m_fullBw * 1.25)
+    {
+      m_fullBw = bw;
+      m_fullBwCount = 0;
+      return;
+    }
+
+  if (++m_fullBwCount >= 3)
+    {
+      m_fullPipe = true;
+      NS_LOG_INFO ("Full pipe at " << m_fullBw * 8 << " bps");
+    }
+}
+
+void
+TcpBbr::EnterProbeBw (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_mode = BBR_PROBE_BW;
+  m_cWndGain = m_cWndGainProbeBw;
+  // Random phase, but never the draining one
+  m_cycleIndex = GAIN_CYCLE_LENGTH - m_uv->GetInteger (0, GAIN_CYCLE_LENGTH - 2);
+  m_cycleIndex %= GAIN_CYCLE_LENGTH;
+  m_cycleStamp = Simulator::Now ();
+  m_pacingGain = PACING_GAIN_CYCLE[m_cycleIndex];
+  NS_LOG_DEBUG ("Enter PROBE_BW at phase " << m_cycleIndex);
+}
+
+void
+TcpBbr::ExitProbeRtt (Ptr<TcpSocketState> tcb)
+{
+  NS_LOG_FUNCTION (this << tcb);
+
+  if (m_fullPipe)
+    {
+      EnterProbeBw ();
+    }
+  else
+    {
+      m_mode = BBR_STARTUP;
+      m_pacingGain = m_highGain;
+      m_cWndGain = m_highGain;
+    }
+  tcb->m_cWnd = std::max (tcb->m_cWnd.Get (), m_priorCwnd);
+  NS_LOG_DEBUG ("Exit PROBE_RTT, cwnd " << tcb->m_cWnd);
+}
+
+void
+TcpBbr::UpdateMode (Ptr<TcpSocketState> tcb)
+{
+  NS_LOG_FUNCTION (this << tcb);
+
+  Time now = Simulator::Now ();
+  uint32_t inFlight = GetInFlight (tcb);
+
+  if (m_mode == BBR_STARTUP && m_fullPipe)
+    {
+      m_mode = BBR_DRAIN;
+      m_pacingGain = 1.0 / m_highGain;
+      m_cWndGain = m_highGain;
+      NS_LOG_DEBUG ("Enter DRAIN");
+    }
+
+  if (m_mode == BBR_DRAIN && inFlight <= GetTargetCwnd (tcb, 1.0))
+    {
+      EnterProbeBw ();
+    }
+
+  if (m_mode == BBR_PROBE_BW)
+    {
+      bool fullLength = now - m_cycleStamp > m_rtProp;
+      bool advance;
+      if (m_pacingGain > 1.0)
+        { // Probe until the queue builds up, or a loss
+          advance = fullLength && (inFlight >= GetTargetCwnd (tcb, m_pacingGain)
+                                   || tcb->m_congState != TcpSocketState::CA_OPEN);
+        }
+      else if (m_pacingGain < 1.0)
+        { // Drain until the queue is empty
+          advance = fullLength || inFlight <= GetTargetCwnd (tcb, 1.0);
+        }
+      else
+        {
+          advance = fullLength;
+        }
+
+      if (advance)
+        {
+          m_cycleIndex = (m_cycleIndex + 1) % GAIN_CYCLE_LENGTH;
+          m_cycleStamp = now;
+          m_pacingGain = PACING_GAIN_CYCLE[m_cycleIndex];
+        }
+    }
+
+  if (m_mode != BBR_PROBE_RTT && m_rtPropExpired)
+    {
+      m_mode = BBR_PROBE_RTT;
+      m_pacingGain = 1.0;
+      m_cWndGain = 1.0;
+      m_priorCwnd = m_restoreCwnd ? std::max (m_priorCwnd, tcb->m_cWnd.Get ())
+                                  : tcb->m_cWnd.Get ();
+      m_probeRttDoneStamp = Time (0);
+      NS_LOG_DEBUG ("Enter PROBE_RTT, RTprop " << m_rtProp << " expired");
+    }
+
+  if (m_mode == BBR_PROBE_RTT)
+    {
+      tcb->m_cWnd = std::min (tcb->m_cWnd.Get (), GetMinCwnd (tcb));
+
+      if (m_probeRttDoneStamp.IsZero () && inFlight <= GetMinCwnd (tcb))
+        {
+          m_probeRttDoneStamp = now + m_probeRttDuration;
+          m_probeRttRoundDone = false;
+          m_nextRoundSeq = tcb->m_highTxMark;
+        }
+      else if (!m_probeRttDoneStamp.IsZero ())
+        {
+          if (m_roundStart)
+            {
+              m_probeRttRoundDone = true;
+            }
+          if (m_probeRttRoundDone && now >= m_probeRttDoneStamp)
+            {
+              m_rtPropStamp = now;
+              ExitProbeRtt (tcb);
+            }
+        }
+    }
+}
+
+void
+TcpBbr::SetPacingRate (Ptr<TcpSocketState> tcb)
+{
+  NS_LOG_FUNCTION (this << tcb);
+
+  double bw = GetBtlBw ();
+  if (bw == 0.0)
+    { // No delivery rate yet: the initial window over the first RTT sample
+      if (m_rtProp.IsZero ())
+        {
+          return;
+        }
+      bw = tcb->m_cWnd.Get () / m_rtProp.GetSeconds ();
+    }
+
+  // Pace slightly below the bandwidth, to drain the queue over time
+  DataRate rate (static_cast<uint64_t> (m_pacingGain * bw * 0.99 * 8));
+  if (m_fullPipe || rate > tcb->m_pacingRate)
+    {
+      tcb->m_pacingRate = rate;
+    }
+}
+
+/**
+ * \brief Update the model of the path, and the pacing rate
+ *
+ * Called for every ACK, dupacks included: the segments SACKed or
+ * reported by dupacks count as delivered.
+ *
+ * \param tcb internal congestion state
+ * \param segmentsAcked count of segments acked
+ * \param rtt the smoothed RTT (the RTT samples are taken from the socket)
+ */
+void
+TcpBbr::PktsAcked (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked,
+                   const Time &rtt)
+{
+  NS_LOG_FUNCTION (this << tcb << segmentsAcked << rtt);
+
+  m_delivered += segmentsAcked * tcb->m_segmentSize;
+
+  UpdateModel (tcb);
+  UpdateMode (tcb);
+  SetPacingRate (tcb);
+}
+
+void
+TcpBbr::IncreaseWindow (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
+{
+  NS_LOG_FUNCTION (this << tcb << segmentsAcked);
+
+  uint32_t cWnd = tcb->m_cWnd.Get ();
+  uint32_t acked = segmentsAcked * tcb->m_segmentSize;
+
+  if (m_restoreCwnd && tcb->m_congState == TcpSocketState::CA_OPEN)
+    { // Back from the loss recovery
+      cWnd = std::max (cWnd, m_priorCwnd);
+      m_restoreCwnd = false;
+    }
+
+  uint32_t target = GetTargetCwnd (tcb, m_cWndGain);
+  if (m_fullPipe)
+    {
+      cWnd = std::min (cWnd + acked, target);
+    }
+  else if (cWnd < target || m_delivered < tcb->m_initialCWnd * tcb->m_segmentSize)
+    {
+      cWnd += acked;
+    }
+
+  cWnd = std::max (cWnd, GetMinCwnd (tcb));
+  if (m_mode == BBR_PROBE_RTT)
+    {
+      cWnd = std::min (cWnd, GetMinCwnd (tcb));
+    }
+
+  tcb->m_cWnd = cWnd;
+  NS_LOG_INFO ("Updated to cwnd " << tcb->m_cWnd << " target " << target);
+}
+
+/**
+ * \brief Save cWnd before the reduction due to a loss
+ *
+ * BBR does not reduce its model on losses: cWnd is held at the bytes in
+ * flight during the recovery, and restored when back in Open.
+ *
+ * \param tcb internal congestion state
+ * \param bytesInFlight bytes in flight
+ * \return the window to hold during the recovery
+ */
+uint32_t
+TcpBbr::GetSsThresh (Ptr<const TcpSocketState> tcb,
+                     uint32_t bytesInFlight)
+{
+  NS_LOG_FUNCTION (this << tcb << bytesInFlight);
+
+  m_priorCwnd = m_restoreCwnd ? std::max (m_priorCwnd, tcb->m_cWnd.Get ())
+                              : tcb->m_cWnd.Get ();
+  m_restoreCwnd = true;
+
+  return std::max (bytesInFlight, GetMinCwnd (tcb));
+}
+
+} // namespace ns3
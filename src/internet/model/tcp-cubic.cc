@@ -0,0 +1,359 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "tcp-cubic.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/tcp-socket-base.h"
+
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpCubic");
+NS_OBJECT_ENSURE_REGISTERED (TcpCubic);
+
+TypeId
+TcpCubic::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpCubic")
+    .SetParent<TcpNewReno> ()
+    .AddConstructor<TcpCubic> ()
+    .SetGroupName ("Internet")
+    .AddAttribute ("FastConvergence", "Enable the fast convergence",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&TcpCubic::m_fastConvergence),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Beta", "Multiplicative decrease factor",
+                   DoubleValue (0.7),
+                   MakeDoubleAccessor (&TcpCubic::m_beta),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("C", "Cubic scaling factor",
+                   DoubleValue (0.4),
+                   MakeDoubleAccessor (&TcpCubic::m_c),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("HyStart", "Enable the HyStart exit of the slow start",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&TcpCubic::m_hystart),
+                   MakeBooleanChecker ())
+    .AddAttribute ("HyStartLowWindow", "Lowest cWnd (in segments) to run HyStart",
+                   UintegerValue (16),
+                   MakeUintegerAccessor (&TcpCubic::m_hystartLowWindow),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("HyStartAckDelta", "Largest spacing of the ACKs of a train",
+                   TimeValue (MilliSeconds (2)),
+                   MakeTimeAccessor (&TcpCubic::m_hystartAckDelta),
+                   MakeTimeChecker ())
+    .AddAttribute ("HyStartDelayMin", "Lowest RTT increase ending the slow start",
+                   TimeValue (MilliSeconds (4)),
+                   MakeTimeAccessor (&TcpCubic::m_hystartDelayMin),
+                   MakeTimeChecker ())
+    .AddAttribute ("HyStartDelayMax", "Highest RTT increase ending the slow start",
+                   TimeValue (MilliSeconds (16)),
+                   MakeTimeAccessor (&TcpCubic::m_hystartDelayMax),
+                   MakeTimeChecker ())
+    .AddAttribute ("HyStartMinSamples", "RTT samples of a round for the delay detection",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&TcpCubic::m_hystartMinSamples),
+                   MakeUintegerChecker<uint8_t> ())
+  ;
+  return tid;
+}
+
+TcpCubic::TcpCubic (void)
+  : TcpNewReno (),
+  m_fastConvergence (true),
+  m_beta (0.7),
+  m_c (0.4),
+  m_hystart (true),
+  m_hystartLowWindow (16),
+  m_hystartAckDelta (MilliSeconds (2)),
+  m_hystartDelayMin (MilliSeconds (4)),
+  m_hystartDelayMax (MilliSeconds (16)),
+  m_hystartMinSamples (8),
+  m_cWndCnt (0),
+  m_lastMaxCwnd (0),
+  m_bicOriginPoint (0),
+  m_bicK (0),
+  m_tcpCwnd (0),
+  m_delayMin (Time (0)),
+  m_epochStart (Time (0)),
+  m_found (false),
+  m_roundStart (Time (0)),
+  m_endSeq (0),
+  m_lastAck (Time (0)),
+  m_currRtt (Time (0)),
+  m_sampleCnt (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpCubic::TcpCubic (const TcpCubic &sock)
+  : TcpNewReno (sock),
+  m_fastConvergence (sock.m_fastConvergence),
+  m_beta (sock.m_beta),
+  m_c (sock.m_c),
+  m_hystart (sock.m_hystart),
+  m_hystartLowWindow (sock.m_hystartLowWindow),
+  m_hystartAckDelta (sock.m_hystartAckDelta),
+  m_hystartDelayMin (sock.m_hystartDelayMin),
+  m_hystartDelayMax (sock.m_hystartDelayMax),
+  m_hystartMinSamples (sock.m_hystartMinSamples),
+  m_cWndCnt (sock.m_cWndCnt),
+  m_lastMaxCwnd (sock.m_lastMaxCwnd),
+  m_bicOriginPoint (sock.m_bicOriginPoint),
+  m_bicK (sock.m_bicK),
+  m_tcpCwnd (sock.m_tcpCwnd),
+  m_delayMin (sock.m_delayMin),
+  m_epochStart (sock.m_epochStart),
+  m_found (sock.m_found),
+  m_roundStart (sock.m_roundStart),
+  m_endSeq (sock.m_endSeq),
+  m_lastAck (sock.m_lastAck),
+  m_currRtt (sock.m_currRtt),
+  m_sampleCnt (sock.m_sampleCnt)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpCubic::~TcpCubic (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+std::string
+TcpCubic::GetName () const
+{
+  return "TcpCubic";
+}
+
+Ptr<TcpCongestionOps>
+TcpCubic::Fork (void)
+{
+  return CopyObject<TcpCubic> (this);
+}
+
+void
+TcpCubic::HystartReset (Ptr<const TcpSocketState> tcb)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_roundStart = m_lastAck = Simulator::Now ();
+  m_endSeq = tcb->m_highTxMark;
+  m_currRtt = Time (0);
+  m_sampleCnt = 0;
+}
+
+void
+TcpCubic::HystartUpdate (Ptr<TcpSocketState> tcb, const Time &rtt)
+{
+  NS_LOG_FUNCTION (this << tcb << rtt);
+
+  if (m_found)
+    {
+      return;
+    }
+
+  // ACK train: the ACKs of the round, closely spaced, span half of the RTT
+  Time now = Simulator::Now ();
+  if (now - m_lastAck <= m_hystartAckDelta)
+    {
+      m_lastAck = now;
+      if (now - m_roundStart > m_delayMin / 2)
+        {
+          m_found = true;
+          NS_LOG_INFO ("HyStart: ACK train spans " << now - m_roundStart);
+        }
+    }
+
+  // Delay increase: the first samples of the round are above the minimum RTT
+  if (m_sampleCnt < m_hystartMinSamples)
+    {
+      if (m_currRtt.IsZero () || rtt < m_currRtt)
+        {
+          m_currRtt = rtt;
+        }
+      ++m_sampleCnt;
+    }
+  else
+    {
+      Time thresh = std::min (std::max (m_delayMin / 8, m_hystartDelayMin), m_hystartDelayMax);
+      if (m_currRtt > m_delayMin + thresh)
+        {
+          m_found = true;
+          NS_LOG_INFO ("HyStart: RTT of the round " << m_currRtt <<
+                       ", minimum RTT " << m_delayMin);
+        }
+    }
+
+  if (m_found)
+    {
+      tcb->m_ssThresh = tcb->m_cWnd;
+      NS_LOG_INFO ("HyStart: exit the slow start with cwnd " << tcb->m_cWnd);
+    }
+}
+
+/**
+ * \brief Update the minimum RTT, and run HyStart in slow start
+ *
+ * The smoothed RTT hides the queueing delay of the last round: the RTT
+ * samples are taken from the socket instead.
+ *
+ * \param tcb internal congestion state
+ * \param segmentsAcked count of segments acked
+ * \param rtt the smoothed RTT
+ */
+void
+TcpCubic::PktsAcked (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked,
+                     const Time &rtt)
+{
+  NS_LOG_FUNCTION (this << tcb << segmentsAcked << rtt);
+
+  Time sample = tcb->m_rttSample;
+  if (sample.IsZero ())
+    {
+      return;
+    }
+
+  if (m_delayMin.IsZero () || sample < m_delayMin)
+    {
+      m_delayMin = sample;
+    }
+
+  if (m_hystart && tcb->m_cWnd < tcb->m_ssThresh)
+    {
+      if (tcb->m_lastAckedSeq >= m_endSeq)
+        {
+          HystartReset (tcb);
+        }
+      if (tcb->GetCwndInSegments () >= m_hystartLowWindow)
+        {
+          HystartUpdate (tcb, sample);
+        }
+    }
+}
+
+uint32_t
+TcpCubic::Update (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
+{
+  NS_LOG_FUNCTION (this << tcb << segmentsAcked);
+
+  double segCwnd = tcb->GetCwndInSegments ();
+
+  if (m_epochStart.IsZero ())
+    { // First ACK after a reduction: the cubic function restarts from here
+      m_epochStart = Simulator::Now ();
+      m_tcpCwnd = segCwnd;
+      if (m_lastMaxCwnd <= segCwnd)
+        {
+          m_bicK = 0;
+          m_bicOriginPoint = segCwnd;
+        }
+      else
+        {
+          m_bicK = std::pow ((m_lastMaxCwnd - segCwnd) / m_c, 1.0 / 3.0);
+          m_bicOriginPoint = m_lastMaxCwnd;
+        }
+      NS_LOG_DEBUG ("New epoch: K=" << m_bicK << " origin=" << m_bicOriginPoint);
+    }
+
+  // The window targeted one RTT from now
+  double t = (Simulator::Now () - m_epochStart + m_delayMin).GetSeconds ();
+  double target = m_bicOriginPoint + m_c * std::pow (t - m_bicK, 3);
+
+  double cnt;
+  if (target > segCwnd)
+    {
+      cnt = segCwnd / (target - segCwnd);
+    }
+  else
+    {
+      cnt = 100.0 * segCwnd; // Very small increment
+    }
+
+  if (m_lastMaxCwnd == 0 && cnt > 20)
+    { // No loss yet: grow by 5% at least
+      cnt = 20;
+    }
+
+  // TCP-friendly region: W_est grows by alpha segments per RTT
+  double alpha = 3.0 * (1.0 - m_beta) / (1.0 + m_beta);
+  m_tcpCwnd += alpha * segmentsAcked / segCwnd;
+  if (m_tcpCwnd > segCwnd)
+    {
+      cnt = std::min (cnt, segCwnd / (m_tcpCwnd - segCwnd));
+    }
+
+  // Never more than 1.5 times cWnd per RTT
+  cnt = std::min (cnt, 100.0 * segCwnd);
+  return std::max (static_cast<uint32_t> (cnt), 2U);
+}
+
+void
+TcpCubic::CongestionAvoidance (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
+{
+  NS_LOG_FUNCTION (this << tcb << segmentsAcked);
+
+  if (segmentsAcked == 0)
+    {
+      return;
+    }
+
+  uint32_t cnt = Update (tcb, segmentsAcked);
+  m_cWndCnt += segmentsAcked;
+  if (m_cWndCnt >= cnt)
+    {
+      uint32_t inc = m_cWndCnt / cnt;
+      tcb->m_cWnd += inc * tcb->m_segmentSize;
+      m_cWndCnt -= inc * cnt;
+      NS_LOG_INFO ("In CongAvoid, updated to cwnd " << tcb->m_cWnd <<
+                   " ssthresh " << tcb->m_ssThresh);
+    }
+}
+
+uint32_t
+TcpCubic::GetSsThresh (Ptr<const TcpSocketState> tcb,
+                       uint32_t bytesInFlight)
+{
+  NS_LOG_FUNCTION (this << tcb << bytesInFlight);
+
+  double segCwnd = tcb->GetCwndInSegments ();
+
+  m_epochStart = Time (0);
+  m_cWndCnt = 0;
+  m_found = false;
+
+  if (segCwnd < m_lastMaxCwnd && m_fastConvergence)
+    { // Release some bandwidth to the new flows
+      m_lastMaxCwnd = segCwnd * (1.0 + m_beta) / 2.0;
+    }
+  else
+    {
+      m_lastMaxCwnd = segCwnd;
+    }
+
+  uint32_t ssThresh = std::max (static_cast<uint32_t> (segCwnd * m_beta), 2U);
+  NS_LOG_DEBUG ("Loss with cwnd " << segCwnd << " segments: Wmax=" << m_lastMaxCwnd <<
+                " ssthresh=" << ssThresh << " segments");
+
+  return ssThresh * tcb->m_segmentSize;
+}
+
+} // namespace ns3
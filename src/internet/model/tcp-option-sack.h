@@ -0,0 +1,94 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TCP_OPTION_SACK_H
+#define TCP_OPTION_SACK_H
+
+#include <vector>
+#include "ns3/tcp-option.h"
+#include "ns3/sequence-number.h"
+
+namespace ns3 {
+
+/**
+ * \brief Defines the TCP option of kind 5 (SACK option) as in \RFC{2018}
+ *
+ * The SACK option reports to the sender the blocks of data received out
+ * of order. Each block is the pair of the sequence number of its first
+ * byte and the sequence number following its last byte. The option takes
+ * 2 bytes plus 8 bytes per block, so at most 4 blocks fit in the option
+ * space of the header, and 3 blocks when the timestamp option is used.
+ */
+class TcpOptionSack : public TcpOption
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  /// A block of data received, as [left edge, right edge)
+  typedef std::pair<SequenceNumber32, SequenceNumber32> SackBlock;
+  /// The list of the blocks in the option
+  typedef std::vector<SackBlock> SackList;
+
+  TcpOptionSack ();
+  virtual ~TcpOptionSack ();
+
+  virtual void Print (std::ostream &os) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+  virtual uint8_t GetKind (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+
+  /**
+   * \brief Append a block to the option
+   *
+   * At most 4 blocks may be added.
+   *
+   * \param block the block
+   */
+  void AddSackBlock (SackBlock block);
+
+  /**
+   * \brief Get the number of blocks in the option
+   * \return the number of blocks
+   */
+  uint32_t GetNumSackBlocks (void) const;
+
+  /**
+   * \brief Get the blocks of the option, in the order of the option
+   * \return the blocks
+   */
+  const SackList & GetSackList (void) const;
+
+  /**
+   * \brief Get the size of an option holding a number of blocks
+   * \param blocks the number of blocks
+   * \return the size of the option in bytes
+   */
+  static uint32_t GetSizeForBlocks (uint32_t blocks);
+
+protected:
+  SackList m_sackList; //!< The blocks
+};
+
+} // namespace ns3
+
+#endif /* TCP_OPTION_SACK_H */
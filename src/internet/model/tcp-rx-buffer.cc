@@ -18,6 +18,8 @@
  * Author: Adrian Sai-wah Tam <adrian.sw.tam@gmail.com>
  */
 
+#include <algorithm>
+
 #include "ns3/packet.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
@@ -156,8 +158,13 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
       if (maxSeq < tailSeq) tailSeq = maxSeq;
       if (tailSeq < headSeq) headSeq = tailSeq;
     }
-  // Remove overlapped bytes from packet
-  BufIterator i = m_data.begin ();
+  // Remove overlapped bytes from packet, starting with the packet which
+  // may hold headSeq: the packets before end at or before its start
+  BufIterator i = m_data.upper_bound (headSeq);
+  if (i != m_data.begin ())
+    {
+      --i;
+    }
   while (i != m_data.end () && i->first <= tailSeq)
     {
       SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
@@ -199,18 +206,11 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
   NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize ());
   // Update variables
   m_size += p->GetSize ();      // Occupancy
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
-    {
-      if (i->first < m_nextRxSeq)
-        {
-          continue;
-        }
-      else if (i->first > m_nextRxSeq)
-        {
-          break;
-        };
-      m_nextRxSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      m_availBytes += i->second->GetSize ();
+  BlockMap::iterator block = AddBlock (headSeq, tailSeq);
+  if (block->first <= m_nextRxSeq.Get () && block->second > m_nextRxSeq.Get ())
+    { // The block of the packet starts the contiguous data
+      m_availBytes += block->second - m_nextRxSeq.Get ();
+      m_nextRxSeq = block->second;
     }
   NS_LOG_LOGIC ("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
   if (m_gotFin && m_nextRxSeq == m_finSeq)
@@ -255,6 +255,14 @@ TcpRxBuffer::Extract (uint32_t maxSize)
           extractSize = 0;
         }
     }
+  // The first block now starts at the first packet left
+  BlockMap::iterator block = m_blocks.begin ();
+  SequenceNumber32 blockEnd = block->second;
+  m_blocks.erase (block);
+  if (!m_data.empty () && m_data.begin ()->first < blockEnd)
+    {
+      m_blocks[m_data.begin ()->first] = blockEnd;
+    }
   if (outPkt->GetSize () == 0)
     {
       NS_LOG_LOGIC ("Nothing extracted.");
@@ -265,4 +273,39 @@ TcpRxBuffer::Extract (uint32_t maxSize)
   return outPkt;
 }
 
+TcpRxBuffer::BlockMap::iterator
+TcpRxBuffer::AddBlock (SequenceNumber32 head, SequenceNumber32 tail)
+{
+  NS_LOG_FUNCTION (this << head << tail);
+  BlockMap::iterator next = m_blocks.upper_bound (head);
+  if (next != m_blocks.begin ())
+    {
+      BlockMap::iterator previous = next;
+      --previous;
+      if (previous->second >= head)
+        { // Merge with the block before
+          head = previous->first;
+          tail = std::max (tail, previous->second);
+          m_blocks.erase (previous);
+        }
+    }
+  while (next != m_blocks.end () && next->first <= tail)
+    { // Merge with the blocks after
+      tail = std::max (tail, next->second);
+      m_blocks.erase (next++);
+    }
+  return m_blocks.insert (next, std::make_pair (head, tail));
+}
+
+TcpRxBuffer::SequenceBlockList
+TcpRxBuffer::GetOutOfOrderBlocks (void) const
+{
+  SequenceBlockList blocks;
+  for (BlockMap::const_iterator i = m_blocks.upper_bound (m_nextRxSeq); i != m_blocks.end (); ++i)
+    {
+      blocks.push_back (*i);
+    }
+  return blocks;
+}
+
 } //namepsace ns3
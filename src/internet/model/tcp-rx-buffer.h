@@ -22,6 +22,8 @@
 #define TCP_RX_BUFFER_H
 
 #include <map>
+#include <vector>
+#include <utility>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/sequence-number.h"
@@ -36,10 +38,21 @@ class Packet;
  *
  * \brief class for the reordering buffer that keeps the data from lower layer, i.e.
  *        TcpL4Protocol, sent to the application
+ *
+ * Besides the packets, the buffer keeps the blocks of contiguous data it
+ * holds, merged as the holes between them are filled: a packet only
+ * visits the packets it overlaps, RCV.NXT moves to the end of the block
+ * which it reaches, and the blocks received out of order, e.g. for SACK,
+ * are read without walking the packets.
  */
 class TcpRxBuffer : public Object
 {
 public:
+  /// A block of contiguous sequence numbers, from first to second excluded
+  typedef std::pair<SequenceNumber32, SequenceNumber32> SequenceBlock;
+  /// A list of blocks of sequence numbers
+  typedef std::vector<SequenceBlock> SequenceBlockList;
+
   /**
    * \brief Get the type ID.
    * \return the object TypeId
@@ -125,9 +138,26 @@ public:
    */
   Ptr<Packet> Extract (uint32_t maxSize);
 
+  /**
+   * \brief Get the blocks of data received beyond nextRxSeq, i.e., out of order
+   * \returns the blocks, in increasing sequence order
+   */
+  SequenceBlockList GetOutOfOrderBlocks (void) const;
+
 private:
   /// container for data stored in the buffer
   typedef std::map<SequenceNumber32, Ptr<Packet> >::iterator BufIterator;
+  /// container for the blocks of contiguous data: the end of the block by its first sequence number
+  typedef std::map<SequenceNumber32, SequenceNumber32> BlockMap;
+
+  /**
+   * \brief Add a block of data to the blocks, merged with the blocks it overlaps or touches
+   * \param head the first sequence number of the data
+   * \param tail the sequence number following the data
+   * \returns the block of contiguous data which holds the data
+   */
+  BlockMap::iterator AddBlock (SequenceNumber32 head, SequenceNumber32 tail);
+
   TracedValue<SequenceNumber32> m_nextRxSeq; //!< Seqnum of the first missing byte in data (RCV.NXT)
   SequenceNumber32 m_finSeq;                 //!< Seqnum of the FIN packet
   bool m_gotFin;                             //!< Did I received FIN packet?
@@ -135,6 +165,7 @@ private:
   uint32_t m_maxBuffer;                      //!< Upper bound of the number of data bytes in buffer (RCV.WND)
   uint32_t m_availBytes;                     //!< Number of bytes available to read, i.e. contiguous block at head
   std::map<SequenceNumber32, Ptr<Packet> > m_data; //!< Corresponding data (may be null)
+  BlockMap m_blocks;                         //!< The blocks of contiguous data in m_data
 };
 
 } //namepsace ns3
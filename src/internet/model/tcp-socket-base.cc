@@ -41,6 +41,7 @@
 #include "ns3/double.h"
 #include "ns3/pointer.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/segmentation-offload.h"
 #include "tcp-socket-base.h"
 #include "tcp-l4-protocol.h"
 #include "ipv4-end-point.h"
@@ -49,6 +50,8 @@
 #include "tcp-header.h"
 #include "tcp-option-winscale.h"
 #include "tcp-option-ts.h"
+#include "tcp-option-sack-permitted.h"
+#include "tcp-option-sack.h"
 #include "rtt-estimator.h"
 
 #include <math.h>
@@ -97,6 +100,20 @@ TcpSocketBase::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&TcpSocketBase::m_timestampEnabled),
                    MakeBooleanChecker ())
+    .AddAttribute ("Sack", "Enable or disable SACK option and SACK-based loss recovery",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_sackEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Rack", "Enable or disable RACK time-based loss detection, when SACK is enabled",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&TcpSocketBase::m_rackEnabled),
+                   MakeBooleanChecker ())
+    .AddAttribute ("GsoMaxSize",
+                   "Largest payload of the super-segments sent over IPv4, split in "
+                   "segments by the device or by IPv4 (0 to send single segments)",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&TcpSocketBase::m_gsoMaxSize),
+                   MakeUintegerChecker<uint32_t> (0, 65000))
     .AddAttribute ("MinRto",
                    "Minimum retransmit timeout value",
                    TimeValue (Seconds (1.0)), // RFC 6298 says min RTO=1 sec, but Linux uses 200ms.
@@ -225,7 +242,11 @@ TcpSocketState::TcpSocketState (void)
     m_initialCWnd (0),
     m_initialSsThresh (0),
     m_segmentSize (0),
-    m_congState (CA_OPEN)
+    m_congState (CA_OPEN),
+    m_highTxMark (0),
+    m_lastAckedSeq (0),
+    m_rttSample (Seconds (0.0)),
+    m_pacingRate (0)
 {
 }
 
@@ -236,7 +257,11 @@ TcpSocketState::TcpSocketState (const TcpSocketState &other)
     m_initialCWnd (other.m_initialCWnd),
     m_initialSsThresh (other.m_initialSsThresh),
     m_segmentSize (other.m_segmentSize),
-    m_congState (other.m_congState)
+    m_congState (other.m_congState),
+    m_highTxMark (other.m_highTxMark),
+    m_lastAckedSeq (other.m_lastAckedSeq),
+    m_rttSample (other.m_rttSample),
+    m_pacingRate (other.m_pacingRate)
 {
 }
 
@@ -295,6 +320,12 @@ TcpSocketBase::TcpSocketBase (void)
     m_sndWindShift (0),
     m_timestampEnabled (true),
     m_timestampToEcho (0),
+    m_sackEnabled (false),
+    m_rackEnabled (true),
+    m_lastDataSeq (0),
+    m_rackEvent (),
+    m_pacingEvent (),
+    m_gsoMaxSize (0),
     m_sendPendingDataEvent (),
     m_recover (0), // Set to the initial sequence number
     m_retxThresh (3),
@@ -366,6 +397,10 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     m_sndWindShift (sock.m_sndWindShift),
     m_timestampEnabled (sock.m_timestampEnabled),
     m_timestampToEcho (sock.m_timestampToEcho),
+    m_sackEnabled (sock.m_sackEnabled),
+    m_rackEnabled (sock.m_rackEnabled),
+    m_lastDataSeq (sock.m_lastDataSeq),
+    m_gsoMaxSize (sock.m_gsoMaxSize),
     m_recover (sock.m_recover),
     m_retxThresh (sock.m_retxThresh),
     m_limitedTx (sock.m_limitedTx),
@@ -1230,6 +1265,11 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, const Address &fromAddress,
           m_timestampEnabled = false;
         }
 
+      if (!tcpHeader.HasOption (TcpOption::SACKPERMITTED))
+        {
+          m_sackEnabled = false;
+        }
+
       // Initialize cWnd and ssThresh
       m_tcb->m_cWnd = GetInitialCwnd () * GetSegSize ();
       m_tcb->m_ssThresh = GetInitialSSThresh ();
@@ -1444,6 +1484,12 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
                 " SND.UNA=" << m_txBuffer->HeadSequence () <<
                 " SND.NXT=" << m_nextTxSequence);
 
+  if (m_sackEnabled)
+    {
+      ProcessOptionSack (tcpHeader);
+      DetectSackLosses ();
+    }
+
   if (ackNumber == m_txBuffer->HeadSequence ()
       && ackNumber < m_nextTxSequence
       && packet->GetSize () == 0)
@@ -1470,7 +1516,13 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
         }
       else if (m_tcb->m_congState == TcpSocketState::CA_DISORDER)
         {
-          if ((m_dupAckCount == m_retxThresh) && (m_highRxAckMark >= m_recover))
+          if ((m_dupAckCount == m_retxThresh) && (m_highRxAckMark >= m_recover)
+              && m_sackEnabled)
+            {
+              NS_LOG_INFO (m_dupAckCount << " dupack. Enter SACK-based loss recovery");
+              EnterSackRecovery ();
+            }
+          else if ((m_dupAckCount == m_retxThresh) && (m_highRxAckMark >= m_recover))
             {
               // triple duplicate ack triggers fast retransmit (RFC2582 sec.3 bullet #1)
               NS_LOG_DEBUG (TcpSocketState::TcpCongStateName[m_tcb->m_congState] <<
@@ -1495,6 +1547,12 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
               m_nextTxSequence += sz;
             }
         }
+      else if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY && m_sackEnabled)
+        { // The pipe has been reduced by the SACK blocks (RFC 6675, sec.5 bullet #C)
+          NS_LOG_INFO (m_dupAckCount << " Dupack received in SACK-based loss recovery." <<
+                       " Pipe is " << BytesInFlight ());
+          SendPendingData (m_connected);
+        }
       else if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY)
         { // Increase cwnd for every additional dupack (RFC2582, sec.3 bullet #3)
           m_tcb->m_cWnd += m_tcb->m_segmentSize;
@@ -1502,6 +1560,10 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
                        "Increase cwnd to " << m_tcb->m_cWnd);
           SendPendingData (m_connected);
         }
+      else if (m_tcb->m_congState == TcpSocketState::CA_LOSS && m_sackEnabled)
+        { // The segments SACKed after the timeout are not retransmitted
+          SendPendingData (m_connected);
+        }
 
       // Artificially call PktsAcked. After all, one segment has been ACKed.
       m_congestionControl->PktsAcked (m_tcb, 1, m_lastRtt);
@@ -1514,6 +1576,7 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
   else if (ackNumber > m_txBuffer->HeadSequence ())
     { // Case 3: New ACK, reset m_dupAckCount and update m_txBuffer
       bool callCongestionControl = true;
+      m_tcb->m_lastAckedSeq = ackNumber;
       bool resetRTO = true;
 
       /* The following switch is made because m_dupAckCount can be
@@ -1554,7 +1617,21 @@ TcpSocketBase::ReceivedAck (Ptr<Packet> packet, const TcpHeader& tcpHeader)
         }
       else if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY)
         {
-          if (ackNumber < m_recover)
+          if (ackNumber < m_recover && m_sackEnabled)
+            {
+              /* Partial ACK in SACK-based loss recovery.
+               * cWnd is held at ssThresh, and the pipe computed from the
+               * scoreboard decides which segments can be sent: the
+               * retransmissions are sent once the buffer is updated.
+               */
+              callCongestionControl = false;
+              m_congestionControl->PktsAcked (m_tcb, segsAcked, m_lastRtt);
+
+              NS_LOG_INFO ("Partial ACK for seq " << ackNumber <<
+                           " in SACK-based loss recovery: pipe " << BytesInFlight () <<
+                           " recover seq: " << m_recover);
+            }
+          else if (ackNumber < m_recover)
             {
               /* Partial ACK.
                * In case of partial ACK, retransmit the first unacknowledged
@@ -2439,6 +2516,11 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
       p->AddPacketTag (ipHopLimitTag);
     }
 
+  if (sz > m_tcb->m_segmentSize)
+    { // Super-segment, to be split by the device or by IPv4
+      p->AddPacketTag (GsoTag (m_tcb->m_segmentSize));
+    }
+
   if (m_closeOnEmpty && (remainingData == 0))
     {
       flags |= TcpHeader::FIN;
@@ -2506,7 +2588,20 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
                     ". Header " << header);
     }
 
-  UpdateRttHistory (seq, sz, isRetransmission);
+  // A super-segment is recorded as its segments
+  uint32_t offset = 0;
+  do
+    {
+      uint32_t segmentSize = std::min (sz - offset, m_tcb->m_segmentSize);
+      UpdateRttHistory (seq + offset, segmentSize, isRetransmission);
+
+      if (m_sackEnabled)
+        {
+          m_txBuffer->Sent (seq + offset, segmentSize);
+        }
+      offset += segmentSize;
+    }
+  while (offset < sz);
 
   // Notify the application of the data being sent unless this is a retransmit
   if (seq + sz > m_highTxMark)
@@ -2515,6 +2610,15 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
     }
   // Update highTxMark
   m_highTxMark = std::max (seq + sz, m_highTxMark.Get ());
+  m_tcb->m_highTxMark = m_highTxMark;
+
+  if (m_tcb->m_pacingRate.GetBitRate () > 0)
+    { // The next segment leaves after the transmission time of this one at the pacing rate
+      m_pacingEvent.Cancel ();
+      m_pacingEvent = Simulator::Schedule (m_tcb->m_pacingRate.CalculateBytesTxTime (sz),
+                                           &TcpSocketBase::SendPendingData,
+                                           this, m_connected);
+    }
   return sz;
 }
 
@@ -2560,8 +2664,17 @@ TcpSocketBase::SendPendingData (bool withAck)
       return false; // Is this the right way to handle this condition?
     }
   uint32_t nPacketsSent = 0;
+  if (m_sackEnabled)
+    { // Segments deemed lost go first (RFC 6675, NextSeg () rule 1)
+      nPacketsSent += SendRetransmissions (withAck, true);
+    }
   while (m_txBuffer->SizeFromSequence (m_nextTxSequence))
     {
+      if (m_pacingEvent.IsRunning ())
+        {
+          NS_LOG_LOGIC ("Pacing the segments. Wait to send.");
+          break;
+        }
       uint32_t w = AvailableWindow (); // Get available window size
       // Stop sending if we need to wait for a larger Tx window (prevent silly window syndrome)
       if (w < m_tcb->m_segmentSize && m_txBuffer->SizeFromSequence (m_nextTxSequence) > w)
@@ -2591,10 +2704,19 @@ TcpSocketBase::SendPendingData (bool withAck)
                     " unAck: " << UnAckDataCount ());
 
       uint32_t s = std::min (w, m_tcb->m_segmentSize);  // Send no more than window
+      uint32_t gsoSize = GetGsoSize ();
+      if (w > m_tcb->m_segmentSize && gsoSize > m_tcb->m_segmentSize)
+        { // Send whole segments of the window as one super-segment
+          s = std::min (w, gsoSize) / m_tcb->m_segmentSize * m_tcb->m_segmentSize;
+        }
       uint32_t sz = SendDataPacket (m_nextTxSequence, s, withAck);
       nPacketsSent++;                             // Count sent this loop
       m_nextTxSequence += sz;                     // Advance next tx sequence
     }
+  if (m_sackEnabled && m_tcb->m_congState == TcpSocketState::CA_RECOVERY)
+    { // No new data to send: retransmit the holes (RFC 6675, NextSeg () rule 3)
+      nPacketsSent += SendRetransmissions (withAck, false);
+    }
   if (nPacketsSent > 0)
     {
       NS_LOG_DEBUG ("SendPendingData sent " << nPacketsSent << " segments");
@@ -2602,6 +2724,23 @@ TcpSocketBase::SendPendingData (bool withAck)
   return (nPacketsSent > 0);
 }
 
+uint32_t
+TcpSocketBase::GetGsoSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (m_endPoint == 0 || m_gsoMaxSize <= m_tcb->m_segmentSize)
+    {
+      return 0;
+    }
+  uint32_t gsoSize = m_gsoMaxSize;
+  if (m_tcb->m_pacingRate.GetBitRate () > 0)
+    { // Send about 1 ms of data at the pacing rate at once, as Linux does
+      uint64_t pacingSize = std::min<uint64_t> (m_tcb->m_pacingRate.GetBitRate () / 8 / 1000, m_tcb->m_cWnd / 4);
+      gsoSize = static_cast<uint32_t> (std::min<uint64_t> (gsoSize, std::max<uint64_t> (pacingSize, 2 * m_tcb->m_segmentSize)));
+    }
+  return gsoSize;
+}
+
 uint32_t
 TcpSocketBase::UnAckDataCount () const
 {
@@ -2623,7 +2762,11 @@ TcpSocketBase::BytesInFlight ()
   uint32_t duplicatedSize;
   uint32_t bytesInFlight;
 
-  if (m_retransOut > m_dupAckCount)
+  if (m_sackEnabled)
+    { // With SACK, the scoreboard knows the pipe (RFC 6675 SetPipe ())
+      bytesInFlight = m_txBuffer->BytesInFlight ();
+    }
+  else if (m_retransOut > m_dupAckCount)
     {
       duplicatedSize = (m_retransOut - m_dupAckCount)*m_tcb->m_segmentSize;
       bytesInFlight = flightSize + duplicatedSize;
@@ -2658,6 +2801,16 @@ TcpSocketBase::AvailableWindow () const
   uint32_t unack = UnAckDataCount (); // Number of outstanding bytes
   uint32_t win = Window ();           // Number of bytes allowed to be outstanding
 
+  if (m_sackEnabled)
+    { // The congestion window limits the pipe, the receiver window the outstanding bytes
+      uint32_t pipe = m_txBuffer->BytesInFlight ();
+      uint32_t cWnd = m_tcb->m_cWnd.Get ();
+      uint32_t rWnd = m_rWnd.Get ();
+
+      NS_LOG_DEBUG ("UnAckCount=" << unack << ", Pipe=" << pipe << ", cWnd=" << cWnd);
+      return std::min ((cWnd < pipe) ? 0 : (cWnd - pipe), (rWnd < unack) ? 0 : (rWnd - unack));
+    }
+
   NS_LOG_DEBUG ("UnAckCount=" << unack << ", Win=" << win);
   return (win < unack) ? 0 : (win - unack);
 }
@@ -2686,8 +2839,17 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
   NS_LOG_DEBUG ("Data segment, seq=" << tcpHeader.GetSequenceNumber () <<
                 " pkt size=" << p->GetSize () );
 
+  // A segment merged by the device counts as its segments for the delayed ACK
+  uint32_t segments = 1;
+  GsoTag gsoTag;
+  if (p->RemovePacketTag (gsoTag) && gsoTag.GetSegmentSize () > 0)
+    {
+      segments = (p->GetSize () + gsoTag.GetSegmentSize () - 1) / gsoTag.GetSegmentSize ();
+    }
+
   // Put into Rx buffer
   SequenceNumber32 expectedSeq = m_rxBuffer->NextRxSequence ();
+  m_lastDataSeq = tcpHeader.GetSequenceNumber ();
   if (!m_rxBuffer->Add (p, tcpHeader))
     { // Insert failed: No data or RX buffer full
       SendEmptyPacket (TcpHeader::ACK);
@@ -2700,7 +2862,8 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
     }
   else
     { // In-sequence packet: ACK if delayed ack count allows
-      if (++m_delAckCount >= m_delAckMaxCount)
+      m_delAckCount += segments;
+      if (m_delAckCount >= m_delAckMaxCount)
         {
           m_delAckEvent.Cancel ();
           m_delAckCount = 0;
@@ -2786,6 +2949,7 @@ TcpSocketBase::EstimateRtt (const TcpHeader& tcpHeader)
       // RFC 6298, clause 2.4
       m_rto = Max (m_rtt->GetEstimate () + Max (m_clockGranularity, m_rtt->GetVariation () * 4), m_minRto);
       m_lastRtt = m_rtt->GetEstimate ();
+      m_tcb->m_rttSample = m;
       NS_LOG_FUNCTION (this << m_lastRtt);
     }
 }
@@ -2973,7 +3137,14 @@ TcpSocketBase::Retransmit ()
       m_tcb->m_cWnd = m_tcb->m_segmentSize;
     }
 
-  m_nextTxSequence = m_txBuffer->HeadSequence (); // Restart from highest Ack
+  if (m_sackEnabled)
+    { // Retransmit all the segments not SACKed, before new data
+      m_txBuffer->MarkAllLost ();
+    }
+  else
+    {
+      m_nextTxSequence = m_txBuffer->HeadSequence (); // Restart from highest Ack
+    }
   m_dupAckCount = 0;
 
   NS_LOG_DEBUG ("RTO. Reset cwnd to " <<  m_tcb->m_cWnd << ", ssthresh to " <<
@@ -3040,6 +3211,8 @@ TcpSocketBase::CancelAllTimers ()
   m_lastAckEvent.Cancel ();
   m_timewaitEvent.Cancel ();
   m_sendPendingDataEvent.Cancel ();
+  m_rackEvent.Cancel ();
+  m_pacingEvent.Cancel ();
 }
 
 /* Move TCP to Time_Wait state and schedule a transition to Closed state */
@@ -3228,6 +3401,19 @@ TcpSocketBase::AddOptions (TcpHeader& header)
     {
       AddOptionTimestamp (header);
     }
+
+  if (m_sackEnabled)
+    {
+      // SACK-permitted is set only on SYN packets, SACK only on the others
+      if (header.GetFlags () & TcpHeader::SYN)
+        {
+          AddOptionSackPermitted (header);
+        }
+      else if (m_rxBuffer->Size () > m_rxBuffer->Available ())
+        {
+          AddOptionSack (header);
+        }
+    }
 }
 
 void
@@ -3327,6 +3513,181 @@ TcpSocketBase::AddOptionTimestamp (TcpHeader& header)
                option->GetTimestamp () << " echo=" << m_timestampToEcho);
 }
 
+void
+TcpSocketBase::AddOptionSackPermitted (TcpHeader& header)
+{
+  NS_LOG_FUNCTION (this << header);
+  NS_ASSERT (header.GetFlags () & TcpHeader::SYN);
+
+  Ptr<TcpOptionSackPermitted> option = CreateObject<TcpOptionSackPermitted> ();
+  header.AppendOption (option);
+  NS_LOG_INFO (m_node->GetId () << " Add option SACK-permitted");
+}
+
+void
+TcpSocketBase::AddOptionSack (TcpHeader& header)
+{
+  NS_LOG_FUNCTION (this << header);
+
+  TcpRxBuffer::SequenceBlockList blocks = m_rxBuffer->GetOutOfOrderBlocks ();
+  uint32_t space = header.GetMaxOptionLength () - header.GetOptionLength ();
+  if (blocks.empty () || space < TcpOptionSack::GetSizeForBlocks (1))
+    {
+      return;
+    }
+  uint32_t maxBlocks = std::min<uint32_t> (4, (space - TcpOptionSack::GetSizeForBlocks (0)) / 8);
+
+  Ptr<TcpOptionSack> option = CreateObject<TcpOptionSack> ();
+
+  // The block holding the most recently received segment goes first
+  TcpRxBuffer::SequenceBlockList::iterator first = blocks.end ();
+  for (TcpRxBuffer::SequenceBlockList::iterator it = blocks.begin (); it != blocks.end (); ++it)
+    {
+      if (it->first <= m_lastDataSeq && m_lastDataSeq < it->second)
+        {
+          first = it;
+          option->AddSackBlock (*it);
+          break;
+        }
+    }
+  for (TcpRxBuffer::SequenceBlockList::reverse_iterator it = blocks.rbegin ();
+       it != blocks.rend () && option->GetNumSackBlocks () < maxBlocks; ++it)
+    {
+      if (it.base () - 1 != first)
+        {
+          option->AddSackBlock (*it);
+        }
+    }
+
+  header.AppendOption (option);
+  NS_LOG_INFO (m_node->GetId () << " Add option SACK with " <<
+               option->GetNumSackBlocks () << " blocks");
+}
+
+void
+TcpSocketBase::ProcessOptionSack (const TcpHeader& tcpHeader)
+{
+  NS_LOG_FUNCTION (this << tcpHeader);
+
+  TcpTxBuffer::SequenceBlockList blocks;
+  if (tcpHeader.GetAckNumber () > m_txBuffer->HeadSequence ())
+    { // The bytes acknowledged are delivered, and never lost
+      blocks.push_back (std::make_pair (m_txBuffer->HeadSequence (), tcpHeader.GetAckNumber ()));
+    }
+  if (tcpHeader.HasOption (TcpOption::SACK))
+    {
+      Ptr<const TcpOptionSack> sack = DynamicCast<const TcpOptionSack> (tcpHeader.GetOption (TcpOption::SACK));
+      const TcpOptionSack::SackList &list = sack->GetSackList ();
+      blocks.insert (blocks.end (), list.begin (), list.end ());
+    }
+  if (blocks.empty ())
+    {
+      return;
+    }
+
+  uint32_t sacked = m_txBuffer->Update (blocks);
+  NS_LOG_INFO (m_node->GetId () << " Got " << blocks.size () << " SACK blocks, " <<
+               sacked << " bytes newly SACKed");
+}
+
+void
+TcpSocketBase::DetectSackLosses (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t lost = m_txBuffer->DetectLoss (m_retxThresh, m_tcb->m_segmentSize);
+
+  if (m_rackEnabled)
+    {
+      // The reordering window is a quarter of the minimum RTT, as in RACK
+      Time minRtt = m_txBuffer->GetMinRtt ();
+      Time reoWnd = (minRtt == Time::Max ()) ? Time (0) : minRtt / 4;
+      uint32_t rackLost = 0;
+      Time timeout = m_txBuffer->DetectLossByTime (reoWnd, &rackLost);
+      lost += rackLost;
+
+      m_rackEvent.Cancel ();
+      if (timeout > Time (0))
+        {
+          m_rackEvent = Simulator::Schedule (timeout, &TcpSocketBase::RackTimeout, this);
+        }
+    }
+
+  if (lost > 0)
+    {
+      NS_LOG_INFO (m_node->GetId () << " " << lost << " bytes deemed lost, pipe " <<
+                   m_txBuffer->BytesInFlight ());
+    }
+
+  if ((m_tcb->m_congState == TcpSocketState::CA_OPEN
+       || m_tcb->m_congState == TcpSocketState::CA_DISORDER)
+      && m_txBuffer->GetLostBytes () > 0 && m_highRxAckMark >= m_recover)
+    {
+      EnterSackRecovery ();
+    }
+}
+
+void
+TcpSocketBase::EnterSackRecovery (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  NS_LOG_DEBUG (TcpSocketState::TcpCongStateName[m_tcb->m_congState] <<
+                " -> RECOVERY");
+  m_recover = m_highTxMark;
+  m_tcb->m_congState = TcpSocketState::CA_RECOVERY;
+
+  // RFC 6675, sec.5 bullet #4.2: ssthresh = cwnd = (FlightSize / 2)
+  m_tcb->m_ssThresh = m_congestionControl->GetSsThresh (m_tcb, UnAckDataCount ());
+  m_tcb->m_cWnd = m_tcb->m_ssThresh;
+
+  NS_LOG_INFO ("Enter SACK-based loss recovery. Reset cwnd to " << m_tcb->m_cWnd <<
+               ", ssthresh to " << m_tcb->m_ssThresh << " at recovery seqnum " << m_recover);
+
+  // RFC 6675, sec.5 bullet #4.3: retransmit the first segment regardless of the pipe
+  SequenceNumber32 seq;
+  uint32_t size;
+  if (!m_txBuffer->NextSeg (&seq, &size, true))
+    {
+      seq = m_txBuffer->HeadSequence ();
+      size = m_tcb->m_segmentSize;
+    }
+  SendDataPacket (seq, size, true);
+  ++m_retransOut;
+
+  SendPendingData (m_connected);
+}
+
+uint32_t
+TcpSocketBase::SendRetransmissions (bool withAck, bool lostOnly)
+{
+  NS_LOG_FUNCTION (this << withAck << lostOnly);
+
+  uint32_t nPacketsSent = 0;
+  SequenceNumber32 seq;
+  uint32_t size;
+  while (!m_pacingEvent.IsRunning () && m_txBuffer->NextSeg (&seq, &size, lostOnly))
+    {
+      if (BytesInFlight () + size > m_tcb->m_cWnd.Get ())
+        {
+          break;
+        }
+      NS_LOG_LOGIC ("Retransmit segment of size " << size << " at seq " << seq);
+      SendDataPacket (seq, size, withAck);
+      ++m_retransOut;
+      ++nPacketsSent;
+    }
+  return nPacketsSent;
+}
+
+void
+TcpSocketBase::RackTimeout (void)
+{
+  NS_LOG_FUNCTION (this);
+  DetectSackLosses ();
+  SendPendingData (m_connected);
+}
+
 void TcpSocketBase::UpdateWindowSize (const TcpHeader &header)
 {
   NS_LOG_FUNCTION (this << header);
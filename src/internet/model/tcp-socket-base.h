@@ -33,6 +33,7 @@
 #include "ns3/ipv6-header.h"
 #include "ns3/ipv6-interface.h"
 #include "ns3/event-id.h"
+#include "ns3/data-rate.h"
 #include "tcp-tx-buffer.h"
 #include "tcp-rx-buffer.h"
 #include "rtt-estimator.h"
@@ -156,6 +157,14 @@ public:
 
   TracedValue<TcpCongState_t> m_congState;    //!< State in the Congestion state machine
 
+  // Kept updated by the socket, for the model-based congestion controls
+  SequenceNumber32       m_highTxMark;      //!< Highest seqno ever sent
+  SequenceNumber32       m_lastAckedSeq;    //!< Highest seqno cumulatively ACKed
+  Time                   m_rttSample;       //!< Last RTT sample, not smoothed
+
+  // Pacing
+  DataRate               m_pacingRate;      //!< Pacing rate of the segments, zero to disable pacing
+
   /**
    * \brief Get cwnd in segments rather than bytes
    *
@@ -715,6 +724,17 @@ protected:
 
   // Window management
 
+  /**
+   * \brief Get the largest payload of a super-segment
+   *
+   * Without pacing, it is the GsoMaxSize attribute. With pacing, it is
+   * further limited to about 1 ms of data at the pacing rate, so that the
+   * super-segments do not turn into line-rate bursts.
+   *
+   * \returns the largest payload, 0 if the super-segments are disabled
+   */
+  uint32_t GetGsoSize (void) const;
+
   /**
    * \brief Return count of number of unacked bytes
    * \returns count of number of unacked bytes
@@ -895,6 +915,70 @@ protected:
    */
   void AddOptionTimestamp (TcpHeader& header);
 
+  /**
+   * \brief Add the SACK-permitted option to the header
+   *
+   * The option is set only on SYN packets (\RFC{2018}).
+   *
+   * \param header TcpHeader to which add the option to
+   */
+  void AddOptionSackPermitted (TcpHeader& header);
+
+  /**
+   * \brief Add the SACK option to the header
+   *
+   * Report the out-of-order blocks of the receive buffer, as many as the
+   * space left for the options allows. The first block is the one holding
+   * the most recently received segment, the others follow from the highest
+   * one (\RFC{2018}, section 4).
+   *
+   * \param header TcpHeader to which add the option to
+   */
+  void AddOptionSack (TcpHeader& header);
+
+  // SACK-based loss recovery
+
+  /**
+   * \brief Update the scoreboard of the transmit buffer with an ACK
+   *
+   * The bytes acknowledged cumulatively and the blocks of the SACK option,
+   * if any, are marked as SACKed in the scoreboard.
+   *
+   * \param tcpHeader the ACK's TCP header
+   */
+  void ProcessOptionSack (const TcpHeader& tcpHeader);
+
+  /**
+   * \brief Mark as lost the segments of the scoreboard which the SACK
+   * (\RFC{6675}) or the RACK rules report, and enter the loss recovery if
+   * needed
+   */
+  void DetectSackLosses (void);
+
+  /**
+   * \brief Enter the SACK-based loss recovery (\RFC{6675}, section 5)
+   *
+   * Set ssthresh and cWnd to half the flight size, and retransmit the
+   * first segment lost regardless of the pipe.
+   */
+  void EnterSackRecovery (void);
+
+  /**
+   * \brief Retransmit the segments that \RFC{6675} NextSeg () returns, while
+   * the pipe allows
+   *
+   * \param withAck forces an ACK to be sent
+   * \param lostOnly true to retransmit only the segments deemed lost
+   * \returns the number of segments retransmitted
+   */
+  uint32_t SendRetransmissions (bool withAck, bool lostOnly);
+
+  /**
+   * \brief Action upon RACK reordering timeout, i.e. detect the segments
+   * lost by time and retransmit them
+   */
+  void RackTimeout (void);
+
   /**
    * \brief Performs a safe subtraction between a and b (a-b)
    *
@@ -973,6 +1057,14 @@ protected:
   bool     m_timestampEnabled;    //!< Timestamp option enabled
   uint32_t m_timestampToEcho;     //!< Timestamp to echo
 
+  bool             m_sackEnabled;  //!< SACK option enabled (RFC 2018)
+  bool             m_rackEnabled;  //!< RACK loss detection enabled, along with SACK
+  SequenceNumber32 m_lastDataSeq;  //!< Sequence number of the last data segment received
+  EventId          m_rackEvent;    //!< RACK reordering timeout event
+
+  EventId m_pacingEvent;          //!< Pacing event, to send the next segment
+  uint32_t m_gsoMaxSize;          //!< Largest super-segment payload, 0 to send single segments
+
   EventId m_sendPendingDataEvent; //!< micro-delay event to send pending data
 
   // Fast Retransmit and Recovery
@@ -25,6 +25,7 @@
 #include "ns3/packet.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include "ns3/simulator.h"
 
 #include "tcp-tx-buffer.h"
 
@@ -57,7 +58,10 @@ TcpTxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpTxBuffer::TcpTxBuffer (uint32_t n)
-  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_data (0)
+  : m_firstByteSeq (n), m_size (0), m_maxBuffer (32768), m_headOffset (0),
+    m_sackedBytes (0), m_lostBytes (0), m_retransBytes (0),
+    m_lostScanOffset (0), m_nextSegHint (0), m_holeHint (0),
+    m_rackEndOffset (0), m_minRtt (Time::Max ())
 {
 }
 
@@ -111,7 +115,10 @@ TcpTxBuffer::Add (Ptr<Packet> p)
     {
       if (p->GetSize () > 0)
         {
-          m_data.push_back (p);
+          Segment segment;
+          segment.packet = p;
+          segment.offset = m_headOffset + m_size;
+          m_data.push_back (segment);
           m_size += p->GetSize ();
           NS_LOG_LOGIC ("Updated size=" << m_size << ", lastSeq=" << m_firstByteSeq + SequenceNumber32 (m_size));
         }
@@ -133,6 +140,28 @@ TcpTxBuffer::SizeFromSequence (const SequenceNumber32& seq) const
   return lastSeq - seq;
 }
 
+uint32_t
+TcpTxBuffer::FindSegment (uint64_t offset) const
+{
+  NS_ASSERT (!m_data.empty () && m_data.front ().offset <= offset);
+  // the last segment starting at or before the offset
+  uint32_t low = 0;
+  uint32_t high = m_data.size ();
+  while (high - low > 1)
+    {
+      uint32_t middle = low + (high - low) / 2;
+      if (m_data[middle].offset <= offset)
+        {
+          low = middle;
+        }
+      else
+        {
+          high = middle;
+        }
+    }
+  return low;
+}
+
 Ptr<Packet>
 TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
 {
@@ -148,54 +177,33 @@ TcpTxBuffer::CopyFromSequence (uint32_t numBytes, const SequenceNumber32& seq)
     }
 
   // Extract data from the buffer and return
-  uint32_t offset = seq - m_firstByteSeq.Get ();
-  uint32_t count = 0;      // Offset of the first byte of a packet in the buffer
-  uint32_t pktSize = 0;
-  bool beginFound = false;
-  int pktCount = 0;
-  Ptr<Packet> outPacket;
-  NS_LOG_LOGIC ("There are " << m_data.size () << " number of packets in buffer");
-  for (BufIterator i = m_data.begin (); i != m_data.end (); ++i)
+  uint64_t offset = m_headOffset + (seq - m_firstByteSeq.Get ());
+  uint32_t i = FindSegment (offset);
+  NS_LOG_LOGIC ("First byte found in packet #" << i << " of " << m_data.size () << " at stream offset "
+                                               << m_data[i].offset << ", packet len=" << m_data[i].packet->GetSize ());
+  uint32_t packetOffset = offset - m_data[i].offset;
+  uint32_t fragmentLength = m_data[i].packet->GetSize () - packetOffset;
+  if (fragmentLength >= s)
+    { // Data to be copied falls entirely in this packet
+      return m_data[i].packet->CreateFragment (packetOffset, s);
+    }
+  // This packet only fulfills part of the request
+  Ptr<Packet> outPacket = m_data[i].packet->CreateFragment (packetOffset, fragmentLength);
+  uint32_t remaining = s - fragmentLength;
+  while (remaining > 0)
     {
-      pktCount++;
-      pktSize = (*i)->GetSize ();
-      if (!beginFound)
-        { // Look for first fragment
-          if (count + pktSize > offset)
-            {
-              NS_LOG_LOGIC ("First byte found in packet #" << pktCount << " at buffer offset " << count
-                                                           << ", packet len=" << pktSize);
-              beginFound = true;
-              uint32_t packetOffset = offset - count;
-              uint32_t fragmentLength = count + pktSize - offset;
-              if (fragmentLength >= s)
-                { // Data to be copied falls entirely in this packet
-                  return (*i)->CreateFragment (packetOffset, s);
-                }
-              else
-                { // This packet only fulfills part of the request
-                  outPacket = (*i)->CreateFragment (packetOffset, fragmentLength);
-                }
-              NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-            }
-        }
-      else if (count + pktSize >= offset + s)
+      Ptr<Packet> p = m_data[++i].packet;
+      if (p->GetSize () > remaining)
         { // Last packet fragment found
-          NS_LOG_LOGIC ("Last byte found in packet #" << pktCount << " at buffer offset " << count
-                                                      << ", packet len=" << pktSize);
-          uint32_t fragmentLength = offset + s - count;
-          Ptr<Packet> endFragment = (*i)->CreateFragment (0, fragmentLength);
-          outPacket->AddAtEnd (endFragment);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
-          break;
+          outPacket->AddAtEnd (p->CreateFragment (0, remaining));
+          remaining = 0;
         }
       else
         {
-          NS_LOG_LOGIC ("Appending to output the packet #" << pktCount << " of offset " << count << " len=" << pktSize);
-          outPacket->AddAtEnd (*i);
-          NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
+          outPacket->AddAtEnd (p);
+          remaining -= p->GetSize ();
         }
-      count += pktSize;
+      NS_LOG_LOGIC ("Output packet is now of size " << outPacket->GetSize ());
     }
   NS_ASSERT (outPacket->GetSize () == s);
   return outPacket;
@@ -217,40 +225,461 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq)
   // Cases do not need to scan the buffer
   if (m_firstByteSeq >= seq) return;
 
-  // Scan the buffer and discard packets
-  uint32_t offset = seq - m_firstByteSeq.Get ();  // Number of bytes to remove
-  uint32_t pktSize;
+  // Drop the segments which are behind the seqnum, the segment of the
+  // new first byte is kept whole
+  uint32_t offset = std::min<uint32_t> (seq - m_firstByteSeq.Get (), m_size);  // Number of bytes to remove
   NS_LOG_LOGIC ("Offset=" << offset);
-  BufIterator i = m_data.begin ();
-  while (i != m_data.end ())
+  m_headOffset += offset;
+  m_size -= offset;
+  while (!m_data.empty ()
+         && m_data.front ().offset + m_data.front ().packet->GetSize () <= m_headOffset)
     {
-      if (offset > (*i)->GetSize ())
-        { // This packet is behind the seqnum. Remove this packet from the buffer
-          pktSize = (*i)->GetSize ();
-          m_size -= pktSize;
-          offset -= pktSize;
-          m_firstByteSeq += pktSize;
-          i = m_data.erase (i);
-          NS_LOG_LOGIC ("Removed one packet of size " << pktSize << ", offset=" << offset);
-        }
-      else if (offset > 0)
-        { // Part of the packet is behind the seqnum. Fragment
-          pktSize = (*i)->GetSize () - offset;
-          *i = (*i)->CreateFragment (offset, pktSize);
-          m_size -= offset;
-          m_firstByteSeq += offset;
-          NS_LOG_LOGIC ("Fragmented one packet by size " << offset << ", new size=" << pktSize);
-          break;
+      NS_LOG_LOGIC ("Removed one packet of size " << m_data.front ().packet->GetSize ());
+      m_data.pop_front ();
+    }
+  // Drop the blocks SACKed below the head, and the segments of the
+  // scoreboard acknowledged. The rest of a segment partly acknowledged
+  // may now be SACKed as a whole.
+  while (!m_sacked.empty () && m_sacked.begin ()->first < m_headOffset)
+    {
+      uint64_t end = m_sacked.begin ()->second;
+      m_sacked.erase (m_sacked.begin ());
+      if (end > m_headOffset)
+        {
+          m_sacked[m_headOffset] = end;
         }
     }
-  // Catching the case of ACKing a FIN
-  if (m_size == 0)
+  while (!m_sent.empty () && m_sent.front ().offset < m_headOffset)
     {
-      m_firstByteSeq = seq;
+      SentSegment &segment = m_sent.front ();
+      if (segment.offset + segment.size > m_headOffset)
+        {
+          Count (segment, false);
+          segment.size -= m_headOffset - segment.offset;
+          segment.offset = m_headOffset;
+          Count (segment, true);
+          if (!segment.sacked && !m_sacked.empty () && m_sacked.begin ()->first == m_headOffset
+              && m_sacked.begin ()->second >= m_headOffset + segment.size)
+            {
+              Delivered (segment);
+              SetMarks (segment, true, segment.lost, segment.retrans);
+            }
+          break;
+        }
+      if (!segment.sacked)
+        {
+          Delivered (segment);
+        }
+      Count (segment, false);
+      if (IsInFlight (segment))
+        {
+          m_inFlight.erase (segment.inFlight);
+        }
+      m_sent.pop_front ();
     }
+  // Includes the case of ACKing a FIN
+  m_firstByteSeq = seq;
   NS_LOG_LOGIC ("size=" << m_size << " headSeq=" << m_firstByteSeq << " maxBuffer=" << m_maxBuffer
                         <<" numPkts="<< m_data.size ());
-  NS_ASSERT (m_firstByteSeq == seq);
+}
+
+bool
+TcpTxBuffer::IsInFlight (const SentSegment &segment)
+{
+  return !segment.sacked && (!segment.lost || segment.retrans);
+}
+
+void
+TcpTxBuffer::Count (const SentSegment &segment, bool add)
+{
+  uint32_t sacked = segment.sacked ? segment.size : 0;
+  uint32_t lost = (!segment.sacked && segment.lost) ? segment.size : 0;
+  uint32_t retrans = (!segment.sacked && segment.retrans) ? segment.size : 0;
+  if (add)
+    {
+      m_sackedBytes += sacked;
+      m_lostBytes += lost;
+      m_retransBytes += retrans;
+    }
+  else
+    {
+      m_sackedBytes -= sacked;
+      m_lostBytes -= lost;
+      m_retransBytes -= retrans;
+    }
+}
+
+void
+TcpTxBuffer::SetMarks (SentSegment &segment, bool sacked, bool lost, bool retrans)
+{
+  bool wasInFlight = IsInFlight (segment);
+  Count (segment, false);
+  segment.sacked = sacked;
+  segment.lost = lost;
+  segment.retrans = retrans;
+  Count (segment, true);
+  if (wasInFlight && !IsInFlight (segment))
+    {
+      m_inFlight.erase (segment.inFlight);
+    }
+  else if (!wasInFlight && IsInFlight (segment))
+    {
+      segment.inFlight = m_inFlight.insert (m_inFlight.end (), &segment);
+    }
+  if (lost && !sacked && !retrans && segment.offset < m_nextSegHint)
+    {
+      m_nextSegHint = segment.offset;
+    }
+}
+
+void
+TcpTxBuffer::Delivered (const SentSegment &segment)
+{
+  Time rtt = Simulator::Now () - segment.lastSent;
+  if (segment.retrans && rtt < m_minRtt)
+    {
+      // Too early for the retransmission: the original was delivered
+      return;
+    }
+  if (!segment.retrans)
+    {
+      m_minRtt = std::min (m_minRtt, rtt);
+    }
+  uint64_t end = segment.offset + segment.size;
+  if (segment.lastSent > m_rackXmitTime
+      || (segment.lastSent == m_rackXmitTime && end > m_rackEndOffset))
+    {
+      m_rackXmitTime = segment.lastSent;
+      m_rackEndOffset = end;
+      m_rackRtt = rtt;
+    }
+}
+
+uint32_t
+TcpTxBuffer::FindSent (uint64_t offset) const
+{
+  NS_ASSERT (!m_sent.empty () && m_sent.front ().offset <= offset);
+  // the last segment starting at or before the offset
+  uint32_t low = 0;
+  uint32_t high = m_sent.size ();
+  while (high - low > 1)
+    {
+      uint32_t middle = low + (high - low) / 2;
+      if (m_sent[middle].offset <= offset)
+        {
+          low = middle;
+        }
+      else
+        {
+          high = middle;
+        }
+    }
+  return low;
+}
+
+uint64_t
+TcpTxBuffer::SentEnd (void) const
+{
+  if (m_sent.empty ())
+    {
+      return m_headOffset;
+    }
+  return m_sent.back ().offset + m_sent.back ().size;
+}
+
+void
+TcpTxBuffer::Sent (const SequenceNumber32& seq, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << seq << size);
+  if (size == 0 || seq < m_firstByteSeq)
+    {
+      return;
+    }
+  uint64_t offset = m_headOffset + (seq - m_firstByteSeq.Get ());
+  uint64_t end = offset + size;
+  uint64_t sentEnd = SentEnd ();
+  Time now = Simulator::Now ();
+  if (offset < sentEnd)
+    {
+      for (uint32_t i = FindSent (offset); i < m_sent.size () && m_sent[i].offset < end; ++i)
+        {
+          SentSegment &segment = m_sent[i];
+          if (segment.sacked)
+            {
+              continue;
+            }
+          if (IsInFlight (segment))
+            {
+              // move it to the end of the transmission order
+              m_inFlight.erase (segment.inFlight);
+              segment.inFlight = m_inFlight.insert (m_inFlight.end (), &segment);
+            }
+          segment.lastSent = now;
+          SetMarks (segment, false, segment.lost, true);
+        }
+    }
+  if (end > sentEnd)
+    {
+      SentSegment segment;
+      segment.offset = sentEnd;
+      segment.size = end - sentEnd;
+      segment.sacked = false;
+      segment.lost = false;
+      segment.retrans = false;
+      segment.lastSent = now;
+      m_sent.push_back (segment);
+      m_sent.back ().inFlight = m_inFlight.insert (m_inFlight.end (), &m_sent.back ());
+    }
+}
+
+uint32_t
+TcpTxBuffer::Update (const SequenceBlockList& blocks)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t sacked = 0;
+  uint64_t sentEnd = SentEnd ();
+  for (SequenceBlockList::const_iterator block = blocks.begin (); block != blocks.end (); ++block)
+    {
+      // clip the block to the bytes sent and not acknowledged
+      if (block->second <= m_firstByteSeq || block->first >= block->second)
+        {
+          continue;
+        }
+      uint64_t start = m_headOffset;
+      if (block->first > m_firstByteSeq)
+        {
+          start += block->first - m_firstByteSeq.Get ();
+        }
+      uint64_t end = std::min (m_headOffset + (block->second - m_firstByteSeq.Get ()), sentEnd);
+      if (start >= end)
+        {
+          continue;
+        }
+      NS_LOG_LOGIC ("SACK block [" << block->first << ";" << block->second << ")");
+
+      // Merge the block with the blocks SACKed before that it overlaps or
+      // touches, and mark the segments which the gaps between them complete
+      std::map<uint64_t, uint64_t>::iterator it = m_sacked.upper_bound (start);
+      if (it != m_sacked.begin ())
+        {
+          --it;
+          if (it->second < start)
+            {
+              ++it;
+            }
+        }
+      uint64_t mergedStart = start;
+      if (it != m_sacked.end () && it->first < mergedStart)
+        {
+          mergedStart = it->first;
+        }
+      uint64_t cursor = start;
+      while (cursor < end)
+        {
+          uint64_t gapEnd = end;
+          uint64_t bound = end;
+          if (it != m_sacked.end () && it->first <= end)
+            {
+              gapEnd = std::max (cursor, it->first);
+              bound = std::max (end, it->second);
+            }
+          if (cursor < gapEnd)
+            {
+              for (uint32_t i = FindSent (cursor); i < m_sent.size () && m_sent[i].offset < gapEnd; ++i)
+                {
+                  SentSegment &segment = m_sent[i];
+                  if (!segment.sacked && segment.offset >= mergedStart
+                      && segment.offset + segment.size <= bound)
+                    {
+                      Delivered (segment);
+                      SetMarks (segment, true, segment.lost, segment.retrans);
+                      sacked += segment.size;
+                    }
+                }
+            }
+          if (it != m_sacked.end () && it->first <= end)
+            {
+              cursor = std::max (cursor, it->second);
+              end = std::max (end, it->second);
+              m_sacked.erase (it++);
+            }
+          else
+            {
+              cursor = end;
+            }
+        }
+      m_sacked[mergedStart] = end;
+    }
+  return sacked;
+}
+
+uint32_t
+TcpTxBuffer::DetectLoss (uint32_t dupThresh, uint32_t segmentSize)
+{
+  NS_LOG_FUNCTION (this << dupThresh << segmentSize);
+  // The segments ending at or before the boundary have enough SACKed
+  // blocks or bytes above them
+  uint64_t limit = static_cast<uint64_t> (dupThresh - 1) * segmentSize;
+  uint64_t bytes = 0;
+  uint32_t blocks = 0;
+  uint64_t boundary = 0;
+  for (std::map<uint64_t, uint64_t>::reverse_iterator it = m_sacked.rbegin (); it != m_sacked.rend (); ++it)
+    {
+      uint64_t length = it->second - it->first;
+      if (bytes + length > limit)
+        {
+          boundary = it->second - (limit + 1 - bytes);
+          break;
+        }
+      if (++blocks >= dupThresh)
+        {
+          boundary = it->first;
+          break;
+        }
+      bytes += length;
+    }
+
+  uint32_t lost = 0;
+  uint64_t from = std::max (m_lostScanOffset, m_headOffset);
+  if (from >= boundary || from >= SentEnd ())
+    {
+      return 0;
+    }
+  uint32_t i = FindSent (from);
+  for (; i < m_sent.size () && m_sent[i].offset + m_sent[i].size <= boundary; ++i)
+    {
+      SentSegment &segment = m_sent[i];
+      if (!segment.sacked && !segment.lost)
+        {
+          SetMarks (segment, false, true, segment.retrans);
+          lost += segment.size;
+        }
+    }
+  m_lostScanOffset = i < m_sent.size () ? m_sent[i].offset : SentEnd ();
+  NS_LOG_LOGIC ("Marked " << lost << " bytes lost below offset " << boundary);
+  return lost;
+}
+
+Time
+TcpTxBuffer::DetectLossByTime (Time reoWnd, uint32_t *lost)
+{
+  NS_LOG_FUNCTION (this << reoWnd);
+  *lost = 0;
+  if (m_rackEndOffset == 0)
+    {
+      return Time (0);
+    }
+  Time now = Simulator::Now ();
+  InFlightList::iterator it = m_inFlight.begin ();
+  while (it != m_inFlight.end ())
+    {
+      SentSegment &segment = **it;
+      if (segment.lastSent > m_rackXmitTime
+          || (segment.lastSent == m_rackXmitTime && segment.offset + segment.size >= m_rackEndOffset))
+        {
+          // sent after the most recently delivered segment
+          break;
+        }
+      Time remaining = segment.lastSent + m_rackRtt + reoWnd - now;
+      if (remaining.IsStrictlyPositive ())
+        {
+          return remaining;
+        }
+      ++it;
+      SetMarks (segment, false, true, false);
+      *lost += segment.size;
+    }
+  return Time (0);
+}
+
+void
+TcpTxBuffer::MarkAllLost (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_sent.size (); ++i)
+    {
+      if (!m_sent[i].sacked)
+        {
+          SetMarks (m_sent[i], false, true, false);
+        }
+    }
+  m_lostScanOffset = SentEnd ();
+}
+
+bool
+TcpTxBuffer::NextSeg (SequenceNumber32 *seq, uint32_t *size, bool lostOnly)
+{
+  NS_LOG_FUNCTION (this << lostOnly);
+  // Rule 1: the first segment lost and not retransmitted
+  uint64_t sentEnd = SentEnd ();
+  m_nextSegHint = std::max (m_nextSegHint, m_headOffset);
+  if (m_nextSegHint < sentEnd)
+    {
+      for (uint32_t i = FindSent (m_nextSegHint); i < m_sent.size (); ++i)
+        {
+          const SentSegment &segment = m_sent[i];
+          if (segment.lost && !segment.sacked && !segment.retrans)
+            {
+              m_nextSegHint = segment.offset;
+              *seq = m_firstByteSeq + SequenceNumber32 (segment.offset - m_headOffset);
+              *size = segment.size;
+              return true;
+            }
+        }
+      m_nextSegHint = sentEnd;
+    }
+  if (lostOnly || m_sacked.empty ())
+    {
+      return false;
+    }
+  // Rule 3: the first segment neither SACKed, lost nor retransmitted below
+  // the highest SACKed byte. A segment SACKed, lost or retransmitted never
+  // turns back into such a segment, so the search resumes from a hint.
+  uint64_t highSacked = m_sacked.rbegin ()->second;
+  m_holeHint = std::max (m_holeHint, m_headOffset);
+  if (m_holeHint >= highSacked || m_holeHint >= sentEnd)
+    {
+      return false;
+    }
+  uint32_t i = FindSent (m_holeHint);
+  for (; i < m_sent.size () && m_sent[i].offset < highSacked; ++i)
+    {
+      const SentSegment &segment = m_sent[i];
+      if (!segment.sacked && !segment.lost && !segment.retrans)
+        {
+          m_holeHint = segment.offset;
+          *seq = m_firstByteSeq + SequenceNumber32 (segment.offset - m_headOffset);
+          *size = segment.size;
+          return true;
+        }
+    }
+  m_holeHint = i < m_sent.size () ? m_sent[i].offset : sentEnd;
+  return false;
+}
+
+uint32_t
+TcpTxBuffer::BytesInFlight (void) const
+{
+  uint32_t sent = SentEnd () - m_headOffset;
+  return sent - m_sackedBytes - m_lostBytes + m_retransBytes;
+}
+
+uint32_t
+TcpTxBuffer::GetSackedBytes (void) const
+{
+  return m_sackedBytes;
+}
+
+uint32_t
+TcpTxBuffer::GetLostBytes (void) const
+{
+  return m_lostBytes;
+}
+
+Time
+TcpTxBuffer::GetMinRtt (void) const
+{
+  return m_minRtt;
 }
 
 } // namepsace ns3
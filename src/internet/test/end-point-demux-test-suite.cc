@@ -0,0 +1,305 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-interface.h"
+#include "../model/ipv4-end-point.h"
+#include "../model/ipv4-end-point-demux.h"
+#include "../model/ipv6-end-point.h"
+#include "../model/ipv6-end-point-demux.h"
+
+using namespace ns3;
+
+/**
+ * Check the lookups of the IPv4 demux against a scan of all its end
+ * points with the match rules of Ipv4EndPointDemux::Lookup, while end
+ * points are allocated, connected, disabled and removed.
+ */
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv4EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \returns a pseudo random number
+   */
+  uint32_t Next (void);
+  /**
+   * \param demux the demux
+   * \param daddr destination address
+   * \param dport destination port
+   * \param saddr source address
+   * \param sport source port
+   * \returns the most-matching end points of a scan of all the end points
+   */
+  static Ipv4EndPointDemux::EndPoints ScanLookup (Ipv4EndPointDemux &demux,
+                                                  Ipv4Address daddr, uint16_t dport,
+                                                  Ipv4Address saddr, uint16_t sport);
+
+  uint32_t m_state; //!< The state of the pseudo random numbers
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase ()
+  : TestCase ("Check the lookups of Ipv4EndPointDemux against a scan of the end points"),
+    m_state (1)
+{
+}
+
+uint32_t
+Ipv4EndPointDemuxTestCase::Next (void)
+{
+  m_state = m_state * 1103515245 + 12345;
+  return m_state ^ (m_state >> 16);
+}
+
+Ipv4EndPointDemux::EndPoints
+Ipv4EndPointDemuxTestCase::ScanLookup (Ipv4EndPointDemux &demux,
+                                       Ipv4Address daddr, uint16_t dport,
+                                       Ipv4Address saddr, uint16_t sport)
+{
+  // only local port, local port and address, all but local address, all 4
+  Ipv4EndPointDemux::EndPoints retval[4];
+  Ipv4EndPointDemux::EndPoints endPoints = demux.GetAllEndPoints ();
+  for (Ipv4EndPointDemux::EndPointsI i = endPoints.begin (); i != endPoints.end (); i++)
+    {
+      Ipv4EndPoint *endP = *i;
+      if (!endP->IsRxEnabled () || endP->GetLocalPort () != dport)
+        {
+          continue;
+        }
+      bool localWildCard = endP->GetLocalAddress () == Ipv4Address::GetAny ();
+      bool localExact = endP->GetLocalAddress () == daddr;
+      bool peerPortWildCard = endP->GetPeerPort () == 0;
+      bool peerPortExact = endP->GetPeerPort () == sport;
+      bool peerAddressWildCard = endP->GetPeerAddress () == Ipv4Address::GetAny ();
+      bool peerAddressExact = endP->GetPeerAddress () == saddr;
+      if (localWildCard && peerPortWildCard && peerAddressWildCard)
+        {
+          retval[0].push_back (endP);
+        }
+      if (localExact && peerPortWildCard && peerAddressWildCard)
+        {
+          retval[1].push_back (endP);
+        }
+      if (localWildCard && peerPortExact && peerAddressExact)
+        {
+          retval[2].push_back (endP);
+        }
+      if (localExact && peerPortExact && peerAddressExact)
+        {
+          retval[3].push_back (endP);
+        }
+    }
+  for (uint32_t i = 3; i > 0; i--)
+    {
+      if (!retval[i].empty ())
+        {
+          return retval[i];
+        }
+    }
+  return retval[0];
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv4Address locals[] = { Ipv4Address::GetAny (), Ipv4Address ("10.0.0.1"), Ipv4Address ("10.0.0.2") };
+  Ipv4Address peers[] = { Ipv4Address::GetAny (), Ipv4Address ("10.0.1.1"), Ipv4Address ("10.0.1.2") };
+  uint16_t localPorts[] = { 80, 81 };
+  uint16_t peerPorts[] = { 0, 1000, 1001 };
+  Ptr<Ipv4Interface> interface = CreateObject<Ipv4Interface> ();
+
+  Ipv4EndPointDemux demux;
+  std::vector<Ipv4EndPoint *> endPoints;
+  for (uint32_t k = 0; k < 3000; k++)
+    {
+      Ipv4Address daddr = locals[1 + Next () % 2];
+      uint16_t dport = localPorts[Next () % 2];
+      Ipv4Address saddr = peers[1 + Next () % 2];
+      uint16_t sport = peerPorts[1 + Next () % 2];
+      switch (Next () % 8)
+        {
+        case 0:
+          {
+            Ipv4EndPoint *endPoint = demux.Allocate (locals[Next () % 3], localPorts[Next () % 2]);
+            if (endPoint != 0)
+              {
+                endPoints.push_back (endPoint);
+              }
+          }
+          break;
+        case 1:
+          {
+            Ipv4EndPoint *endPoint = demux.Allocate (daddr, dport, saddr, sport);
+            if (endPoint != 0)
+              {
+                endPoints.push_back (endPoint);
+              }
+            else
+              {
+                NS_TEST_ASSERT_MSG_EQ ((demux.SimpleLookup (daddr, dport, saddr, sport) != 0), true,
+                                       "Allocation of a new four-tuple failed");
+              }
+          }
+          break;
+        case 2:
+          if (!endPoints.empty ())
+            {
+              endPoints[Next () % endPoints.size ()]->SetPeer (peers[Next () % 3], peerPorts[Next () % 3]);
+            }
+          break;
+        case 3:
+          if (!endPoints.empty ())
+            {
+              endPoints[Next () % endPoints.size ()]->SetLocalAddress (locals[Next () % 3]);
+            }
+          break;
+        case 4:
+          if (!endPoints.empty ())
+            {
+              uint32_t i = Next () % endPoints.size ();
+              if (Next () % 4 == 0)
+                {
+                  endPoints[i]->SetRxEnabled (false);
+                }
+              else
+                {
+                  demux.DeAllocate (endPoints[i]);
+                  endPoints.erase (endPoints.begin () + i);
+                }
+            }
+          break;
+        default:
+          {
+            Ipv4EndPointDemux::EndPoints expected = ScanLookup (demux, daddr, dport, saddr, sport);
+            Ipv4EndPointDemux::EndPoints found = demux.Lookup (daddr, dport, saddr, sport, interface);
+            NS_TEST_ASSERT_MSG_EQ ((found == expected), true, "Wrong end points for " << daddr << ":" << dport
+                                   << " from " << saddr << ":" << sport);
+          }
+          break;
+        }
+      NS_TEST_ASSERT_MSG_EQ (demux.GetAllEndPoints ().size (), endPoints.size (), "Wrong number of end points");
+      bool used = false;
+      for (uint32_t i = 0; i < endPoints.size (); i++)
+        {
+          used = used || endPoints[i]->GetLocalPort () == dport;
+        }
+      NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (dport), used, "Wrong use of the local port");
+    }
+
+  // the ephemeral ports which are in use are skipped
+  Ipv4EndPoint *first = demux.Allocate ();
+  NS_TEST_ASSERT_MSG_EQ ((first != 0), true, "Ephemeral port expected");
+  Ipv4EndPoint *bound = demux.Allocate (first->GetLocalPort () + 1);
+  NS_TEST_ASSERT_MSG_EQ ((bound != 0), true, "Free port expected");
+  Ipv4EndPoint *second = demux.Allocate ();
+  NS_TEST_ASSERT_MSG_EQ (second->GetLocalPort (), first->GetLocalPort () + 2, "Port in use not skipped");
+  demux.DeAllocate (bound);
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (first->GetLocalPort () + 1), false, "Port still in use");
+}
+
+/**
+ * Check the lookups of the IPv6 demux for connected and listening end
+ * points.
+ */
+class Ipv6EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv6EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ipv6EndPointDemuxTestCase::Ipv6EndPointDemuxTestCase ()
+  : TestCase ("Check the lookups of Ipv6EndPointDemux")
+{
+}
+
+void
+Ipv6EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv6Address local ("2001:db8::1");
+  Ptr<Ipv6Interface> interface = CreateObject<Ipv6Interface> ();
+  Ipv6EndPointDemux demux;
+
+  Ipv6EndPoint *any = demux.Allocate (80);
+  Ipv6EndPoint *listener = demux.Allocate (local, 80);
+  NS_TEST_ASSERT_MSG_EQ ((demux.Allocate (local, 80) == 0), true, "Duplicate address and port allocated");
+  std::vector<Ipv6EndPoint *> connections;
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      connections.push_back (demux.Allocate (local, 80, Ipv6Address ("2001:db8::2"), 1000 + i));
+    }
+  NS_TEST_ASSERT_MSG_EQ ((demux.Allocate (local, 80, Ipv6Address ("2001:db8::2"), 1000) == 0), true,
+                         "Duplicate four-tuple allocated");
+
+  Ipv6EndPointDemux::EndPoints found = demux.Lookup (local, 80, Ipv6Address ("2001:db8::2"), 1042, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "One end point expected");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), connections[42], "Connected end point expected");
+  NS_TEST_ASSERT_MSG_EQ (demux.SimpleLookup (local, 80, Ipv6Address ("2001:db8::2"), 1042), connections[42],
+                         "Connected end point expected");
+  found = demux.Lookup (local, 80, Ipv6Address ("2001:db8::3"), 1042, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "One end point expected");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), listener, "Listening end point expected");
+  found = demux.Lookup (Ipv6Address ("2001:db8::4"), 80, Ipv6Address ("2001:db8::3"), 1042, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "One end point expected");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), any, "Wildcard end point expected");
+
+  // a connection which changes its peer is found with its new four-tuple
+  connections[42]->SetPeer (Ipv6Address ("2001:db8::3"), 2000);
+  found = demux.Lookup (local, 80, Ipv6Address ("2001:db8::2"), 1042, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.front (), listener, "Listening end point expected");
+  found = demux.Lookup (local, 80, Ipv6Address ("2001:db8::3"), 2000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.front (), connections[42], "Connected end point expected");
+
+  // an end point which gets a local address and a peer becomes connected
+  Ipv6EndPoint *client = demux.Allocate ();
+  client->SetLocalAddress (local);
+  client->SetPeer (Ipv6Address ("2001:db8::5"), 80);
+  found = demux.Lookup (local, client->GetLocalPort (), Ipv6Address ("2001:db8::5"), 80, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "One end point expected");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), client, "Client end point expected");
+
+  for (uint32_t i = 0; i < connections.size (); i++)
+    {
+      demux.DeAllocate (connections[i]);
+    }
+  found = demux.Lookup (local, 80, Ipv6Address ("2001:db8::3"), 2000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.front (), listener, "Listening end point expected");
+  demux.DeAllocate (listener);
+  found = demux.Lookup (local, 80, Ipv6Address ("2001:db8::3"), 2000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.front (), any, "Wildcard end point expected");
+  NS_TEST_ASSERT_MSG_EQ (demux.GetEndPoints ().size (), 2, "Two end points expected");
+}
+
+class EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  EndPointDemuxTestSuite ()
+    : TestSuite ("end-point-demux", UNIT)
+  {
+    AddTestCase (new Ipv4EndPointDemuxTestCase, TestCase::QUICK);
+    AddTestCase (new Ipv6EndPointDemuxTestCase, TestCase::QUICK);
+  }
+};
+
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite;
@@ -27,6 +27,7 @@
 #include "ns3/candidate-queue.h"
 #include "ns3/simulator.h"
 #include <cstdlib> // for rand()
+#include <list>
 
 using namespace ns3;
 
@@ -214,6 +215,105 @@ GlobalRouteManagerImplTestCase::DoRun (void)
 }
 
 
+/**
+ * \brief Check the order of the vertices popped from a CandidateQueue
+ * against a list sorted like the queue used to be.
+ */
+class CandidateQueueTestCase : public TestCase
+{
+public:
+  CandidateQueueTestCase();
+  virtual void DoRun (void);
+private:
+  /**
+   * \param v1 first vertex
+   * \param v2 second vertex
+   * \returns true if v1 should be popped before v2
+   */
+  static bool Compare (const SPFVertex* v1, const SPFVertex* v2);
+};
+
+CandidateQueueTestCase::CandidateQueueTestCase()
+  : TestCase ("CandidateQueue with decrease-key against a sorted list")
+{
+}
+
+bool
+CandidateQueueTestCase::Compare (const SPFVertex* v1, const SPFVertex* v2)
+{
+  if (v1->GetDistanceFromRoot () != v2->GetDistanceFromRoot ())
+    {
+      return v1->GetDistanceFromRoot () < v2->GetDistanceFromRoot ();
+    }
+  return v1->GetVertexType () == SPFVertex::VertexNetwork
+         && v2->GetVertexType () == SPFVertex::VertexRouter;
+}
+
+void
+CandidateQueueTestCase::DoRun (void)
+{
+  CandidateQueue candidate;
+  std::list<SPFVertex *> sorted;
+  uint32_t id = 0;
+
+  for (int round = 0; round < 2000; ++round)
+    {
+      int operation = std::rand () % 4;
+      if (operation == 0 || sorted.empty ())
+        {
+          // push a vertex after the ones of the same priority
+          SPFVertex *v = new SPFVertex;
+          v->SetVertexId (Ipv4Address (++id));
+          v->SetVertexType (std::rand () % 2 ? SPFVertex::VertexRouter : SPFVertex::VertexNetwork);
+          v->SetDistanceFromRoot (std::rand () % 20);
+          candidate.Push (v);
+          std::list<SPFVertex *>::iterator i = sorted.begin ();
+          while (i != sorted.end () && !Compare (v, *i))
+            {
+              i++;
+            }
+          sorted.insert (i, v);
+        }
+      else if (operation == 1)
+        {
+          // decrease the distance of a queued vertex
+          std::list<SPFVertex *>::iterator i = sorted.begin ();
+          std::advance (i, std::rand () % sorted.size ());
+          SPFVertex *v = *i;
+          if (v->GetDistanceFromRoot () > 0)
+            {
+              v->SetDistanceFromRoot (std::rand () % v->GetDistanceFromRoot ());
+              candidate.Update (v);
+              sorted.sort (&CandidateQueueTestCase::Compare);
+            }
+        }
+      else if (operation == 2)
+        {
+          SPFVertex *v = sorted.back ();
+          NS_TEST_ASSERT_MSG_EQ (candidate.Find (v->GetVertexId ()), v, "Vertex not found");
+          NS_TEST_ASSERT_MSG_EQ (candidate.Find (Ipv4Address (id + 1)), 0, "Vertex found but not queued");
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_EQ (candidate.Top (), sorted.front (), "Wrong top vertex");
+          SPFVertex *v = candidate.Pop ();
+          NS_TEST_ASSERT_MSG_EQ (v, sorted.front (), "Wrong popped vertex");
+          sorted.pop_front ();
+          NS_TEST_ASSERT_MSG_EQ (candidate.Find (v->GetVertexId ()), 0, "Popped vertex still found");
+          delete v;
+        }
+      NS_TEST_ASSERT_MSG_EQ (candidate.Size (), sorted.size (), "Wrong size");
+    }
+  while (!sorted.empty ())
+    {
+      SPFVertex *v = candidate.Pop ();
+      NS_TEST_ASSERT_MSG_EQ (v, sorted.front (), "Wrong popped vertex");
+      sorted.pop_front ();
+      delete v;
+    }
+  NS_TEST_ASSERT_MSG_EQ (candidate.Empty (), true, "Queue not empty");
+}
+
 static class GlobalRouteManagerImplTestSuite : public TestSuite
 {
 public:
@@ -221,5 +321,6 @@ public:
     : TestSuite ("global-route-manager-impl", UNIT)
   {
     AddTestCase (new GlobalRouteManagerImplTestCase (), TestCase::QUICK);
+    AddTestCase (new CandidateQueueTestCase (), TestCase::QUICK);
   }
 } g_globalRoutingManagerImplTestSuite;
@@ -0,0 +1,205 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/boolean.h"
+#include "ns3/global-value.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/ethernet-trailer.h"
+#include "ns3/checksum-offload.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/udp-header.h"
+#include "ns3/tcp-header.h"
+#include "ns3/icmpv4.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/udp-l4-protocol.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/icmpv4-l4-protocol.h"
+
+using namespace ns3;
+
+/**
+ * Check that the checksums filled by ChecksumOffload::Complete in a
+ * frame are those computed by the headers.
+ */
+class Ipv4ChecksumOffloadTestCase : public TestCase
+{
+public:
+  Ipv4ChecksumOffloadTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Build an Ethernet frame carrying an IPv4 packet.
+   * \param protocol the transport protocol
+   * \param defer whether the checksums are deferred
+   * \returns the frame
+   */
+  Ptr<Packet> MakeFrame (uint8_t protocol, bool defer);
+  /**
+   * \param packet a packet
+   * \returns the bytes of the packet
+   */
+  std::vector<uint8_t> GetBytes (Ptr<const Packet> packet);
+};
+
+Ipv4ChecksumOffloadTestCase::Ipv4ChecksumOffloadTestCase ()
+  : TestCase ("Completion of the deferred IPv4 checksums")
+{
+}
+
+Ptr<Packet>
+Ipv4ChecksumOffloadTestCase::MakeFrame (uint8_t protocol, bool defer)
+{
+  Ipv4Address source ("10.1.2.3");
+  Ipv4Address destination ("192.168.200.17");
+  // An odd size, so that the transport checksum ends with a single byte
+  std::vector<uint8_t> payload (301);
+  for (uint32_t i = 0; i < payload.size (); i++)
+    {
+      payload[i] = (i * 7 + 3) & 0xff;
+    }
+  Ptr<Packet> p = Create<Packet> (&payload[0], payload.size ());
+
+  if (protocol == UdpL4Protocol::PROT_NUMBER)
+    {
+      UdpHeader udpHeader;
+      udpHeader.SetSourcePort (49153);
+      udpHeader.SetDestinationPort (9);
+      if (!defer)
+        {
+          udpHeader.EnableChecksums ();
+          udpHeader.InitializeChecksum (source, destination, protocol);
+        }
+      p->AddHeader (udpHeader);
+    }
+  else if (protocol == TcpL4Protocol::PROT_NUMBER)
+    {
+      TcpHeader tcpHeader;
+      tcpHeader.SetSourcePort (49153);
+      tcpHeader.SetDestinationPort (80);
+      tcpHeader.SetSequenceNumber (SequenceNumber32 (0x12345678));
+      tcpHeader.SetAckNumber (SequenceNumber32 (0x9abcdef0));
+      tcpHeader.SetFlags (TcpHeader::ACK | TcpHeader::PSH);
+      tcpHeader.SetWindowSize (1000);
+      if (!defer)
+        {
+          tcpHeader.EnableChecksums ();
+          tcpHeader.InitializeChecksum (source, destination, protocol);
+        }
+      p->AddHeader (tcpHeader);
+    }
+  else
+    {
+      Icmpv4Echo echo;
+      echo.SetIdentifier (1);
+      echo.SetSequenceNumber (2);
+      p->AddHeader (echo);
+      Icmpv4Header icmpHeader;
+      icmpHeader.SetType (Icmpv4Header::ECHO);
+      if (!defer)
+        {
+          icmpHeader.EnableChecksum ();
+        }
+      p->AddHeader (icmpHeader);
+    }
+
+  Ipv4Header ipHeader;
+  ipHeader.SetSource (source);
+  ipHeader.SetDestination (destination);
+  ipHeader.SetProtocol (protocol);
+  ipHeader.SetPayloadSize (p->GetSize ());
+  ipHeader.SetTtl (64);
+  ipHeader.SetIdentification (0x4321);
+  if (defer)
+    {
+      ChecksumOffload::Defer (p, Ipv4L3Protocol::PROT_NUMBER, ipHeader.GetSerializedSize ());
+    }
+  else
+    {
+      ipHeader.EnableChecksum ();
+    }
+  p->AddHeader (ipHeader);
+
+  EthernetHeader ethernetHeader;
+  ethernetHeader.SetLengthType (Ipv4L3Protocol::PROT_NUMBER);
+  p->AddHeader (ethernetHeader);
+  EthernetTrailer ethernetTrailer;
+  p->AddTrailer (ethernetTrailer);
+  return p;
+}
+
+std::vector<uint8_t>
+Ipv4ChecksumOffloadTestCase::GetBytes (Ptr<const Packet> packet)
+{
+  std::vector<uint8_t> bytes (packet->GetSize ());
+  packet->CopyData (&bytes[0], bytes.size ());
+  return bytes;
+}
+
+void
+Ipv4ChecksumOffloadTestCase::DoRun (void)
+{
+  // Registers the completion of the IPv4 checksums
+  CreateObject<Ipv4L3Protocol> ();
+
+  GlobalValue::Bind ("ChecksumOffload", BooleanValue (true));
+  NS_TEST_EXPECT_MSG_EQ (ChecksumOffload::IsEnabled (), true, "Checksum offload not enabled");
+  GlobalValue::Bind ("ChecksumEnabled", BooleanValue (true));
+  NS_TEST_EXPECT_MSG_EQ (ChecksumOffload::IsEnabled (), false, "Checksums both computed and deferred");
+  GlobalValue::Bind ("ChecksumEnabled", BooleanValue (false));
+  GlobalValue::Bind ("ChecksumOffload", BooleanValue (false));
+
+  uint8_t protocols[] = { UdpL4Protocol::PROT_NUMBER, TcpL4Protocol::PROT_NUMBER, Icmpv4L4Protocol::PROT_NUMBER };
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Ptr<Packet> computed = MakeFrame (protocols[i], false);
+      Ptr<Packet> deferred = MakeFrame (protocols[i], true);
+      NS_TEST_EXPECT_MSG_EQ ((GetBytes (computed) == GetBytes (deferred)), false,
+                             "Checksums computed for protocol " << +protocols[i]);
+      Ptr<const Packet> completed = ChecksumOffload::Complete (deferred);
+      NS_TEST_EXPECT_MSG_EQ ((GetBytes (computed) == GetBytes (completed)), true,
+                             "Wrong checksums for protocol " << +protocols[i]);
+      NS_TEST_EXPECT_MSG_EQ (ChecksumOffload::Complete (computed), computed,
+                             "Packet without deferred checksums changed");
+
+      // A fragment of the packet no longer matches the tag
+      Ptr<Packet> fragment = deferred->CreateFragment (0, deferred->GetSize () - 100);
+      NS_TEST_EXPECT_MSG_EQ (ChecksumOffload::Complete (fragment), fragment,
+                             "Checksums filled in a fragment");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief IPv4 checksum offload TestSuite
+ */
+class Ipv4ChecksumOffloadTestSuite : public TestSuite
+{
+public:
+  Ipv4ChecksumOffloadTestSuite ()
+    : TestSuite ("ipv4-checksum-offload", UNIT)
+  {
+    AddTestCase (new Ipv4ChecksumOffloadTestCase, TestCase::QUICK);
+  }
+};
+
+static Ipv4ChecksumOffloadTestSuite g_ipv4ChecksumOffloadTestSuite;
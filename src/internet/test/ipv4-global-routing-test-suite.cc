@@ -36,6 +36,9 @@
 #include "ns3/simple-channel.h"
 #include "ns3/socket-factory.h"
 #include "ns3/udp-socket-factory.h"
+#include "ns3/global-router-interface.h"
+#include "ns3/ipv4-global-routing.h"
+#include <sstream>
 
 using namespace ns3;
 
@@ -420,6 +423,136 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun (void)
 }
 
 
+/**
+ * \brief Check the routes given by RecomputeRoutingTables () when a link
+ * goes down and up again.
+ */
+class Ipv4GlobalRoutingRecomputeTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingRecomputeTestCase ();
+
+private:
+  /**
+   * \param nodes the nodes
+   * \returns the routing table of each node, printed
+   */
+  static std::vector<std::string> GetRoutes (NodeContainer nodes);
+  /**
+   * \brief Link two nodes with point to point simple net devices
+   * \param a first node
+   * \param b second node
+   * \param address the address helper
+   * \returns the devices
+   */
+  static NetDeviceContainer Link (Ptr<Node> a, Ptr<Node> b, Ipv4AddressHelper &address);
+  virtual void DoRun (void);
+};
+
+Ipv4GlobalRoutingRecomputeTestCase::Ipv4GlobalRoutingRecomputeTestCase ()
+  : TestCase ("Recomputation of the global routes after a link change")
+{
+}
+
+std::vector<std::string>
+Ipv4GlobalRoutingRecomputeTestCase::GetRoutes (NodeContainer nodes)
+{
+  std::vector<std::string> routes;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Ipv4GlobalRouting> gr = nodes.Get (i)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+      std::ostringstream os;
+      for (uint32_t j = 0; j < gr->GetNRoutes (); j++)
+        {
+          os << *gr->GetRoute (j) << std::endl;
+        }
+      routes.push_back (os.str ());
+    }
+  return routes;
+}
+
+NetDeviceContainer
+Ipv4GlobalRoutingRecomputeTestCase::Link (Ptr<Node> a, Ptr<Node> b, Ipv4AddressHelper &address)
+{
+  SimpleNetDeviceHelper simple;
+  simple.SetNetDevicePointToPointMode (true);
+  NetDeviceContainer devices = simple.Install (NodeContainer (a, b));
+  address.Assign (devices);
+  address.NewNetwork ();
+  return devices;
+}
+
+// Two areas: a ring of 6 routers, two of which share a broadcast network
+// with a third router, and a ring of 5 routers.  A link of the first ring
+// goes down, then up.
+void
+Ipv4GlobalRoutingRecomputeTestCase::DoRun (void)
+{
+  NodeContainer first;
+  first.Create (7);
+  NodeContainer second;
+  second.Create (5);
+  NodeContainer all (first, second);
+  InternetStackHelper internet;
+  internet.Install (all);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.0.0", "255.255.255.0");
+  NetDeviceContainer changing;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      NetDeviceContainer devices = Link (first.Get (i), first.Get ((i + 1) % 6), address);
+      if (i == 2)
+        {
+          changing = devices;
+        }
+    }
+  SimpleNetDeviceHelper simple;
+  address.Assign (simple.Install (NodeContainer (first.Get (0), first.Get (3), first.Get (6))));
+  address.SetBase ("10.2.0.0", "255.255.255.0");
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      Link (second.Get (i), second.Get ((i + 1) % 5), address);
+    }
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  std::vector<std::string> before = GetRoutes (all);
+
+  Ptr<Ipv4> ipv4 = changing.Get (0)->GetNode ()->GetObject<Ipv4> ();
+  uint32_t interface = ipv4->GetInterfaceForDevice (changing.Get (0));
+  for (uint32_t step = 0; step < 2; step++)
+    {
+      if (step == 0)
+        {
+          ipv4->SetDown (interface);
+        }
+      else
+        {
+          ipv4->SetUp (interface);
+        }
+      Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+      std::vector<std::string> routes = GetRoutes (all);
+
+      for (uint32_t i = 0; i < all.GetN (); i++)
+        {
+          if (i >= first.GetN ())
+            {
+              NS_TEST_ASSERT_MSG_EQ (routes[i], before[i], "Routes of the second area changed on node " << i);
+            }
+          else if (step == 1)
+            {
+              NS_TEST_ASSERT_MSG_EQ (routes[i], before[i], "Routes not restored on node " << i);
+            }
+        }
+      if (step == 0)
+        {
+          NS_TEST_ASSERT_MSG_NE (routes[0], before[0], "Routes of the first area did not change");
+        }
+    }
+
+  Simulator::Destroy ();
+}
+
 class Ipv4GlobalRoutingTestSuite : public TestSuite
 {
 public:
@@ -431,6 +564,7 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite ()
 {
   AddTestCase (new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
   AddTestCase (new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+  AddTestCase (new Ipv4GlobalRoutingRecomputeTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -0,0 +1,267 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+#include <algorithm>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/ipv4-routing-trie.h"
+
+using namespace ns3;
+
+/**
+ * Check the prefixes found by the trie against a linear scan of the
+ * routes, while routes are added and removed.
+ */
+class Ipv4RoutingTrieTestCase : public TestCase
+{
+public:
+  Ipv4RoutingTrieTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \returns a pseudo random number
+   */
+  uint32_t Next (void);
+  /**
+   * Check the lookups of some addresses.
+   * \param trie the trie
+   * \param routes the routes in the trie
+   */
+  void CheckLookups (const Ipv4RoutingTrie &trie, const std::vector<Ipv4RoutingTableEntry *> &routes);
+
+  uint32_t m_state; //!< The state of the pseudo random numbers
+};
+
+Ipv4RoutingTrieTestCase::Ipv4RoutingTrieTestCase ()
+  : TestCase ("Check the longest prefix matches of the routing trie"),
+    m_state (1)
+{
+}
+
+uint32_t
+Ipv4RoutingTrieTestCase::Next (void)
+{
+  m_state = m_state * 1103515245 + 12345;
+  return m_state ^ (m_state >> 16);
+}
+
+void
+Ipv4RoutingTrieTestCase::CheckLookups (const Ipv4RoutingTrie &trie, const std::vector<Ipv4RoutingTableEntry *> &routes)
+{
+  NS_TEST_ASSERT_MSG_EQ (trie.GetN (), routes.size (), "Wrong number of routes");
+  for (uint32_t k = 0; k < 200; k++)
+    {
+      // an address close to a route
+      Ipv4Address dest (routes[Next () % routes.size ()]->GetDestNetwork ().Get () ^ (Next () & 0xff));
+      std::vector<Ipv4RoutingTableEntry *> expected;
+      for (int length = 32; length >= 0; length--)
+        {
+          for (uint32_t i = 0; i < routes.size (); i++)
+            {
+              if (routes[i]->GetDestNetworkMask ().GetPrefixLength () == length
+                  && routes[i]->GetDestNetworkMask ().IsMatch (dest, routes[i]->GetDestNetwork ()))
+                {
+                  expected.push_back (routes[i]);
+                }
+            }
+        }
+      const Ipv4RoutingTrie::Routes *matches[Ipv4RoutingTrie::MAX_MATCHES];
+      uint8_t lengths[Ipv4RoutingTrie::MAX_MATCHES];
+      uint32_t n = trie.Lookup (dest, matches, lengths);
+      std::vector<Ipv4RoutingTableEntry *> found;
+      for (uint32_t m = 0; m < n; m++)
+        {
+          NS_TEST_EXPECT_MSG_EQ ((m == 0 || lengths[m] < lengths[m - 1]), true, "Prefixes not sorted");
+          for (uint32_t i = 0; i < matches[m]->size (); i++)
+            {
+              NS_TEST_EXPECT_MSG_EQ ((*matches[m])[i].entry->GetDestNetworkMask ().GetPrefixLength (), static_cast<uint16_t> (lengths[m]), "Wrong prefix length");
+              NS_TEST_EXPECT_MSG_EQ ((i == 0 || (*matches[m])[i].sequence > (*matches[m])[i - 1].sequence), true, "Routes not in order");
+              found.push_back ((*matches[m])[i].entry);
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (found.size (), expected.size (), "Wrong number of routes for " << dest);
+      for (uint32_t i = 0; i < found.size (); i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (found[i], expected[i], "Wrong route " << i << " for " << dest);
+        }
+    }
+}
+
+void
+Ipv4RoutingTrieTestCase::DoRun (void)
+{
+  Ipv4RoutingTrie trie;
+  std::vector<Ipv4RoutingTableEntry *> routes;
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      // few prefixes of 8 bits, to have many nested prefixes
+      uint32_t length = Next () % 33;
+      uint32_t network = ((Next () % 4) << 24) | (Next () & 0x00ffffff);
+      Ipv4Mask mask (length == 0 ? 0 : 0xffffffff << (32 - length));
+      Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
+      *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (Ipv4Address (network).CombineMask (mask), mask, i % 4);
+      routes.push_back (route);
+      trie.Add (route, i);
+    }
+  CheckLookups (trie, routes);
+
+  // remove half of the routes
+  std::vector<Ipv4RoutingTableEntry *> kept;
+  for (uint32_t i = 0; i < routes.size (); i++)
+    {
+      if (Next () % 2 == 0)
+        {
+          NS_TEST_EXPECT_MSG_EQ (trie.Remove (routes[i]), true, "Route not found");
+          NS_TEST_EXPECT_MSG_EQ (trie.Remove (routes[i]), false, "Route removed twice");
+          delete routes[i];
+        }
+      else
+        {
+          kept.push_back (routes[i]);
+        }
+    }
+  CheckLookups (trie, kept);
+
+  trie.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (trie.GetN (), 0, "Routes left");
+  const Ipv4RoutingTrie::Routes *matches[Ipv4RoutingTrie::MAX_MATCHES];
+  uint8_t lengths[Ipv4RoutingTrie::MAX_MATCHES];
+  NS_TEST_EXPECT_MSG_EQ (trie.Lookup (Ipv4Address ("1.2.3.4"), matches, lengths), 0, "Prefix found in an empty trie");
+  for (uint32_t i = 0; i < kept.size (); i++)
+    {
+      delete kept[i];
+    }
+}
+
+/**
+ * Check the routes chosen by Ipv4StaticRouting and Ipv4GlobalRouting
+ * among overlapping prefixes, metrics and equal cost routes.
+ */
+class Ipv4RoutingTrieLookupTestCase : public TestCase
+{
+public:
+  Ipv4RoutingTrieLookupTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param routing the routing protocol
+   * \param dest the destination
+   * \returns the gateway of the route to the destination, or 0.0.0.0
+   */
+  Ipv4Address GetGateway (Ptr<Ipv4RoutingProtocol> routing, Ipv4Address dest);
+};
+
+Ipv4RoutingTrieLookupTestCase::Ipv4RoutingTrieLookupTestCase ()
+  : TestCase ("Check the routes chosen by the static and global routing")
+{
+}
+
+Ipv4Address
+Ipv4RoutingTrieLookupTestCase::GetGateway (Ptr<Ipv4RoutingProtocol> routing, Ipv4Address dest)
+{
+  Ipv4Header header;
+  header.SetDestination (dest);
+  Socket::SocketErrno error;
+  Ptr<Ipv4Route> route = routing->RouteOutput (Create<Packet> (), header, 0, error);
+  return route == 0 ? Ipv4Address::GetZero () : route->GetGateway ();
+}
+
+void
+Ipv4RoutingTrieLookupTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  SimpleNetDeviceHelper simple;
+  NetDeviceContainer devices = simple.Install (nodes);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("192.168.0.0", "255.255.255.0");
+  address.Assign (devices);
+  Ptr<Ipv4> ipv4 = nodes.Get (0)->GetObject<Ipv4> ();
+
+  Ipv4StaticRoutingHelper helper;
+  Ptr<Ipv4StaticRouting> staticRouting = helper.GetStaticRouting (ipv4);
+  staticRouting->AddNetworkRouteTo ("10.0.0.0", "255.0.0.0", "192.168.0.8", 1);
+  staticRouting->AddNetworkRouteTo ("10.1.0.0", "255.255.0.0", "192.168.0.16", 1, 5);
+  staticRouting->AddNetworkRouteTo ("10.1.0.0", "255.255.0.0", "192.168.0.17", 1, 2);
+  staticRouting->AddNetworkRouteTo ("10.1.0.0", "255.255.0.0", "192.168.0.18", 1, 2);
+  staticRouting->AddHostRouteTo ("10.1.2.3", "192.168.0.32", 1);
+  staticRouting->AddHostRouteTo ("10.1.2.3", "192.168.0.33", 1);
+  staticRouting->SetDefaultRoute ("192.168.0.1", 1);
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (staticRouting, "10.1.2.3"), Ipv4Address ("192.168.0.32"), "First host route expected");
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (staticRouting, "10.1.2.4"), Ipv4Address ("192.168.0.18"), "Last route with the smallest metric expected");
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (staticRouting, "10.2.0.1"), Ipv4Address ("192.168.0.8"), "Route to 10.0.0.0/8 expected");
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (staticRouting, "11.0.0.1"), Ipv4Address ("192.168.0.1"), "Default route expected");
+  // the routes added by the interfaces come first
+  uint32_t first = staticRouting->GetNRoutes () - 7;
+  staticRouting->RemoveRoute (first + 4);
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (staticRouting, "10.1.2.3"), Ipv4Address ("192.168.0.33"), "Second host route expected");
+  staticRouting->RemoveRoute (first + 4);
+  staticRouting->RemoveRoute (first + 3);
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (staticRouting, "10.1.2.3"), Ipv4Address ("192.168.0.17"), "Remaining route with the smallest metric expected");
+
+  Ptr<Ipv4GlobalRouting> globalRouting = CreateObject<Ipv4GlobalRouting> ();
+  globalRouting->SetIpv4 (ipv4);
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (globalRouting, "10.1.2.3"), Ipv4Address::GetZero (), "No route expected");
+  globalRouting->AddASExternalRouteTo ("10.0.0.0", "255.0.0.0", "192.168.0.64", 1);
+  globalRouting->AddASExternalRouteTo ("10.1.0.0", "255.255.0.0", "192.168.0.65", 1);
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (globalRouting, "10.1.2.3"), Ipv4Address ("192.168.0.64"), "First external route expected");
+  // all the network routes are equal cost routes, in their order
+  globalRouting->AddNetworkRouteTo ("10.1.0.0", "255.255.0.0", "192.168.0.8", 1);
+  globalRouting->AddNetworkRouteTo ("10.0.0.0", "255.0.0.0", "192.168.0.16", 1);
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (globalRouting, "10.1.2.3"), Ipv4Address ("192.168.0.8"), "First network route expected");
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (globalRouting, "10.2.2.3"), Ipv4Address ("192.168.0.16"), "Route to 10.0.0.0/8 expected");
+  globalRouting->AddHostRouteTo ("10.1.2.3", "192.168.0.32", 1);
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (globalRouting, "10.1.2.3"), Ipv4Address ("192.168.0.32"), "Host route expected");
+  // the host route, then the first network route
+  globalRouting->RemoveRoute (0);
+  globalRouting->RemoveRoute (0);
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (globalRouting, "10.1.2.3"), Ipv4Address ("192.168.0.16"), "Second network route expected");
+  globalRouting->RemoveRoute (0);
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (globalRouting, "10.1.2.3"), Ipv4Address ("192.168.0.64"), "First external route expected");
+  globalRouting->RemoveRoute (0);
+  NS_TEST_EXPECT_MSG_EQ (GetGateway (globalRouting, "10.1.2.3"), Ipv4Address ("192.168.0.65"), "Second external route expected");
+  globalRouting->Dispose ();
+
+  Simulator::Destroy ();
+}
+
+class Ipv4RoutingTrieTestSuite : public TestSuite
+{
+public:
+  Ipv4RoutingTrieTestSuite ()
+    : TestSuite ("ipv4-routing-trie", UNIT)
+  {
+    AddTestCase (new Ipv4RoutingTrieTestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4RoutingTrieLookupTestCase, TestCase::QUICK);
+  }
+};
+
+static Ipv4RoutingTrieTestSuite g_ipv4RoutingTrieTestSuite;
@@ -0,0 +1,241 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <limits>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+#include "ns3/socket.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/mac48-address.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/ipv6-header.h"
+#include "ns3/icmpv6-header.h"
+#include "ns3/arp-l3-protocol.h"
+#include "ns3/icmpv6-l4-protocol.h"
+#include "ns3/static-neighbor-table.h"
+
+using namespace ns3;
+
+/**
+ * Check the lookups of the addresses added to a table.
+ */
+class StaticNeighborTableLookupTestCase : public TestCase
+{
+public:
+  StaticNeighborTableLookupTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+StaticNeighborTableLookupTestCase::StaticNeighborTableLookupTestCase ()
+  : TestCase ("Lookup of the addresses in a static neighbor table")
+{
+}
+
+void
+StaticNeighborTableLookupTestCase::DoRun (void)
+{
+  Ptr<StaticNeighborTable> table = CreateObject<StaticNeighborTable> ();
+  Mac48Address mac1 ("00:00:00:00:00:01");
+  Mac48Address mac2 ("00:00:00:00:00:02");
+
+  table->Add (Ipv4Address ("10.0.0.1"), mac1);
+  table->Add (Ipv6Address ("2001:1::1"), mac1);
+  table->Add (Ipv4Address ("10.0.0.2"), mac2);
+  table->Add (Ipv4Address ("10.0.1.2"), mac2);
+  table->Add (Ipv4Address ("10.0.0.1"), mac2);
+  NS_TEST_EXPECT_MSG_EQ (table->GetNIpv4Addresses (), 3, "Duplicate IPv4 address added");
+  NS_TEST_EXPECT_MSG_EQ (table->GetNIpv6Addresses (), 1, "Wrong number of IPv6 addresses");
+
+  Address address;
+  NS_TEST_EXPECT_MSG_EQ (table->Lookup (Ipv4Address ("10.0.0.1"), &address), true, "10.0.0.1 not found");
+  NS_TEST_EXPECT_MSG_EQ (Mac48Address::ConvertFrom (address), mac1, "The first address added must be kept");
+  NS_TEST_EXPECT_MSG_EQ (table->Lookup (Ipv4Address ("10.0.1.2"), &address), true, "10.0.1.2 not found");
+  NS_TEST_EXPECT_MSG_EQ (Mac48Address::ConvertFrom (address), mac2, "Wrong hardware address");
+  NS_TEST_EXPECT_MSG_EQ (table->Lookup (Ipv6Address ("2001:1::1"), &address), true, "2001:1::1 not found");
+  NS_TEST_EXPECT_MSG_EQ (Mac48Address::ConvertFrom (address), mac1, "Wrong hardware address");
+  NS_TEST_EXPECT_MSG_EQ (table->Lookup (Ipv4Address ("10.0.0.3"), &address), false, "Unknown IPv4 address found");
+  NS_TEST_EXPECT_MSG_EQ (table->Lookup (Ipv6Address ("2001:1::2"), &address), false, "Unknown IPv6 address found");
+}
+
+/**
+ * Check that the nodes sharing a static neighbor table exchange IPv4 and
+ * IPv6 packets without any ARP or NDisc message.
+ */
+class StaticNeighborTableResolutionTestCase : public TestCase
+{
+public:
+  StaticNeighborTableResolutionTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Count the ARP and NDisc messages received by a device.
+   * \param device the device
+   * \param packet the packet
+   * \param protocol the protocol
+   * \param from the source address
+   * \param to the destination address
+   * \param packetType the type of packet
+   */
+  void ReceiveFrame (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                     const Address &from, const Address &to, NetDevice::PacketType packetType);
+  /**
+   * Count the packets received by a socket.
+   * \param socket the socket
+   */
+  void ReceivePacket (Ptr<Socket> socket);
+  /**
+   * Send a packet.
+   * \param socket the socket
+   * \param to the destination
+   */
+  void SendPacket (Ptr<Socket> socket, Address to);
+
+  uint32_t m_resolutions; //!< The number of ARP and NDisc messages received
+  uint32_t m_received;    //!< The number of packets received by the sockets
+};
+
+StaticNeighborTableResolutionTestCase::StaticNeighborTableResolutionTestCase ()
+  : TestCase ("Address resolution by a static neighbor table"),
+    m_resolutions (0),
+    m_received (0)
+{
+}
+
+void
+StaticNeighborTableResolutionTestCase::ReceiveFrame (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol,
+                                                     const Address &from, const Address &to, NetDevice::PacketType packetType)
+{
+  if (protocol == ArpL3Protocol::PROT_NUMBER)
+    {
+      m_resolutions++;
+    }
+  else if (protocol == 0x86DD)
+    {
+      Ptr<Packet> copy = packet->Copy ();
+      Ipv6Header ipHeader;
+      copy->RemoveHeader (ipHeader);
+      Icmpv6Header icmpHeader;
+      if (ipHeader.GetNextHeader () == Icmpv6L4Protocol::PROT_NUMBER
+          && copy->PeekHeader (icmpHeader)
+          && (icmpHeader.GetType () == Icmpv6Header::ICMPV6_ND_NEIGHBOR_SOLICITATION
+              || icmpHeader.GetType () == Icmpv6Header::ICMPV6_ND_NEIGHBOR_ADVERTISEMENT))
+        {
+          m_resolutions++;
+        }
+    }
+}
+
+void
+StaticNeighborTableResolutionTestCase::ReceivePacket (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv (std::numeric_limits<uint32_t>::max (), 0)))
+    {
+      m_received++;
+    }
+}
+
+void
+StaticNeighborTableResolutionTestCase::SendPacket (Ptr<Socket> socket, Address to)
+{
+  NS_TEST_EXPECT_MSG_EQ (socket->SendTo (Create<Packet> (100), 0, to), 100, "The packet was not sent");
+}
+
+void
+StaticNeighborTableResolutionTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+  SimpleNetDeviceHelper simple;
+  NetDeviceContainer devices = simple.Install (nodes);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  ipv4.Assign (devices);
+  Ipv6AddressHelper ipv6;
+  ipv6.SetBase (Ipv6Address ("2001:1::"), Ipv6Prefix (64));
+  ipv6.Assign (devices);
+
+  Ptr<StaticNeighborTable> table = InternetStackHelper::PopulateStaticNeighborTables (nodes);
+  // One global address and one link-local address per device
+  NS_TEST_EXPECT_MSG_EQ (table->GetNIpv4Addresses (), 2, "Wrong number of IPv4 addresses");
+  NS_TEST_EXPECT_MSG_EQ (table->GetNIpv6Addresses (), 4, "Wrong number of IPv6 addresses");
+  NS_TEST_EXPECT_MSG_EQ (nodes.Get (0)->GetObject<ArpL3Protocol> ()->GetStaticNeighborTable (), table,
+                         "The table is not shared by ARP");
+  NS_TEST_EXPECT_MSG_EQ (nodes.Get (1)->GetObject<Icmpv6L4Protocol> ()->GetStaticNeighborTable (), table,
+                         "The table is not shared by ICMPv6");
+
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      nodes.Get (i)->RegisterProtocolHandler (MakeCallback (&StaticNeighborTableResolutionTestCase::ReceiveFrame, this),
+                                              0, devices.Get (i));
+    }
+
+  Ptr<Socket> rx4 = Socket::CreateSocket (nodes.Get (1), UdpSocketFactory::GetTypeId ());
+  rx4->Bind (InetSocketAddress (Ipv4Address::GetAny (), 1234));
+  rx4->SetRecvCallback (MakeCallback (&StaticNeighborTableResolutionTestCase::ReceivePacket, this));
+  Ptr<Socket> rx6 = Socket::CreateSocket (nodes.Get (1), UdpSocketFactory::GetTypeId ());
+  rx6->Bind (Inet6SocketAddress (Ipv6Address::GetAny (), 1234));
+  rx6->SetRecvCallback (MakeCallback (&StaticNeighborTableResolutionTestCase::ReceivePacket, this));
+
+  Ptr<Socket> tx4 = Socket::CreateSocket (nodes.Get (0), UdpSocketFactory::GetTypeId ());
+  tx4->Bind ();
+  Ptr<Socket> tx6 = Socket::CreateSocket (nodes.Get (0), UdpSocketFactory::GetTypeId ());
+  tx6->Bind6 ();
+  // After the DAD of the IPv6 addresses, if any
+  Simulator::ScheduleWithContext (nodes.Get (0)->GetId (), Seconds (2), &StaticNeighborTableResolutionTestCase::SendPacket, this,
+                                  tx4, InetSocketAddress (Ipv4Address ("10.1.1.2"), 1234));
+  Simulator::ScheduleWithContext (nodes.Get (0)->GetId (), Seconds (2), &StaticNeighborTableResolutionTestCase::SendPacket, this,
+                                  tx6, Inet6SocketAddress (Ipv6Address ("2001:1::200:ff:fe00:2"), 1234));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received, 2, "The packets were not received");
+  NS_TEST_EXPECT_MSG_EQ (m_resolutions, 0, "ARP or NDisc messages exchanged");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Static neighbor table TestSuite
+ */
+class StaticNeighborTableTestSuite : public TestSuite
+{
+public:
+  StaticNeighborTableTestSuite ()
+    : TestSuite ("static-neighbor-table", UNIT)
+  {
+    AddTestCase (new StaticNeighborTableLookupTestCase, TestCase::QUICK);
+    AddTestCase (new StaticNeighborTableResolutionTestCase, TestCase::QUICK);
+  }
+};
+
+static StaticNeighborTableTestSuite g_staticNeighborTableTestSuite;
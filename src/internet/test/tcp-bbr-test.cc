@@ -0,0 +1,283 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/tcp-bbr.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpBbrTestSuite");
+
+/**
+ * \brief Testing TcpBbr over a bottleneck link
+ *
+ * The sender paces the segments at the rate set by TcpBbr, within cWnd.
+ * The segments queue at a bottleneck of fixed rate, and are ACKed one
+ * base RTT after their departure from the bottleneck. The estimates must
+ * converge to the bottleneck rate and to the base RTT, and the queueing
+ * delay must stay low once in PROBE_BW.
+ *
+ * When the minimum RTT is not refreshed for 10 s, BBR must enter
+ * PROBE_RTT, drop cWnd to four segments, and measure the base RTT again,
+ * which may have grown in the meantime.
+ */
+class TcpBbrPathTest : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param duration duration of the transfer
+   * \param rttChange time of the increase of the base RTT, zero if none
+   * \param name the test description
+   */
+  TcpBbrPathTest (const Time &duration, const Time &rttChange, const std::string &name);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Send a segment if cWnd allows it, and schedule the next one
+   */
+  void Send (void);
+
+  /**
+   * \brief Receive the ACK of a segment
+   * \param seq end of the segment
+   * \param sent time of the transmission of the segment
+   */
+  void Ack (SequenceNumber32 seq, Time sent);
+
+  /**
+   * \brief Increase the base RTT
+   */
+  void ChangeRtt (void);
+
+  /**
+   * \brief Trace the state of BBR
+   * \param oldValue previous state
+   * \param newValue new state
+   */
+  void ModeTrace (TcpBbr::BbrMode_t oldValue, TcpBbr::BbrMode_t newValue);
+
+  Time m_duration;                  //!< Duration of the transfer
+  Time m_rttChange;                 //!< Time of the increase of the base RTT
+  Time m_baseRtt;                   //!< Base RTT
+  double m_rate;                    //!< Bottleneck rate, in bytes per second
+  Time m_linkFree;                  //!< Departure of the last segment from the bottleneck
+  Time m_queueDelay;                //!< Sum of the queueing delays of the last second
+  uint32_t m_samples;               //!< Number of queueing delays of the last second
+  bool m_probeRtt;                  //!< PROBE_RTT was entered
+  uint32_t m_probeRttCwnd;          //!< Highest cWnd in PROBE_RTT, once drained
+  Ptr<TcpSocketState> m_state;      //!< Congestion state
+  Ptr<TcpBbr> m_cong;               //!< Congestion control
+};
+
+TcpBbrPathTest::TcpBbrPathTest (const Time &duration, const Time &rttChange,
+                                const std::string &name)
+  : TestCase (name),
+  m_duration (duration),
+  m_rttChange (rttChange),
+  m_baseRtt (MilliSeconds (20)),
+  m_rate (10e6 / 8),
+  m_linkFree (Time (0)),
+  m_queueDelay (Time (0)),
+  m_samples (0),
+  m_probeRtt (false),
+  m_probeRttCwnd (0)
+{
+}
+
+void
+TcpBbrPathTest::Send (void)
+{
+  Time now = Simulator::Now ();
+  if (now >= m_duration)
+    {
+      return;
+    }
+
+  uint32_t inFlight = m_state->m_highTxMark - m_state->m_lastAckedSeq;
+  if (inFlight + m_state->m_segmentSize <= m_state->m_cWnd)
+    {
+      Time txTime = Seconds (m_state->m_segmentSize / m_rate);
+      m_linkFree = Max (now, m_linkFree) + txTime;
+      m_state->m_highTxMark += m_state->m_segmentSize;
+      Simulator::Schedule (m_linkFree + m_baseRtt - now, &TcpBbrPathTest::Ack, this,
+                           m_state->m_highTxMark, now);
+    }
+
+  Time next = MicroSeconds (10);
+  if (m_state->m_pacingRate.GetBitRate () > 0)
+    {
+      next = m_state->m_pacingRate.CalculateBytesTxTime (m_state->m_segmentSize);
+    }
+  Simulator::Schedule (next, &TcpBbrPathTest::Send, this);
+}
+
+void
+TcpBbrPathTest::Ack (SequenceNumber32 seq, Time sent)
+{
+  Time now = Simulator::Now ();
+  m_state->m_lastAckedSeq = seq;
+  m_state->m_rttSample = now - sent;
+
+  if (now > m_duration - Seconds (1))
+    {
+      m_queueDelay += m_state->m_rttSample - m_baseRtt - Seconds (m_state->m_segmentSize / m_rate);
+      ++m_samples;
+    }
+
+  m_cong->PktsAcked (m_state, 1, m_state->m_rttSample);
+  m_cong->IncreaseWindow (m_state, 1);
+
+  if (m_cong->GetMode () == TcpBbr::BBR_PROBE_RTT
+      && m_state->m_highTxMark - m_state->m_lastAckedSeq
+             <= static_cast<int32_t> (4 * m_state->m_segmentSize))
+    {
+      m_probeRttCwnd = std::max (m_probeRttCwnd, m_state->m_cWnd.Get ());
+    }
+}
+
+void
+TcpBbrPathTest::ChangeRtt (void)
+{
+  m_baseRtt = MilliSeconds (25);
+}
+
+void
+TcpBbrPathTest::ModeTrace (TcpBbr::BbrMode_t oldValue, TcpBbr::BbrMode_t newValue)
+{
+  if (newValue == TcpBbr::BBR_PROBE_RTT)
+    {
+      NS_TEST_ASSERT_MSG_GT (Simulator::Now (), Seconds (10),
+                             "PROBE_RTT entered with a fresh minimum RTT");
+      m_probeRtt = true;
+    }
+}
+
+void
+TcpBbrPathTest::DoRun ()
+{
+  m_state = CreateObject<TcpSocketState> ();
+  m_state->m_segmentSize = 1000;
+  m_state->m_initialCWnd = 10;
+  m_state->m_cWnd = 10 * 1000;
+  m_state->m_ssThresh = 0xFFFFFFFF;
+  m_state->m_lastAckedSeq = SequenceNumber32 (1);
+  m_state->m_highTxMark = SequenceNumber32 (1);
+
+  m_cong = CreateObject <TcpBbr> ();
+  m_cong->TraceConnectWithoutContext ("Mode", MakeCallback (&TcpBbrPathTest::ModeTrace, this));
+
+  if (!m_rttChange.IsZero ())
+    {
+      Simulator::Schedule (m_rttChange, &TcpBbrPathTest::ChangeRtt, this);
+    }
+  Simulator::ScheduleNow (&TcpBbrPathTest::Send, this);
+  Simulator::Run ();
+
+  double bdp = m_rate * m_baseRtt.GetSeconds ();
+  NS_TEST_ASSERT_MSG_EQ (m_cong->GetMode (), TcpBbr::BBR_PROBE_BW, "Not in PROBE_BW");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_cong->GetBtlBw (), m_rate, m_rate * 0.05,
+                             "Wrong bottleneck bandwidth estimate");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_cong->GetRtProp (), m_baseRtt, MilliSeconds (1),
+                             "Wrong round-trip propagation time estimate");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_state->m_cWnd.Get (), 2.1 * bdp + 3 * 1000,
+                               "cWnd beyond twice the bandwidth-delay product");
+  NS_TEST_ASSERT_MSG_GT (m_samples, 0, "No ACK in the last second");
+  NS_TEST_ASSERT_MSG_LT (m_queueDelay / m_samples, m_baseRtt / 2,
+                         "Queueing delay too high");
+
+  NS_TEST_ASSERT_MSG_EQ (m_probeRtt, (m_duration > Seconds (10)), "Wrong PROBE_RTT");
+  if (m_probeRtt)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_probeRttCwnd, 4 * 1000, "cWnd not reduced in PROBE_RTT");
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Testing the window of TcpBbr during and after a loss recovery
+ *
+ * cWnd is held at the bytes in flight during the recovery, and restored
+ * to its previous value when back in Open.
+ */
+class TcpBbrRecoveryTest : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param name the test description
+   */
+  TcpBbrRecoveryTest (const std::string &name);
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpBbrRecoveryTest::TcpBbrRecoveryTest (const std::string &name)
+  : TestCase (name)
+{
+}
+
+void
+TcpBbrRecoveryTest::DoRun ()
+{
+  Ptr<TcpSocketState> state = CreateObject<TcpSocketState> ();
+  state->m_segmentSize = 1000;
+  state->m_initialCWnd = 10;
+  state->m_cWnd = 100 * 1000;
+
+  Ptr<TcpBbr> cong = CreateObject <TcpBbr> ();
+
+  uint32_t ssThresh = cong->GetSsThresh (state, 50 * 1000);
+  NS_TEST_ASSERT_MSG_EQ (ssThresh, 50 * 1000, "cWnd not held at the bytes in flight");
+  ssThresh = cong->GetSsThresh (state, 1000);
+  NS_TEST_ASSERT_MSG_EQ (ssThresh, 4 * 1000, "cWnd below four segments");
+
+  state->m_cWnd = ssThresh;
+  state->m_congState = TcpSocketState::CA_RECOVERY;
+  cong->IncreaseWindow (state, 1);
+  NS_TEST_ASSERT_MSG_LT (state->m_cWnd.Get (), 100 * 1000, "cWnd restored during the recovery");
+
+  state->m_congState = TcpSocketState::CA_OPEN;
+  cong->IncreaseWindow (state, 1);
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (state->m_cWnd.Get (), 100 * 1000, "cWnd not restored after the recovery");
+}
+
+// -------------------------------------------------------------------
+
+static class TcpBbrTestSuite : public TestSuite
+{
+public:
+  TcpBbrTestSuite () : TestSuite ("tcp-bbr-test", UNIT)
+  {
+    AddTestCase (new TcpBbrPathTest (Seconds (5), Time (0), "Bottleneck estimates"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpBbrPathTest (Seconds (13), Seconds (1), "PROBE_RTT after a base RTT change"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpBbrRecoveryTest ("cWnd during the loss recovery"),
+                 TestCase::QUICK);
+  }
+} g_tcpBbrTest;
+
+} // namespace ns3
@@ -0,0 +1,352 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/tcp-cubic.h"
+
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpCubicTestSuite");
+
+/**
+ * \brief Testing the window reduction of TcpCubic
+ *
+ * The slow start threshold is beta times cWnd. With fast convergence, the
+ * cubic function of the second epoch plateaus below the window of the
+ * second loss, since it came before the window of the first loss.
+ */
+class TcpCubicReductionTest : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param fastConvergence enable the fast convergence
+   * \param name the test description
+   */
+  TcpCubicReductionTest (bool fastConvergence, const std::string &name);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Grow cWnd for one RTT, with one ACK per segment
+   */
+  void RunRound (void);
+
+  bool m_fastConvergence;           //!< Enable the fast convergence
+  Ptr<TcpSocketState> m_state;      //!< Congestion state
+  Ptr<TcpCubic> m_cong;             //!< Congestion control
+};
+
+TcpCubicReductionTest::TcpCubicReductionTest (bool fastConvergence, const std::string &name)
+  : TestCase (name),
+  m_fastConvergence (fastConvergence)
+{
+}
+
+void
+TcpCubicReductionTest::RunRound (void)
+{
+  uint32_t segCwnd = m_state->GetCwndInSegments ();
+  for (uint32_t i = 0; i < segCwnd; ++i)
+    {
+      m_cong->PktsAcked (m_state, 1, m_state->m_rttSample);
+      m_cong->IncreaseWindow (m_state, 1);
+    }
+}
+
+void
+TcpCubicReductionTest::DoRun ()
+{
+  m_state = CreateObject<TcpSocketState> ();
+  m_state->m_segmentSize = 1000;
+  m_state->m_cWnd = 1000 * 1000;
+  m_state->m_ssThresh = 500 * 1000;
+  m_state->m_rttSample = MilliSeconds (100);
+
+  m_cong = CreateObject <TcpCubic> ();
+  m_cong->SetAttribute ("FastConvergence", BooleanValue (m_fastConvergence));
+
+  uint32_t ssThresh = m_cong->GetSsThresh (m_state, m_state->m_cWnd);
+  NS_TEST_ASSERT_MSG_EQ (ssThresh, 700 * 1000, "ssThresh is not beta times cWnd");
+
+  // Second loss, below the window of the first one
+  m_state->m_cWnd = 800 * 1000;
+  ssThresh = m_cong->GetSsThresh (m_state, m_state->m_cWnd);
+  NS_TEST_ASSERT_MSG_EQ (ssThresh, 560 * 1000, "ssThresh is not beta times cWnd");
+
+  // The window stops around Wmax, which is lower with fast convergence
+  uint32_t wMax = m_fastConvergence ? 680 : 800;
+  m_state->m_cWnd = ssThresh;
+  m_state->m_ssThresh = ssThresh;
+  Time k = Seconds (std::pow ((wMax - 560) / 0.4, 1.0 / 3.0));
+  for (Time t = Seconds (0); t < k; t += MilliSeconds (100))
+    {
+      Simulator::Schedule (t, &TcpCubicReductionTest::RunRound, this);
+    }
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_state->GetCwndInSegments (), wMax + 1,
+                               "cWnd went beyond the plateau");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (m_state->GetCwndInSegments (), wMax - 3,
+                               "cWnd did not reach the plateau");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Testing the cubic increment of TcpCubic in congestion avoidance
+ *
+ * After a loss at Wmax, cWnd gets back to Wmax after K seconds, whatever
+ * the RTT, and grows much faster than NewReno in the meantime.
+ */
+class TcpCubicIncrementTest : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param wMax window of the loss, in segments
+   * \param rtt the RTT
+   * \param name the test description
+   */
+  TcpCubicIncrementTest (uint32_t wMax, const Time &rtt, const std::string &name);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief ACK one segment, and schedule the next ACK
+   */
+  void Ack (void);
+
+  /**
+   * \brief Check cWnd against the cubic function
+   * \param low lowest cWnd, in segments
+   * \param high highest cWnd, in segments
+   */
+  void Check (double low, double high);
+
+  uint32_t m_wMax;                  //!< Window of the loss
+  Time m_rtt;                       //!< RTT
+  Ptr<TcpSocketState> m_state;      //!< Congestion state
+  Ptr<TcpCubic> m_cong;             //!< Congestion control
+  EventId m_ackEvent;               //!< Next ACK
+};
+
+TcpCubicIncrementTest::TcpCubicIncrementTest (uint32_t wMax, const Time &rtt,
+                                              const std::string &name)
+  : TestCase (name),
+  m_wMax (wMax),
+  m_rtt (rtt)
+{
+}
+
+void
+TcpCubicIncrementTest::Ack (void)
+{
+  m_cong->PktsAcked (m_state, 1, m_rtt);
+  m_cong->IncreaseWindow (m_state, 1);
+  // One window of ACKs per RTT
+  m_ackEvent = Simulator::Schedule (m_rtt / m_state->GetCwndInSegments (),
+                                    &TcpCubicIncrementTest::Ack, this);
+}
+
+void
+TcpCubicIncrementTest::Check (double low, double high)
+{
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (m_state->GetCwndInSegments (), low,
+                               "cWnd too low at " << Simulator::Now ().GetSeconds ());
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_state->GetCwndInSegments (), high,
+                               "cWnd too high at " << Simulator::Now ().GetSeconds ());
+}
+
+void
+TcpCubicIncrementTest::DoRun ()
+{
+  m_state = CreateObject<TcpSocketState> ();
+  m_state->m_segmentSize = 1000;
+  m_state->m_cWnd = m_wMax * 1000;
+  m_state->m_rttSample = m_rtt;
+
+  m_cong = CreateObject <TcpCubic> ();
+
+  m_state->m_ssThresh = m_cong->GetSsThresh (m_state, m_state->m_cWnd);
+  m_state->m_cWnd = m_state->m_ssThresh;
+
+  // W(t) = C (t - K)^3 + Wmax, with t counted from the loss plus one RTT
+  double k = std::pow (m_wMax * (1 - 0.7) / 0.4, 1.0 / 3.0);
+  double half = m_wMax + 0.4 * std::pow (k / 2 + m_rtt.GetSeconds () - k, 3);
+  double reno = 0.7 * m_wMax + 3 * 0.3 / 1.7 * (k / 2) / m_rtt.GetSeconds ();
+
+  m_ackEvent = Simulator::Schedule (m_rtt / m_state->GetCwndInSegments (),
+                                    &TcpCubicIncrementTest::Ack, this);
+  Simulator::Schedule (Seconds (k / 2), &TcpCubicIncrementTest::Check, this,
+                       std::max (half * 0.95, reno), half * 1.02);
+  Simulator::Schedule (Seconds (k), &TcpCubicIncrementTest::Check, this,
+                       m_wMax * 0.97, m_wMax * 1.02);
+  Simulator::Stop (Seconds (k) + TimeStep (1));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Testing the HyStart exit of the slow start of TcpCubic
+ *
+ * The ACKs of the segments of each round are spaced by a constant
+ * interval. The RTT samples of the first round are at the base RTT, and
+ * then grow by a constant increase. HyStart must set ssThresh to cWnd in the
+ * expected round, either because the ACK train spans half of the minimum RTT
+ * or because the RTT grew.
+ */
+class TcpCubicHystartTest : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param hystart enable HyStart
+   * \param ackSpacing interval between two ACKs
+   * \param rttIncrease increase of the RTT after the first round
+   * \param exitRound round of the exit of the slow start, -1 if none
+   * \param name the test description
+   */
+  TcpCubicHystartTest (bool hystart, const Time &ackSpacing, const Time &rttIncrease,
+                       int32_t exitRound, const std::string &name);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief ACK one segment, and schedule the next ACK
+   */
+  void Ack (void);
+
+  bool m_hystart;                   //!< Enable HyStart
+  Time m_ackSpacing;                //!< Interval between two ACKs
+  Time m_rttIncrease;               //!< Increase of the RTT after the first round
+  int32_t m_exitRound;              //!< Expected round of the exit
+  int32_t m_round;                  //!< Current round
+  int32_t m_foundRound;             //!< Round of the exit, -1 if none
+  SequenceNumber32 m_roundEnd;      //!< End of the current round
+  Ptr<TcpSocketState> m_state;      //!< Congestion state
+  Ptr<TcpCubic> m_cong;             //!< Congestion control
+
+  static const uint32_t MAX_ROUNDS; //!< Rounds of the test
+};
+
+const uint32_t TcpCubicHystartTest::MAX_ROUNDS = 5;
+
+TcpCubicHystartTest::TcpCubicHystartTest (bool hystart, const Time &ackSpacing,
+                                          const Time &rttIncrease, int32_t exitRound,
+                                          const std::string &name)
+  : TestCase (name),
+  m_hystart (hystart),
+  m_ackSpacing (ackSpacing),
+  m_rttIncrease (rttIncrease),
+  m_exitRound (exitRound),
+  m_round (-1),
+  m_foundRound (-1),
+  m_roundEnd (0)
+{
+}
+
+void
+TcpCubicHystartTest::Ack (void)
+{
+  m_state->m_lastAckedSeq += m_state->m_segmentSize;
+  if (m_state->m_lastAckedSeq >= m_roundEnd)
+    {
+      ++m_round;
+      m_roundEnd = m_state->m_highTxMark;
+    }
+  if (m_round >= static_cast<int32_t> (MAX_ROUNDS))
+    {
+      return;
+    }
+
+  m_state->m_rttSample = MilliSeconds (10) + (m_round == 0 ? Time (0) : m_rttIncrease);
+  m_cong->PktsAcked (m_state, 1, m_state->m_rttSample);
+  if (m_foundRound < 0 && m_state->m_ssThresh != 0xFFFFFFFF)
+    {
+      m_foundRound = m_round;
+      NS_TEST_ASSERT_MSG_EQ (m_state->m_ssThresh.Get (), m_state->m_cWnd.Get (),
+                             "ssThresh not set to cWnd at the exit of the slow start");
+    }
+  m_cong->IncreaseWindow (m_state, 1);
+  m_state->m_highTxMark = m_state->m_lastAckedSeq + m_state->m_cWnd.Get ();
+
+  Simulator::Schedule (m_ackSpacing, &TcpCubicHystartTest::Ack, this);
+}
+
+void
+TcpCubicHystartTest::DoRun ()
+{
+  m_state = CreateObject<TcpSocketState> ();
+  m_state->m_segmentSize = 1000;
+  m_state->m_cWnd = 16 * 1000;
+  m_state->m_ssThresh = 0xFFFFFFFF;
+  m_state->m_lastAckedSeq = SequenceNumber32 (1);
+  m_state->m_highTxMark = m_state->m_lastAckedSeq + m_state->m_cWnd.Get ();
+
+  m_cong = CreateObject <TcpCubic> ();
+  m_cong->SetAttribute ("HyStart", BooleanValue (m_hystart));
+
+  Simulator::Schedule (m_ackSpacing, &TcpCubicHystartTest::Ack, this);
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_foundRound, m_exitRound, "Slow start ended in a different round");
+
+  Simulator::Destroy ();
+}
+
+// -------------------------------------------------------------------
+
+static class TcpCubicTestSuite : public TestSuite
+{
+public:
+  TcpCubicTestSuite () : TestSuite ("tcp-cubic-test", UNIT)
+  {
+    AddTestCase (new TcpCubicReductionTest (true, "Reduction with fast convergence"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpCubicReductionTest (false, "Reduction without fast convergence"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpCubicIncrementTest (100, MilliSeconds (100), "Wmax=100, RTT=100 ms"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpCubicIncrementTest (1000, MilliSeconds (50), "Wmax=1000, RTT=50 ms"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpCubicHystartTest (true, MilliSeconds (3), MilliSeconds (10), 1,
+                                          "HyStart, RTT increase"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpCubicHystartTest (true, MicroSeconds (100), Time (0), 2,
+                                          "HyStart, ACK train"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpCubicHystartTest (true, MilliSeconds (3), MilliSeconds (2), -1,
+                                          "HyStart, RTT increase below the threshold"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpCubicHystartTest (false, MilliSeconds (3), MilliSeconds (10), -1,
+                                          "HyStart disabled"),
+                 TestCase::QUICK);
+  }
+} g_tcpCubicTest;
+
+} // namespace ns3
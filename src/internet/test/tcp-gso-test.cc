@@ -0,0 +1,402 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "tcp-general-test.h"
+#include "tcp-error-model.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/segmentation-offload.h"
+
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpGsoTestSuite");
+
+/**
+ * \brief Check the split of an IPv4 TCP super-segment
+ *
+ * Each segment must carry a copy of the headers, with its own sequence
+ * number, IPv4 identification and length; FIN and PSH must be on the
+ * last segment only.
+ */
+class TcpGsoSegmentationTest : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param name the test description
+   */
+  TcpGsoSegmentationTest (const std::string &name);
+
+private:
+  virtual void DoRun (void);
+};
+
+TcpGsoSegmentationTest::TcpGsoSegmentationTest (const std::string &name)
+  : TestCase (name)
+{
+}
+
+void
+TcpGsoSegmentationTest::DoRun ()
+{
+  // Registers the IPv4 segmentation
+  Ptr<Ipv4L3Protocol> ipv4 = CreateObject<Ipv4L3Protocol> ();
+
+  const uint16_t mss = 1448;
+  const uint32_t payload = 3 * mss + 656;
+
+  Ptr<Packet> p = Create<Packet> (payload);
+  TcpHeader tcpHeader;
+  tcpHeader.SetSourcePort (49153);
+  tcpHeader.SetDestinationPort (50000);
+  tcpHeader.SetSequenceNumber (SequenceNumber32 (1001));
+  tcpHeader.SetAckNumber (SequenceNumber32 (1));
+  tcpHeader.SetFlags (TcpHeader::ACK | TcpHeader::PSH | TcpHeader::FIN);
+  p->AddHeader (tcpHeader);
+
+  Ipv4Header ipHeader;
+  ipHeader.SetSource (Ipv4Address ("10.0.0.1"));
+  ipHeader.SetDestination (Ipv4Address ("10.0.0.2"));
+  ipHeader.SetProtocol (6);
+  ipHeader.SetIdentification (7);
+  ipHeader.SetPayloadSize (p->GetSize ());
+  p->AddHeader (ipHeader);
+  p->AddPacketTag (GsoTag (mss));
+
+  std::list<Ptr<Packet> > segments = SegmentationOffload::Segment (p, Ipv4L3Protocol::PROT_NUMBER);
+  NS_TEST_ASSERT_MSG_EQ (segments.size (), 4, "Wrong number of segments");
+
+  uint32_t index = 0;
+  uint32_t received = 0;
+  for (std::list<Ptr<Packet> >::iterator it = segments.begin (); it != segments.end (); ++it, ++index)
+    {
+      Ptr<Packet> segment = (*it)->Copy ();
+      GsoTag gsoTag;
+      NS_TEST_ASSERT_MSG_EQ (segment->PeekPacketTag (gsoTag), false, "GsoTag left on a segment");
+
+      Ipv4Header segmentIpHeader;
+      segment->RemoveHeader (segmentIpHeader);
+      TcpHeader segmentTcpHeader;
+      segment->RemoveHeader (segmentTcpHeader);
+      bool last = (index == segments.size () - 1);
+
+      NS_TEST_ASSERT_MSG_EQ (segment->GetSize (), (last ? 656 : mss), "Wrong segment size");
+      NS_TEST_ASSERT_MSG_EQ (segmentIpHeader.GetPayloadSize (), segment->GetSize () + segmentTcpHeader.GetSerializedSize (),
+                             "Wrong IPv4 payload size");
+      NS_TEST_ASSERT_MSG_EQ (segmentIpHeader.GetIdentification (), 7 + index, "Wrong IPv4 identification");
+      NS_TEST_ASSERT_MSG_EQ (segmentIpHeader.GetSource (), ipHeader.GetSource (), "Wrong IPv4 source");
+      NS_TEST_ASSERT_MSG_EQ (segmentTcpHeader.GetSequenceNumber (), SequenceNumber32 (1001 + received),
+                             "Wrong sequence number");
+      NS_TEST_ASSERT_MSG_EQ (segmentTcpHeader.GetAckNumber (), SequenceNumber32 (1), "Wrong ACK number");
+      NS_TEST_ASSERT_MSG_EQ (segmentTcpHeader.GetDestinationPort (), 50000, "Wrong port");
+      NS_TEST_ASSERT_MSG_EQ (((segmentTcpHeader.GetFlags () & TcpHeader::FIN) != 0), last, "Wrong FIN flag");
+      NS_TEST_ASSERT_MSG_EQ (((segmentTcpHeader.GetFlags () & TcpHeader::PSH) != 0), last, "Wrong PSH flag");
+      NS_TEST_ASSERT_MSG_EQ (((segmentTcpHeader.GetFlags () & TcpHeader::ACK) != 0), true, "Wrong ACK flag");
+      received += segment->GetSize ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (received, payload, "Payload lost in the split");
+
+  ipv4->Dispose ();
+}
+
+/**
+ * \brief Check the merge of received IPv4 TCP segments
+ *
+ * Contiguous segments of a flow must be merged behind the headers of the
+ * first one, up to a segment with PSH or shorter than the first one; the
+ * segments of another flow, not contiguous or with other headers must not.
+ */
+class TcpGsoCoalesceTest : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param name the test description
+   */
+  TcpGsoCoalesceTest (const std::string &name);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Create a segment
+   * \param seq the sequence number
+   * \param size the payload size
+   * \param flags the TCP flags
+   * \param ack the ACK number
+   * \param srcPort the source port
+   * \returns the segment, starting with the IPv4 header
+   */
+  Ptr<Packet> CreateSegment (uint32_t seq, uint32_t size, uint8_t flags = TcpHeader::ACK,
+                             uint32_t ack = 1, uint16_t srcPort = 49153);
+};
+
+TcpGsoCoalesceTest::TcpGsoCoalesceTest (const std::string &name)
+  : TestCase (name)
+{
+}
+
+Ptr<Packet>
+TcpGsoCoalesceTest::CreateSegment (uint32_t seq, uint32_t size, uint8_t flags, uint32_t ack, uint16_t srcPort)
+{
+  Ptr<Packet> p = Create<Packet> (size);
+  TcpHeader tcpHeader;
+  tcpHeader.SetSourcePort (srcPort);
+  tcpHeader.SetDestinationPort (50000);
+  tcpHeader.SetSequenceNumber (SequenceNumber32 (seq));
+  tcpHeader.SetAckNumber (SequenceNumber32 (ack));
+  tcpHeader.SetFlags (flags);
+  tcpHeader.SetWindowSize (1000);
+  p->AddHeader (tcpHeader);
+
+  Ipv4Header ipHeader;
+  ipHeader.SetSource (Ipv4Address ("10.0.0.1"));
+  ipHeader.SetDestination (Ipv4Address ("10.0.0.2"));
+  ipHeader.SetProtocol (6);
+  ipHeader.SetPayloadSize (p->GetSize ());
+  p->AddHeader (ipHeader);
+  return p;
+}
+
+void
+TcpGsoCoalesceTest::DoRun ()
+{
+  // Registers the IPv4 merge
+  Ptr<Ipv4L3Protocol> ipv4 = CreateObject<Ipv4L3Protocol> ();
+  const uint16_t protocol = Ipv4L3Protocol::PROT_NUMBER;
+  const uint32_t mss = 1448;
+
+  Ptr<Packet> held = CreateSegment (1001, mss);
+  held = SegmentationOffload::Coalesce (held, CreateSegment (1001 + mss, mss), protocol);
+  NS_TEST_ASSERT_MSG_NE (held, 0, "Contiguous segments not merged");
+  held = SegmentationOffload::Coalesce (held, CreateSegment (1001 + 2 * mss, mss), protocol);
+  NS_TEST_ASSERT_MSG_NE (held, 0, "Contiguous segments not merged");
+
+  NS_TEST_ASSERT_MSG_EQ (SegmentationOffload::Coalesce (held, CreateSegment (1001 + 4 * mss, mss), protocol), 0,
+                         "Segment after a gap merged");
+  NS_TEST_ASSERT_MSG_EQ (SegmentationOffload::Coalesce (held, CreateSegment (1001 + 3 * mss, mss, TcpHeader::ACK, 2), protocol), 0,
+                         "Segment with another ACK merged");
+  NS_TEST_ASSERT_MSG_EQ (SegmentationOffload::Coalesce (held, CreateSegment (1001 + 3 * mss, mss, TcpHeader::ACK | TcpHeader::FIN), protocol), 0,
+                         "Segment with FIN merged");
+  NS_TEST_ASSERT_MSG_EQ (SegmentationOffload::Coalesce (held, CreateSegment (1001 + 3 * mss, mss, TcpHeader::ACK, 1, 49154), protocol), 0,
+                         "Segment of another flow merged");
+  NS_TEST_ASSERT_MSG_EQ (SegmentationOffload::Coalesce (held, CreateSegment (1001 + 3 * mss, mss + 1), protocol), 0,
+                         "Segment longer than the first one merged");
+
+  // A short segment with PSH ends the merge
+  held = SegmentationOffload::Coalesce (held, CreateSegment (1001 + 3 * mss, 100, TcpHeader::ACK | TcpHeader::PSH), protocol);
+  NS_TEST_ASSERT_MSG_NE (held, 0, "Last segment not merged");
+  NS_TEST_ASSERT_MSG_EQ (SegmentationOffload::Coalesce (held, CreateSegment (1101 + 3 * mss, mss), protocol), 0,
+                         "Segment merged after PSH");
+
+  GsoTag gsoTag;
+  NS_TEST_ASSERT_MSG_EQ (held->PeekPacketTag (gsoTag), true, "Merged segment without GsoTag");
+  NS_TEST_ASSERT_MSG_EQ (gsoTag.GetSegmentSize (), mss, "Wrong segment size");
+
+  Ptr<Packet> merged = held->Copy ();
+  Ipv4Header ipHeader;
+  merged->RemoveHeader (ipHeader);
+  TcpHeader tcpHeader;
+  merged->RemoveHeader (tcpHeader);
+  NS_TEST_ASSERT_MSG_EQ (merged->GetSize (), 3 * mss + 100, "Wrong merged payload");
+  NS_TEST_ASSERT_MSG_EQ (ipHeader.GetPayloadSize (), merged->GetSize () + tcpHeader.GetSerializedSize (),
+                         "Wrong IPv4 payload size");
+  NS_TEST_ASSERT_MSG_EQ (tcpHeader.GetSequenceNumber (), SequenceNumber32 (1001), "Wrong sequence number");
+  NS_TEST_ASSERT_MSG_EQ (tcpHeader.GetFlags (), (TcpHeader::ACK | TcpHeader::PSH), "Wrong flags");
+
+  ipv4->Dispose ();
+}
+
+/**
+ * \brief Check a transfer with super-segments over a device without
+ * segmentation offload
+ *
+ * The sender must emit super-segments, split by IPv4 in segments which
+ * the receiver gets one by one. With SACK, each segment of a super-segment
+ * dropped by the receiver must be retransmitted alone, without timeout.
+ */
+class TcpGsoTransferTest : public TcpGeneralTest
+{
+public:
+  /**
+   * \brief Constructor
+   * \param seqsToKill the sequence numbers of the segments to drop
+   * \param msg the test description
+   */
+  TcpGsoTransferTest (const std::vector<uint32_t> &seqsToKill, const std::string &msg);
+
+protected:
+  virtual Ptr<TcpSocketMsgBase> CreateReceiverSocket (Ptr<Node> node);
+  virtual Ptr<TcpSocketMsgBase> CreateSenderSocket (Ptr<Node> node);
+  virtual Ptr<ErrorModel> CreateReceiverErrorModel ();
+  virtual void ConfigureEnvironment ();
+  virtual void ConfigureProperties ();
+
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void Rx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void RTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who);
+  virtual void FinalChecks ();
+
+  std::vector<uint32_t> m_seqsToKill;    //!< Segments to drop
+  SequenceNumber32 m_highTxSeq;          //!< Highest sequence number sent
+  SequenceNumber32 m_highRxAck;          //!< Highest ACK received by the sender
+  std::map<uint32_t, uint32_t> m_retx;   //!< Retransmissions, by sequence number
+  uint32_t m_superSegments;              //!< Super-segments sent
+  uint32_t m_rxSegments;                 //!< Data segments received
+};
+
+TcpGsoTransferTest::TcpGsoTransferTest (const std::vector<uint32_t> &seqsToKill,
+                                        const std::string &msg)
+  : TcpGeneralTest (msg),
+    m_seqsToKill (seqsToKill),
+    m_highTxSeq (0),
+    m_highRxAck (0),
+    m_superSegments (0),
+    m_rxSegments (0)
+{
+}
+
+void
+TcpGsoTransferTest::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktCount (200);
+}
+
+void
+TcpGsoTransferTest::ConfigureProperties ()
+{
+  TcpGeneralTest::ConfigureProperties ();
+  SetInitialCwnd (SENDER, 10);
+}
+
+Ptr<TcpSocketMsgBase>
+TcpGsoTransferTest::CreateReceiverSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateReceiverSocket (node);
+  socket->SetAttribute ("Sack", BooleanValue (true));
+  return socket;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpGsoTransferTest::CreateSenderSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket (node);
+  socket->SetAttribute ("Sack", BooleanValue (true));
+  socket->SetAttribute ("GsoMaxSize", UintegerValue (8 * 500));
+  socket->SetAttribute ("MinRto", TimeValue (Seconds (10.0)));
+  return socket;
+}
+
+Ptr<ErrorModel>
+TcpGsoTransferTest::CreateReceiverErrorModel ()
+{
+  Ptr<TcpSeqErrorModel> errorModel = CreateObject<TcpSeqErrorModel> ();
+  for (std::vector<uint32_t>::const_iterator it = m_seqsToKill.begin (); it != m_seqsToKill.end (); ++it)
+    {
+      errorModel->AddSeqToKill (SequenceNumber32 (*it));
+    }
+  return errorModel;
+}
+
+void
+TcpGsoTransferTest::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who != SENDER || p->GetSize () == 0)
+    {
+      return;
+    }
+
+  GsoTag gsoTag;
+  if (p->GetSize () > 500)
+    {
+      NS_TEST_ASSERT_MSG_EQ (p->PeekPacketTag (gsoTag), true, "Super-segment without GsoTag");
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (p->GetSize (), 8 * 500, "Super-segment above GsoMaxSize");
+      NS_TEST_ASSERT_MSG_EQ ((p->GetSize () % 500), 0, "Super-segment of partial segments");
+      ++m_superSegments;
+    }
+  if (h.GetSequenceNumber () < m_highTxSeq)
+    {
+      NS_TEST_ASSERT_MSG_EQ (p->GetSize (), 500, "Retransmission of a super-segment");
+      ++m_retx[h.GetSequenceNumber ().GetValue ()];
+    }
+  m_highTxSeq = std::max (m_highTxSeq, h.GetSequenceNumber () + p->GetSize ());
+}
+
+void
+TcpGsoTransferTest::Rx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who == SENDER && (h.GetFlags () & TcpHeader::ACK))
+    {
+      m_highRxAck = std::max (m_highRxAck, h.GetAckNumber ());
+    }
+  else if (who == RECEIVER && p->GetSize () > 0)
+    {
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (p->GetSize (), 500, "Super-segment not split");
+      ++m_rxSegments;
+    }
+}
+
+void
+TcpGsoTransferTest::RTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who)
+{
+  NS_TEST_ASSERT_MSG_EQ (true, false, "RTO expired");
+}
+
+void
+TcpGsoTransferTest::FinalChecks ()
+{
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (m_highRxAck, SequenceNumber32 (1 + 200 * 500),
+                               "Not all the data has been acknowledged");
+  NS_TEST_ASSERT_MSG_GT (m_superSegments, 0, "No super-segment sent");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (m_rxSegments, 200, "Segments missing at the receiver");
+  for (std::vector<uint32_t>::const_iterator it = m_seqsToKill.begin (); it != m_seqsToKill.end (); ++it)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_retx[*it], 1, "Segment " << *it << " not retransmitted once");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_retx.size (), m_seqsToKill.size (), "Spurious retransmission");
+}
+
+static class TcpGsoTestSuite : public TestSuite
+{
+public:
+  TcpGsoTestSuite ()
+    : TestSuite ("tcp-gso-test", UNIT)
+  {
+    std::vector<uint32_t> none;
+    std::vector<uint32_t> losses;
+    losses.push_back (20001 + 500);
+    losses.push_back (20001 + 2 * 500);
+
+    AddTestCase (new TcpGsoTransferTest (none, "Transfer with super-segments"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpGsoTransferTest (losses, "SACK recovery of segments of a super-segment"),
+                 TestCase::QUICK);
+    // Last, as the transfers enable the packet metadata
+    AddTestCase (new TcpGsoSegmentationTest ("Split of an IPv4 super-segment"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpGsoCoalesceTest ("Merge of received IPv4 segments"),
+                 TestCase::QUICK);
+  }
+} g_tcpGsoTestSuite;
+
+} // namespace ns3
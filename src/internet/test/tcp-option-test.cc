@@ -22,6 +22,8 @@
 #include "ns3/tcp-option.h"
 #include "ns3/private/tcp-option-winscale.h"
 #include "ns3/private/tcp-option-ts.h"
+#include "ns3/private/tcp-option-sack-permitted.h"
+#include "ns3/private/tcp-option-sack.h"
 
 #include <string.h>
 
@@ -164,6 +166,118 @@ TcpOptionTSTestCase::DoTeardown ()
 {
 }
 
+class TcpOptionSackTestCase : public TestCase
+{
+public:
+  TcpOptionSackTestCase (std::string name, uint32_t blocks);
+
+  void TestSerialize ();
+  void TestDeserialize ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  uint32_t m_blocks;
+  TcpOptionSack::SackList m_sackList;
+  Buffer m_buffer;
+};
+
+
+TcpOptionSackTestCase::TcpOptionSackTestCase (std::string name, uint32_t blocks)
+  : TestCase (name)
+{
+  m_blocks = blocks;
+}
+
+void
+TcpOptionSackTestCase::DoRun ()
+{
+  Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable> ();
+
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      m_sackList.clear ();
+      for (uint32_t j = 0; j < m_blocks; ++j)
+        {
+          SequenceNumber32 left (x->GetInteger ());
+          m_sackList.push_back (std::make_pair (left, left + x->GetInteger (1, 65535)));
+        }
+      TestSerialize ();
+      TestDeserialize ();
+    }
+}
+
+void
+TcpOptionSackTestCase::TestSerialize ()
+{
+  TcpOptionSack opt;
+
+  for (TcpOptionSack::SackList::const_iterator it = m_sackList.begin (); it != m_sackList.end (); ++it)
+    {
+      opt.AddSackBlock (*it);
+    }
+
+  NS_TEST_EXPECT_MSG_EQ (m_blocks, opt.GetNumSackBlocks (), "Blocks aren't saved correctly");
+  NS_TEST_EXPECT_MSG_EQ (opt.GetSerializedSize (), TcpOptionSack::GetSizeForBlocks (m_blocks),
+                         "Wrong size");
+
+  m_buffer.AddAtStart (opt.GetSerializedSize ());
+
+  opt.Serialize (m_buffer.Begin ());
+}
+
+void
+TcpOptionSackTestCase::TestDeserialize ()
+{
+  TcpOptionSack opt;
+
+  Buffer::Iterator start = m_buffer.Begin ();
+  uint8_t kind = start.PeekU8 ();
+
+  NS_TEST_EXPECT_MSG_EQ (kind, TcpOption::SACK, "Different kind found");
+
+  uint32_t size = opt.Deserialize (start);
+
+  NS_TEST_EXPECT_MSG_EQ (size, TcpOptionSack::GetSizeForBlocks (m_blocks), "Different size found");
+  NS_TEST_EXPECT_MSG_EQ (opt.GetNumSackBlocks (), m_blocks, "Different number of blocks found");
+  NS_TEST_EXPECT_MSG_EQ ((opt.GetSackList () == m_sackList), true, "Different blocks found");
+}
+
+void
+TcpOptionSackTestCase::DoTeardown ()
+{
+}
+
+class TcpOptionSackPermittedTestCase : public TestCase
+{
+public:
+  TcpOptionSackPermittedTestCase (std::string name);
+
+private:
+  virtual void DoRun (void);
+};
+
+
+TcpOptionSackPermittedTestCase::TcpOptionSackPermittedTestCase (std::string name)
+  : TestCase (name)
+{
+}
+
+void
+TcpOptionSackPermittedTestCase::DoRun ()
+{
+  TcpOptionSackPermitted opt;
+  Buffer buffer;
+
+  buffer.AddAtStart (opt.GetSerializedSize ());
+  opt.Serialize (buffer.Begin ());
+
+  Buffer::Iterator start = buffer.Begin ();
+  NS_TEST_EXPECT_MSG_EQ (start.PeekU8 (), TcpOption::SACKPERMITTED, "Different kind found");
+  NS_TEST_EXPECT_MSG_EQ (opt.Deserialize (start), 2, "Different size found");
+}
+
 static class TcpOptionTestSuite : public TestSuite
 {
 public:
@@ -176,6 +290,12 @@ public:
                                               "scale value", i), TestCase::QUICK);
       }
     AddTestCase (new TcpOptionTSTestCase ("Testing serialization of random values for timestamp"), TestCase::QUICK);
+    for (uint32_t i = 1; i <= 4; ++i)
+      {
+        AddTestCase (new TcpOptionSackTestCase ("Testing serialization of random "
+                                                "SACK blocks", i), TestCase::QUICK);
+      }
+    AddTestCase (new TcpOptionSackPermittedTestCase ("Testing serialization of SACK-permitted"), TestCase::QUICK);
   }
 
 } g_TcpOptionTestSuite;
@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-rx-buffer.h"
+
+using namespace ns3;
+
+/**
+ * Check the data extracted from the reordering buffer, its next expected
+ * sequence number and its out of order blocks against a map of the bytes
+ * received, while overlapping segments arrive in random order.
+ */
+class TcpRxBufferTestCase : public TestCase
+{
+public:
+  TcpRxBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \returns a pseudo random number
+   */
+  uint32_t Next (void);
+  /**
+   * \param offset the offset of a byte in the stream
+   * \returns the value of the byte
+   */
+  static uint8_t GetByte (uint32_t offset);
+
+  uint32_t m_state; //!< The state of the pseudo random numbers
+};
+
+TcpRxBufferTestCase::TcpRxBufferTestCase ()
+  : TestCase ("Check the reordering of TcpRxBuffer"),
+    m_state (1)
+{
+}
+
+uint32_t
+TcpRxBufferTestCase::Next (void)
+{
+  m_state = m_state * 1103515245 + 12345;
+  return m_state ^ (m_state >> 16);
+}
+
+uint8_t
+TcpRxBufferTestCase::GetByte (uint32_t offset)
+{
+  return (offset * 7 + offset / 251) & 0xff;
+}
+
+void
+TcpRxBufferTestCase::DoRun (void)
+{
+  // start close to the wrap around of the sequence numbers
+  SequenceNumber32 isn (0xffff0000);
+  uint32_t length = 100000;
+  Ptr<TcpRxBuffer> buffer = CreateObject<TcpRxBuffer> ();
+  buffer->SetNextRxSequence (isn);
+  buffer->SetMaxBufferSize (1 << 20);
+
+  std::vector<bool> received (length, false);
+  uint32_t next = 0;       // first byte not received
+  uint32_t extracted = 0;  // bytes read by the application
+  std::vector<uint8_t> data (length);
+  while (extracted < length)
+    {
+      if (Next () % 4 != 0)
+        {
+          // a segment from 1000 bytes before the first missing byte to
+          // 4000 bytes after it
+          uint32_t offset = std::max (next + Next () % 5000, 1000U) - 1000;
+          if (offset >= length)
+            {
+              continue;
+            }
+          uint32_t size = std::min (1 + Next () % 1500, length - offset);
+          for (uint32_t i = 0; i < size; i++)
+            {
+              data[i] = GetByte (offset + i);
+            }
+          TcpHeader header;
+          header.SetSequenceNumber (isn + SequenceNumber32 (offset));
+          buffer->Add (Create<Packet> (&data[0], size), header);
+          for (uint32_t i = 0; i < size; i++)
+            {
+              received[offset + i] = true;
+            }
+          while (next < length && received[next])
+            {
+              next++;
+            }
+        }
+      else
+        {
+          uint32_t size = Next () % 5000;
+          Ptr<Packet> p = buffer->Extract (size);
+          size = std::min (size, next - extracted);
+          if (size == 0)
+            {
+              NS_TEST_ASSERT_MSG_EQ ((p == 0), true, "Nothing to extract expected");
+              continue;
+            }
+          NS_TEST_ASSERT_MSG_EQ (p->GetSize (), size, "Wrong size of the extracted data");
+          p->CopyData (&data[0], size);
+          for (uint32_t i = 0; i < size; i++)
+            {
+              NS_TEST_ASSERT_MSG_EQ ((uint32_t) data[i], (uint32_t) GetByte (extracted + i),
+                                     "Wrong byte " << extracted + i);
+            }
+          extracted += size;
+        }
+
+      NS_TEST_ASSERT_MSG_EQ (buffer->NextRxSequence (), isn + SequenceNumber32 (next), "Wrong next sequence");
+      NS_TEST_ASSERT_MSG_EQ (buffer->Available (), next - extracted, "Wrong available size");
+      TcpRxBuffer::SequenceBlockList blocks = buffer->GetOutOfOrderBlocks ();
+      uint32_t n = 0;
+      uint32_t size = next - extracted;
+      for (uint32_t i = next; i < length && i < next + 6500; i++)
+        {
+          if (received[i] && !received[i - 1])
+            {
+              NS_TEST_ASSERT_MSG_LT (n, blocks.size (), "Missing block at " << i);
+              NS_TEST_ASSERT_MSG_EQ (blocks[n].first, isn + SequenceNumber32 (i), "Wrong start of block " << n);
+            }
+          if (received[i])
+            {
+              size++;
+            }
+          if (received[i] && (i + 1 == length || !received[i + 1]))
+            {
+              NS_TEST_ASSERT_MSG_EQ (blocks[n].second, isn + SequenceNumber32 (i + 1), "Wrong end of block " << n);
+              n++;
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (blocks.size (), n, "Wrong number of blocks");
+      NS_TEST_ASSERT_MSG_EQ (buffer->Size (), size, "Wrong buffer size");
+    }
+}
+
+class TcpRxBufferTestSuite : public TestSuite
+{
+public:
+  TcpRxBufferTestSuite ()
+    : TestSuite ("tcp-rx-buffer", UNIT)
+  {
+    AddTestCase (new TcpRxBufferTestCase, TestCase::QUICK);
+  }
+};
+
+static TcpRxBufferTestSuite g_tcpRxBufferTestSuite;
@@ -0,0 +1,248 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tcp-general-test.h"
+#include "tcp-error-model.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+#include "ns3/private/tcp-option-sack.h"
+
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpSackTestSuite");
+
+/**
+ * \brief Check the SACK negotiation, and the SACK-based recovery of the
+ * segments dropped by the receiver
+ *
+ * When both ends enable SACK, the receiver reports the out-of-order data
+ * in SACK blocks, and the sender retransmits each dropped segment once,
+ * without retransmission timeout nor spurious retransmission. When one end
+ * disables SACK, no SACK option is ever sent.
+ */
+class TcpSackTestCase : public TcpGeneralTest
+{
+public:
+  /**
+   * \brief Constructor
+   * \param senderSack SACK enabled on the sender
+   * \param receiverSack SACK enabled on the receiver
+   * \param seqsToKill the sequence numbers of the segments to drop
+   * \param msg the test description
+   */
+  TcpSackTestCase (bool senderSack, bool receiverSack,
+                   const std::vector<uint32_t> &seqsToKill, const std::string &msg);
+
+protected:
+  virtual Ptr<TcpSocketMsgBase> CreateReceiverSocket (Ptr<Node> node);
+  virtual Ptr<TcpSocketMsgBase> CreateSenderSocket (Ptr<Node> node);
+  virtual Ptr<ErrorModel> CreateReceiverErrorModel ();
+  virtual void ConfigureEnvironment ();
+
+  virtual void Tx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void Rx (const Ptr<const Packet> p, const TcpHeader&h, SocketWho who);
+  virtual void RTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who);
+  virtual void CongStateTrace (const TcpSocketState::TcpCongState_t oldValue,
+                               const TcpSocketState::TcpCongState_t newValue);
+  virtual void FinalChecks ();
+
+  bool m_senderSack;                     //!< SACK enabled on the sender
+  bool m_receiverSack;                   //!< SACK enabled on the receiver
+  std::vector<uint32_t> m_seqsToKill;    //!< Segments to drop
+  SequenceNumber32 m_highTxSeq;          //!< Highest sequence number sent
+  SequenceNumber32 m_highRxAck;          //!< Highest ACK received by the sender
+  std::map<uint32_t, uint32_t> m_retx;   //!< Retransmissions, by sequence number
+  uint32_t m_sackOptions;                //!< SACK options sent by the receiver
+  bool m_recovery;                       //!< The sender entered the recovery
+};
+
+TcpSackTestCase::TcpSackTestCase (bool senderSack, bool receiverSack,
+                                  const std::vector<uint32_t> &seqsToKill,
+                                  const std::string &msg)
+  : TcpGeneralTest (msg),
+    m_senderSack (senderSack),
+    m_receiverSack (receiverSack),
+    m_seqsToKill (seqsToKill),
+    m_highTxSeq (0),
+    m_highRxAck (0),
+    m_sackOptions (0),
+    m_recovery (false)
+{
+}
+
+void
+TcpSackTestCase::ConfigureEnvironment ()
+{
+  TcpGeneralTest::ConfigureEnvironment ();
+  SetAppPktCount (200);
+}
+
+Ptr<TcpSocketMsgBase>
+TcpSackTestCase::CreateReceiverSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateReceiverSocket (node);
+  socket->SetAttribute ("Sack", BooleanValue (m_receiverSack));
+  return socket;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpSackTestCase::CreateSenderSocket (Ptr<Node> node)
+{
+  Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket (node);
+  socket->SetAttribute ("Sack", BooleanValue (m_senderSack));
+  socket->SetAttribute ("MinRto", TimeValue (Seconds (10.0)));
+  return socket;
+}
+
+Ptr<ErrorModel>
+TcpSackTestCase::CreateReceiverErrorModel ()
+{
+  Ptr<TcpSeqErrorModel> errorModel = CreateObject<TcpSeqErrorModel> ();
+  for (std::vector<uint32_t>::const_iterator it = m_seqsToKill.begin (); it != m_seqsToKill.end (); ++it)
+    {
+      errorModel->AddSeqToKill (SequenceNumber32 (*it));
+    }
+  return errorModel;
+}
+
+void
+TcpSackTestCase::Tx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  bool sack = m_senderSack && m_receiverSack;
+
+  if (h.GetFlags () & TcpHeader::SYN)
+    {
+      bool enabled = (who == SENDER) ? m_senderSack : (m_senderSack && m_receiverSack);
+      NS_TEST_ASSERT_MSG_EQ (h.HasOption (TcpOption::SACKPERMITTED), enabled,
+                             "Wrong SACK-permitted option in the SYN");
+      return;
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (h.HasOption (TcpOption::SACKPERMITTED), false,
+                         "SACK-permitted option out of a SYN");
+
+  if (who == SENDER)
+    {
+      NS_TEST_ASSERT_MSG_EQ (h.HasOption (TcpOption::SACK), false,
+                             "SACK option sent with no out-of-order data");
+      if (p->GetSize () == 0)
+        {
+          return;
+        }
+      if (h.GetSequenceNumber () < m_highTxSeq)
+        {
+          NS_LOG_INFO ("SENDER retransmits " << h);
+          ++m_retx[h.GetSequenceNumber ().GetValue ()];
+        }
+      m_highTxSeq = std::max (m_highTxSeq, h.GetSequenceNumber () + p->GetSize ());
+    }
+  else if (h.HasOption (TcpOption::SACK))
+    {
+      NS_TEST_ASSERT_MSG_EQ (sack, true, "SACK option sent while not negotiated");
+      ++m_sackOptions;
+
+      Ptr<const TcpOptionSack> option = DynamicCast<const TcpOptionSack> (h.GetOption (TcpOption::SACK));
+      const TcpOptionSack::SackList &blocks = option->GetSackList ();
+      NS_TEST_ASSERT_MSG_GT (blocks.size (), 0, "Empty SACK option");
+      for (TcpOptionSack::SackList::const_iterator it = blocks.begin (); it != blocks.end (); ++it)
+        {
+          NS_TEST_ASSERT_MSG_GT (it->first, h.GetAckNumber (), "SACK block below the ACK");
+          NS_TEST_ASSERT_MSG_GT (it->second, it->first, "Empty SACK block");
+        }
+    }
+}
+
+void
+TcpSackTestCase::Rx (const Ptr<const Packet> p, const TcpHeader &h, SocketWho who)
+{
+  if (who == SENDER && (h.GetFlags () & TcpHeader::ACK))
+    {
+      m_highRxAck = std::max (m_highRxAck, h.GetAckNumber ());
+    }
+}
+
+void
+TcpSackTestCase::RTOExpired (const Ptr<const TcpSocketState> tcb, SocketWho who)
+{
+  if (m_senderSack && m_receiverSack)
+    {
+      NS_TEST_ASSERT_MSG_EQ (true, false, "RTO expired during the SACK-based recovery");
+    }
+}
+
+void
+TcpSackTestCase::CongStateTrace (const TcpSocketState::TcpCongState_t oldValue,
+                                 const TcpSocketState::TcpCongState_t newValue)
+{
+  if (newValue == TcpSocketState::CA_RECOVERY)
+    {
+      m_recovery = true;
+    }
+}
+
+void
+TcpSackTestCase::FinalChecks ()
+{
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (m_highRxAck, SequenceNumber32 (1 + 200 * 500),
+                               "Not all the data has been acknowledged");
+
+  if (!(m_senderSack && m_receiverSack))
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_sackOptions, 0, "SACK option sent while not negotiated");
+      return;
+    }
+
+  NS_TEST_ASSERT_MSG_GT (m_sackOptions, 0, "No SACK option sent");
+  NS_TEST_ASSERT_MSG_EQ (m_recovery, true, "No recovery");
+  for (std::vector<uint32_t>::const_iterator it = m_seqsToKill.begin (); it != m_seqsToKill.end (); ++it)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_retx[*it], 1, "Segment " << *it << " not retransmitted once");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_retx.size (), m_seqsToKill.size (), "Spurious retransmission");
+}
+
+static class TcpSackTestSuite : public TestSuite
+{
+public:
+  TcpSackTestSuite ()
+    : TestSuite ("tcp-sack-test", UNIT)
+  {
+    std::vector<uint32_t> burst;
+    for (uint32_t i = 0; i < 4; ++i)
+      {
+        burst.push_back (20001 + i * 500);
+      }
+    std::vector<uint32_t> spread;
+    for (uint32_t i = 0; i < 4; ++i)
+      {
+        spread.push_back (20001 + i * 2000);
+      }
+
+    AddTestCase (new TcpSackTestCase (true, true, burst, "SACK recovery of a burst of losses"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpSackTestCase (true, true, spread, "SACK recovery of spread losses"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpSackTestCase (true, false, burst, "SACK disabled on the receiver"),
+                 TestCase::QUICK);
+    AddTestCase (new TcpSackTestCase (false, true, burst, "SACK disabled on the sender"),
+                 TestCase::QUICK);
+  }
+} g_tcpSackTestSuite;
+
+} // namespace ns3
@@ -0,0 +1,445 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <deque>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-tx-buffer.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/**
+ * Check the segments copied from the transmit buffer against the bytes
+ * written by the application, while the data is added, sent and
+ * acknowledged in random steps.
+ */
+class TcpTxBufferTestCase : public TestCase
+{
+public:
+  TcpTxBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \returns a pseudo random number
+   */
+  uint32_t Next (void);
+  /**
+   * \param offset the offset of a byte in the stream
+   * \returns the value of the byte
+   */
+  static uint8_t GetByte (uint32_t offset);
+
+  uint32_t m_state; //!< The state of the pseudo random numbers
+};
+
+TcpTxBufferTestCase::TcpTxBufferTestCase ()
+  : TestCase ("Check the data copied from TcpTxBuffer"),
+    m_state (1)
+{
+}
+
+uint32_t
+TcpTxBufferTestCase::Next (void)
+{
+  m_state = m_state * 1103515245 + 12345;
+  return m_state ^ (m_state >> 16);
+}
+
+uint8_t
+TcpTxBufferTestCase::GetByte (uint32_t offset)
+{
+  return (offset * 7 + offset / 251) & 0xff;
+}
+
+void
+TcpTxBufferTestCase::DoRun (void)
+{
+  // start close to the wrap around of the sequence numbers
+  SequenceNumber32 isn (0xffff0000);
+  Ptr<TcpTxBuffer> buffer = CreateObject<TcpTxBuffer> ();
+  buffer->SetHeadSequence (isn);
+  buffer->SetMaxBufferSize (100000);
+
+  uint32_t written = 0;  // bytes added by the application
+  uint32_t acked = 0;    // bytes acknowledged
+  std::vector<uint8_t> data (3000);
+  for (uint32_t k = 0; k < 5000; k++)
+    {
+      switch (Next () % 3)
+        {
+        case 0:
+          {
+            uint32_t size = 1 + Next () % 2000;
+            for (uint32_t i = 0; i < size; i++)
+              {
+                data[i] = GetByte (written + i);
+              }
+            bool added = buffer->Add (Create<Packet> (&data[0], size));
+            NS_TEST_ASSERT_MSG_EQ (added, (size <= 100000 - (written - acked)), "Wrong room in the buffer");
+            if (added)
+              {
+                written += size;
+              }
+          }
+          break;
+        case 1:
+          if (written > acked)
+            {
+              acked += Next () % (written - acked + 1);
+              buffer->DiscardUpTo (isn + SequenceNumber32 (acked));
+            }
+          break;
+        default:
+          if (written > acked)
+            {
+              uint32_t offset = acked + Next () % (written - acked);
+              uint32_t size = 1 + Next () % 3000;
+              Ptr<Packet> segment = buffer->CopyFromSequence (size, isn + SequenceNumber32 (offset));
+              size = std::min (size, written - offset);
+              NS_TEST_ASSERT_MSG_EQ (segment->GetSize (), size, "Wrong segment size");
+              segment->CopyData (&data[0], size);
+              for (uint32_t i = 0; i < size; i++)
+                {
+                  NS_TEST_ASSERT_MSG_EQ ((uint32_t) data[i], (uint32_t) GetByte (offset + i),
+                                         "Wrong byte " << i << " of the segment at " << offset);
+                }
+            }
+          break;
+        }
+      NS_TEST_ASSERT_MSG_EQ (buffer->HeadSequence (), isn + SequenceNumber32 (acked), "Wrong head sequence");
+      NS_TEST_ASSERT_MSG_EQ (buffer->Size (), written - acked, "Wrong buffer size");
+      NS_TEST_ASSERT_MSG_EQ (buffer->TailSequence (), isn + SequenceNumber32 (written), "Wrong tail sequence");
+    }
+
+  // acknowledging a FIN moves the head beyond the data
+  buffer->DiscardUpTo (isn + SequenceNumber32 (written + 1));
+  NS_TEST_ASSERT_MSG_EQ (buffer->Size (), 0, "Empty buffer expected");
+  NS_TEST_ASSERT_MSG_EQ (buffer->HeadSequence (), isn + SequenceNumber32 (written + 1), "Wrong head sequence");
+}
+
+/**
+ * Check the SACK scoreboard of the transmit buffer against a model of the
+ * segments and of the bytes SACKed, while segments are sent, SACKed,
+ * acknowledged, deemed lost and retransmitted in random steps.
+ */
+class TcpTxBufferScoreboardTestCase : public TestCase
+{
+public:
+  TcpTxBufferScoreboardTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \returns a pseudo random number
+   */
+  uint32_t Next (void);
+
+  /// A segment of the model
+  struct Segment
+  {
+    uint32_t offset; //!< Offset of the segment
+    uint32_t size;   //!< Size of the segment
+    bool sacked;     //!< SACKed
+    bool lost;       //!< Deemed lost
+    bool retrans;    //!< Retransmitted
+  };
+
+  uint32_t m_state; //!< The state of the pseudo random numbers
+};
+
+TcpTxBufferScoreboardTestCase::TcpTxBufferScoreboardTestCase ()
+  : TestCase ("Check the SACK scoreboard of TcpTxBuffer"),
+    m_state (7)
+{
+}
+
+uint32_t
+TcpTxBufferScoreboardTestCase::Next (void)
+{
+  m_state = m_state * 1103515245 + 12345;
+  return m_state ^ (m_state >> 16);
+}
+
+void
+TcpTxBufferScoreboardTestCase::DoRun (void)
+{
+  const uint32_t dupThresh = 3;
+  const uint32_t segmentSize = 100;
+  const uint32_t total = 400000;
+  SequenceNumber32 isn (0xfffff000);
+  Ptr<TcpTxBuffer> buffer = CreateObject<TcpTxBuffer> ();
+  buffer->SetHeadSequence (isn);
+  buffer->SetMaxBufferSize (total);
+  buffer->Add (Create<Packet> (total));
+
+  std::deque<Segment> segments;            // the segments sent and not acknowledged
+  std::vector<bool> sackedBytes (total);   // the bytes SACKed
+  uint32_t acked = 0;
+  uint32_t sent = 0;
+  for (uint32_t k = 0; k < 20000 && sent + 200 < total; k++)
+    {
+      switch (Next () % 8)
+        {
+        case 0:
+        case 1:
+          if (sent - acked < 5000)
+            {
+              // send a new segment
+              Segment segment = { sent, 1 + Next () % 150, false, false, false };
+              buffer->Sent (isn + SequenceNumber32 (sent), segment.size);
+              segments.push_back (segment);
+              sent += segment.size;
+            }
+          break;
+        case 2:
+        case 3:
+          {
+            // SACK a block, which may exceed the bytes sent
+            uint32_t start = acked + Next () % (sent - acked + 50);
+            uint32_t end = start + 1 + Next () % 400;
+            TcpTxBuffer::SequenceBlockList blocks;
+            blocks.push_back (std::make_pair (isn + SequenceNumber32 (start), isn + SequenceNumber32 (end)));
+            for (uint32_t i = start; i < std::min (end, sent); i++)
+              {
+                sackedBytes[i] = true;
+              }
+            uint32_t expected = 0;
+            for (std::deque<Segment>::iterator it = segments.begin (); it != segments.end (); ++it)
+              {
+                bool covered = true;
+                for (uint32_t i = it->offset; i < it->offset + it->size && covered; i++)
+                  {
+                    covered = sackedBytes[i];
+                  }
+                if (covered && !it->sacked)
+                  {
+                    it->sacked = true;
+                    expected += it->size;
+                  }
+              }
+            NS_TEST_ASSERT_MSG_EQ (buffer->Update (blocks), expected, "Wrong bytes newly SACKed");
+          }
+          break;
+        case 4:
+          {
+            // acknowledge some bytes
+            acked += Next () % (std::min<uint32_t> (sent - acked, 300) + 1);
+            buffer->DiscardUpTo (isn + SequenceNumber32 (acked));
+            while (!segments.empty () && segments.front ().offset + segments.front ().size <= acked)
+              {
+                segments.pop_front ();
+              }
+            if (!segments.empty () && segments.front ().offset < acked)
+              {
+                Segment &segment = segments.front ();
+                segment.size -= acked - segment.offset;
+                segment.offset = acked;
+                bool covered = true;
+                for (uint32_t i = segment.offset; i < segment.offset + segment.size && covered; i++)
+                  {
+                    covered = sackedBytes[i];
+                  }
+                segment.sacked = segment.sacked || covered;
+              }
+          }
+          break;
+        case 5:
+          {
+            // RFC 6675 IsLost (): enough SACKed blocks or bytes above.
+            // Count the bytes and the blocks starting at or above each byte.
+            std::vector<uint32_t> bytesAbove (sent - acked + 1, 0);
+            std::vector<uint32_t> blocksAbove (sent - acked + 1, 0);
+            for (uint32_t i = sent; i-- > acked; )
+              {
+                bytesAbove[i - acked] = bytesAbove[i - acked + 1] + sackedBytes[i];
+                blocksAbove[i - acked] = blocksAbove[i - acked + 1]
+                  + (sackedBytes[i] && (i == acked || !sackedBytes[i - 1]));
+              }
+            uint32_t expected = 0;
+            for (std::deque<Segment>::iterator it = segments.begin (); it != segments.end (); ++it)
+              {
+                uint32_t end = it->offset + it->size - acked;
+                if (!it->sacked && !it->lost
+                    && (blocksAbove[end] >= dupThresh || bytesAbove[end] > (dupThresh - 1) * segmentSize))
+                  {
+                    it->lost = true;
+                    expected += it->size;
+                  }
+              }
+            NS_TEST_ASSERT_MSG_EQ (buffer->DetectLoss (dupThresh, segmentSize), expected,
+                                   "Wrong bytes newly lost");
+          }
+          break;
+        case 6:
+          {
+            // retransmit with NextSeg ()
+            bool lostOnly = Next () % 2;
+            uint32_t highSacked = 0;
+            for (uint32_t i = acked; i < sent; i++)
+              {
+                highSacked = sackedBytes[i] ? i + 1 : highSacked;
+              }
+            std::deque<Segment>::iterator next = segments.end ();
+            for (std::deque<Segment>::iterator it = segments.begin (); it != segments.end (); ++it)
+              {
+                if (it->lost && !it->sacked && !it->retrans)
+                  {
+                    next = it;
+                    break;
+                  }
+              }
+            for (std::deque<Segment>::iterator it = segments.begin ();
+                 it != segments.end () && next == segments.end () && !lostOnly
+                 && it->offset < highSacked; ++it)
+              {
+                if (!it->sacked && !it->lost && !it->retrans)
+                  {
+                    next = it;
+                  }
+              }
+            SequenceNumber32 seq;
+            uint32_t size;
+            bool found = buffer->NextSeg (&seq, &size, lostOnly);
+            NS_TEST_ASSERT_MSG_EQ (found, (next != segments.end ()), "Wrong segment found");
+            if (found)
+              {
+                NS_TEST_ASSERT_MSG_EQ (seq, isn + SequenceNumber32 (next->offset), "Wrong segment sequence");
+                NS_TEST_ASSERT_MSG_EQ (size, next->size, "Wrong segment size");
+                buffer->Sent (seq, size);
+                next->retrans = true;
+              }
+          }
+          break;
+        default:
+          if (Next () % 16 == 0)
+            {
+              // retransmission timeout
+              buffer->MarkAllLost ();
+              for (std::deque<Segment>::iterator it = segments.begin (); it != segments.end (); ++it)
+                {
+                  it->lost = it->lost || !it->sacked;
+                  it->retrans = it->retrans && it->sacked;
+                }
+            }
+          break;
+        }
+
+      uint32_t sackedCount = 0;
+      uint32_t lostCount = 0;
+      uint32_t pipe = 0;
+      for (std::deque<Segment>::iterator it = segments.begin (); it != segments.end (); ++it)
+        {
+          sackedCount += it->sacked ? it->size : 0;
+          lostCount += (!it->sacked && it->lost) ? it->size : 0;
+          pipe += (!it->sacked && !it->lost) ? it->size : 0;
+          pipe += (!it->sacked && it->retrans) ? it->size : 0;
+        }
+      NS_TEST_ASSERT_MSG_EQ (buffer->GetSackedBytes (), sackedCount, "Wrong SACKed bytes at step " << k);
+      NS_TEST_ASSERT_MSG_EQ (buffer->GetLostBytes (), lostCount, "Wrong lost bytes at step " << k);
+      NS_TEST_ASSERT_MSG_EQ (buffer->BytesInFlight (), pipe, "Wrong pipe at step " << k);
+    }
+}
+
+/**
+ * Check the segments which the RACK rule of the transmit buffer deems
+ * lost, and when.
+ */
+class TcpTxBufferRackTestCase : public TestCase
+{
+public:
+  TcpTxBufferRackTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /// SACK the fifth segment, 10 ms after the segments were sent
+  void SackFifth (void);
+  /// Detect the losses by time, before and once the reordering window elapses
+  void DetectLosses (void);
+
+  Ptr<TcpTxBuffer> m_buffer; //!< The buffer
+  SequenceNumber32 m_isn;    //!< The initial sequence number
+};
+
+TcpTxBufferRackTestCase::TcpTxBufferRackTestCase ()
+  : TestCase ("Check the RACK loss detection of TcpTxBuffer"),
+    m_isn (1000)
+{
+}
+
+void
+TcpTxBufferRackTestCase::DoRun (void)
+{
+  m_buffer = CreateObject<TcpTxBuffer> ();
+  m_buffer->SetHeadSequence (m_isn);
+  m_buffer->Add (Create<Packet> (10000));
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      m_buffer->Sent (m_isn + SequenceNumber32 (i * 1000), 1000);
+    }
+  Simulator::Schedule (MilliSeconds (10), &TcpTxBufferRackTestCase::SackFifth, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+TcpTxBufferRackTestCase::SackFifth (void)
+{
+  TcpTxBuffer::SequenceBlockList blocks;
+  blocks.push_back (std::make_pair (m_isn + SequenceNumber32 (4000), m_isn + SequenceNumber32 (5000)));
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->Update (blocks), 1000, "Wrong bytes newly SACKed");
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->GetMinRtt (), MilliSeconds (10), "Wrong minimum RTT");
+
+  uint32_t lost;
+  Time timeout = m_buffer->DetectLossByTime (MilliSeconds (2), &lost);
+  NS_TEST_ASSERT_MSG_EQ (lost, 0, "No segment is lost before the reordering window elapses");
+  NS_TEST_ASSERT_MSG_EQ (timeout, MilliSeconds (2), "Wrong reordering timeout");
+  Simulator::Schedule (timeout, &TcpTxBufferRackTestCase::DetectLosses, this);
+}
+
+void
+TcpTxBufferRackTestCase::DetectLosses (void)
+{
+  uint32_t lost;
+  Time timeout = m_buffer->DetectLossByTime (MilliSeconds (2), &lost);
+  // the segments sent along with the fifth one, but before it, are lost
+  NS_TEST_ASSERT_MSG_EQ (lost, 4000, "Wrong bytes deemed lost");
+  NS_TEST_ASSERT_MSG_EQ (timeout, Time (0), "No segment is left to check");
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->BytesInFlight (), 5000, "Wrong pipe");
+
+  SequenceNumber32 seq;
+  uint32_t size;
+  NS_TEST_ASSERT_MSG_EQ (m_buffer->NextSeg (&seq, &size, true), true, "A lost segment is expected");
+  NS_TEST_ASSERT_MSG_EQ (seq, m_isn, "The first segment is expected");
+  NS_TEST_ASSERT_MSG_EQ (size, 1000, "Wrong segment size");
+}
+
+class TcpTxBufferTestSuite : public TestSuite
+{
+public:
+  TcpTxBufferTestSuite ()
+    : TestSuite ("tcp-tx-buffer", UNIT)
+  {
+    AddTestCase (new TcpTxBufferTestCase, TestCase::QUICK);
+    AddTestCase (new TcpTxBufferScoreboardTestCase, TestCase::QUICK);
+    AddTestCase (new TcpTxBufferRackTestCase, TestCase::QUICK);
+  }
+};
+
+static TcpTxBufferTestSuite g_tcpTxBufferTestSuite;
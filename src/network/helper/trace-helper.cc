@@ -28,6 +28,10 @@
 #include "ns3/names.h"
 #include "ns3/net-device.h"
 #include "ns3/pcap-file-wrapper.h"
+#include "ns3/pcapng-file.h"
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+#include "ns3/simulator.h"
 
 #include "trace-helper.h"
 
@@ -35,6 +39,51 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("TraceHelper");
 
+/**
+ * \brief The pcapng file shared by all the pcap traces, if any.
+ */
+static GlobalValue g_pcapNgFile = GlobalValue ("PcapNgFile",
+                                               "If not empty, the pcap traces written by the helpers "
+                                               "are all captured into this pcapng file, one interface "
+                                               "per trace, instead of one pcap file per trace.",
+                                               StringValue (""),
+                                               MakeStringChecker ());
+
+namespace {
+
+/** The pcapng file of the "PcapNgFile" global value, when open. */
+Ptr<PcapNgFile> g_sharedPcapNgFile;
+
+/** Close the shared pcapng file, at the end of the simulation. */
+void
+CloseSharedPcapNgFile (void)
+{
+  if (g_sharedPcapNgFile != 0)
+    {
+      g_sharedPcapNgFile->Close ();
+      g_sharedPcapNgFile = 0;
+    }
+}
+
+/**
+ * \param filename The name of the pcapng file.
+ * \returns The shared pcapng file, created if needed.
+ */
+Ptr<PcapNgFile>
+GetSharedPcapNgFile (std::string const &filename)
+{
+  if (g_sharedPcapNgFile == 0)
+    {
+      g_sharedPcapNgFile = Create<PcapNgFile> ();
+      bool ok = g_sharedPcapNgFile->Open (filename, 1 << 20, true);
+      NS_ABORT_MSG_UNLESS (ok, "Unable to Open " << filename);
+      Simulator::ScheduleDestroy (&CloseSharedPcapNgFile);
+    }
+  return g_sharedPcapNgFile;
+}
+
+} // anonymous namespace
+
 PcapHelper::PcapHelper ()
 {
   NS_LOG_FUNCTION_NOARGS ();
@@ -56,6 +105,14 @@ PcapHelper::CreateFile (
   NS_LOG_FUNCTION (filename << filemode << dataLinkType << snapLen << tzCorrection);
 
   Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+  StringValue ngFilename;
+  g_pcapNgFile.GetValue (ngFilename);
+  if (ngFilename.Get () != "" && filemode == std::ios::out)
+    {
+      file->Attach (GetSharedPcapNgFile (ngFilename.Get ()), filename);
+      file->Init (dataLinkType, snapLen, tzCorrection);
+      return file;
+    }
   file->Open (filename, filemode);
   NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename << " for mode " << filemode);
 
@@ -94,6 +94,10 @@ public:
   /**
    * @brief Create and initialize a pcap file.
    * 
+   * When the "PcapNgFile" global value is set, a file opened for output
+   * is instead an interface of this shared pcapng file, named after
+   * @p filename.
+   *
    * @param filename file name
    * @param filemode file mode
    * @param dataLinkType data link type of packet data
@@ -18,9 +18,17 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "buffer.h"
+#include "packet-arena.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
 
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined (__AVX2__)
+#include <immintrin.h>
+#endif
+
 #define LOG_INTERNAL_STATE(y)                                                                    \
   NS_LOG_LOGIC (y << "start="<<m_start<<", end="<<m_end<<", zero start="<<m_zeroAreaStart<<              \
                 ", zero end="<<m_zeroAreaEnd<<", count="<<m_data->m_count<<", size="<<m_data->m_size<<   \
@@ -43,148 +51,129 @@ static struct Zeroes
   const uint32_t size;  //!< buffer size
 } g_zeroes; //!< Zero-filled buffer
 
-}
-
-namespace ns3 {
-
-NS_LOG_COMPONENT_DEFINE ("Buffer");
-
-
-uint32_t Buffer::g_recommendedStart = 0;
-#ifdef BUFFER_FREE_LIST
-/* The following macros are pretty evil but they are needed to allow us to
- * keep track of 3 possible states for the g_freeList variable:
- *  - uninitialized means that no one has created a buffer yet
- *    so no one has created the associated free list (it is created
- *    on-demand when the first buffer is created)
- *  - initialized means that the free list exists and is valid
- *  - destroyed means that the static destructors of this compilation unit
- *    have run so, the free list has been cleared from its content
- * The key is that in destroyed state, we are careful not re-create it
- * which is a typical weakness of lazy evaluation schemes which use 
- * '0' as a special value to indicate both un-initialized and destroyed.
- * Note that it is important to use '0' as the marker for un-initialized state
- * because the variable holding this state information is initialized to zero
- * which the compiler assigns to zero-memory which is initialized to _zero_
- * before the constructors run so this ensures perfect handling of crazy 
- * constructor orderings.
+/**
+ * \ingroup packet
+ * \brief Sum the 16-bit words of a contiguous run of bytes.
+ *
+ * The words are read in the format of Buffer::Iterator::ReadU16, the
+ * first byte being the low order one; a trailing odd byte is a word of
+ * its own.  The vector paths rely on x86 being little endian.  Each 32-bit
+ * lane of the accumulators gets two words per block, so that the runs of
+ * a 16-bit checksum size cannot overflow them.
+ *
+ * \param data the bytes
+ * \param size the number of bytes, at most 65535
+ * \returns the sum, not folded
  */
-#define MAGIC_DESTROYED (~(long) 0)
-#define IS_UNINITIALIZED(x) (x == (Buffer::FreeList*)0)
-#define IS_DESTROYED(x) (x == (Buffer::FreeList*)MAGIC_DESTROYED)
-#define IS_INITIALIZED(x) (!IS_UNINITIALIZED (x) && !IS_DESTROYED (x))
-#define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
-#define UNINITIALIZED ((Buffer::FreeList*)0)
-uint32_t Buffer::g_maxSize = 0;
-Buffer::FreeList *Buffer::g_freeList = 0;
-struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
-
-Buffer::LocalStaticDestructor::~LocalStaticDestructor(void)
+uint64_t
+AddChecksumWords (uint8_t const *data, uint32_t size)
 {
-  NS_LOG_FUNCTION (this);
-  if (IS_INITIALIZED (g_freeList))
+  uint64_t sum = 0;
+#if defined (__AVX2__)
+  if (size >= 32)
     {
-      for (Buffer::FreeList::iterator i = g_freeList->begin ();
-           i != g_freeList->end (); i++)
+      __m256i zero = _mm256_setzero_si256 ();
+      __m256i acc = zero;
+      do
         {
-          Buffer::Deallocate (*i);
+          __m256i v = _mm256_loadu_si256 (reinterpret_cast<__m256i const *> (data));
+          acc = _mm256_add_epi32 (acc, _mm256_unpacklo_epi16 (v, zero));
+          acc = _mm256_add_epi32 (acc, _mm256_unpackhi_epi16 (v, zero));
+          data += 32;
+          size -= 32;
+        }
+      while (size >= 32);
+      uint32_t lanes[8];
+      _mm256_storeu_si256 (reinterpret_cast<__m256i *> (lanes), acc);
+      for (uint32_t i = 0; i < 8; i++)
+        {
+          sum += lanes[i];
         }
-      delete g_freeList;
-      g_freeList = DESTROYED;
     }
-}
-
-void
-Buffer::Recycle (struct Buffer::Data *data)
-{
-  NS_LOG_FUNCTION (data);
-  NS_ASSERT (data->m_count == 0);
-  NS_ASSERT (!IS_UNINITIALIZED (g_freeList));
-  g_maxSize = std::max (g_maxSize, data->m_size);
-  /* feed into free list */
-  if (data->m_size < g_maxSize ||
-      IS_DESTROYED (g_freeList) ||
-      g_freeList->size () > 1000)
+#endif
+#if defined (__SSE2__)
+  if (size >= 16)
     {
-      Buffer::Deallocate (data);
+      __m128i zero = _mm_setzero_si128 ();
+      __m128i acc = zero;
+      do
+        {
+          __m128i v = _mm_loadu_si128 (reinterpret_cast<__m128i const *> (data));
+          acc = _mm_add_epi32 (acc, _mm_unpacklo_epi16 (v, zero));
+          acc = _mm_add_epi32 (acc, _mm_unpackhi_epi16 (v, zero));
+          data += 16;
+          size -= 16;
+        }
+      while (size >= 16);
+      uint32_t lanes[4];
+      _mm_storeu_si128 (reinterpret_cast<__m128i *> (lanes), acc);
+      for (uint32_t i = 0; i < 4; i++)
+        {
+          sum += lanes[i];
+        }
     }
-  else
+#endif
+  for (; size >= 2; size -= 2, data += 2)
+    {
+      sum += data[0] | (data[1] << 8);
+    }
+  if (size == 1)
     {
-      NS_ASSERT (IS_INITIALIZED (g_freeList));
-      g_freeList->push_back (data);
+      sum += data[0];
     }
+  return sum;
 }
 
-Buffer::Data *
-Buffer::Create (uint32_t dataSize)
+/**
+ * \ingroup packet
+ * \brief Fold a sum of 16-bit words in one's complement
+ * \param sum the sum
+ * \returns the folded sum
+ */
+uint64_t
+FoldChecksum (uint64_t sum)
 {
-  NS_LOG_FUNCTION (dataSize);
-  /* try to find a buffer correctly sized. */
-  if (IS_UNINITIALIZED (g_freeList))
-    {
-      g_freeList = new Buffer::FreeList ();
-    }
-  else if (IS_INITIALIZED (g_freeList))
+  while (sum >> 16)
     {
-      while (!g_freeList->empty ()) 
-        {
-          struct Buffer::Data *data = g_freeList->back ();
-          g_freeList->pop_back ();
-          if (data->m_size >= dataSize) 
-            {
-              data->m_count = 1;
-              return data;
-            }
-          Buffer::Deallocate (data);
-        }
+      sum = (sum & 0xffff) + (sum >> 16);
     }
-  struct Buffer::Data *data = Buffer::Allocate (dataSize);
-  NS_ASSERT (data->m_count == 1);
-  return data;
+  return sum;
 }
-#else /* BUFFER_FREE_LIST */
+
+}
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Buffer");
+
+
+uint32_t Buffer::g_recommendedStart = 0;
+uint64_t Buffer::g_materializedZeroBytes = 0;
+
 void
 Buffer::Recycle (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
-  Deallocate (data);
+  PacketArena::Deallocate (data, data->m_size - 1 + sizeof (struct Buffer::Data));
 }
 
 Buffer::Data *
-Buffer::Create (uint32_t size)
-{
-  NS_LOG_FUNCTION (size);
-  return Allocate (size);
-}
-#endif /* BUFFER_FREE_LIST */
-
-struct Buffer::Data *
-Buffer::Allocate (uint32_t reqSize)
+Buffer::Create (uint32_t reqSize)
 {
   NS_LOG_FUNCTION (reqSize);
   if (reqSize == 0) 
     {
       reqSize = 1;
     }
-  NS_ASSERT (reqSize >= 1);
-  uint32_t size = reqSize - 1 + sizeof (struct Buffer::Data);
-  uint8_t *b = new uint8_t [size];
+  uint32_t size = PacketArena::GetBlockSize (reqSize - 1 + sizeof (struct Buffer::Data));
+  uint8_t *b = PacketArena::Allocate (size);
   struct Buffer::Data *data = reinterpret_cast<struct Buffer::Data*>(b);
-  data->m_size = reqSize;
+  data->m_size = size + 1 - sizeof (struct Buffer::Data);
   data->m_count = 1;
   return data;
 }
 
-void
-Buffer::Deallocate (struct Buffer::Data *data)
-{
-  NS_LOG_FUNCTION (data);
-  NS_ASSERT (data->m_count == 0);
-  uint8_t *buf = reinterpret_cast<uint8_t *> (data);
-  delete [] buf;
-}
-
 Buffer::Buffer ()
 {
   NS_LOG_FUNCTION (this);
@@ -262,13 +251,12 @@ Buffer::operator = (Buffer const&o)
   if (m_data != o.m_data) 
     {
       // not assignment to self.
-      m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (AtomicDecrement (m_data->m_count) == 0) 
         {
           Recycle (m_data);
         }
       m_data = o.m_data;
-      m_data->m_count++;
+      AtomicIncrement (m_data->m_count);
     }
   g_recommendedStart = std::max (g_recommendedStart, m_maxZeroAreaStart);
   m_maxZeroAreaStart = o.m_maxZeroAreaStart;
@@ -285,8 +273,7 @@ Buffer::~Buffer ()
   NS_LOG_FUNCTION (this);
   NS_ASSERT (CheckInternalState ());
   g_recommendedStart = std::max (g_recommendedStart, m_maxZeroAreaStart);
-  m_data->m_count--;
-  if (m_data->m_count == 0) 
+  if (AtomicDecrement (m_data->m_count) == 0) 
     {
       Recycle (m_data);
     }
@@ -310,7 +297,12 @@ Buffer::AddAtStart (uint32_t start)
 {
   NS_LOG_FUNCTION (this << start);
   NS_ASSERT (CheckInternalState ());
+#ifdef NS3_MTP
+  // another thread may own a reference to this data: never write into it.
+  bool isDirty = m_data->m_count > 1;
+#else
   bool isDirty = m_data->m_count > 1 && m_start > m_data->m_dirtyStart;
+#endif
   if (m_start >= start && !isDirty)
     {
       /* enough space in the buffer and not dirty. 
@@ -328,8 +320,7 @@ Buffer::AddAtStart (uint32_t start)
       uint32_t newSize = GetInternalSize () + start;
       struct Buffer::Data *newData = Buffer::Create (newSize);
       memcpy (newData->m_data + start, m_data->m_data + m_start, GetInternalSize ());
-      m_data->m_count--;
-      if (m_data->m_count == 0)
+      if (AtomicDecrement (m_data->m_count) == 0)
         {
           Buffer::Recycle (m_data);
         }
@@ -355,7 +346,11 @@ Buffer::AddAtEnd (uint32_t end)
 {
   NS_LOG_FUNCTION (this << end);
   NS_ASSERT (CheckInternalState ());
+#ifdef NS3_MTP
+  bool isDirty = m_data->m_count > 1;
+#else
   bool isDirty = m_data->m_count > 1 && m_end < m_data->m_dirtyEnd;
+#endif
   if (GetInternalEnd () + end <= m_data->m_size && !isDirty)
     {
       /* enough space in buffer and not dirty
@@ -373,8 +368,7 @@ Buffer::AddAtEnd (uint32_t end)
       uint32_t newSize = GetInternalSize () + end;
       struct Buffer::Data *newData = Buffer::Create (newSize);
       memcpy (newData->m_data, m_data->m_data + m_start, GetInternalSize ());
-      m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (AtomicDecrement (m_data->m_count) == 0) 
         {
           Buffer::Recycle (m_data);
         }
@@ -426,14 +420,27 @@ Buffer::AddAtEnd (const Buffer &o)
       return;
     }
 
-  Buffer dst = CreateFullCopy ();
-  Buffer src = o.CreateFullCopy ();
-
-  dst.AddAtEnd (src.GetSize ());
-  Buffer::Iterator destStart = dst.End ();
-  destStart.Prev (src.GetSize ());
-  destStart.Write (src.Begin (), src.End ());
-  *this = dst;
+  uint32_t zeroSize = m_zeroAreaEnd - m_zeroAreaStart;
+  uint32_t otherZeroSize = o.m_zeroAreaEnd - o.m_zeroAreaStart;
+  if (otherZeroSize <= zeroSize)
+    {
+      /* keep our zero area virtual and append the bytes of o,
+       * which are real bytes but for a smaller zero area. */
+      Buffer src = o.CreateFullCopy ();
+      AddAtEnd (src.GetSize ());
+      Buffer::Iterator destStart = End ();
+      destStart.Prev (src.GetSize ());
+      destStart.Write (src.Begin (), src.End ());
+    }
+  else
+    {
+      /* keep the zero area of o virtual and prepend our bytes. */
+      Buffer dst = CreateFullCopy ();
+      Buffer tmp = o;
+      tmp.AddAtStart (dst.GetSize ());
+      tmp.Begin ().Write (dst.Begin (), dst.End ());
+      *this = tmp;
+    }
   NS_ASSERT (CheckInternalState ());
 }
 
@@ -537,6 +544,10 @@ Buffer::CreateFullCopy (void) const
   NS_ASSERT (CheckInternalState ());
   if (m_zeroAreaEnd - m_zeroAreaStart != 0) 
     {
+      NS_LOG_LOGIC ("write " << m_zeroAreaEnd - m_zeroAreaStart << " zero bytes into memory");
+#ifndef NS3_MTP
+      g_materializedZeroBytes += m_zeroAreaEnd - m_zeroAreaStart;
+#endif
       Buffer tmp;
       tmp.AddAtStart (m_zeroAreaEnd - m_zeroAreaStart);
       tmp.Begin ().WriteU8 (0, m_zeroAreaEnd - m_zeroAreaStart);
@@ -555,6 +566,12 @@ Buffer::CreateFullCopy (void) const
   return *this;
 }
 
+uint64_t
+Buffer::GetMaterializedZeroBytes (void)
+{
+  return g_materializedZeroBytes;
+}
+
 uint32_t 
 Buffer::GetSerializedSize (void) const
 {
@@ -843,25 +860,32 @@ Buffer::Iterator::Write (Iterator start, Iterator end)
   uint32_t size = end.m_current - start.m_current;
   NS_ASSERT_MSG (CheckNoZero (m_current, m_current + size),
                  GetWriteErrorMessage ());
+  // the destination bytes are all on the same side of our zero area
+  uint8_t *to = &m_data[m_current];
+  if (m_current > m_zeroStart)
+    {
+      to -= m_zeroEnd - m_zeroStart;
+    }
   if (start.m_current <= start.m_zeroStart)
     {
       uint32_t toCopy = std::min (size, start.m_zeroStart - start.m_current);
-      memcpy (&m_data[m_current], &start.m_data[start.m_current], toCopy);
+      memcpy (to, &start.m_data[start.m_current], toCopy);
       start.m_current += toCopy;
       m_current += toCopy;
+      to += toCopy;
       size -= toCopy;
     }
   if (start.m_current <= start.m_zeroEnd)
     {
       uint32_t toCopy = std::min (size, start.m_zeroEnd - start.m_current);
-      memset (&m_data[m_current], 0, toCopy);
+      memset (to, 0, toCopy);
       start.m_current += toCopy;
       m_current += toCopy;
+      to += toCopy;
       size -= toCopy;
     }
   uint32_t toCopy = std::min (size, start.m_dataEnd - start.m_current);
   uint8_t *from = &start.m_data[start.m_current - (start.m_zeroEnd-start.m_zeroStart)];
-  uint8_t *to = &m_data[m_current];
   memcpy (to, from, toCopy);
   m_current += toCopy;
 }
@@ -1140,18 +1164,47 @@ uint16_t
 Buffer::Iterator::CalculateIpChecksum (uint16_t size, uint32_t initialChecksum)
 {
   NS_LOG_FUNCTION (this << size << initialChecksum);
-  /* see RFC 1071 to understand this code. */
-  uint32_t sum = initialChecksum;
-
-  for (int j = 0; j < size/2; j++)
-    sum += ReadU16 ();
-
-  if (size & 1)
-    sum += ReadU8 ();
-
-  while (sum >> 16)
-    sum = (sum & 0xffff) + (sum >> 16);
-  return ~sum;
+  NS_ASSERT_MSG (m_current >= m_dataStart &&
+                 m_current + size <= m_dataEnd,
+                 GetReadErrorMessage ());
+  /* see RFC 1071 to understand this code. The bytes are summed by
+   * contiguous runs, the zero area adding nothing. A run starting at an
+   * odd offset has its bytes swapped with respect to the words, and so
+   * does its folded sum (RFC 1071, section 2.B). */
+  uint64_t sum = initialChecksum;
+  uint32_t offset = 0;
+  uint32_t end = m_current + size;
+  while (m_current < end)
+    {
+      uint8_t const *run;
+      uint32_t runEnd;
+      if (m_current < m_zeroStart)
+        {
+          run = m_data + m_current;
+          runEnd = std::min (end, m_zeroStart);
+        }
+      else if (m_current < m_zeroEnd)
+        {
+          runEnd = std::min (end, m_zeroEnd);
+          offset += runEnd - m_current;
+          m_current = runEnd;
+          continue;
+        }
+      else
+        {
+          run = m_data + m_current - (m_zeroEnd - m_zeroStart);
+          runEnd = end;
+        }
+      uint64_t runSum = FoldChecksum (AddChecksumWords (run, runEnd - m_current));
+      if (offset & 1)
+        {
+          runSum = ((runSum & 0xff) << 8) | (runSum >> 8);
+        }
+      sum += runSum;
+      offset += runEnd - m_current;
+      m_current = runEnd;
+    }
+  return ~FoldChecksum (sum);
 }
 
 uint32_t 
@@ -24,8 +24,7 @@
 #include <vector>
 #include <ostream>
 #include "ns3/assert.h"
-
-#define BUFFER_FREE_LIST 1
+#include "ns3/atomic-counter.h"
 
 namespace ns3 {
 
@@ -365,6 +364,10 @@ public:
 
     /**
      * \brief Calculate the checksum.
+     *
+     * The contiguous runs of bytes are summed 16 or 32 bytes at a time
+     * when the build targets SSE2 or AVX2.
+     *
      * \param size size of the buffer.
      * \param initialChecksum initial value
      * \return checksum
@@ -521,6 +524,10 @@ private:
    * Add bytes at the end of the Buffer.
    * Any call to this method invalidates any Iterator
    * pointing to this Buffer.
+   *
+   * A Buffer holds a single virtual zero area: when both buffers
+   * have one, the larger one is kept virtual and only the other one
+   * is written into memory.
    */
   void AddAtEnd (const Buffer &o);
   /**
@@ -560,6 +567,20 @@ private:
    */
   inline Buffer::Iterator End (void) const;
 
+  /**
+   * \returns the number of virtual zero bytes which were written into
+   * memory, by all the buffers, since the start of the program.
+   *
+   * The virtual zero area of a buffer is written into memory when
+   * the buffer is converted into a real buffer, for example by
+   * PeekData, or when two buffers which both hold a zero area are
+   * concatenated.  Copying, fragmenting, adding headers and trailers,
+   * and writing the buffer into a stream with CopyData keep the zero
+   * area virtual.  This counter is not maintained when configured
+   * with --enable-mtp.
+   */
+  static uint64_t GetMaterializedZeroBytes (void);
+
   /**
    * \brief Return the number of bytes required for serialization.
    * \return the number of bytes.
@@ -727,21 +748,14 @@ private:
   static void Recycle (struct Buffer::Data *data);
   /**
    * \brief Create a buffer data storage
+   *
+   * The storage is allocated from the PacketArena, and its size is
+   * rounded up to the size of the arena block.
+   *
    * \param size the storage size to create
    * \returns a pointer to the created buffer storage
    */
   static struct Buffer::Data *Create (uint32_t size);
-  /**
-   * \brief Allocate a buffer data storage
-   * \param reqSize the storage size to create
-   * \returns a pointer to the allocated buffer storage
-   */
-  static struct Buffer::Data *Allocate (uint32_t reqSize);
-  /**
-   * \brief Deallocate the buffer memory
-   * \param data the buffer data storage
-   */
-  static void Deallocate (struct Buffer::Data *data);
 
   struct Data *m_data; //!< the buffer data storage
 
@@ -762,6 +776,10 @@ private:
    * value.
    */
   static uint32_t g_recommendedStart;
+  /**
+   * number of virtual zero bytes written into memory by CreateFullCopy
+   */
+  static uint64_t g_materializedZeroBytes;
 
   /**
    * offset to the start of the virtual zero area from the start
@@ -783,19 +801,6 @@ private:
    * instance from the start of m_data->m_data
    */
   uint32_t m_end;
-
-#ifdef BUFFER_FREE_LIST
-  /// Container for buffer data
-  typedef std::vector<struct Buffer::Data*> FreeList;
-  /// Local static destructor structure
-  struct LocalStaticDestructor 
-  {
-    ~LocalStaticDestructor ();
-  };
-  static uint32_t g_maxSize; //!< Max observed data size
-  static FreeList *g_freeList; //!< Buffer data container
-  static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
-#endif
 };
 
 } // namespace ns3
@@ -1049,7 +1054,7 @@ Buffer::Buffer (Buffer const&o)
     m_start (o.m_start),
     m_end (o.m_end)
 {
-  m_data->m_count++;
+  AtomicIncrement (m_data->m_count);
   NS_ASSERT (CheckInternalState ());
 }
 
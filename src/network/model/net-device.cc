@@ -231,4 +231,10 @@ NetDevice::~NetDevice ()
   NS_LOG_FUNCTION (this);
 }
 
+bool
+NetDevice::SupportsSegmentationOffload (void) const
+{
+  return false;
+}
+
 } // namespace ns3
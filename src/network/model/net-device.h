@@ -601,6 +601,15 @@ public:
    */
   virtual bool SupportsSendFrom (void) const = 0;
 
+  /**
+   * \return true if this interface splits the super-segments marked with
+   *         a GsoTag itself, false otherwise (the default).
+   *
+   * The super-segments sent over an interface which does not are split by
+   * the layer 3 protocol, before they are handed to the device.
+   */
+  virtual bool SupportsSegmentationOffload (void) const;
+
 };
 
 } // namespace ns3
@@ -25,6 +25,7 @@
 #include "ns3/log.h"
 #include "ns3/assert.h"
 #include "node-list.h"
+#include "packet-arena.h"
 #include "node.h"
 
 namespace ns3 {
@@ -136,6 +137,8 @@ NodeListPriv::DoGet (void)
       ptr = CreateObject<NodeListPriv> ();
       Config::RegisterRootNamespaceObject (ptr);
       Simulator::ScheduleDestroy (&NodeListPriv::Delete);
+      // run after the nodes, and thus their queues, are disposed
+      Simulator::ScheduleDestroy (&PacketArena::Reset);
     }
   return &ptr;
 }
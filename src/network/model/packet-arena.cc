@@ -0,0 +1,222 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "packet-arena.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PacketArena");
+
+#ifndef NS3_MTP
+namespace {
+
+/** log2 of the smallest size class */
+const uint32_t MIN_SHIFT = 4;
+/** Number of size classes: 16 bytes to 64 KiB */
+const uint32_t CLASSES = 13;
+/** Maximum number of bytes kept in each free list */
+const uint64_t MAX_CACHED_BYTES = 4 << 20;
+
+/** A block in a free list */
+struct FreeBlock
+{
+  FreeBlock *next;      //!< Next free block of the same size class
+};
+
+/**
+ * The free lists and the statistics.  They are plain data, zero
+ * initialized before any constructor runs, so that packets created or
+ * destroyed by static constructors and destructors are handled.
+ */
+struct ArenaState
+{
+  FreeBlock *head[CLASSES];        //!< Free lists
+  uint64_t cached[CLASSES];        //!< Bytes held in each free list
+  PacketArena::Stats stats;        //!< Statistics
+  bool destroyed;                  //!< Static destructors have run
+} g_arena;
+
+/**
+ * \param size a block size.
+ * \returns the size class of this size, or CLASSES if too large.
+ */
+inline uint32_t
+GetClass (uint32_t size)
+{
+  uint32_t c = 0;
+  while (c < CLASSES && (1U << (c + MIN_SHIFT)) < size)
+    {
+      c++;
+    }
+  return c;
+}
+
+/** Release the free lists. */
+void
+ReleaseFreeLists (void)
+{
+  for (uint32_t c = 0; c < CLASSES; c++)
+    {
+      while (g_arena.head[c] != 0)
+        {
+          FreeBlock *block = g_arena.head[c];
+          g_arena.head[c] = block->next;
+          delete [] reinterpret_cast<uint8_t *> (block);
+        }
+      g_arena.cached[c] = 0;
+    }
+  g_arena.stats.cachedBytes = 0;
+}
+
+/**
+ * Release the free lists at exit, and stop caching the blocks
+ * released after that.
+ */
+struct ArenaStaticDestructor
+{
+  ~ArenaStaticDestructor ()
+  {
+    ReleaseFreeLists ();
+    g_arena.destroyed = true;
+  }
+} g_arenaStaticDestructor;
+
+} // anonymous namespace
+
+uint32_t
+PacketArena::GetBlockSize (uint32_t size)
+{
+  uint32_t c = GetClass (size);
+  return c < CLASSES ? 1U << (c + MIN_SHIFT) : size;
+}
+
+uint8_t *
+PacketArena::Allocate (uint32_t size)
+{
+  uint32_t c = GetClass (size);
+  uint32_t blockSize = c < CLASSES ? 1U << (c + MIN_SHIFT) : size;
+  Stats &stats = g_arena.stats;
+  stats.allocations++;
+  stats.liveObjects++;
+  stats.liveBytes += blockSize;
+  if (stats.liveBytes > stats.peakBytes)
+    {
+      stats.peakBytes = stats.liveBytes;
+    }
+  if (c < CLASSES && g_arena.head[c] != 0)
+    {
+      FreeBlock *block = g_arena.head[c];
+      g_arena.head[c] = block->next;
+      g_arena.cached[c] -= blockSize;
+      stats.cachedBytes -= blockSize;
+      stats.reuses++;
+      return reinterpret_cast<uint8_t *> (block);
+    }
+  return new uint8_t [blockSize];
+}
+
+void
+PacketArena::Deallocate (void *block, uint32_t size)
+{
+  uint32_t c = GetClass (size);
+  uint32_t blockSize = c < CLASSES ? 1U << (c + MIN_SHIFT) : size;
+  Stats &stats = g_arena.stats;
+  NS_ASSERT (stats.liveObjects > 0);
+  stats.liveObjects--;
+  stats.liveBytes -= blockSize;
+  if (c < CLASSES && !g_arena.destroyed
+      && g_arena.cached[c] + blockSize <= MAX_CACHED_BYTES)
+    {
+      FreeBlock *free = reinterpret_cast<FreeBlock *> (block);
+      free->next = g_arena.head[c];
+      g_arena.head[c] = free;
+      g_arena.cached[c] += blockSize;
+      stats.cachedBytes += blockSize;
+      return;
+    }
+  delete [] reinterpret_cast<uint8_t *> (block);
+}
+
+void
+PacketArena::Reset (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  NS_LOG_INFO ("peak " << g_arena.stats.peakBytes << " bytes, "
+                       << g_arena.stats.reuses << " of "
+                       << g_arena.stats.allocations << " allocations reused");
+  ReleaseFreeLists ();
+  Stats &stats = g_arena.stats;
+  stats.allocations = 0;
+  stats.reuses = 0;
+  stats.peakBytes = stats.liveBytes;
+}
+
+PacketArena::Stats
+PacketArena::GetStats (void)
+{
+  return g_arena.stats;
+}
+
+#else /* NS3_MTP */
+
+uint32_t
+PacketArena::GetBlockSize (uint32_t size)
+{
+  return size;
+}
+
+uint8_t *
+PacketArena::Allocate (uint32_t size)
+{
+  return new uint8_t [size];
+}
+
+void
+PacketArena::Deallocate (void *block, uint32_t size)
+{
+  delete [] reinterpret_cast<uint8_t *> (block);
+}
+
+void
+PacketArena::Reset (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+}
+
+PacketArena::Stats
+PacketArena::GetStats (void)
+{
+  Stats stats = { 0, 0, 0, 0, 0, 0 };
+  return stats;
+}
+
+#endif /* NS3_MTP */
+
+void
+PacketArena::PrintStats (std::ostream &os)
+{
+  Stats stats = GetStats ();
+  os << "allocations=" << stats.allocations
+     << " reuses=" << stats.reuses
+     << " live-objects=" << stats.liveObjects
+     << " live-bytes=" << stats.liveBytes
+     << " peak-bytes=" << stats.peakBytes
+     << " cached-bytes=" << stats.cachedBytes;
+}
+
+} // namespace ns3
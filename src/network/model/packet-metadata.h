@@ -25,6 +25,7 @@
 #include <limits>
 #include "ns3/callback.h"
 #include "ns3/assert.h"
+#include "ns3/atomic-counter.h"
 #include "ns3/type-id.h"
 #include "buffer.h"
 
@@ -491,16 +492,6 @@ private:
     uint64_t packetUid;
   };
 
-  /**
-   * \brief Class to hold all the metadata
-   */
-  class DataFreeList : public std::vector<struct Data *>
-  {
-public:
-    ~DataFreeList ();
-  };
-
-  friend DataFreeList::~DataFreeList ();
   friend class ItemIterator;
 
   PacketMetadata ();
@@ -656,7 +647,6 @@ public:
    */
   static void Deallocate (struct PacketMetadata::Data *data);
 
-  static DataFreeList m_freeList; //!< the metadata data storage
   static bool m_enable; //!< Enable the packet metadata
   static bool m_enableChecking; //!< Enable the packet metadata checking
 
@@ -708,7 +698,7 @@ PacketMetadata::PacketMetadata (PacketMetadata const &o)
 {
   NS_ASSERT (m_data != 0);
   NS_ASSERT (m_data->m_count < std::numeric_limits<uint32_t>::max());
-  m_data->m_count++;
+  AtomicIncrement (m_data->m_count);
 }
 PacketMetadata &
 PacketMetadata::operator = (PacketMetadata const& o)
@@ -717,14 +707,13 @@ PacketMetadata::operator = (PacketMetadata const& o)
     {
       // not self assignment
       NS_ASSERT (m_data != 0);
-      m_data->m_count--;
-      if (m_data->m_count == 0) 
+      if (AtomicDecrement (m_data->m_count) == 0) 
         {
           PacketMetadata::Recycle (m_data);
         }
       m_data = o.m_data;
       NS_ASSERT (m_data != 0);
-      m_data->m_count++;
+      AtomicIncrement (m_data->m_count);
     }
   m_head = o.m_head;
   m_tail = o.m_tail;
@@ -735,8 +724,7 @@ PacketMetadata::operator = (PacketMetadata const& o)
 PacketMetadata::~PacketMetadata ()
 {
   NS_ASSERT (m_data != 0);
-  m_data->m_count--;
-  if (m_data->m_count == 0) 
+  if (AtomicDecrement (m_data->m_count) == 0) 
     {
       PacketMetadata::Recycle (m_data);
     }
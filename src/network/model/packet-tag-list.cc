@@ -20,7 +20,7 @@
 
 /**
 \file   packet-tag-list.cc
-\brief  Implements a linked list of Packet tags, including copy-on-write semantics.
+\brief  Implements a flat array of Packet tags, including copy-on-write semantics.
 */
 
 #include "packet-tag-list.h"
@@ -28,261 +28,198 @@
 #include "tag.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include <algorithm>
 #include <cstring>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("PacketTagList");
 
-bool
-PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
+struct PacketTagList::TagBlock *
+PacketTagList::Allocate (uint32_t capacity)
 {
-  TypeId tid = tag.GetInstanceTypeId ();
-  NS_LOG_FUNCTION (this << tid);
-  NS_LOG_INFO     ("looking for " << tid);
+  NS_LOG_FUNCTION (capacity);
+  capacity = std::max (capacity, (uint32_t)INITIAL_CAPACITY);
+  uint32_t size = PacketArena::GetBlockSize (sizeof (struct TagBlock)
+                                             + capacity * sizeof (struct TagData));
+  // use the slack of the arena size class
+  uint32_t fit = (size - sizeof (struct TagBlock)) / sizeof (struct TagData);
+  capacity = std::min (fit, 0xffffU);
+  struct TagBlock *block = reinterpret_cast<struct TagBlock *>
+    (PacketArena::Allocate (sizeof (struct TagBlock) + capacity * sizeof (struct TagData)));
+  block->count = 1;
+  block->size = 0;
+  block->capacity = capacity;
+  std::memset (block->index, 0, INDEX_SIZE);
+  return block;
+}
 
-  // trivial case when list is empty
-  if (m_next == 0)
+void
+PacketTagList::Reindex (struct TagBlock *block)
+{
+  std::memset (block->index, 0, INDEX_SIZE);
+  struct TagData *tags = block->GetTags ();
+  for (uint32_t i = 0; i < block->size; i++)
     {
-      return false;
+      uint8_t &slot = block->index[tags[i].tid.GetUid () % INDEX_SIZE];
+      slot = (slot == 0 && i + 1 < COLLISION) ? i + 1 : COLLISION;
     }
+}
 
-  bool found = false;
-
-  struct TagData ** prevNext = &m_next; // previous node's next pointer
-  struct TagData  * cur      =  m_next; // cursor to current node
-  struct TagData  * it = 0;             // utility
-
-  // Search from the head of the list until we find tid or a merge
-  while (cur != 0)
+void
+PacketTagList::Reserve (uint32_t capacity)
+{
+  if (m_block != 0 && m_block->count == 1 && m_block->capacity >= capacity)
     {
-      if (cur->count > 1)
-        {
-          // found merge
-          NS_LOG_INFO ("found initial merge before tid");
-          break;
-        }
-      else if (cur->tid == tid)
-        {
-          NS_LOG_INFO ("found tid before initial merge, calling writer");
-          found = (this->*Writer)(tag, true, cur, prevNext);
-          break;
-        }
-      else
+      return;
+    }
+  NS_LOG_FUNCTION (this << capacity);
+  uint32_t size = 0;
+  if (m_block != 0)
+    {
+      size = m_block->size;
+      if (m_block->capacity < capacity)
         {
-          // no merge or tid found yet, move on
-          prevNext = &cur->next;
-          cur      =  cur->next;
+          // grow geometrically
+          capacity = std::max (capacity, 2U * m_block->capacity);
         }
-    }  // while !found && !cow
-
-  // did we find it or run out of tags?
-  if (cur == 0 || found)
+    }
+  struct TagBlock *block = Allocate (capacity);
+  if (m_block != 0)
     {
-      NS_LOG_INFO ("returning after header with found: " << found);
-      return found;
+      block->size = size;
+      std::memcpy (block->index, m_block->index, INDEX_SIZE);
+      std::memcpy (static_cast<void *> (block->GetTags ()), m_block->GetTags (),
+                   size * sizeof (struct TagData));
+      Release (m_block);
     }
+  m_block = block;
+}
 
-  // From here on out, we have to copy the list
-  // until we find tid, then link past it
-
-  // Before we do all that work, let's make sure tid really exists
-  for (it = cur; it != 0; it = it->next)
+int32_t
+PacketTagList::Find (TypeId tid) const
+{
+  if (m_block == 0)
     {
-      if (it->tid == tid)
-        {
-          break;
-        }
+      return -1;
     }
-  if (it == 0)
+  uint8_t slot = m_block->index[tid.GetUid () % INDEX_SIZE];
+  if (slot == 0)
     {
-      // got to end of list without finding tid
-      NS_LOG_INFO ("tid not found after first merge");
-      return found;
+      return -1;
     }
-
-  // At this point cur is a merge, but untested for tid
-  NS_ASSERT (cur != 0);
-  NS_ASSERT (cur->count > 1);
-
-  /*
-     Walk the remainder of the list, copying, until we find tid
-     As we put a copy of the cur node onto our list,
-     we move the merge point down the list.
-
-     Starting position                  End position
-       T1 is a merge                     T1.count decremented
-                                         T2 is a merge
-                                         T1' is a copy of T1
-
-          other                             other
-               \                                 \
-      Prev  ->  T1  ->  T2  -> ...                T1  ->  T2  -> ...
-           /   /                                         /|
-      pNext cur                         Prev  ->  T1' --/ |
-                                                     /    |
-                                                pNext   cur
-
-     When we reach tid, we link past it, decrement count, and we're done.
-  */
-
-  // Should normally check for null cur pointer,
-  // but since we know tid exists, we'll skip this test
-  while ( /* cur && */ cur->tid != tid)
+  struct TagData *tags = m_block->GetTags ();
+  if (slot != COLLISION)
     {
-      NS_ASSERT (cur != 0);
-      NS_ASSERT (cur->count > 1);
-      cur->count--;                       // unmerge cur
-      struct TagData * copy = new struct TagData ();
-      copy->tid = cur->tid;
-      copy->count = 1;
-      memcpy (copy->data, cur->data, TagData::MAX_SIZE);
-      copy->next = cur->next;             // merge into tail
-      copy->next->count++;                // mark new merge
-      *prevNext = copy;                   // point prior list at copy
-      prevNext = &copy->next;             // advance
-      cur      =  copy->next;
+      return tags[slot - 1].tid == tid ? slot - 1 : -1;
     }
-  // Sanity check:
-  NS_ASSERT (cur != 0);                 // cur should be non-zero
-  NS_ASSERT (cur->tid == tid);          // cur->tid should be tid
-  NS_ASSERT (cur->count > 1);           // cur should be a merge
-
-  // link around tid, removing it from our list
-  found = (this->*Writer)(tag, false, cur, prevNext);
-  return found;
-
+  for (uint32_t i = 0; i < m_block->size; i++)
+    {
+      if (tags[i].tid == tid)
+        {
+          return i;
+        }
+    }
+  return -1;
 }
 
 bool
 PacketTagList::Remove (Tag & tag)
 {
-  return COWTraverse (tag, &PacketTagList::RemoveWriter);
-}
-
-// COWWriter implementing Remove
-bool
-PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
-                             struct PacketTagList::TagData  * cur,
-                             struct PacketTagList::TagData ** prevNext)
-{
-  NS_LOG_FUNCTION_NOARGS ();
-
-  // found tid
-  bool found = true;
-  tag.Deserialize (TagBuffer (cur->data,
-                              cur->data + TagData::MAX_SIZE));
-  *prevNext = cur->next;            // link around cur
-
-  if (preMerge)
+  TypeId tid = tag.GetInstanceTypeId ();
+  NS_LOG_FUNCTION (this << tid);
+  int32_t i = Find (tid);
+  if (i < 0)
+    {
+      NS_LOG_INFO ("tid not found");
+      return false;
+    }
+  struct TagData *tags = m_block->GetTags ();
+  tag.Deserialize (TagBuffer (tags[i].data,
+                              tags[i].data + TagData::MAX_SIZE));
+  if (m_block->size == 1)
     {
-      // found tid before first merge, so delete cur
-      delete cur;
+      RemoveAll ();
+      return true;
+    }
+  if (m_block->count > 1)
+    {
+      // copy all the other tags into a block of our own
+      NS_LOG_INFO ("block is shared, copying");
+      struct TagBlock *block = Allocate (m_block->size - 1);
+      std::memcpy (static_cast<void *> (block->GetTags ()), tags,
+                   i * sizeof (struct TagData));
+      std::memcpy (static_cast<void *> (block->GetTags () + i), tags + i + 1,
+                   (m_block->size - i - 1) * sizeof (struct TagData));
+      block->size = m_block->size - 1;
+      Release (m_block);
+      m_block = block;
     }
   else
     {
-      // cur is always a merge at this point
-      // unmerge cur, since we linked around it already
-      cur->count--;
-      if (cur->next != 0)
-        {
-          // there's a next, so make it a merge
-          cur->next->count++;
-        }
+      std::memmove (static_cast<void *> (tags + i), tags + i + 1,
+                    (m_block->size - i - 1) * sizeof (struct TagData));
+      m_block->size--;
     }
-  return found;
+  Reindex (m_block);
+  return true;
 }
 
 bool
 PacketTagList::Replace (Tag & tag)
 {
-  bool found = COWTraverse (tag, &PacketTagList::ReplaceWriter);
-  if (!found)
+  TypeId tid = tag.GetInstanceTypeId ();
+  NS_LOG_FUNCTION (this << tid);
+  int32_t i = Find (tid);
+  if (i < 0)
     {
       Add (tag);
+      return false;
     }
-  return found;
-}
-
-// COWWriter implementing Replace
-bool
-PacketTagList::ReplaceWriter (Tag & tag, bool preMerge,
-                              struct PacketTagList::TagData  * cur,
-                              struct PacketTagList::TagData ** prevNext)
-{
-  NS_LOG_FUNCTION_NOARGS ();
-
-  // found tid
-  bool found = true;
-  if (preMerge)
-    {
-      // found tid before first merge, so just rewrite
-      tag.Serialize (TagBuffer (cur->data,
-                                cur->data + tag.GetSerializedSize ()));
-    }
-  else
-    {
-      // cur is always a merge at this point
-      // need to copy, replace, and link past cur
-      cur->count--;                     // unmerge cur
-      struct TagData * copy = new struct TagData ();
-      copy->tid = tag.GetInstanceTypeId ();
-      copy->count = 1;
-      tag.Serialize (TagBuffer (copy->data,
-                                copy->data + tag.GetSerializedSize ()));
-      copy->next = cur->next;           // merge into tail
-      if (copy->next != 0)
-        {
-          copy->next->count++;          // mark new merge
-        }
-      *prevNext = copy;                 // point prior list at copy
-    }
-  return found;
+  // copy the block if shared
+  Reserve (m_block->size);
+  struct TagData *data = m_block->GetTags () + i;
+  NS_ASSERT (tag.GetSerializedSize () <= TagData::MAX_SIZE);
+  tag.Serialize (TagBuffer (data->data, data->data + tag.GetSerializedSize ()));
+  return true;
 }
 
 void 
 PacketTagList::Add (const Tag &tag) const
 {
-  NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
+  TypeId tid = tag.GetInstanceTypeId ();
+  NS_LOG_FUNCTION (this << tid);
   // ensure this id was not yet added
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
-    {
-      NS_ASSERT_MSG (cur->tid != tag.GetInstanceTypeId (), "Error: cannot add the same kind of tag twice.");
-    }
-  struct TagData * head = new struct TagData ();
-  head->count = 1;
-  head->next = 0;
-  head->tid = tag.GetInstanceTypeId ();
-  head->next = m_next;
+  NS_ASSERT_MSG (Find (tid) < 0, "Error: cannot add the same kind of tag twice.");
   NS_ASSERT (tag.GetSerializedSize () <= TagData::MAX_SIZE);
-  tag.Serialize (TagBuffer (head->data, head->data + tag.GetSerializedSize ()));
 
-  const_cast<PacketTagList *> (this)->m_next = head;
+  PacketTagList *self = const_cast<PacketTagList *> (this);
+  uint32_t size = m_block != 0 ? m_block->size : 0;
+  self->Reserve (size + 1);
+  struct TagBlock *block = self->m_block;
+  struct TagData *data = block->GetTags () + size;
+  data->tid = tid;
+  tag.Serialize (TagBuffer (data->data, data->data + tag.GetSerializedSize ()));
+  block->size++;
+  uint8_t &slot = block->index[tid.GetUid () % INDEX_SIZE];
+  slot = (slot == 0 && size + 1 < COLLISION) ? size + 1 : COLLISION;
 }
 
 bool
 PacketTagList::Peek (Tag &tag) const
 {
-  NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
   TypeId tid = tag.GetInstanceTypeId ();
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
+  NS_LOG_FUNCTION (this << tid);
+  int32_t i = Find (tid);
+  if (i < 0)
     {
-      if (cur->tid == tid) 
-        {
-          /* found tag */
-          tag.Deserialize (TagBuffer (cur->data, cur->data + TagData::MAX_SIZE));
-          return true;
-        }
+      /* no tag found */
+      return false;
     }
-  /* no tag found */
-  return false;
-}
-
-const struct PacketTagList::TagData *
-PacketTagList::Head (void) const
-{
-  return m_next;
+  /* found tag */
+  struct TagData *data = m_block->GetTags () + i;
+  tag.Deserialize (TagBuffer (data->data, data->data + TagData::MAX_SIZE));
+  return true;
 }
 
 } /* namespace ns3 */
-
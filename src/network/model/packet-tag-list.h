@@ -22,12 +22,15 @@
 
 /**
 \file   packet-tag-list.h
-\brief  Defines a linked list of Packet tags, including copy-on-write semantics.
+\brief  Defines a flat array of Packet tags, including copy-on-write semantics.
 */
 
 #include <stdint.h>
+#include <cstddef>
 #include <ostream>
 #include "ns3/type-id.h"
+#include "ns3/atomic-counter.h"
+#include "packet-arena.h"
 
 namespace ns3 {
 
@@ -43,94 +46,48 @@ class Tag;
  *
  * \internal
  *
- * The implementation of this class is a bit tricky.  Refer to this
- * diagram in the discussion that follows.
+ * The tags are stored in serialized form in a TagData array, which
+ * lives in a single TagBlock allocated from the PacketArena, after a
+ * small header:
  *
- * \dot
- *    digraph {
- *        rankdir = "LR";
- *        clusterrank = local;
- *        node [ shape = record, fontname="FreeSans", fontsize="10" ];
- *        oth  [ label="<l> Other branch | <n> next | <c> ..." ];
- *        PTL1 [ label="<l> PacketTagList A | <n> m_next" , shape=Mrecord];
- *        PTL2 [ label="<l> PacketTagList B | <n> m_next" , shape=Mrecord];
- *        oth:n  -> T7:l ;
- *        PTL2:n -> T6:l ;
- *        PTL1:n -> T5:l ;
- *        T1   [ label="<l> T1  | <n> next | <c> count = 1" ];
- *        T2   [ label="<l> T2  | <n> next | <c> count = 1" ];
- *        T3   [ label="<l> T3  | <n> next | <c> count = 2" ];
- *        T4   [ label="<l> T4  | <n> next | <c> count = 1" ];
- *        T5   [ label="<l> T5  | <n> next | <c> count = 2" ];
- *        T6   [ label="<l> T6  | <n> next | <c> count = 1" ];
- *        T7   [ label="<l> T7  | <n> next | <c> count = 1" ];
- *        NULL [ label="0", shape = ellipse ];
- *        subgraph cluster_list {
- *          penwidth = 0;
- *          T6:n -> T5:l ;
- *          T5:n -> T4:l ;
- *          T4:n -> T3:l ;
- *          T7:n -> T3:l ;
- *          T3:n -> T2:l ;
- *          T2:n -> T1:l ;
- *          T1:n -> NULL ;
- *        };
- *      };
- * \enddot
+ *   - \c count is the number of PacketTagList's sharing the block.
  *
- *   - Tags are stored in serialized form in a tree of TagData
- *     structures. (<tt>T1-T7</tt> in the diagram)
+ *   - \c size and \c capacity are the number of tags in the array and
+ *     the number of tags which fit in the block.  The first block
+ *     holds up to #INITIAL_CAPACITY tags, so that the handful of tags
+ *     carried by a packet live in one cache friendly allocation.
  *
- *   - Each TagData points (\c next pointers in the diagram)
- *     toward the root of the tree, which is a null pointer.
- *
- *   - \c count is the number of incoming pointers to this
- *     TagData.  Branch points, where branches merge or join, have
- *     <tt>count \> 1</tt> (\c T3, \c T5); successive links along
- *     a branch have <tt>count = 1</tt> (\c T1, \c T2, \c T4, \c T6, \c T7).
- *
- *   - Each PacketTagList points to a specific TagData,
- *     which is the most recent Tag added to the packet. (<tt>T5-T7</tt>)
- *
- *   - Conceptually, therefore, each Packet has a PacketTagList which
- *     points to a singly-linked list of TagData.
+ *   - \c index is a table indexed by the low bits of the TypeId uid
+ *     of the tags.  An empty slot means that no tag of this hash is
+ *     present, #COLLISION means that several tags share the slot, and
+ *     any other value is the position of the only such tag, plus one.
+ *     #Peek, #Remove and #Replace thus find or reject the common tags
+ *     in constant time, and only walk the array on collisions.
  *
  * \par <b> Copy-on-write </b> is implemented as follows:
  *
- *   - #Add prepends the new tag to the list (growing that branch of the tree,
- *     as \c T6). This is a constant time operation, and does not affect
- *     any other #PacketTagList's, hence this is a \c const function.
- *
  *   - Copy constructor (PacketTagList(const PacketTagList & o))
  *     and assignment (#operator=(const PacketTagList & o)
- *     simply join the tree at the same place as the original
- *     PacketTagList \c o, incrementing the \c count.
- *     For assignment, the old branch is deleted, up to
- *     the first branch point, which has its \c count decremented.
- *     (PacketTagList \c B started as a copy of PacketTagList \c A,
- *     before \c T6 was added to \c B).
+ *     share the block of \c o, incrementing the \c count.
+ *
+ *   - #Add, #Remove and #Replace modify the block in place when it is
+ *     not shared, and otherwise first copy it into a new block owned
+ *     by this list.  #Add appends the tag, and grows the block when
+ *     it is full.  #Add does not affect any other PacketTagList's,
+ *     hence this is a \c const function.
  *
- *   - #Remove and #Replace are a little tricky, depending on where the
- *     target tag is found relative to the first branch point:
- *     - \e Target before <em> the first branch point: </em> \n
- *       The target is just dealt with in place (linked around and deleted,
- *       in the case of #Remove; rewritten in the case of #Replace).
- *     - \e Target at or after <em> the first branch point: </em> \n
- *       The portion of the list between the first branch and the target is
- *       shared. This portion is copied before the #Remove or #Replace is
- *       performed.
+ *   - The tags are iterated from the most recent one, in the order in
+ *     which the former linked list implementation returned them.
  *
  * \par <b> Memory Management: </b>
  * \n
  * Packet tags must serialize to a finite maximum size, see TagData
- *
- * This documentation entitles the original author to a free beer.
  */
 class PacketTagList 
 {
 public:
   /**
-   * Tree node for sharing serialized tags.
+   * Serialized tag.
    *
    * See PacketTagList for a discussion of the data structure.
    *
@@ -146,15 +103,9 @@ public:
      * in this constant.
      *
      * \internal
-     * Ideally, TagData would be 32 bytes in size, so they require
-     * no padding on 64-bit architectures.  (The architecture
-     * affects the size because of the \c #next pointer.)
-     * This would leave 18 bytes for \c #data.  However,
-     * ns3:Ipv6PacketInfoTag needs 19 bytes!  The current
-     * implementation allows 20 bytes, which gives TagData
-     * a size of 30 bytes on 32-byte machines (which gets
-     * padded with 2 bytes), and 34 bytes on 64-bit machines, which
-     * gets padded to 40 bytes.
+     * ns3:Ipv6PacketInfoTag needs 19 bytes.  The current
+     * implementation allows 21 bytes, which, with the 2 bytes
+     * of \c #tid, gives TagData a size of 24 bytes.
      */
     enum TagData_e
     {
@@ -162,9 +113,7 @@ public:
   };
 
     uint8_t data[MAX_SIZE];   /**< Serialization buffer */
-    struct TagData * next;   /**< Pointer to next in list */
     TypeId tid;               /**< Type of the tag serialized into #data */
-    uint32_t count;           /**< Number of incoming links */
   };  /* struct TagData */
 
   /**
@@ -176,8 +125,8 @@ public:
    *
    * \param [in] o The PacketTagList to copy.
    *
-   * This makes a light-weight copy by #RemoveAll, then
-   * pointing to the same \ref TagData as \pname{o}.
+   * This makes a light-weight copy by sharing the \ref TagData
+   * of \pname{o}.
    */
   inline PacketTagList (PacketTagList const &o);
   /**
@@ -187,24 +136,24 @@ public:
    * \returns the copied object
    *
    * This makes a light-weight copy by #RemoveAll, then
-   * pointing to the same \ref TagData as \pname{o}.
+   * sharing the \ref TagData of \pname{o}.
    */
   inline PacketTagList &operator = (PacketTagList const &o);
   /**
    * Destructor
    *
-   * #RemoveAll's the tags up to the first merge.
+   * #RemoveAll's the tags.
    */
   inline ~PacketTagList ();
 
   /**
-   * Add a tag to the head of this branch.
+   * Add a tag to the list.
    *
    * \param [in] tag The tag to add
    */
   void Add (Tag const&tag) const;
   /**
-   * Remove (the first instance of) tag from the list.
+   * Remove tag from the list.
    *
    * \param [in,out] tag The tag type to remove.  If found,
    *          \pname{tag} is set to the value of the tag found.
@@ -230,67 +179,77 @@ public:
    */
   bool Peek (Tag &tag) const;
   /**
-   * Remove all tags from this list (up to the first merge).
+   * Remove all tags from this list.
    */
   inline void RemoveAll (void);
   /**
-   * \returns pointer to head of tag list
+   * \returns pointer to the first (oldest) tag of the list
+   */
+  inline const struct PacketTagList::TagData *Begin (void) const;
+  /**
+   * \returns pointer past the last (most recent) tag of the list
    */
-  const struct PacketTagList::TagData *Head (void) const;
+  inline const struct PacketTagList::TagData *End (void) const;
 
 private:
+  /** Sizes of the tag blocks. */
+  enum TagBlock_e
+  {
+    INITIAL_CAPACITY = 4,     /**< Number of tags of the first block */
+    INDEX_SIZE = 16,          /**< Number of slots of the index */
+    COLLISION = 0xff          /**< Index slot shared by several tags */
+  };
+
   /**
-   * Typedef of method function pointer for copy-on-write operations
-   *
-   * \param [in] tag The tag type to operate on.
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *             false otherwise.
-   * \param [in] cur Pointer to the tag.
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True if operation successful, false otherwise
+   * Header of the block holding the tags, which follow it.
+   */
+  struct TagBlock
+  {
+    uint32_t count;               /**< Number of lists sharing the block */
+    uint16_t size;                /**< Number of tags */
+    uint16_t capacity;            /**< Number of tags which fit in the block */
+    uint8_t index[INDEX_SIZE];    /**< Position plus one of the tag of each uid hash */
+
+    /** \returns the tags stored after the header. */
+    inline struct TagData *GetTags (void);
+  };
+
+  /**
+   * \param [in] tid The type of a tag.
+   * \returns The position of the tag in the block, or -1 if not found.
    */
-  typedef bool (PacketTagList::*COWWriter)
-    (Tag       & tag, bool         preMerge,
-    struct TagData * cur, struct TagData ** prevNext);
+  int32_t Find (TypeId tid) const;
   /**
-   * Traverse the list implementing copy-on-write, using \pname{Writer}.
+   * Make sure that this list owns its block, and that the block can
+   * hold \pname{capacity} tags.
    *
-   * \param [in] tag The tag type to operate on.
-   * \param [in] Writer The copy-on-write function to use.
-   * \returns True if \pname{tag} found, false otherwise.
+   * \param [in] capacity The number of tags needed.
    */
-  bool COWTraverse   (Tag & tag, PacketTagList::COWWriter Writer);
+  void Reserve (uint32_t capacity);
   /**
-   * Copy-on-write implementing Remove.
+   * Rebuild the index of the block.
    *
-   * \param [in] tag The target tag type to remove.
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *             false otherwise.
-   * \param [in] cur Pointer to the tag.
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True, since tag will definitely be removed.
+   * \param [in] block The block to index.
    */
-  bool RemoveWriter  (Tag       & tag, bool         preMerge,
-                      struct TagData * cur, struct TagData ** prevNext);
+  static void Reindex (struct TagBlock * block);
   /**
-   * Copy-on-write implementing Replace
+   * \param [in] capacity The number of tags needed.
+   * \returns A new block with a count of one, no tags and at least
+   *          \pname{capacity} slots.
+   */
+  static struct TagBlock * Allocate (uint32_t capacity);
+  /**
+   * Drop one reference to \pname{block}, and release it to the
+   * PacketArena if no other list shares it.
    *
-   * \param [in] tag The target tag type to replace
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *          false otherwise.
-   * \param [in] cur Pointer to the tag
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True, since tag value will definitely be replaced.
+   * \param [in] block Pointer to the block.
    */
-  bool ReplaceWriter (Tag & tag, bool preMerge, struct TagData * cur, struct TagData ** prevNext);
+  static inline void Release (struct TagBlock * block);
 
   /**
-   * Pointer to first \ref TagData on the list
+   * Pointer to the block holding the tags, or 0 if the list is empty
    */
-  struct TagData *m_next;
+  struct TagBlock *m_block;
 };
 
 } // namespace ns3
@@ -301,17 +260,23 @@ private:
 
 namespace ns3 {
 
+struct PacketTagList::TagData *
+PacketTagList::TagBlock::GetTags (void)
+{
+  return reinterpret_cast<struct TagData *> (this + 1);
+}
+
 PacketTagList::PacketTagList ()
-  : m_next ()
+  : m_block (0)
 {
 }
 
 PacketTagList::PacketTagList (PacketTagList const &o)
-  : m_next (o.m_next)
+  : m_block (o.m_block)
 {
-  if (m_next != 0)
+  if (m_block != 0)
     {
-      m_next->count++;
+      AtomicIncrement (m_block->count);
     }
 }
 
@@ -319,15 +284,15 @@ PacketTagList &
 PacketTagList::operator = (PacketTagList const &o)
 {
   // self assignment
-  if (m_next == o.m_next) 
+  if (m_block == o.m_block) 
     {
       return *this;
     }
   RemoveAll ();
-  m_next = o.m_next;
-  if (m_next != 0) 
+  m_block = o.m_block;
+  if (m_block != 0) 
     {
-      m_next->count++;
+      AtomicIncrement (m_block->count);
     }
   return *this;
 }
@@ -340,25 +305,33 @@ PacketTagList::~PacketTagList ()
 void
 PacketTagList::RemoveAll (void)
 {
-  struct TagData *prev = 0;
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
+  if (m_block != 0)
     {
-      cur->count--;
-      if (cur->count > 0) 
-        {
-          break;
-        }
-      if (prev != 0) 
-        {
-	  delete prev;
-        }
-      prev = cur;
+      Release (m_block);
+      m_block = 0;
     }
-  if (prev != 0) 
+}
+
+const struct PacketTagList::TagData *
+PacketTagList::Begin (void) const
+{
+  return m_block != 0 ? m_block->GetTags () : 0;
+}
+
+const struct PacketTagList::TagData *
+PacketTagList::End (void) const
+{
+  return m_block != 0 ? m_block->GetTags () + m_block->size : 0;
+}
+
+void
+PacketTagList::Release (struct TagBlock *block)
+{
+  if (AtomicDecrement (block->count) == 0)
     {
-      delete prev;
+      PacketArena::Deallocate (block, sizeof (struct TagBlock)
+                               + block->capacity * sizeof (struct TagData));
     }
-  m_next = 0;
 }
 
 } // namespace ns3
@@ -169,10 +169,13 @@ private:
   friend class Packet;
   /**
    * Constructor
-   * \param head head of the items
+   * \param begin first (oldest) item
+   * \param end past the last (most recent) item
    */
-  PacketTagIterator (const struct PacketTagList::TagData *head);
-  const struct PacketTagList::TagData *m_current;  //!< actual position over the set of tags in a packet
+  PacketTagIterator (const struct PacketTagList::TagData *begin,
+                     const struct PacketTagList::TagData *end);
+  const struct PacketTagList::TagData *m_begin;  //!< first item of the set of tags in a packet
+  const struct PacketTagList::TagData *m_current;  //!< past the next item of the set of tags in a packet
 };
 
 /**
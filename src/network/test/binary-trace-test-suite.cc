@@ -0,0 +1,263 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/binary-trace.h"
+#include <fstream>
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * \param i A record index.
+ * \returns The record written at this index by the tests.
+ */
+static BinaryTraceRecord
+MakeRecord (uint32_t i)
+{
+  BinaryTraceRecord record;
+  // mostly increasing times, with a step back every 100 records
+  record.time = 1000000000LL + i * 12345LL - (i % 100 == 99 ? 50000 : 0);
+  record.node = i % 100;
+  record.device = i % 3;
+  record.event = i % 5;
+  record.size = (i * 97) % 70000;
+  record.mcs = i % 7 == 0 ? BinaryTraceRecord::NONE : i % 25;
+  record.sector = i % 32;
+  record.snr = (i % 40) * 0.5f - 3;
+  return record;
+}
+
+/**
+ * Write a binary trace and read it back.
+ */
+class BinaryTraceRoundTripTestCase : public TestCase
+{
+public:
+  /**
+   * \param threaded Write from a background thread.
+   */
+  BinaryTraceRoundTripTestCase (bool threaded);
+
+private:
+  virtual void DoRun (void);
+  bool m_threaded; //!< Write from a background thread
+};
+
+BinaryTraceRoundTripTestCase::BinaryTraceRoundTripTestCase (bool threaded)
+  : TestCase (threaded ? "Check a binary trace written by the writer thread"
+              : "Check a binary trace written synchronously"),
+    m_threaded (threaded)
+{
+}
+
+void
+BinaryTraceRoundTripTestCase::DoRun (void)
+{
+  const uint32_t n = 10000;
+  std::string filename = CreateTempDirFilename ("trace.bin");
+  Ptr<BinaryTraceWriter> writer = Create<BinaryTraceWriter> ();
+  NS_TEST_ASSERT_MSG_EQ (writer->Open (filename, 1000, m_threaded), true, "Open failed");
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      writer->Write (MakeRecord (i));
+    }
+  writer->Close ();
+  NS_TEST_ASSERT_MSG_EQ (writer->Fail (), false, "Write failed");
+
+  std::ifstream file (filename.c_str (), std::ios::binary | std::ios::ate);
+  uint64_t size = file.tellg ();
+  NS_TEST_EXPECT_MSG_LT (size, n * 16, "The records are not compact");
+
+  BinaryTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Cannot read the trace");
+  BinaryTraceRecord record;
+  uint32_t count = 0;
+  while (reader.Read (record))
+    {
+      BinaryTraceRecord expected = MakeRecord (count);
+      NS_TEST_ASSERT_MSG_EQ (record.time, expected.time, "Wrong time of record " << count);
+      NS_TEST_ASSERT_MSG_EQ (record.node, expected.node, "Wrong node of record " << count);
+      NS_TEST_ASSERT_MSG_EQ (record.device, expected.device, "Wrong device of record " << count);
+      NS_TEST_ASSERT_MSG_EQ (uint32_t (record.event), uint32_t (expected.event), "Wrong event of record " << count);
+      NS_TEST_ASSERT_MSG_EQ (record.size, expected.size, "Wrong size of record " << count);
+      NS_TEST_ASSERT_MSG_EQ (uint32_t (record.mcs), uint32_t (expected.mcs), "Wrong MCS of record " << count);
+      NS_TEST_ASSERT_MSG_EQ (uint32_t (record.sector), uint32_t (expected.sector), "Wrong sector of record " << count);
+      NS_TEST_ASSERT_MSG_EQ (record.snr, expected.snr, "Wrong SNR of record " << count);
+      count++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (reader.Fail (), false, "Corrupted trace");
+  NS_TEST_EXPECT_MSG_EQ (count, n, "Wrong number of records");
+
+  // the same records, by column
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Cannot read the trace again");
+  BinaryTraceChunk chunk;
+  uint32_t chunks = 0;
+  uint64_t bytes = 0;
+  while (reader.ReadChunk (chunk))
+    {
+      NS_TEST_EXPECT_MSG_EQ (chunk.GetN (), 1000, "Wrong number of records in chunk " << chunks);
+      for (uint32_t i = 0; i < chunk.GetN (); ++i)
+        {
+          bytes += chunk.size[i];
+        }
+      chunks++;
+    }
+  uint64_t expectedBytes = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      expectedBytes += MakeRecord (i).size;
+    }
+  NS_TEST_EXPECT_MSG_EQ (chunks, 10, "Wrong number of chunks");
+  NS_TEST_EXPECT_MSG_EQ (bytes, expectedBytes, "Wrong size column");
+}
+
+/**
+ * Check that a truncated binary trace is detected.
+ */
+class BinaryTraceTruncatedTestCase : public TestCase
+{
+public:
+  BinaryTraceTruncatedTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BinaryTraceTruncatedTestCase::BinaryTraceTruncatedTestCase ()
+  : TestCase ("Check that a truncated binary trace is detected")
+{
+}
+
+void
+BinaryTraceTruncatedTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("trace.bin");
+  Ptr<BinaryTraceWriter> writer = Create<BinaryTraceWriter> ();
+  NS_TEST_ASSERT_MSG_EQ (writer->Open (filename, 100, false), true, "Open failed");
+  for (uint32_t i = 0; i < 150; ++i)
+    {
+      writer->Write (MakeRecord (i));
+    }
+  writer = 0;
+
+  std::ostringstream content;
+  std::ifstream in (filename.c_str (), std::ios::binary);
+  content << in.rdbuf ();
+  in.close ();
+  std::string truncated = content.str ().substr (0, content.str ().size () - 10);
+  std::ofstream out (filename.c_str (), std::ios::binary | std::ios::trunc);
+  out << truncated;
+  out.close ();
+
+  BinaryTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Cannot read the trace");
+  BinaryTraceChunk chunk;
+  NS_TEST_EXPECT_MSG_EQ (reader.ReadChunk (chunk), true, "First chunk not read");
+  NS_TEST_EXPECT_MSG_EQ (chunk.GetN (), 100, "Wrong first chunk");
+  NS_TEST_EXPECT_MSG_EQ (reader.ReadChunk (chunk), false, "Truncated chunk read");
+  NS_TEST_EXPECT_MSG_EQ (reader.Fail (), true, "Truncation not detected");
+}
+
+/**
+ * Check that a chunk header announcing more data than the file holds
+ * is detected before anything is allocated from it.
+ */
+class BinaryTraceCorruptedHeaderTestCase : public TestCase
+{
+public:
+  BinaryTraceCorruptedHeaderTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Write a trace made of a single chunk header and some bytes.
+   * \param filename The name of the file.
+   * \param n The number of records in the header.
+   * \param size The number of bytes in the header.
+   * \param bytes The number of bytes following the header.
+   */
+  void WriteTrace (std::string const &filename, uint32_t n, uint32_t size, uint32_t bytes);
+};
+
+BinaryTraceCorruptedHeaderTestCase::BinaryTraceCorruptedHeaderTestCase ()
+  : TestCase ("Check that a corrupted chunk header is detected")
+{
+}
+
+void
+BinaryTraceCorruptedHeaderTestCase::WriteTrace (std::string const &filename, uint32_t n,
+                                                uint32_t size, uint32_t bytes)
+{
+  std::ofstream out (filename.c_str (), std::ios::binary | std::ios::trunc);
+  uint32_t magic = BinaryTraceWriter::MAGIC;
+  uint16_t version[2] = { BinaryTraceWriter::VERSION, 0 };
+  uint32_t header[2] = { n, size };
+  out.write (reinterpret_cast<char const *> (&magic), sizeof (magic));
+  out.write (reinterpret_cast<char const *> (version), sizeof (version));
+  out.write (reinterpret_cast<char const *> (header), sizeof (header));
+  out << std::string (bytes, '\0');
+  out.close ();
+}
+
+void
+BinaryTraceCorruptedHeaderTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("trace.bin");
+  BinaryTraceChunk chunk;
+
+  // a size much larger than the file
+  WriteTrace (filename, 1000, 0xfffffff0, 64);
+  BinaryTraceReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Cannot read the trace");
+  NS_TEST_EXPECT_MSG_EQ (reader.ReadChunk (chunk), false, "Oversized chunk read");
+  NS_TEST_EXPECT_MSG_EQ (reader.Fail (), true, "Oversized chunk not detected");
+
+  // more records than the bytes of the chunk can hold
+  WriteTrace (filename, 0xfffffff0, 64, 64);
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Cannot read the trace");
+  NS_TEST_EXPECT_MSG_EQ (reader.ReadChunk (chunk), false, "Impossible chunk read");
+  NS_TEST_EXPECT_MSG_EQ (reader.Fail (), true, "Impossible chunk not detected");
+  NS_TEST_EXPECT_MSG_EQ (chunk.GetN (), 0, "Records allocated from a corrupted header");
+
+  // a header cut in the middle
+  WriteTrace (filename, 1, 16, 0);
+  std::ostringstream content;
+  std::ifstream in (filename.c_str (), std::ios::binary);
+  content << in.rdbuf ();
+  in.close ();
+  std::ofstream out (filename.c_str (), std::ios::binary | std::ios::trunc);
+  out << content.str ().substr (0, content.str ().size () - 4);
+  out.close ();
+  NS_TEST_ASSERT_MSG_EQ (reader.Open (filename), true, "Cannot read the trace");
+  NS_TEST_EXPECT_MSG_EQ (reader.ReadChunk (chunk), false, "Truncated header read");
+  NS_TEST_EXPECT_MSG_EQ (reader.Fail (), true, "Truncated header not detected");
+}
+
+class BinaryTraceTestSuite : public TestSuite
+{
+public:
+  BinaryTraceTestSuite ()
+    : TestSuite ("binary-trace", UNIT)
+  {
+    AddTestCase (new BinaryTraceRoundTripTestCase (false), TestCase::QUICK);
+    AddTestCase (new BinaryTraceRoundTripTestCase (true), TestCase::QUICK);
+    AddTestCase (new BinaryTraceTruncatedTestCase (), TestCase::QUICK);
+    AddTestCase (new BinaryTraceCorruptedHeaderTestCase (), TestCase::QUICK);
+  }
+};
+
+static BinaryTraceTestSuite g_binaryTraceTestSuite;
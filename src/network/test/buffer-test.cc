@@ -22,6 +22,8 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/double.h"
 #include "ns3/test.h"
+#include <sstream>
+#include <vector>
 
 using namespace ns3;
 
@@ -361,6 +363,190 @@ BufferTest::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (val1, val2, "Bad ReadNtohU16()");
 }
 //-----------------------------------------------------------------------------
+/**
+ * Check that the virtual zero area of the buffers is kept virtual by
+ * the usual packet operations.
+ */
+class BufferZeroAreaTest : public TestCase
+{
+public:
+  BufferZeroAreaTest ();
+private:
+  virtual void DoRun (void);
+  /**
+   * \param size the size of the zero area.
+   * \returns a buffer with a zero area framed by a header and a trailer.
+   */
+  Buffer MakeFrame (uint32_t size);
+  /**
+   * \param b a buffer.
+   * \returns the content of the buffer.
+   */
+  std::vector<uint8_t> GetContent (const Buffer &b);
+};
+
+BufferZeroAreaTest::BufferZeroAreaTest ()
+  : TestCase ("Check that the zero area of the buffers stays virtual")
+{
+}
+
+Buffer
+BufferZeroAreaTest::MakeFrame (uint32_t size)
+{
+  Buffer b (size);
+  b.AddAtStart (4);
+  b.Begin ().WriteHtonU32 (0xdeadbeef);
+  b.AddAtEnd (2);
+  Buffer::Iterator i = b.End ();
+  i.Prev (2);
+  i.WriteU16 (0xabcd);
+  return b;
+}
+
+std::vector<uint8_t>
+BufferZeroAreaTest::GetContent (const Buffer &b)
+{
+  std::vector<uint8_t> content (b.GetSize ());
+  if (!content.empty ())
+    {
+      b.CopyData (&content[0], content.size ());
+    }
+  return content;
+}
+
+void
+BufferZeroAreaTest::DoRun (void)
+{
+  uint64_t start = Buffer::GetMaterializedZeroBytes ();
+
+  // copies, fragments and stream output
+  Buffer frame = MakeFrame (7000);
+  std::vector<uint8_t> frameContent = GetContent (frame);
+  Buffer copy = frame;
+  copy.AddAtStart (10);
+  Buffer fragment = frame.CreateFragment (100, 3000);
+  std::ostringstream os;
+  frame.CopyData (&os, frame.GetSize ());
+  NS_TEST_EXPECT_MSG_EQ (os.str ().size (), 7006, "Wrong stream output");
+  NS_TEST_EXPECT_MSG_EQ (Buffer::GetMaterializedZeroBytes () - start, 0, "Zero area written into memory");
+
+  // appending real bytes keeps the zero area virtual
+  Buffer head;
+  head.AddAtStart (8);
+  head.Begin ().WriteHtonU64 (0x0102030405060708ULL);
+  Buffer aggregate = head;
+  aggregate.AddAtEnd (frame);
+  Buffer padding = frame;
+  padding.AddAtEnd (head);
+  NS_TEST_EXPECT_MSG_EQ (Buffer::GetMaterializedZeroBytes () - start, 0, "Zero area written into memory");
+  std::vector<uint8_t> expected = GetContent (head);
+  expected.insert (expected.end (), frameContent.begin (), frameContent.end ());
+  NS_TEST_EXPECT_MSG_EQ ((GetContent (aggregate) == expected), true, "Wrong content after prepending bytes");
+  expected = frameContent;
+  std::vector<uint8_t> headContent = GetContent (head);
+  expected.insert (expected.end (), headContent.begin (), headContent.end ());
+  NS_TEST_EXPECT_MSG_EQ ((GetContent (padding) == expected), true, "Wrong content after appending bytes");
+
+  // only the smaller of two zero areas is written into memory
+  Buffer small = MakeFrame (500);
+  std::vector<uint8_t> smallContent = GetContent (small);
+  Buffer first = small;
+  first.AddAtEnd (frame);
+  NS_TEST_EXPECT_MSG_EQ (Buffer::GetMaterializedZeroBytes () - start, 500, "Wrong zero area written into memory");
+  expected = smallContent;
+  expected.insert (expected.end (), frameContent.begin (), frameContent.end ());
+  NS_TEST_EXPECT_MSG_EQ ((GetContent (first) == expected), true, "Wrong content after aggregation");
+  Buffer second = frame;
+  second.AddAtEnd (small);
+  NS_TEST_EXPECT_MSG_EQ (Buffer::GetMaterializedZeroBytes () - start, 1000, "Wrong zero area written into memory");
+  expected = frameContent;
+  expected.insert (expected.end (), smallContent.begin (), smallContent.end ());
+  NS_TEST_EXPECT_MSG_EQ ((GetContent (second) == expected), true, "Wrong content after aggregation");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Check the checksums of buffers made of real bytes and of a zero area,
+ * from every parity of start and size, against a byte by byte sum.
+ */
+class BufferChecksumTest : public TestCase
+{
+public:
+  BufferChecksumTest ();
+private:
+  virtual void DoRun (void);
+  /**
+   * \param content the bytes.
+   * \param start the offset of the first byte summed.
+   * \param size the number of bytes summed.
+   * \returns the checksum computed byte by byte.
+   */
+  uint16_t Reference (const std::vector<uint8_t> &content, uint32_t start, uint32_t size);
+};
+
+BufferChecksumTest::BufferChecksumTest ()
+  : TestCase ("Check the checksums of the buffers")
+{
+}
+
+uint16_t
+BufferChecksumTest::Reference (const std::vector<uint8_t> &content, uint32_t start, uint32_t size)
+{
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < size; i++)
+    {
+      sum += (i & 1) ? (content[start + i] << 8) : content[start + i];
+    }
+  while (sum >> 16)
+    {
+      sum = (sum & 0xffff) + (sum >> 16);
+    }
+  return ~sum;
+}
+
+void
+BufferChecksumTest::DoRun (void)
+{
+  Ptr<UniformRandomVariable> rand = CreateObject<UniformRandomVariable> ();
+  // A header and a trailer of odd sizes around a zero area
+  Buffer b (1001);
+  b.AddAtStart (77);
+  Buffer::Iterator i = b.Begin ();
+  for (uint32_t k = 0; k < 77; k++)
+    {
+      i.WriteU8 (rand->GetInteger (0, 255));
+    }
+  b.AddAtEnd (133);
+  i = b.End ();
+  i.Prev (133);
+  for (uint32_t k = 0; k < 133; k++)
+    {
+      i.WriteU8 (rand->GetInteger (0, 255));
+    }
+  std::vector<uint8_t> content (b.GetSize ());
+  b.CopyData (&content[0], content.size ());
+
+  uint32_t starts[] = { 0, 1, 2, 3, 40, 76, 77, 78, 1077, 1078, 1100 };
+  for (uint32_t s = 0; s < sizeof (starts) / sizeof (starts[0]); s++)
+    {
+      for (uint32_t size = 0; starts[s] + size <= b.GetSize (); size += 1 + size / 4)
+        {
+          i = b.Begin ();
+          i.Next (starts[s]);
+          uint16_t checksum = i.CalculateIpChecksum (size);
+          NS_TEST_EXPECT_MSG_EQ (checksum, Reference (content, starts[s], size),
+                                 "Wrong checksum of " << size << " bytes from " << starts[s]);
+          NS_TEST_EXPECT_MSG_EQ (i.GetDistanceFrom (b.Begin ()), starts[s] + size, "Wrong position after the checksum");
+        }
+    }
+
+  // The initial value is added
+  i = b.Begin ();
+  uint16_t half = ~i.CalculateIpChecksum (100);
+  uint16_t whole = i.CalculateIpChecksum (1000, half);
+  NS_TEST_EXPECT_MSG_EQ (whole, Reference (content, 0, 1100), "Wrong checksum with an initial value");
+}
+
 class BufferTestSuite : public TestSuite
 {
 public:
@@ -371,6 +557,8 @@ BufferTestSuite::BufferTestSuite ()
   : TestSuite ("buffer", UNIT)
 {
   AddTestCase (new BufferTest, TestCase::QUICK);
+  AddTestCase (new BufferZeroAreaTest, TestCase::QUICK);
+  AddTestCase (new BufferChecksumTest, TestCase::QUICK);
 }
 
 static BufferTestSuite g_bufferTestSuite;
@@ -19,6 +19,7 @@
  */
 #include "ns3/packet.h"
 #include "ns3/packet-tag-list.h"
+#include "ns3/packet-arena.h"
 #include "ns3/test.h"
 #include "ns3/unused.h"
 #include <limits>     // std:numeric_limits
@@ -806,6 +807,37 @@ PacketTagListTest::DoRun (void)
     ReplaceCheck (7);
   }
   
+  { // More tags than the first block and the index slots hold
+    std::cout << GetName () << "check a long list" << std::endl;
+#   define LONG_TAGS(X)                                          \
+    X (11) X (12) X (13) X (14) X (15) X (16) X (17) X (18) X (19) X (20)
+#   define AddLong(n)  { ATestTag<n> t (n); ptl.Add (t); }
+#   define PeekLong(n) { ATestTag<n> t (n); CheckRef (ptl, t, "long " #n); }
+#   define MissLong(n) { ATestTag<n> t (n); CheckRef (ref, t, "long orig " #n, true); }
+    PacketTagList ptl = ref;
+    LONG_TAGS (AddLong);
+    CheckRefList (ptl, "long copy");
+    LONG_TAGS (PeekLong);
+    CheckRefList (ref, "long orig");
+    LONG_TAGS (MissLong);
+
+    PacketTagList cpy = ptl;
+    ATestTag<15> t15;
+    NS_TEST_EXPECT_MSG_EQ (cpy.Remove (t15), true, "remove from a long list");
+    NS_TEST_EXPECT_MSG_EQ (t15.GetData (), 15, "value of the removed tag");
+    NS_TEST_EXPECT_MSG_EQ (cpy.Peek (t15), false, "removed tag");
+    NS_TEST_EXPECT_MSG_EQ (ptl.Peek (t15), true, "tag removed from the original");
+    cpy.Remove (t4);
+    CheckRefList (cpy, "long copy after removals", 4);
+    CheckRefList (ptl, "long orig after removals");
+    NS_TEST_EXPECT_MSG_EQ (ptl.End () - ptl.Begin (), 17, "long list size");
+    NS_TEST_EXPECT_MSG_EQ (cpy.End () - cpy.Begin (), 15, "long copy size");
+#   undef MissLong
+#   undef PeekLong
+#   undef AddLong
+#   undef LONG_TAGS
+  }
+
   { // Timing
     std::cout << GetName () << "add+remove timing" << std::endl;
     int flm = std::numeric_limits<int>::max ();
@@ -847,6 +879,75 @@ PacketTagListTest::DoRun (void)
     
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Check that the packet memory goes through the PacketArena and is
+ * reused by the next packets.
+ */
+class PacketArenaTest : public TestCase
+{
+public:
+  PacketArenaTest ();
+private:
+  void DoRun (void);
+  /**
+   * Create, copy, tag and fragment a few packets, then release them.
+   */
+  void Churn (void);
+};
+
+PacketArenaTest::PacketArenaTest ()
+  : TestCase ("Check the packet arena statistics")
+{
+}
+
+void
+PacketArenaTest::Churn (void)
+{
+  std::vector<Ptr<Packet> > packets;
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (1000 + i);
+      p->AddHeader (ATestHeader<10> ());
+      p->AddPacketTag (ATestTag<2> ());
+      p->AddByteTag (ATestTag<3> ());
+      Ptr<Packet> copy = p->Copy ();
+      copy->AddTrailer (ATestTrailer<4> ());
+      packets.push_back (copy);
+      packets.push_back (p->CreateFragment (0, 500));
+    }
+}
+
+void
+PacketArenaTest::DoRun (void)
+{
+#ifndef NS3_MTP
+  PacketArena::Reset ();
+  PacketArena::Stats before = PacketArena::GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (before.cachedBytes, 0, "Reset did not release the free lists");
+  NS_TEST_EXPECT_MSG_EQ (before.peakBytes, before.liveBytes, "Reset did not restart the peak");
+
+  Churn ();
+  PacketArena::Stats first = PacketArena::GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (first.liveObjects, before.liveObjects, "Packet memory was not released");
+  NS_TEST_EXPECT_MSG_EQ (first.liveBytes, before.liveBytes, "Packet memory was not released");
+  NS_TEST_EXPECT_MSG_GT (first.allocations, 80, "Too few allocations");
+  // the payload is a virtual zero area, which takes no memory
+  NS_TEST_EXPECT_MSG_GT (first.peakBytes, before.liveBytes, "Peak does not include the packets");
+  NS_TEST_EXPECT_MSG_GT (first.cachedBytes, 0, "Nothing was cached");
+
+  Churn ();
+  PacketArena::Stats second = PacketArena::GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (second.liveBytes, before.liveBytes, "Packet memory was not released");
+  // the metadata blocks may grow to the largest size seen in the first round
+  NS_TEST_EXPECT_MSG_GT (10 * (second.reuses - first.reuses), 9 * (second.allocations - first.allocations),
+                         "The second round did not reuse the blocks");
+
+  PacketArena::Reset ();
+  NS_TEST_EXPECT_MSG_EQ (PacketArena::GetStats ().cachedBytes, 0, "Reset did not release the free lists");
+#endif /* NS3_MTP */
+}
+
 //-----------------------------------------------------------------------------
 class PacketTestSuite : public TestSuite
 {
@@ -859,6 +960,7 @@ PacketTestSuite::PacketTestSuite ()
 {
   AddTestCase (new PacketTest, TestCase::QUICK);
   AddTestCase (new PacketTagListTest, TestCase::QUICK);
+  AddTestCase (new PacketArenaTest, TestCase::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite;
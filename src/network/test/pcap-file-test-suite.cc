@@ -25,6 +25,11 @@
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/pcap-file.h"
+#include "ns3/pcapng-file.h"
+#include "ns3/packet.h"
+#include "ns3/header.h"
+#include "ns3/nstime.h"
+#include <fstream>
 
 using namespace ns3;
 
@@ -1121,6 +1126,244 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+// ===========================================================================
+// A header written before the packets by the buffered write tests.
+// ===========================================================================
+class PcapFileTestHeader : public Header
+{
+public:
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+  virtual void Print (std::ostream &os) const;
+  uint8_t m_value; //!< Value of the header bytes
+};
+
+TypeId
+PcapFileTestHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("PcapFileTestHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Network")
+  ;
+  return tid;
+}
+
+TypeId
+PcapFileTestHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+PcapFileTestHeader::GetSerializedSize (void) const
+{
+  return 24;
+}
+
+void
+PcapFileTestHeader::Serialize (Buffer::Iterator start) const
+{
+  for (uint32_t i = 0; i < GetSerializedSize (); ++i)
+    {
+      start.WriteU8 (m_value + i);
+    }
+}
+
+uint32_t
+PcapFileTestHeader::Deserialize (Buffer::Iterator start)
+{
+  return GetSerializedSize ();
+}
+
+void
+PcapFileTestHeader::Print (std::ostream &os) const
+{
+}
+
+/**
+ * \param filename A file name.
+ * \returns The content of the file.
+ */
+static std::string
+ReadFileContent (std::string filename)
+{
+  std::ifstream file (filename.c_str (), std::ios::binary);
+  std::ostringstream content;
+  content << file.rdbuf ();
+  return content.str ();
+}
+
+// ===========================================================================
+// Test case to make sure that the buffered output, with or without the
+// writer thread, writes the same bytes as the unbuffered output.
+// ===========================================================================
+class BufferedWriteTestCase : public TestCase
+{
+public:
+  BufferedWriteTestCase ();
+
+private:
+  /**
+   * Write the same records into a file.
+   * \param f The file, open for output.
+   */
+  void WriteRecords (PcapFile &f);
+  virtual void DoRun (void);
+};
+
+BufferedWriteTestCase::BufferedWriteTestCase ()
+  : TestCase ("Check that buffered and asynchronous writes match the unbuffered file")
+{
+}
+
+void
+BufferedWriteTestCase::WriteRecords (PcapFile &f)
+{
+  f.Init (1, 200);
+  uint8_t data[300];
+  for (uint32_t i = 0; i < sizeof (data); ++i)
+    {
+      data[i] = i;
+    }
+  PcapFileTestHeader header;
+  for (uint32_t i = 0; i < 500; ++i)
+    {
+      uint32_t size = (i * 37) % sizeof (data);
+      header.m_value = i;
+      switch (i % 3)
+        {
+        case 0:
+          f.Write (i, i * 10, data, size);
+          break;
+        case 1:
+          f.Write (i, i * 10, Create<Packet> (data, size));
+          break;
+        default:
+          f.Write (i, i * 10, header, Create<Packet> (data, size));
+          break;
+        }
+    }
+}
+
+void
+BufferedWriteTestCase::DoRun (void)
+{
+  std::string reference = CreateTempDirFilename ("buffered-reference.pcap");
+  PcapFile f;
+  f.Open (reference, std::ios::out);
+  WriteRecords (f);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Unbuffered write failed");
+  f.Close ();
+  std::string expected = ReadFileContent (reference);
+  NS_TEST_ASSERT_MSG_GT (expected.size (), 24, "Nothing written");
+
+  // the small buffers make records span chunks and records larger than a chunk
+  uint32_t bufferSizes[] = { 100, 1 << 16 };
+  for (uint32_t threaded = 0; threaded < 2; ++threaded)
+    {
+      for (uint32_t i = 0; i < 2; ++i)
+        {
+          std::string filename = CreateTempDirFilename ("buffered.pcap");
+          PcapFile g;
+          g.OpenBuffered (filename, bufferSizes[i], threaded);
+          NS_TEST_ASSERT_MSG_EQ (g.Fail (), false, "OpenBuffered (" << filename << ") failed");
+          WriteRecords (g);
+          g.Flush ();
+          NS_TEST_EXPECT_MSG_EQ (ReadFileContent (filename).size (), expected.size (),
+                                 "Flush did not write everything");
+          g.Close ();
+          NS_TEST_EXPECT_MSG_EQ ((ReadFileContent (filename) == expected), true,
+                                 "Buffered file differs, buffer " << bufferSizes[i]
+                                                                  << " threaded " << threaded);
+        }
+    }
+}
+
+// ===========================================================================
+// Test case to make sure that the pcapng file has the expected blocks.
+// ===========================================================================
+class PcapNgTestCase : public TestCase
+{
+public:
+  PcapNgTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PcapNgTestCase::PcapNgTestCase ()
+  : TestCase ("Check the blocks of a pcapng file with two interfaces")
+{
+}
+
+void
+PcapNgTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("interfaces.pcapng");
+  Ptr<PcapNgFile> file = Create<PcapNgFile> ();
+  NS_TEST_ASSERT_MSG_EQ (file->Open (filename, 1000, true), true, "Open failed");
+  uint32_t first = file->AddInterface (1, 100, "node-0");
+  uint32_t second = file->AddInterface (127, 10, "node-12");
+  NS_TEST_EXPECT_MSG_EQ (first, 0, "Wrong first interface");
+  NS_TEST_EXPECT_MSG_EQ (second, 1, "Wrong second interface");
+  NS_TEST_EXPECT_MSG_EQ (file->GetSnapLen (second), 10, "Wrong snapshot length");
+  uint8_t data[15] = { 0 };
+  PcapFileTestHeader header;
+  header.m_value = 7;
+  file->Write (first, NanoSeconds (5000000123ULL), data, 15);
+  file->Write (second, Seconds (1), &header, Create<Packet> (data, 15));
+  file->Close ();
+  NS_TEST_EXPECT_MSG_EQ (file->Fail (), false, "Write failed");
+
+  std::string content = ReadFileContent (filename);
+  std::vector<uint32_t> words (content.size () / 4);
+  NS_TEST_ASSERT_MSG_EQ (content.size (), words.size () * 4, "Blocks not padded");
+  std::memcpy (&words[0], content.data (), content.size ());
+
+  // section header block
+  NS_TEST_ASSERT_MSG_EQ (words[0], PcapNgFile::SHB_TYPE, "Wrong section header type");
+  NS_TEST_ASSERT_MSG_EQ (words[1], 28, "Wrong section header length");
+  NS_TEST_EXPECT_MSG_EQ (words[2], PcapNgFile::BYTE_ORDER_MAGIC, "Wrong byte order magic");
+  NS_TEST_EXPECT_MSG_EQ (words[6], 28, "Wrong trailing section header length");
+
+  // interface description blocks
+  uint32_t offset = 7;
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (words[offset], PcapNgFile::IDB_TYPE, "Wrong interface block type");
+      uint32_t length = words[offset + 1];
+      NS_TEST_EXPECT_MSG_EQ ((words[offset + 2] & 0xffff), (i == 0 ? 1U : 127U), "Wrong link type");
+      NS_TEST_EXPECT_MSG_EQ (words[offset + 3], (i == 0 ? 100U : 10U), "Wrong snapshot length");
+      std::string name = i == 0 ? "node-0" : "node-12";
+      NS_TEST_EXPECT_MSG_EQ (content.substr (offset * 4 + 20, name.size ()), name, "Wrong interface name");
+      NS_TEST_EXPECT_MSG_NE (content.find (std::string ("\x09\x00\x01\x00\x09", 5), offset * 4), std::string::npos,
+                             "Missing nanosecond resolution");
+      offset += length / 4;
+      NS_TEST_EXPECT_MSG_EQ (words[offset - 1], length, "Wrong trailing interface block length");
+    }
+
+  // enhanced packet blocks
+  NS_TEST_ASSERT_MSG_EQ (words[offset], PcapNgFile::EPB_TYPE, "Wrong packet block type");
+  NS_TEST_EXPECT_MSG_EQ (words[offset + 1], 32 + 16, "Wrong packet block length");
+  NS_TEST_EXPECT_MSG_EQ (words[offset + 2], 0, "Wrong interface");
+  uint64_t ts = (uint64_t (words[offset + 3]) << 32) | words[offset + 4];
+  NS_TEST_EXPECT_MSG_EQ (ts, 5000000123ULL, "Wrong timestamp");
+  NS_TEST_EXPECT_MSG_EQ (words[offset + 5], 15, "Wrong captured length");
+  NS_TEST_EXPECT_MSG_EQ (words[offset + 6], 15, "Wrong original length");
+  offset += 12;
+  NS_TEST_ASSERT_MSG_EQ (words[offset], PcapNgFile::EPB_TYPE, "Wrong packet block type");
+  NS_TEST_EXPECT_MSG_EQ (words[offset + 1], 32 + 12, "Wrong truncated packet block length");
+  NS_TEST_EXPECT_MSG_EQ (words[offset + 2], 1, "Wrong interface");
+  NS_TEST_EXPECT_MSG_EQ (words[offset + 5], 10, "Wrong truncated captured length");
+  NS_TEST_EXPECT_MSG_EQ (words[offset + 6], 24 + 15, "Wrong original length");
+  NS_TEST_EXPECT_MSG_EQ (uint32_t (uint8_t (content[(offset + 7) * 4 + 9])), 16, "Wrong header byte");
+  offset += 11;
+  NS_TEST_EXPECT_MSG_EQ (offset, words.size (), "Unexpected bytes at the end");
+}
+
 class PcapFileTestSuite : public TestSuite
 {
 public:
@@ -1138,6 +1381,8 @@ PcapFileTestSuite::PcapFileTestSuite ()
   AddTestCase (new RecordHeaderTestCase, TestCase::QUICK);
   AddTestCase (new ReadFileTestCase, TestCase::QUICK);
   AddTestCase (new DiffTestCase, TestCase::QUICK);
+  AddTestCase (new BufferedWriteTestCase, TestCase::QUICK);
+  AddTestCase (new PcapNgTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite;
@@ -0,0 +1,323 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "async-file-writer.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AsyncFileWriter");
+
+#ifdef HAVE_PTHREAD_H
+namespace {
+
+/**
+ * Longest wait on a condition before checking the state again, in ns.
+ * It only bounds the latency of a wakeup lost between the check of the
+ * state and the wait.
+ */
+const uint64_t WAIT_NS = 100000000;
+
+} // anonymous namespace
+#endif /* HAVE_PTHREAD_H */
+
+AsyncFileWriter::AsyncFileWriter ()
+  : m_fail (false),
+    m_chunkSize (0),
+    m_maxChunks (0),
+    m_current (0),
+    m_size (0)
+#ifdef HAVE_PTHREAD_H
+  ,
+    m_outstanding (0),
+    m_stop (false)
+#endif /* HAVE_PTHREAD_H */
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AsyncFileWriter::~AsyncFileWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+AsyncFileWriter::Open (std::string const &filename, uint32_t chunkSize,
+                       uint32_t maxChunks, bool threaded)
+{
+  NS_LOG_FUNCTION (this << filename << chunkSize << maxChunks << threaded);
+  NS_ASSERT (!IsOpen ());
+  m_file.open (filename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  // no writer thread yet
+  m_fail = !m_file.is_open ();
+  if (m_fail)
+    {
+      NS_LOG_WARN ("Cannot create " << filename);
+      return false;
+    }
+  m_chunkSize = std::max (chunkSize, 1U);
+  m_maxChunks = std::max (maxChunks, 2U);
+  m_size = 0;
+#ifdef HAVE_PTHREAD_H
+  if (threaded)
+    {
+      m_stop = false;
+      m_thread = Create<SystemThread> (MakeCallback (&AsyncFileWriter::Run, this));
+      m_thread->Start ();
+    }
+#endif /* HAVE_PTHREAD_H */
+  return true;
+}
+
+bool
+AsyncFileWriter::IsOpen (void) const
+{
+  return m_file.is_open ();
+}
+
+bool
+AsyncFileWriter::Fail (void) const
+{
+#ifdef HAVE_PTHREAD_H
+  CriticalSection cs (m_mutex);
+#endif /* HAVE_PTHREAD_H */
+  return m_fail;
+}
+
+void
+AsyncFileWriter::SetFail (void)
+{
+#ifdef HAVE_PTHREAD_H
+  CriticalSection cs (m_mutex);
+#endif /* HAVE_PTHREAD_H */
+  m_fail = true;
+}
+
+uint64_t
+AsyncFileWriter::GetSize (void) const
+{
+  return m_size;
+}
+
+bool
+AsyncFileWriter::WriteChunk (Chunk *chunk)
+{
+  // no logging here: this runs in the writer thread
+  m_file.write (reinterpret_cast<const char *> (&chunk->data[0]), chunk->size);
+  chunk->size = 0;
+  return !m_file.fail ();
+}
+
+void
+AsyncFileWriter::Submit (void)
+{
+  if (m_current == 0 || m_current->size == 0)
+    {
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+  if (m_thread != 0)
+    {
+      m_mutex.Lock ();
+      m_queue.push_back (m_current);
+      m_outstanding++;
+      m_queued.SetCondition (true);
+      m_mutex.Unlock ();
+      m_queued.Signal ();
+      m_current = 0;
+      return;
+    }
+#endif /* HAVE_PTHREAD_H */
+  if (!WriteChunk (m_current))
+    {
+      SetFail ();
+    }
+}
+
+AsyncFileWriter::Chunk *
+AsyncFileWriter::GetFreeChunk (void)
+{
+  Chunk *chunk = 0;
+#ifdef HAVE_PTHREAD_H
+  if (m_thread != 0)
+    {
+      m_mutex.Lock ();
+      while (m_free.empty () && m_chunks.size () >= m_maxChunks)
+        {
+          NS_LOG_LOGIC ("all the chunks are queued, waiting for the writer thread");
+          m_written.SetCondition (false);
+          m_mutex.Unlock ();
+          m_written.TimedWait (WAIT_NS);
+          m_mutex.Lock ();
+        }
+      if (!m_free.empty ())
+        {
+          chunk = m_free.back ();
+          m_free.pop_back ();
+        }
+      m_mutex.Unlock ();
+    }
+#endif /* HAVE_PTHREAD_H */
+  if (chunk == 0)
+    {
+      chunk = new Chunk;
+      chunk->data.resize (m_chunkSize);
+      chunk->size = 0;
+      m_chunks.push_back (chunk);
+    }
+  return chunk;
+}
+
+uint8_t *
+AsyncFileWriter::Reserve (uint32_t size)
+{
+  NS_ASSERT (IsOpen ());
+  if (m_current != 0 && m_current->size + size > m_current->data.size ())
+    {
+      Submit ();
+    }
+  if (m_current == 0)
+    {
+      m_current = GetFreeChunk ();
+    }
+  if (size > m_current->data.size ())
+    {
+      // a record larger than a chunk gets a chunk of its own
+      NS_ASSERT (m_current->size == 0);
+      m_current->data.resize (size);
+    }
+  uint8_t *buffer = &m_current->data[0] + m_current->size;
+  m_current->size += size;
+  m_size += size;
+  return buffer;
+}
+
+void
+AsyncFileWriter::Write (void const *data, uint32_t size)
+{
+  if (size != 0)
+    {
+      std::memcpy (Reserve (size), data, size);
+    }
+}
+
+void
+AsyncFileWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!IsOpen ())
+    {
+      return;
+    }
+  Submit ();
+#ifdef HAVE_PTHREAD_H
+  if (m_thread != 0)
+    {
+      m_mutex.Lock ();
+      while (m_outstanding > 0)
+        {
+          m_written.SetCondition (false);
+          m_mutex.Unlock ();
+          m_written.TimedWait (WAIT_NS);
+          m_mutex.Lock ();
+        }
+      m_mutex.Unlock ();
+    }
+#endif /* HAVE_PTHREAD_H */
+  // the writer thread is idle until the next Submit
+  m_file.flush ();
+  if (!m_file)
+    {
+      SetFail ();
+    }
+}
+
+void
+AsyncFileWriter::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!IsOpen ())
+    {
+      return;
+    }
+  Flush ();
+#ifdef HAVE_PTHREAD_H
+  if (m_thread != 0)
+    {
+      m_mutex.Lock ();
+      m_stop = true;
+      m_queued.SetCondition (true);
+      m_mutex.Unlock ();
+      m_queued.Signal ();
+      m_thread->Join ();
+      m_thread = 0;
+    }
+#endif /* HAVE_PTHREAD_H */
+  m_file.close ();
+  for (std::vector<Chunk *>::iterator i = m_chunks.begin (); i != m_chunks.end (); ++i)
+    {
+      delete *i;
+    }
+  m_chunks.clear ();
+  m_free.clear ();
+  m_current = 0;
+}
+
+#ifdef HAVE_PTHREAD_H
+void
+AsyncFileWriter::Run (void)
+{
+  while (true)
+    {
+      m_mutex.Lock ();
+      while (m_queue.empty () && !m_stop)
+        {
+          m_queued.SetCondition (false);
+          m_mutex.Unlock ();
+          m_queued.TimedWait (WAIT_NS);
+          m_mutex.Lock ();
+        }
+      if (m_queue.empty ())
+        {
+          // stopped, and everything was written
+          m_mutex.Unlock ();
+          return;
+        }
+      Chunk *chunk = m_queue.front ();
+      m_queue.pop_front ();
+      m_mutex.Unlock ();
+
+      bool ok = WriteChunk (chunk);
+
+      m_mutex.Lock ();
+      if (!ok)
+        {
+          m_fail = true;
+        }
+      m_free.push_back (chunk);
+      m_outstanding--;
+      m_written.SetCondition (true);
+      m_mutex.Unlock ();
+      m_written.Signal ();
+    }
+}
+#endif /* HAVE_PTHREAD_H */
+
+} // namespace ns3
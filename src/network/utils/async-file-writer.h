@@ -0,0 +1,156 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ASYNC_FILE_WRITER_H
+#define ASYNC_FILE_WRITER_H
+
+#include <stdint.h>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "ns3/core-config.h"
+#include "ns3/ptr.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-condition.h"
+#include "ns3/system-mutex.h"
+#include "ns3/system-thread.h"
+#endif /* HAVE_PTHREAD_H */
+
+namespace ns3 {
+
+/**
+ * \brief Buffered binary file output, optionally written by a
+ * background thread
+ *
+ * The records are serialized in place into large memory chunks with
+ * Reserve (), instead of being written field by field into a stream.
+ * A full chunk is handed to a writer thread, which writes it into the
+ * file while the simulation goes on filling the next chunk.  When all
+ * the chunks are queued, Reserve () waits for the writer thread, so
+ * that the memory used stays bounded.
+ *
+ * Without threads, or when not asked to start one, the chunks are
+ * written synchronously when full, which still replaces the many small
+ * stream writes by one large write per chunk.
+ *
+ * The data is in the file only after Flush () or Close ().
+ */
+class AsyncFileWriter
+{
+public:
+  AsyncFileWriter ();
+  /** Close the file, writing the pending data. */
+  ~AsyncFileWriter ();
+
+  /**
+   * Create the file, truncating it if it exists.
+   *
+   * \param filename The name of the file.
+   * \param chunkSize The size of the memory chunks, in bytes.
+   * \param maxChunks The maximum number of chunks in memory.
+   * \param threaded Write the chunks from a background thread.
+   *        Ignored when built without threads.
+   * \returns true if the file was created.
+   */
+  bool Open (std::string const &filename, uint32_t chunkSize,
+             uint32_t maxChunks, bool threaded);
+  /** \returns true if the file is open. */
+  bool IsOpen (void) const;
+  /** \returns true if a write into the file failed. */
+  bool Fail (void) const;
+
+  /**
+   * Reserve contiguous space for the next bytes of the file.
+   *
+   * \param size The number of bytes.
+   * \returns A pointer to \pname{size} bytes to fill, which will be
+   *          written after the ones previously reserved.  It is valid
+   *          until the next call to any other method.
+   */
+  uint8_t *Reserve (uint32_t size);
+  /**
+   * Copy bytes at the end of the file.
+   *
+   * \param data The bytes to copy.
+   * \param size The number of bytes.
+   */
+  void Write (void const *data, uint32_t size);
+  /**
+   * Write all the pending data into the file, and wait for the
+   * writer thread to be done with it.
+   */
+  void Flush (void);
+  /**
+   * Flush the pending data, stop the writer thread and close the file.
+   */
+  void Close (void);
+
+  /** \returns The number of bytes reserved since Open (). */
+  uint64_t GetSize (void) const;
+
+private:
+  /** A memory chunk. */
+  struct Chunk
+  {
+    std::vector<uint8_t> data;  //!< Buffer
+    uint32_t size;              //!< Number of bytes used
+  };
+
+  /**
+   * Write a chunk into the file.
+   * \param chunk The chunk.
+   * \returns false if the write failed.
+   */
+  bool WriteChunk (Chunk *chunk);
+  /** Record that a write failed, from any thread. */
+  void SetFail (void);
+  /**
+   * Queue the current chunk for the writer thread, or write it now.
+   */
+  void Submit (void);
+  /**
+   * \returns An empty chunk, waiting for the writer thread if all the
+   *          chunks are queued.
+   */
+  Chunk *GetFreeChunk (void);
+
+  std::ofstream m_file;           //!< The file
+  bool m_fail;                    //!< A write failed, guarded by m_mutex
+  uint32_t m_chunkSize;           //!< Size of the chunks
+  uint32_t m_maxChunks;           //!< Maximum number of chunks
+  std::vector<Chunk *> m_chunks;  //!< All the chunks
+  std::vector<Chunk *> m_free;    //!< Chunks available for writing
+  Chunk *m_current;               //!< Chunk being filled
+  uint64_t m_size;                //!< Bytes reserved since Open
+
+#ifdef HAVE_PTHREAD_H
+  /** Body of the writer thread. */
+  void Run (void);
+
+  Ptr<SystemThread> m_thread;     //!< Writer thread, if started
+  mutable SystemMutex m_mutex;    //!< Protects the queue, the free list and m_fail
+  SystemCondition m_queued;       //!< A chunk was queued, or m_stop set
+  SystemCondition m_written;      //!< The writer thread released a chunk
+  std::deque<Chunk *> m_queue;    //!< Chunks waiting for the writer thread
+  uint32_t m_outstanding;         //!< Queued chunks not yet written
+  bool m_stop;                    //!< Stop the writer thread
+#endif /* HAVE_PTHREAD_H */
+};
+
+} // namespace ns3
+
+#endif /* ASYNC_FILE_WRITER_H */
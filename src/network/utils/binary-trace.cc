@@ -0,0 +1,451 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "binary-trace.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTrace");
+
+namespace {
+
+/**
+ * Append an unsigned varint: 7 bits per byte, low bits first.
+ * \param out The encoding buffer.
+ * \param value The value.
+ */
+void
+PutVarint (std::vector<uint8_t> &out, uint64_t value)
+{
+  while (value >= 0x80)
+    {
+      out.push_back (static_cast<uint8_t> (value | 0x80));
+      value >>= 7;
+    }
+  out.push_back (static_cast<uint8_t> (value));
+}
+
+/**
+ * Decode an unsigned varint.
+ * \param [in,out] p The current position, moved after the varint.
+ * \param end The end of the buffer.
+ * \param [out] value The value.
+ * \returns false if the buffer ends in the varint.
+ */
+bool
+GetVarint (uint8_t const *&p, uint8_t const *end, uint64_t &value)
+{
+  value = 0;
+  for (uint32_t shift = 0; shift < 64; shift += 7)
+    {
+      if (p == end)
+        {
+          return false;
+        }
+      uint8_t byte = *p++;
+      value |= static_cast<uint64_t> (byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+/**
+ * Append a column of varints.
+ * \param out The encoding buffer.
+ * \param column The column.
+ */
+void
+PutColumn (std::vector<uint8_t> &out, std::vector<uint32_t> const &column)
+{
+  for (std::vector<uint32_t>::const_iterator i = column.begin (); i != column.end (); ++i)
+    {
+      PutVarint (out, *i);
+    }
+}
+
+/**
+ * Decode a column of varints.
+ * \param [in,out] p The current position.
+ * \param end The end of the buffer.
+ * \param n The number of values.
+ * \param [out] column The column.
+ * \returns false if the buffer is too short.
+ */
+bool
+GetColumn (uint8_t const *&p, uint8_t const *end, uint32_t n, std::vector<uint32_t> &column)
+{
+  column.resize (n);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      uint64_t value;
+      if (!GetVarint (p, end, value))
+        {
+          return false;
+        }
+      column[i] = static_cast<uint32_t> (value);
+    }
+  return true;
+}
+
+/**
+ * Append a column of fixed size values.
+ * \param out The encoding buffer.
+ * \param column The column.
+ */
+template <typename T>
+void
+PutRawColumn (std::vector<uint8_t> &out, std::vector<T> const &column)
+{
+  if (!column.empty ())
+    {
+      uint8_t const *data = reinterpret_cast<uint8_t const *> (&column[0]);
+      out.insert (out.end (), data, data + column.size () * sizeof (T));
+    }
+}
+
+/**
+ * Decode a column of fixed size values.
+ * \param [in,out] p The current position.
+ * \param end The end of the buffer.
+ * \param n The number of values.
+ * \param [out] column The column.
+ * \returns false if the buffer is too short.
+ */
+template <typename T>
+bool
+GetRawColumn (uint8_t const *&p, uint8_t const *end, uint32_t n, std::vector<T> &column)
+{
+  column.resize (n);
+  if (static_cast<uint64_t> (end - p) < static_cast<uint64_t> (n) * sizeof (T))
+    {
+      return false;
+    }
+  if (n != 0)
+    {
+      std::memcpy (&column[0], p, n * sizeof (T));
+    }
+  p += n * sizeof (T);
+  return true;
+}
+
+/**
+ * Smallest encoded record: one byte for each of the four varints and
+ * for the event, MCS and sector, and the SNR float.
+ */
+const uint32_t MIN_RECORD_SIZE = 4 + 3 + sizeof (float);
+
+} // anonymous namespace
+
+const uint8_t BinaryTraceRecord::NONE;
+const uint32_t BinaryTraceWriter::MAGIC;
+const uint16_t BinaryTraceWriter::VERSION;
+
+uint32_t
+BinaryTraceChunk::GetN (void) const
+{
+  return time.size ();
+}
+
+BinaryTraceRecord
+BinaryTraceChunk::Get (uint32_t i) const
+{
+  NS_ASSERT (i < GetN ());
+  BinaryTraceRecord record;
+  record.time = time[i];
+  record.node = node[i];
+  record.device = device[i];
+  record.event = event[i];
+  record.size = size[i];
+  record.mcs = mcs[i];
+  record.sector = sector[i];
+  record.snr = snr[i];
+  return record;
+}
+
+void
+BinaryTraceChunk::Add (BinaryTraceRecord const &record)
+{
+  time.push_back (record.time);
+  node.push_back (record.node);
+  device.push_back (record.device);
+  event.push_back (record.event);
+  size.push_back (record.size);
+  mcs.push_back (record.mcs);
+  sector.push_back (record.sector);
+  snr.push_back (record.snr);
+}
+
+void
+BinaryTraceChunk::Clear (void)
+{
+  time.clear ();
+  node.clear ();
+  device.clear ();
+  event.clear ();
+  size.clear ();
+  mcs.clear ();
+  sector.clear ();
+  snr.clear ();
+}
+
+BinaryTraceWriter::BinaryTraceWriter ()
+  : m_chunkRecords (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BinaryTraceWriter::~BinaryTraceWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+BinaryTraceWriter::Open (std::string const &filename, uint32_t chunkRecords, bool threaded)
+{
+  NS_LOG_FUNCTION (this << filename << chunkRecords << threaded);
+  // a chunk of records takes about 16 bytes per record once encoded
+  m_chunkRecords = std::max (chunkRecords, 1U);
+  if (!m_writer.Open (filename, m_chunkRecords * 16, 4, threaded))
+    {
+      return false;
+    }
+  m_chunk.Clear ();
+  uint32_t magic = MAGIC;
+  uint16_t version[2] = { VERSION, 0 };
+  m_writer.Write (&magic, sizeof (magic));
+  m_writer.Write (version, sizeof (version));
+  return true;
+}
+
+bool
+BinaryTraceWriter::Fail (void) const
+{
+  return m_writer.Fail ();
+}
+
+void
+BinaryTraceWriter::Write (BinaryTraceRecord const &record)
+{
+#ifdef NS3_MTP
+  CriticalSection cs (m_mutex);
+#endif
+  if (!m_writer.IsOpen ())
+    {
+      return;
+    }
+  m_chunk.Add (record);
+  if (m_chunk.GetN () >= m_chunkRecords)
+    {
+      WriteChunk ();
+    }
+}
+
+void
+BinaryTraceWriter::WriteChunk (void)
+{
+  uint32_t n = m_chunk.GetN ();
+  if (n == 0)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << n);
+  m_encoded.clear ();
+  int64_t previous = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      // zigzag encoding of the delta, which is usually small and positive
+      int64_t delta = m_chunk.time[i] - previous;
+      PutVarint (m_encoded, (static_cast<uint64_t> (delta) << 1) ^ static_cast<uint64_t> (delta >> 63));
+      previous = m_chunk.time[i];
+    }
+  PutColumn (m_encoded, m_chunk.node);
+  PutColumn (m_encoded, m_chunk.device);
+  PutRawColumn (m_encoded, m_chunk.event);
+  PutColumn (m_encoded, m_chunk.size);
+  PutRawColumn (m_encoded, m_chunk.mcs);
+  PutRawColumn (m_encoded, m_chunk.sector);
+  PutRawColumn (m_encoded, m_chunk.snr);
+
+  uint32_t header[2] = { n, static_cast<uint32_t> (m_encoded.size ()) };
+  uint8_t *chunk = m_writer.Reserve (sizeof (header) + m_encoded.size ());
+  std::memcpy (chunk, header, sizeof (header));
+  std::memcpy (chunk + sizeof (header), &m_encoded[0], m_encoded.size ());
+  m_chunk.Clear ();
+}
+
+void
+BinaryTraceWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef NS3_MTP
+  CriticalSection cs (m_mutex);
+#endif
+  if (m_writer.IsOpen ())
+    {
+      WriteChunk ();
+      m_writer.Flush ();
+    }
+}
+
+void
+BinaryTraceWriter::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef NS3_MTP
+  CriticalSection cs (m_mutex);
+#endif
+  if (m_writer.IsOpen ())
+    {
+      WriteChunk ();
+      m_writer.Close ();
+    }
+}
+
+BinaryTraceReader::BinaryTraceReader ()
+  : m_next (0),
+    m_remaining (0),
+    m_fail (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+BinaryTraceReader::Open (std::string const &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  if (m_file.is_open ())
+    {
+      m_file.close ();
+    }
+  m_file.clear ();
+  m_file.open (filename.c_str (), std::ios::in | std::ios::binary);
+  m_file.seekg (0, std::ios::end);
+  std::streamoff size = m_file.tellg ();
+  m_file.seekg (0, std::ios::beg);
+  uint32_t magic = 0;
+  uint16_t version[2] = { 0, 0 };
+  m_file.read (reinterpret_cast<char *> (&magic), sizeof (magic));
+  m_file.read (reinterpret_cast<char *> (version), sizeof (version));
+  m_fail = !m_file || magic != BinaryTraceWriter::MAGIC
+    || version[0] != BinaryTraceWriter::VERSION;
+  m_remaining = m_fail ? 0 : size - sizeof (magic) - sizeof (version);
+  m_chunk.Clear ();
+  m_next = 0;
+  return !m_fail;
+}
+
+bool
+BinaryTraceReader::Fail (void) const
+{
+  return m_fail;
+}
+
+bool
+BinaryTraceReader::ReadChunk (BinaryTraceChunk &chunk)
+{
+  NS_LOG_FUNCTION (this);
+  chunk.Clear ();
+  if (m_fail)
+    {
+      return false;
+    }
+  uint32_t header[2];
+  m_file.read (reinterpret_cast<char *> (header), sizeof (header));
+  if (m_file.gcount () == 0 && m_file.eof ())
+    {
+      return false;
+    }
+  if (m_file.gcount () != sizeof (header))
+    {
+      NS_LOG_WARN ("Truncated chunk header");
+      m_fail = true;
+      return false;
+    }
+  m_remaining -= std::min<uint64_t> (m_remaining, sizeof (header));
+  // check the header before allocating anything from it
+  uint32_t n = header[0];
+  if (header[1] > m_remaining || n > header[1] / MIN_RECORD_SIZE)
+    {
+      NS_LOG_WARN ("Corrupted chunk header: " << n << " records in " << header[1] << " bytes");
+      m_fail = true;
+      return false;
+    }
+  m_remaining -= header[1];
+  m_encoded.resize (header[1]);
+  if (header[1] != 0)
+    {
+      m_file.read (reinterpret_cast<char *> (&m_encoded[0]), header[1]);
+    }
+  if (!m_file)
+    {
+      NS_LOG_WARN ("Truncated chunk");
+      m_fail = true;
+      return false;
+    }
+
+  uint8_t const *p = m_encoded.empty () ? 0 : &m_encoded[0];
+  uint8_t const *end = p + m_encoded.size ();
+  chunk.time.resize (n);
+  int64_t previous = 0;
+  for (uint32_t i = 0; i < n && !m_fail; ++i)
+    {
+      uint64_t zigzag;
+      m_fail = !GetVarint (p, end, zigzag);
+      previous += static_cast<int64_t> (zigzag >> 1) ^ -static_cast<int64_t> (zigzag & 1);
+      chunk.time[i] = previous;
+    }
+  m_fail = m_fail
+    || !GetColumn (p, end, n, chunk.node)
+    || !GetColumn (p, end, n, chunk.device)
+    || !GetRawColumn (p, end, n, chunk.event)
+    || !GetColumn (p, end, n, chunk.size)
+    || !GetRawColumn (p, end, n, chunk.mcs)
+    || !GetRawColumn (p, end, n, chunk.sector)
+    || !GetRawColumn (p, end, n, chunk.snr)
+    || p != end;
+  if (m_fail)
+    {
+      NS_LOG_WARN ("Corrupted chunk");
+      chunk.Clear ();
+      return false;
+    }
+  return true;
+}
+
+bool
+BinaryTraceReader::Read (BinaryTraceRecord &record)
+{
+  while (m_next >= m_chunk.GetN ())
+    {
+      m_next = 0;
+      if (!ReadChunk (m_chunk))
+        {
+          return false;
+        }
+    }
+  record = m_chunk.Get (m_next++);
+  return true;
+}
+
+} // namespace ns3
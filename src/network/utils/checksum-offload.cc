@@ -0,0 +1,201 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "checksum-offload.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/global-value.h"
+#include "ns3/boolean.h"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ChecksumOffload");
+
+/**
+ * \brief A global switch to defer the checksums to the byte-level consumers.
+ */
+static GlobalValue g_checksumOffload = GlobalValue ("ChecksumOffload",
+                                                    "When ChecksumEnabled is not set, fill the checksums "
+                                                    "only in the packets written to the pcap traces and "
+                                                    "to the file descriptors",
+                                                    BooleanValue (false),
+                                                    MakeBooleanChecker ());
+
+NS_OBJECT_ENSURE_REGISTERED (ChecksumOffloadTag);
+
+TypeId
+ChecksumOffloadTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ChecksumOffloadTag")
+    .SetParent<Tag> ()
+    .SetGroupName("Network")
+    .AddConstructor<ChecksumOffloadTag> ()
+  ;
+  return tid;
+}
+TypeId
+ChecksumOffloadTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+uint32_t
+ChecksumOffloadTag::GetSerializedSize (void) const
+{
+  return 8;
+}
+void
+ChecksumOffloadTag::Serialize (TagBuffer buf) const
+{
+  buf.WriteU16 (m_protocol);
+  buf.WriteU16 (m_headerSize);
+  buf.WriteU32 (m_payloadSize);
+}
+void
+ChecksumOffloadTag::Deserialize (TagBuffer buf)
+{
+  m_protocol = buf.ReadU16 ();
+  m_headerSize = buf.ReadU16 ();
+  m_payloadSize = buf.ReadU32 ();
+}
+void
+ChecksumOffloadTag::Print (std::ostream &os) const
+{
+  os << "Protocol=" << m_protocol << " HeaderSize=" << m_headerSize << " PayloadSize=" << m_payloadSize;
+}
+ChecksumOffloadTag::ChecksumOffloadTag ()
+  : Tag (),
+    m_protocol (0),
+    m_headerSize (0),
+    m_payloadSize (0)
+{
+}
+
+ChecksumOffloadTag::ChecksumOffloadTag (uint16_t protocol, uint16_t headerSize, uint32_t payloadSize)
+  : Tag (),
+    m_protocol (protocol),
+    m_headerSize (headerSize),
+    m_payloadSize (payloadSize)
+{
+}
+
+uint16_t
+ChecksumOffloadTag::GetProtocol (void) const
+{
+  return m_protocol;
+}
+uint16_t
+ChecksumOffloadTag::GetHeaderSize (void) const
+{
+  return m_headerSize;
+}
+uint32_t
+ChecksumOffloadTag::GetPayloadSize (void) const
+{
+  return m_payloadSize;
+}
+
+/**
+ * \brief Get the registered functions, by protocol number
+ * \returns the registry
+ */
+static std::map<uint16_t, ChecksumOffload::CompleteCallback> &
+GetCompleteCallbacks (void)
+{
+  static std::map<uint16_t, ChecksumOffload::CompleteCallback> callbacks;
+  return callbacks;
+}
+
+bool
+ChecksumOffload::IsEnabled (void)
+{
+  BooleanValue val;
+  g_checksumOffload.GetValue (val);
+  return val.Get () && !Node::ChecksumEnabled ();
+}
+
+void
+ChecksumOffload::Register (uint16_t protocol, CompleteCallback cb)
+{
+  NS_LOG_FUNCTION (protocol);
+  GetCompleteCallbacks ()[protocol] = cb;
+}
+
+void
+ChecksumOffload::Defer (Ptr<Packet> payload, uint16_t protocol, uint16_t headerSize)
+{
+  NS_LOG_FUNCTION (payload << protocol << headerSize);
+  payload->AddByteTag (ChecksumOffloadTag (protocol, headerSize, payload->GetSize ()));
+}
+
+Ptr<const Packet>
+ChecksumOffload::Complete (Ptr<const Packet> packet)
+{
+  NS_LOG_FUNCTION (packet);
+
+  // The start and the size of the packets of each protocol, without the
+  // duplicates left by the forwarding nodes
+  std::vector<std::pair<uint32_t, uint32_t> > ranges;
+  std::vector<CompleteCallback> callbacks;
+  ByteTagIterator it = packet->GetByteTagIterator ();
+  while (it.HasNext ())
+    {
+      ByteTagIterator::Item item = it.Next ();
+      if (item.GetTypeId () != ChecksumOffloadTag::GetTypeId ())
+        {
+          continue;
+        }
+      ChecksumOffloadTag tag;
+      item.GetTag (tag);
+      if (item.GetEnd () - item.GetStart () != tag.GetPayloadSize () || item.GetStart () < tag.GetHeaderSize ())
+        {
+          continue;
+        }
+      std::pair<uint32_t, uint32_t> range (item.GetStart () - tag.GetHeaderSize (),
+                                           tag.GetHeaderSize () + tag.GetPayloadSize ());
+      std::map<uint16_t, CompleteCallback>::const_iterator cb = GetCompleteCallbacks ().find (tag.GetProtocol ());
+      if (cb == GetCompleteCallbacks ().end ()
+          || std::find (ranges.begin (), ranges.end (), range) != ranges.end ())
+        {
+          continue;
+        }
+      ranges.push_back (range);
+      callbacks.push_back (cb->second);
+    }
+  if (ranges.empty ())
+    {
+      return packet;
+    }
+
+  uint32_t size = packet->GetSize ();
+  std::vector<uint8_t> bytes (size);
+  packet->CopyData (&bytes[0], size);
+  Buffer buffer;
+  buffer.AddAtStart (size);
+  buffer.Begin ().Write (&bytes[0], size);
+  for (uint32_t i = 0; i < ranges.size (); i++)
+    {
+      Buffer::Iterator start = buffer.Begin ();
+      start.Next (ranges[i].first);
+      callbacks[i] (start, ranges[i].second);
+    }
+  return Create<Packet> (buffer.PeekData (), size);
+}
+
+} // namespace ns3
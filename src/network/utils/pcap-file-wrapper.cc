@@ -21,6 +21,7 @@
 #include "ns3/uinteger.h"
 #include "ns3/buffer.h"
 #include "ns3/header.h"
+#include "checksum-offload.h"
 #include "pcap-file-wrapper.h"
 
 namespace ns3 {
@@ -46,12 +47,26 @@ PcapFileWrapper::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&PcapFileWrapper::m_nanosecMode),
                    MakeBooleanChecker())
+    .AddAttribute ("WriteBufferSize",
+                   "Size of the buffers in which the records are written before "
+                   "going to the file, or 0 to write each record immediately. "
+                   "The buffered records are in the file after Flush or Close.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_bufferSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("AsynchronousWrite",
+                   "Whether the full buffers are written by a background thread, "
+                   "when WriteBufferSize is not 0 and threads are available.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapFileWrapper::m_asynchronous),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 
 PcapFileWrapper::PcapFileWrapper ()
+  : m_ngInterface (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -66,6 +81,10 @@ bool
 PcapFileWrapper::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_ngFile != 0)
+    {
+      return m_ngFile->Fail ();
+    }
   return m_file.Fail ();
 }
 
@@ -86,6 +105,8 @@ void
 PcapFileWrapper::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  // the shared pcapng file is closed by its owner
+  m_ngFile = 0;
   m_file.Close ();
 }
 
@@ -93,7 +114,37 @@ void
 PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
 {
   NS_LOG_FUNCTION (this << filename << mode);
-  m_file.Open (filename, mode);
+  if (m_bufferSize != 0 && mode == std::ios::out)
+    {
+      m_file.OpenBuffered (filename, m_bufferSize, m_asynchronous);
+    }
+  else
+    {
+      m_file.Open (filename, mode);
+    }
+}
+
+void
+PcapFileWrapper::Attach (Ptr<PcapNgFile> file, std::string const &name)
+{
+  NS_LOG_FUNCTION (this << file << name);
+  NS_ASSERT (file->IsOpen ());
+  m_ngFile = file;
+  m_ngName = name;
+}
+
+void
+PcapFileWrapper::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_ngFile != 0)
+    {
+      m_ngFile->Flush ();
+    }
+  else
+    {
+      m_file.Flush ();
+    }
 }
 
 void
@@ -105,6 +156,15 @@ PcapFileWrapper::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t tzCorrec
   // a snaplen, we use the one provided.
   //
   NS_LOG_FUNCTION (this << dataLinkType << snapLen << tzCorrection);
+  if (m_ngFile != 0)
+    {
+      if (snapLen == std::numeric_limits<uint32_t>::max ())
+        {
+          snapLen = m_snapLen;
+        }
+      m_ngInterface = m_ngFile->AddInterface (dataLinkType, snapLen, m_ngName);
+      return;
+    }
   if (snapLen != std::numeric_limits<uint32_t>::max ())
     {
       m_file.Init (dataLinkType, snapLen, tzCorrection, false, m_nanosecMode);
@@ -119,6 +179,12 @@ void
 PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << p);
+  p = ChecksumOffload::Complete (p);
+  if (m_ngFile != 0)
+    {
+      m_ngFile->Write (m_ngInterface, t, 0, p);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -139,6 +205,12 @@ void
 PcapFileWrapper::Write (Time t, const Header &header, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << &header << p);
+  p = ChecksumOffload::Complete (p);
+  if (m_ngFile != 0)
+    {
+      m_ngFile->Write (m_ngInterface, t, &header, p);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -159,6 +231,11 @@ void
 PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
 {
   NS_LOG_FUNCTION (this << t << &buffer << length);
+  if (m_ngFile != 0)
+    {
+      m_ngFile->Write (m_ngInterface, t, buffer, length);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -246,6 +323,10 @@ uint32_t
 PcapFileWrapper::GetSnapLen (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_ngFile != 0)
+    {
+      return m_ngFile->GetSnapLen (m_ngInterface);
+    }
   return m_file.GetSnapLen ();
 }
 
@@ -253,6 +334,10 @@ uint32_t
 PcapFileWrapper::GetDataLinkType (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_ngFile != 0)
+    {
+      return m_ngFile->GetDataLinkType (m_ngInterface);
+    }
   return m_file.GetDataLinkType ();
 }
 
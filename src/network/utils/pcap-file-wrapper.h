@@ -27,6 +27,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "pcap-file.h"
+#include "pcapng-file.h"
 
 namespace ns3 {
 
@@ -77,6 +78,22 @@ public:
    */
   void Open (std::string const &filename, std::ios::openmode mode);
 
+  /**
+   * Capture into an interface of a shared pcapng file, instead of a
+   * pcap file of our own.  The interface is added by Init (), named
+   * after \pname{name}.
+   *
+   * \param file The shared pcapng file, which must be open.
+   * \param name The name of the interface.
+   */
+  void Attach (Ptr<PcapNgFile> file, std::string const &name);
+
+  /**
+   * Write the records buffered when the "WriteBufferSize" attribute is
+   * set.  Without buffering, flush the underlying stream.
+   */
+  void Flush (void);
+
   /**
    * Close the underlying pcap file.
    */
@@ -224,6 +241,11 @@ private:
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
   bool     m_nanosecMode; //!< Timestamps in nanosecond mode
+  uint32_t m_bufferSize; //!< Size of the write buffers, or 0
+  bool     m_asynchronous; //!< Write the buffers from a background thread
+  Ptr<PcapNgFile> m_ngFile; //!< Shared pcapng file, if attached
+  std::string m_ngName; //!< Name of our interface in m_ngFile
+  uint32_t m_ngInterface; //!< Our interface in m_ngFile
 };
 
 } // namespace ns3
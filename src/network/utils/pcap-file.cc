@@ -27,6 +27,7 @@
 #include "ns3/header.h"
 #include "ns3/buffer.h"
 #include "pcap-file.h"
+#include "async-file-writer.h"
 #include "ns3/log.h"
 #include "ns3/build-profile.h"
 //
@@ -49,6 +50,8 @@ const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pc
 
 PcapFile::PcapFile ()
   : m_file (),
+    m_writer (0),
+    m_recordData (0),
     m_swapMode (false),
     m_nanosecMode (false)
 {
@@ -68,12 +71,20 @@ bool
 PcapFile::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_writer != 0)
+    {
+      return m_writer->Fail ();
+    }
   return m_file.fail ();
 }
 bool 
 PcapFile::Eof (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_writer != 0)
+    {
+      return false;
+    }
   return m_file.eof ();
 }
 void 
@@ -88,9 +99,42 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_writer != 0)
+    {
+      m_writer->Close ();
+      delete m_writer;
+      m_writer = 0;
+    }
   m_file.close ();
 }
 
+void
+PcapFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_writer != 0)
+    {
+      m_writer->Flush ();
+    }
+  else
+    {
+      m_file.flush ();
+    }
+}
+
+void
+PcapFile::WriteBytes (void const *data, uint32_t size)
+{
+  if (m_writer != 0)
+    {
+      m_writer->Write (data, size);
+    }
+  else
+    {
+      m_file.write ((const char *)data, size);
+    }
+}
+
 uint32_t
 PcapFile::GetMagic (void)
 {
@@ -206,7 +250,10 @@ PcapFile::WriteFileHeader (void)
   // If we're initializing the file, we need to write the pcap file header
   // at the start of the file.
   //
-  m_file.seekp (0, std::ios::beg);
+  if (m_writer == 0)
+    {
+      m_file.seekp (0, std::ios::beg);
+    }
  
   //
   // We have the ability to write out the pcap file header in a foreign endian
@@ -234,13 +281,13 @@ PcapFile::WriteFileHeader (void)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
-  m_file.write ((const char *)&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
-  m_file.write ((const char *)&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
-  m_file.write ((const char *)&headerOut->m_zone, sizeof(headerOut->m_zone));
-  m_file.write ((const char *)&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
-  m_file.write ((const char *)&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
-  m_file.write ((const char *)&headerOut->m_type, sizeof(headerOut->m_type));
+  WriteBytes (&headerOut->m_magicNumber, sizeof(headerOut->m_magicNumber));
+  WriteBytes (&headerOut->m_versionMajor, sizeof(headerOut->m_versionMajor));
+  WriteBytes (&headerOut->m_versionMinor, sizeof(headerOut->m_versionMinor));
+  WriteBytes (&headerOut->m_zone, sizeof(headerOut->m_zone));
+  WriteBytes (&headerOut->m_sigFigs, sizeof(headerOut->m_sigFigs));
+  WriteBytes (&headerOut->m_snapLen, sizeof(headerOut->m_snapLen));
+  WriteBytes (&headerOut->m_type, sizeof(headerOut->m_type));
 }
 
 void
@@ -341,6 +388,18 @@ PcapFile::Open (std::string const &filename, std::ios::openmode mode)
     }
 }
 
+void
+PcapFile::OpenBuffered (std::string const &filename, uint32_t bufferSize, bool threaded)
+{
+  NS_LOG_FUNCTION (this << filename << bufferSize << threaded);
+  NS_ASSERT (m_writer == 0 && !m_file.is_open ());
+  m_filename = filename;
+  m_writer = new AsyncFileWriter ();
+  // a writer thread fills the file while the simulation fills the
+  // other chunks
+  m_writer->Open (filename, bufferSize, 4, threaded);
+}
+
 void
 PcapFile::Init (uint32_t dataLinkType, uint32_t snapLen, int32_t timeZoneCorrection, bool swapMode, bool nanosecMode)
 {
@@ -403,7 +462,7 @@ uint32_t
 PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << totalLen);
-  NS_ASSERT (m_file.good ());
+  NS_ASSERT (m_writer != 0 || m_file.good ());
 
   uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
 
@@ -419,13 +478,24 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
     }
 
   //
-  // Watch out for memory alignment differences between machines, so write
-  // them all individually.
+  // Watch out for memory alignment differences between machines, so copy
+  // them all individually, then write the header at once.
   //
-  m_file.write ((const char *)&header.m_tsSec, sizeof(header.m_tsSec));
-  m_file.write ((const char *)&header.m_tsUsec, sizeof(header.m_tsUsec));
-  m_file.write ((const char *)&header.m_inclLen, sizeof(header.m_inclLen));
-  m_file.write ((const char *)&header.m_origLen, sizeof(header.m_origLen));
+  uint8_t buffer[sizeof (header.m_tsSec) + sizeof (header.m_tsUsec)
+                 + sizeof (header.m_inclLen) + sizeof (header.m_origLen)];
+  memcpy (buffer, &header.m_tsSec, 4);
+  memcpy (buffer + 4, &header.m_tsUsec, 4);
+  memcpy (buffer + 8, &header.m_inclLen, 4);
+  memcpy (buffer + 12, &header.m_origLen, 4);
+  if (m_writer != 0)
+    {
+      // reserve the packet data with the header
+      uint8_t *record = m_writer->Reserve (sizeof (buffer) + inclLen);
+      memcpy (record, buffer, sizeof (buffer));
+      m_recordData = record + sizeof (buffer);
+      return inclLen;
+    }
+  m_file.write ((const char *)buffer, sizeof (buffer));
   NS_BUILD_DEBUG(m_file.flush());
   return inclLen;
 }
@@ -435,6 +505,11 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, ui
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
+  if (m_writer != 0)
+    {
+      memcpy (m_recordData, data, inclLen);
+      return;
+    }
   m_file.write ((const char *)data, inclLen);
   NS_BUILD_DEBUG(m_file.flush());
 }
@@ -444,6 +519,11 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
+  if (m_writer != 0)
+    {
+      p->CopyData (m_recordData, inclLen);
+      return;
+    }
   p->CopyData (&m_file, inclLen);
   NS_BUILD_DEBUG(m_file.flush());
 }
@@ -460,6 +540,12 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, const Header &header, Ptr<cons
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
   uint32_t toCopy = std::min (headerSize, inclLen);
+  if (m_writer != 0)
+    {
+      headerBuffer.CopyData (m_recordData, toCopy);
+      p->CopyData (m_recordData + toCopy, inclLen - toCopy);
+      return;
+    }
   headerBuffer.CopyData (&m_file, toCopy);
   inclLen -= toCopy;
   p->CopyData (&m_file, inclLen);
@@ -30,6 +30,7 @@ namespace ns3 {
 
 class Packet;
 class Header;
+class AsyncFileWriter;
 
 
 /**
@@ -80,6 +81,25 @@ public:
    */
   void Open (std::string const &filename, std::ios::openmode mode);
 
+  /**
+   * Create a new pcap file for writing through an AsyncFileWriter.
+   *
+   * The records are serialized into memory chunks of \pname{bufferSize}
+   * bytes, which are written into the file when full, from a background
+   * thread if \pname{threaded} is true.  The records are only in the
+   * file after Flush or Close.
+   *
+   * \param filename String containing the name of the file.
+   * \param bufferSize The size of the memory chunks, in bytes.
+   * \param threaded Write the chunks from a background thread.
+   */
+  void OpenBuffered (std::string const &filename, uint32_t bufferSize, bool threaded);
+
+  /**
+   * Write the records buffered by a file opened with OpenBuffered.
+   */
+  void Flush (void);
+
   /**
    * Close the underlying file.
    */
@@ -350,6 +370,9 @@ private:
    * The pcap header has a fixed length of 24 bytes. The last 4 bytes
    * represent the link-layer type
    *
+   * With buffered output, the space of the packet data is reserved
+   * after the header, and m_recordData points to it.
+   *
    * \param tsSec Time stamp (seconds part)
    * \param tsUsec Time stamp (microseconds part)
    * \param totalLen total packet length
@@ -362,8 +385,17 @@ private:
    */
   void ReadAndVerifyFileHeader (void);
 
+  /**
+   * \brief Write bytes into the file
+   * \param data the bytes
+   * \param size the number of bytes
+   */
+  void WriteBytes (void const *data, uint32_t size);
+
   std::string    m_filename;    //!< file name
   std::fstream   m_file;        //!< file stream
+  AsyncFileWriter *m_writer;    //!< buffered output, instead of m_file
+  uint8_t       *m_recordData;  //!< buffered output of the record data
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
   bool m_nanosecMode;           //!< nanosecond timestamp mode
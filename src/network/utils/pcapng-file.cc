@@ -0,0 +1,261 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "pcapng-file.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/header.h"
+#include "ns3/buffer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapNgFile");
+
+namespace {
+
+/** Option code of the interface name */
+const uint16_t IF_NAME = 2;
+/** Option code of the timestamp resolution */
+const uint16_t IF_TSRESOL = 9;
+/** Timestamp resolution: 10^-9 seconds */
+const uint8_t TSRESOL_NS = 9;
+
+/**
+ * \param size A number of bytes.
+ * \returns This number rounded up to a multiple of 4.
+ */
+inline uint32_t
+Pad (uint32_t size)
+{
+  return (size + 3) & ~3U;
+}
+
+/**
+ * Append a value in host byte order.
+ * \param block The block being built.
+ * \param value The value.
+ */
+template <typename T>
+void
+Append (std::vector<uint8_t> &block, T value)
+{
+  uint8_t const *bytes = reinterpret_cast<uint8_t const *> (&value);
+  block.insert (block.end (), bytes, bytes + sizeof (T));
+}
+
+/**
+ * Append an option, padded to 32 bits.
+ * \param block The block being built.
+ * \param code The option code.
+ * \param data The option value.
+ * \param size The length of the value.
+ */
+void
+AppendOption (std::vector<uint8_t> &block, uint16_t code, uint8_t const *data, uint16_t size)
+{
+  Append (block, code);
+  Append (block, size);
+  block.insert (block.end (), data, data + size);
+  block.resize (block.size () + Pad (size) - size, 0);
+}
+
+} // anonymous namespace
+
+PcapNgFile::PcapNgFile ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PcapNgFile::~PcapNgFile ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+PcapNgFile::Open (std::string const &filename, uint32_t bufferSize, bool threaded)
+{
+  NS_LOG_FUNCTION (this << filename << bufferSize << threaded);
+  if (!m_writer.Open (filename, bufferSize, 4, threaded))
+    {
+      return false;
+    }
+  m_interfaces.clear ();
+  std::vector<uint8_t> block;
+  Append (block, SHB_TYPE);
+  Append (block, uint32_t (28));
+  Append (block, BYTE_ORDER_MAGIC);
+  Append (block, uint16_t (1));
+  Append (block, uint16_t (0));
+  // the length of the section is not known in advance
+  Append (block, int64_t (-1));
+  Append (block, uint32_t (28));
+  m_writer.Write (&block[0], block.size ());
+  return true;
+}
+
+bool
+PcapNgFile::IsOpen (void) const
+{
+  return m_writer.IsOpen ();
+}
+
+bool
+PcapNgFile::Fail (void) const
+{
+  return m_writer.Fail ();
+}
+
+void
+PcapNgFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef NS3_MTP
+  CriticalSection cs (m_mutex);
+#endif
+  m_writer.Flush ();
+}
+
+void
+PcapNgFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef NS3_MTP
+  CriticalSection cs (m_mutex);
+#endif
+  m_writer.Close ();
+}
+
+uint32_t
+PcapNgFile::AddInterface (uint32_t dataLinkType, uint32_t snapLen, std::string const &name)
+{
+  NS_LOG_FUNCTION (this << dataLinkType << snapLen << name);
+#ifdef NS3_MTP
+  CriticalSection cs (m_mutex);
+#endif
+  NS_ASSERT (m_writer.IsOpen ());
+  Interface interface;
+  interface.dataLinkType = dataLinkType;
+  interface.snapLen = snapLen;
+  m_interfaces.push_back (interface);
+
+  std::vector<uint8_t> block;
+  Append (block, IDB_TYPE);
+  Append (block, uint32_t (0));
+  Append (block, uint16_t (dataLinkType));
+  Append (block, uint16_t (0));
+  Append (block, snapLen);
+  if (!name.empty ())
+    {
+      uint16_t size = std::min<size_t> (name.size (), 0xfffc);
+      AppendOption (block, IF_NAME, reinterpret_cast<uint8_t const *> (name.data ()), size);
+    }
+  AppendOption (block, IF_TSRESOL, &TSRESOL_NS, 1);
+  // opt_endofopt
+  Append (block, uint32_t (0));
+  uint32_t blockLen = block.size () + 4;
+  std::memcpy (&block[4], &blockLen, 4);
+  Append (block, blockLen);
+  m_writer.Write (&block[0], block.size ());
+  return m_interfaces.size () - 1;
+}
+
+uint32_t
+PcapNgFile::GetDataLinkType (uint32_t interface) const
+{
+  NS_ASSERT (interface < m_interfaces.size ());
+  return m_interfaces[interface].dataLinkType;
+}
+
+uint32_t
+PcapNgFile::GetSnapLen (uint32_t interface) const
+{
+  NS_ASSERT (interface < m_interfaces.size ());
+  return m_interfaces[interface].snapLen;
+}
+
+uint32_t
+PcapNgFile::GetNInterfaces (void) const
+{
+  return m_interfaces.size ();
+}
+
+uint8_t *
+PcapNgFile::ReservePacket (uint32_t interface, Time t, uint32_t origLen, uint32_t &capLen)
+{
+  NS_ASSERT (interface < m_interfaces.size ());
+  capLen = std::min (origLen, m_interfaces[interface].snapLen);
+  uint32_t padded = Pad (capLen);
+  uint32_t blockLen = 32 + padded;
+  uint64_t ts = t.GetNanoSeconds ();
+  uint32_t fields[7] = {
+    EPB_TYPE, blockLen, interface,
+    static_cast<uint32_t> (ts >> 32), static_cast<uint32_t> (ts),
+    capLen, origLen
+  };
+  uint8_t *block = m_writer.Reserve (blockLen);
+  std::memcpy (block, fields, sizeof (fields));
+  uint8_t *data = block + sizeof (fields);
+  std::memset (data + capLen, 0, padded - capLen);
+  std::memcpy (data + padded, &blockLen, 4);
+  return data;
+}
+
+void
+PcapNgFile::Write (uint32_t interface, Time t, Header const *header, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << interface << t << header << p);
+#ifdef NS3_MTP
+  CriticalSection cs (m_mutex);
+#endif
+  if (!m_writer.IsOpen ())
+    {
+      return;
+    }
+  uint32_t headerSize = header != 0 ? header->GetSerializedSize () : 0;
+  uint32_t capLen;
+  uint8_t *data = ReservePacket (interface, t, headerSize + p->GetSize (), capLen);
+  uint32_t toCopy = std::min (headerSize, capLen);
+  if (toCopy != 0)
+    {
+      Buffer headerBuffer;
+      headerBuffer.AddAtStart (headerSize);
+      header->Serialize (headerBuffer.Begin ());
+      headerBuffer.CopyData (data, toCopy);
+    }
+  p->CopyData (data + toCopy, capLen - toCopy);
+}
+
+void
+PcapNgFile::Write (uint32_t interface, Time t, uint8_t const *buffer, uint32_t length)
+{
+  NS_LOG_FUNCTION (this << interface << t << &buffer << length);
+#ifdef NS3_MTP
+  CriticalSection cs (m_mutex);
+#endif
+  if (!m_writer.IsOpen ())
+    {
+      return;
+    }
+  uint32_t capLen;
+  uint8_t *data = ReservePacket (interface, t, length, capLen);
+  std::memcpy (data, buffer, capLen);
+}
+
+} // namespace ns3
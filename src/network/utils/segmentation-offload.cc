@@ -0,0 +1,231 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "segmentation-offload.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <map>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SegmentationOffload");
+
+NS_OBJECT_ENSURE_REGISTERED (GsoTag);
+
+TypeId
+GsoTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::GsoTag")
+    .SetParent<Tag> ()
+    .SetGroupName("Network")
+    .AddConstructor<GsoTag> ()
+  ;
+  return tid;
+}
+TypeId
+GsoTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+uint32_t
+GsoTag::GetSerializedSize (void) const
+{
+  return 2;
+}
+void
+GsoTag::Serialize (TagBuffer buf) const
+{
+  buf.WriteU16 (m_segmentSize);
+}
+void
+GsoTag::Deserialize (TagBuffer buf)
+{
+  m_segmentSize = buf.ReadU16 ();
+}
+void
+GsoTag::Print (std::ostream &os) const
+{
+  os << "SegmentSize=" << m_segmentSize;
+}
+GsoTag::GsoTag ()
+  : Tag (),
+    m_segmentSize (0)
+{
+}
+
+GsoTag::GsoTag (uint16_t segmentSize)
+  : Tag (),
+    m_segmentSize (segmentSize)
+{
+}
+
+void
+GsoTag::SetSegmentSize (uint16_t segmentSize)
+{
+  m_segmentSize = segmentSize;
+}
+uint16_t
+GsoTag::GetSegmentSize (void) const
+{
+  return m_segmentSize;
+}
+
+/**
+ * \brief Get the registered functions, by protocol number
+ * \returns the registry
+ */
+static std::map<uint16_t, SegmentationOffload::SegmentCallback> &
+GetSegmentCallbacks (void)
+{
+  static std::map<uint16_t, SegmentationOffload::SegmentCallback> callbacks;
+  return callbacks;
+}
+
+void
+SegmentationOffload::Register (uint16_t protocol, SegmentCallback cb)
+{
+  NS_LOG_FUNCTION (protocol);
+  GetSegmentCallbacks ()[protocol] = cb;
+}
+
+std::list<Ptr<Packet> >
+SegmentationOffload::Segment (Ptr<const Packet> packet, uint16_t protocol)
+{
+  NS_LOG_FUNCTION (packet << protocol);
+
+  GsoTag tag;
+  if (packet->PeekPacketTag (tag))
+    {
+      std::map<uint16_t, SegmentCallback>::const_iterator it = GetSegmentCallbacks ().find (protocol);
+      if (it != GetSegmentCallbacks ().end ())
+        {
+          return it->second (packet);
+        }
+      NS_LOG_WARN ("No segmentation for protocol " << protocol << ", sending the super-segment");
+    }
+
+  std::list<Ptr<Packet> > segments;
+  Ptr<Packet> copy = packet->Copy ();
+  copy->RemovePacketTag (tag);
+  segments.push_back (copy);
+  return segments;
+}
+
+/**
+ * \brief Get the registered merge functions, by protocol number
+ * \returns the registry
+ */
+static std::map<uint16_t, SegmentationOffload::CoalesceCallback> &
+GetCoalesceCallbacks (void)
+{
+  static std::map<uint16_t, SegmentationOffload::CoalesceCallback> callbacks;
+  return callbacks;
+}
+
+void
+SegmentationOffload::RegisterCoalesce (uint16_t protocol, CoalesceCallback cb)
+{
+  NS_LOG_FUNCTION (protocol);
+  GetCoalesceCallbacks ()[protocol] = cb;
+}
+
+Ptr<Packet>
+SegmentationOffload::Coalesce (Ptr<const Packet> held, Ptr<const Packet> packet, uint16_t protocol)
+{
+  NS_LOG_FUNCTION (held << packet << protocol);
+
+  std::map<uint16_t, CoalesceCallback>::const_iterator it = GetCoalesceCallbacks ().find (protocol);
+  if (it == GetCoalesceCallbacks ().end ())
+    {
+      return 0;
+    }
+  return it->second (held, packet);
+}
+
+ReceiveCoalescer::ReceiveCoalescer ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ReceiveCoalescer::~ReceiveCoalescer ()
+{
+  NS_LOG_FUNCTION (this);
+  m_flushEvent.Cancel ();
+}
+
+void
+ReceiveCoalescer::SetDeliverCallback (DeliverCallback cb)
+{
+  m_deliver = cb;
+}
+
+void
+ReceiveCoalescer::Receive (Ptr<Packet> packet, uint16_t protocol, const Address &from)
+{
+  NS_LOG_FUNCTION (this << packet << protocol << from);
+
+  if (!m_items.empty ())
+    {
+      Item &last = m_items.back ();
+      if (last.protocol == protocol && last.from == from)
+        {
+          Ptr<Packet> merged = SegmentationOffload::Coalesce (last.packet, packet, protocol);
+          if (merged != 0)
+            {
+              NS_LOG_LOGIC ("Merged into a packet of " << merged->GetSize () << " bytes");
+              last.packet = merged;
+              return;
+            }
+        }
+    }
+
+  Item item;
+  item.packet = packet;
+  item.protocol = protocol;
+  item.from = from;
+  m_items.push_back (item);
+  if (!m_flushEvent.IsRunning ())
+    {
+      m_flushEvent = Simulator::ScheduleNow (&ReceiveCoalescer::Flush, this);
+    }
+}
+
+void
+ReceiveCoalescer::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_flushEvent.Cancel ();
+
+  // The delivery may trigger new receptions
+  std::vector<Item> items;
+  items.swap (m_items);
+  for (std::vector<Item>::iterator it = items.begin (); it != items.end (); it++)
+    {
+      m_deliver (it->packet, it->protocol, it->from);
+    }
+}
+
+void
+ReceiveCoalescer::Dispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_flushEvent.Cancel ();
+  m_items.clear ();
+  m_deliver = MakeNullCallback<void, Ptr<Packet>, uint16_t, const Address &> ();
+}
+
+} // namespace ns3
@@ -0,0 +1,362 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <map>
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "batch-run-helper.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/data-collector.h"
+#include "ns3/data-calculator.h"
+#include "ns3/data-output-interface.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BatchRunHelper");
+
+namespace {
+
+/**
+ * \param field a CSV field.
+ * \returns the field, quoted if needed.
+ */
+std::string
+CsvQuote (const std::string &field)
+{
+  if (field.find_first_of (",\"\n") == std::string::npos)
+    {
+      return field;
+    }
+  std::string quoted = "\"";
+  for (std::string::const_iterator i = field.begin (); i != field.end (); i++)
+    {
+      if (*i == '"')
+        {
+          quoted += '"';
+        }
+      quoted += *i;
+    }
+  return quoted + "\"";
+}
+
+/**
+ * Write the values of the calculators of a DataCollector as CSV lines.
+ */
+class CsvOutputCallback : public DataOutputCallback
+{
+public:
+  /**
+   * \param os the output stream.
+   * \param prefix the first columns of every line, including the
+   *        trailing comma.
+   */
+  CsvOutputCallback (std::ostream &os, std::string prefix)
+    : m_os (os),
+      m_prefix (prefix)
+  {
+  }
+
+  void OutputStatistic (std::string key, std::string variable,
+                        const StatisticalSummary *statSum)
+  {
+    OutputSingleton (key, variable + "-count", (double)statSum->getCount ());
+    if (!isNaN (statSum->getSum ()))
+      {
+        OutputSingleton (key, variable + "-total", statSum->getSum ());
+      }
+    if (!isNaN (statSum->getMax ()))
+      {
+        OutputSingleton (key, variable + "-max", statSum->getMax ());
+      }
+    if (!isNaN (statSum->getMin ()))
+      {
+        OutputSingleton (key, variable + "-min", statSum->getMin ());
+      }
+    if (!isNaN (statSum->getSqrSum ()))
+      {
+        OutputSingleton (key, variable + "-sqrsum", statSum->getSqrSum ());
+      }
+    if (!isNaN (statSum->getStddev ()))
+      {
+        OutputSingleton (key, variable + "-stddev", statSum->getStddev ());
+      }
+  }
+  void OutputSingleton (std::string key, std::string variable, int val)
+  {
+    Write (key, variable) << val << std::endl;
+  }
+  void OutputSingleton (std::string key, std::string variable, uint32_t val)
+  {
+    Write (key, variable) << val << std::endl;
+  }
+  void OutputSingleton (std::string key, std::string variable, double val)
+  {
+    Write (key, variable) << std::setprecision (15) << val << std::endl;
+  }
+  void OutputSingleton (std::string key, std::string variable, std::string val)
+  {
+    Write (key, variable) << CsvQuote (val) << std::endl;
+  }
+  void OutputSingleton (std::string key, std::string variable, Time val)
+  {
+    Write (key, variable) << std::setprecision (15) << val.GetSeconds () << std::endl;
+  }
+
+private:
+  /**
+   * Write the first columns of a line.
+   * \param key the calculator key.
+   * \param variable the variable name.
+   * \returns the output stream.
+   */
+  std::ostream & Write (std::string key, std::string variable)
+  {
+    return m_os << m_prefix << CsvQuote (key) << "," << CsvQuote (variable) << ",";
+  }
+
+  std::ostream &m_os;   //!< The output stream
+  std::string m_prefix; //!< The first columns of every line
+};
+
+} // anonymous namespace
+
+BatchRunHelper::BatchRunHelper ()
+  : m_experiment ("batch"),
+    m_replications (1),
+    m_workers (1),
+    m_baseRun (1),
+    m_runsPerHour (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BatchRunHelper::~BatchRunHelper ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+BatchRunHelper::SetExperiment (std::string experiment)
+{
+  NS_LOG_FUNCTION (this << experiment);
+  m_experiment = experiment;
+}
+
+uint32_t
+BatchRunHelper::AddPoint (std::string label)
+{
+  NS_LOG_FUNCTION (this << label);
+  m_points.push_back (label);
+  return m_points.size () - 1;
+}
+
+void
+BatchRunHelper::SetReplications (uint32_t replications)
+{
+  NS_LOG_FUNCTION (this << replications);
+  NS_ABORT_MSG_IF (replications == 0, "BatchRunHelper needs at least one replication");
+  m_replications = replications;
+}
+
+void
+BatchRunHelper::SetWorkers (uint32_t workers)
+{
+  NS_LOG_FUNCTION (this << workers);
+  m_workers = workers;
+}
+
+void
+BatchRunHelper::SetBaseRun (uint64_t run)
+{
+  NS_LOG_FUNCTION (this << run);
+  m_baseRun = run;
+}
+
+void
+BatchRunHelper::SetRunCallback (RunCallback callback)
+{
+  NS_LOG_FUNCTION (this << &callback);
+  m_runCallback = callback;
+}
+
+uint64_t
+BatchRunHelper::GetRun (uint32_t point, uint32_t replication) const
+{
+  return m_baseRun + (uint64_t)point * m_replications + replication;
+}
+
+uint32_t
+BatchRunHelper::GetJobCount (void) const
+{
+  return m_points.size () * m_replications;
+}
+
+double
+BatchRunHelper::GetRunsPerHour (void) const
+{
+  return m_runsPerHour;
+}
+
+std::string
+BatchRunHelper::GetJobFileName (std::string fileName, uint32_t job) const
+{
+  std::ostringstream oss;
+  oss << fileName << ".job-" << job;
+  return oss.str ();
+}
+
+bool
+BatchRunHelper::RunJob (uint32_t job, std::string fileName)
+{
+  NS_LOG_FUNCTION (this << job << fileName);
+  uint32_t point = job / m_replications;
+  uint32_t replication = job % m_replications;
+  uint64_t run = GetRun (point, replication);
+  RngSeedManager::SetRun (run);
+
+  std::ostringstream input;
+  input << replication;
+  std::ostringstream runLabel;
+  runLabel << run;
+  DataCollector collector;
+  collector.DescribeRun (m_experiment, m_points[point], input.str (), runLabel.str ());
+
+  m_runCallback (point, collector);
+
+  std::ofstream os (fileName.c_str ());
+  std::ostringstream prefix;
+  prefix << run << "," << CsvQuote (m_experiment) << "," << CsvQuote (m_points[point])
+         << "," << replication << ",";
+  for (MetadataList::iterator i = collector.MetadataBegin ();
+       i != collector.MetadataEnd (); i++)
+    {
+      os << prefix.str () << "metadata," << CsvQuote (i->first) << ","
+         << CsvQuote (i->second) << std::endl;
+    }
+  CsvOutputCallback callback (os, prefix.str ());
+  for (DataCalculatorList::iterator i = collector.DataCalculatorBegin ();
+       i != collector.DataCalculatorEnd (); i++)
+    {
+      (*i)->Output (callback);
+    }
+  os.close ();
+
+  Simulator::Destroy ();
+  return !os.fail ();
+}
+
+uint32_t
+BatchRunHelper::Run (std::string fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  NS_ABORT_MSG_IF (m_runCallback.IsNull (), "BatchRunHelper needs a run callback");
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  uint32_t jobs = GetJobCount ();
+  std::vector<bool> failed (jobs, false);
+
+  if (m_workers == 0)
+    {
+      for (uint32_t job = 0; job < jobs; job++)
+        {
+          failed[job] = !RunJob (job, GetJobFileName (fileName, job));
+        }
+    }
+  else
+    {
+      std::map<pid_t, uint32_t> running;
+      uint32_t next = 0;
+      while (next < jobs || !running.empty ())
+        {
+          while (next < jobs && running.size () < m_workers)
+            {
+              // do not let the children flush the buffered output of the parent
+              std::cout.flush ();
+              std::cerr.flush ();
+              std::fflush (0);
+              pid_t pid = fork ();
+              NS_ABORT_MSG_IF (pid < 0, "BatchRunHelper: fork failed");
+              if (pid == 0)
+                {
+                  bool ok = RunJob (next, GetJobFileName (fileName, next));
+                  _exit (ok ? 0 : 1);
+                }
+              NS_LOG_LOGIC ("job " << next << " runs in process " << pid);
+              running[pid] = next;
+              next++;
+            }
+          int status;
+          pid_t pid = waitpid (-1, &status, 0);
+          if (pid < 0)
+            {
+              break;
+            }
+          std::map<pid_t, uint32_t>::iterator i = running.find (pid);
+          if (i == running.end ())
+            {
+              continue;
+            }
+          if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+            {
+              NS_LOG_WARN ("job " << i->second << " failed with status " << status);
+              failed[i->second] = true;
+            }
+          running.erase (i);
+        }
+    }
+
+  std::ofstream os (fileName.c_str ());
+  NS_ABORT_MSG_IF (!os.is_open (), "BatchRunHelper: cannot open " << fileName);
+  os << "run,experiment,strategy,input,key,variable,value" << std::endl;
+  uint32_t failures = 0;
+  for (uint32_t job = 0; job < jobs; job++)
+    {
+      std::string jobFileName = GetJobFileName (fileName, job);
+      std::ifstream is (jobFileName.c_str ());
+      if (failed[job] || !is.is_open ())
+        {
+          failures++;
+        }
+      else if (is.peek () != std::ifstream::traits_type::eof ())
+        {
+          os << is.rdbuf ();
+        }
+      is.close ();
+      std::remove (jobFileName.c_str ());
+    }
+  os.close ();
+
+  int64_t elapsed = clock.End ();
+  m_runsPerHour = (jobs - failures) * 3600000.0 / (elapsed > 0 ? elapsed : 1);
+  NS_LOG_INFO (jobs << " jobs, " << failures << " failed, "
+                    << m_runsPerHour << " runs per hour");
+  return failures;
+}
+
+} // namespace ns3
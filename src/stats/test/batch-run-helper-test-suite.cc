@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "ns3/test.h"
+#include "ns3/batch-run-helper.h"
+#include "ns3/basic-data-calculators.h"
+#include "ns3/data-collector.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+
+using namespace ns3;
+
+/**
+ * Run one job: draw a few samples at regular times, with a mean which
+ * depends on the sweep point.
+ */
+static void
+BatchRunJob (uint32_t point, DataCollector &collector)
+{
+  Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable> ();
+  rv->SetStream (1);
+  Ptr<MinMaxAvgTotalCalculator<double> > samples = CreateObject<MinMaxAvgTotalCalculator<double> > ();
+  samples->SetContext ("node");
+  samples->SetKey ("samples");
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      double value = point * 10 + rv->GetValue ();
+      Simulator::Schedule (Seconds (i), &MinMaxAvgTotalCalculator<double>::Update, samples, value);
+    }
+  Simulator::Run ();
+  collector.AddDataCalculator (samples);
+  collector.AddMetadata ("end", Simulator::Now ().GetSeconds ());
+}
+
+class BatchRunHelperTestCase : public TestCase
+{
+public:
+  BatchRunHelperTestCase ();
+
+private:
+  virtual void DoRun (void);
+  std::string RunBatch (uint32_t workers);
+};
+
+BatchRunHelperTestCase::BatchRunHelperTestCase ()
+  : TestCase ("Check that the batch results do not depend on the number of workers")
+{
+}
+
+std::string
+BatchRunHelperTestCase::RunBatch (uint32_t workers)
+{
+  std::ostringstream name;
+  name << "batch-" << workers << ".csv";
+  std::string fileName = CreateTempDirFilename (name.str ());
+
+  BatchRunHelper batch;
+  batch.SetExperiment ("batch-test");
+  batch.AddPoint ("low");
+  batch.AddPoint ("high");
+  batch.SetReplications (3);
+  batch.SetBaseRun (5);
+  batch.SetWorkers (workers);
+  batch.SetRunCallback (MakeCallback (&BatchRunJob));
+  NS_TEST_EXPECT_MSG_EQ (batch.GetJobCount (), 6, "Wrong number of jobs");
+  NS_TEST_EXPECT_MSG_EQ (batch.GetRun (1, 2), 10, "Wrong run number");
+  uint32_t failures = batch.Run (fileName);
+  NS_TEST_EXPECT_MSG_EQ (failures, 0, "Some jobs failed");
+  NS_TEST_EXPECT_MSG_GT (batch.GetRunsPerHour (), 0, "No throughput measured");
+
+  std::ifstream is (fileName.c_str ());
+  std::ostringstream content;
+  content << is.rdbuf ();
+  return content.str ();
+}
+
+void
+BatchRunHelperTestCase::DoRun (void)
+{
+  std::string sequential = RunBatch (0);
+  std::string parallel = RunBatch (3);
+  NS_TEST_ASSERT_MSG_EQ (parallel, sequential, "Results depend on the number of workers");
+
+  uint32_t lines = 0;
+  std::istringstream is (parallel);
+  std::string line;
+  std::getline (is, line);
+  NS_TEST_EXPECT_MSG_EQ (line, "run,experiment,strategy,input,key,variable,value", "Wrong header");
+  while (std::getline (is, line))
+    {
+      lines++;
+    }
+  // 6 jobs, each with one metadata line and the 6 statistics of the calculator
+  NS_TEST_EXPECT_MSG_EQ (lines, 6 * 7, "Wrong number of result lines");
+  NS_TEST_EXPECT_MSG_NE (parallel.find ("5,batch-test,low,0,metadata,end,9"), std::string::npos,
+                         "Missing metadata of the first job");
+  NS_TEST_EXPECT_MSG_NE (parallel.find ("10,batch-test,high,2,node,samples-min,10."), std::string::npos,
+                         "Missing statistic of the last job");
+}
+
+class BatchRunHelperTestSuite : public TestSuite
+{
+public:
+  BatchRunHelperTestSuite ();
+};
+
+BatchRunHelperTestSuite::BatchRunHelperTestSuite ()
+  : TestSuite ("batch-run-helper", UNIT)
+{
+  AddTestCase (new BatchRunHelperTestCase, TestCase::QUICK);
+}
+
+static BatchRunHelperTestSuite batchRunHelperTestSuite;
@@ -22,6 +22,7 @@
 #include "ns3/node.h"
 #include "ns3/channel.h"
 #include "ns3/packet.h"
+#include "ns3/checksum-offload.h"
 #include "ns3/ethernet-header.h"
 #include "ns3/llc-snap-header.h"
 #include "ns3/log.h"
@@ -987,7 +988,7 @@ TapBridge::ReceiveFromBridgedDevice (
   NS_LOG_LOGIC ("Pkt size is " << p->GetSize ());
 
   NS_ASSERT_MSG (p->GetSize () <= 65536, "TapBridge::ReceiveFromBridgedDevice: Packet too big " << p->GetSize ());
-  p->CopyData (m_packetBuffer, p->GetSize ());
+  ChecksumOffload::Complete (p)->CopyData (m_packetBuffer, p->GetSize ());
 
   uint32_t bytesWritten = write (m_sock, m_packetBuffer, p->GetSize ());
   NS_ABORT_MSG_IF (bytesWritten != p->GetSize (), "TapBridge::ReceiveFromBridgedDevice(): Write error.");
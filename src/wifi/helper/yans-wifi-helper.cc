@@ -37,11 +37,157 @@
 #include "ns3/names.h"
 #include "ns3/abort.h"
 #include "ns3/log.h"
+#include <cstdlib>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("YansWifiHelper");
 
+/**
+ * \brief Write the events of a wifi PHY into a binary trace
+ */
+class WifiBinaryTraceSink : public SimpleRefCount<WifiBinaryTraceSink>
+{
+public:
+  /**
+   * \param writer the binary trace
+   * \param phy the traced PHY
+   * \param node the node identifier
+   * \param device the device index
+   */
+  WifiBinaryTraceSink (Ptr<BinaryTraceWriter> writer, WifiPhy *phy,
+                       uint32_t node, uint32_t device);
+  /**
+   * MonitorSnifferTx sink.
+   * \param packet the packet being transmitted
+   * \param channelFreqMhz the channel frequency
+   * \param channelNumber the channel number
+   * \param rate the PHY data rate
+   * \param preamble the preamble of the packet
+   * \param txVector the TXVECTOR of the packet
+   * \param aMpdu the A-MPDU information
+   */
+  void Tx (Ptr<const Packet> packet, uint16_t channelFreqMhz, uint16_t channelNumber,
+           uint32_t rate, WifiPreamble preamble, WifiTxVector txVector, struct mpduInfo aMpdu);
+  /**
+   * MonitorSnifferRx sink.
+   * \param packet the packet received
+   * \param channelFreqMhz the channel frequency
+   * \param channelNumber the channel number
+   * \param rate the PHY data rate
+   * \param preamble the preamble of the packet
+   * \param txVector the TXVECTOR of the packet
+   * \param aMpdu the A-MPDU information
+   * \param signalNoise the signal and noise power
+   */
+  void Rx (Ptr<const Packet> packet, uint16_t channelFreqMhz, uint16_t channelNumber,
+           uint32_t rate, WifiPreamble preamble, WifiTxVector txVector, struct mpduInfo aMpdu,
+           struct signalNoiseDbm signalNoise);
+  /**
+   * PhyTxDrop and PhyRxDrop sink.
+   * \param packet the packet dropped
+   */
+  void Drop (Ptr<const Packet> packet);
+
+private:
+  /**
+   * \param mode a wifi mode
+   * \returns the MCS of this mode, or BinaryTraceRecord::NONE
+   */
+  uint8_t GetMcs (WifiMode mode);
+
+  Ptr<BinaryTraceWriter> m_writer;      //!< The binary trace
+  WifiPhy *m_phy;                       //!< The traced PHY, which owns this sink
+  BinaryTraceRecord m_record;           //!< Record with the node and device set
+  uint32_t m_lastModeUid;               //!< Last mode given to GetMcs
+  uint8_t m_lastMcs;                    //!< MCS of m_lastModeUid
+};
+
+WifiBinaryTraceSink::WifiBinaryTraceSink (Ptr<BinaryTraceWriter> writer, WifiPhy *phy,
+                                          uint32_t node, uint32_t device)
+  : m_writer (writer),
+    m_phy (phy),
+    m_lastModeUid (0xffffffff),
+    m_lastMcs (BinaryTraceRecord::NONE)
+{
+  m_record.node = node;
+  m_record.device = device;
+}
+
+uint8_t
+WifiBinaryTraceSink::GetMcs (WifiMode mode)
+{
+  if (mode.GetUid () == m_lastModeUid)
+    {
+      return m_lastMcs;
+    }
+  m_lastModeUid = mode.GetUid ();
+  switch (mode.GetModulationClass ())
+    {
+    case WIFI_MOD_CLASS_HT:
+    case WIFI_MOD_CLASS_VHT:
+      m_lastMcs = mode.GetMcsValue ();
+      break;
+    case WIFI_MOD_CLASS_DMG_CTRL:
+    case WIFI_MOD_CLASS_DMG_SC:
+    case WIFI_MOD_CLASS_DMG_OFDM:
+    case WIFI_MOD_CLASS_DMG_LP_SC:
+      {
+        // the DMG modes are named after their MCS, as DMG_MCS12
+        std::string name = mode.GetUniqueName ();
+        std::string::size_type pos = name.find ("MCS");
+        m_lastMcs = pos != std::string::npos ? std::atoi (name.c_str () + pos + 3)
+          : static_cast<int> (BinaryTraceRecord::NONE);
+        break;
+      }
+    default:
+      m_lastMcs = BinaryTraceRecord::NONE;
+      break;
+    }
+  return m_lastMcs;
+}
+
+void
+WifiBinaryTraceSink::Tx (Ptr<const Packet> packet, uint16_t channelFreqMhz, uint16_t channelNumber,
+                         uint32_t rate, WifiPreamble preamble, WifiTxVector txVector, struct mpduInfo aMpdu)
+{
+  Ptr<DirectionalAntenna> antenna = m_phy->GetDirectionalAntenna ();
+  m_record.time = Simulator::Now ().GetNanoSeconds ();
+  m_record.event = BinaryTraceRecord::TX;
+  m_record.size = packet->GetSize ();
+  m_record.mcs = GetMcs (txVector.GetMode ());
+  m_record.sector = antenna != 0 ? antenna->GetCurrentTxSectorID () : BinaryTraceRecord::NONE;
+  m_record.snr = 0;
+  m_writer->Write (m_record);
+}
+
+void
+WifiBinaryTraceSink::Rx (Ptr<const Packet> packet, uint16_t channelFreqMhz, uint16_t channelNumber,
+                         uint32_t rate, WifiPreamble preamble, WifiTxVector txVector, struct mpduInfo aMpdu,
+                         struct signalNoiseDbm signalNoise)
+{
+  Ptr<DirectionalAntenna> antenna = m_phy->GetDirectionalAntenna ();
+  m_record.time = Simulator::Now ().GetNanoSeconds ();
+  m_record.event = BinaryTraceRecord::RX;
+  m_record.size = packet->GetSize ();
+  m_record.mcs = GetMcs (txVector.GetMode ());
+  m_record.sector = antenna != 0 ? antenna->GetCurrentRxSectorID () : BinaryTraceRecord::NONE;
+  m_record.snr = signalNoise.signal - signalNoise.noise;
+  m_writer->Write (m_record);
+}
+
+void
+WifiBinaryTraceSink::Drop (Ptr<const Packet> packet)
+{
+  m_record.time = Simulator::Now ().GetNanoSeconds ();
+  m_record.event = BinaryTraceRecord::DROP;
+  m_record.size = packet->GetSize ();
+  m_record.mcs = BinaryTraceRecord::NONE;
+  m_record.sector = BinaryTraceRecord::NONE;
+  m_record.snr = 0;
+  m_writer->Write (m_record);
+}
+
 static void
 AsciiPhyTransmitSinkWithContext (
   Ptr<OutputStreamWrapper> stream,
@@ -318,7 +464,8 @@ PcapSniffTxEvent (
       }
     case PcapHelper::DLT_IEEE802_11_RADIO:
       {
-        Ptr<Packet> p = packet->Copy ();
+        // the radiotap header is written before the packet, without a copy
+        Ptr<const Packet> p = packet;
         RadiotapHeader header;
         uint8_t frameFlags = RadiotapHeader::FRAME_FLAG_NONE;
         header.SetTsft (Simulator::Now ().GetMicroSeconds ());
@@ -420,9 +567,9 @@ PcapSniffTxEvent (
             /* For PCAP file, MPDU Delimiter and Padding should be removed by the MAC Driver */
             AmpduSubframeHeader hdr;
             uint32_t extractedLength;
-            p->RemoveHeader (hdr);
+            packet->PeekHeader (hdr);
             extractedLength = hdr.GetLength ();
-            p = p->CreateFragment (0, static_cast<uint32_t> (extractedLength));
+            p = packet->CreateFragment (hdr.GetSerializedSize (), static_cast<uint32_t> (extractedLength));
             if (aMpdu.type == LAST_MPDU_IN_AGGREGATE || (hdr.GetEof () == true && hdr.GetLength () > 0))
               {
                 ampduStatusFlags |= RadiotapHeader::A_MPDU_STATUS_LAST;
@@ -476,8 +623,7 @@ PcapSniffTxEvent (
             header.SetVhtFields (vhtKnown, vhtFlags, vhtBandwidth, vhtMcsNss, vhtCoding, vhtGroupId, vhtPartialAid);
           }
 
-        p->AddHeader (header);
-        file->Write (Simulator::Now (), p);
+        file->Write (Simulator::Now (), header, p);
         return;
       }
     default:
@@ -511,7 +657,8 @@ PcapSniffRxEvent (
       }
     case PcapHelper::DLT_IEEE802_11_RADIO:
       {
-        Ptr<Packet> p = packet->Copy ();
+        // the radiotap header is written before the packet, without a copy
+        Ptr<const Packet> p = packet;
         RadiotapHeader header;
         uint8_t frameFlags = RadiotapHeader::FRAME_FLAG_NONE;
         header.SetTsft (Simulator::Now ().GetMicroSeconds ());
@@ -617,9 +764,9 @@ PcapSniffRxEvent (
             /* For PCAP file, MPDU Delimiter and Padding should be removed by the MAC Driver */
             AmpduSubframeHeader hdr;
             uint32_t extractedLength;
-            p->RemoveHeader (hdr);
+            packet->PeekHeader (hdr);
             extractedLength = hdr.GetLength ();
-            p = p->CreateFragment (0, static_cast<uint32_t> (extractedLength));
+            p = packet->CreateFragment (hdr.GetSerializedSize (), static_cast<uint32_t> (extractedLength));
             if (aMpdu.type == LAST_MPDU_IN_AGGREGATE || (hdr.GetEof () == true && hdr.GetLength () > 0))
               {
                 ampduStatusFlags |= RadiotapHeader::A_MPDU_STATUS_LAST;
@@ -673,8 +820,7 @@ PcapSniffRxEvent (
             header.SetVhtFields (vhtKnown, vhtFlags, vhtBandwidth, vhtMcsNss, vhtCoding, vhtGroupId, vhtPartialAid);
           }
 
-        p->AddHeader (header);
-        file->Write (Simulator::Now (), p);
+        file->Write (Simulator::Now (), header, p);
         return;
       }
     default:
@@ -766,6 +912,28 @@ YansWifiPhyHelper::EnableMultiBandPcap (std::string prefix, Ptr<NetDevice> nd, P
   phy->TraceConnectWithoutContext ("MonitorSnifferRx", MakeBoundCallback (&PcapSniffRxEvent, file));
 }
 
+void
+YansWifiPhyHelper::EnableBinaryTrace (Ptr<BinaryTraceWriter> writer, NetDeviceContainer devices)
+{
+  for (NetDeviceContainer::Iterator i = devices.Begin (); i != devices.End (); ++i)
+    {
+      Ptr<WifiNetDevice> device = (*i)->GetObject<WifiNetDevice> ();
+      if (device == 0)
+        {
+          NS_LOG_INFO ("YansWifiHelper::EnableBinaryTrace(): Device " << *i << " not of type ns3::WifiNetDevice");
+          continue;
+        }
+      Ptr<WifiPhy> phy = device->GetPhy ();
+      NS_ABORT_MSG_IF (phy == 0, "YansWifiPhyHelper::EnableBinaryTrace(): Phy layer in WifiNetDevice must be set");
+      Ptr<WifiBinaryTraceSink> sink = ns3::Create<WifiBinaryTraceSink> (writer, PeekPointer (phy), device->GetNode ()->GetId (),
+                                                                        device->GetIfIndex ());
+      phy->TraceConnectWithoutContext ("MonitorSnifferTx", MakeCallback (&WifiBinaryTraceSink::Tx, sink));
+      phy->TraceConnectWithoutContext ("MonitorSnifferRx", MakeCallback (&WifiBinaryTraceSink::Rx, sink));
+      phy->TraceConnectWithoutContext ("PhyTxDrop", MakeCallback (&WifiBinaryTraceSink::Drop, sink));
+      phy->TraceConnectWithoutContext ("PhyRxDrop", MakeCallback (&WifiBinaryTraceSink::Drop, sink));
+    }
+}
+
 void
 YansWifiPhyHelper::EnableAsciiInternal (
   Ptr<OutputStreamWrapper> stream,
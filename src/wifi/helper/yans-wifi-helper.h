@@ -23,6 +23,8 @@
 
 #include "wifi-helper.h"
 #include "ns3/trace-helper.h"
+#include "ns3/binary-trace.h"
+#include "ns3/net-device-container.h"
 #include "ns3/yans-wifi-channel.h"
 
 namespace ns3 {
@@ -301,6 +303,20 @@ public:
                             Ptr<NetDevice> nd,
                             Ptr<WifiPhy> phy);
 
+  /**
+   * @brief Enable binary trace output on the indicated net devices.
+   *
+   * Each frame transmitted or received by the PHY is a TX or RX
+   * BinaryTraceRecord, with its MCS, the current sector of the
+   * directional antenna if any, and the SNR of the received frames.
+   * The frames dropped by the PHY are DROP records.
+   *
+   * @param writer The binary trace, shared by all the devices.
+   * @param devices The devices; the ones which are not of type
+   *        ns3::WifiNetDevice are ignored.
+   */
+  void EnableBinaryTrace (Ptr<BinaryTraceWriter> writer, NetDeviceContainer devices);
+
 private:
   /**
    * \param node the node on which we wish to create a wifi PHY
@@ -658,6 +658,10 @@ BlockAckManager::NotifyGotBlockAck (const CtrlBAckResponseHeader *blockAck, Mac4
                 }
             }
           m_stationManager->ReportAmpduTxStatus (recipient, tid, nSuccessfulMpdus, nFailedMpdus, rxSnr, dataSnr);
+          if (!m_blockAckStatusCallback.IsNull ())
+            {
+              m_blockAckStatusCallback (recipient, tid, nSuccessfulMpdus, nFailedMpdus);
+            }
           uint16_t newSeq = m_txMiddle->GetNextSeqNumberByTidAndAddress (tid, recipient);
           if ((foundFirstLost && !SwitchToBlockAckIfNeeded (recipient, tid, sequenceFirstLost))
               || (!foundFirstLost && !SwitchToBlockAckIfNeeded (recipient, tid, newSeq)))
@@ -966,6 +970,12 @@ BlockAckManager::SetTxFailedCallback (TxFailed callback)
   m_txFailedCallback = callback;
 }
 
+void
+BlockAckManager::SetBlockAckStatusCallback (BlockAckStatus callback)
+{
+  m_blockAckStatusCallback = callback;
+}
+
 void
 BlockAckManager::InsertInRetryQueue (PacketQueueI item)
 {
@@ -356,6 +356,16 @@ public:
    * packet transmission was completed unsuccessfully.
    */
   void SetTxFailedCallback (TxFailed callback);
+  /**
+   * typedef for a callback to invoke when a block ack is received:
+   * the recipient, the TID, and the numbers of acknowledged and missing
+   * MPDUs.
+   */
+  typedef Callback <void, Mac48Address, uint8_t, uint32_t, uint32_t> BlockAckStatus;
+  /**
+   * \param callback the callback to invoke when a block ack is received.
+   */
+  void SetBlockAckStatusCallback (BlockAckStatus callback);
 
 
 private:
@@ -456,6 +466,7 @@ private:
   Callback<void, Mac48Address, uint8_t> m_unblockPackets;
   TxOk m_txOkCallback;
   TxFailed m_txFailedCallback;
+  BlockAckStatus m_blockAckStatusCallback;
   Ptr<WifiRemoteStationManager> m_stationManager;
 };
 
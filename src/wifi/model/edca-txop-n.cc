@@ -245,6 +245,11 @@ EdcaTxopN::GetTypeId (void)
     .AddTraceSource ("AccessGranted", "EDCA is granted an access to the channel",
                      MakeTraceSourceAccessor (&EdcaTxopN::m_accessGrantedTrace),
                      "ns3::EdcaTxopN::AccessGrantedTracedCallback")
+    .AddTraceSource ("BlockAckStatus",
+                     "The numbers of MPDUs acknowledged and not acknowledged by a block ack, "
+                     "or not acknowledged because the block ack is missed",
+                     MakeTraceSourceAccessor (&EdcaTxopN::m_blockAckStatusTrace),
+                     "ns3::EdcaTxopN::BlockAckStatusCallback")
   ;
   return tid;
 }
@@ -272,6 +277,7 @@ EdcaTxopN::EdcaTxopN ()
   m_baManager->SetMaxPacketDelay (m_queue->GetMaxDelay ());
   m_baManager->SetTxOkCallback (MakeCallback (&EdcaTxopN::BaTxOk, this));
   m_baManager->SetTxFailedCallback (MakeCallback (&EdcaTxopN::BaTxFailed, this));
+  m_baManager->SetBlockAckStatusCallback (MakeCallback (&EdcaTxopN::BaStatus, this));
 }
 
 EdcaTxopN::~EdcaTxopN ()
@@ -946,6 +952,7 @@ EdcaTxopN::MissedBlockAck (uint32_t nMpdus)
   if (GetAmpduExist (m_currentHdr.GetAddr1 ()))
     {
       m_stationManager->ReportAmpduTxStatus (m_currentHdr.GetAddr1 (), tid, 0, nMpdus, 0, 0);
+      m_blockAckStatusTrace (m_currentHdr.GetAddr1 (), tid, 0, nMpdus);
     }
   if (NeedBarRetransmission ())
     {
@@ -1648,4 +1655,11 @@ EdcaTxopN::BaTxFailed (const WifiMacHeader &hdr)
     }
 }
 
+void
+EdcaTxopN::BaStatus (Mac48Address recipient, uint8_t tid, uint32_t nSuccessfulMpdus, uint32_t nFailedMpdus)
+{
+  NS_LOG_FUNCTION (this << recipient << static_cast<uint32_t> (tid) << nSuccessfulMpdus << nFailedMpdus);
+  m_blockAckStatusTrace (recipient, tid, nSuccessfulMpdus, nFailedMpdus);
+}
+
 } //namespace ns3
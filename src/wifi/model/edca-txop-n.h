@@ -464,6 +464,15 @@ public:
    * \param hdr the header of the packet that we failed to sent
    */
   void BaTxFailed (const WifiMacHeader &hdr);
+  /**
+   * The BlockAckManager received a block ack.
+   *
+   * \param recipient the mac address of the recipient
+   * \param tid the TID of the MPDUs
+   * \param nSuccessfulMpdus the number of MPDUs acknowledged
+   * \param nFailedMpdus the number of MPDUs not acknowledged
+   */
+  void BaStatus (Mac48Address recipient, uint8_t tid, uint32_t nSuccessfulMpdus, uint32_t nFailedMpdus);
 
   /**
    * Assign a fixed random variable stream number to the random variables
@@ -482,6 +491,17 @@ public:
    * \param queueSize the size of the Wifi Queue
    */
   typedef void (* AccessGrantedCallback)(Mac48Address address, uint32_t queueSize);
+  /**
+   * TracedCallback signature for the block ack status of an A-MPDU.
+   *
+   * \param recipient the mac address of the recipient
+   * \param tid the TID of the MPDUs
+   * \param nSuccessfulMpdus the number of MPDUs acknowledged
+   * \param nFailedMpdus the number of MPDUs not acknowledged, or all
+   *        the MPDUs if the block ack is missed
+   */
+  typedef void (* BlockAckStatusCallback)(Mac48Address recipient, uint8_t tid,
+                                          uint32_t nSuccessfulMpdus, uint32_t nFailedMpdus);
 
 private:
   void DoInitialize ();
@@ -579,6 +599,7 @@ private:
   struct Bar m_currentBar;
 
   TracedCallback<Mac48Address, uint32_t> m_accessGrantedTrace;
+  TracedCallback<Mac48Address, uint8_t, uint32_t, uint32_t> m_blockAckStatusTrace;
 
   Time m_transmissionStarted;   /* The time of the initiation of transmission */
   Time m_remainingDuration;     /* The remaining duration till the end of this CBAP allocation*/
@@ -431,6 +431,14 @@ MacLow::GetTypeId (void)
     .SetParent<Object> ()
     .SetGroupName ("Wifi")
     .AddConstructor<MacLow> ()
+    .AddTraceSource ("TxMpdu",
+                     "An MPDU, alone or in an A-MPDU, is sent to the PHY",
+                     MakeTraceSourceAccessor (&MacLow::m_txMpduTrace),
+                     "ns3::MacLow::TxMpduCallback")
+    .AddTraceSource ("TxAmpdu",
+                     "An A-MPDU is sent to the PHY",
+                     MakeTraceSourceAccessor (&MacLow::m_txAmpduTrace),
+                     "ns3::MacLow::TxAmpduCallback")
   ;
   return tid;
 }
@@ -1923,8 +1931,10 @@ MacLow::ForwardDown (Ptr<const Packet> packet, const WifiMacHeader* hdr,
         }
     }
 
-  if (!m_ampdu || hdr->IsRts () || hdr->IsBlockAck ())
+  /* An ACK sent while an A-MPDU is suspended must not carry the aggregate */
+  if (!m_ampdu || hdr->IsRts () || hdr->IsBlockAck () || hdr->IsAck ())
     {
+      m_txMpduTrace (*hdr, packet->GetSize ());
       m_phy->SendPacket (packet, txVector, preamble);
     }
   else
@@ -1952,6 +1962,7 @@ MacLow::ForwardDown (Ptr<const Packet> packet, const WifiMacHeader* hdr,
       AmpduTag ampdutag;
       ampdutag.SetAmpdu (true);
       Time delay = Seconds (0);
+      uint32_t ampduSize = 0;
       if (queueSize > 1 || vhtSingleMpdu)
         {
           txVector.SetAggregation (true);
@@ -1959,6 +1970,9 @@ MacLow::ForwardDown (Ptr<const Packet> packet, const WifiMacHeader* hdr,
       for (; queueSize > 0; queueSize--)
         {
           dequeuedPacket = m_aggregateQueue->Dequeue (&newHdr);
+          uint32_t mpduSize = dequeuedPacket->GetSize () + newHdr.GetSize () + fcs.GetSerializedSize ();
+          m_txMpduTrace (newHdr, mpduSize);
+          ampduSize += mpduSize;
           newPacket = dequeuedPacket->Copy ();
           newHdr.SetDuration (hdr->GetDuration ());
           newPacket->AddHeader (newHdr);
@@ -1997,6 +2011,7 @@ MacLow::ForwardDown (Ptr<const Packet> packet, const WifiMacHeader* hdr,
             }
           preamble = WIFI_PREAMBLE_NONE;
         }
+      m_txAmpduTrace (hdr->GetAddr1 (), tid, m_nTxMpdus, ampduSize);
     }
 }
 
@@ -42,6 +42,7 @@
 #include "ns3/event-id.h"
 #include "ns3/packet.h"
 #include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
 #include "qos-utils.h"
 #include "block-ack-cache.h"
 #include "wifi-tx-vector.h"
@@ -949,6 +950,23 @@ public:
    */
   Time CalculateDmgTransactionDuration (Ptr<Packet> packet, WifiMacHeader &hdr);
 
+  /**
+   * TracedCallback signature for MPDU transmissions.
+   *
+   * \param hdr the header of the MPDU, with the retry flag of retransmissions
+   * \param size the size of the MPDU, including the header and the FCS
+   */
+  typedef void (* TxMpduCallback)(const WifiMacHeader &hdr, uint32_t size);
+  /**
+   * TracedCallback signature for A-MPDU transmissions.
+   *
+   * \param recipient the mac address of the recipient
+   * \param tid the TID of the MPDUs
+   * \param nMpdus the number of MPDUs in the A-MPDU
+   * \param size the size of the MPDUs, including their headers and FCS
+   */
+  typedef void (* TxAmpduCallback)(Mac48Address recipient, uint8_t tid, uint32_t nMpdus, uint32_t size);
+
 protected:
   /**
    * Return a TXVECTOR for the DATA frame given the destination.
@@ -1556,6 +1574,8 @@ private:
   MacLowTransmissionParameters m_suspendedTxParams;
   WifiTxVector m_suspendedTxVector;
 
+  TracedCallback<const WifiMacHeader &, uint32_t> m_txMpduTrace;                 //!< MPDU sent to the PHY
+  TracedCallback<Mac48Address, uint8_t, uint32_t, uint32_t> m_txAmpduTrace;     //!< A-MPDU sent to the PHY
 };
 
 } //namespace ns3
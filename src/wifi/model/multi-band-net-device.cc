@@ -26,6 +26,7 @@
 #include "ns3/llc-snap-header.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/pointer.h"
 #include "ns3/node.h"
 #include "ns3/trace-source-accessor.h"
@@ -51,14 +52,22 @@ MultiBandNetDevice::GetTypeId (void)
                    MakeUintegerAccessor (&MultiBandNetDevice::SetMtu,
                                          &MultiBandNetDevice::GetMtu),
                    MakeUintegerChecker<uint16_t> (1, MAX_MSDU_SIZE - LLC_SNAP_HEADER_LENGTH))
+    .AddAttribute ("ReceiveCoalescing",
+                   "Whether to merge the contiguous TCP segments of a flow received in the same "
+                   "event (e.g., the MSDUs of an A-MPDU) before passing them up the stack",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&MultiBandNetDevice::m_receiveCoalescing),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
 
 MultiBandNetDevice::MultiBandNetDevice ()
-  : m_configComplete (false)
+  : m_configComplete (false),
+    m_receiveCoalescing (false)
 {
   NS_LOG_FUNCTION_NOARGS ();
+  m_coalescer.SetDeliverCallback (MakeCallback (&MultiBandNetDevice::DeliverUp, this));
 }
 
 MultiBandNetDevice::~MultiBandNetDevice ()
@@ -72,6 +81,7 @@ MultiBandNetDevice::DoDispose (void)
   NS_LOG_FUNCTION_NOARGS ();
   WifiTechnology *technology;
   m_node = 0;
+  m_coalescer.Dispose ();
   for (WifiTechnologyList::iterator item = m_list.begin (); item != m_list.end (); item++)
     {
       technology = &item->second;
@@ -410,7 +420,14 @@ MultiBandNetDevice::ForwardUp (Ptr<Packet> packet, Mac48Address from, Mac48Addre
   if (type != NetDevice::PACKET_OTHERHOST)
     {
       m_mac->NotifyRx (packet);
-      m_forwardUp (this, packet, llc.GetType (), from);
+      if (m_receiveCoalescing && type == NetDevice::PACKET_HOST)
+        {
+          m_coalescer.Receive (packet, llc.GetType (), from);
+        }
+      else
+        {
+          m_forwardUp (this, packet, llc.GetType (), from);
+        }
     }
 
   if (!m_promiscRx.IsNull ())
@@ -420,6 +437,12 @@ MultiBandNetDevice::ForwardUp (Ptr<Packet> packet, Mac48Address from, Mac48Addre
     }
 }
 
+void
+MultiBandNetDevice::DeliverUp (Ptr<Packet> packet, uint16_t protocol, const Address &from)
+{
+  m_forwardUp (this, packet, protocol, from);
+}
+
 void
 MultiBandNetDevice::LinkUp (void)
 {
@@ -458,4 +481,11 @@ MultiBandNetDevice::SupportsSendFrom (void) const
   return false;
 }
 
+bool
+MultiBandNetDevice::SupportsSegmentationOffload (void) const
+{
+  // The super-segments are split in MSDUs by the WifiMacQueue
+  return true;
+}
+
 } //namespace ns3
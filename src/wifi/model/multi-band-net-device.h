@@ -23,6 +23,7 @@
 #include "ns3/net-device.h"
 #include "ns3/packet.h"
 #include "ns3/traced-callback.h"
+#include "ns3/segmentation-offload.h"
 #include "ns3/mac48-address.h"
 #include "wifi-phy-standard.h"
 #include <string>
@@ -126,6 +127,7 @@ public:
   virtual bool SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber);
   virtual void SetPromiscReceiveCallback (PromiscReceiveCallback cb);
   virtual bool SupportsSendFrom (void) const;
+  virtual bool SupportsSegmentationOffload (void) const;
 
 protected:
   virtual void DoDispose (void);
@@ -139,6 +141,15 @@ protected:
    * \param to
    */
   void ForwardUp (Ptr<Packet> packet, Mac48Address from, Mac48Address to);
+  /**
+   * Pass a received packet, possibly merged by the ReceiveCoalescer, up
+   * the stack.
+   *
+   * \param packet the packet, without LLC header
+   * \param protocol the protocol number
+   * \param from the sender
+   */
+  void DeliverUp (Ptr<Packet> packet, uint16_t protocol, const Address &from);
 
 private:
   // This value conforms to the 802.11 specification
@@ -177,6 +188,8 @@ private:
 
   NetDevice::ReceiveCallback m_forwardUp;
   NetDevice::PromiscReceiveCallback m_promiscRx;
+  bool m_receiveCoalescing;         //!< Whether the received TCP segments are merged
+  ReceiveCoalescer m_coalescer;     //!< Merges the segments received in the same event
   TracedCallback<Ptr<const Packet>, Mac48Address> m_rxLogger;
   TracedCallback<Ptr<const Packet>, Mac48Address> m_txLogger;
 
@@ -26,6 +26,8 @@
 #include "ns3/simulator.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
+#include "ns3/llc-snap-header.h"
+#include "ns3/segmentation-offload.h"
 #include "wifi-mac-queue.h"
 #include "qos-blocked-destinations.h"
 
@@ -111,13 +113,36 @@ void
 WifiMacQueue::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
 {
   Cleanup ();
+  Time now = Simulator::Now ();
+  GsoTag gsoTag;
+  if (packet->PeekPacketTag (gsoTag))
+    {
+      // Split the super-segment in MSDUs here, so that they are aggregated
+      Ptr<Packet> copy = packet->Copy ();
+      LlcSnapHeader llc;
+      copy->RemoveHeader (llc);
+      std::list<Ptr<Packet> > segments = SegmentationOffload::Segment (copy, llc.GetType ());
+      NS_LOG_DEBUG ("Split super-segment of " << packet->GetSize () << " bytes in " << segments.size () << " MSDUs");
+      for (std::list<Ptr<Packet> >::iterator it = segments.begin (); it != segments.end (); it++)
+        {
+          (*it)->AddHeader (llc);
+          if (m_size == m_maxSize)
+            {
+              m_queueDropTrace (*it, QueueFull);
+              NS_LOG_DEBUG ("Drop packet Wifi MAC Queue is full");
+              continue;
+            }
+          m_queue.push_back (Item (*it, hdr, now));
+          m_size++;
+        }
+      return;
+    }
   if (m_size == m_maxSize)
     {
       m_queueDropTrace (packet, QueueFull);
       NS_LOG_DEBUG ("Drop packet Wifi MAC Queue is full");
       return;
     }
-  Time now = Simulator::Now ();
   m_queue.push_back (Item (packet, hdr, now));
   m_size++;
 }
@@ -26,6 +26,7 @@
 #include "ns3/llc-snap-header.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/pointer.h"
 #include "ns3/node.h"
 #include "ns3/trace-source-accessor.h"
@@ -49,6 +50,12 @@ WifiNetDevice::GetTypeId (void)
                    MakeUintegerAccessor (&WifiNetDevice::SetMtu,
                                          &WifiNetDevice::GetMtu),
                    MakeUintegerChecker<uint16_t> (1,MAX_MSDU_SIZE - LLC_SNAP_HEADER_LENGTH))
+    .AddAttribute ("ReceiveCoalescing",
+                   "Whether to merge the contiguous TCP segments of a flow received in the same "
+                   "event (e.g., the MSDUs of an A-MPDU) before passing them up the stack",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&WifiNetDevice::m_receiveCoalescing),
+                   MakeBooleanChecker ())
     .AddAttribute ("Channel", "The channel attached to this device",
                    PointerValue (),
                    MakePointerAccessor (&WifiNetDevice::DoGetChannel),
@@ -73,9 +80,11 @@ WifiNetDevice::GetTypeId (void)
 }
 
 WifiNetDevice::WifiNetDevice ()
-  : m_configComplete (false)
+  : m_receiveCoalescing (false),
+    m_configComplete (false)
 {
   NS_LOG_FUNCTION_NOARGS ();
+  m_coalescer.SetDeliverCallback (MakeCallback (&WifiNetDevice::DeliverUp, this));
 }
 
 WifiNetDevice::~WifiNetDevice ()
@@ -88,6 +97,7 @@ WifiNetDevice::DoDispose (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
   m_node = 0;
+  m_coalescer.Dispose ();
   m_mac->Dispose ();
   m_phy->Dispose ();
   m_stationManager->Dispose ();
@@ -340,7 +350,14 @@ WifiNetDevice::ForwardUp (Ptr<Packet> packet, Mac48Address from, Mac48Address to
     {
       m_mac->NotifyRx (packet);
       packet->RemoveHeader (llc);
-      m_forwardUp (this, packet, llc.GetType (), from);
+      if (m_receiveCoalescing && type == NetDevice::PACKET_HOST)
+        {
+          m_coalescer.Receive (packet, llc.GetType (), from);
+        }
+      else
+        {
+          m_forwardUp (this, packet, llc.GetType (), from);
+        }
     }
   else
     {
@@ -354,6 +371,12 @@ WifiNetDevice::ForwardUp (Ptr<Packet> packet, Mac48Address from, Mac48Address to
     }
 }
 
+void
+WifiNetDevice::DeliverUp (Ptr<Packet> packet, uint16_t protocol, const Address &from)
+{
+  m_forwardUp (this, packet, protocol, from);
+}
+
 void
 WifiNetDevice::LinkUp (void)
 {
@@ -400,4 +423,11 @@ WifiNetDevice::SupportsSendFrom (void) const
   return m_mac->SupportsSendFrom ();
 }
 
+bool
+WifiNetDevice::SupportsSegmentationOffload (void) const
+{
+  // The super-segments are split in MSDUs by the WifiMacQueue
+  return true;
+}
+
 } //namespace ns3
@@ -20,8 +20,10 @@
  *          Hany Assasa <hany.assasa@gmail.com>
  */
 
+#include "ns3/core-config.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
+#include "ns3/make-event.h"
 #include "ns3/mobility-model.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
@@ -32,6 +34,10 @@
 #include "yans-wifi-phy.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/multithreaded-simulator-impl.h"
+#endif
+#include <algorithm>
 
 namespace ns3 {
 
@@ -98,11 +104,59 @@ YansWifiChannel::AddPacketDropper (bool (*dropper)(), Ptr<WifiPhy> srcWifiPhy, P
   m_dstWifiPhy = dstWifiPhy;
 }
 
+Time
+YansWifiChannel::GetMinimumDelay (void) const
+{
+  NS_LOG_FUNCTION (this);
+  Time minimum = Time::Max ();
+  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
+    {
+      Ptr<MobilityModel> a = (*i)->GetMobility ()->GetObject<MobilityModel> ();
+      for (PhyList::const_iterator j = i + 1; j != m_phyList.end (); j++)
+        {
+          if ((*i)->GetChannelNumber () != (*j)->GetChannelNumber ())
+            {
+              continue;
+            }
+          Ptr<MobilityModel> b = (*j)->GetMobility ()->GetObject<MobilityModel> ();
+          minimum = std::min (minimum, m_delay->GetDelay (a, b));
+        }
+    }
+  if (minimum == Time::Max ())
+    {
+      return Seconds (0);
+    }
+  return minimum;
+}
+
 void
 YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
                        WifiTxVector txVector, WifiPreamble preamble, enum mpduType mpdutype, Time duration) const
 {
   NS_LOG_FUNCTION (this << sender << packet << txPowerDbm << txVector << preamble << mpdutype << duration);
+  struct Parameters parameters;
+  parameters.rxPowerDbm = txPowerDbm;
+  parameters.type = mpdutype;
+  parameters.duration = duration;
+  parameters.txVector = txVector;
+  parameters.preamble = preamble;
+#ifdef HAVE_PTHREAD_H
+  Ptr<MultithreadedSimulatorImpl> impl = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != 0)
+    {
+      // the receivers may belong to other partitions
+      impl->ScheduleShared (MakeEvent (&YansWifiChannel::DoSend, this, sender, packet->Copy (), parameters));
+      return;
+    }
+#endif /* HAVE_PTHREAD_H */
+  DoSend (sender, packet, parameters);
+}
+
+void
+YansWifiChannel::DoSend (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, struct Parameters parameters) const
+{
+  NS_LOG_FUNCTION (this << sender << packet << parameters.rxPowerDbm);
+  double txPowerDbm = parameters.rxPowerDbm;
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
   uint32_t j = 0; /* Phy ID */
@@ -194,12 +248,7 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
                 }
 
               /* We are sending PSDU Packet */
-              struct Parameters parameters;
               parameters.rxPowerDbm = rxPowerDbm;
-              parameters.type = mpdutype;
-              parameters.duration = duration;
-              parameters.txVector = txVector;
-              parameters.preamble = preamble;
               NS_LOG_DEBUG ("Receiving Node ID=" << dstNode);
 
               Simulator::ScheduleWithContext (dstNode, delay, &YansWifiChannel::Receive, this, j, copy, parameters);
@@ -210,10 +259,28 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 
 void
 YansWifiChannel::SendTrn (Ptr<YansWifiPhy> sender, double txPowerDbm, WifiTxVector txVector, uint8_t fieldsRemaining) const
+{
+  NS_LOG_FUNCTION (this << sender << txPowerDbm << txVector << uint (fieldsRemaining));
+#ifdef HAVE_PTHREAD_H
+  Ptr<MultithreadedSimulatorImpl> impl = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != 0)
+    {
+      // the receivers may belong to other partitions
+      impl->ScheduleShared (MakeEvent (&YansWifiChannel::DoSendTrn, this, sender, txPowerDbm,
+                                       txVector, fieldsRemaining));
+      return;
+    }
+#endif /* HAVE_PTHREAD_H */
+  DoSendTrn (sender, txPowerDbm, txVector, fieldsRemaining);
+}
+
+void
+YansWifiChannel::DoSendTrn (Ptr<YansWifiPhy> sender, double txPowerDbm, WifiTxVector txVector, uint8_t fieldsRemaining) const
 {
   NS_LOG_FUNCTION (this << sender << txPowerDbm << txVector << uint (fieldsRemaining));
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
+  Ptr<DirectionalAntenna> senderAnt = sender->GetDirectionalAntenna ();
   Ptr<MobilityModel> receiverMobility;
   uint32_t j = 0; /* Phy ID */
   Time delay; /* Propagation delay of the signal */
@@ -233,6 +300,18 @@ YansWifiChannel::SendTrn (Ptr<YansWifiPhy> sender, double txPowerDbm, WifiTxVect
           NS_LOG_DEBUG ("propagation: distance=" << senderMobility->GetDistanceFrom (receiverMobility)
                         << "m, delay=" << delay);
 
+          /* The gain of the receiver's antenna is added upon the reception of the TRN Field */
+          double azimuthTx = CalculateAzimuthAngle (senderMobility->GetPosition (), receiverMobility->GetPosition ());
+          double azimuthRx = CalculateAzimuthAngle (receiverMobility->GetPosition (), senderMobility->GetPosition ());
+          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility) +
+                              senderAnt->GetTxGainDbi (azimuthTx);                      // Sender's antenna gain.
+
+          /* External Attenuator */
+          if ((m_blockage != 0) && (m_srcWifiPhy == sender) && (m_dstWifiPhy == (*i)))
+            {
+              rxPowerDbm += m_blockage ();
+            }
+
           Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
           uint32_t dstNode;	/* Destination node (Receiver) */
           if (dstNetDevice == 0)
@@ -245,7 +324,7 @@ YansWifiChannel::SendTrn (Ptr<YansWifiPhy> sender, double txPowerDbm, WifiTxVect
             }
 
           Simulator::ScheduleWithContext (dstNode, delay, &YansWifiChannel::ReceiveTrn, this, j,
-                                          sender, txVector, txPowerDbm, fieldsRemaining);
+                                          txVector, rxPowerDbm, azimuthRx, fieldsRemaining);
         }
     }
 }
@@ -259,36 +338,17 @@ YansWifiChannel::Receive (uint32_t i, Ptr<Packet> packet, struct Parameters para
 }
 
 void
-YansWifiChannel::ReceiveTrn (uint32_t i, Ptr<YansWifiPhy> sender, WifiTxVector txVector,
-                             double txPowerDbm, uint8_t fieldsRemaining) const
+YansWifiChannel::ReceiveTrn (uint32_t i, WifiTxVector txVector, double rxPowerDbm,
+                             double azimuthRx, uint8_t fieldsRemaining) const
 {
-  NS_LOG_FUNCTION (this << i << sender << txVector << txPowerDbm<< uint (fieldsRemaining));
+  NS_LOG_FUNCTION (this << i << txVector << rxPowerDbm << azimuthRx << uint (fieldsRemaining));
   /* Calculate SNR upon the receiption of the TRN Field */
-  Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
-  Ptr<MobilityModel> receiverMobility = m_phyList[i]->GetMobility ()->GetObject<MobilityModel> ();
-  NS_ASSERT ((senderMobility != 0) && (receiverMobility != 0));
-  Ptr<DirectionalAntenna> senderAnt = sender->GetDirectionalAntenna ();
-  double azimuthTx = CalculateAzimuthAngle (senderMobility->GetPosition (), receiverMobility->GetPosition ());
-  double azimuthRx = CalculateAzimuthAngle (receiverMobility->GetPosition (), senderMobility->GetPosition ());
-  double rxPowerDbm;
-
-  NS_LOG_DEBUG ("POWER: azimuthTx=" << azimuthTx
-                << ", azimuthRx=" << azimuthRx
-                << ", RxPower=" << m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility)
-                << ", Gtx=" << senderAnt->GetTxGainDbi (azimuthTx)
+  NS_LOG_DEBUG ("POWER: azimuthRx=" << azimuthRx
                 << ", Grx=" << m_phyList[i]->GetDirectionalAntenna ()->GetRxGainDbi (azimuthRx));
 
-  rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility) +
-               senderAnt->GetTxGainDbi (azimuthTx) +                                      // Sender's antenna gain.
-               m_phyList[i]->GetDirectionalAntenna ()->GetRxGainDbi (azimuthRx);          // Receiver's antenna gain.
-
-  /* External Attenuator */
-  if ((m_blockage != 0) && (m_srcWifiPhy == sender) && (m_dstWifiPhy == m_phyList[i]))
-    {
-      rxPowerDbm += m_blockage ();
-    }
+  rxPowerDbm += m_phyList[i]->GetDirectionalAntenna ()->GetRxGainDbi (azimuthRx);   // Receiver's antenna gain.
 
-  NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm");
+  NS_LOG_DEBUG ("propagation: rxPower=" << rxPowerDbm << "dbm");
 
   /* Report the received SNR to the higher layers */
   m_phyList[i]->StartReceiveTrnField (txVector, rxPowerDbm, fieldsRemaining);
@@ -87,6 +87,16 @@ public:
    * \param delay the new propagation delay model.
    */
   void SetPropagationDelayModel (Ptr<PropagationDelayModel> delay);
+  /**
+   * Compute the smallest propagation delay between two PHYs operating
+   * on the same channel number, for the current PHY positions.  This is
+   * a suitable lookahead for the MultithreadedSimulatorImpl as long as
+   * the nodes do not move closer to each other.
+   *
+   * \return the smallest propagation delay, or zero if the channel has
+   *         less than two PHYs on the same channel number.
+   */
+  Time GetMinimumDelay (void) const;
 
   /**
    * \param sender the device from which the packet is originating.
@@ -101,6 +111,12 @@ public:
    * currently invoked only from WifiPhy::Send. YansWifiChannel
    * delivers packets only between PHYs with the same m_channelNumber,
    * e.g. PHYs that are operating on the same channel.
+   *
+   * With the MultithreadedSimulatorImpl, the receptions are computed by
+   * an event given to MultithreadedSimulatorImpl::ScheduleShared, at the
+   * end of the current window, since the positions and the antennas of
+   * the receivers, and the random variables of the propagation models,
+   * are shared with the other partitions.
    */
   void Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
              WifiTxVector txVector, WifiPreamble preamble, enum mpduType mpdutype, Time duration) const;
@@ -136,6 +152,28 @@ private:
    */
   typedef std::vector<Ptr<YansWifiPhy> > PhyList;
 
+  /**
+   * Compute the power received by every other PHY on the same channel
+   * number, and schedule the receptions.
+   *
+   * \param sender the device from which the packet is originating
+   * \param packet the packet to send
+   * \param parameters the parameters of the packet, with the tx power
+   *        in the rxPowerDbm field
+   */
+  void DoSend (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, struct Parameters parameters) const;
+  /**
+   * Compute the power received by every other PHY on the same channel
+   * number, without the gain of its antenna, and schedule the receptions
+   * of the TRN Field.
+   *
+   * \param sender the device from which the TRN Field is originating.
+   * \param txPowerDbm the tx power associated to the TRN Field.
+   * \param txVector the TXVECTOR associated to the TRN Field.
+   * \param fieldsRemaining the number of TRN Fields remaining after this one.
+   */
+  void DoSendTrn (Ptr<YansWifiPhy> sender, double txPowerDbm, WifiTxVector txVector, uint8_t fieldsRemaining) const;
+
   /**
    * This method is scheduled by Send for each associated YansWifiPhy.
    * The method then calls the corresponding YansWifiPhy that the first
@@ -151,9 +189,13 @@ private:
   /**
    * \param i index of the corresponding YansWifiPhy in the PHY list.
    * \param txVector the TXVECTOR of the packet.
-   * \param txPowerDbm the transmitted signal strength [dBm].
+   * \param rxPowerDbm the received signal strength [dBm], without the
+   *        gain of the receiver's antenna.
+   * \param azimuthRx the angle of arrival of the signal.
+   * \param fieldsRemaining the number of TRN Fields remaining after this one.
    */
-  void ReceiveTrn (uint32_t i, Ptr<YansWifiPhy> sender, WifiTxVector txVector, double txPowerDbm, uint8_t fieldsRemaining) const;
+  void ReceiveTrn (uint32_t i, WifiTxVector txVector, double rxPowerDbm,
+                   double azimuthRx, uint8_t fieldsRemaining) const;
 
   PhyList m_phyList;                    //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss;     //!< Propagation loss model
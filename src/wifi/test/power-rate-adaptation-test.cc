@@ -203,7 +203,7 @@ PowerRateAdaptationTest::TestParf ()
     }
   manager->ReportDataOk (remoteAddress, &packetHeader, 0, ackMode, 0);
 
-  txVector = manager->GetDataTxVector (remoteAddress,&packetHeader,packet,packet->GetSize ());
+  txVector = manager->GetDataTxVector (remoteAddress,&packetHeader,packet);
   mode = txVector.GetMode ();
   power = (int) txVector.GetTxPowerLevel ();
 
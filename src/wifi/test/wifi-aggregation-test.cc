@@ -26,12 +26,18 @@
 #include "ns3/mac-low.h"
 #include "ns3/edca-txop-n.h"
 #include "ns3/yans-wifi-phy.h"
+#include "ns3/yans-wifi-channel.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/constant-position-mobility-model.h"
 #include "ns3/mac-tx-middle.h"
 #include "ns3/dcf-manager.h"
 #include "ns3/ampdu-tag.h"
 #include "ns3/wifi-mac-trailer.h"
 #include "ns3/msdu-standard-aggregator.h"
 #include "ns3/mpdu-standard-aggregator.h"
+#include "ns3/llc-snap-header.h"
+#include "ns3/segmentation-offload.h"
 #include "ns3/log.h"
 
 using namespace ns3;
@@ -43,6 +49,9 @@ public:
 
 private:
   virtual void DoRun (void);
+  void TxMpdu (const WifiMacHeader &hdr, uint32_t size);
+  void Receive (Ptr<Packet> packet, const WifiMacHeader *hdr);
+  void RxOk (Mac48Address address);
   Ptr<MacLow> m_low;
   Ptr<YansWifiPhy> m_phy;
   Ptr<EdcaTxopN> m_edca;
@@ -51,6 +60,7 @@ private:
   ObjectFactory m_factory;
   Ptr<MpduAggregator> m_mpduAggregator;
   DcfManager *m_dcfManager;
+  std::vector<WifiMacHeader> m_txHdrs;
 };
 
 AmpduAggregationTest::AmpduAggregationTest ()
@@ -58,6 +68,22 @@ AmpduAggregationTest::AmpduAggregationTest ()
 {
 }
 
+void
+AmpduAggregationTest::TxMpdu (const WifiMacHeader &hdr, uint32_t size)
+{
+  m_txHdrs.push_back (hdr);
+}
+
+void
+AmpduAggregationTest::Receive (Ptr<Packet> packet, const WifiMacHeader *hdr)
+{
+}
+
+void
+AmpduAggregationTest::RxOk (Mac48Address address)
+{
+}
+
 void
 AmpduAggregationTest::DoRun (void)
 {
@@ -233,6 +259,50 @@ AmpduAggregationTest::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_edca->m_currentPacket, 0, "packet should be discarded");
   m_edca->GetEdcaQueue ()->Remove (pkt3);
 
+  //-----------------------------------------------------------------------------------------------------
+
+  /*
+   * Test behavior when an A-MPDU does not fit in the remaining duration of the access period, e.g., at
+   * the end of a CBAP, and is suspended: a normal ACK sent by the station in the meantime must be sent
+   * alone, and not replaced by the suspended A-MPDU.
+   */
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationLossModel (CreateObject<FriisPropagationLossModel> ());
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  m_phy->SetChannel (channel);
+  m_phy->SetMobility (CreateObject<ConstantPositionMobilityModel> ());
+  m_low->SetRxCallback (MakeCallback (&AmpduAggregationTest::Receive, this));
+  m_manager->RegisterRxOkCallback (MakeCallback (&AmpduAggregationTest::RxOk, this));
+  m_low->TraceConnectWithoutContext ("TxMpdu", MakeCallback (&AmpduAggregationTest::TxMpdu, this));
+
+  m_edca->GetEdcaQueue ()->Enqueue (pkt1, hdr1);
+  m_edca->GetEdcaQueue ()->Enqueue (pkt2, hdr1);
+
+  MacLowTransmissionParameters params;
+  params.EnableAck ();
+  params.SetAsBoundedTransmission ();
+  params.SetMaximumTransmissionDuration (MicroSeconds (10));
+  m_low->StartTransmission (pkt, &hdr, params, 0);
+  NS_TEST_EXPECT_MSG_EQ (m_low->IsTransmissionSuspended (), true, "the A-MPDU should be suspended");
+  NS_TEST_EXPECT_MSG_EQ (m_low->m_ampdu, true, "the suspended transmission should be an A-MPDU");
+
+  Ptr<Packet> data = Create<Packet> (100);
+  WifiMacHeader dataHdr;
+  dataHdr.SetType (WIFI_MAC_DATA);
+  dataHdr.SetAddr1 (Mac48Address ("00:00:00:00:00:01"));
+  dataHdr.SetAddr2 (Mac48Address ("00:00:00:00:00:02"));
+  dataHdr.SetAddr3 (Mac48Address ("00:00:00:00:00:02"));
+  dataHdr.SetDuration (MicroSeconds (44));
+  data->AddHeader (dataHdr);
+  data->AddTrailer (WifiMacTrailer ());
+  m_low->ReceiveOk (data, 100, m_low->m_currentTxVector, WIFI_PREAMBLE_LONG, false);
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_txHdrs.size (), 1, "only the ACK should be sent");
+  NS_TEST_EXPECT_MSG_EQ (m_txHdrs[0].IsAck (), true, "the ACK was not sent alone");
+  NS_TEST_EXPECT_MSG_EQ (m_low->m_aggregateQueue->GetSize (), 3, "the suspended A-MPDU should be kept");
+  NS_TEST_EXPECT_MSG_EQ (m_low->IsTransmissionSuspended (), true, "the A-MPDU should still be suspended");
+
   Simulator::Destroy ();
   delete m_txMiddle;
   delete m_dcfManager;
@@ -380,6 +450,86 @@ TwoLevelAggregationTest::DoRun (void)
 }
 
 
+class SuperSegmentSplitTest : public TestCase
+{
+public:
+  SuperSegmentSplitTest ();
+
+private:
+  virtual void DoRun (void);
+  static std::list<Ptr<Packet> > Split (Ptr<const Packet> packet);
+};
+
+SuperSegmentSplitTest::SuperSegmentSplitTest ()
+  : TestCase ("Check the split of the super-segments in MSDUs by the queue")
+{
+}
+
+std::list<Ptr<Packet> >
+SuperSegmentSplitTest::Split (Ptr<const Packet> packet)
+{
+  GsoTag gsoTag;
+  packet->PeekPacketTag (gsoTag);
+  std::list<Ptr<Packet> > segments;
+  for (uint32_t offset = 0; offset < packet->GetSize (); offset += gsoTag.GetSegmentSize ())
+    {
+      Ptr<Packet> segment = packet->CreateFragment (offset, std::min<uint32_t> (gsoTag.GetSegmentSize (),
+                                                                                packet->GetSize () - offset));
+      segment->RemovePacketTag (gsoTag);
+      segments.push_back (segment);
+    }
+  return segments;
+}
+
+void
+SuperSegmentSplitTest::DoRun (void)
+{
+  // Local experimental EtherType, with a splitter which needs no header
+  const uint16_t protocol = 0x88B5;
+  SegmentationOffload::Register (protocol, MakeCallback (&SuperSegmentSplitTest::Split));
+
+  Ptr<WifiMacQueue> queue = CreateObject<WifiMacQueue> ();
+  queue->SetMaxSize (6);
+  WifiMacHeader hdr, peekedHdr;
+  hdr.SetAddr1 (Mac48Address ("00:00:00:00:00:01"));
+  hdr.SetAddr2 (Mac48Address ("00:00:00:00:00:02"));
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (0);
+
+  LlcSnapHeader llc;
+  llc.SetType (protocol);
+  Ptr<Packet> superSegment = Create<Packet> (3500);
+  superSegment->AddPacketTag (GsoTag (1000));
+  superSegment->AddHeader (llc);
+
+  /*
+   * The super-segment is queued as four MSDUs, each with its LLC header.
+   */
+  queue->Enqueue (superSegment, hdr);
+  NS_TEST_EXPECT_MSG_EQ (queue->GetSize (), 4, "super-segment not split");
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      Ptr<Packet> msdu = queue->Dequeue (&peekedHdr)->Copy ();
+      GsoTag gsoTag;
+      NS_TEST_EXPECT_MSG_EQ (msdu->PeekPacketTag (gsoTag), false, "GsoTag left on a MSDU");
+      LlcSnapHeader msduLlc;
+      msdu->RemoveHeader (msduLlc);
+      NS_TEST_EXPECT_MSG_EQ (msduLlc.GetType (), protocol, "wrong LLC type");
+      NS_TEST_EXPECT_MSG_EQ (msdu->GetSize (), ((i < 3) ? 1000 : 500), "wrong MSDU size");
+      NS_TEST_EXPECT_MSG_EQ (peekedHdr.GetAddr1 (), hdr.GetAddr1 (), "wrong MAC header");
+    }
+
+  /*
+   * The MSDUs beyond the queue size are dropped.
+   */
+  queue->Enqueue (superSegment, hdr);
+  queue->Enqueue (superSegment, hdr);
+  NS_TEST_EXPECT_MSG_EQ (queue->GetSize (), 6, "MSDUs queued beyond the queue size");
+
+  Simulator::Destroy ();
+}
+
+
 //-----------------------------------------------------------------------------
 class WifiAggregationTestSuite : public TestSuite
 {
@@ -392,6 +542,7 @@ WifiAggregationTestSuite::WifiAggregationTestSuite ()
 {
   AddTestCase (new AmpduAggregationTest, TestCase::QUICK);
   AddTestCase (new TwoLevelAggregationTest, TestCase::QUICK);
+  AddTestCase (new SuperSegmentSplitTest, TestCase::QUICK);
 }
 
 static WifiAggregationTestSuite g_wifiAggregationTestSuite;
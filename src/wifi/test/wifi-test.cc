@@ -21,6 +21,7 @@
  *          Sébastien Deronne <sebastien.deronne@gmail.com> (Case for bug 730)
  */
 
+#include "ns3/core-config.h"
 #include "ns3/yans-wifi-helper.h"
 #include "ns3/mobility-helper.h"
 #include "ns3/wifi-net-device.h"
@@ -29,6 +30,7 @@
 #include "ns3/propagation-loss-model.h"
 #include "ns3/yans-error-rate-model.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
 #include "ns3/test.h"
 #include "ns3/pointer.h"
 #include "ns3/rng-seed-manager.h"
@@ -39,6 +41,11 @@
 #include "ns3/packet-socket-server.h"
 #include "ns3/packet-socket-client.h"
 #include "ns3/packet-socket-helper.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/multithreaded-simulator-impl.h"
+#endif
 
 using namespace ns3;
 
@@ -618,6 +625,183 @@ Bug730TestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (result, true, "packet reception unexpectedly stopped after adapting fragmentation threshold!");
 }
 
+#ifdef HAVE_PTHREAD_H
+//-----------------------------------------------------------------------------
+/**
+ * Make the stations of an ad hoc network, one of them moving, exchange
+ * unicast and broadcast frames over a channel with a random loss, with
+ * the MultithreadedSimulatorImpl, and check that the frames received do
+ * not depend on the number of threads.
+ */
+class MultithreadedWifiTest : public TestCase
+{
+public:
+  MultithreadedWifiTest ();
+
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+
+private:
+  /** The frames received by each station. */
+  struct Result
+  {
+    std::vector<uint32_t> count;
+    std::vector<uint64_t> hash;
+  };
+
+  Result RunScenario (uint32_t threads);
+  void SendPackets (uint32_t i, uint32_t n);
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+  uint32_t GetIndex (const Address &address) const;
+
+  NetDeviceContainer m_devices;
+  Result m_result;
+};
+
+MultithreadedWifiTest::MultithreadedWifiTest ()
+  : TestCase ("Check that the results of the multithreaded simulator do not depend on the number of threads")
+{
+}
+
+void
+MultithreadedWifiTest::DoSetup (void)
+{
+  GlobalValue::Bind ("SimulatorImplementationType",
+                     StringValue ("ns3::MultithreadedSimulatorImpl"));
+}
+
+void
+MultithreadedWifiTest::DoTeardown (void)
+{
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::ThreadCount", UintegerValue (1));
+  GlobalValue::Bind ("SimulatorImplementationType",
+                     StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+uint32_t
+MultithreadedWifiTest::GetIndex (const Address &address) const
+{
+  for (uint32_t i = 0; i < m_devices.GetN (); i++)
+    {
+      if (m_devices.Get (i)->GetAddress () == address)
+        {
+          return i;
+        }
+    }
+  return m_devices.GetN ();
+}
+
+void
+MultithreadedWifiTest::SendPackets (uint32_t i, uint32_t n)
+{
+  Ptr<NetDevice> device = m_devices.Get (i);
+  Address to = device->GetBroadcast ();
+  if (n % 3 != 0)
+    {
+      to = m_devices.Get ((i + 1) % m_devices.GetN ())->GetAddress ();
+    }
+  device->Send (Create<Packet> (200 + 100 * (n % 5)), to, 1);
+  if (n > 1)
+    {
+      Simulator::Schedule (MilliSeconds (2), &MultithreadedWifiTest::SendPackets, this, i, n - 1);
+    }
+}
+
+bool
+MultithreadedWifiTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                                uint16_t protocol, const Address &from)
+{
+  uint32_t i = GetIndex (device->GetAddress ());
+  uint64_t value = Simulator::Now ().GetTimeStep () * 31 + packet->GetSize () * 7 + GetIndex (from);
+  m_result.hash[i] = (m_result.hash[i] ^ value) * 1099511628211ULL;
+  m_result.count[i]++;
+  return true;
+}
+
+MultithreadedWifiTest::Result
+MultithreadedWifiTest::RunScenario (uint32_t threads)
+{
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::ThreadCount", UintegerValue (threads));
+  NodeContainer nodes;
+  nodes.Create (6);
+
+  YansWifiChannelHelper channelHelper = YansWifiChannelHelper::Default ();
+  channelHelper.AddPropagationLoss ("ns3::NakagamiPropagationLossModel");
+  Ptr<YansWifiChannel> channel = channelHelper.Create ();
+  channelHelper.AssignStreams (channel, 100);
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel);
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211a);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate24Mbps"),
+                                "ControlMode", StringValue ("OfdmRate6Mbps"));
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  m_devices = wifi.Install (phy, mac, nodes);
+  wifi.AssignStreams (m_devices, 200);
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      positionAlloc->Add (Vector (40.0 * (i % 3), 30.0 * (i / 3), 0.0));
+    }
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.Install (nodes);
+  // the last station moves away from all the others
+  nodes.Get (5)->GetObject<ConstantVelocityMobilityModel> ()->SetVelocity (Vector (20.0, 20.0, 0.0));
+
+  m_result.count.assign (m_devices.GetN (), 0);
+  m_result.hash.assign (m_devices.GetN (), 14695981039346656037ULL);
+  for (uint32_t i = 0; i < m_devices.GetN (); i++)
+    {
+      m_devices.Get (i)->SetReceiveCallback (MakeCallback (&MultithreadedWifiTest::Receive, this));
+      Simulator::ScheduleWithContext (nodes.Get (i)->GetId (), MicroSeconds (100000 + 37 * i),
+                                      &MultithreadedWifiTest::SendPackets, this, i, 60);
+    }
+
+  Ptr<MultithreadedSimulatorImpl> impl = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  NS_ASSERT (impl != 0);
+  NS_TEST_EXPECT_MSG_EQ (impl->GetPartitionCount (), threads, "Wrong number of partitions");
+  impl->SetLookahead (channel->GetMinimumDelay ());
+
+  Simulator::Stop (Seconds (0.3));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_devices = NetDeviceContainer ();
+  return m_result;
+}
+
+void
+MultithreadedWifiTest::DoRun (void)
+{
+  Result reference = RunScenario (1);
+  uint32_t total = 0;
+  for (uint32_t i = 0; i < reference.count.size (); i++)
+    {
+      total += reference.count[i];
+    }
+  NS_TEST_ASSERT_MSG_GT (total, 100, "Too few frames were received");
+
+  for (uint32_t threads = 2; threads <= 3; threads++)
+    {
+      Result result = RunScenario (threads);
+      for (uint32_t i = 0; i < reference.count.size (); i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (result.count[i], reference.count[i],
+                                 "Frame count differs on station " << i << " with " << threads << " threads");
+          NS_TEST_EXPECT_MSG_EQ (result.hash[i], reference.hash[i],
+                                 "Frames differ on station " << i << " with " << threads << " threads");
+        }
+    }
+}
+#endif /* HAVE_PTHREAD_H */
+
 //-----------------------------------------------------------------------------
 class WifiTestSuite : public TestSuite
 {
@@ -633,6 +817,9 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new InterferenceHelperSequenceTest, TestCase::QUICK); //Bug 991
   AddTestCase (new Bug555TestCase, TestCase::QUICK); //Bug 555
   AddTestCase (new Bug730TestCase, TestCase::QUICK); //Bug 730
+#ifdef HAVE_PTHREAD_H
+  AddTestCase (new MultithreadedWifiTest, TestCase::QUICK);
+#endif
 }
 
 static WifiTestSuite g_wifiTestSuite;
@@ -0,0 +1,115 @@
+#!/usr/bin/env python
+## -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation;
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+#
+
+#
+# Compare the run time of the DMG scratch scenarios built with the
+# debug, fast-debug and optimized build profiles.
+#
+# Every profile is configured in its own build directory (build-bench-<profile>)
+# with its own waf lock file, so that the regular build is left untouched.
+# Run from the top-level directory:
+#
+#   ./utils/bench-build-profiles.py
+#   ./utils/bench-build-profiles.py --profiles=debug,fast-debug --runs=5
+#   ./utils/bench-build-profiles.py --disable-logging-modules=wifi,antenna
+#
+
+import optparse
+import os
+import subprocess
+import sys
+import time
+
+SCENARIOS = [
+    ['evaluate_dmg_throughput', '--simulationTime=2'],
+    ['evaluate_beamforming', '--simulationTime=2'],
+    ['evaluate_service_period', '--simulationTime=2'],
+    ['evaluate_relay_operation', '--simulationTime=2'],
+    ['evaluate_fst_mechanism', '--simulationTime=2'],
+]
+
+def waf(profile, args):
+    env = dict(os.environ)
+    env['WAFLOCK'] = '.lock-waf_bench_%s' % profile
+    command = [sys.executable, 'waf'] + args
+    print(' '.join(command))
+    subprocess.check_call(command, env=env)
+
+def build(profile, options):
+    args = ['configure', '-d', profile, '--out=build-bench-%s' % profile,
+            '--disable-tests', '--disable-examples', '--disable-python']
+    if options.modules:
+        args.append('--enable-modules=%s' % options.modules)
+    if options.disable_logging_modules:
+        args.append('--disable-logging-modules=%s' % options.disable_logging_modules)
+    waf(profile, args)
+    waf(profile, ['build', '-j%d' % options.jobs])
+
+def run(profile, scenario, runs):
+    out = 'build-bench-%s' % profile
+    env = dict(os.environ)
+    env['LD_LIBRARY_PATH'] = os.path.abspath(out) + os.pathsep + env.get('LD_LIBRARY_PATH', '')
+    program = os.path.join(out, 'scratch', scenario[0])
+    best = None
+    devnull = open(os.devnull, 'w')
+    for i in range(runs):
+        start = time.time()
+        subprocess.check_call([program] + scenario[1:], env=env, stdout=devnull, stderr=devnull)
+        elapsed = time.time() - start
+        if best is None or elapsed < best:
+            best = elapsed
+    devnull.close()
+    return best
+
+def main(argv):
+    parser = optparse.OptionParser()
+    parser.add_option('--profiles', default='debug,fast-debug,optimized',
+                      help='Comma-separated list of build profiles to compare')
+    parser.add_option('--runs', type='int', default=3,
+                      help='Number of runs of each scenario; the best time is kept')
+    parser.add_option('--jobs', type='int', default=1,
+                      help='Number of parallel build jobs')
+    parser.add_option('--modules', default='',
+                      help='Modules to build (default: all)')
+    parser.add_option('--disable-logging-modules', default='',
+                      dest='disable_logging_modules',
+                      help='Modules to build with the logging macros compiled out')
+    parser.add_option('--no-build', action='store_true', default=False,
+                      dest='no_build', help='Reuse the existing build directories')
+    (options, args) = parser.parse_args(argv)
+
+    profiles = options.profiles.split(',')
+    if not options.no_build:
+        for profile in profiles:
+            build(profile, options)
+
+    results = {}
+    for profile in profiles:
+        for scenario in SCENARIOS:
+            results[(profile, scenario[0])] = run(profile, scenario, options.runs)
+
+    print('')
+    print('%-26s' % 'scenario' + ''.join(['%14s' % p for p in profiles]))
+    for scenario in SCENARIOS:
+        line = '%-26s' % scenario[0]
+        for profile in profiles:
+            line += '%13.2fs' % results[(profile, scenario[0])]
+        print(line)
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,122 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/config.h"
+#include "ns3/callback.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/packet.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/** Number of trace sinks called */
+static uint32_t g_enqueued = 0;
+
+/**
+ * A trace sink of the queues.
+ * \param context the context
+ * \param packet the packet enqueued
+ */
+static void
+EnqueueSink (std::string context, Ptr<const Packet> packet)
+{
+  g_enqueued++;
+}
+
+/**
+ * \param node the index of a node
+ * \returns the path of the Enqueue trace source of the devices of the node
+ */
+static std::string
+GetNodePath (uint32_t node)
+{
+  std::ostringstream oss;
+  oss << "/NodeList/" << node << "/DeviceList/*/$ns3::SimpleNetDevice/TxQueue/Enqueue";
+  return oss.str ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t devices = 2;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the time to connect a trace sink per node with Config::Connect "
+             "and with Config::CompiledPath");
+  cmd.AddValue ("n", "number of nodes", n);
+  cmd.AddValue ("devices", "number of devices per node", devices);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of nodes must be specified " <<
+        "by command-line argument --n=(number of nodes)" << std::endl;
+      exit (1);
+    }
+
+  NodeContainer nodes;
+  nodes.Create (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      for (uint32_t j = 0; j < devices; j++)
+        {
+          Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+          device->SetQueue (CreateObject<DropTailQueue> ());
+          nodes.Get (i)->AddDevice (device);
+        }
+    }
+
+  std::cout << "Running bench-config-paths with n=" << n << " devices=" << devices << std::endl;
+
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Config::Connect (GetNodePath (i), MakeCallback (&EnqueueSink));
+    }
+  std::cout << "Config::Connect per node: " << time.End () << "ms" << std::endl;
+
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Config::CompiledPath (GetNodePath (i)).Connect (MakeCallback (&EnqueueSink));
+    }
+  std::cout << "CompiledPath::Connect per node: " << time.End () << "ms" << std::endl;
+
+  time.Start ();
+  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::SimpleNetDevice/TxQueue/Enqueue",
+                   MakeCallback (&EnqueueSink));
+  std::cout << "Config::Connect with a wildcard: " << time.End () << "ms" << std::endl;
+
+  time.Start ();
+  Config::CompiledPath ("/NodeList/*/DeviceList/*/$ns3::SimpleNetDevice/TxQueue/Enqueue")
+    .Connect (MakeCallback (&EnqueueSink));
+  std::cout << "CompiledPath::Connect with a wildcard: " << time.End () << "ms" << std::endl;
+
+  // each queue has now four sinks
+  Ptr<SimpleNetDevice> device = DynamicCast<SimpleNetDevice> (nodes.Get (n - 1)->GetDevice (0));
+  device->GetQueue ()->Enqueue (Create<QueueItem> (Create<Packet> (100)));
+  std::cout << "Sinks called: " << g_enqueued << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/udp-header.h"
+#include "ns3/flow-monitor.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include <iostream>
+#include <vector>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/**
+ * A probe which is not attached to any node: the benchmark reports
+ * the packet events itself.
+ */
+class BenchFlowProbe : public FlowProbe
+{
+public:
+  /**
+   * \param monitor the flow monitor
+   */
+  BenchFlowProbe (Ptr<FlowMonitor> monitor)
+    : FlowProbe (monitor)
+  {
+  }
+};
+
+/** The state of the benchmark */
+struct BenchFlowMonitor
+{
+  Ptr<FlowMonitor> monitor;                     //!< The monitor
+  Ptr<Ipv4FlowClassifier> classifier;           //!< The classifier
+  Ptr<FlowProbe> probes[3];                     //!< Source, router and sink probes
+  std::vector<Ipv4Header> headers;              //!< IPv4 header of each flow
+  std::vector<Ptr<Packet> > payloads;           //!< UDP payload of each flow
+  uint32_t flows;                               //!< Number of flows
+  uint32_t packetsPerTick;                      //!< Packets sent per tick
+  uint32_t lossPeriod;                          //!< One packet out of lossPeriod is lost
+  uint32_t sent;                                //!< Packets sent so far
+  uint32_t total;                               //!< Packets to send
+};
+
+/**
+ * Send, forward and receive the packets of one tick, and schedule the
+ * next tick.
+ * \param bench the benchmark
+ */
+static void
+BenchTick (BenchFlowMonitor *bench)
+{
+  for (uint32_t i = 0; i < bench->packetsPerTick && bench->sent < bench->total; i++, bench->sent++)
+    {
+      uint32_t flow = (bench->sent * 7919) % bench->flows;
+      FlowId flowId;
+      FlowPacketId packetId;
+      bench->classifier->Classify (bench->headers[flow], bench->payloads[flow], &flowId, &packetId);
+      bench->monitor->ReportFirstTx (bench->probes[0], flowId, packetId, 100);
+      bench->monitor->ReportForwarding (bench->probes[1], flowId, packetId, 100);
+      if (bench->sent % bench->lossPeriod != 0)
+        {
+          bench->monitor->ReportLastRx (bench->probes[2], flowId, packetId, 100);
+        }
+    }
+  if (bench->sent < bench->total)
+    {
+      Simulator::Schedule (MilliSeconds (1), &BenchTick, bench);
+    }
+  else
+    {
+      // the monitor checks for lost packets forever
+      Simulator::Stop ();
+    }
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t flows = 10000;
+  uint32_t n = 0;
+  uint32_t rate = 100000;
+  uint32_t lossPeriod = 100;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the FlowMonitor and Ipv4FlowClassifier tables");
+  cmd.AddValue ("n", "number of packets", n);
+  cmd.AddValue ("flows", "number of flows", flows);
+  cmd.AddValue ("rate", "packets per second of simulated time", rate);
+  cmd.AddValue ("loss-period", "one packet out of loss-period is lost", lossPeriod);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of packets must be specified " <<
+        "by command-line argument --n=(number of packets)" << std::endl;
+      exit (1);
+    }
+
+  BenchFlowMonitor bench;
+  bench.monitor = CreateObject<FlowMonitor> ();
+  bench.classifier = Create<Ipv4FlowClassifier> ();
+  bench.monitor->AddFlowClassifier (bench.classifier);
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      bench.probes[i] = CreateObject<BenchFlowProbe> (bench.monitor);
+    }
+  for (uint32_t i = 0; i < flows; i++)
+    {
+      Ipv4Header header;
+      header.SetSource (Ipv4Address (0x0a000000 + i / 16));
+      header.SetDestination (Ipv4Address (0x0b000000 + i % 251));
+      header.SetProtocol (17);
+      bench.headers.push_back (header);
+      Ptr<Packet> payload = Create<Packet> (100);
+      UdpHeader udp;
+      udp.SetSourcePort (1000 + i % 16);
+      udp.SetDestinationPort (9);
+      payload->AddHeader (udp);
+      bench.payloads.push_back (payload);
+    }
+  bench.flows = flows;
+  bench.packetsPerTick = std::max (rate / 1000, 1U);
+  bench.lossPeriod = lossPeriod;
+  bench.sent = 0;
+  bench.total = n;
+
+  std::cout << "Running bench-flow-monitor with n=" << n << " flows=" << flows
+            << " rate=" << rate << std::endl;
+
+  SystemWallClockMs time;
+  time.Start ();
+  bench.monitor->StartRightNow ();
+  Simulator::Schedule (Seconds (0), &BenchTick, &bench);
+  Simulator::Run ();
+  bench.monitor->CheckForLostPackets (Seconds (0));
+  uint64_t deltaMs = time.End ();
+
+  uint64_t lost = 0;
+  const FlowMonitor::FlowStatsContainer &stats = bench.monitor->GetFlowStats ();
+  for (FlowMonitor::FlowStatsContainerCI i = stats.begin (); i != stats.end (); ++i)
+    {
+      lost += i->second.lostPackets;
+    }
+  double ps = n;
+  ps *= 1000;
+  ps /= std::max (deltaMs, uint64_t (1));
+  std::cout << ps << " packets/s (" << deltaMs << " ms elapsed), "
+            << stats.size () << " flows, " << lost << " lost packets" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/global-route-manager.h"
+#include "ns3/ipv4.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Link two nodes with point to point simple net devices.
+ * \param a first node
+ * \param b second node
+ * \param address the address helper
+ * \returns the devices
+ */
+static NetDeviceContainer
+Link (Ptr<Node> a, Ptr<Node> b, Ipv4AddressHelper &address)
+{
+  SimpleNetDeviceHelper simple;
+  simple.SetNetDevicePointToPointMode (true);
+  NetDeviceContainer devices = simple.Install (NodeContainer (a, b));
+  address.Assign (devices);
+  address.NewNetwork ();
+  return devices;
+}
+
+/**
+ * Recompute the routes, as Ipv4GlobalRoutingHelper::RecomputeRoutingTables
+ * does, and print the time of each step.
+ * \param what the change of the topology
+ */
+static void
+Recompute (std::string what)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  GlobalRouteManager::DeleteGlobalRoutes ();
+  int64_t deleteMs = time.End ();
+  time.Start ();
+  GlobalRouteManager::BuildGlobalRoutingDatabase ();
+  int64_t buildMs = time.End ();
+  time.Start ();
+  GlobalRouteManager::InitializeRoutes ();
+  int64_t initializeMs = time.End ();
+  std::cout << "RecomputeRoutingTables " << what << ": " << deleteMs + buildMs + initializeMs << "ms ("
+            << deleteMs << "ms to delete the routes, " << buildMs << "ms to build the LSDB, "
+            << initializeMs << "ms to compute the routes)" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t size = 20;
+  uint32_t areas = 1;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the computation of the global routes on grids of routers");
+  cmd.AddValue ("size", "number of routers on a side of a grid", size);
+  cmd.AddValue ("areas", "number of disconnected grids", areas);
+  cmd.Parse (argc, argv);
+
+  InternetStackHelper internet;
+  Ipv4AddressHelper address;
+  address.SetBase ("10.0.0.0", "255.255.255.252");
+  std::vector<NodeContainer> grids;
+  NetDeviceContainer changing;
+  for (uint32_t a = 0; a < areas; a++)
+    {
+      NodeContainer grid;
+      grid.Create (size * size);
+      internet.Install (grid);
+      for (uint32_t i = 0; i < size; i++)
+        {
+          for (uint32_t j = 0; j < size; j++)
+            {
+              if (j + 1 < size)
+                {
+                  NetDeviceContainer devices = Link (grid.Get (i * size + j), grid.Get (i * size + j + 1), address);
+                  if (a == 0 && i == size / 2 && j == size / 2)
+                    {
+                      changing = devices;
+                    }
+                }
+              if (i + 1 < size)
+                {
+                  Link (grid.Get (i * size + j), grid.Get ((i + 1) * size + j), address);
+                }
+            }
+        }
+      grids.push_back (grid);
+    }
+
+  std::cout << "Running bench-global-routing with size=" << size << " areas=" << areas
+            << " (" << areas * size * size << " routers)" << std::endl;
+
+  SystemWallClockMs time;
+  time.Start ();
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  std::cout << "PopulateRoutingTables: " << time.End () << "ms" << std::endl;
+
+  Ptr<Ipv4> ipv4 = changing.Get (0)->GetNode ()->GetObject<Ipv4> ();
+  uint32_t interface = ipv4->GetInterfaceForDevice (changing.Get (0));
+  Recompute ("without a change");
+  ipv4->SetDown (interface);
+  Recompute ("after a link down in the first area");
+  ipv4->SetUp (interface);
+  Recompute ("after a link up in the first area");
+
+  Simulator::Destroy ();
+  return 0;
+}
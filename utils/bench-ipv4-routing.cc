@@ -0,0 +1,189 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-routing-table-entry.h"
+#include <iostream>
+#include <vector>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/**
+ * Look up the destinations with a routing protocol.
+ * \param routing the routing protocol
+ * \param destinations the destinations
+ * \param n the number of lookups
+ * \returns the number of routes found
+ */
+static uint32_t
+BenchRouteOutput (Ptr<Ipv4RoutingProtocol> routing, const std::vector<Ipv4Address> &destinations, uint32_t n)
+{
+  uint32_t found = 0;
+  Ptr<Packet> packet = Create<Packet> ();
+  Ipv4Header header;
+  Socket::SocketErrno error;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      header.SetDestination (destinations[i % destinations.size ()]);
+      if (routing->RouteOutput (packet, header, 0, error) != 0)
+        {
+          found++;
+        }
+    }
+  return found;
+}
+
+/**
+ * Look up the destinations by scanning a list of routes for the longest
+ * prefix, as the routing protocols did before their routing trie.
+ * \param routes the routes
+ * \param destinations the destinations
+ * \param n the number of lookups
+ * \returns the number of routes found
+ */
+static uint32_t
+BenchLinearScan (const std::vector<Ipv4RoutingTableEntry *> &routes, const std::vector<Ipv4Address> &destinations, uint32_t n)
+{
+  uint32_t found = 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ipv4Address dest = destinations[i % destinations.size ()];
+      Ipv4RoutingTableEntry *route = 0;
+      uint16_t longest = 0;
+      for (uint32_t j = 0; j < routes.size (); j++)
+        {
+          Ipv4Mask mask = routes[j]->GetDestNetworkMask ();
+          if (mask.IsMatch (dest, routes[j]->GetDestNetwork ()) && mask.GetPrefixLength () >= longest)
+            {
+              longest = mask.GetPrefixLength ();
+              route = routes[j];
+            }
+        }
+      if (route != 0)
+        {
+          found++;
+        }
+    }
+  return found;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t routes = 100000;
+  uint32_t n = 0;
+  uint32_t hostRoutes = 90;
+  uint32_t scanLookups = 1000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the route lookups of Ipv4StaticRouting and Ipv4GlobalRouting");
+  cmd.AddValue ("n", "number of lookups", n);
+  cmd.AddValue ("routes", "number of routes", routes);
+  cmd.AddValue ("host-routes", "percentage of /32 host routes, the others are /24", hostRoutes);
+  cmd.AddValue ("scan-lookups", "number of lookups with a linear scan of the routes", scanLookups);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of lookups must be specified " <<
+        "by command-line argument --n=(number of lookups)" << std::endl;
+      exit (1);
+    }
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  SimpleNetDeviceHelper simple;
+  NetDeviceContainer devices = simple.Install (nodes);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("192.168.0.0", "255.255.255.0");
+  address.Assign (devices);
+  Ptr<Ipv4> ipv4 = nodes.Get (0)->GetObject<Ipv4> ();
+  Ptr<Ipv4StaticRouting> staticRouting = Ipv4StaticRoutingHelper ().GetStaticRouting (ipv4);
+  Ptr<Ipv4GlobalRouting> globalRouting = CreateObject<Ipv4GlobalRouting> ();
+  globalRouting->SetIpv4 (ipv4);
+
+  std::cout << "Running bench-ipv4-routing with n=" << n << " routes=" << routes
+            << " host-routes=" << hostRoutes << "%" << std::endl;
+
+  std::vector<Ipv4RoutingTableEntry *> entries;
+  std::vector<Ipv4Address> destinations;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < routes; i++)
+    {
+      // spread the routes over 10.0.0.0/8
+      uint32_t host = 0x0a000000 + ((i * 2654435761U) & 0x00ffffff);
+      Ipv4Address gateway = Ipv4Address (0xc0a80002 + i % 200);
+      Ipv4RoutingTableEntry *entry = new Ipv4RoutingTableEntry ();
+      if (i % 100 < hostRoutes)
+        {
+          staticRouting->AddHostRouteTo (Ipv4Address (host), gateway, 1);
+          globalRouting->AddHostRouteTo (Ipv4Address (host), gateway, 1);
+          *entry = Ipv4RoutingTableEntry::CreateHostRouteTo (Ipv4Address (host), gateway, 1);
+        }
+      else
+        {
+          Ipv4Address network = Ipv4Address (host).CombineMask (Ipv4Mask ("255.255.255.0"));
+          staticRouting->AddNetworkRouteTo (network, Ipv4Mask ("255.255.255.0"), gateway, 1);
+          globalRouting->AddNetworkRouteTo (network, Ipv4Mask ("255.255.255.0"), gateway, 1);
+          *entry = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network, Ipv4Mask ("255.255.255.0"), gateway, 1);
+        }
+      entries.push_back (entry);
+      destinations.push_back (Ipv4Address (host ^ (i % 7 == 0 ? 0x80 : 0)));
+    }
+  std::cout << "Adding the routes: " << time.End () << "ms" << std::endl;
+
+  time.Start ();
+  uint32_t found = BenchRouteOutput (staticRouting, destinations, n);
+  int64_t ms = time.End ();
+  std::cout << "Ipv4StaticRouting: " << ms << "ms, " << found << " routes found, "
+            << (ms * 1e6 / n) << "ns per lookup" << std::endl;
+
+  time.Start ();
+  found = BenchRouteOutput (globalRouting, destinations, n);
+  ms = time.End ();
+  std::cout << "Ipv4GlobalRouting: " << ms << "ms, " << found << " routes found, "
+            << (ms * 1e6 / n) << "ns per lookup" << std::endl;
+
+  if (scanLookups > 0)
+    {
+      time.Start ();
+      found = BenchLinearScan (entries, destinations, scanLookups);
+      ms = time.End ();
+      std::cout << "Linear scan: " << ms << "ms for " << scanLookups << " lookups, " << found << " routes found, "
+                << (ms * 1e6 / scanLookups) << "ns per lookup" << std::endl;
+    }
+
+  for (uint32_t i = 0; i < entries.size (); i++)
+    {
+      delete entries[i];
+    }
+  globalRouting->Dispose ();
+  Simulator::Destroy ();
+  return 0;
+}
@@ -302,6 +302,84 @@ benchByteTags (uint32_t n)
     }
 }
 
+/*
+ * The packet tags of the wifi MAC send and receive path, from a QoS
+ * station to three receivers, with tags of the same sizes as the
+ * QosTag, the tx vector tags, the AmpduTag and the SnrTag.
+ */
+static void
+benchWifiTags (uint32_t n)
+{
+  BenchHeader<26> mac;
+  BenchTag<1> qos;
+  BenchTag<20> dataTxVector;
+  BenchTag<19> rtsTxVector;
+  BenchTag<18> ctsToSelfTxVector;
+  BenchTag<2> ampdu;
+  BenchTag<8> snr;
+  BenchTag<4> flowId;
+
+  for (uint32_t i = 0; i < n; i++) {
+    Ptr<Packet> p = Create<Packet> (1500);
+    p->AddPacketTag (flowId);
+    // EdcaTxopN::Queue: QosUtilsGetTidForPacket
+    p->PeekPacketTag (qos);
+    // WifiRemoteStationManager::PrepareForQueue
+    p->RemovePacketTag (dataTxVector);
+    p->RemovePacketTag (rtsTxVector);
+    p->RemovePacketTag (ctsToSelfTxVector);
+    p->AddPacketTag (dataTxVector);
+    p->AddPacketTag (rtsTxVector);
+    p->AddPacketTag (ctsToSelfTxVector);
+    // MacLow::StartTransmission
+    p->PeekPacketTag (rtsTxVector);
+    p->PeekPacketTag (dataTxVector);
+    p->AddHeader (mac);
+    p->AddPacketTag (ampdu);
+    for (uint32_t j = 0; j < 3; j++) {
+      // YansWifiChannel::Send: one copy per receiver
+      Ptr<Packet> r = p->Copy ();
+      // YansWifiPhy::StartReceivePreambleAndHeader
+      r->PeekPacketTag (ampdu);
+      r->PeekPacketTag (ampdu);
+      // YansWifiPhy::EndReceive
+      r->AddPacketTag (snr);
+      // MacLow::DeaggregateAmpduAndReceive and MacLow::ReceiveOk
+      r->RemovePacketTag (ampdu);
+      r->RemovePacketTag (snr);
+      r->RemoveHeader (mac);
+      r->PeekPacketTag (qos);
+    }
+    p->RemovePacketTag (ampdu);
+  }
+}
+
+/*
+ * An A-MSDU of AMSDU_SUBFRAMES MSDUs of virtual zero payload, as the
+ * wifi MAC builds it.  A buffer keeps a single zero area virtual: the
+ * payloads of all the MSDUs but one are written into memory.
+ */
+static const uint32_t AMSDU_SUBFRAMES = 4;
+static const uint32_t AMSDU_PAYLOAD = 1500;
+
+static void
+benchAggregation (uint32_t n)
+{
+  BenchHeader<14> subframe;
+  BenchHeader<26> mac;
+
+  for (uint32_t i = 0; i < n; i++) {
+    Ptr<Packet> aggregate = Create<Packet> ();
+    for (uint32_t j = 0; j < AMSDU_SUBFRAMES; j++)
+      {
+        Ptr<Packet> msdu = Create<Packet> (AMSDU_PAYLOAD);
+        msdu->AddHeader (subframe);
+        aggregate->AddAtEnd (msdu);
+      }
+    aggregate->AddHeader (mac);
+  }
+}
+
 static uint64_t
 runBenchOneIteration (void (*bench) (uint32_t), uint32_t n)
 {
@@ -359,6 +437,14 @@ int main (int argc, char *argv[])
   runBench (&benchD, n, minIterations, "Intermixed add/remove headers and tags");
   runBench (&benchFragment, n, minIterations, "Fragmentation and concatenation");
   runBench (&benchByteTags, n, minIterations, "Benchmark byte tags");
+  runBench (&benchWifiTags, n, minIterations, "Packet tags of the wifi MAC path");
+
+  uint64_t zeroBytes = Buffer::GetMaterializedZeroBytes ();
+  runBench (&benchAggregation, n, minIterations, "A-MSDU aggregation");
+  zeroBytes = Buffer::GetMaterializedZeroBytes () - zeroBytes;
+  std::cout << "  zero payload bytes written into memory per A-MSDU: "
+            << zeroBytes / (static_cast<uint64_t> (n) * minIterations)
+            << " of " << AMSDU_SUBFRAMES * AMSDU_PAYLOAD << std::endl;
 
   return 0;
 }